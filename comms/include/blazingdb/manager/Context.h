@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
+#include "blazingdb/manager/QueryProfile.h"
 #include "blazingdb/transport/Node.h"
 
 namespace blazingdb {
@@ -64,6 +66,11 @@ public:
     return config_options_;
   }
 
+  /// The execution profile of the query, shared with the clones
+  std::shared_ptr<QueryProfile> getQueryProfile() const {
+    return query_profile_;
+  }
+
 private:
   const uint32_t token_;
   uint32_t query_step;
@@ -74,6 +81,7 @@ private:
   uint32_t kernel_id_;
   std::mutex increment_step_mutex;
   std::map<std::string, std::string> config_options_;
+  std::shared_ptr<QueryProfile> query_profile_;
 };
 
 }  // namespace manager
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace blazingdb {
+namespace manager {
+
+/// \brief What a kernel of the execution graph of a query did.
+///
+/// The wait times are the time the kernel was blocked on its caches, the busy
+/// time is the rest of the time it was running. The batches that its output
+/// caches had to keep in host memory or on disk are the spills by tier.
+struct KernelProfile {
+  int32_t kernel_id = 0;
+  std::string kernel_type;
+  std::string expression;
+  int64_t busy_ns = 0;
+  int64_t input_wait_ns = 0;
+  int64_t output_wait_ns = 0;
+  uint64_t batches_in = 0;
+  uint64_t rows_in = 0;
+  uint64_t bytes_in = 0;
+  uint64_t batches_out = 0;
+  uint64_t rows_out = 0;
+  uint64_t bytes_out = 0;
+  uint64_t batches_spilled_to_host = 0;
+  uint64_t batches_spilled_to_disk = 0;
+};
+
+/// \brief The execution profile of a query, one KernelProfile per kernel.
+///
+/// It is shared by a Context and its clones, so the kernels of a query add to
+/// the same profile whatever clone they hold.
+class QueryProfile {
+public:
+  QueryProfile() = default;
+
+  QueryProfile(QueryProfile&&) = delete;
+  QueryProfile(const QueryProfile&) = delete;
+  QueryProfile& operator=(QueryProfile&&) = delete;
+  QueryProfile& operator=(const QueryProfile&) = delete;
+
+  void addKernelProfile(KernelProfile&& profile);
+
+  /// The kernel profiles by kernel id
+  std::vector<KernelProfile> getKernelProfiles() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<KernelProfile> kernel_profiles_;
+};
+
+}  // namespace manager
+}  // namespace blazingdb
@@ -32,6 +32,10 @@ public:
              comunication_port == rhs.comunication_port and
              protocol_port == rhs.protocol_port;
     }
+
+    /// true when both addresses are on the same machine, used to pick an
+    /// intra-host transport
+    bool isSameHost(const MetaData &rhs) const;
   } metadata_;
   Address();
   Address(const Address& address);
@@ -22,6 +22,14 @@ public:
   virtual void Close() = 0;
 
   virtual void SetDevice(int) = 0;
+
+  /**
+   * It creates a client for the destination node. A shared memory client is
+   * used when the destination is on the same host and it has a shared memory
+   * ring, otherwise it falls back to a TCP client.
+   */
+  static std::shared_ptr<Client> Make(const Address::MetaData &self,
+                                      const Address::MetaData &destination);
 };
 
 class ClientTCP : public Client {
@@ -35,5 +43,20 @@ public:
   static std::shared_ptr<Client> Make(const std::string& ip, int16_t port);
 };
 
+class ClientSharedMemory : public Client {
+public:
+  virtual Status Send(GPUMessage& message) = 0;
+
+  virtual void Close() = 0;
+
+  virtual void SetDevice(int) = 0;
+
+  /**
+   * It returns nullptr when the server listening on that port has no shared
+   * memory ring, e.g. when it runs on another host.
+   */
+  static std::shared_ptr<Client> Make(const std::string& ip, int16_t port);
+};
+
 }  // namespace transport
 }  // namespace blazingdb
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "blazingdb/transport/Address.h"
+
+namespace blazingdb {
+namespace transport {
+
+/// \brief Receiver side of the credit based flow control.
+///
+/// Every (context, sender) pair may have at most `credits_per_sender` bytes
+/// received but not yet consumed through Server::getMessage. A sender asks
+/// for credits before pushing a frame and the server answers with a grant or
+/// a deny, it never blocks the server socket. Credits are given back when the
+/// message leaves the MessageQueue.
+///
+/// A single frame bigger than the whole budget is granted when the pair has
+/// nothing outstanding, otherwise it could never be sent.
+class CreditManager {
+public:
+  CreditManager() = default;
+
+  CreditManager(CreditManager&&) = delete;
+  CreditManager(const CreditManager&) = delete;
+  CreditManager& operator=(CreditManager&&) = delete;
+  CreditManager& operator=(const CreditManager&) = delete;
+
+  /**
+   * Tries to reserve `bytes` credits for the sender inside the context.
+   *
+   * @return true if the credits were granted.
+   */
+  bool tryAcquire(uint32_t context_token, const Address::MetaData& sender,
+                  std::size_t bytes);
+
+  /**
+   * Gives back credits once the message has been consumed.
+   */
+  void release(uint32_t context_token, const Address::MetaData& sender,
+               std::size_t bytes);
+
+  /**
+   * Drops every credit account related to the context.
+   */
+  void releaseContext(uint32_t context_token);
+
+  std::size_t outstandingBytes(uint32_t context_token,
+                               const Address::MetaData& sender);
+
+private:
+  using AccountKey = std::tuple<uint32_t, std::string, int16_t>;
+
+  static AccountKey makeKey(uint32_t context_token,
+                            const Address::MetaData& sender);
+
+  std::mutex mutex_;
+  std::map<AccountKey, std::size_t> outstanding_bytes_;
+};
+
+/// \brief Sender side counters, shared by all the clients of the process.
+struct FlowControlStats {
+  std::atomic<uint64_t> credit_requests{0};
+  std::atomic<uint64_t> credit_denials{0};
+  std::atomic<uint64_t> stalled_sends{0};
+  std::atomic<uint64_t> stall_time_ns{0};
+};
+
+FlowControlStats& getFlowControlStats();
+
+/**
+ * Sets the amount of bytes a receiver grants to each (context, sender) pair.
+ * Zero disables the flow control, which is the default. All the nodes of a
+ * cluster must use the same value because the sender skips the credit request
+ * when it is disabled.
+ */
+void setFlowControlCreditsPerSender(std::size_t bytes);
+
+std::size_t getFlowControlCreditsPerSender();
+
+inline bool isFlowControlEnabled() {
+  return getFlowControlCreditsPerSender() > 0;
+}
+
+}  // namespace transport
+}  // namespace blazingdb
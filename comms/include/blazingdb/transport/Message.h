@@ -88,10 +88,16 @@ public:
 
   bool is_sentinel() { return _is_sentinel; }
 
+  /// bytes received from the wire for this message, used to give back the
+  /// flow control credits once the message is consumed
+  void setBufferSize(std::size_t buffer_size) { _buffer_size = buffer_size; }
+  std::size_t getBufferSize() const { return _buffer_size; }
+
   BZ_INTERFACE(ReceivedMessage);
 
 private:
   bool _is_sentinel;
+  std::size_t _buffer_size{0};
 };
 
 }  // namespace transport
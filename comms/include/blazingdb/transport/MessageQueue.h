@@ -1,17 +1,22 @@
 #pragma once
 
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <vector>
-#include <set>
-#include <map>
+#include <unordered_map>
 
 #include "blazingdb/transport/Message.h"
 
 namespace blazingdb {
 namespace transport {
 
+/// \brief Queue of received messages indexed by message token.
+///
+/// Each message token has its own FIFO and its own condition variable, so a
+/// putMessage only wakes a thread waiting for that token and a getMessage
+/// never scans messages addressed to other tokens.
 class MessageQueue {
 public:
   MessageQueue();
@@ -27,20 +32,37 @@ public:
   MessageQueue& operator=(const MessageQueue&) = delete;
 
 public:
+  /**
+   * Waits until there is a message with the given token and removes it from
+   * the queue. It returns nullptr for a sentinel message or when the queue is
+   * closed.
+   */
   std::shared_ptr<ReceivedMessage> getMessage(const std::string& messageToken);
 
   void putMessage(std::shared_ptr<ReceivedMessage>& message);
 
-  
+  /**
+   * Wakes up every waiting thread and drops all the pending messages. Used
+   * when the context of this queue is deregistered.
+   */
+  void close();
+
 private:
-  std::shared_ptr<ReceivedMessage> getMessageQueue(const std::string& messageToken);
+  struct TokenQueue {
+    std::deque<std::shared_ptr<ReceivedMessage>> messages;
+    std::condition_variable condition_variable;
+    std::size_t waiters{0};
+  };
+
+  std::shared_ptr<ReceivedMessage> getMessageQueue(
+      const std::string& messageToken, TokenQueue& token_queue);
 
   void putMessageQueue(std::shared_ptr<ReceivedMessage>& message);
 
 private:
   std::mutex mutex_;
-  std::vector<std::shared_ptr<ReceivedMessage>> message_queue_;
-  std::condition_variable condition_variable_;
+  std::unordered_map<std::string, TokenQueue> message_queues_;
+  bool closed_{false};
 };
 
 }  // namespace transport
@@ -3,9 +3,11 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <shared_mutex>
 #include <string>
 #include "MessageQueue.h"
+#include "blazingdb/transport/FlowControl.h"
 #include "blazingdb/transport/Message.h"
 #include <rmm/device_buffer.hpp>
 #include "blazingdb/concurrency/BlazingThread.h"
@@ -73,7 +75,8 @@ public:
   /**
    * It is used to destroy a message queue related to the ContextToken.
    * It uses a 'unique lock' with a shared_mutex in order to ensure unique
-   * access to the whole structure.
+   * access to the whole structure. The threads waiting for a message of that
+   * context are woken up and they receive a nullptr.
    *
    * @param context_token  ContextToken class identifier.
    */
@@ -108,6 +111,9 @@ public:
    * wait condition has no relationship between message queues. It uses a
    * 'shared lock' with a 'shared mutex' for that purpose.
    *
+   * It throws if the context is not registered, since then no message would
+   * ever arrive.
+   *
    * @param context_token  identifier for the message queue using ContextToken.
    * @return               a shared pointer of a base message class.
    */
@@ -119,7 +125,7 @@ public:
    * select the queue. Each message queue works independently. Whether multiple
    * threads want to access at the same time to different message queue, then
    * all the threads put the message in the corresponding queue without wait or
-   * exclusion.
+   * exclusion. The message is dropped if the context was deregistered.
    *
    * @param context_token  identifier for the message queue using ContextToken.
    * @param message        message that will be stored in the corresponding
@@ -128,12 +134,40 @@ public:
   virtual void putMessage(const uint32_t context_token,
                           std::shared_ptr<ReceivedMessage> &message);
 
+  /**
+   * It answers a credit request of a sender. The credits are given back when
+   * the message is retrieved with 'getMessage' or when the context is
+   * deregistered. See CreditManager.
+   *
+   * @param context_token  identifier for the message queue using ContextToken.
+   * @param sender         address of the node that wants to send the message.
+   * @param bytes          size of the buffers the sender wants to push.
+   * @return               true if the sender can push the message now.
+   */
+  virtual bool acquireCredits(const uint32_t context_token,
+                              const Address::MetaData &sender,
+                              std::size_t bytes);
+
 
   Server::MakeDeviceFrameCallback getDeviceDeserializationFunction(const std::string &endpoint);
 
 
   Server::MakeHostFrameCallback getHostDeserializationFunction(const std::string & endpoint);
 
+protected:
+  /**
+   * It returns the message queue of the context, or nullptr if the context is
+   * not registered.
+   */
+  std::shared_ptr<MessageQueue> getMessageQueue(const uint32_t context_token);
+
+  /**
+   * It returns the message queue of the context, registering the context if
+   * it was not registered yet, because a message can arrive before the
+   * context is registered. It returns nullptr if the context was deregistered.
+   */
+  std::shared_ptr<MessageQueue> getOrRegisterMessageQueue(const uint32_t context_token);
+
 protected:
   /**
    * Defined in 'shared_mutex' header file.
@@ -144,8 +178,17 @@ protected:
 
   /**
    * It associate the context value with a message queue.
+   * The queues are shared with the threads waiting in 'getMessage', so a
+   * queue that is deregistered is closed and released by its last user.
+   */
+  std::map<uint32_t, std::shared_ptr<MessageQueue>> context_messages_map_;
+
+  /**
+   * The contexts that were deregistered and not registered again, so the
+   * messages that arrive late for them are dropped instead of creating a new
+   * queue that nobody would release.
    */
-  std::map<uint32_t, MessageQueue> context_messages_map_;
+  std::set<uint32_t> deregistered_contexts_;
 
   /**
    * It associates the endpoint to a HTTP Method.
@@ -160,6 +203,11 @@ protected:
 
   std::map<std::string, MakeHostFrameCallback> host_deserializer_;
 
+  /**
+   * It keeps the bytes received and not yet consumed per (context, sender).
+   */
+  CreditManager credit_manager_;
+
 public:
   /**
    * Static function that creates a TCP server.
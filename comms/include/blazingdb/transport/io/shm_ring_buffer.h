@@ -0,0 +1,109 @@
+#pragma once
+#include <pthread.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+/// \brief Thrown by a write into a ring that was closed, so the writer can send
+/// the frame through another transport.
+class SharedMemoryRingClosedError : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+/// \brief Byte stream between processes of the same host over POSIX shared memory.
+///
+/// The receiver creates the segment and is its only reader. Many writers, from
+/// any process, can push into it. A writer takes the writer lock for a whole
+/// frame so frames from different writers are never interleaved, while the
+/// bytes of a frame flow through the ring in chunks of at most `capacity` bytes.
+/// The copy into the ring is done outside the ring lock, so the reader drains
+/// the previous chunk while the next one is being copied.
+class SharedMemoryRingBuffer {
+public:
+  using CopyFunction = std::function<void(char *dst, const char *src, std::size_t nbytes)>;
+
+  ~SharedMemoryRingBuffer();
+
+  SharedMemoryRingBuffer(SharedMemoryRingBuffer &&) = delete;
+  SharedMemoryRingBuffer(const SharedMemoryRingBuffer &) = delete;
+  SharedMemoryRingBuffer &operator=(SharedMemoryRingBuffer &&) = delete;
+  SharedMemoryRingBuffer &operator=(const SharedMemoryRingBuffer &) = delete;
+
+  /**
+   * Creates the segment, replacing a stale one with the same name. The object
+   * owns the segment and unlinks it when destroyed.
+   */
+  static std::unique_ptr<SharedMemoryRingBuffer> Create(const std::string &name, std::size_t capacity);
+
+  /**
+   * Opens a segment created by another process. It returns nullptr if there is
+   * no such segment or if it was already closed, so the caller can fall back
+   * to another transport.
+   */
+  static std::unique_ptr<SharedMemoryRingBuffer> Open(const std::string &name);
+
+  void lockWriter();
+
+  void unlockWriter();
+
+  /**
+   * Blocks until all the bytes were pushed. It throws
+   * SharedMemoryRingClosedError if the reader closes the ring meanwhile.
+   * `copy` is used to move the bytes into the ring, e.g. a device to host
+   * copy; it defaults to memcpy. If `copy` throws, the frame in the ring is
+   * incomplete, so the ring is closed before the exception is rethrown.
+   */
+  void write(const char *data, std::size_t nbytes, const CopyFunction &copy = nullptr);
+
+  /**
+   * Blocks until `nbytes` were read. It returns false if the ring was closed
+   * before all of them arrived.
+   */
+  bool read(char *data, std::size_t nbytes);
+
+  /**
+   * Wakes up the reader and every writer. Later writes throw.
+   */
+  void close();
+
+  bool is_closed();
+
+  std::size_t capacity() const;
+
+private:
+  struct Header;
+
+  SharedMemoryRingBuffer(const std::string &name, Header *header, std::size_t mapped_size, bool owner);
+
+  std::string name_;
+  Header *header_;
+  char *data_;
+  std::size_t mapped_size_;
+  bool owner_;
+};
+
+/**
+ * Enables the shared memory transport between nodes that run on the same host.
+ * Both sides must enable it: the server creates its ring when it starts, and
+ * a client falls back to TCP when the ring of the destination does not exist.
+ * The rings are named after `cluster_id` and the port, so the nodes of two
+ * clusters that run on the same host do not write into each other's rings.
+ */
+void setSharedMemoryTransport(bool enabled, std::size_t ring_capacity, const std::string &cluster_id = "");
+
+bool isSharedMemoryTransportEnabled();
+
+std::size_t getSharedMemoryRingCapacity();
+
+std::string getSharedMemoryRingName(int16_t communication_port);
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
@@ -18,13 +18,15 @@ Context::Context(const uint32_t token,
       query_step{0},
       query_substep{0},
       kernel_id_{0},
-      config_options_{config_options} {}
+      config_options_{config_options},
+      query_profile_{std::make_shared<QueryProfile>()} {}
 
 std::shared_ptr<Context> Context::clone() {
   auto ptr = std::make_shared<Context>(this->token_, this->taskNodes_, this->masterNode_, this->logicalPlan_, this->config_options_);
   ptr->query_step = this->query_step;
   ptr->query_substep = this->query_substep;
   ptr->kernel_id_ = this->kernel_id_;
+  ptr->query_profile_ = this->query_profile_;
   return ptr;
 }
 
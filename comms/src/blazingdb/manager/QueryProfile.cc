@@ -0,0 +1,26 @@
+#include "blazingdb/manager/QueryProfile.h"
+#include <algorithm>
+
+namespace blazingdb {
+namespace manager {
+
+void QueryProfile::addKernelProfile(KernelProfile&& profile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  kernel_profiles_.push_back(std::move(profile));
+}
+
+std::vector<KernelProfile> QueryProfile::getKernelProfiles() const {
+  std::vector<KernelProfile> profiles;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profiles = kernel_profiles_;
+  }
+  std::sort(profiles.begin(), profiles.end(),
+            [](const KernelProfile& a, const KernelProfile& b) {
+              return a.kernel_id < b.kernel_id;
+            });
+  return profiles;
+}
+
+}  // namespace manager
+}  // namespace blazingdb
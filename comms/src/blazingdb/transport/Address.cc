@@ -4,6 +4,16 @@
 namespace blazingdb {
 namespace transport {
 
+static bool isLoopback(const std::string &ip) {
+  return ip == "localhost" || ip.compare(0, 4, "127.") == 0;
+}
+
+bool Address::MetaData::isSameHost(const MetaData &rhs) const {
+  const std::string lhs_ip{ip};
+  const std::string rhs_ip{rhs.ip};
+  return lhs_ip == rhs_ip || (isLoopback(lhs_ip) && isLoopback(rhs_ip));
+}
+
 Address::Address(){}
  
 Address::Address(const Address& address){
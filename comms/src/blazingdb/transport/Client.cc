@@ -1,11 +1,18 @@
 #include "blazingdb/transport/Client.h"
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <chrono>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <stdexcept>
+#include <thread>
 #include "blazingdb/network/TCPSocket.h"
 #include "blazingdb/transport/ColumnTransport.h"
+#include "blazingdb/transport/FlowControl.h"
 #include "blazingdb/transport/Status.h"
 #include "blazingdb/transport/io/reader_writer.h"
+#include "blazingdb/transport/io/shm_ring_buffer.h"
 
 namespace blazingdb {
 namespace transport {
@@ -71,11 +78,77 @@ public:
     return true;
   }
 
+  /**
+   * Asks the receiver for credits until they are granted. The caller thread is
+   * blocked meanwhile, the time spent here is accounted in FlowControlStats.
+   */
+  void acquireCredits(const Message::MetaData &message_metadata,
+                      const Address::MetaData &address_metadata,
+                      uint64_t bytes) {
+    void* fd = client_socket.fd();
+    zmq::socket_t* socket_ptr = (zmq::socket_t*)fd;
+    auto & stats = getFlowControlStats();
+
+    auto start = std::chrono::steady_clock::now();
+    auto backoff = std::chrono::milliseconds(1);
+    bool stalled = false;
+    while (true) {
+      blazingdb::transport::io::writeToSocket(fd, "CRED", 4);
+      write_metadata(fd, message_metadata);
+      write_metadata(fd, address_metadata);
+      write_metadata(fd, bytes);
+      blazingdb::transport::io::writeToSocket(fd, "OK", 2, false);
+
+      zmq::message_t local_message;
+      auto success = socket_ptr->recv(local_message);
+      if (success.value() == false || local_message.size() == 0) {
+        std::cerr << "Client:   throw zmq::error_t()" << std::endl;
+        throw zmq::error_t();
+      }
+      stats.credit_requests++;
+
+      std::string answer(static_cast<char*>(local_message.data()),
+                         local_message.size());
+      if (answer == "GRNT") {
+        break;
+      }
+      stats.credit_denials++;
+      stalled = true;
+      std::this_thread::sleep_for(backoff);
+      backoff = std::min(backoff * 2, std::chrono::milliseconds(100));
+    }
+
+    if (stalled) {
+      auto stall_time = std::chrono::steady_clock::now() - start;
+      stats.stalled_sends++;
+      stats.stall_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(stall_time).count();
+    }
+  }
+
   Status Send(GPUMessage& message) override {
+    return sendMessage(message, isFlowControlEnabled());
+  }
+
+  /**
+   * Sends the message, asking for its credits first only if `acquire_credits`,
+   * e.g. the shared memory client already holds them when it falls back here.
+   */
+  Status sendMessage(GPUMessage& message, bool acquire_credits) {
     void* fd = client_socket.fd();
     auto &node = message.getSenderNode();
     auto message_metadata = message.metadata();
 
+    std::vector<std::size_t> buffer_sizes;
+    std::vector<const char *> buffers;
+    std::vector<ColumnTransport> column_offsets;
+    std::vector<std::unique_ptr<rmm::device_buffer>> temp_scope_holder;
+    std::tie(buffer_sizes, buffers, column_offsets, temp_scope_holder) = message.GetRawColumns();
+
+    if (acquire_credits) {
+      uint64_t total_bytes = std::accumulate(buffer_sizes.begin(), buffer_sizes.end(), uint64_t{0});
+      acquireCredits(message_metadata, node.address().metadata_, total_bytes);
+    }
+
     // Initialize the topic message to be sent.
     blazingdb::transport::io::writeToSocket(fd, "GPUS", 4);
 
@@ -85,11 +158,6 @@ public:
     write_metadata(fd, node.address().metadata_);
 
     // send message content (gpu buffers)
-    std::vector<std::size_t> buffer_sizes;
-    std::vector<const char *> buffers;
-    std::vector<ColumnTransport> column_offsets;
-    std::vector<std::unique_ptr<rmm::device_buffer>> temp_scope_holder;
-    std::tie(buffer_sizes, buffers, column_offsets, temp_scope_holder) = message.GetRawColumns();
 
     write_metadata(fd, (int32_t)column_offsets.size());
     blazingdb::transport::io::writeToSocket(
@@ -132,5 +200,158 @@ std::shared_ptr<Client> ClientTCP::Make(const std::string& ip, int16_t port) {
   return std::shared_ptr<Client>(new ConcreteClientTCP(ip, port));
 }
 
+// holds the writer lock of the ring for a whole frame, it is released even if the ring is closed in the middle
+struct RingWriterLock {
+  explicit RingWriterLock(io::SharedMemoryRingBuffer& ring) : ring{ring} { ring.lockWriter(); }
+  ~RingWriterLock() { ring.unlockWriter(); }
+  io::SharedMemoryRingBuffer& ring;
+};
+
+/**
+  @brief A client for a server on the same host. The frames have the same layout
+  as the TCP ones but they are pushed through the shared memory ring of the
+  server, so the buffers are copied from the GPU straight into the ring.
+  The credit requests are still answered through TCP, they are tiny.
+  If the server closes the ring, because its reader failed, the frame that was
+  being pushed and all the later ones are sent through TCP instead.
+*/
+class ConcreteClientSharedMemory : public ClientSharedMemory {
+public:
+  ConcreteClientSharedMemory(std::shared_ptr<io::SharedMemoryRingBuffer> ring,
+                             const std::string& ip, int16_t port)
+      : ring{ring}, ip{ip}, port{port} {}
+
+  void Close() override {
+    if (tcp_client) {
+      tcp_client->Close();
+    }
+  }
+
+  void SetDevice(int gpuId) override { this->gpuId = gpuId; }
+
+  bool notifyLastMessageEvent(const Message::MetaData &message_metadata) override {
+    if (!ring_closed) {
+      try {
+        RingWriterLock lock(*ring);
+        ring->write("LAST", 4);
+        write_metadata(message_metadata);
+        return true;
+      } catch (const io::SharedMemoryRingClosedError &) {
+        ring_closed = true;
+      }
+    }
+    return getTCPClient().notifyLastMessageEvent(message_metadata);
+  }
+
+  Status Send(GPUMessage& message) override {
+    if (ring_closed || ring->is_closed()) {
+      ring_closed = true;
+      return getTCPClient().Send(message);
+    }
+
+    auto &node = message.getSenderNode();
+    auto message_metadata = message.metadata();
+
+    std::vector<std::size_t> buffer_sizes;
+    std::vector<const char *> buffers;
+    std::vector<ColumnTransport> column_offsets;
+    std::vector<std::unique_ptr<rmm::device_buffer>> temp_scope_holder;
+    std::tie(buffer_sizes, buffers, column_offsets, temp_scope_holder) = message.GetRawColumns();
+
+    if (isFlowControlEnabled()) {
+      uint64_t total_bytes = std::accumulate(buffer_sizes.begin(), buffer_sizes.end(), uint64_t{0});
+      ConcreteClientTCP control_client(ip, port);
+      control_client.acquireCredits(message_metadata, node.address().metadata_, total_bytes);
+      control_client.Close();
+    }
+
+    int gpuId = this->gpuId;
+    auto copy_from_gpu = [gpuId](char *dst, const char *src, std::size_t nbytes) {
+      cudaError_t status = cudaSetDevice(gpuId);
+      if (status == cudaSuccess) {
+        status = cudaMemcpy(dst, src, nbytes, cudaMemcpyDefault);
+      }
+      if (status != cudaSuccess) {
+        throw std::runtime_error(std::string("ClientSharedMemory: cannot copy a buffer into the ring: ") +
+                                 cudaGetErrorString(status));
+      }
+    };
+
+    try {
+      RingWriterLock lock(*ring);
+      ring->write("GPUS", 4);
+      write_metadata(message_metadata);
+      write_metadata(node.address().metadata_);
+
+      write_metadata((int32_t)column_offsets.size());
+      ring->write((char*)column_offsets.data(), sizeof(ColumnTransport) * column_offsets.size());
+
+      write_metadata((int32_t)buffer_sizes.size());
+      ring->write((char*)buffer_sizes.data(), sizeof(std::size_t) * buffer_sizes.size());
+
+      for (std::size_t i = 0; i < buffers.size(); i++) {
+        ring->write(buffers[i], buffer_sizes[i], copy_from_gpu);
+      }
+    } catch (const io::SharedMemoryRingClosedError &) {
+      // the reader drops the incomplete frame, the credits that were granted for it are used by the TCP one
+      ring_closed = true;
+      return getTCPClient().sendMessage(message, false);
+    }
+    return Status{true};
+  }
+
+private:
+  template <typename MetadataType>
+  void write_metadata(const MetadataType& metadata) {
+    ring->write((const char*)&metadata, sizeof(MetadataType));
+  }
+
+  ConcreteClientTCP& getTCPClient() {
+    if (!tcp_client) {
+      tcp_client.reset(new ConcreteClientTCP(ip, port));
+      tcp_client->SetDevice(gpuId);
+    }
+    return *tcp_client;
+  }
+
+  std::shared_ptr<io::SharedMemoryRingBuffer> ring;
+  std::string ip;
+  int16_t port;
+  int gpuId{0};
+  bool ring_closed{false};
+  std::unique_ptr<ConcreteClientTCP> tcp_client;
+};
+
+std::shared_ptr<Client> ClientSharedMemory::Make(const std::string& ip, int16_t port) {
+  // the rings are kept open, mapping a segment for each message would cost as much as a TCP connection
+  static std::mutex rings_mutex;
+  static std::map<std::string, std::shared_ptr<io::SharedMemoryRingBuffer>> rings;
+
+  const std::string ring_name = io::getSharedMemoryRingName(port);
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  auto it = rings.find(ring_name);
+  if (it == rings.end() || it->second->is_closed()) {
+    std::shared_ptr<io::SharedMemoryRingBuffer> ring = io::SharedMemoryRingBuffer::Open(ring_name);
+    if (ring == nullptr) {
+      rings.erase(ring_name);
+      return nullptr;
+    }
+    rings[ring_name] = ring;
+    it = rings.find(ring_name);
+  }
+  return std::shared_ptr<Client>(new ConcreteClientSharedMemory(it->second, ip, port));
+}
+
+std::shared_ptr<Client> Client::Make(const Address::MetaData &self,
+                                     const Address::MetaData &destination) {
+  if (io::isSharedMemoryTransportEnabled() && self.isSameHost(destination)) {
+    auto client = ClientSharedMemory::Make(destination.ip, destination.comunication_port);
+    if (client != nullptr) {
+      return client;
+    }
+  }
+  return ClientTCP::Make(destination.ip, destination.comunication_port);
+}
+
 }  // namespace transport
 }  // namespace blazingdb
@@ -0,0 +1,71 @@
+#include "blazingdb/transport/FlowControl.h"
+#include <limits>
+
+namespace blazingdb {
+namespace transport {
+
+static std::atomic<std::size_t> credits_per_sender{0};
+
+void setFlowControlCreditsPerSender(std::size_t bytes) {
+  credits_per_sender.store(bytes);
+}
+
+std::size_t getFlowControlCreditsPerSender() {
+  return credits_per_sender.load();
+}
+
+FlowControlStats& getFlowControlStats() {
+  static FlowControlStats stats;
+  return stats;
+}
+
+CreditManager::AccountKey CreditManager::makeKey(
+    uint32_t context_token, const Address::MetaData& sender) {
+  return std::make_tuple(context_token, std::string{sender.ip},
+                         sender.comunication_port);
+}
+
+bool CreditManager::tryAcquire(uint32_t context_token,
+                               const Address::MetaData& sender,
+                               std::size_t bytes) {
+  const std::size_t budget = getFlowControlCreditsPerSender();
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::size_t& outstanding = outstanding_bytes_[makeKey(context_token, sender)];
+  if (budget > 0 && outstanding > 0 && outstanding + bytes > budget) {
+    return false;
+  }
+  outstanding += bytes;
+  return true;
+}
+
+void CreditManager::release(uint32_t context_token,
+                            const Address::MetaData& sender,
+                            std::size_t bytes) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = outstanding_bytes_.find(makeKey(context_token, sender));
+  if (it == outstanding_bytes_.end()) {
+    return;
+  }
+  it->second = bytes < it->second ? it->second - bytes : 0;
+}
+
+void CreditManager::releaseContext(uint32_t context_token) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = outstanding_bytes_.lower_bound(
+      std::make_tuple(context_token, std::string{},
+                     std::numeric_limits<int16_t>::min()));
+  while (it != outstanding_bytes_.end() &&
+         std::get<0>(it->first) == context_token) {
+    it = outstanding_bytes_.erase(it);
+  }
+}
+
+std::size_t CreditManager::outstandingBytes(uint32_t context_token,
+                                            const Address::MetaData& sender) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = outstanding_bytes_.find(makeKey(context_token, sender));
+  return it == outstanding_bytes_.end() ? 0 : it->second;
+}
+
+}  // namespace transport
+}  // namespace blazingdb
@@ -1,5 +1,4 @@
 #include "blazingdb/transport/MessageQueue.h"
-#include <algorithm>
 #include <iostream>
 
 namespace blazingdb {
@@ -14,34 +13,52 @@ std::shared_ptr<ReceivedMessage> MessageQueue::getMessage(
     const std::string &messageToken) {
   std::unique_lock<std::mutex> lock(mutex_);
 
-  condition_variable_.wait(lock, [&, this] {
-    return std::any_of(this->message_queue_.cbegin(),
-                       this->message_queue_.cend(), [&](const auto &e) {
-                         return e->getMessageTokenValue() == messageToken;
-                       });
+  // a reference to the entry stays valid while other tokens are added, an
+  // iterator does not, so only the reference is kept across the wait
+  TokenQueue &token_queue = message_queues_.emplace(std::piecewise_construct,
+                                                    std::forward_as_tuple(messageToken),
+                                                    std::tuple<>()).first->second;
+  token_queue.waiters++;
+  token_queue.condition_variable.wait(lock, [&, this] {
+    return this->closed_ || !token_queue.messages.empty();
   });
-  return getMessageQueue(messageToken);
+  token_queue.waiters--;
+
+  return getMessageQueue(messageToken, token_queue);
 }
 
 void MessageQueue::putMessage(std::shared_ptr<ReceivedMessage> &message) {
   std::unique_lock<std::mutex> lock(mutex_);
+  if (closed_) {
+    return;
+  }
   putMessageQueue(message);
-  lock.unlock();
-  condition_variable_.notify_all(); // Note: Very important to notify all threads
+}
+
+void MessageQueue::close() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  closed_ = true;
+  for (auto &token_queue : message_queues_) {
+    token_queue.second.messages.clear();
+    token_queue.second.condition_variable.notify_all();
+  }
 }
 
 std::shared_ptr<ReceivedMessage> MessageQueue::getMessageQueue(
-    const std::string &messageToken) {
-  auto it = std::find_if(message_queue_.begin(), message_queue_.end(),
-                           [&messageToken](const auto &e) {
-                             return e->getMessageTokenValue() == messageToken;
-                           });
-  assert(it != message_queue_.end());
+    const std::string &messageToken, TokenQueue &token_queue) {
 
-  std::shared_ptr<ReceivedMessage> message = *it;
-  message_queue_.erase(it, it + 1);
+  std::shared_ptr<ReceivedMessage> message;
+  if (!token_queue.messages.empty()) {
+    message = token_queue.messages.front();
+    token_queue.messages.pop_front();
+  }
+
+  // nobody else is using this token, so we do not keep an empty entry around
+  if (token_queue.messages.empty() && token_queue.waiters == 0) {
+    message_queues_.erase(messageToken);
+  }
 
-  if (message->is_sentinel()) {
+  if (message == nullptr || message->is_sentinel()) {
     return nullptr;
   }
 
@@ -49,7 +66,14 @@ std::shared_ptr<ReceivedMessage> MessageQueue::getMessageQueue(
 }
 
 void MessageQueue::putMessageQueue(std::shared_ptr<ReceivedMessage> &message) {
-  message_queue_.push_back(message);
+  auto token_queue_it = message_queues_.emplace(std::piecewise_construct,
+                                                std::forward_as_tuple(message->getMessageTokenValue()),
+                                                std::tuple<>()).first;
+  TokenQueue &token_queue = token_queue_it->second;
+  token_queue.messages.push_back(message);
+  // Note: the entry can be erased as soon as the lock is released, so the
+  // waiter of this token is notified while the lock is still held.
+  token_queue.condition_variable.notify_one();
 }
 
 }  // namespace transport
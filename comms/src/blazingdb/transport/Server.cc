@@ -3,6 +3,7 @@
 #include "blazingdb/concurrency/BlazingThread.h"
 #include "blazingdb/network/TCPSocket.h"
 #include "blazingdb/transport/io/reader_writer.h"
+#include "blazingdb/transport/io/shm_ring_buffer.h"
 
 #include "blazingdb/network/TCPSocket.h"
 #include "blazingdb/transport/MessageQueue.h"
@@ -13,6 +14,7 @@
 #include <map>
 #include <mutex>
 #include <numeric>
+#include <set>
 #include <rmm/device_buffer.hpp>
 #include <shared_mutex>
 #include <string>
@@ -35,34 +37,68 @@ void Server::registerHostDeserializerForEndPoint(MakeHostFrameCallback deseriali
 
 void Server::registerContext(const uint32_t context_token) {
 	std::unique_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
-	context_messages_map_.emplace(std::piecewise_construct, std::forward_as_tuple(context_token), std::tuple<>());
+	deregistered_contexts_.erase(context_token);
+	context_messages_map_.emplace(context_token, std::make_shared<MessageQueue>());
 }
 
 void Server::deregisterContext(const uint32_t context_token) {
 	std::unique_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
 	auto it = context_messages_map_.find(context_token);
 	if(it != context_messages_map_.end()) {
+		it->second->close();
 		context_messages_map_.erase(it);
 	}
+	deregistered_contexts_.insert(context_token);
+	credit_manager_.releaseContext(context_token);
+}
+
+std::shared_ptr<MessageQueue> Server::getMessageQueue(const uint32_t context_token) {
+	std::shared_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
+	auto it = context_messages_map_.find(context_token);
+	if(it == context_messages_map_.end()) {
+		return nullptr;
+	}
+	return it->second;
+}
+
+std::shared_ptr<MessageQueue> Server::getOrRegisterMessageQueue(const uint32_t context_token) {
+	std::shared_ptr<MessageQueue> message_queue = getMessageQueue(context_token);
+	if(message_queue != nullptr) {
+		return message_queue;
+	}
+
+	// a message of a peer can arrive before the context is registered in this node, so the queue is created here,
+	// but never again after the context is deregistered. The lock is held from the find to the use of the iterator
+	std::unique_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
+	if(deregistered_contexts_.find(context_token) != deregistered_contexts_.end()) {
+		return nullptr;
+	}
+	return context_messages_map_.emplace(context_token, std::make_shared<MessageQueue>()).first->second;
 }
 
 std::shared_ptr<ReceivedMessage> Server::getMessage(const uint32_t context_token, const std::string & messageToken) {
-	MessageQueue & message_queue = context_messages_map_.at(context_token);
-	return message_queue.getMessage(messageToken);
+	std::shared_ptr<MessageQueue> message_queue = getMessageQueue(context_token);
+	if(message_queue == nullptr) {
+		throw std::runtime_error("getMessage: context " + std::to_string(context_token) + " is not registered");
+	}
+	auto message = message_queue->getMessage(messageToken);
+	if(message != nullptr && message->getBufferSize() > 0) {
+		credit_manager_.release(context_token, message->getSenderNode().address().metadata(), message->getBufferSize());
+	}
+	return message;
+}
+
+bool Server::acquireCredits(const uint32_t context_token, const Address::MetaData & sender, std::size_t bytes) {
+	return credit_manager_.tryAcquire(context_token, sender, bytes);
 }
 
 void Server::putMessage(const uint32_t context_token, std::shared_ptr<ReceivedMessage> & message) {
-	std::shared_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
-	if(context_messages_map_.find(context_token) == context_messages_map_.end()) {
-		// putMessage could be called before registerContext so we force the
-		// registration of the context token.
-		lock.unlock();
-		registerContext(context_token);
-		lock.lock();
+	std::shared_ptr<MessageQueue> message_queue = getOrRegisterMessageQueue(context_token);
+	if(message_queue == nullptr) {
+		// the query of the context already finished, so nobody is going to get the message
+		return;
 	}
-
-	MessageQueue & message_queue = context_messages_map_.at(context_token);
-	message_queue.putMessage(message);
+	message_queue->putMessage(message);
 }
 
 Server::MakeDeviceFrameCallback Server::getDeviceDeserializationFunction(const std::string & endpoint) {
@@ -96,6 +132,7 @@ namespace {
 	"GPUS" this represent a dataframe Message
 	"LAST" this represent a last event used to indicate that there is 
 	not going to be more message with the same message_token
+	"CRED" this represent a credit request sent by a client before a "GPUS" event when the flow control is enabled
 	"" 
 */ 
 class ServerTCP : public Server {
@@ -143,6 +180,37 @@ Message::MetaData collect_last_event(void * socket, Server * server) {
 	return message_metadata;
 }
 
+/**
+	@brief Answers a "CRED" event. The sender asks for credits before pushing a "GPUS" event,
+	the answer is "GRNT" or "DENY" and it is sent right away so a slow consumer never blocks the socket.
+*/
+void reply_credit_request(void * socket, Server * server) {
+	zmq::socket_t * socket_ptr = (zmq::socket_t *) socket;
+	Message::MetaData message_metadata = read_metadata<Message::MetaData>(socket);
+	Address::MetaData address_metadata = read_metadata<Address::MetaData>(socket);
+	uint64_t requested_bytes = read_metadata<uint64_t>(socket);
+
+	zmq::message_t local_message;
+	auto success = socket_ptr->recv(local_message);
+	if(success.value() == false || local_message.size() == 0) {
+		throw zmq::error_t();
+	}
+	std::string ok_message(static_cast<char *>(local_message.data()), local_message.size());
+	assert(ok_message == "OK");
+
+	bool granted = server->acquireCredits(message_metadata.contextToken, address_metadata, requested_bytes);
+	blazingdb::transport::io::writeToSocket(socket, granted ? "GRNT" : "DENY", 4, false);
+}
+
+template <typename buffer_container_type>
+std::size_t total_buffer_size(const buffer_container_type & raw_columns) {
+	std::size_t total_size = 0;
+	for(const auto & buffer : raw_columns) {
+		total_size += buffer.size();
+	}
+	return total_size;
+}
+
 template <typename buffer_container_type = std::vector<rmm::device_buffer>>
 std::tuple<Message::MetaData, Address::MetaData, std::vector<ColumnTransport>, buffer_container_type>
 collect_gpu_message(
@@ -198,6 +266,8 @@ void ServerTCP::Run() {
 				std::string message_topic_str(static_cast<char *>(message_topic.data()), message_topic.size());
 				if(message_topic_str == "LAST") {
 					collect_last_event(socket, this);
+				} else if(message_topic_str == "CRED") {
+					reply_credit_request(socket, this);
 				} else if(message_topic_str == "GPUS") {
 					Message::MetaData message_metadata;
 					Address::MetaData address_metadata;
@@ -213,6 +283,7 @@ void ServerTCP::Run() {
 					std::shared_ptr<ReceivedMessage> message =
 						deserialize_function(message_metadata, address_metadata, column_offsets, raw_columns);
 					assert(message != nullptr);
+					message->setBufferSize(total_buffer_size(raw_columns));
 					this->putMessage(message->metadata().contextToken, message);
 				}
 			} catch(const std::runtime_error & exception) {
@@ -234,13 +305,36 @@ void ServerTCP::Run() {
 	"GPUS" this represent a dataframe Message
 	"LAST" this represent a last event used to indicate that there is 
 	not going to be more message with the same message_token
+	"CRED" this represent a credit request sent by a client before a "GPUS" event when the flow control is enabled
 	"" 
+
+	When the shared memory transport is enabled this server also creates a ring named after its cluster and its port, the clients
+	of the same host push their "GPUS" and "LAST" events there instead of going through the TCP socket.
 */ 
 class ServerForBatchProcessing : public ServerTCP {
 public:
-	ServerForBatchProcessing(unsigned short port) : ServerTCP(port) {}
+	ServerForBatchProcessing(unsigned short port) : ServerTCP(port), port{port} {}
+
+	~ServerForBatchProcessing() {
+		if(shm_thread.joinable()) {
+			shm_thread.join();
+		}
+	}
+
+	void Close() override {
+		if(shm_ring) {
+			shm_ring->close();
+		}
+		ServerTCP::Close();
+	}
 
 	void Run() override {
+		if(blazingdb::transport::io::isSharedMemoryTransportEnabled()) {
+			shm_ring = blazingdb::transport::io::SharedMemoryRingBuffer::Create(
+				blazingdb::transport::io::getSharedMemoryRingName(port), blazingdb::transport::io::getSharedMemoryRingCapacity());
+			shm_thread = BlazingThread([this]() { this->RunSharedMemory(); });
+		}
+
 		thread = BlazingThread([this]() {
 			server_socket.run([this](void * socket) {
 				try {
@@ -261,6 +355,8 @@ public:
 						auto sentinel_message = std::make_shared<ReceivedMessage>(messageToken, contextToken, tmp_node, true);
 						this->putMessage(contextToken, sentinel_message);
 					
+					} else if(message_topic_str == "CRED") {
+						reply_credit_request(socket, this);
 					} else if(message_topic_str == "GPUS") {
 						Message::MetaData message_metadata;
 						Address::MetaData address_metadata;
@@ -273,9 +369,11 @@ public:
 						std::string messageToken = message_metadata.messageToken;
 						auto deserialize_function =
 						this->getHostDeserializationFunction(messageToken.substr(0, messageToken.find('_')));
+						std::size_t buffer_size = total_buffer_size(raw_columns);
 						std::shared_ptr<ReceivedMessage> message =
 							deserialize_function(message_metadata, address_metadata, column_offsets, std::move(raw_columns));
 						assert(message != nullptr);
+						message->setBufferSize(buffer_size);
 						uint32_t contextToken = message->metadata().contextToken; 
 						this->putMessage(contextToken, message);
 						
@@ -289,6 +387,86 @@ public:
 		});
 		std::this_thread::yield();
 	} 
+
+private:
+	void read_ring_bytes(char * data, std::size_t nbytes) {
+		if(!shm_ring->read(data, nbytes)) {
+			throw std::runtime_error("SharedMemoryServer: ring closed in the middle of a frame");
+		}
+	}
+
+	template <typename MetadataType>
+	MetadataType read_ring_metadata() {
+		MetadataType metadata;
+		read_ring_bytes((char *) &metadata, sizeof(MetadataType));
+		return metadata;
+	}
+
+	/**
+		@brief Consumes the frames that the clients of the same host push through the shared memory ring.
+		The frames have the same events and layout as the TCP ones, except "CRED" which always goes through TCP.
+		It runs on its own thread, so an error is logged and closes the ring instead of escaping the thread. Once the
+		ring is closed the clients of the same host fall back to TCP.
+	*/
+	void RunSharedMemory() {
+		try {
+			char message_topic[4];
+			while(shm_ring->read(message_topic, 4)) {
+				std::string message_topic_str(message_topic, 4);
+				if(message_topic_str == "LAST") {
+					auto message_metadata = read_ring_metadata<Message::MetaData>();
+
+					std::string messageToken = message_metadata.messageToken;
+					uint32_t contextToken = message_metadata.contextToken;
+					blazingdb::transport::Node tmp_node;
+
+					auto sentinel_message = std::make_shared<ReceivedMessage>(messageToken, contextToken, tmp_node, true);
+					this->putMessage(contextToken, sentinel_message);
+				} else if(message_topic_str == "GPUS") {
+					Message::MetaData message_metadata = read_ring_metadata<Message::MetaData>();
+					Address::MetaData address_metadata = read_ring_metadata<Address::MetaData>();
+
+					auto column_offset_size = read_ring_metadata<int32_t>();
+					std::vector<ColumnTransport> column_offsets(column_offset_size);
+					read_ring_bytes((char *) column_offsets.data(), column_offset_size * sizeof(ColumnTransport));
+
+					auto buffer_sizes_size = read_ring_metadata<int32_t>();
+					std::vector<std::size_t> buffer_sizes(buffer_sizes_size);
+					read_ring_bytes((char *) buffer_sizes.data(), buffer_sizes_size * sizeof(std::size_t));
+
+					std::vector<Buffer> raw_columns;
+					for(auto buffer_size : buffer_sizes) {
+						raw_columns.emplace_back(buffer_size, '0');
+						read_ring_bytes(&raw_columns.back()[0], buffer_size);
+					}
+
+					std::string messageToken = message_metadata.messageToken;
+					auto deserialize_function =
+						this->getHostDeserializationFunction(messageToken.substr(0, messageToken.find('_')));
+					std::size_t buffer_size = total_buffer_size(raw_columns);
+					std::shared_ptr<ReceivedMessage> message =
+						deserialize_function(message_metadata, address_metadata, column_offsets, std::move(raw_columns));
+					assert(message != nullptr);
+					message->setBufferSize(buffer_size);
+					uint32_t contextToken = message->metadata().contextToken;
+					this->putMessage(contextToken, message);
+				} else {
+					throw std::runtime_error("SharedMemoryServer: unknown event " + message_topic_str);
+				}
+			}
+		} catch(const std::exception & exception) {
+			if(!shm_ring->is_closed()) {
+				std::cerr << "[ERROR] " << exception.what() << std::endl;
+				shm_ring->close();
+			}
+		}
+	}
+
+	unsigned short port;
+
+	std::unique_ptr<blazingdb::transport::io::SharedMemoryRingBuffer> shm_ring;
+
+	BlazingThread shm_thread;
 };
 
 }  // namespace
@@ -0,0 +1,258 @@
+#include "blazingdb/transport/io/shm_ring_buffer.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+struct SharedMemoryRingBuffer::Header {
+  pthread_mutex_t mutex;         // protects head, tail and closed
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+  pthread_mutex_t writer_mutex;  // held by a writer for a whole frame
+  uint64_t capacity;
+  uint64_t head;                 // total bytes read
+  uint64_t tail;                 // total bytes written
+  bool closed;
+};
+
+namespace {
+
+// the mutexes are robust, a process that dies holding one of them does not
+// leave the others blocked forever
+void lock_robust(pthread_mutex_t *mutex) {
+  int result = pthread_mutex_lock(mutex);
+  if (result == EOWNERDEAD) {
+    pthread_mutex_consistent(mutex);
+  } else if (result != 0) {
+    throw std::runtime_error("SharedMemoryRingBuffer: cannot lock mutex");
+  }
+}
+
+void init_shared_mutex(pthread_mutex_t *mutex) {
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+void init_shared_cond(pthread_cond_t *cond) {
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+void wait_robust(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+  if (pthread_cond_wait(cond, mutex) == EOWNERDEAD) {
+    pthread_mutex_consistent(mutex);
+  }
+}
+
+}  // namespace
+
+SharedMemoryRingBuffer::SharedMemoryRingBuffer(const std::string &name, Header *header,
+                                               std::size_t mapped_size, bool owner)
+    : name_{name},
+      header_{header},
+      data_{reinterpret_cast<char *>(header) + sizeof(Header)},
+      mapped_size_{mapped_size},
+      owner_{owner} {}
+
+SharedMemoryRingBuffer::~SharedMemoryRingBuffer() {
+  if (owner_) {
+    close();
+    shm_unlink(name_.c_str());
+  }
+  munmap(header_, mapped_size_);
+}
+
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::Create(const std::string &name,
+                                                                       std::size_t capacity) {
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw std::runtime_error("SharedMemoryRingBuffer: cannot create " + name + ": " + std::strerror(errno));
+  }
+  std::size_t mapped_size = sizeof(Header) + capacity;
+  if (ftruncate(fd, mapped_size) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw std::runtime_error("SharedMemoryRingBuffer: cannot resize " + name + ": " + std::strerror(errno));
+  }
+  void *address = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw std::runtime_error("SharedMemoryRingBuffer: cannot map " + name + ": " + std::strerror(errno));
+  }
+
+  Header *header = static_cast<Header *>(address);
+  init_shared_mutex(&header->mutex);
+  init_shared_mutex(&header->writer_mutex);
+  init_shared_cond(&header->not_empty);
+  init_shared_cond(&header->not_full);
+  header->head = 0;
+  header->tail = 0;
+  header->closed = false;
+  // capacity is published last, a client that sees it can use the header
+  std::atomic_thread_fence(std::memory_order_release);
+  header->capacity = capacity;
+
+  return std::unique_ptr<SharedMemoryRingBuffer>(new SharedMemoryRingBuffer(name, header, mapped_size, true));
+}
+
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::Open(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) <= sizeof(Header)) {
+    ::close(fd);
+    return nullptr;
+  }
+  std::size_t mapped_size = st.st_size;
+  void *address = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+
+  Header *header = static_cast<Header *>(address);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (header->capacity + sizeof(Header) != mapped_size || header->closed) {
+    munmap(address, mapped_size);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemoryRingBuffer>(new SharedMemoryRingBuffer(name, header, mapped_size, false));
+}
+
+void SharedMemoryRingBuffer::lockWriter() { lock_robust(&header_->writer_mutex); }
+
+void SharedMemoryRingBuffer::unlockWriter() { pthread_mutex_unlock(&header_->writer_mutex); }
+
+void SharedMemoryRingBuffer::write(const char *data, std::size_t nbytes, const CopyFunction &copy) {
+  const uint64_t capacity = header_->capacity;
+  std::size_t written = 0;
+  while (written < nbytes) {
+    lock_robust(&header_->mutex);
+    while (!header_->closed && header_->tail - header_->head == capacity) {
+      wait_robust(&header_->not_full, &header_->mutex);
+    }
+    if (header_->closed) {
+      pthread_mutex_unlock(&header_->mutex);
+      throw SharedMemoryRingClosedError("SharedMemoryRingBuffer: " + name_ + " was closed by the reader");
+    }
+    uint64_t offset = header_->tail % capacity;
+    std::size_t chunk = std::min<uint64_t>({nbytes - written, capacity - (header_->tail - header_->head), capacity - offset});
+    pthread_mutex_unlock(&header_->mutex);
+
+    // only this writer owns [tail, tail + chunk), the reader does not go past tail
+    if (copy) {
+      try {
+        copy(data_ + offset, data + written, chunk);
+      } catch (...) {
+        // the reader would take the bytes of the next frame as the rest of this one
+        close();
+        throw;
+      }
+    } else {
+      std::memcpy(data_ + offset, data + written, chunk);
+    }
+
+    lock_robust(&header_->mutex);
+    header_->tail += chunk;
+    pthread_cond_signal(&header_->not_empty);
+    pthread_mutex_unlock(&header_->mutex);
+    written += chunk;
+  }
+}
+
+bool SharedMemoryRingBuffer::read(char *data, std::size_t nbytes) {
+  const uint64_t capacity = header_->capacity;
+  std::size_t amount_read = 0;
+  while (amount_read < nbytes) {
+    lock_robust(&header_->mutex);
+    while (!header_->closed && header_->tail == header_->head) {
+      wait_robust(&header_->not_empty, &header_->mutex);
+    }
+    if (header_->tail == header_->head) {
+      pthread_mutex_unlock(&header_->mutex);
+      return false;
+    }
+    uint64_t offset = header_->head % capacity;
+    std::size_t chunk = std::min<uint64_t>({nbytes - amount_read, header_->tail - header_->head, capacity - offset});
+    pthread_mutex_unlock(&header_->mutex);
+
+    std::memcpy(data + amount_read, data_ + offset, chunk);
+
+    lock_robust(&header_->mutex);
+    header_->head += chunk;
+    pthread_cond_broadcast(&header_->not_full);
+    pthread_mutex_unlock(&header_->mutex);
+    amount_read += chunk;
+  }
+  return true;
+}
+
+void SharedMemoryRingBuffer::close() {
+  lock_robust(&header_->mutex);
+  header_->closed = true;
+  pthread_cond_broadcast(&header_->not_empty);
+  pthread_cond_broadcast(&header_->not_full);
+  pthread_mutex_unlock(&header_->mutex);
+}
+
+bool SharedMemoryRingBuffer::is_closed() {
+  lock_robust(&header_->mutex);
+  bool closed = header_->closed;
+  pthread_mutex_unlock(&header_->mutex);
+  return closed;
+}
+
+std::size_t SharedMemoryRingBuffer::capacity() const { return header_->capacity; }
+
+static std::atomic<bool> shared_memory_transport_enabled{false};
+static std::atomic<std::size_t> shared_memory_ring_capacity{64 << 20};
+static std::atomic<uint64_t> shared_memory_cluster_hash{0};
+
+void setSharedMemoryTransport(bool enabled, std::size_t ring_capacity, const std::string &cluster_id) {
+  // FNV-1a, the name has to be the same in every process of the cluster, std::hash does not promise that
+  uint64_t cluster_hash = 14695981039346656037ULL;
+  for (unsigned char c : cluster_id) {
+    cluster_hash = (cluster_hash ^ c) * 1099511628211ULL;
+  }
+  shared_memory_cluster_hash.store(cluster_hash);
+  shared_memory_transport_enabled.store(enabled);
+  shared_memory_ring_capacity.store(ring_capacity);
+}
+
+bool isSharedMemoryTransportEnabled() { return shared_memory_transport_enabled.load(); }
+
+std::size_t getSharedMemoryRingCapacity() { return shared_memory_ring_capacity.load(); }
+
+std::string getSharedMemoryRingName(int16_t communication_port) {
+  char cluster_hash[17];
+  std::snprintf(cluster_hash, sizeof(cluster_hash), "%016llx",
+                static_cast<unsigned long long>(shared_memory_cluster_hash.load()));
+  return "/blazingsql-transport-" + std::string(cluster_hash) + "-" +
+         std::to_string(static_cast<uint16_t>(communication_port));
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
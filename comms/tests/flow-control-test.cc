@@ -0,0 +1,192 @@
+#include <blazingdb/transport/api.h>
+#include <blazingdb/transport/io/reader_writer.h>
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "rmm/rmm.h"
+#include <rmm/device_buffer.hpp>
+
+namespace blazingdb {
+namespace transport {
+
+constexpr uint32_t flow_control_context_token = 4321;
+constexpr std::size_t payload_size = 1 << 20;
+constexpr std::size_t credits_per_sender = 2 * payload_size;
+constexpr int number_of_messages = 16;
+
+TEST(CreditManagerTest, DeniesWhenBudgetIsExhausted) {
+  setFlowControlCreditsPerSender(100);
+  CreditManager credit_manager;
+  auto sender = Address::TCP("127.0.0.1", 8001, 1234).metadata();
+
+  EXPECT_TRUE(credit_manager.tryAcquire(1, sender, 60));
+  EXPECT_FALSE(credit_manager.tryAcquire(1, sender, 60));
+  EXPECT_EQ(credit_manager.outstandingBytes(1, sender), 60);
+
+  credit_manager.release(1, sender, 60);
+  EXPECT_TRUE(credit_manager.tryAcquire(1, sender, 60));
+  setFlowControlCreditsPerSender(0);
+}
+
+TEST(CreditManagerTest, AccountsArePerContextAndSender) {
+  setFlowControlCreditsPerSender(100);
+  CreditManager credit_manager;
+  auto sender = Address::TCP("127.0.0.1", 8001, 1234).metadata();
+  auto other_sender = Address::TCP("127.0.0.1", 8002, 1234).metadata();
+
+  EXPECT_TRUE(credit_manager.tryAcquire(1, sender, 100));
+  EXPECT_TRUE(credit_manager.tryAcquire(1, other_sender, 100));
+  EXPECT_TRUE(credit_manager.tryAcquire(2, sender, 100));
+  EXPECT_FALSE(credit_manager.tryAcquire(1, sender, 1));
+
+  credit_manager.releaseContext(1);
+  EXPECT_EQ(credit_manager.outstandingBytes(1, sender), 0);
+  EXPECT_EQ(credit_manager.outstandingBytes(1, other_sender), 0);
+  EXPECT_EQ(credit_manager.outstandingBytes(2, sender), 100);
+  setFlowControlCreditsPerSender(0);
+}
+
+TEST(CreditManagerTest, OversizedMessageIsGrantedWhenNothingIsOutstanding) {
+  setFlowControlCreditsPerSender(100);
+  CreditManager credit_manager;
+  auto sender = Address::TCP("127.0.0.1", 8001, 1234).metadata();
+
+  EXPECT_TRUE(credit_manager.tryAcquire(1, sender, 1000));
+  EXPECT_FALSE(credit_manager.tryAcquire(1, sender, 1));
+  setFlowControlCreditsPerSender(0);
+}
+
+struct ReceivedPayloadMessage : public ReceivedMessage {
+  ReceivedPayloadMessage(const std::string &messageToken, uint32_t contextToken,
+                         const Node &sender_node)
+      : ReceivedMessage(messageToken, contextToken, sender_node) {}
+};
+
+class PayloadMessage : public GPUMessage {
+public:
+  PayloadMessage(uint32_t contextToken, const Node &sender_node)
+      : GPUMessage(PayloadMessage::MessageID(), contextToken, sender_node),
+        payload(payload_size) {}
+
+  raw_buffer GetRawColumns() override {
+    std::vector<std::size_t> buffer_sizes{payload.size()};
+    std::vector<const char *> buffers{static_cast<const char *>(payload.data())};
+    ColumnTransport column_transport;
+    column_transport.metadata.size = payload.size();
+    column_transport.data = 0;
+    column_transport.valid = -1;
+    column_transport.strings_data = -1;
+    column_transport.strings_offsets = -1;
+    column_transport.strings_nullmask = -1;
+    column_transport.size_in_bytes = payload.size();
+    std::vector<ColumnTransport> column_offsets{column_transport};
+    std::vector<std::unique_ptr<rmm::device_buffer>> temp_scope_holder;
+    return std::make_tuple(buffer_sizes, buffers, column_offsets, std::move(temp_scope_holder));
+  }
+
+  static std::shared_ptr<ReceivedMessage> MakeFromHost(
+      const Message::MetaData &message_metadata,
+      const Address::MetaData &address_metadata,
+      const std::vector<ColumnTransport> &columns_offsets,
+      std::vector<std::basic_string<char>> &&raw_buffers) {
+    Node node(Address::TCP(address_metadata.ip, address_metadata.comunication_port,
+                           address_metadata.protocol_port));
+    return std::make_shared<ReceivedPayloadMessage>(
+        message_metadata.messageToken, message_metadata.contextToken, node);
+  }
+
+  DefineClassName(PayloadMessage);
+
+private:
+  rmm::device_buffer payload;
+};
+
+TEST(ServerContextTest, DeregisteredContextsDoNotGetNewQueues) {
+  std::unique_ptr<Server> server = Server::BatchProcessing(8012);
+  Node sender_node(Address::TCP("127.0.0.1", 8013, 1234));
+  auto endpoint = PayloadMessage::MessageID();
+
+  // a message can arrive before its context is registered in this node
+  std::shared_ptr<ReceivedMessage> early = std::make_shared<ReceivedPayloadMessage>(endpoint, 1, sender_node);
+  server->putMessage(1, early);
+  server->registerContext(1);
+  EXPECT_EQ(server->getMessage(1, endpoint), early);
+
+  // late messages of a finished context are dropped and getting them fails
+  server->deregisterContext(1);
+  std::shared_ptr<ReceivedMessage> late = std::make_shared<ReceivedPayloadMessage>(endpoint, 1, sender_node);
+  server->putMessage(1, late);
+  EXPECT_THROW(server->getMessage(1, endpoint), std::runtime_error);
+  EXPECT_THROW(server->getMessage(2, endpoint), std::runtime_error);
+
+  // the context can be registered again
+  server->registerContext(1);
+  server->putMessage(1, late);
+  EXPECT_EQ(server->getMessage(1, endpoint), late);
+  server->deregisterContext(1);
+  server->Close();
+}
+
+// The consumer takes much longer than the network to process each message, so
+// without credits the whole stream would be buffered on its side.
+static void ExecSlowConsumer() {
+  setFlowControlCreditsPerSender(credits_per_sender);
+  blazingdb::transport::io::setPinnedBufferProvider(payload_size / 4, 1);
+
+  std::unique_ptr<Server> server = Server::BatchProcessing(8010);
+  auto endpoint = PayloadMessage::MessageID();
+  server->registerEndPoint(endpoint);
+  server->registerContext(flow_control_context_token);
+  server->registerHostDeserializerForEndPoint(PayloadMessage::MakeFromHost, endpoint);
+  server->Run();
+
+  int received = 0;
+  while (server->getMessage(flow_control_context_token, endpoint) != nullptr) {
+    received++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  server->Close();
+  exit(received == number_of_messages ? 0 : 1);
+}
+
+static void ExecFastProducer() {
+  setFlowControlCreditsPerSender(credits_per_sender);
+  blazingdb::transport::io::setPinnedBufferProvider(payload_size / 4, 4);
+
+  Node sender_node(Address::TCP("127.0.0.1", 8011, 1234));
+  PayloadMessage message{flow_control_context_token, sender_node};
+
+  for (int i = 0; i < number_of_messages; i++) {
+    auto client = ClientTCP::Make("127.0.0.1", 8010);
+    EXPECT_TRUE(client->Send(message).IsOk());
+  }
+  auto client = ClientTCP::Make("127.0.0.1", 8010);
+  client->notifyLastMessageEvent(message.metadata());
+
+  auto &stats = getFlowControlStats();
+  EXPECT_GT(stats.stalled_sends.load(), 0);
+  EXPECT_GT(stats.stall_time_ns.load(), 0);
+}
+
+TEST(FlowControlTest, SlowConsumerStallsFastProducer) {
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    ExecSlowConsumer();
+  } else {
+    ASSERT_EQ(rmmInitialize(nullptr), RMM_SUCCESS);
+    ExecFastProducer();
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,40 @@
+#include <blazingdb/manager/Context.h>
+
+#include <gtest/gtest.h>
+
+namespace blazingdb {
+namespace manager {
+
+TEST(QueryProfileTest, ClonesShareTheProfile) {
+  Node node(transport::Address::TCP("127.0.0.1", 8001, 1234));
+  Context context(1, {node}, node, "", {});
+  auto clone = context.clone();
+
+  KernelProfile second;
+  second.kernel_id = 2;
+  second.rows_out = 10;
+  clone->getQueryProfile()->addKernelProfile(std::move(second));
+  KernelProfile first;
+  first.kernel_id = 1;
+  context.getQueryProfile()->addKernelProfile(std::move(first));
+
+  auto profiles = context.getQueryProfile()->getKernelProfiles();
+  ASSERT_EQ(profiles.size(), 2);
+  EXPECT_EQ(profiles[0].kernel_id, 1);
+  EXPECT_EQ(profiles[1].kernel_id, 2);
+  EXPECT_EQ(profiles[1].rows_out, 10);
+}
+
+TEST(QueryProfileTest, ContextsHaveTheirOwnProfile) {
+  Node node(transport::Address::TCP("127.0.0.1", 8001, 1234));
+  Context context(1, {node}, node, "", {});
+  Context other(2, {node}, node, "", {});
+
+  context.getQueryProfile()->addKernelProfile(KernelProfile());
+
+  EXPECT_EQ(context.getQueryProfile()->getKernelProfiles().size(), 1);
+  EXPECT_TRUE(other.getQueryProfile()->getKernelProfiles().empty());
+}
+
+}  // namespace manager
+}  // namespace blazingdb
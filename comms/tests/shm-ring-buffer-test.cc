@@ -0,0 +1,106 @@
+#include <blazingdb/transport/io/shm_ring_buffer.h>
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+constexpr const char *test_ring_name = "/blazingsql-transport-test-ring";
+
+TEST(SharedMemoryRingBufferTest, OpenReturnsNullWithoutSegment) {
+  EXPECT_EQ(SharedMemoryRingBuffer::Open("/blazingsql-transport-missing"), nullptr);
+}
+
+TEST(SharedMemoryRingBufferTest, FramesBiggerThanCapacityAreNotInterleaved) {
+  constexpr int number_of_writers = 3;
+  constexpr int frames_per_writer = 100;
+  constexpr std::size_t frame_size = 4567;
+
+  // the frame is bigger than the ring, it must go through it in chunks
+  auto ring = SharedMemoryRingBuffer::Create(test_ring_name, 1000);
+
+  for (int writer = 0; writer < number_of_writers; writer++) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      auto writer_ring = SharedMemoryRingBuffer::Open(test_ring_name);
+      if (writer_ring == nullptr) {
+        _exit(1);
+      }
+      std::vector<char> frame(frame_size);
+      for (int f = 0; f < frames_per_writer; f++) {
+        for (std::size_t i = 0; i < frame_size; i++) {
+          frame[i] = static_cast<char>(writer * 31 + f + i);
+        }
+        int32_t header = writer;
+        writer_ring->lockWriter();
+        writer_ring->write((const char *)&header, sizeof(header));
+        writer_ring->write(frame.data(), frame_size);
+        writer_ring->unlockWriter();
+      }
+      writer_ring.reset();
+      // the inherited owner ring must not be destroyed by the child
+      _exit(0);
+    }
+  }
+
+  std::vector<char> frame(frame_size);
+  std::vector<int> next_frame(number_of_writers, 0);
+  for (int n = 0; n < number_of_writers * frames_per_writer; n++) {
+    int32_t writer;
+    ASSERT_TRUE(ring->read((char *)&writer, sizeof(writer)));
+    ASSERT_TRUE(writer >= 0 && writer < number_of_writers);
+    ASSERT_TRUE(ring->read(frame.data(), frame_size));
+    int f = next_frame[writer]++;
+    for (std::size_t i = 0; i < frame_size; i++) {
+      ASSERT_EQ(frame[i], static_cast<char>(writer * 31 + f + i));
+    }
+  }
+
+  for (int writer = 0; writer < number_of_writers; writer++) {
+    int status = 0;
+    wait(&status);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+TEST(SharedMemoryRingBufferTest, CloseWakesUpReaderAndWriters) {
+  auto ring = SharedMemoryRingBuffer::Create(test_ring_name, 16);
+
+  std::thread reader([&ring]() {
+    char c;
+    EXPECT_FALSE(ring->read(&c, 1));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ring->close();
+  reader.join();
+
+  char data[4] = {0};
+  EXPECT_THROW(ring->write(data, sizeof(data)), SharedMemoryRingClosedError);
+  EXPECT_EQ(SharedMemoryRingBuffer::Open(test_ring_name), nullptr);
+}
+
+TEST(SharedMemoryRingBufferTest, FailedCopyClosesTheRing) {
+  auto ring = SharedMemoryRingBuffer::Create(test_ring_name, 16);
+
+  char data[4] = {0};
+  auto failing_copy = [](char *, const char *, std::size_t) { throw std::runtime_error("copy failed"); };
+  EXPECT_THROW(ring->write(data, sizeof(data), failing_copy), std::runtime_error);
+
+  // the reader does not wait for the rest of the frame
+  EXPECT_TRUE(ring->is_closed());
+  char c;
+  EXPECT_FALSE(ring->read(&c, 1));
+  EXPECT_THROW(ring->write(data, sizeof(data)), SharedMemoryRingClosedError);
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
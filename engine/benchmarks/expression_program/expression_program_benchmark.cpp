@@ -0,0 +1,85 @@
+#include "execution_graph/logic_controllers/LogicalProject.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+// A wide projection, like the ones Calcite generates for TPC-H style queries, made of the same few expressions over and over.
+static std::vector<std::string> make_wide_projection(int num_expressions) {
+	const std::vector<std::string> expressions = {"+($0, $2)",
+		"*(-(1, $1), $1)",
+		"CASE(>($0, 100), $1, *($1, 0.5))",
+		"$2",
+		"-(FLOOR(+(POWER(SIN($1), 2), POWER(COS($1), 2))), CEIL($1))",
+		"10"};
+
+	std::vector<std::string> projection;
+	for(int i = 0; i < num_expressions; i++) {
+		projection.push_back(expressions[i % expressions.size()]);
+	}
+	return projection;
+}
+
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 10; num_rows <= 1 << 16; num_rows *= 8)
+		for(int64_t num_expressions : {4, 32})
+			b->Args({num_rows, num_expressions});
+}
+
+struct ExpressionProgramBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		std::vector<int32_t> x(state.range(0));
+		std::vector<double> y(state.range(0));
+		std::vector<int32_t> z(state.range(0));
+		std::generate(x.begin(), x.end(), []() { return std::rand() % 1000; });
+		std::generate(y.begin(), y.end(), []() { return (std::rand() % 1000) / 10.0; });
+		std::iota(z.begin(), z.end(), 0);
+
+		x_column = std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(x.begin(), x.end());
+		y_column = std::make_unique<cudf::test::fixed_width_column_wrapper<double>>(y.begin(), y.end());
+		z_column = std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(z.begin(), z.end());
+		expressions = make_wide_projection(state.range(1));
+	}
+
+	void TearDown(benchmark::State & state) override {
+		x_column.reset();
+		y_column.reset();
+		z_column.reset();
+	}
+
+	// a batch as it comes out of a cache, with views of the columns
+	std::vector<std::unique_ptr<ral::frame::BlazingColumn>> make_batch() {
+		std::vector<std::unique_ptr<ral::frame::BlazingColumn>> columns;
+		columns.push_back(std::make_unique<ral::frame::BlazingColumnView>(*x_column));
+		columns.push_back(std::make_unique<ral::frame::BlazingColumnView>(*y_column));
+		columns.push_back(std::make_unique<ral::frame::BlazingColumnView>(*z_column));
+		return columns;
+	}
+
+	std::unique_ptr<cudf::test::fixed_width_column_wrapper<int32_t>> x_column;
+	std::unique_ptr<cudf::test::fixed_width_column_wrapper<double>> y_column;
+	std::unique_ptr<cudf::test::fixed_width_column_wrapper<int32_t>> z_column;
+	std::vector<std::string> expressions;
+};
+
+// What the kernels did before, the expressions are parsed and planned for every batch
+BENCHMARK_DEFINE_F(ExpressionProgramBench, ParsePerBatch)(benchmark::State & state) {
+	for(auto _ : state) {
+		auto out = ral::processor::evaluate_expressions(make_batch(), expressions);
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(ExpressionProgramBench, ParsePerBatch)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond);
+
+// The program is built once, like in the constructors of the Projection and Filter kernels
+BENCHMARK_DEFINE_F(ExpressionProgramBench, CompiledProgram)(benchmark::State & state) {
+	ral::processor::expression_program program(expressions);
+	for(auto _ : state) {
+		auto out = program.evaluate(make_batch());
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(ExpressionProgramBench, CompiledProgram)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond);
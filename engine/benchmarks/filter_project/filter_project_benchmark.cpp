@@ -0,0 +1,103 @@
+#include "execution_graph/logic_controllers/PhysicalPlanGenerator.h"
+#include "io/data_parser/GDFParser.h"
+#include "io/data_provider/DummyProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+// each batch is a partition of the gdf table
+const int NUM_BATCHES = 16;
+
+// SELECT a + b AS s, a * 2 AS d FROM (SELECT a, b, c * 3 AS e FROM t) WHERE e > x, where x sets the selectivity
+static std::string filter_project_plan(int64_t threshold) {
+	return R"J({"expr": "LogicalProject(s=[+($0, $1)], d=[*($0, 2)])", "children": [
+		{"expr": "LogicalFilter(condition=[>($2, )J" + std::to_string(threshold) + R"J()])", "children": [
+			{"expr": "LogicalProject(a=[$0], b=[$1], e=[*($2, 3)])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]}]}]})J";
+}
+
+// rows, percentage of the rows that pass the filter
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 20; num_rows <= 1 << 26; num_rows *= 8)
+		for(int64_t selectivity : {1, 50, 100})
+			b->Args({num_rows, selectivity});
+}
+
+struct FilterProjectBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		int64_t batch_rows = state.range(0) / NUM_BATCHES;
+		for(int i = 0; i < NUM_BATCHES; i++) {
+			std::vector<int64_t> a(batch_rows);
+			std::vector<int64_t> b(batch_rows);
+			std::vector<int64_t> c(batch_rows);
+			std::generate(a.begin(), a.end(), []() { return std::rand(); });
+			std::generate(b.begin(), b.end(), []() { return std::rand(); });
+			std::generate(c.begin(), c.end(), []() { return std::rand() % 100; });
+			columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(a.begin(), a.end()));
+			columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(b.begin(), b.end()));
+			columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(c.begin(), c.end()));
+		}
+
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown(benchmark::State & state) override {
+		columns.clear();
+	}
+
+	void run_query(benchmark::State & state, bool fuse) {
+		std::vector<ral::frame::BlazingTableView> batches;
+		for(int i = 0; i < NUM_BATCHES; i++) {
+			batches.emplace_back(cudf::table_view{{*columns[3 * i], *columns[3 * i + 1], *columns[3 * i + 2]}},
+				std::vector<std::string>{"a", "b", "c"});
+		}
+		auto parser = std::make_shared<ral::io::gdf_parser>(batches);
+		auto provider = std::make_shared<ral::io::dummy_data_provider>();
+		std::vector<ral::io::data_loader> loaders = {ral::io::data_loader(parser, provider)};
+		std::vector<ral::io::Schema> schemas = {ral::io::Schema({"a", "b", "c"},
+			{cudf::type_id::INT64, cudf::type_id::INT64, cudf::type_id::INT64})};
+
+		// c * 3 is in [0, 300), so the rows with e > 3 * (100 - selectivity) - 1 are selectivity percent of them
+		auto plan = ral::parser::build_physical_plan(filter_project_plan(3 * (100 - state.range(1)) - 1));
+		if(fuse) {
+			plan = ral::parser::rewrite_plan(plan, ral::parser::get_physical_rewrite_rules(1));
+		}
+
+		for(auto _ : state) {
+			Context context(0, contextNodes, contextNodes[0], "", {});
+			ral::batch::tree_processor tree{
+				.root = {},
+				.context = context.clone(),
+				.input_loaders = loaders,
+				.schemas = schemas,
+				.table_names = {"t"},
+				.transform_operators_bigger_than_gpu = true
+			};
+			ral::batch::OutputKernel output;
+			auto query_graph = tree.build_batch_graph(*plan);
+			*query_graph += link(query_graph->get_last_kernel(), output, ral::cache::cache_settings{.type = ral::cache::CacheType::CONCATENATING});
+			query_graph->execute();
+			auto result = output.release();
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int64_t>>> columns;
+	std::vector<Node> contextNodes;
+};
+
+BENCHMARK_DEFINE_F(FilterProjectBench, Unfused)(benchmark::State & state) {
+	run_query(state, false);
+}
+BENCHMARK_REGISTER_F(FilterProjectBench, Unfused)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_DEFINE_F(FilterProjectBench, Fused)(benchmark::State & state) {
+	run_query(state, true);
+}
+BENCHMARK_REGISTER_F(FilterProjectBench, Fused)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
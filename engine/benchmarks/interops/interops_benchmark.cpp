@@ -17,17 +17,16 @@
  */
 
 #include "Interpreter/interpreter_cpp.h"
-#include "gdf/library/api.h"
-#include <CalciteInterpreter.h>
-#include <DataFrame.h>
-#include <Utils.cuh>
+#include "Interpreter/interpreter_cpu.h"
+#include "CalciteExpressionParsing.h"
+#include "execution_graph/logic_controllers/LogicalProject.h"
+#include "parser/expression_tree.hpp"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
 #include <algorithm>
 #include <benchmark/benchmark.h>
 #include <cstdlib>
 #include <utility>
 
-using namespace gdf::library;
-
 static std::vector<std::string> LOGICAL_PLANS = {"LogicalProject(EXPR$0=[+($0, $2)])",
 	"LogicalProject(EXPR$0=[*(SIN(/(+($0, $2), $1)), POWER(/(-($0, $2), $1), 2))])",
 	"LogicalProject(EXPR$1=[-(FLOOR(+(POWER(SIN($1), 2), POWER(COS($1), 2))), CEIL(+(POWER(SIN(+($1, 53.42)), 2), "
@@ -43,69 +42,107 @@ static void CustomArguments(benchmark::internal::Benchmark * b) {
 			b->Args({i, j});
 }
 
-template <int logPlanIndex>
+// the host backend also goes over the number of threads, 0 lets it pick one per core
+static void CpuArguments(benchmark::internal::Benchmark * b) {
+	for(int i = 0; i < LOGICAL_PLANS.size(); ++i)
+		for(int64_t j = 50 << 10; j <= 80 << 20; j *= 6)
+			for(int64_t threads : {1, 0})
+				b->Args({i, j, threads});
+}
+
 struct InterOpsBench : public benchmark::Fixture {
 public:
-	void SetUp(benchmark::State & state) override {}
+	void SetUp(benchmark::State & state) override {
+		x.resize(state.range(1));
+		std::generate(x.begin(), x.end(), []() { return std::rand() % (RAND_MAX / 13); });
+		y.resize(state.range(1));
+		std::generate(y.begin(), y.end(), []() { return ((std::rand() % RAND_MAX) + 1); });
+		z.resize(state.range(1));
+		std::generate(z.begin(), z.end(), []() { return std::rand() % (RAND_MAX / 2); });
+
+		std::vector<std::string> column_names;
+		ral::processor::get_project_expressions(LOGICAL_PLANS[state.range(0)], expressions, column_names);
+	}
 
 	void TearDown(benchmark::State & state) override {}
 
-	std::string logicalPlan;
-};
-
-
-BENCHMARK_TEMPLATE_DEFINE_F(InterOpsBench, SimpleBench, 4)
-(benchmark::State & state) {
-	logicalPlan = LOGICAL_PLANS[state.range(0)];
+	// the columns in host memory
+	cudf::table_view host_table() {
+		return cudf::table_view{{cudf::column_view{cudf::data_type{cudf::type_id::INT32}, static_cast<cudf::size_type>(x.size()), x.data()},
+			cudf::column_view{cudf::data_type{cudf::type_id::FLOAT64}, static_cast<cudf::size_type>(y.size()), y.data()},
+			cudf::column_view{cudf::data_type{cudf::type_id::INT32}, static_cast<cudf::size_type>(z.size()), z.data()}}};
+	}
 
 	std::vector<int32_t> x;
 	std::vector<double> y;
 	std::vector<int32_t> z;
-	x.resize(state.range(1));
-	std::generate(x.begin(), x.end(), []() { return std::rand() % (RAND_MAX / 13); });
-	y.resize(state.range(1));
-	std::generate(y.begin(), y.end(), []() { return ((std::rand() % RAND_MAX) + 1); });
-	z.resize(state.range(1));
-	std::generate(z.begin(), z.end(), []() { return std::rand() % (RAND_MAX / 2); });
-
-	gdf::library::TableGroup tableGroup =
-		LiteralTableGroupBuilder{{"temp",
-									 {{"in_x", Literals<GDF_INT32>{std::move(x)}},
-										 {"in_y", Literals<GDF_FLOAT64>{std::move(y)}},
-										 {"in_z", Literals<GDF_INT32>{std::move(z)}}}}}
-			.Build();
-	auto input_tables = tableGroup.ToBlazingFrame();
-
-	blazing_frame bz_frame, bz_out;
+	std::vector<std::string> expressions;
+};
+
+BENCHMARK_DEFINE_F(InterOpsBench, SimpleBench)
+(benchmark::State & state) {
+	cudf::test::fixed_width_column_wrapper<int32_t> x_column(x.begin(), x.end());
+	cudf::test::fixed_width_column_wrapper<double> y_column(y.begin(), y.end());
+	cudf::test::fixed_width_column_wrapper<int32_t> z_column(z.begin(), z.end());
 
 	for(auto _ : state) {
-		state.PauseTiming();
-		bz_frame.clear();
-		for(auto & t : input_tables)
-			bz_frame.add_table(t);
-		state.ResumeTiming();
-
-		auto params = parse_project_plan(bz_frame, logicalPlan);
-		if(params.num_expressions_out <= 0) {
-			state.SkipWithError("num_expressions_out is not good!");
-			break;
-		}
-
-		perform_operation(params.output_columns,
-			params.input_columns,
-			params.left_inputs,
-			params.right_inputs,
-			params.outputs,
-			params.final_output_positions,
-			params.operators,
-			params.unary_operators,
-			params.left_scalars,
-			params.right_scalars,
-			params.new_column_indices);
-
-		bz_out.clear();
-		bz_out.add_table(params.columns);
+		std::vector<std::unique_ptr<ral::frame::BlazingColumn>> columns;
+		columns.push_back(std::make_unique<ral::frame::BlazingColumnView>(x_column));
+		columns.push_back(std::make_unique<ral::frame::BlazingColumnView>(y_column));
+		columns.push_back(std::make_unique<ral::frame::BlazingColumnView>(z_column));
+
+		auto out = ral::processor::evaluate_expressions(std::move(columns), expressions);
+		benchmark::DoNotOptimize(out);
 	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * state.range(1));
 }
 
 BENCHMARK_REGISTER_F(InterOpsBench, SimpleBench)->Apply(CustomArguments)->Unit(benchmark::kMillisecond);
+
+// The same expressions through the host backend, the plan is built once and only the interpreter is timed
+BENCHMARK_DEFINE_F(InterOpsBench, CpuBench)
+(benchmark::State & state) {
+	using namespace interops;
+
+	cudf::table_view table = host_table();
+
+	std::vector<column_index_type> left_inputs;
+	std::vector<column_index_type> right_inputs;
+	std::vector<column_index_type> outputs;
+	std::vector<column_index_type> final_output_positions;
+	std::vector<operator_type> operators;
+	std::vector<std::unique_ptr<cudf::scalar>> left_scalars;
+	std::vector<std::unique_ptr<cudf::scalar>> right_scalars;
+
+	std::vector<std::vector<int64_t>> out_data(expressions.size(), std::vector<int64_t>(table.num_rows()));
+	std::vector<std::vector<cudf::bitmask_type>> out_valids(expressions.size(), std::vector<cudf::bitmask_type>((table.num_rows() + 31) / 32));
+	std::vector<cudf::mutable_column_view> out_columns;
+	for(size_t i = 0; i < expressions.size(); i++) {
+		parser::parse_tree parse_tree;
+		parse_tree.build(replace_calcite_regex(expressions[i]));
+		parse_tree.transform_to_custom_op();
+		std::string expression = parse_tree.rebuildExpression();
+
+		std::vector<std::string> tokens = get_tokens_in_reverse_order(clean_calcite_expression(expression));
+		final_output_positions.push_back(table.num_columns() + i);
+		add_expression_to_interpreter_plan(tokens, table, {{0, 0}, {1, 1}, {2, 2}}, i, expressions.size(),
+			left_inputs, right_inputs, outputs, operators, left_scalars, right_scalars);
+
+		// every fixed width type fits in the 8 bytes of each row of out_data
+		cudf::type_id output_type = get_output_type_expression(table, expression);
+		out_columns.emplace_back(cudf::data_type{output_type}, table.num_rows(), out_data[i].data(), out_valids[i].data());
+	}
+	cudf::mutable_table_view out_table(out_columns);
+
+	std::vector<cpu::host_scalar> host_left_scalars = cpu::to_host_scalars(left_scalars);
+	std::vector<cpu::host_scalar> host_right_scalars = cpu::to_host_scalars(right_scalars);
+
+	for(auto _ : state) {
+		cpu::perform_interpreter_operation(out_table, table, left_inputs, right_inputs, outputs, final_output_positions,
+			operators, host_left_scalars, host_right_scalars, state.range(2));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * state.range(1));
+}
+
+BENCHMARK_REGISTER_F(InterOpsBench, CpuBench)->Apply(CpuArguments)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,93 @@
+#include "execution_graph/logic_controllers/BatchProcessing.h"
+#include "io/data_parser/ParquetParser.h"
+#include "io/data_provider/UriDataProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+// a wide file sorted by its first column, so that the rows that a range filter keeps are together
+const int64_t NUM_ROWS = 1 << 23;
+const int NUM_PAYLOAD_COLUMNS = 8;
+const std::string PARQUET_FILE = "/tmp/late_materialization_benchmark.parquet";
+
+// late materialization, percent of the rows that the filter keeps
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t late : {0, 1})
+		for(int64_t selectivity : {0, 1, 10, 50, 100})
+			b->Args({late, selectivity});
+}
+
+struct LateMaterializationBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+
+		// the file is written once and kept for the other runs
+		if(!std::ifstream(PARQUET_FILE).good()) {
+			std::vector<int64_t> key(NUM_ROWS);
+			std::iota(key.begin(), key.end(), 0);
+			std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int64_t>>> columns;
+			columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(key.begin(), key.end()));
+			std::vector<int64_t> payload(NUM_ROWS);
+			for(int i = 0; i < NUM_PAYLOAD_COLUMNS; i++) {
+				std::generate(payload.begin(), payload.end(), []() { return std::rand(); });
+				columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(payload.begin(), payload.end()));
+			}
+			std::vector<cudf::column_view> views;
+			for(auto & column : columns) {
+				views.push_back(*column);
+			}
+			cudf::experimental::io::write_parquet_args out_args{
+				cudf::experimental::io::sink_info{PARQUET_FILE}, cudf::table_view{views}};
+			cudf::experimental::io::write_parquet(out_args);
+		}
+	}
+
+	void TearDown(benchmark::State & state) override {}
+
+	std::vector<Node> contextNodes;
+};
+
+// Scans the file with a filter on the first column and counts the bytes of the columns that are decoded
+BENCHMARK_DEFINE_F(LateMaterializationBench, RangeFilter)(benchmark::State & state) {
+	std::string condition = "<($0, " + std::to_string(NUM_ROWS * state.range(1) / 100) + ")";
+	std::map<std::string, std::string> config_options = {
+		{"ENABLE_LATE_MATERIALIZATION", state.range(0) ? "true" : "false"},
+		{"SCAN_UNIT_TARGET_BYTES", "64000000"}};
+
+	auto parser = std::make_shared<ral::io::parquet_parser>();
+	int64_t bytes_decoded = 0;
+	int64_t rows_kept = 0;
+	for(auto _ : state) {
+		auto provider = std::make_shared<ral::io::uri_data_provider>(std::vector<Uri>{Uri{PARQUET_FILE}});
+		ral::io::data_loader loader(parser, provider);
+		ral::io::Schema schema;
+		loader.get_schema(schema, {});
+
+		Context context(0, contextNodes, contextNodes[0], "", config_options);
+		ral::batch::DataSourceSequence input(loader, schema, context.clone());
+		input.set_late_materialization_filter(condition);
+		ral::processor::expression_program filter_program({condition});
+
+		bytes_decoded = 0;
+		rows_kept = 0;
+		while(auto batch = input.next()) {
+			bytes_decoded += batch->sizeInBytes();
+			auto filtered = ral::processor::process_filter(batch->toBlazingTableView(), filter_program);
+			rows_kept += filtered->num_rows();
+			benchmark::DoNotOptimize(filtered);
+		}
+		// the first column of the rows whose other columns were not read was decoded too
+		bytes_decoded += input.get_late_materialization_stats().second * sizeof(int64_t);
+	}
+	state.counters["bytes_decoded"] = bytes_decoded;
+	state.counters["rows_kept"] = rows_kept;
+	state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK_REGISTER_F(LateMaterializationBench, RangeFilter)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
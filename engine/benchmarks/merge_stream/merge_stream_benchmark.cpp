@@ -0,0 +1,127 @@
+#include "execution_graph/logic_controllers/BatchOrderByProcessing.h"
+#include "execution_graph/logic_controllers/taskflow/graph.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+using ral::cache::kernel;
+using ral::cache::kstatus;
+
+// The sorted runs of one partition, as the Partition kernel leaves them in the cache of the MergeStream
+class SortedRunsKernel : public kernel {
+public:
+	SortedRunsKernel(const std::vector<ral::frame::BlazingTableView> & runs, std::shared_ptr<Context> context)
+		: kernel("", context), runs(runs) {}
+
+	bool can_you_throttle_my_input() { return false; }
+
+	virtual kstatus run() {
+		for(auto & run : runs) {
+			this->add_to_output_cache(run.clone(), "output_0");
+		}
+		return kstatus::proceed;
+	}
+
+private:
+	std::vector<ral::frame::BlazingTableView> runs;
+};
+
+// Consumes the output of the MergeStream and records when its first rows arrive
+class FirstRowsKernel : public kernel {
+public:
+	FirstRowsKernel() : kernel("FirstRowsKernel", nullptr) {}
+
+	bool can_you_throttle_my_input() { return false; }
+
+	virtual kstatus run() {
+		auto start = std::chrono::high_resolution_clock::now();
+		while(this->input_.get_cache()->wait_for_next()) {
+			auto batch = this->input_.get_cache()->pullFromCache();
+			if(batch && num_rows == 0 && batch->num_rows() > 0) {
+				time_to_first_rows = std::chrono::high_resolution_clock::now() - start;
+			}
+			num_rows += batch ? batch->num_rows() : 0;
+		}
+		return kstatus::stop;
+	}
+
+	std::chrono::duration<double> time_to_first_rows{0};
+	std::size_t num_rows = 0;
+};
+
+static const std::string merge_expression = "LogicalMerge(sort0=[$0], dir0=[ASC])";
+
+// rows, number of runs
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 22; num_rows <= 1 << 26; num_rows *= 4)
+		for(int64_t num_runs : {4, 32})
+			b->Args({num_rows, num_runs});
+}
+
+struct MergeStreamBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		int64_t run_rows = state.range(0) / state.range(1);
+		for(int64_t i = 0; i < state.range(1); i++) {
+			std::vector<int64_t> keys(run_rows);
+			std::vector<double> values(run_rows);
+			std::generate(keys.begin(), keys.end(), []() { return std::rand(); });
+			std::sort(keys.begin(), keys.end());
+			std::generate(values.begin(), values.end(), []() { return (std::rand() % 1000) / 10.0; });
+			key_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(keys.begin(), keys.end()));
+			value_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<double>>(values.begin(), values.end()));
+		}
+
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown(benchmark::State & state) override {
+		key_columns.clear();
+		value_columns.clear();
+	}
+
+	void run_merge(benchmark::State & state, const std::map<std::string, std::string> & config_options) {
+		std::vector<ral::frame::BlazingTableView> runs;
+		for(size_t i = 0; i < key_columns.size(); i++) {
+			runs.emplace_back(cudf::table_view{{*key_columns[i], *value_columns[i]}}, std::vector<std::string>{"k", "v"});
+		}
+
+		double time_to_first_rows = 0;
+		for(auto _ : state) {
+			auto context = std::make_shared<Context>(0, contextNodes, contextNodes[0], "", config_options);
+			SortedRunsKernel sorted_runs(runs, context);
+			ral::batch::MergeStreamKernel merge(*ral::parser::parse_plan_node(merge_expression), context, nullptr);
+			FirstRowsKernel first_rows;
+
+			ral::cache::graph m;
+			m += link(sorted_runs, merge, ral::cache::cache_settings{.type = ral::cache::CacheType::FOR_EACH, .num_partitions = 1});
+			m += link(merge, first_rows, ral::cache::cache_settings{.type = ral::cache::CacheType::SIMPLE});
+			m.execute();
+
+			time_to_first_rows += first_rows.time_to_first_rows.count();
+			benchmark::DoNotOptimize(first_rows.num_rows);
+		}
+		state.counters["time_to_first_rows_ms"] = benchmark::Counter(time_to_first_rows * 1000, benchmark::Counter::kAvgIterations);
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int64_t>>> key_columns;
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<double>>> value_columns;
+	std::vector<Node> contextNodes;
+};
+
+// A single slice of every run, which merges the whole partition at once
+BENCHMARK_DEFINE_F(MergeStreamBench, WholePartition)(benchmark::State & state) {
+	run_merge(state, {{"MERGE_STREAM_BATCH_BYTES", std::to_string(std::numeric_limits<std::size_t>::max() / 2)}});
+}
+BENCHMARK_REGISTER_F(MergeStreamBench, WholePartition)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_DEFINE_F(MergeStreamBench, Streaming)(benchmark::State & state) {
+	run_merge(state, {});
+}
+BENCHMARK_REGISTER_F(MergeStreamBench, Streaming)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
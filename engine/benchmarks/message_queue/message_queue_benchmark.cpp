@@ -0,0 +1,58 @@
+#include <blazingdb/transport/MessageQueue.h>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using blazingdb::transport::MessageQueue;
+using blazingdb::transport::Node;
+using blazingdb::transport::ReceivedMessage;
+
+// One waiting thread per message token, like the kernels of many concurrent
+// queries waiting on their own partitions. The producer interleaves the tokens
+// so every put lands in a queue holding messages for all the other tokens.
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_tokens = 8; num_tokens <= 512; num_tokens *= 4)
+		for(int64_t messages_per_token = 16; messages_per_token <= 256; messages_per_token *= 4)
+			b->Args({num_tokens, messages_per_token});
+}
+
+static void BM_MessageQueueManyWaiters(benchmark::State & state) {
+	const int num_tokens = state.range(0);
+	const int messages_per_token = state.range(1);
+
+	Node sender_node;
+	std::vector<std::string> tokens;
+	for(int i = 0; i < num_tokens; i++) {
+		tokens.push_back("ColumnDataPartitionMessage_" + std::to_string(i));
+	}
+
+	for(auto _ : state) {
+		MessageQueue message_queue;
+
+		std::vector<std::thread> waiters;
+		for(int i = 0; i < num_tokens; i++) {
+			waiters.emplace_back([&message_queue, &tokens, i, messages_per_token]() {
+				for(int j = 0; j < messages_per_token; j++) {
+					benchmark::DoNotOptimize(message_queue.getMessage(tokens[i]));
+				}
+			});
+		}
+
+		for(int j = 0; j < messages_per_token; j++) {
+			for(int i = 0; i < num_tokens; i++) {
+				auto message = std::make_shared<ReceivedMessage>(tokens[i], 0, sender_node);
+				message_queue.putMessage(message);
+			}
+		}
+
+		for(auto & waiter : waiters) {
+			waiter.join();
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * num_tokens * messages_per_token);
+}
+
+BENCHMARK(BM_MessageQueueManyWaiters)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,352 @@
+#include "io/data_parser/ParquetParser.h"
+#include <arrow/io/file.h>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+// a single file, sorted by key, whose column chunks have a page index
+const int64_t NUM_ROWS = 1 << 24;
+const int64_t ROWS_PER_ROW_GROUP = 1 << 20;
+const int64_t ROWS_PER_PAGE = 1 << 13;
+const std::string PARQUET_FILE = "/tmp/page_index_benchmark.parquet";
+
+// use the page index, rows of the range of keys that the filter keeps
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t use_page_index : {0, 1})
+		for(int64_t range_rows : {1 << 10, 1 << 14, 1 << 18})
+			b->Args({use_page_index, range_rows});
+}
+
+// arrow 0.15 does not write page indexes yet, so the file is written with the minimum that a reader needs: REQUIRED INT64
+// columns, PLAIN encoded, uncompressed, in v1 data pages, with the statistics of each column chunk and its page index
+class thrift_compact_writer {
+public:
+	void field(int16_t id, uint8_t type) {
+		if(id > last_id && id - last_id <= 15) {
+			byte(((id - last_id) << 4) | type);
+		} else {
+			byte(type);
+			zigzag(id);
+		}
+		last_id = id;
+	}
+	void i32(int16_t id, int32_t value) {
+		field(id, 5);
+		zigzag(value);
+	}
+	void i64(int16_t id, int64_t value) {
+		field(id, 6);
+		zigzag(value);
+	}
+	void binary(int16_t id, const std::string & value) {
+		field(id, 8);
+		binary(value);
+	}
+	void binary(const std::string & value) {
+		varint(value.size());
+		bytes.append(value);
+	}
+	void list(int16_t id, uint8_t element_type, size_t size) {
+		field(id, 9);
+		list(element_type, size);
+	}
+	void list(uint8_t element_type, size_t size) {
+		if(size < 15) {
+			byte((size << 4) | element_type);
+		} else {
+			byte(0xf0 | element_type);
+			varint(size);
+		}
+	}
+	void begin_struct(int16_t id) {
+		field(id, 12);
+		begin_struct();
+	}
+	void begin_struct() {
+		last_ids.push_back(last_id);
+		last_id = 0;
+	}
+	void end_struct() {
+		byte(0);
+		last_id = last_ids.back();
+		last_ids.pop_back();
+	}
+	void zigzag(int64_t value) { varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); }
+	void varint(uint64_t value) {
+		while(value >= 0x80) {
+			byte(static_cast<uint8_t>(value) | 0x80);
+			value >>= 7;
+		}
+		byte(static_cast<uint8_t>(value));
+	}
+	void byte(uint8_t value) { bytes.push_back(static_cast<char>(value)); }
+
+	std::string bytes;
+
+private:
+	int16_t last_id = 0;
+	std::vector<int16_t> last_ids;
+};
+
+std::string plain(int64_t value) { return std::string(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+// key is the row, value is random
+void write_parquet_file_with_page_index() {
+	const std::vector<std::string> names = {"key", "value"};
+	const int64_t num_row_groups = NUM_ROWS / ROWS_PER_ROW_GROUP;
+	const int64_t pages_per_chunk = ROWS_PER_ROW_GROUP / ROWS_PER_PAGE;
+	const int64_t page_bytes = ROWS_PER_PAGE * sizeof(int64_t);
+
+	struct column_chunk {
+		int64_t offset;
+		int64_t size;
+		int64_t min;
+		int64_t max;
+		std::vector<int64_t> page_min;
+		std::vector<int64_t> page_max;
+		int64_t column_index_offset;
+		int64_t column_index_length;
+		int64_t offset_index_offset;
+		int64_t offset_index_length;
+	};
+	std::vector<std::vector<column_chunk>> chunks(num_row_groups, std::vector<column_chunk>(names.size()));
+
+	std::ofstream out(PARQUET_FILE, std::ios::binary);
+	int64_t offset = 4;
+	out.write("PAR1", 4);
+	std::vector<int64_t> values(ROWS_PER_PAGE);
+	for(int64_t row_group = 0; row_group < num_row_groups; row_group++) {
+		for(size_t column = 0; column < names.size(); column++) {
+			column_chunk & chunk = chunks[row_group][column];
+			chunk.offset = offset;
+			for(int64_t page = 0; page < pages_per_chunk; page++) {
+				int64_t first_row = row_group * ROWS_PER_ROW_GROUP + page * ROWS_PER_PAGE;
+				for(int64_t i = 0; i < ROWS_PER_PAGE; i++) {
+					values[i] = column == 0 ? first_row + i : std::rand();
+				}
+				chunk.page_min.push_back(*std::min_element(values.begin(), values.end()));
+				chunk.page_max.push_back(*std::max_element(values.begin(), values.end()));
+
+				thrift_compact_writer header;
+				header.begin_struct();
+				header.i32(1, 0);  // DATA_PAGE
+				header.i32(2, page_bytes);
+				header.i32(3, page_bytes);
+				header.begin_struct(5);
+				header.i32(1, ROWS_PER_PAGE);
+				header.i32(2, 0);  // PLAIN
+				header.i32(3, 3);  // RLE
+				header.i32(4, 3);
+				header.end_struct();
+				header.end_struct();
+				out.write(header.bytes.data(), header.bytes.size());
+				out.write(reinterpret_cast<const char *>(values.data()), page_bytes);
+				offset += header.bytes.size() + page_bytes;
+			}
+			chunk.size = offset - chunk.offset;
+			chunk.min = *std::min_element(chunk.page_min.begin(), chunk.page_min.end());
+			chunk.max = *std::max_element(chunk.page_max.begin(), chunk.page_max.end());
+		}
+	}
+
+	// the page index of every column chunk goes after the row groups
+	for(int64_t row_group = 0; row_group < num_row_groups; row_group++) {
+		for(size_t column = 0; column < names.size(); column++) {
+			column_chunk & chunk = chunks[row_group][column];
+			thrift_compact_writer column_index;
+			column_index.begin_struct();
+			column_index.list(1, 1, pages_per_chunk);
+			for(int64_t page = 0; page < pages_per_chunk; page++) {
+				column_index.byte(2);  // false
+			}
+			column_index.list(2, 8, pages_per_chunk);
+			for(int64_t page = 0; page < pages_per_chunk; page++) {
+				column_index.binary(plain(chunk.page_min[page]));
+			}
+			column_index.list(3, 8, pages_per_chunk);
+			for(int64_t page = 0; page < pages_per_chunk; page++) {
+				column_index.binary(plain(chunk.page_max[page]));
+			}
+			column_index.i32(4, column == 0 ? 1 : 0);  // ASCENDING or UNORDERED
+			column_index.end_struct();
+			chunk.column_index_offset = offset;
+			chunk.column_index_length = column_index.bytes.size();
+			out.write(column_index.bytes.data(), column_index.bytes.size());
+			offset += column_index.bytes.size();
+
+			thrift_compact_writer offset_index;
+			offset_index.begin_struct();
+			offset_index.list(1, 12, pages_per_chunk);
+			int64_t page_offset = chunk.offset;
+			int64_t page_size = chunk.size / pages_per_chunk;
+			for(int64_t page = 0; page < pages_per_chunk; page++) {
+				offset_index.begin_struct();
+				offset_index.i64(1, page_offset);
+				offset_index.i32(2, page_size);
+				offset_index.i64(3, page * ROWS_PER_PAGE);
+				offset_index.end_struct();
+				page_offset += page_size;
+			}
+			offset_index.end_struct();
+			chunk.offset_index_offset = offset;
+			chunk.offset_index_length = offset_index.bytes.size();
+			out.write(offset_index.bytes.data(), offset_index.bytes.size());
+			offset += offset_index.bytes.size();
+		}
+	}
+
+	thrift_compact_writer footer;
+	footer.begin_struct();
+	footer.i32(1, 1);
+	footer.list(2, 12, names.size() + 1);
+	footer.begin_struct();
+	footer.binary(4, "schema");
+	footer.i32(5, names.size());
+	footer.end_struct();
+	for(auto & name : names) {
+		footer.begin_struct();
+		footer.i32(1, 2);  // INT64
+		footer.i32(3, 0);  // REQUIRED
+		footer.binary(4, name);
+		footer.end_struct();
+	}
+	footer.i64(3, NUM_ROWS);
+	footer.list(4, 12, num_row_groups);
+	for(int64_t row_group = 0; row_group < num_row_groups; row_group++) {
+		footer.begin_struct();
+		footer.list(1, 12, names.size());
+		int64_t total_byte_size = 0;
+		for(size_t column = 0; column < names.size(); column++) {
+			column_chunk & chunk = chunks[row_group][column];
+			total_byte_size += chunk.size;
+			footer.begin_struct();
+			footer.i64(2, chunk.offset);
+			footer.begin_struct(3);
+			footer.i32(1, 2);
+			footer.list(2, 5, 2);
+			footer.zigzag(0);  // PLAIN
+			footer.zigzag(3);  // RLE
+			footer.list(3, 8, 1);
+			footer.binary(names[column]);
+			footer.i32(4, 0);  // UNCOMPRESSED
+			footer.i64(5, ROWS_PER_ROW_GROUP);
+			footer.i64(6, chunk.size);
+			footer.i64(7, chunk.size);
+			footer.i64(9, chunk.offset);
+			footer.begin_struct(12);
+			footer.binary(5, plain(chunk.max));
+			footer.binary(6, plain(chunk.min));
+			footer.end_struct();
+			footer.end_struct();
+			footer.i64(4, chunk.offset_index_offset);
+			footer.i32(5, chunk.offset_index_length);
+			footer.i64(6, chunk.column_index_offset);
+			footer.i32(7, chunk.column_index_length);
+			footer.end_struct();
+		}
+		footer.i64(2, total_byte_size);
+		footer.i64(3, ROWS_PER_ROW_GROUP);
+		footer.end_struct();
+	}
+	footer.binary(6, "parquet-cpp version 1.5.0");
+	footer.end_struct();
+
+	uint32_t footer_size = footer.bytes.size();
+	out.write(footer.bytes.data(), footer.bytes.size());
+	out.write(reinterpret_cast<const char *>(&footer_size), sizeof(footer_size));
+	out.write("PAR1", 4);
+}
+
+// Counts the bytes that are read from the file
+class counting_file : public arrow::io::RandomAccessFile {
+public:
+	counting_file(std::shared_ptr<arrow::io::RandomAccessFile> file) : file(file) {}
+
+	arrow::Status Close() override { return file->Close(); }
+	bool closed() const override { return file->closed(); }
+	arrow::Status Tell(int64_t * position) const override { return file->Tell(position); }
+	arrow::Status Seek(int64_t position) override { return file->Seek(position); }
+	arrow::Status GetSize(int64_t * size) override { return file->GetSize(size); }
+
+	arrow::Status Read(int64_t nbytes, int64_t * bytes_read, void * out) override {
+		arrow::Status status = file->Read(nbytes, bytes_read, out);
+		bytes += *bytes_read;
+		return status;
+	}
+	arrow::Status Read(int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override {
+		arrow::Status status = file->Read(nbytes, out);
+		bytes += status.ok() ? (*out)->size() : 0;
+		return status;
+	}
+	arrow::Status ReadAt(int64_t position, int64_t nbytes, int64_t * bytes_read, void * out) override {
+		arrow::Status status = file->ReadAt(position, nbytes, bytes_read, out);
+		bytes += *bytes_read;
+		return status;
+	}
+	arrow::Status ReadAt(int64_t position, int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override {
+		arrow::Status status = file->ReadAt(position, nbytes, out);
+		bytes += status.ok() ? (*out)->size() : 0;
+		return status;
+	}
+
+	std::atomic<int64_t> bytes{0};
+
+private:
+	std::shared_ptr<arrow::io::RandomAccessFile> file;
+};
+
+struct PageIndexBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		// the file is written once and kept for the other runs
+		if(!std::ifstream(PARQUET_FILE).good()) {
+			write_parquet_file_with_page_index();
+		}
+	}
+
+	void TearDown(benchmark::State & state) override {}
+};
+
+// Reads the rows of a narrow range of the sorted key, like a scan with the filter of the range does. The row groups out of
+// the range are skipped by their statistics either way
+BENCHMARK_DEFINE_F(PageIndexBench, NarrowRange)(benchmark::State & state) {
+	bool use_page_index = state.range(0);
+	ral::io::column_value_range range;
+	range.is_valid = true;
+	range.is_integer = true;
+	range.integer_min = NUM_ROWS / 3;
+	range.integer_max = range.integer_min + state.range(1) - 1;
+
+	ral::io::parquet_parser parser;
+	int64_t bytes_read = 0;
+	int64_t rows_read = 0;
+	for(auto _ : state) {
+		std::shared_ptr<arrow::io::ReadableFile> readable_file;
+		arrow::io::ReadableFile::Open(PARQUET_FILE, &readable_file);
+		auto file = std::make_shared<counting_file>(readable_file);
+
+		ral::io::Schema schema;
+		parser.parse_schema(file, schema);
+
+		std::vector<cudf::size_type> row_groups;
+		parser.skip_row_groups_out_of_range(file, "key", range, row_groups);
+		std::vector<ral::io::scan_unit> units = parser.get_scan_units(file, row_groups, 0);
+		if(use_page_index) {
+			parser.skip_pages_out_of_range(file, "key", range, units);
+		}
+
+		rows_read = 0;
+		for(auto & unit : units) {
+			auto table = parser.parse_scan_unit(file, schema, {0, 1}, unit);
+			rows_read += table->num_rows();
+			benchmark::DoNotOptimize(table);
+		}
+		bytes_read = file->bytes;
+		file->Close();
+	}
+	state.counters["bytes_read"] = bytes_read;
+	state.counters["rows_read"] = rows_read;
+}
+BENCHMARK_REGISTER_F(PageIndexBench, NarrowRange)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
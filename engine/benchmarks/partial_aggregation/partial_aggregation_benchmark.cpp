@@ -0,0 +1,106 @@
+#include "execution_graph/logic_controllers/PhysicalPlanGenerator.h"
+#include "io/data_parser/GDFParser.h"
+#include "io/data_provider/DummyProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+// each batch is a partition of the gdf table, so the aggregation sees this many batches
+const int NUM_BATCHES = 16;
+
+// SELECT k, SUM(v), COUNT(v) FROM t GROUP BY k
+static const std::string group_by_plan = R"J({"expr": "LogicalAggregate(group=[{0}], EXPR$1=[SUM($1)], EXPR$2=[COUNT($1)])", "children": [
+	{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]})J";
+
+// rows, number of distinct keys
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 20; num_rows <= 1 << 24; num_rows *= 16)
+		for(int64_t num_groups = 16; num_groups <= num_rows; num_groups *= 64)
+			b->Args({num_rows, num_groups});
+}
+
+struct PartialAggregationBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		int64_t batch_rows = state.range(0) / NUM_BATCHES;
+		int64_t num_groups = state.range(1);
+		for(int i = 0; i < NUM_BATCHES; i++) {
+			std::vector<int64_t> keys(batch_rows);
+			std::vector<double> values(batch_rows);
+			std::generate(keys.begin(), keys.end(), [num_groups]() { return std::rand() % num_groups; });
+			std::generate(values.begin(), values.end(), []() { return (std::rand() % 1000) / 10.0; });
+			key_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(keys.begin(), keys.end()));
+			value_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<double>>(values.begin(), values.end()));
+		}
+
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown(benchmark::State & state) override {
+		key_columns.clear();
+		value_columns.clear();
+	}
+
+	// Runs the group by and reports how many partial rows the merge phase received
+	void run_group_by(benchmark::State & state, const std::map<std::string, std::string> & config_options) {
+		std::vector<ral::frame::BlazingTableView> batches;
+		for(int i = 0; i < NUM_BATCHES; i++) {
+			batches.emplace_back(cudf::table_view{{*key_columns[i], *value_columns[i]}}, std::vector<std::string>{"k", "v"});
+		}
+		auto parser = std::make_shared<ral::io::gdf_parser>(batches);
+		auto provider = std::make_shared<ral::io::dummy_data_provider>();
+		std::vector<ral::io::data_loader> loaders = {ral::io::data_loader(parser, provider)};
+		std::vector<ral::io::Schema> schemas = {ral::io::Schema({"k", "v"}, {cudf::type_id::INT64, cudf::type_id::FLOAT64})};
+
+		std::size_t partial_rows = 0;
+		for(auto _ : state) {
+			Context context(0, contextNodes, contextNodes[0], "", config_options);
+			ral::batch::tree_processor tree{
+				.root = {},
+				.context = context.clone(),
+				.input_loaders = loaders,
+				.schemas = schemas,
+				.table_names = {"t"},
+				.transform_operators_bigger_than_gpu = true
+			};
+			ral::batch::OutputKernel output;
+			auto query_graph = tree.build_batch_graph(group_by_plan);
+			// on a single node the last kernel is the MergeAggregate
+			auto & merge_aggregate = query_graph->get_last_kernel();
+			*query_graph += link(merge_aggregate, output, ral::cache::cache_settings{.type = ral::cache::CacheType::CONCATENATING});
+			query_graph->execute();
+			auto result = output.release();
+			benchmark::DoNotOptimize(result);
+
+			partial_rows += merge_aggregate.total_input_rows_added();
+		}
+		state.counters["partial_rows"] = benchmark::Counter(partial_rows, benchmark::Counter::kAvgIterations);
+	}
+
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int64_t>>> key_columns;
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<double>>> value_columns;
+	std::vector<Node> contextNodes;
+};
+
+// Every batch is aggregated on its own and the merge phase gets all the partial results
+BENCHMARK_DEFINE_F(PartialAggregationBench, WithoutFolding)(benchmark::State & state) {
+	run_group_by(state, {{"AGGREGATION_MERGE_BYTES_THRESHOLD", std::to_string(std::numeric_limits<std::size_t>::max())}});
+}
+BENCHMARK_REGISTER_F(PartialAggregationBench, WithoutFolding)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The partial results are folded after every batch and never bypassed, this is the worst case with many groups
+BENCHMARK_DEFINE_F(PartialAggregationBench, AlwaysFolding)(benchmark::State & state) {
+	run_group_by(state, {{"AGGREGATION_MERGE_BYTES_THRESHOLD", "0"}, {"AGGREGATION_BYPASS_RATIO", "1"}});
+}
+BENCHMARK_REGISTER_F(PartialAggregationBench, AlwaysFolding)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Folds after every batch until the folds stop reducing the rows
+BENCHMARK_DEFINE_F(PartialAggregationBench, AdaptiveFolding)(benchmark::State & state) {
+	run_group_by(state, {{"AGGREGATION_MERGE_BYTES_THRESHOLD", "0"}});
+}
+BENCHMARK_REGISTER_F(PartialAggregationBench, AdaptiveFolding)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,59 @@
+#include "parser/physical_plan.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+static std::string json_node(const std::string & expr, const std::string & children) {
+	return "{\"expr\": \"" + expr + "\", \"children\": [" + children + "]}";
+}
+
+static std::string scan(int table) {
+	std::string name = "t" + std::to_string(table);
+	return json_node("BindableTableScan(table=[[main, " + name + "]], filters=[[>($1, " + std::to_string(table) +
+						 ")]], projects=[[0, 1, 2]], aliases=[[" + name + "_key, " + name + "_value, " + name + "_name]])",
+		"");
+}
+
+// The plan of a star schema query like the ones of TPC-H, num_tables tables joined on their first column
+// then grouped, projected and sorted
+static std::string make_star_query_plan(int num_tables) {
+	std::string plan = scan(0);
+	for(int table = 1; table < num_tables; table++) {
+		std::string join = json_node("LogicalJoin(condition=[=($0, $" + std::to_string(3 * table) + ")], joinType=[inner])",
+			plan + ", " + scan(table));
+		plan = json_node("LogicalFilter(condition=[AND(<>($2, 'LogicalSort'), >($1, 0))])", join);
+	}
+	plan = json_node("LogicalProject(key=[$0], value=[*($1, -(1, $4))], name=[$2])", plan);
+	plan = json_node("LogicalAggregate(group=[{0, 2}], EXPR$1=[SUM($1)], EXPR$2=[COUNT()])", plan);
+	return json_node("LogicalSort(sort0=[$2], dir0=[DESC], sort1=[$0], dir1=[ASC], fetch=[100])", plan);
+}
+
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_tables : {1, 4, 16})
+		for(int64_t num_nodes : {1, 4})
+			b->Args({num_tables, num_nodes});
+}
+
+// From the relational algebra JSON to the physical plan that the kernels are built from
+static void BM_build_physical_plan(benchmark::State & state) {
+	std::string json = make_star_query_plan(state.range(0));
+	auto rules = ral::parser::get_physical_rewrite_rules(state.range(1));
+	for(auto _ : state) {
+		auto plan = ral::parser::rewrite_plan(ral::parser::build_physical_plan(json), rules);
+		benchmark::DoNotOptimize(plan);
+	}
+}
+BENCHMARK(BM_build_physical_plan)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond);
+
+// Only the rewrite rules, over a plan that is already parsed
+static void BM_rewrite_physical_plan(benchmark::State & state) {
+	std::string json = make_star_query_plan(state.range(0));
+	auto rules = ral::parser::get_physical_rewrite_rules(state.range(1));
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto plan = ral::parser::build_physical_plan(json);
+		state.ResumeTiming();
+		plan = ral::parser::rewrite_plan(plan, rules);
+		benchmark::DoNotOptimize(plan);
+	}
+}
+BENCHMARK(BM_rewrite_physical_plan)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,100 @@
+#include "CalciteInterpreter.h"
+#include "execution_graph/logic_controllers/PhysicalPlanCache.h"
+#include "io/data_parser/GDFParser.h"
+#include "io/data_provider/DummyProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+// SELECT a, b * 2 FROM t WHERE a > ? ORDER BY b LIMIT 10, with the parameter as it is left by Calcite or already replaced
+static std::string make_plan(const std::string & parameter) {
+	std::string json = R"J({"expr": "LogicalSort(sort0=[$1], dir0=[ASC], fetch=[10])", "children": [
+		{"expr": "LogicalProject(a=[$0], EXPR$1=[*($1, 2)])", "children": [
+			{"expr": "LogicalFilter(condition=[>($0, PARAMETER)])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]}]}]})J";
+	json.replace(json.find("PARAMETER"), std::string("PARAMETER").size(), parameter);
+	return json;
+}
+
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 10; num_rows <= 1 << 20; num_rows *= 32)
+		b->Args({num_rows});
+}
+
+struct PreparedQueryBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		std::vector<int32_t> a(state.range(0));
+		std::vector<double> b(state.range(0));
+		std::generate(a.begin(), a.end(), []() { return std::rand() % 1000; });
+		std::generate(b.begin(), b.end(), []() { return (std::rand() % 1000) / 10.0; });
+
+		a_column = std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(a.begin(), a.end());
+		b_column = std::make_unique<cudf::test::fixed_width_column_wrapper<double>>(b.begin(), b.end());
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown(benchmark::State & state) override {
+		a_column.reset();
+		b_column.reset();
+	}
+
+	// what runQuery derives from the table schemas on every call
+	std::pair<ral::io::data_loader, ral::io::Schema> make_loader() {
+		std::vector<std::string> names = {"a", "b"};
+		ral::frame::BlazingTableView table(cudf::table_view{{*a_column, *b_column}}, names);
+		auto parser = std::make_shared<ral::io::gdf_parser>(std::vector<ral::frame::BlazingTableView>{table});
+		auto provider = std::make_shared<ral::io::dummy_data_provider>();
+		ral::io::Schema schema(names, {cudf::type_id::INT32, cudf::type_id::FLOAT64});
+		return std::make_pair(ral::io::data_loader(parser, provider), schema);
+	}
+
+	std::unique_ptr<cudf::test::fixed_width_column_wrapper<int32_t>> a_column;
+	std::unique_ptr<cudf::test::fixed_width_column_wrapper<double>> b_column;
+	std::vector<Node> contextNodes;
+};
+
+// Every run resolves the table and parses the plan, like runQuery without the physical plan cache
+BENCHMARK_DEFINE_F(PreparedQueryBench, Unprepared)(benchmark::State & state) {
+	ral::batch::physical_plan_cache::getInstance().set_capacity(0);
+	std::string plan = make_plan("500");
+	for(auto _ : state) {
+		auto loader = make_loader();
+		Context context(0, contextNodes, contextNodes[0], "", std::map<std::string, std::string>());
+		auto result = execute_plan({loader.first}, {loader.second}, {"t"}, plan, 0, context);
+		benchmark::DoNotOptimize(result);
+	}
+	ral::batch::physical_plan_cache::getInstance().set_capacity(ral::batch::DEFAULT_PHYSICAL_PLAN_CACHE_SIZE);
+}
+BENCHMARK_REGISTER_F(PreparedQueryBench, Unprepared)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Same query text every run, the plan comes from the physical plan cache
+BENCHMARK_DEFINE_F(PreparedQueryBench, PlanCache)(benchmark::State & state) {
+	std::string plan = make_plan("500");
+	for(auto _ : state) {
+		auto loader = make_loader();
+		Context context(0, contextNodes, contextNodes[0], "", std::map<std::string, std::string>());
+		auto result = execute_plan({loader.first}, {loader.second}, {"t"}, plan, 0, context);
+		benchmark::DoNotOptimize(result);
+	}
+}
+BENCHMARK_REGISTER_F(PreparedQueryBench, PlanCache)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// What runPreparedQuery does, the table and the plan template are resolved once and every run only binds the parameter
+BENCHMARK_DEFINE_F(PreparedQueryBench, Prepared)(benchmark::State & state) {
+	auto loader = make_loader();
+	auto plan_template = ral::parser::build_physical_plan(make_plan("?0"));
+	for(auto _ : state) {
+		Context context(0, contextNodes, contextNodes[0], "", std::map<std::string, std::string>());
+		auto plan = ral::parser::rewrite_plan(ral::parser::bind_parameters(*plan_template, {"500"}),
+			ral::parser::get_physical_rewrite_rules(context.getTotalNodes()));
+		auto result = execute_plan({loader.first}, {loader.second}, {"t"}, *plan, 0, context);
+		benchmark::DoNotOptimize(result);
+	}
+}
+BENCHMARK_REGISTER_F(PreparedQueryBench, Prepared)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
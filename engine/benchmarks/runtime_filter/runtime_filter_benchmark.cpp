@@ -0,0 +1,130 @@
+#include "execution_graph/logic_controllers/PhysicalPlanGenerator.h"
+#include "io/data_parser/GDFParser.h"
+#include "io/data_provider/DummyProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+const int32_t NUM_DIMENSION_ROWS = 1000;
+
+// SELECT SUM(f.amount) FROM fact f JOIN dim1 ON f.d1 = dim1.id JOIN dim2 ON f.d2 = dim2.id
+// WHERE dim1.attr < 10 AND dim2.attr < 10, where each dimension keeps 10% of its rows
+static const std::string star_plan = R"J({"expr": "LogicalAggregate(group=[{}], EXPR$0=[SUM($2)])", "children": [
+	{"expr": "LogicalJoin(condition=[=($1, $5)], joinType=[inner])", "children": [
+		{"expr": "LogicalJoin(condition=[=($0, $3)], joinType=[inner])", "children": [
+			{"expr": "LogicalTableScan(table=[[main, fact]])", "children": []},
+			{"expr": "LogicalFilter(condition=[<($1, 10)])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, dim1]])", "children": []}]}]},
+		{"expr": "LogicalFilter(condition=[<($1, 10)])", "children": [
+			{"expr": "LogicalTableScan(table=[[main, dim2]])", "children": []}]}]}]})J";
+
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 16; num_rows <= 1 << 24; num_rows *= 16)
+		b->Args({num_rows});
+}
+
+struct RuntimeFilterBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		std::vector<int32_t> d1(state.range(0));
+		std::vector<int32_t> d2(state.range(0));
+		std::vector<double> amount(state.range(0));
+		std::generate(d1.begin(), d1.end(), []() { return std::rand() % NUM_DIMENSION_ROWS; });
+		std::generate(d2.begin(), d2.end(), []() { return std::rand() % NUM_DIMENSION_ROWS; });
+		std::generate(amount.begin(), amount.end(), []() { return (std::rand() % 1000) / 10.0; });
+		fact_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(d1.begin(), d1.end()));
+		fact_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(d2.begin(), d2.end()));
+		amount_column = std::make_unique<cudf::test::fixed_width_column_wrapper<double>>(amount.begin(), amount.end());
+
+		std::vector<int32_t> ids(NUM_DIMENSION_ROWS);
+		std::vector<int32_t> attrs(NUM_DIMENSION_ROWS);
+		std::iota(ids.begin(), ids.end(), 0);
+		std::generate(attrs.begin(), attrs.end(), []() { return std::rand() % 100; });
+		dimension_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(ids.begin(), ids.end()));
+		dimension_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int32_t>>(attrs.begin(), attrs.end()));
+
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown(benchmark::State & state) override {
+		fact_columns.clear();
+		dimension_columns.clear();
+		amount_column.reset();
+	}
+
+	void add_table(const std::vector<std::string> & names, const std::vector<cudf::column_view> & columns,
+		const std::vector<cudf::type_id> & types) {
+		ral::frame::BlazingTableView table(cudf::table_view{columns}, names);
+		auto parser = std::make_shared<ral::io::gdf_parser>(std::vector<ral::frame::BlazingTableView>{table});
+		auto provider = std::make_shared<ral::io::dummy_data_provider>();
+		loaders.emplace_back(parser, provider);
+		schemas.emplace_back(names, types);
+	}
+
+	// Runs the star join and reports how many fact rows were read and how many of them went on to the joins,
+	// which are the ones that a distributed query would shuffle
+	void run_star_join(benchmark::State & state, bool enable_runtime_filters) {
+		loaders.clear();
+		schemas.clear();
+		add_table({"d1", "d2", "amount"}, {*fact_columns[0], *fact_columns[1], *amount_column},
+			{cudf::type_id::INT32, cudf::type_id::INT32, cudf::type_id::FLOAT64});
+		add_table({"id", "attr"}, {*dimension_columns[0], *dimension_columns[1]}, {cudf::type_id::INT32, cudf::type_id::INT32});
+		add_table({"id", "attr"}, {*dimension_columns[0], *dimension_columns[1]}, {cudf::type_id::INT32, cudf::type_id::INT32});
+
+		std::map<std::string, std::string> config_options = {{"ENABLE_RUNTIME_FILTERS", enable_runtime_filters ? "true" : "false"}};
+		std::size_t rows_scanned = 0;
+		std::size_t rows_joined = 0;
+		for(auto _ : state) {
+			Context context(0, contextNodes, contextNodes[0], "", config_options);
+			ral::batch::tree_processor tree{
+				.root = {},
+				.context = context.clone(),
+				.input_loaders = loaders,
+				.schemas = schemas,
+				.table_names = {"fact", "dim1", "dim2"},
+				.transform_operators_bigger_than_gpu = true
+			};
+			ral::batch::OutputKernel output;
+			auto query_graph = tree.build_batch_graph(star_plan);
+			*query_graph += link(query_graph->get_last_kernel(), output, ral::cache::cache_settings{.type = ral::cache::CacheType::CONCATENATING});
+			query_graph->execute();
+			auto result = output.release();
+			benchmark::DoNotOptimize(result);
+
+			// only the fact scan has runtime filters
+			auto runtime_filters = query_graph->get_runtime_filters();
+			if(enable_runtime_filters) {
+				rows_scanned += runtime_filters->rows_scanned();
+				rows_joined += runtime_filters->rows_scanned() - runtime_filters->rows_dropped();
+			} else {
+				rows_scanned += state.range(0);
+				rows_joined += state.range(0);
+			}
+		}
+		state.counters["rows_scanned"] = benchmark::Counter(rows_scanned, benchmark::Counter::kAvgIterations);
+		state.counters["rows_to_join"] = benchmark::Counter(rows_joined, benchmark::Counter::kAvgIterations);
+	}
+
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int32_t>>> fact_columns;
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int32_t>>> dimension_columns;
+	std::unique_ptr<cudf::test::fixed_width_column_wrapper<double>> amount_column;
+	std::vector<ral::io::data_loader> loaders;
+	std::vector<ral::io::Schema> schemas;
+	std::vector<Node> contextNodes;
+};
+
+BENCHMARK_DEFINE_F(RuntimeFilterBench, WithoutRuntimeFilters)(benchmark::State & state) {
+	run_star_join(state, false);
+}
+BENCHMARK_REGISTER_F(RuntimeFilterBench, WithoutRuntimeFilters)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The fact scan waits for the filters of both dimensions and only passes the rows whose keys are in both of them
+BENCHMARK_DEFINE_F(RuntimeFilterBench, WithRuntimeFilters)(benchmark::State & state) {
+	run_star_join(state, true);
+}
+BENCHMARK_REGISTER_F(RuntimeFilterBench, WithRuntimeFilters)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
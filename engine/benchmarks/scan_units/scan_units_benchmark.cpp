@@ -0,0 +1,111 @@
+#include "execution_graph/logic_controllers/PhysicalPlanGenerator.h"
+#include "io/data_parser/CSVParser.h"
+#include "io/data_parser/ParquetParser.h"
+#include "io/data_provider/UriDataProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+// a single file, which is big enough to be split into several batches
+const int64_t NUM_ROWS = 1 << 26;
+const std::string PARQUET_FILE = "/tmp/scan_units_benchmark.parquet";
+const std::string CSV_FILE = "/tmp/scan_units_benchmark.csv";
+
+enum file_format { PARQUET = 0, CSV = 1 };
+
+const std::string SCAN_PLAN = R"J({"expr": "LogicalTableScan(table=[[main, t]])", "children": []})J";
+
+// format, scan threads
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t format : {PARQUET, CSV})
+		for(int64_t num_threads = 1; num_threads <= 8; num_threads *= 2)
+			b->Args({format, num_threads});
+}
+
+struct ScanUnitsBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+
+		// the files are written once and kept for the other runs
+		if(state.range(0) == PARQUET && !std::ifstream(PARQUET_FILE).good()) {
+			std::vector<int64_t> a(NUM_ROWS);
+			std::vector<double> b(NUM_ROWS);
+			std::generate(a.begin(), a.end(), []() { return std::rand(); });
+			std::generate(b.begin(), b.end(), []() { return (std::rand() % 100000) / 100.0; });
+			cudf::test::fixed_width_column_wrapper<int64_t> a_column(a.begin(), a.end());
+			cudf::test::fixed_width_column_wrapper<double> b_column(b.begin(), b.end());
+			cudf::experimental::io::write_parquet_args out_args{
+				cudf::experimental::io::sink_info{PARQUET_FILE}, cudf::table_view{{a_column, b_column}}};
+			cudf::experimental::io::write_parquet(out_args);
+		}
+		if(state.range(0) == CSV && !std::ifstream(CSV_FILE).good()) {
+			std::ofstream out(CSV_FILE);
+			out << "a,b\n";
+			for(int64_t i = 0; i < NUM_ROWS; i++) {
+				out << std::rand() << "," << (std::rand() % 100000) / 100.0 << "\n";
+			}
+		}
+	}
+
+	void TearDown(benchmark::State & state) override {}
+
+	void run_scan(benchmark::State & state, size_t scan_unit_target_bytes) {
+		std::shared_ptr<ral::io::data_parser> parser;
+		std::string file;
+		if(state.range(0) == PARQUET) {
+			parser = std::make_shared<ral::io::parquet_parser>();
+			file = PARQUET_FILE;
+		} else {
+			cudf::experimental::io::read_csv_args args{cudf::experimental::io::source_info{""}};
+			args.dtype = {"int64", "float64"};
+			parser = std::make_shared<ral::io::csv_parser>(args);
+			file = CSV_FILE;
+		}
+
+		std::map<std::string, std::string> config_options = {
+			{"TABLE_SCAN_KERNEL_NUM_THREADS", std::to_string(state.range(1))},
+			{"SCAN_UNIT_TARGET_BYTES", std::to_string(scan_unit_target_bytes)}};
+
+		for(auto _ : state) {
+			auto provider = std::make_shared<ral::io::uri_data_provider>(std::vector<Uri>{Uri{file}});
+			ral::io::data_loader loader(parser, provider);
+			ral::io::Schema schema;
+			loader.get_schema(schema, {});
+
+			Context context(0, contextNodes, contextNodes[0], "", config_options);
+			ral::batch::tree_processor tree{
+				.root = {},
+				.context = context.clone(),
+				.input_loaders = {loader},
+				.schemas = {schema},
+				.table_names = {"t"},
+				.transform_operators_bigger_than_gpu = true
+			};
+			ral::batch::OutputKernel output;
+			auto query_graph = tree.build_batch_graph(SCAN_PLAN);
+			*query_graph += link(query_graph->get_last_kernel(), output, ral::cache::cache_settings{.type = ral::cache::CacheType::CONCATENATING});
+			query_graph->execute();
+			auto result = output.release();
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+	}
+
+	std::vector<Node> contextNodes;
+};
+
+BENCHMARK_DEFINE_F(ScanUnitsBench, WholeFile)(benchmark::State & state) {
+	run_scan(state, 0);
+}
+BENCHMARK_REGISTER_F(ScanUnitsBench, WholeFile)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_DEFINE_F(ScanUnitsBench, ScanUnits)(benchmark::State & state) {
+	run_scan(state, 250000000);
+}
+BENCHMARK_REGISTER_F(ScanUnitsBench, ScanUnits)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,83 @@
+#include "io/DataLoader.h"
+#include "io/data_parser/ParquetParser.h"
+#include "io/data_provider/UriDataProvider.h"
+#include "skip_data/SkipDataProcessor.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+
+// the keys are sorted across the files, each file is a row group. The values of every eighth file are all null
+const int NUM_FILES = 64;
+const int ROWS_PER_FILE = 1 << 16;
+const std::string FILE_PREFIX = "/tmp/skip_data_strings_benchmark_";
+
+std::string file_path(int file_index) { return FILE_PREFIX + std::to_string(file_index) + ".parquet"; }
+
+std::string key(int row) {
+	char buffer[16];
+	std::snprintf(buffer, sizeof(buffer), "key_%08d", row);
+	return buffer;
+}
+
+// = on a key, a range of keys, IN of two keys, IS NULL and IS NOT NULL
+const std::vector<std::string> FILTERS = {
+	"=($0, '" + key(10 * ROWS_PER_FILE + 5) + "')",
+	"AND(>=($0, '" + key(10 * ROWS_PER_FILE) + "'), <($0, '" + key(14 * ROWS_PER_FILE) + "'))",
+	"OR(=($0, '" + key(5) + "'), =($0, '" + key(40 * ROWS_PER_FILE + 5) + "'))",
+	"IS NULL($1)",
+	"IS NOT NULL($1)"};
+
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t filter = 0; filter < FILTERS.size(); filter++)
+		b->Args({filter});
+}
+
+struct SkipDataStringsBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		// the files are written once and kept for the other runs
+		std::vector<Uri> uris;
+		for(int file_index = 0; file_index < NUM_FILES; file_index++) {
+			uris.push_back(Uri{file_path(file_index)});
+			if(std::ifstream(file_path(file_index)).good()) {
+				continue;
+			}
+			std::vector<std::string> keys(ROWS_PER_FILE);
+			std::vector<int64_t> values(ROWS_PER_FILE);
+			for(int i = 0; i < ROWS_PER_FILE; i++) {
+				keys[i] = key(file_index * ROWS_PER_FILE + i);
+				values[i] = i;
+			}
+			std::vector<bool> valids(ROWS_PER_FILE, file_index % 8 != 0);
+			cudf::test::strings_column_wrapper keys_column(keys.begin(), keys.end());
+			cudf::test::fixed_width_column_wrapper<int64_t> values_column(values.begin(), values.end(), valids.begin());
+			cudf::experimental::io::write_parquet_args out_args{
+				cudf::experimental::io::sink_info{file_path(file_index)}, cudf::table_view{{keys_column, values_column}}};
+			cudf::experimental::io::write_parquet(out_args);
+		}
+
+		auto provider = std::make_shared<ral::io::uri_data_provider>(uris);
+		ral::io::data_loader loader(std::make_shared<ral::io::parquet_parser>(), provider);
+		metadata = loader.get_metadata(0);
+	}
+
+	void TearDown(benchmark::State & state) override { metadata = nullptr; }
+
+	std::unique_ptr<ral::frame::BlazingTable> metadata;
+};
+
+BENCHMARK_DEFINE_F(SkipDataStringsBench, RowGroupsPruned)(benchmark::State & state) {
+	std::string table_scan = "BindableTableScan(table=[[main, t]], filters=[[" + FILTERS[state.range(0)] +
+							 "]], projects=[[0, 1]], aliases=[[k, v]])";
+	cudf::size_type row_groups_kept = metadata->num_rows();
+	for(auto _ : state) {
+		auto result = ral::skip_data::process_skipdata_for_table(metadata->toBlazingTableView(), {"k", "v"}, table_scan);
+		if(!result.second) {
+			row_groups_kept = result.first->num_rows();
+		}
+		benchmark::DoNotOptimize(result);
+	}
+	state.counters["row_groups"] = metadata->num_rows();
+	state.counters["row_groups_pruned"] = metadata->num_rows() - row_groups_kept;
+}
+BENCHMARK_REGISTER_F(SkipDataStringsBench, RowGroupsPruned)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,102 @@
+#include "execution_graph/logic_controllers/PhysicalPlanGenerator.h"
+#include "io/data_parser/GDFParser.h"
+#include "io/data_provider/DummyProvider.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+// each batch is a partition of the gdf table
+const int NUM_BATCHES = 16;
+
+// SELECT k, v FROM t ORDER BY k DESC LIMIT n, as the TopN that the rewrite rules plan for it
+static std::string top_n_plan(int64_t limit) {
+	return R"J({"expr": "LogicalTopN(sort0=[$0], dir0=[DESC], fetch=[)J" + std::to_string(limit) + R"J(])", "children": [
+		{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]})J";
+}
+
+// the same query as the sort, partition and merge that a Sort with a bigger limit gets
+static std::string full_sort_plan(int64_t limit) {
+	std::string arguments = "(sort0=[$0], dir0=[DESC], fetch=[" + std::to_string(limit) + "])";
+	return R"J({"expr": "LogicalLimit)J" + arguments + R"J(", "children": [
+		{"expr": "LogicalMerge)J" + arguments + R"J(", "children": [
+			{"expr": "LogicalSingleNodePartition)J" + arguments + R"J(", "children": [
+				{"expr": "LogicalSingleNodeSortAndSample)J" + arguments + R"J(", "children": [
+					{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]}]}]}]})J";
+}
+
+// rows, limit
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t num_rows = 1 << 20; num_rows <= 1 << 26; num_rows *= 8)
+		for(int64_t limit : {10, 100, 10000})
+			b->Args({num_rows, limit});
+}
+
+struct TopNBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		int64_t batch_rows = state.range(0) / NUM_BATCHES;
+		for(int i = 0; i < NUM_BATCHES; i++) {
+			std::vector<int64_t> keys(batch_rows);
+			std::vector<double> values(batch_rows);
+			std::generate(keys.begin(), keys.end(), []() { return std::rand(); });
+			std::generate(values.begin(), values.end(), []() { return (std::rand() % 1000) / 10.0; });
+			key_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<int64_t>>(keys.begin(), keys.end()));
+			value_columns.push_back(std::make_unique<cudf::test::fixed_width_column_wrapper<double>>(values.begin(), values.end()));
+		}
+
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown(benchmark::State & state) override {
+		key_columns.clear();
+		value_columns.clear();
+	}
+
+	void run_query(benchmark::State & state, const std::string & json) {
+		std::vector<ral::frame::BlazingTableView> batches;
+		for(int i = 0; i < NUM_BATCHES; i++) {
+			batches.emplace_back(cudf::table_view{{*key_columns[i], *value_columns[i]}}, std::vector<std::string>{"k", "v"});
+		}
+		auto parser = std::make_shared<ral::io::gdf_parser>(batches);
+		auto provider = std::make_shared<ral::io::dummy_data_provider>();
+		std::vector<ral::io::data_loader> loaders = {ral::io::data_loader(parser, provider)};
+		std::vector<ral::io::Schema> schemas = {ral::io::Schema({"k", "v"}, {cudf::type_id::INT64, cudf::type_id::FLOAT64})};
+
+		for(auto _ : state) {
+			Context context(0, contextNodes, contextNodes[0], "", {});
+			ral::batch::tree_processor tree{
+				.root = {},
+				.context = context.clone(),
+				.input_loaders = loaders,
+				.schemas = schemas,
+				.table_names = {"t"},
+				.transform_operators_bigger_than_gpu = true
+			};
+			ral::batch::OutputKernel output;
+			auto query_graph = tree.build_batch_graph(json);
+			*query_graph += link(query_graph->get_last_kernel(), output, ral::cache::cache_settings{.type = ral::cache::CacheType::CONCATENATING});
+			query_graph->execute();
+			auto result = output.release();
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<int64_t>>> key_columns;
+	std::vector<std::unique_ptr<cudf::test::fixed_width_column_wrapper<double>>> value_columns;
+	std::vector<Node> contextNodes;
+};
+
+BENCHMARK_DEFINE_F(TopNBench, FullSort)(benchmark::State & state) {
+	run_query(state, full_sort_plan(state.range(1)));
+}
+BENCHMARK_REGISTER_F(TopNBench, FullSort)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_DEFINE_F(TopNBench, TopN)(benchmark::State & state) {
+	run_query(state, top_n_plan(state.range(1)));
+}
+BENCHMARK_REGISTER_F(TopNBench, TopN)->Apply(CustomArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,149 @@
+#include <blazingdb/transport/api.h>
+#include <blazingdb/transport/io/reader_writer.h>
+#include <blazingdb/transport/io/shm_ring_buffer.h>
+#include <benchmark/benchmark.h>
+#include <rmm/rmm.h>
+#include <rmm/device_buffer.hpp>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace blazingdb::transport;
+
+constexpr uint32_t transport_context_token = 9876;
+constexpr int16_t transport_server_port = 8020;
+
+enum TransportType { TCP = 0, SHARED_MEMORY = 1 };
+
+struct ReceivedPayloadMessage : public ReceivedMessage {
+	ReceivedPayloadMessage(const std::string & messageToken, uint32_t contextToken, const Node & sender_node)
+		: ReceivedMessage(messageToken, contextToken, sender_node) {}
+};
+
+class PayloadMessage : public GPUMessage {
+public:
+	PayloadMessage(uint32_t contextToken, const Node & sender_node, std::size_t payload_size)
+		: GPUMessage(PayloadMessage::MessageID(), contextToken, sender_node), payload(payload_size) {}
+
+	raw_buffer GetRawColumns() override {
+		std::vector<std::size_t> buffer_sizes{payload.size()};
+		std::vector<const char *> buffers{static_cast<const char *>(payload.data())};
+		ColumnTransport column_transport;
+		column_transport.metadata.size = payload.size();
+		column_transport.data = 0;
+		column_transport.valid = -1;
+		column_transport.strings_data = -1;
+		column_transport.strings_offsets = -1;
+		column_transport.strings_nullmask = -1;
+		column_transport.size_in_bytes = payload.size();
+		std::vector<ColumnTransport> column_offsets{column_transport};
+		std::vector<std::unique_ptr<rmm::device_buffer>> temp_scope_holder;
+		return std::make_tuple(buffer_sizes, buffers, column_offsets, std::move(temp_scope_holder));
+	}
+
+	static std::shared_ptr<ReceivedMessage> MakeFromHost(const Message::MetaData & message_metadata,
+		const Address::MetaData & address_metadata,
+		const std::vector<ColumnTransport> & columns_offsets,
+		std::vector<std::basic_string<char>> && raw_buffers) {
+		Node node(Address::TCP(address_metadata.ip, address_metadata.comunication_port, address_metadata.protocol_port));
+		return std::make_shared<ReceivedPayloadMessage>(message_metadata.messageToken, message_metadata.contextToken, node);
+	}
+
+	DefineClassName(PayloadMessage);
+
+private:
+	rmm::device_buffer payload;
+};
+
+// The receiver lives in another process of the same host, like two workers
+// sharing a machine. It is forked before the benchmark process touches the GPU
+// and it listens on TCP and on its shared memory ring at the same time.
+class TransportReceiverProcess {
+public:
+	TransportReceiverProcess() {
+		pid = fork();
+		if(pid == 0) {
+			io::setSharedMemoryTransport(true, 64 << 20);
+			io::setPinnedBufferProvider(16 << 20, 4);
+
+			std::unique_ptr<Server> server = Server::BatchProcessing(transport_server_port);
+			auto endpoint = PayloadMessage::MessageID();
+			server->registerEndPoint(endpoint);
+			server->registerContext(transport_context_token);
+			server->registerHostDeserializerForEndPoint(PayloadMessage::MakeFromHost, endpoint);
+			server->Run();
+
+			while(server->getMessage(transport_context_token, endpoint) != nullptr) {
+			}
+			server->Close();
+			_exit(0);
+		}
+	}
+
+	~TransportReceiverProcess() {
+		if(pid > 0) {
+			Message::MetaData metadata;
+			std::string token = PayloadMessage::MessageID();
+			strcpy(metadata.messageToken, token.c_str());
+			metadata.contextToken = transport_context_token;
+			ClientTCP::Make("127.0.0.1", transport_server_port)->notifyLastMessageEvent(metadata);
+			int status = 0;
+			waitpid(pid, &status, 0);
+		}
+	}
+
+private:
+	pid_t pid;
+};
+
+static TransportReceiverProcess receiver_process;
+
+static std::shared_ptr<Client> make_client(TransportType transport_type) {
+	if(transport_type == TCP) {
+		return ClientTCP::Make("127.0.0.1", transport_server_port);
+	}
+	// the ring shows up once the receiver is running
+	std::shared_ptr<Client> client;
+	while((client = ClientSharedMemory::Make("127.0.0.1", transport_server_port)) == nullptr) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return client;
+}
+
+static void CustomArguments(benchmark::internal::Benchmark * b) {
+	for(int64_t payload_size = 64 << 10; payload_size <= 64 << 20; payload_size *= 8)
+		for(int64_t transport_type : {TCP, SHARED_MEMORY})
+			b->Args({payload_size, transport_type});
+}
+
+static void BM_TransportSend(benchmark::State & state) {
+	static bool sender_initialized = []() {
+		io::setPinnedBufferProvider(16 << 20, 4);
+		return rmmInitialize(nullptr) == RMM_SUCCESS;
+	}();
+	if(!sender_initialized) {
+		state.SkipWithError("rmm could not be initialized");
+		return;
+	}
+
+	const std::size_t payload_size = state.range(0);
+	const auto transport_type = static_cast<TransportType>(state.range(1));
+
+	Node sender_node(Address::TCP("127.0.0.1", transport_server_port + 1, 1234));
+	PayloadMessage message{transport_context_token, sender_node, payload_size};
+
+	for(auto _ : state) {
+		auto client = make_client(transport_type);
+		if(!client->Send(message).IsOk()) {
+			state.SkipWithError("send failed");
+			break;
+		}
+	}
+
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(payload_size));
+	state.SetLabel(transport_type == TCP ? "tcp" : "shared_memory");
+}
+BENCHMARK(BM_TransportSend)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -19,6 +19,7 @@ from libc.stdint cimport (  # noqa: E211
     uint8_t,
     uint32_t,
     int64_t,
+    uint64_t,
     int32_t,
     int16_t,
     int8_t,
@@ -50,11 +51,29 @@ ctypedef table_view CudfTableView
 ctypedef table CudfTable
 
 
+cdef extern from "blazingdb/manager/QueryProfile.h" namespace "blazingdb::manager":
+    cdef struct KernelProfile:
+        int32_t kernel_id
+        string kernel_type
+        string expression
+        int64_t busy_ns
+        int64_t input_wait_ns
+        int64_t output_wait_ns
+        uint64_t batches_in
+        uint64_t rows_in
+        uint64_t bytes_in
+        uint64_t batches_out
+        uint64_t rows_out
+        uint64_t bytes_out
+        uint64_t batches_spilled_to_host
+        uint64_t batches_spilled_to_disk
+
 cdef extern from "../include/io/io.h":
     cdef struct ResultSet:
         unique_ptr[table] cudfTable
         vector[string]  names
         bool skipdata_analysis_fail
+        vector[KernelProfile] profile
 
 
     ctypedef enum DataType:
@@ -146,6 +165,9 @@ cdef extern from "../include/engine/engine.h":
             string ip
             int communication_port
         unique_ptr[ResultSet] runQuery(int masterIndex, vector[NodeMetaDataTCP] tcpMetadata, vector[string] tableNames, vector[TableSchema] tableSchemas, vector[vector[string]] tableSchemaCppArgKeys, vector[vector[string]] tableSchemaCppArgValues, vector[vector[string]] filesAll, vector[int] fileTypes, int ctxToken, string query, unsigned long accessToken, vector[vector[map[string,string]]] uri_values_cpp, map[string,string] config_options) except +raiseRunQueryError
+        int prepareQuery(vector[string] tableNames, vector[TableSchema] tableSchemas, vector[vector[string]] tableSchemaCppArgKeys, vector[vector[string]] tableSchemaCppArgValues, vector[vector[string]] filesAll, vector[int] fileTypes, string query, vector[vector[map[string,string]]] uri_values_cpp) except +raiseRunQueryError
+        unique_ptr[ResultSet] runPreparedQuery(int statementId, int masterIndex, vector[NodeMetaDataTCP] tcpMetadata, int ctxToken, vector[string] parameters, unsigned long accessToken, map[string,string] config_options, vector[string] tableNames, vector[TableSchema] tableSchemas, vector[vector[string]] tableSchemaCppArgKeys, vector[vector[string]] tableSchemaCppArgValues, vector[vector[string]] filesAll, vector[int] fileTypes, vector[vector[map[string,string]]] uri_values_cpp) except +raiseRunQueryError
+        void releasePreparedQuery(int statementId)
         unique_ptr[ResultSet] runSkipData(BlazingTableView metadata, vector[string] all_column_names, string query) except +raiseRunQueryError
 
         cdef struct TableScanInfo:
@@ -100,6 +100,12 @@ cdef unique_ptr[cio.ResultSet] parseMetadataPython(vector[string] files, pair[in
 cdef unique_ptr[cio.ResultSet] runQueryPython(int masterIndex, vector[NodeMetaDataTCP] tcpMetadata, vector[string] tableNames, vector[TableSchema] tableSchemas, vector[vector[string]] tableSchemaCppArgKeys, vector[vector[string]] tableSchemaCppArgValues, vector[vector[string]] filesAll, vector[int] fileTypes, int ctxToken, string query, unsigned long accessToken,vector[vector[map[string,string]]] uri_values_cpp, map[string,string] config_options) except *:
     return blaz_move(cio.runQuery( masterIndex, tcpMetadata, tableNames, tableSchemas, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, fileTypes, ctxToken, query, accessToken, uri_values_cpp, config_options))
 
+cdef int prepareQueryPython(vector[string] tableNames, vector[TableSchema] tableSchemas, vector[vector[string]] tableSchemaCppArgKeys, vector[vector[string]] tableSchemaCppArgValues, vector[vector[string]] filesAll, vector[int] fileTypes, string query, vector[vector[map[string,string]]] uri_values_cpp) except *:
+    return cio.prepareQuery(tableNames, tableSchemas, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, fileTypes, query, uri_values_cpp)
+
+cdef unique_ptr[cio.ResultSet] runPreparedQueryPython(int statementId, int masterIndex, vector[NodeMetaDataTCP] tcpMetadata, int ctxToken, vector[string] parameters, unsigned long accessToken, map[string,string] config_options, vector[string] tableNames, vector[TableSchema] tableSchemas, vector[vector[string]] tableSchemaCppArgKeys, vector[vector[string]] tableSchemaCppArgValues, vector[vector[string]] filesAll, vector[int] fileTypes, vector[vector[map[string,string]]] uri_values_cpp) except *:
+    return blaz_move(cio.runPreparedQuery(statementId, masterIndex, tcpMetadata, ctxToken, parameters, accessToken, config_options, tableNames, tableSchemas, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, fileTypes, uri_values_cpp))
+
 cdef unique_ptr[cio.ResultSet] performPartitionPython(int masterIndex, vector[NodeMetaDataTCP] tcpMetadata, int ctxToken, BlazingTableView blazingTableView, vector[string] column_names) except *:
     return blaz_move(cio.performPartition(masterIndex, tcpMetadata, ctxToken, blazingTableView, column_names))
 
@@ -283,25 +289,15 @@ cpdef performPartitionCaller(int masterIndex, tcpMetadata, int ctxToken, input,
     
     return df
 
-cpdef runQueryCaller(int masterIndex,  tcpMetadata,  tables,  vector[int] fileTypes, int ctxToken, queryPy, unsigned long accessToken, map[string,string] config_options):
-    cdef string query
-    query = str.encode(queryPy)
-    cdef vector[NodeMetaDataTCP] tcpMetadataCpp
-    cdef vector[TableSchema] tableSchemaCpp
-    cdef vector[vector[string]] tableSchemaCppArgKeys
-    cdef vector[vector[string]] tableSchemaCppArgValues
+cdef void tablesToCpp(tables, vector[int] fileTypes, vector[string]& tableNames, vector[TableSchema]& tableSchemaCpp, vector[vector[string]]& tableSchemaCppArgKeys, vector[vector[string]]& tableSchemaCppArgValues, vector[vector[string]]& filesAll, vector[vector[map[string,string]]]& uri_values_cpp_all) except *:
     cdef vector[string] currentTableSchemaCppArgKeys
     cdef vector[string] currentTableSchemaCppArgValues
-    cdef vector[string] tableNames
     cdef vector[type_id] types
     cdef vector[string] names
     cdef TableSchema currentTableSchemaCpp
-    cdef NodeMetaDataTCP currentMetadataCpp
-    cdef vector[vector[string]] filesAll
     cdef vector[string] currentFilesAll
     cdef vector[BlazingTableView] blazingTableViews
 
-    cdef vector[vector[map[string,string]]] uri_values_cpp_all
     cdef vector[map[string,string]] uri_values_cpp
     cdef map[string,string] cur_uri_values
 
@@ -381,13 +377,64 @@ cpdef runQueryCaller(int masterIndex,  tcpMetadata,  tables,  vector[int] fileTy
       tableSchemaCpp.push_back(currentTableSchemaCpp)
       tableIndex = tableIndex + 1
 
+cdef vector[NodeMetaDataTCP] tcpMetadataToCpp(tcpMetadata):
+    cdef vector[NodeMetaDataTCP] tcpMetadataCpp
+    cdef NodeMetaDataTCP currentMetadataCpp
     for currentMetadata in tcpMetadata:
         currentMetadataCpp.ip = currentMetadata['ip'].encode()
         currentMetadataCpp.communication_port = currentMetadata['communication_port']
         tcpMetadataCpp.push_back(currentMetadataCpp)
+    return tcpMetadataCpp
+
+# the execution profile of the last query run by this process
+_last_query_profile = None
+
+cdef profileToDataFrame(vector[cio.KernelProfile] profile):
+    columns = OrderedDict()
+    for name in ['kernel_id', 'kernel_type', 'expression', 'busy_ms', 'input_wait_ms', 'output_wait_ms',
+                 'batches_in', 'rows_in', 'bytes_in', 'batches_out', 'rows_out', 'bytes_out',
+                 'batches_spilled_to_host', 'batches_spilled_to_disk']:
+        columns[name] = []
+    for i in range(profile.size()):
+        columns['kernel_id'].append(profile[i].kernel_id)
+        columns['kernel_type'].append(profile[i].kernel_type.decode('utf-8'))
+        columns['expression'].append(profile[i].expression.decode('utf-8'))
+        columns['busy_ms'].append(profile[i].busy_ns / 1e6)
+        columns['input_wait_ms'].append(profile[i].input_wait_ns / 1e6)
+        columns['output_wait_ms'].append(profile[i].output_wait_ns / 1e6)
+        columns['batches_in'].append(profile[i].batches_in)
+        columns['rows_in'].append(profile[i].rows_in)
+        columns['bytes_in'].append(profile[i].bytes_in)
+        columns['batches_out'].append(profile[i].batches_out)
+        columns['rows_out'].append(profile[i].rows_out)
+        columns['bytes_out'].append(profile[i].bytes_out)
+        columns['batches_spilled_to_host'].append(profile[i].batches_spilled_to_host)
+        columns['batches_spilled_to_disk'].append(profile[i].batches_spilled_to_disk)
+    return cudf.DataFrame.from_pandas(pd.DataFrame(columns))
+
+cpdef getLastQueryProfileCaller():
+    return _last_query_profile
+
+cpdef runQueryCaller(int masterIndex,  tcpMetadata,  tables,  vector[int] fileTypes, int ctxToken, queryPy, unsigned long accessToken, map[string,string] config_options):
+    cdef string query
+    query = str.encode(queryPy)
+    cdef vector[NodeMetaDataTCP] tcpMetadataCpp
+    cdef vector[TableSchema] tableSchemaCpp
+    cdef vector[vector[string]] tableSchemaCppArgKeys
+    cdef vector[vector[string]] tableSchemaCppArgValues
+    cdef vector[string] tableNames
+    cdef vector[string] names
+    cdef vector[vector[string]] filesAll
+    cdef vector[vector[map[string,string]]] uri_values_cpp_all
+
+    tablesToCpp(tables, fileTypes, tableNames, tableSchemaCpp, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, uri_values_cpp_all)
+    tcpMetadataCpp = tcpMetadataToCpp(tcpMetadata)
 
     resultSet = blaz_move(runQueryPython(masterIndex, tcpMetadataCpp, tableNames, tableSchemaCpp, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, fileTypes, ctxToken, query,accessToken,uri_values_cpp_all, config_options))
 
+    global _last_query_profile
+    _last_query_profile = profileToDataFrame(dereference(resultSet).profile)
+
     names = dereference(resultSet).names
     decoded_names = []
     for i in range(names.size()):
@@ -398,7 +445,57 @@ cpdef runQueryCaller(int masterIndex,  tcpMetadata,  tables,  vector[int] fileTy
     return df
 
 
-cpdef runSkipDataCaller(table, queryPy):
+cpdef prepareQueryCaller(tables, vector[int] fileTypes, queryPy):
+    cdef string query
+    query = str.encode(queryPy)
+    cdef vector[TableSchema] tableSchemaCpp
+    cdef vector[vector[string]] tableSchemaCppArgKeys
+    cdef vector[vector[string]] tableSchemaCppArgValues
+    cdef vector[string] tableNames
+    cdef vector[vector[string]] filesAll
+    cdef vector[vector[map[string,string]]] uri_values_cpp_all
+
+    tablesToCpp(tables, fileTypes, tableNames, tableSchemaCpp, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, uri_values_cpp_all)
+    return prepareQueryPython(tableNames, tableSchemaCpp, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, fileTypes, query, uri_values_cpp_all)
+
+cpdef runPreparedQueryCaller(int statementId, int masterIndex, tcpMetadata, int ctxToken, parameters, unsigned long accessToken, map[string,string] config_options, tables=None, vector[int] fileTypes=[]):
+    cdef vector[NodeMetaDataTCP] tcpMetadataCpp
+    cdef vector[string] parametersCpp
+    cdef vector[string] names
+    cdef vector[TableSchema] tableSchemaCpp
+    cdef vector[vector[string]] tableSchemaCppArgKeys
+    cdef vector[vector[string]] tableSchemaCppArgValues
+    cdef vector[string] tableNames
+    cdef vector[vector[string]] filesAll
+    cdef vector[vector[map[string,string]]] uri_values_cpp_all
+
+    tcpMetadataCpp = tcpMetadataToCpp(tcpMetadata)
+    for parameter in parameters:
+        parametersCpp.push_back(str.encode(parameter))
+
+    # the tables of this run, when the bound parameters prune other files than the ones of the prepared query
+    if tables is not None:
+        tablesToCpp(tables, fileTypes, tableNames, tableSchemaCpp, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, uri_values_cpp_all)
+
+    resultSet = blaz_move(runPreparedQueryPython(statementId, masterIndex, tcpMetadataCpp, ctxToken, parametersCpp, accessToken, config_options, tableNames, tableSchemaCpp, tableSchemaCppArgKeys, tableSchemaCppArgValues, filesAll, fileTypes, uri_values_cpp_all))
+
+    global _last_query_profile
+    _last_query_profile = profileToDataFrame(dereference(resultSet).profile)
+
+    names = dereference(resultSet).names
+    decoded_names = []
+    for i in range(names.size()):
+        decoded_names.append(names[i].decode('utf-8'))
+
+    df = cudf.DataFrame(CudfXxTable.from_unique_ptr(blaz_move(dereference(resultSet).cudfTable), decoded_names)._data)
+
+    return df
+
+cpdef releasePreparedQueryCaller(int statementId):
+    cio.releasePreparedQuery(statementId)
+
+
+cpdef runSkipDataCaller(table, queryPy, metadataPy=None):
     cdef string query
     cdef BlazingTableView metadata
     cdef vector[string] all_column_names
@@ -414,9 +511,12 @@ cpdef runSkipDataCaller(table, queryPy):
       else: # from file
         all_column_names.push_back(col_name)
     
+    if metadataPy is None:
+      metadataPy = table.metadata
+
     column_views.resize(0)
-    metadata_col_names = [name.encode() for name in table.metadata._data.keys()]
-    for cython_col in table.metadata._data.values():
+    metadata_col_names = [name.encode() for name in metadataPy._data.keys()]
+    for cython_col in metadataPy._data.values():
       column_views.push_back(cython_col.view())
     metadata = BlazingTableView(table_view(column_views), metadata_col_names)
 
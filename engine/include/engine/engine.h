@@ -30,6 +30,36 @@ std::unique_ptr<ResultSet> runQuery(int32_t masterIndex,
 	std::vector<std::vector<std::map<std::string, std::string>>> uri_values,
 	std::map<std::string, std::string> config_options);
 
+// Parses the relational algebra of a query and resolves the loaders and schemas of its tables once, so that the query can be
+// run many times with runPreparedQuery. The algebra can have the ?0, ?1... parameters of Calcite. Returns the id of the prepared query
+int32_t prepareQuery(std::vector<std::string> tableNames,
+	std::vector<TableSchema> tableSchemas,
+	std::vector<std::vector<std::string>> tableSchemaCppArgKeys,
+	std::vector<std::vector<std::string>> tableSchemaCppArgValues,
+	std::vector<std::vector<std::string>> filesAll,
+	std::vector<int> fileTypes,
+	std::string query,
+	std::vector<std::vector<std::map<std::string, std::string>>> uri_values);
+
+// Runs a prepared query, parameters[i] is the literal that replaces ?i, i.e. 10, 'abc' or null.
+// The tables, if given, replace the ones of prepareQuery for this run, i.e. with the files that the bound filters leave
+std::unique_ptr<ResultSet> runPreparedQuery(int32_t statementId,
+	int32_t masterIndex,
+	std::vector<NodeMetaDataTCP> tcpMetadata,
+	int32_t ctxToken,
+	std::vector<std::string> parameters,
+	uint64_t accessToken,
+	std::map<std::string, std::string> config_options,
+	std::vector<std::string> tableNames = {},
+	std::vector<TableSchema> tableSchemas = {},
+	std::vector<std::vector<std::string>> tableSchemaCppArgKeys = {},
+	std::vector<std::vector<std::string>> tableSchemaCppArgValues = {},
+	std::vector<std::vector<std::string>> filesAll = {},
+	std::vector<int> fileTypes = {},
+	std::vector<std::vector<std::map<std::string, std::string>>> uri_values = {});
+
+void releasePreparedQuery(int32_t statementId);
+
 
 struct TableScanInfo {
 	std::vector<std::string> relational_algebra_steps;
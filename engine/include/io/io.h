@@ -10,6 +10,7 @@
 #include <memory>
 #include <cudf/io/functions.hpp>
 #include <execution_graph/logic_controllers/LogicPrimitives.h>
+#include <blazingdb/manager/QueryProfile.h>
 
 
 typedef ral::io::DataType DataType;
@@ -19,6 +20,8 @@ struct ResultSet {
 	std::unique_ptr<cudf::experimental::table> cudfTable;
 	std::vector<std::string> names;
 	bool skipdata_analysis_fail;
+	// the execution profile of the query, empty when it was not run by the execution graph
+	std::vector<blazingdb::manager::KernelProfile> profile;
 };
 
 struct TableSchema {
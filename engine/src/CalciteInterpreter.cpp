@@ -7,12 +7,14 @@
 
 #include "CalciteExpressionParsing.h"
 #include "CodeTimer.h"
+#include "communication/CommunicationData.h"
 #include "communication/network/Server.h"
 #include "operators/OrderBy.h"
 #include "utilities/CommonOperations.h"
 #include "utilities/StringUtils.h"
 #include "parser/expression_tree.hpp"
 #include "utilities/DebuggingUtils.h"
+#include "utilities/Tracing.h"
 
 #include "execution_graph/logic_controllers/LogicalFilter.h"
 #include "execution_graph/logic_controllers/LogicalProject.h"
@@ -60,10 +62,8 @@ void split_inequality_join_into_join_and_filter(const std::string & join_stateme
 	std::string condition = get_named_expression(join_statement, "condition");
 	std::string join_type = get_named_expression(join_statement, "joinType");
 
-	ral::parser::parse_tree condition_tree;
-	condition_tree.build(condition);
 	std::string new_join_statement_expression, filter_statement_expression;
-	condition_tree.split_inequality_join_into_join_and_filter(new_join_statement_expression, filter_statement_expression);
+	split_inequality_join_condition(condition, new_join_statement_expression, filter_statement_expression);
 
 	new_join_statement = "LogicalJoin(condition=[" + new_join_statement_expression + "], joinType=[" + join_type + "])";
 	if (filter_statement_expression != ""){
@@ -73,6 +73,58 @@ void split_inequality_join_into_join_and_filter(const std::string & join_stateme
 	}
 }
 
+void split_inequality_join_condition(const std::string & condition, std::string & join_condition, std::string & filter_condition){
+	ral::parser::parse_tree condition_tree;
+	condition_tree.build(condition);
+	condition_tree.split_inequality_join_into_join_and_filter(join_condition, filter_condition);
+}
+
+namespace {
+
+// The spans of a query are only recorded when it sets ENABLE_TRACING
+bool start_query_trace_if_enabled(Context & queryContext) {
+	std::map<std::string, std::string> config_options = queryContext.getConfigOptions();
+	auto it = config_options.find("ENABLE_TRACING");
+	if(it == config_options.end() || !(it->second == "True" || it->second == "true" || it->second == "1")) {
+		return false;
+	}
+	if(!ral::utilities::start_query_trace(queryContext.getContextToken())) {
+		auto logger = spdlog::get("batch_logger");
+		logger->warn("{query_id}|{step}|{substep}|{info}|||||",
+									"query_id"_a=queryContext.getContextToken(),
+									"step"_a=queryContext.getQueryStep(),
+									"substep"_a=queryContext.getQuerySubstep(),
+									"info"_a="Query is not traced, too many queries are being traced");
+		return false;
+	}
+	return true;
+}
+
+// Every node writes its spans of the query into TRACE_OUTPUT_DIRECTORY, as RAL.{node}.query.{query_id}.trace.json
+void finish_query_trace(Context & queryContext) {
+	std::map<std::string, std::string> config_options = queryContext.getConfigOptions();
+	std::string directory = "";
+	auto it = config_options.find("TRACE_OUTPUT_DIRECTORY");
+	if(it != config_options.end() && !it->second.empty()) {
+		directory = it->second + "/";
+	}
+	int node_index = queryContext.getNodeIndex(ral::communication::CommunicationData::getInstance().getSelfNode());
+	std::string path = directory + "RAL." + std::to_string(node_index) + ".query." +
+		std::to_string(queryContext.getContextToken()) + ".trace.json";
+
+	bool written = ral::utilities::write_query_trace(queryContext.getContextToken(), node_index, path);
+	ral::utilities::stop_query_trace(queryContext.getContextToken());
+
+	auto logger = spdlog::get("batch_logger");
+	logger->info("{query_id}|{step}|{substep}|{info}|||||",
+								"query_id"_a=queryContext.getContextToken(),
+								"step"_a=queryContext.getQueryStep(),
+								"substep"_a=queryContext.getQuerySubstep(),
+								"info"_a=(written ? "Query trace written to " : "Query trace could not be written to ") + path);
+}
+
+}  // namespace
+
 std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data_loader> input_loaders,
 	std::vector<ral::io::Schema> schemas,
 	std::vector<std::string> table_names,
@@ -80,8 +132,20 @@ std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data
 	int64_t connection,
 	Context & queryContext)  {
 
+	auto plan = ral::batch::physical_plan_cache::getInstance().get_plan(logicalPlan, &queryContext);
+	return execute_plan(input_loaders, schemas, table_names, *plan, connection, queryContext);
+}
+
+std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data_loader> input_loaders,
+	std::vector<ral::io::Schema> schemas,
+	std::vector<std::string> table_names,
+	const ral::parser::plan_node & plan,
+	int64_t connection,
+	Context & queryContext)  {
+
 	CodeTimer blazing_timer;
 	auto logger = spdlog::get("batch_logger");
+	bool traced = false;
 
 	try {
 		assert(input_loaders.size() == table_names.size());
@@ -97,7 +161,7 @@ std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data
 		};
 		ral::batch::OutputKernel output;
 
-		auto query_graph = tree.build_batch_graph(logicalPlan);
+		auto query_graph = tree.build_batch_graph(plan);
 		
 		logger->info("{query_id}|{step}|{substep}|{info}|||||",
 									"query_id"_a=queryContext.getContextToken(),
@@ -141,12 +205,17 @@ std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data
 									"info"_a="\"Config Options: {}\""_format(config_info),
 									"duration"_a="");
 		
+		traced = start_query_trace_if_enabled(queryContext);
 		if (query_graph->num_nodes() > 0) {
 			*query_graph += link(query_graph->get_last_kernel(), output, ral::cache::cache_settings{.type = ral::cache::CacheType::CONCATENATING});
 			// query_graph.show();
 			query_graph->execute();
 			output_frame = output.release();
 		}
+		if (traced) {
+			traced = false;
+			finish_query_trace(queryContext);
+		}
 
 		logger->info("{query_id}|{step}|{substep}|{info}|{duration}||||",
 									"query_id"_a=queryContext.getContextToken(),
@@ -167,6 +236,9 @@ std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data
 									"substep"_a=queryContext.getQuerySubstep(),
 									"info"_a="In execute_plan. What: {}"_format(e.what()),
 									"duration"_a="");
+		if (traced) {
+			finish_query_trace(queryContext);
+		}
 		throw;
 	}
 }
@@ -5,6 +5,7 @@
 #include "Interpreter/interpreter_cpp.h"
 #include "cudf/legacy/binaryop.hpp"
 #include "io/DataLoader.h"
+#include "parser/physical_plan.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -19,10 +20,22 @@ std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data
 	int64_t connection,
 	Context & queryContext);
 
+// Runs a plan that is already rewritten into physical operators, like the ones of the physical_plan_cache
+std::unique_ptr<ral::frame::BlazingTable> execute_plan(std::vector<ral::io::data_loader> input_loaders,
+	std::vector<ral::io::Schema> schemas,
+	std::vector<std::string> table_names,
+	const ral::parser::plan_node & plan,
+	int64_t connection,
+	Context & queryContext);
+
 
 void split_inequality_join_into_join_and_filter(const std::string & join_statement, 
  					std::string & new_join_statement, std::string & filter_statement);
 
+// The same split on the condition of a join alone, as the plan node of the join has it
+void split_inequality_join_condition(const std::string & condition,
+					std::string & join_condition, std::string & filter_condition);
+
 void getTableScanInfo(std::string & logicalPlan_in, 
 						std::vector<std::string> & relational_algebra_steps_out,
 						std::vector<std::string> & table_names_out,
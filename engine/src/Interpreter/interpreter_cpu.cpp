@@ -0,0 +1,1154 @@
+#include "interpreter_cpu.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <cudf/scalar/scalar.hpp>
+#include <cudf/utilities/traits.hpp>
+#include <cudf/utilities/type_dispatcher.hpp>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "blazingdb/concurrency/BlazingThread.h"
+#include "Utils.cuh"
+#include "utilities/Tracing.h"
+
+namespace interops {
+namespace cpu {
+namespace {
+
+// the null masks are combined a word of cudf::bitmask_type, 32 bits, at a time
+typedef cudf::bitmask_type bitmask_type;
+
+const cudf::size_type BITS_PER_WORD = sizeof(bitmask_type) * 8;
+// all the registers of a block should stay in the L2 cache while the operators go over them
+const std::size_t BLOCK_CACHE_BYTES = 256 * 1024;
+const cudf::size_type MIN_BLOCK_ROWS = 256;
+const cudf::size_type MAX_BLOCK_ROWS = 8192;
+// a multiple of the bits of a mask word and of the widest vector, so blocks never share a word of the null masks
+const cudf::size_type BLOCK_ROWS_ALIGNMENT = 64;
+// below this many rows per thread, starting another thread costs more than what it saves
+const cudf::size_type MIN_ROWS_PER_THREAD = 64 * 1024;
+
+bool is_float_type(cudf::type_id type) {
+	return (cudf::type_id::FLOAT32 == type || cudf::type_id::FLOAT64 == type);
+}
+
+bool is_timestamp_type(cudf::type_id type) {
+	return (cudf::type_id::TIMESTAMP_DAYS == type || cudf::type_id::TIMESTAMP_SECONDS == type ||
+			cudf::type_id::TIMESTAMP_MILLISECONDS == type || cudf::type_id::TIMESTAMP_MICROSECONDS == type ||
+			cudf::type_id::TIMESTAMP_NANOSECONDS == type);
+}
+
+bool is_string_type(cudf::type_id type) {
+	return (cudf::type_id::STRING == type);
+}
+
+/**
+ * Vector loops for the arithmetic operators. The instruction set is picked at compile time, so this file has to be
+ * built with the flags of the target (see INTERPRETER_CPU_ARCH_FLAGS). Everything else is left to the auto vectorizer.
+ */
+template <typename T>
+struct simd {
+	static constexpr bool enabled = false;
+};
+
+#if defined(__AVX512F__)
+template <>
+struct simd<double> {
+	static constexpr bool enabled = true;
+	static constexpr int lanes = 8;
+	typedef __m512d vector;
+	static vector load(const double * p) { return _mm512_loadu_pd(p); }
+	static void store(double * p, vector v) { _mm512_storeu_pd(p, v); }
+	static vector add(vector l, vector r) { return _mm512_add_pd(l, r); }
+	static vector sub(vector l, vector r) { return _mm512_sub_pd(l, r); }
+	static vector mul(vector l, vector r) { return _mm512_mul_pd(l, r); }
+	static vector div(vector l, vector r) { return _mm512_div_pd(l, r); }
+};
+
+template <>
+struct simd<int64_t> {
+	static constexpr bool enabled = true;
+	static constexpr int lanes = 8;
+	typedef __m512i vector;
+	static vector load(const int64_t * p) { return _mm512_loadu_si512(p); }
+	static void store(int64_t * p, vector v) { _mm512_storeu_si512(p, v); }
+	static vector add(vector l, vector r) { return _mm512_add_epi64(l, r); }
+	static vector sub(vector l, vector r) { return _mm512_sub_epi64(l, r); }
+};
+#elif defined(__AVX2__)
+template <>
+struct simd<double> {
+	static constexpr bool enabled = true;
+	static constexpr int lanes = 4;
+	typedef __m256d vector;
+	static vector load(const double * p) { return _mm256_loadu_pd(p); }
+	static void store(double * p, vector v) { _mm256_storeu_pd(p, v); }
+	static vector add(vector l, vector r) { return _mm256_add_pd(l, r); }
+	static vector sub(vector l, vector r) { return _mm256_sub_pd(l, r); }
+	static vector mul(vector l, vector r) { return _mm256_mul_pd(l, r); }
+	static vector div(vector l, vector r) { return _mm256_div_pd(l, r); }
+};
+
+template <>
+struct simd<int64_t> {
+	static constexpr bool enabled = true;
+	static constexpr int lanes = 4;
+	typedef __m256i vector;
+	static vector load(const int64_t * p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+	static void store(int64_t * p, vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+	static vector add(vector l, vector r) { return _mm256_add_epi64(l, r); }
+	static vector sub(vector l, vector r) { return _mm256_sub_epi64(l, r); }
+};
+#endif
+
+struct add_op {
+	template <typename T>
+	using vectorized = std::integral_constant<bool, simd<T>::enabled>;
+
+	template <typename T>
+	T operator()(T l, T r) const { return l + r; }
+
+	template <typename T>
+	static typename simd<T>::vector vector(typename simd<T>::vector l, typename simd<T>::vector r) { return simd<T>::add(l, r); }
+};
+
+struct sub_op {
+	template <typename T>
+	using vectorized = std::integral_constant<bool, simd<T>::enabled>;
+
+	template <typename T>
+	T operator()(T l, T r) const { return l - r; }
+
+	template <typename T>
+	static typename simd<T>::vector vector(typename simd<T>::vector l, typename simd<T>::vector r) { return simd<T>::sub(l, r); }
+};
+
+struct mul_op {
+	// there is no 64 bits integer multiplication before AVX-512DQ
+	template <typename T>
+	using vectorized = std::integral_constant<bool, simd<T>::enabled && std::is_floating_point<T>::value>;
+
+	template <typename T>
+	T operator()(T l, T r) const { return l * r; }
+
+	template <typename T>
+	static typename simd<T>::vector vector(typename simd<T>::vector l, typename simd<T>::vector r) { return simd<T>::mul(l, r); }
+};
+
+struct div_op {
+	template <typename T>
+	using vectorized = std::integral_constant<bool, simd<T>::enabled && std::is_floating_point<T>::value>;
+
+	// the row is set to null when dividing by zero, but the host division must not trap in the meantime
+	template <typename T, std::enable_if_t<std::is_integral<T>::value> * = nullptr>
+	T operator()(T l, T r) const { return (r == 0 || r == -1) ? (r == 0 ? 0 : static_cast<T>(0 - static_cast<uint64_t>(l))) : l / r; }
+
+	template <typename T, std::enable_if_t<std::is_floating_point<T>::value> * = nullptr>
+	T operator()(T l, T r) const { return l / r; }
+
+	template <typename T>
+	static typename simd<T>::vector vector(typename simd<T>::vector l, typename simd<T>::vector r) { return simd<T>::div(l, r); }
+};
+
+struct mod_op {
+	template <typename T>
+	using vectorized = std::false_type;
+
+	template <typename T, std::enable_if_t<std::is_integral<T>::value> * = nullptr>
+	T operator()(T l, T r) const { return (r == 0 || r == -1) ? 0 : l % r; }
+
+	template <typename T, std::enable_if_t<std::is_floating_point<T>::value> * = nullptr>
+	T operator()(T l, T r) const { return std::fmod(l, r); }
+};
+
+template <typename Op, typename T>
+void arithmetic_loop(const T * left, const T * right, T * out, cudf::size_type size, std::true_type) {
+	cudf::size_type i = 0;
+	for(; i + simd<T>::lanes <= size; i += simd<T>::lanes) {
+		simd<T>::store(out + i, Op::template vector<T>(simd<T>::load(left + i), simd<T>::load(right + i)));
+	}
+	for(; i < size; i++) {
+		out[i] = Op{}(left[i], right[i]);
+	}
+}
+
+template <typename Op, typename T>
+void arithmetic_loop(const T * left, const T * right, T * out, cudf::size_type size, std::false_type) {
+	Op op;
+	for(cudf::size_type i = 0; i < size; i++) {
+		out[i] = op(left[i], right[i]);
+	}
+}
+
+template <typename Op, typename T>
+void arithmetic_loop(const T * left, const T * right, T * out, cudf::size_type size) {
+	arithmetic_loop<Op>(left, right, out, size, typename Op::template vectorized<T>{});
+}
+
+template <typename T, typename Out, typename Op>
+void binary_loop(const T * left, const T * right, Out * out, cudf::size_type size, Op op) {
+	for(cudf::size_type i = 0; i < size; i++) {
+		out[i] = static_cast<Out>(op(left[i], right[i]));
+	}
+}
+
+template <typename T, typename Out, typename Op>
+void unary_loop(const T * left, Out * out, cudf::size_type size, Op op) {
+	for(cudf::size_type i = 0; i < size; i++) {
+		out[i] = static_cast<Out>(op(left[i]));
+	}
+}
+
+bool get_bit(const bitmask_type * words, cudf::size_type row) {
+	return (words[row / BITS_PER_WORD] >> (row % BITS_PER_WORD)) & bitmask_type{1};
+}
+
+void set_bit(bitmask_type * words, cudf::size_type row, bool value) {
+	bitmask_type bit = bitmask_type{1} << (row % BITS_PER_WORD);
+	words[row / BITS_PER_WORD] = value ? (words[row / BITS_PER_WORD] | bit) : (words[row / BITS_PER_WORD] & ~bit);
+}
+
+cudf::size_type num_words(cudf::size_type rows) {
+	return (rows + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+template <typename T>
+T get_magic_number();
+
+template <>
+int64_t get_magic_number<int64_t>() {
+	return std::numeric_limits<int64_t>::max() - 13ll;
+}
+
+template <>
+double get_magic_number<double>() {
+	return 1.7976931348623123e+308;
+}
+
+// Timestamps are kept as the count of their unit, like in the device interpreter
+
+int64_t ticks_per_day(cudf::type_id type) {
+	switch(type) {
+	case cudf::type_id::TIMESTAMP_SECONDS: return 86400ll;
+	case cudf::type_id::TIMESTAMP_MILLISECONDS: return 86400000ll;
+	case cudf::type_id::TIMESTAMP_MICROSECONDS: return 86400000000ll;
+	case cudf::type_id::TIMESTAMP_NANOSECONDS: return 86400000000000ll;
+	default: return 1;
+	}
+}
+
+int64_t nanoseconds_per_tick(cudf::type_id type) {
+	switch(type) {
+	case cudf::type_id::TIMESTAMP_DAYS: return 86400000000000ll;
+	case cudf::type_id::TIMESTAMP_SECONDS: return 1000000000ll;
+	case cudf::type_id::TIMESTAMP_MILLISECONDS: return 1000000ll;
+	case cudf::type_id::TIMESTAMP_MICROSECONDS: return 1000ll;
+	default: return 1;
+	}
+}
+
+int64_t floor_div(int64_t value, int64_t divisor) {
+	int64_t quotient = value / divisor;
+	return (value % divisor != 0 && ((value < 0) != (divisor < 0))) ? quotient - 1 : quotient;
+}
+
+// the proleptic gregorian date of a count of days since 1970-01-01
+void civil_from_days(int64_t days, int64_t & year, int64_t & month, int64_t & day) {
+	days += 719468;
+	const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+	const int64_t day_of_era = days - era * 146097;
+	const int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	const int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	const int64_t shifted_month = (5 * day_of_year + 2) / 153;
+	day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+	month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+	year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+int64_t extract_datetime_component(int64_t value, cudf::type_id type, operator_type op) {
+	int64_t day_ticks = ticks_per_day(type);
+	int64_t days = floor_div(value, day_ticks);
+	if(op == operator_type::BLZ_YEAR || op == operator_type::BLZ_MONTH || op == operator_type::BLZ_DAY) {
+		int64_t year, month, day;
+		civil_from_days(days, year, month, day);
+		return op == operator_type::BLZ_YEAR ? year : (op == operator_type::BLZ_MONTH ? month : day);
+	}
+
+	if(type == cudf::type_id::TIMESTAMP_DAYS) {
+		return 0;
+	}
+	int64_t seconds_of_day = (value - days * day_ticks) / (day_ticks / 86400);
+	switch(op) {
+	case operator_type::BLZ_HOUR: return seconds_of_day / 3600;
+	case operator_type::BLZ_MINUTE: return (seconds_of_day % 3600) / 60;
+	default: return seconds_of_day % 60;
+	}
+}
+
+/**
+ * Where an operation reads one of its operands from
+ */
+struct operand {
+	column_index_type position;
+	cudf::type_id type;
+	const host_scalar * scalar;
+};
+
+struct operation {
+	operator_type op;
+	operand left;
+	operand right;
+	column_index_type output;
+	bool output_float;
+};
+
+struct plan {
+	std::vector<operation> operations;
+	// the columns of the table that are read into registers, string columns are read in place
+	std::vector<column_index_type> loaded_columns;
+	// whether the last value written to each register is a floating point
+	std::vector<bool> register_is_float;
+	column_index_type num_registers;
+	cudf::size_type block_rows;
+};
+
+plan make_plan(const cudf::table_view & table,
+	const std::vector<column_index_type> & left_inputs,
+	const std::vector<column_index_type> & right_inputs,
+	const std::vector<column_index_type> & outputs,
+	const std::vector<column_index_type> & final_output_positions,
+	const std::vector<operator_type> & operators,
+	const std::vector<host_scalar> & left_scalars,
+	const std::vector<host_scalar> & right_scalars) {
+
+	plan interpreter_plan;
+
+	column_index_type max_position = std::max<column_index_type>(table.num_columns() - 1,
+		*std::max_element(final_output_positions.begin(), final_output_positions.end()));
+	max_position = std::max(max_position, *std::max_element(outputs.begin(), outputs.end()));
+	interpreter_plan.num_registers = max_position + 1;
+
+	std::vector<cudf::type_id> register_types(interpreter_plan.num_registers, cudf::type_id::EMPTY);
+	for(cudf::size_type i = 0; i < table.num_columns(); i++) {
+		register_types[i] = table.column(i).type().id();
+	}
+
+	std::vector<bool> column_is_read(table.num_columns(), false);
+	auto make_operand = [&](column_index_type position, const host_scalar & scalar) {
+		operand new_operand{position, cudf::type_id::EMPTY, nullptr};
+		if(position >= 0) {
+			new_operand.type = register_types[position];
+			if(position < table.num_columns()) {
+				column_is_read[position] = true;
+			}
+		} else if(position == SCALAR_INDEX) {
+			new_operand.type = scalar.type;
+			new_operand.scalar = &scalar;
+		}
+		return new_operand;
+	};
+
+	for(std::size_t i = 0; i < operators.size(); i++) {
+		operation new_operation;
+		new_operation.op = operators[i];
+		new_operation.left = make_operand(left_inputs[i], left_scalars[i]);
+		new_operation.right = make_operand(right_inputs[i], right_scalars[i]);
+		new_operation.output = outputs[i];
+
+		cudf::type_id type_from_op = (right_inputs[i] == UNARY_INDEX
+			? get_output_type(new_operation.left.type, operators[i])
+			: get_output_type(new_operation.left.type, new_operation.right.type, operators[i]));
+		new_operation.output_float = is_float_type(type_from_op);
+		register_types[outputs[i]] = new_operation.output_float ? cudf::type_id::FLOAT64 : cudf::type_id::INT64;
+
+		interpreter_plan.operations.push_back(new_operation);
+	}
+
+	for(cudf::size_type i = 0; i < table.num_columns(); i++) {
+		if(column_is_read[i] && !is_string_type(register_types[i])) {
+			interpreter_plan.loaded_columns.push_back(i);
+		}
+	}
+	for(auto type : register_types) {
+		interpreter_plan.register_is_float.push_back(is_float_type(type));
+	}
+
+	// the integer and the floating point values of a register, the left, right and output scratch and the null masks
+	std::size_t bytes_per_row = (2 * interpreter_plan.num_registers + 6) * sizeof(int64_t);
+	cudf::size_type block_rows = static_cast<cudf::size_type>(BLOCK_CACHE_BYTES / bytes_per_row);
+	block_rows = std::min(std::max(block_rows, MIN_BLOCK_ROWS), MAX_BLOCK_ROWS);
+	interpreter_plan.block_rows = block_rows - block_rows % BLOCK_ROWS_ALIGNMENT;
+
+	return interpreter_plan;
+}
+
+/**
+ * The registers of the rows of one block, one typed array per register. Each thread has its own.
+ */
+class block_buffers {
+public:
+	block_buffers(column_index_type num_registers, cudf::size_type block_rows)
+		: block_rows{block_rows},
+		  words_per_block{num_words(block_rows)},
+		  int_values(num_registers * block_rows),
+		  float_values(num_registers * block_rows),
+		  valids(num_registers * num_words(block_rows)),
+		  int_scratch(3 * block_rows),
+		  float_scratch(3 * block_rows),
+		  scratch_valids(num_words(block_rows)),
+		  all_valid(num_words(block_rows), ~bitmask_type{0}),
+		  all_null(num_words(block_rows), bitmask_type{0}) {}
+
+	template <typename T>
+	T * values(column_index_type position);
+
+	template <typename T>
+	T * scratch(int index);
+
+	bitmask_type * valid_words(column_index_type position) { return valids.data() + position * words_per_block; }
+
+	cudf::size_type block_rows;
+	cudf::size_type words_per_block;
+
+private:
+	std::vector<int64_t> int_values;
+	std::vector<double> float_values;
+	std::vector<bitmask_type> valids;
+	std::vector<int64_t> int_scratch;
+	std::vector<double> float_scratch;
+
+public:
+	std::vector<bitmask_type> scratch_valids;
+	std::vector<bitmask_type> all_valid;
+	std::vector<bitmask_type> all_null;
+};
+
+template <>
+int64_t * block_buffers::values<int64_t>(column_index_type position) {
+	return int_values.data() + position * block_rows;
+}
+
+template <>
+double * block_buffers::values<double>(column_index_type position) {
+	return float_values.data() + position * block_rows;
+}
+
+template <>
+int64_t * block_buffers::scratch<int64_t>(int index) {
+	return int_scratch.data() + index * block_rows;
+}
+
+template <>
+double * block_buffers::scratch<double>(int index) {
+	return float_scratch.data() + index * block_rows;
+}
+
+const int LEFT_SCRATCH = 0;
+const int RIGHT_SCRATCH = 1;
+const int OUTPUT_SCRATCH = 2;
+
+template <typename T>
+const T * convert_values(const T * values, T * /*scratch*/, cudf::size_type /*size*/) {
+	return values;
+}
+
+template <typename From, typename To>
+const To * convert_values(const From * values, To * scratch, cudf::size_type size) {
+	for(cudf::size_type i = 0; i < size; i++) {
+		scratch[i] = static_cast<To>(values[i]);
+	}
+	return scratch;
+}
+
+// The values of an operand as T. They are converted or the scalar is broadcast into the scratch when needed.
+template <typename T>
+const T * operand_values(const operand & source, block_buffers & buffers, int scratch_index, cudf::size_type size) {
+	T * scratch = buffers.scratch<T>(scratch_index);
+	if(source.position >= 0) {
+		if(is_float_type(source.type)) {
+			return convert_values(buffers.values<double>(source.position), scratch, size);
+		}
+		return convert_values(buffers.values<int64_t>(source.position), scratch, size);
+	}
+
+	T value{};
+	if(source.position == SCALAR_INDEX) {
+		value = is_float_type(source.scalar->type) ? static_cast<T>(source.scalar->float_value)
+												   : static_cast<T>(source.scalar->int_value);
+	}
+	std::fill_n(scratch, size, value);
+	return scratch;
+}
+
+const bitmask_type * operand_valids(const operand & source, block_buffers & buffers) {
+	if(source.position >= 0) {
+		return buffers.valid_words(source.position);
+	}
+	return source.position == SCALAR_INDEX ? buffers.all_valid.data() : buffers.all_null.data();
+}
+
+// Where to compute the output of an operation as T, its register when it has that type
+template <typename T>
+T * output_values(const operation & op, block_buffers & buffers) {
+	if(op.output_float == std::is_floating_point<T>::value) {
+		return buffers.values<T>(op.output);
+	}
+	return buffers.scratch<T>(OUTPUT_SCRATCH);
+}
+
+template <typename T>
+void store_output(const operation & op, block_buffers & buffers, const T * values, cudf::size_type size) {
+	if(op.output_float) {
+		double * out = buffers.values<double>(op.output);
+		if(convert_values(values, out, size) != out) {
+			std::copy_n(values, size, out);
+		}
+	} else {
+		int64_t * out = buffers.values<int64_t>(op.output);
+		if(convert_values(values, out, size) != out) {
+			std::copy_n(values, size, out);
+		}
+	}
+}
+
+void store_valids(const operation & op, block_buffers & buffers) {
+	std::copy_n(buffers.scratch_valids.begin(), buffers.words_per_block, buffers.valid_words(op.output));
+}
+
+/**
+ * Reads the strings of an operand in place, from its column in host memory or from its scalar
+ */
+class string_operand {
+public:
+	string_operand(const operand & source, const cudf::table_view & table, cudf::size_type row_start) {
+		if(source.position >= 0) {
+			const cudf::column_view & column = table.column(source.position);
+			offsets = column.child(0).data<int32_t>() + column.offset() + row_start;
+			chars = column.child(1).data<char>();
+		} else if(source.scalar) {
+			scalar = &source.scalar->string_value;
+		}
+	}
+
+	int compare(cudf::size_type row, const string_operand & other) const {
+		const char * data;
+		const char * other_data;
+		std::size_t length, other_length;
+		get(row, data, length);
+		other.get(row, other_data, other_length);
+
+		int result = std::memcmp(data, other_data, std::min(length, other_length));
+		if(result != 0) {
+			return result;
+		}
+		return length < other_length ? -1 : (length > other_length ? 1 : 0);
+	}
+
+private:
+	void get(cudf::size_type row, const char *& data, std::size_t & length) const {
+		if(offsets) {
+			data = chars + offsets[row];
+			length = offsets[row + 1] - offsets[row];
+		} else if(scalar) {
+			data = scalar->data();
+			length = scalar->size();
+		} else {
+			data = "";
+			length = 0;
+		}
+	}
+
+	const int32_t * offsets = nullptr;
+	const char * chars = nullptr;
+	const std::string * scalar = nullptr;
+};
+
+template <typename T>
+void evaluate_comparison(const operation & op, const T * left, const T * right, int64_t * out, cudf::size_type size) {
+	switch(op.op) {
+	case operator_type::BLZ_EQUAL: binary_loop(left, right, out, size, [](T l, T r) { return l == r; }); break;
+	case operator_type::BLZ_NOT_EQUAL: binary_loop(left, right, out, size, [](T l, T r) { return l != r; }); break;
+	case operator_type::BLZ_LESS: binary_loop(left, right, out, size, [](T l, T r) { return l < r; }); break;
+	case operator_type::BLZ_GREATER: binary_loop(left, right, out, size, [](T l, T r) { return l > r; }); break;
+	case operator_type::BLZ_LESS_EQUAL: binary_loop(left, right, out, size, [](T l, T r) { return l <= r; }); break;
+	case operator_type::BLZ_GREATER_EQUAL: binary_loop(left, right, out, size, [](T l, T r) { return l >= r; }); break;
+	default: break;
+	}
+}
+
+void evaluate_string_comparison(const operation & op, const cudf::table_view & table, cudf::size_type row_start,
+	block_buffers & buffers, cudf::size_type size) {
+
+	string_operand left(op.left, table, row_start);
+	string_operand right(op.right, table, row_start);
+	int64_t * out = buffers.scratch<int64_t>(OUTPUT_SCRATCH);
+	for(cudf::size_type i = 0; i < size; i++) {
+		out[i] = left.compare(i, right);
+	}
+	switch(op.op) {
+	case operator_type::BLZ_EQUAL: unary_loop(out, out, size, [](int64_t c) { return c == 0; }); break;
+	case operator_type::BLZ_NOT_EQUAL: unary_loop(out, out, size, [](int64_t c) { return c != 0; }); break;
+	case operator_type::BLZ_LESS: unary_loop(out, out, size, [](int64_t c) { return c < 0; }); break;
+	case operator_type::BLZ_GREATER: unary_loop(out, out, size, [](int64_t c) { return c > 0; }); break;
+	case operator_type::BLZ_LESS_EQUAL: unary_loop(out, out, size, [](int64_t c) { return c <= 0; }); break;
+	case operator_type::BLZ_GREATER_EQUAL: unary_loop(out, out, size, [](int64_t c) { return c >= 0; }); break;
+	default: break;
+	}
+	store_output(op, buffers, out, size);
+}
+
+template <typename T>
+void evaluate_arithmetic(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	const T * left = operand_values<T>(op.left, buffers, LEFT_SCRATCH, size);
+	const T * right = operand_values<T>(op.right, buffers, RIGHT_SCRATCH, size);
+
+	if(op.op == operator_type::BLZ_DIV || (op.op == operator_type::BLZ_MOD && std::is_integral<T>::value)) {
+		// dividing by zero gives a null
+		bitmask_type * valids = buffers.scratch_valids.data();
+		for(cudf::size_type word = 0; word < num_words(size); word++) {
+			bitmask_type zeros = 0;
+			cudf::size_type end = std::min(BITS_PER_WORD, size - word * BITS_PER_WORD);
+			for(cudf::size_type bit = 0; bit < end; bit++) {
+				zeros |= static_cast<bitmask_type>(right[word * BITS_PER_WORD + bit] == 0) << bit;
+			}
+			valids[word] &= ~zeros;
+		}
+	}
+
+	T * out = output_values<T>(op, buffers);
+	switch(op.op) {
+	case operator_type::BLZ_ADD: arithmetic_loop<add_op>(left, right, out, size); break;
+	case operator_type::BLZ_SUB: arithmetic_loop<sub_op>(left, right, out, size); break;
+	case operator_type::BLZ_MUL: arithmetic_loop<mul_op>(left, right, out, size); break;
+	case operator_type::BLZ_DIV: arithmetic_loop<div_op>(left, right, out, size); break;
+	case operator_type::BLZ_MOD: arithmetic_loop<mod_op>(left, right, out, size); break;
+	default: break;
+	}
+	store_output(op, buffers, out, size);
+}
+
+template <typename T>
+void evaluate_logical(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	const T * left = operand_values<T>(op.left, buffers, LEFT_SCRATCH, size);
+	const T * right = operand_values<T>(op.right, buffers, RIGHT_SCRATCH, size);
+	int64_t * out = output_values<int64_t>(op, buffers);
+	switch(op.op) {
+	case operator_type::BLZ_LOGICAL_AND: binary_loop(left, right, out, size, [](T l, T r) { return l && r; }); break;
+	case operator_type::BLZ_BITWISE_AND: binary_loop(left, right, out, size, [](T l, T r) { return static_cast<int64_t>(l) & static_cast<int64_t>(r); }); break;
+	case operator_type::BLZ_BITWISE_OR: binary_loop(left, right, out, size, [](T l, T r) { return static_cast<int64_t>(l) | static_cast<int64_t>(r); }); break;
+	case operator_type::BLZ_BITWISE_XOR: binary_loop(left, right, out, size, [](T l, T r) { return static_cast<int64_t>(l) ^ static_cast<int64_t>(r); }); break;
+	default: break;
+	}
+	store_output(op, buffers, out, size);
+}
+
+void evaluate_power(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	const double * left = operand_values<double>(op.left, buffers, LEFT_SCRATCH, size);
+	const double * right = operand_values<double>(op.right, buffers, RIGHT_SCRATCH, size);
+	double * out = output_values<double>(op, buffers);
+	if(op.op == operator_type::BLZ_POW) {
+		binary_loop(left, right, out, size, [](double l, double r) { return std::pow(l, r); });
+	} else {
+		binary_loop(left, right, out, size, [](double l, double r) {
+			double factor = std::pow(10, r);
+			return std::round(l * factor) / factor;
+		});
+	}
+	store_output(op, buffers, out, size);
+}
+
+/**
+ * LOGICAL_OR and the operators of CASE go row by row, the validity of the output depends on the values
+ */
+template <typename L, typename R, typename Out>
+void evaluate_conditional(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	const L * left = operand_values<L>(op.left, buffers, LEFT_SCRATCH, size);
+	const R * right = operand_values<R>(op.right, buffers, RIGHT_SCRATCH, size);
+	const bitmask_type * left_valids = operand_valids(op.left, buffers);
+	const bitmask_type * right_valids = operand_valids(op.right, buffers);
+	bitmask_type * valids = buffers.scratch_valids.data();
+	Out * out = buffers.values<Out>(op.output);
+
+	for(cudf::size_type i = 0; i < size; i++) {
+		bool left_valid = get_bit(left_valids, i);
+		bool right_valid = get_bit(right_valids, i);
+		if(op.op == operator_type::BLZ_MAGIC_IF_NOT) {
+			if(left_valid && left[i]) {
+				out[i] = static_cast<Out>(right[i]);
+				set_bit(valids, i, right_valid);
+			} else {
+				// we want to indicate to first_non_magic to use the second value
+				out[i] = get_magic_number<Out>();
+				set_bit(valids, i, false);
+			}
+		} else if(op.op == operator_type::BLZ_FIRST_NON_MAGIC) {
+			if(left[i] == get_magic_number<L>()) {
+				out[i] = static_cast<Out>(right[i]);
+				set_bit(valids, i, right_valid);
+			} else {
+				out[i] = static_cast<Out>(left[i]);
+				set_bit(valids, i, left_valid);
+			}
+		} else {  // BLZ_LOGICAL_OR
+			if(left_valid && right_valid) {
+				out[i] = static_cast<Out>(left[i] || right[i]);
+				set_bit(valids, i, true);
+			} else if(left_valid) {
+				out[i] = static_cast<Out>(left[i]);
+				set_bit(valids, i, !!left[i]);
+			} else if(right_valid) {
+				out[i] = static_cast<Out>(right[i]);
+				set_bit(valids, i, !!right[i]);
+			} else {
+				set_bit(valids, i, false);
+			}
+		}
+	}
+	store_valids(op, buffers);
+}
+
+template <typename L, typename R>
+void evaluate_conditional(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	if(op.output_float) {
+		evaluate_conditional<L, R, double>(op, buffers, size);
+	} else {
+		evaluate_conditional<L, R, int64_t>(op, buffers, size);
+	}
+}
+
+template <typename L>
+void evaluate_conditional(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	if(is_float_type(op.right.type)) {
+		evaluate_conditional<L, double>(op, buffers, size);
+	} else {
+		evaluate_conditional<L, int64_t>(op, buffers, size);
+	}
+}
+
+void evaluate_binary(const operation & op, const cudf::table_view & table, cudf::size_type row_start,
+	block_buffers & buffers, cudf::size_type size) {
+
+	if(op.op == operator_type::BLZ_LOGICAL_OR || op.op == operator_type::BLZ_MAGIC_IF_NOT ||
+		op.op == operator_type::BLZ_FIRST_NON_MAGIC) {
+		if(is_float_type(op.left.type)) {
+			evaluate_conditional<double>(op, buffers, size);
+		} else {
+			evaluate_conditional<int64_t>(op, buffers, size);
+		}
+		return;
+	}
+
+	const bitmask_type * left_valids = operand_valids(op.left, buffers);
+	const bitmask_type * right_valids = operand_valids(op.right, buffers);
+	bitmask_type * valids = buffers.scratch_valids.data();
+	for(cudf::size_type word = 0; word < num_words(size); word++) {
+		valids[word] = left_valids[word] & right_valids[word];
+	}
+
+	bool compute_float = is_float_type(op.left.type) || is_float_type(op.right.type);
+	switch(op.op) {
+	case operator_type::BLZ_ADD:
+	case operator_type::BLZ_SUB:
+	case operator_type::BLZ_MUL:
+	case operator_type::BLZ_DIV:
+	case operator_type::BLZ_MOD:
+		if(compute_float) {
+			evaluate_arithmetic<double>(op, buffers, size);
+		} else {
+			evaluate_arithmetic<int64_t>(op, buffers, size);
+		}
+		break;
+	case operator_type::BLZ_POW:
+	case operator_type::BLZ_ROUND:
+		evaluate_power(op, buffers, size);
+		break;
+	case operator_type::BLZ_EQUAL:
+	case operator_type::BLZ_NOT_EQUAL:
+	case operator_type::BLZ_LESS:
+	case operator_type::BLZ_GREATER:
+	case operator_type::BLZ_LESS_EQUAL:
+	case operator_type::BLZ_GREATER_EQUAL:
+		if(is_string_type(op.left.type) && is_string_type(op.right.type)) {
+			evaluate_string_comparison(op, table, row_start, buffers, size);
+		} else if(is_timestamp_type(op.left.type) && is_timestamp_type(op.right.type)) {
+			// both sides are compared in nanoseconds
+			int64_t * left = buffers.scratch<int64_t>(LEFT_SCRATCH);
+			int64_t * right = buffers.scratch<int64_t>(RIGHT_SCRATCH);
+			const int64_t * left_values = operand_values<int64_t>(op.left, buffers, LEFT_SCRATCH, size);
+			const int64_t * right_values = operand_values<int64_t>(op.right, buffers, RIGHT_SCRATCH, size);
+			int64_t left_factor = nanoseconds_per_tick(op.left.type);
+			int64_t right_factor = nanoseconds_per_tick(op.right.type);
+			unary_loop(left_values, left, size, [left_factor](int64_t v) { return v * left_factor; });
+			unary_loop(right_values, right, size, [right_factor](int64_t v) { return v * right_factor; });
+			int64_t * out = output_values<int64_t>(op, buffers);
+			evaluate_comparison(op, static_cast<const int64_t *>(left), static_cast<const int64_t *>(right), out, size);
+			store_output(op, buffers, out, size);
+		} else if(compute_float) {
+			const double * left = operand_values<double>(op.left, buffers, LEFT_SCRATCH, size);
+			const double * right = operand_values<double>(op.right, buffers, RIGHT_SCRATCH, size);
+			int64_t * out = output_values<int64_t>(op, buffers);
+			evaluate_comparison(op, left, right, out, size);
+			store_output(op, buffers, out, size);
+		} else {
+			const int64_t * left = operand_values<int64_t>(op.left, buffers, LEFT_SCRATCH, size);
+			const int64_t * right = operand_values<int64_t>(op.right, buffers, RIGHT_SCRATCH, size);
+			int64_t * out = output_values<int64_t>(op, buffers);
+			evaluate_comparison(op, left, right, out, size);
+			store_output(op, buffers, out, size);
+		}
+		break;
+	case operator_type::BLZ_LOGICAL_AND:
+	case operator_type::BLZ_BITWISE_AND:
+	case operator_type::BLZ_BITWISE_OR:
+	case operator_type::BLZ_BITWISE_XOR:
+		if(compute_float) {
+			evaluate_logical<double>(op, buffers, size);
+		} else {
+			evaluate_logical<int64_t>(op, buffers, size);
+		}
+		break;
+	default:
+		// the string functions are computed before the interpreter runs
+		break;
+	}
+	store_valids(op, buffers);
+}
+
+template <typename T>
+void evaluate_unary_values(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	const T * left = operand_values<T>(op.left, buffers, LEFT_SCRATCH, size);
+	cudf::type_id left_type = op.left.type;
+
+	switch(op.op) {
+	case operator_type::BLZ_FLOOR:
+	case operator_type::BLZ_CEIL:
+	case operator_type::BLZ_SIN:
+	case operator_type::BLZ_COS:
+	case operator_type::BLZ_ASIN:
+	case operator_type::BLZ_ACOS:
+	case operator_type::BLZ_TAN:
+	case operator_type::BLZ_COTAN:
+	case operator_type::BLZ_ATAN:
+	case operator_type::BLZ_LN:
+	case operator_type::BLZ_LOG:
+	case operator_type::BLZ_CAST_FLOAT:
+	case operator_type::BLZ_CAST_DOUBLE: {
+		const double * values = convert_values(left, buffers.scratch<double>(LEFT_SCRATCH), size);
+		double * out = output_values<double>(op, buffers);
+		switch(op.op) {
+		case operator_type::BLZ_FLOOR: unary_loop(values, out, size, [](double v) { return std::floor(v); }); break;
+		case operator_type::BLZ_CEIL: unary_loop(values, out, size, [](double v) { return std::ceil(v); }); break;
+		case operator_type::BLZ_SIN: unary_loop(values, out, size, [](double v) { return std::sin(v); }); break;
+		case operator_type::BLZ_COS: unary_loop(values, out, size, [](double v) { return std::cos(v); }); break;
+		case operator_type::BLZ_ASIN: unary_loop(values, out, size, [](double v) { return std::asin(v); }); break;
+		case operator_type::BLZ_ACOS: unary_loop(values, out, size, [](double v) { return std::acos(v); }); break;
+		case operator_type::BLZ_TAN: unary_loop(values, out, size, [](double v) { return std::tan(v); }); break;
+		case operator_type::BLZ_COTAN: unary_loop(values, out, size, [](double v) { return std::cos(v) / std::sin(v); }); break;
+		case operator_type::BLZ_ATAN: unary_loop(values, out, size, [](double v) { return std::atan(v); }); break;
+		case operator_type::BLZ_LN: unary_loop(values, out, size, [](double v) { return std::log(v); }); break;
+		case operator_type::BLZ_LOG: unary_loop(values, out, size, [](double v) { return std::log10(v); }); break;
+		default: unary_loop(values, out, size, [](double v) { return v; }); break;
+		}
+		store_output(op, buffers, out, size);
+		break;
+	}
+	case operator_type::BLZ_ABS: {
+		T * out = output_values<T>(op, buffers);
+		unary_loop(left, out, size, [](T v) { return v < 0 ? -v : v; });
+		store_output(op, buffers, out, size);
+		break;
+	}
+	case operator_type::BLZ_NOT: {
+		int64_t * out = output_values<int64_t>(op, buffers);
+		unary_loop(left, out, size, [](T v) { return !v; });
+		store_output(op, buffers, out, size);
+		break;
+	}
+	case operator_type::BLZ_YEAR:
+	case operator_type::BLZ_MONTH:
+	case operator_type::BLZ_DAY:
+	case operator_type::BLZ_HOUR:
+	case operator_type::BLZ_MINUTE:
+	case operator_type::BLZ_SECOND: {
+		int64_t * out = output_values<int64_t>(op, buffers);
+		operator_type component = op.op;
+		unary_loop(left, out, size, [left_type, component](T v) {
+			return extract_datetime_component(static_cast<int64_t>(v), left_type, component);
+		});
+		store_output(op, buffers, out, size);
+		break;
+	}
+	case operator_type::BLZ_CAST_TINYINT:
+	case operator_type::BLZ_CAST_SMALLINT:
+	case operator_type::BLZ_CAST_INTEGER:
+	case operator_type::BLZ_CAST_BIGINT: {
+		int64_t * out = output_values<int64_t>(op, buffers);
+		unary_loop(left, out, size, [](T v) { return static_cast<int64_t>(v); });
+		store_output(op, buffers, out, size);
+		break;
+	}
+	case operator_type::BLZ_CAST_DATE: {
+		// like the conversions between cudf timestamps, a coarser unit truncates
+		int64_t * out = output_values<int64_t>(op, buffers);
+		if(is_timestamp_type(left_type)) {
+			int64_t day_ticks = ticks_per_day(left_type);
+			unary_loop(left, out, size, [day_ticks](T v) { return static_cast<int32_t>(static_cast<int64_t>(v) / day_ticks); });
+		} else {
+			unary_loop(left, out, size, [](T v) { return static_cast<int32_t>(v); });
+		}
+		store_output(op, buffers, out, size);
+		break;
+	}
+	case operator_type::BLZ_CAST_TIMESTAMP: {
+		int64_t * out = output_values<int64_t>(op, buffers);
+		if(is_timestamp_type(left_type)) {
+			int64_t factor = nanoseconds_per_tick(left_type);
+			unary_loop(left, out, size, [factor](T v) { return static_cast<int64_t>(v) * factor; });
+		} else {
+			unary_loop(left, out, size, [](T v) { return static_cast<int64_t>(v); });
+		}
+		store_output(op, buffers, out, size);
+		break;
+	}
+	default:
+		// CAST_VARCHAR is computed before the interpreter runs
+		break;
+	}
+}
+
+void evaluate_unary(const operation & op, block_buffers & buffers, cudf::size_type size) {
+	// scalar inputs are not allowed in unary operations
+	const bitmask_type * left_valids = operand_valids(op.left, buffers);
+	bitmask_type * valids = buffers.scratch_valids.data();
+
+	if(op.op == operator_type::BLZ_IS_NULL || op.op == operator_type::BLZ_IS_NOT_NULL) {
+		int64_t * out = output_values<int64_t>(op, buffers);
+		bool expected = op.op == operator_type::BLZ_IS_NOT_NULL;
+		for(cudf::size_type i = 0; i < size; i++) {
+			out[i] = get_bit(left_valids, i) == expected;
+		}
+		store_output(op, buffers, out, size);
+		std::fill_n(valids, num_words(size), ~bitmask_type{0});
+	} else {
+		if(is_float_type(op.left.type)) {
+			evaluate_unary_values<double>(op, buffers, size);
+		} else {
+			evaluate_unary_values<int64_t>(op, buffers, size);
+		}
+		std::copy_n(left_valids, num_words(size), valids);
+	}
+	store_valids(op, buffers);
+}
+
+template <typename T, typename Register>
+void read_column_values(const cudf::column_view & column, cudf::size_type row_start, cudf::size_type size, Register * out) {
+	const T * data = column.data<T>() + row_start;
+	for(cudf::size_type i = 0; i < size; i++) {
+		out[i] = static_cast<Register>(data[i]);
+	}
+}
+
+void read_column(const cudf::column_view & column, column_index_type position, cudf::size_type row_start,
+	cudf::size_type size, block_buffers & buffers) {
+
+	int64_t * int_out = buffers.values<int64_t>(position);
+	switch(column.type().id()) {
+	case cudf::type_id::BOOL8: read_column_values<uint8_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::INT8: read_column_values<int8_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::INT16: read_column_values<int16_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::INT32: read_column_values<int32_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::INT64: read_column_values<int64_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::TIMESTAMP_DAYS: read_column_values<int32_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::TIMESTAMP_SECONDS:
+	case cudf::type_id::TIMESTAMP_MILLISECONDS:
+	case cudf::type_id::TIMESTAMP_MICROSECONDS:
+	case cudf::type_id::TIMESTAMP_NANOSECONDS: read_column_values<int64_t>(column, row_start, size, int_out); break;
+	case cudf::type_id::FLOAT32: read_column_values<float>(column, row_start, size, buffers.values<double>(position)); break;
+	case cudf::type_id::FLOAT64: read_column_values<double>(column, row_start, size, buffers.values<double>(position)); break;
+	default: RAL_FAIL("Column type not supported by the host interpreter");
+	}
+
+	// the masks are read a word at a time, shifting the words when the column does not start at the beginning of one
+	bitmask_type * valids = buffers.valid_words(position);
+	cudf::size_type words = num_words(size);
+	if(!column.nullable()) {
+		std::fill_n(valids, words, ~bitmask_type{0});
+		return;
+	}
+
+	const bitmask_type * mask = column.null_mask();
+	cudf::size_type first_bit = column.offset() + row_start;
+	cudf::size_type first_word = first_bit / BITS_PER_WORD;
+	cudf::size_type last_word = (first_bit + size - 1) / BITS_PER_WORD;
+	cudf::size_type shift = first_bit % BITS_PER_WORD;
+	if(shift == 0) {
+		std::copy_n(mask + first_word, words, valids);
+		return;
+	}
+	for(cudf::size_type word = 0; word < words; word++) {
+		bitmask_type low = mask[first_word + word] >> shift;
+		bitmask_type high = (first_word + word + 1 <= last_word) ? mask[first_word + word + 1] << (BITS_PER_WORD - shift) : 0;
+		valids[word] = low | high;
+	}
+}
+
+template <typename T, typename Register>
+void write_column_values(cudf::mutable_column_view & column, cudf::size_type row_start, cudf::size_type size, const Register * values) {
+	T * data = column.data<T>() + row_start;
+	for(cudf::size_type i = 0; i < size; i++) {
+		data[i] = static_cast<T>(values[i]);
+	}
+}
+
+template <typename Register>
+void write_column(cudf::mutable_column_view & column, cudf::size_type row_start, cudf::size_type size, const Register * values) {
+	switch(column.type().id()) {
+	case cudf::type_id::BOOL8: write_column_values<bool>(column, row_start, size, values); break;
+	case cudf::type_id::INT8: write_column_values<int8_t>(column, row_start, size, values); break;
+	case cudf::type_id::INT16: write_column_values<int16_t>(column, row_start, size, values); break;
+	case cudf::type_id::INT32: write_column_values<int32_t>(column, row_start, size, values); break;
+	case cudf::type_id::INT64: write_column_values<int64_t>(column, row_start, size, values); break;
+	case cudf::type_id::TIMESTAMP_DAYS: write_column_values<int32_t>(column, row_start, size, values); break;
+	case cudf::type_id::TIMESTAMP_SECONDS:
+	case cudf::type_id::TIMESTAMP_MILLISECONDS:
+	case cudf::type_id::TIMESTAMP_MICROSECONDS:
+	case cudf::type_id::TIMESTAMP_NANOSECONDS: write_column_values<int64_t>(column, row_start, size, values); break;
+	case cudf::type_id::FLOAT32: write_column_values<float>(column, row_start, size, values); break;
+	case cudf::type_id::FLOAT64: write_column_values<double>(column, row_start, size, values); break;
+	default: RAL_FAIL("Column type not supported by the host interpreter");
+	}
+}
+
+void evaluate_block(const plan & interpreter_plan,
+	cudf::mutable_table_view & out_table,
+	const cudf::table_view & table,
+	const std::vector<column_index_type> & final_output_positions,
+	cudf::size_type row_start,
+	block_buffers & buffers) {
+
+	cudf::size_type size = std::min(interpreter_plan.block_rows, table.num_rows() - row_start);
+
+	for(auto column_index : interpreter_plan.loaded_columns) {
+		read_column(table.column(column_index), column_index, row_start, size, buffers);
+	}
+
+	for(const auto & op : interpreter_plan.operations) {
+		if(op.right.position == UNARY_INDEX) {
+			evaluate_unary(op, buffers, size);
+		} else {
+			evaluate_binary(op, table, row_start, buffers, size);
+		}
+	}
+
+	for(cudf::size_type i = 0; i < out_table.num_columns(); i++) {
+		cudf::mutable_column_view column = out_table.column(i);
+		column_index_type position = final_output_positions[i];
+		if(interpreter_plan.register_is_float[position]) {
+			write_column(column, row_start, size, buffers.values<double>(position));
+		} else {
+			write_column(column, row_start, size, buffers.values<int64_t>(position));
+		}
+
+		if(column.nullable()) {
+			// blocks start at a word boundary, so they never write the same word
+			std::copy_n(buffers.valid_words(position), num_words(size), column.null_mask() + row_start / BITS_PER_WORD);
+		}
+	}
+}
+
+}  // namespace
+
+std::vector<host_scalar> to_host_scalars(const std::vector<std::unique_ptr<cudf::scalar>> & scalars) {
+	std::vector<host_scalar> host_scalars(scalars.size());
+	for(std::size_t i = 0; i < scalars.size(); i++) {
+		if(!scalars[i]) {
+			continue;
+		}
+
+		cudf::scalar * scalar = scalars[i].get();
+		host_scalar & out = host_scalars[i];
+		out.type = scalar->type().id();
+		switch(out.type) {
+		case cudf::type_id::BOOL8: out.int_value = static_cast<cudf::experimental::scalar_type_t<bool> *>(scalar)->value(); break;
+		case cudf::type_id::INT8: out.int_value = static_cast<cudf::experimental::scalar_type_t<int8_t> *>(scalar)->value(); break;
+		case cudf::type_id::INT16: out.int_value = static_cast<cudf::experimental::scalar_type_t<int16_t> *>(scalar)->value(); break;
+		case cudf::type_id::INT32: out.int_value = static_cast<cudf::experimental::scalar_type_t<int32_t> *>(scalar)->value(); break;
+		case cudf::type_id::INT64: out.int_value = static_cast<cudf::experimental::scalar_type_t<int64_t> *>(scalar)->value(); break;
+		case cudf::type_id::FLOAT32: out.float_value = static_cast<cudf::experimental::scalar_type_t<float> *>(scalar)->value(); break;
+		case cudf::type_id::FLOAT64: out.float_value = static_cast<cudf::experimental::scalar_type_t<double> *>(scalar)->value(); break;
+		case cudf::type_id::TIMESTAMP_DAYS: out.int_value = static_cast<cudf::experimental::scalar_type_t<cudf::timestamp_D> *>(scalar)->value().time_since_epoch().count(); break;
+		case cudf::type_id::TIMESTAMP_SECONDS: out.int_value = static_cast<cudf::experimental::scalar_type_t<cudf::timestamp_s> *>(scalar)->value().time_since_epoch().count(); break;
+		case cudf::type_id::TIMESTAMP_MILLISECONDS: out.int_value = static_cast<cudf::experimental::scalar_type_t<cudf::timestamp_ms> *>(scalar)->value().time_since_epoch().count(); break;
+		case cudf::type_id::TIMESTAMP_MICROSECONDS: out.int_value = static_cast<cudf::experimental::scalar_type_t<cudf::timestamp_us> *>(scalar)->value().time_since_epoch().count(); break;
+		case cudf::type_id::TIMESTAMP_NANOSECONDS: out.int_value = static_cast<cudf::experimental::scalar_type_t<cudf::timestamp_ns> *>(scalar)->value().time_since_epoch().count(); break;
+		case cudf::type_id::STRING: out.string_value = static_cast<cudf::experimental::scalar_type_t<cudf::string_view> *>(scalar)->to_string(); break;
+		default: RAL_FAIL("Scalar type not supported by the host interpreter");
+		}
+	}
+	return host_scalars;
+}
+
+void perform_interpreter_operation(cudf::mutable_table_view & out_table,
+	const cudf::table_view & table,
+	const std::vector<column_index_type> & left_inputs,
+	const std::vector<column_index_type> & right_inputs,
+	const std::vector<column_index_type> & outputs,
+	const std::vector<column_index_type> & final_output_positions,
+	const std::vector<operator_type> & operators,
+	const std::vector<host_scalar> & left_scalars,
+	const std::vector<host_scalar> & right_scalars,
+	int num_threads) {
+
+	if (final_output_positions.empty() || table.num_rows() == 0) {
+		return;
+	}
+
+	assert(!left_inputs.empty());
+	assert(!right_inputs.empty());
+	assert(!outputs.empty());
+	assert(!operators.empty());
+
+	for(cudf::size_type i = 0; i < out_table.num_columns(); i++) {
+		RAL_EXPECTS(!out_table.column(i).nullable() || out_table.column(i).offset() % BITS_PER_WORD == 0,
+			"The host interpreter writes the null masks a word at a time, output columns must start at a word boundary");
+	}
+
+	plan interpreter_plan = make_plan(table, left_inputs, right_inputs, outputs, final_output_positions, operators, left_scalars, right_scalars);
+
+	cudf::size_type num_rows = table.num_rows();
+	cudf::size_type num_blocks = (num_rows + interpreter_plan.block_rows - 1) / interpreter_plan.block_rows;
+	if(num_threads <= 0) {
+		num_threads = std::min<int>(BlazingThread::hardware_concurrency(), std::max(num_rows / MIN_ROWS_PER_THREAD, 1));
+	}
+	num_threads = std::max(std::min<int>(num_threads, num_blocks), 1);
+
+	std::atomic<cudf::size_type> next_block{0};
+	auto evaluate_blocks = [&]() {
+		block_buffers buffers(interpreter_plan.num_registers, interpreter_plan.block_rows);
+		for(cudf::size_type block = next_block++; block < num_blocks; block = next_block++) {
+			evaluate_block(interpreter_plan, out_table, table, final_output_positions, block * interpreter_plan.block_rows, buffers);
+		}
+	};
+
+	std::vector<BlazingThread> threads;
+	for(int i = 1; i < num_threads; i++) {
+		threads.push_back(BlazingThread(ral::utilities::with_trace_query(evaluate_blocks)));
+	}
+	evaluate_blocks();
+	for(auto & thread : threads) {
+		thread.join();
+	}
+}
+
+} // namespace cpu
+} // namespace interops
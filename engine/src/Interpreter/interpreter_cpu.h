@@ -0,0 +1,53 @@
+/*
+ * interpreter_cpu.h
+ *
+ * Host backend of the interops interpreter, it runs the same plans as perform_interpreter_operation
+ * over columns that live in host memory.
+ */
+
+#pragma once
+
+#include "interpreter_cpp.h"
+#include <string>
+
+namespace interops {
+namespace cpu {
+
+/**
+ * A scalar of the plan with its value already in host memory.
+ * Integers, booleans and timestamps (as the count of their unit) are kept in int_value, floating points in float_value.
+ * A null scalar has an EMPTY type.
+ */
+struct host_scalar {
+	cudf::type_id type = cudf::type_id::EMPTY;
+	int64_t int_value = 0;
+	double float_value = 0.0;
+	std::string string_value;
+};
+
+/**
+ * Copies the values of the scalars of a plan to host memory, nullptr entries give an EMPTY host_scalar
+ */
+std::vector<host_scalar> to_host_scalars(const std::vector<std::unique_ptr<cudf::scalar>> & scalars);
+
+/**
+ * Evaluates the plan row block by row block, each block is sized so that all the registers of the plan fit in cache.
+ * Every operator is applied to the whole block before the next one, over typed arrays and a word of the null masks at a time.
+ * The blocks are split among num_threads threads, 0 means one per core (less for small tables).
+ *
+ * The data and null masks of table and out_table must be in host memory. The plan is the same one that
+ * add_expression_to_interpreter_plan builds for the device interpreter, and so are the results.
+ */
+void perform_interpreter_operation(cudf::mutable_table_view & out_table,
+	const cudf::table_view & table,
+	const std::vector<column_index_type> & left_inputs,
+	const std::vector<column_index_type> & right_inputs,
+	const std::vector<column_index_type> & outputs,
+	const std::vector<column_index_type> & final_output_positions,
+	const std::vector<operator_type> & operators,
+	const std::vector<host_scalar> & left_scalars,
+	const std::vector<host_scalar> & right_scalars,
+	int num_threads = 0);
+
+} // namespace cpu
+} // namespace interops
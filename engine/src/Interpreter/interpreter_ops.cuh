@@ -483,7 +483,7 @@ private:
 					setColumnValid(row_valids, output_position, !!left_value);
 				} else if(right_valid) {
 					store_data_in_buffer(right_value, buffer, output_position);
-					setColumnValid(row_valids, output_position, !!right_valid);
+					setColumnValid(row_valids, output_position, !!right_value);
 				}	else {
 					setColumnValid(row_valids, output_position, false);
 				}
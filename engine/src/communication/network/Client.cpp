@@ -2,6 +2,8 @@
 // #include <blazingdb/manager/Manager.h>
 #include <blazingdb/transport/Client.h>
 #include <blazingdb/transport/api.h>
+#include "communication/CommunicationData.h"
+#include "utilities/Tracing.h"
 
 namespace ral {
 namespace communication {
@@ -9,14 +11,15 @@ namespace network {
 
 // concurrent::send
 Status Client::send(const Node & node, GPUMessage & message) {
-	const auto & metadata = node.address().metadata();
-	auto ral_client = blazingdb::transport::ClientTCP::Make(metadata.ip, metadata.comunication_port);
+	ral::utilities::trace_span span("communication", "Client::send", message.getContextTokenValue());
+	const auto & self_metadata = CommunicationData::getInstance().getSelfNode().address().metadata();
+	auto ral_client = blazingdb::transport::Client::Make(self_metadata, node.address().metadata());
 	return ral_client->Send(message);
 }
 
 bool Client::notifyLastMessageEvent(const Node & node, const Message::MetaData &message_metadata) {
-	const auto & metadata = node.address().metadata();
-	auto ral_client = blazingdb::transport::ClientTCP::Make(metadata.ip, metadata.comunication_port);
+	const auto & self_metadata = CommunicationData::getInstance().getSelfNode().address().metadata();
+	auto ral_client = blazingdb::transport::Client::Make(self_metadata, node.address().metadata());
 	return ral_client->notifyLastMessageEvent(message_metadata);
 }
 
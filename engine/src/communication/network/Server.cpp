@@ -1,5 +1,6 @@
 #include "communication/network/Server.h"
 #include "communication/messages/ComponentMessages.h"
+#include "utilities/Tracing.h"
 
 namespace ral {
 namespace communication {
@@ -43,6 +44,7 @@ void Server::deregisterContext(const ContextToken context_token) { comm_server->
 
 std::shared_ptr<ReceivedMessage> Server::getMessage(
 	const ContextToken & token_value, const MessageTokenType & messageToken) {
+	ral::utilities::trace_span span("communication", "Server::getMessage", token_value);
 	auto message = comm_server->getMessage(token_value, messageToken);
 	
 	messages::ReceivedHostMessage * host_msg_ptr = nullptr;
@@ -60,6 +62,7 @@ std::shared_ptr<ReceivedMessage> Server::getMessage(
 }
 
 std::shared_ptr<ReceivedMessage> Server::getHostMessage(const ContextToken & token_value, const MessageTokenType & messageToken){
+	ral::utilities::trace_span span("communication", "Server::getHostMessage", token_value);
 	return comm_server->getMessage(token_value, messageToken);
 }
 
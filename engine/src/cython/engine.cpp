@@ -11,9 +11,11 @@
 #include "../io/data_provider/UriDataProvider.h"
 #include "../skip_data/SkipDataProcessor.h"
 #include "../execution_graph/logic_controllers/LogicalFilter.h"
+#include "../execution_graph/logic_controllers/QueryResultCache.h"
 #include "communication/network/Server.h"
 #include <numeric>
 #include <map>
+#include <mutex>
 #include <spdlog/spdlog.h>
 using namespace fmt::literals;
 
@@ -115,6 +117,120 @@ void fix_column_names_duplicated(std::vector<std::string> & col_names){
 	}
 }
 
+namespace {
+
+std::vector<blazingdb::transport::Node> get_context_nodes(const std::vector<NodeMetaDataTCP> & tcpMetadata) {
+	std::vector<blazingdb::transport::Node> contextNodes;
+	for(auto currentMetadata : tcpMetadata) {
+		auto address =
+			blazingdb::transport::Address::TCP(currentMetadata.ip, currentMetadata.communication_port, 0);
+		contextNodes.push_back(blazingdb::transport::Node(address));
+	}
+	return contextNodes;
+}
+
+std::unique_ptr<ResultSet> make_result_set(std::unique_ptr<ral::frame::BlazingTable> frame) {
+	std::unique_ptr<ResultSet> result = std::make_unique<ResultSet>();
+	result->names = frame->names();
+	fix_column_names_duplicated(result->names);
+	result->cudfTable = frame->releaseCudfTable();
+	result->skipdata_analysis_fail = false;
+	return result;
+}
+
+std::unique_ptr<ResultSet> make_result_set(std::unique_ptr<ral::frame::BlazingTable> frame, const blazingdb::manager::Context & queryContext) {
+	std::unique_ptr<ResultSet> result = make_result_set(std::move(frame));
+	result->profile = queryContext.getQueryProfile()->getKernelProfiles();
+	return result;
+}
+
+void log_query_error(const blazingdb::manager::Context & queryContext, const std::string & function_name, const std::exception & e) {
+	std::shared_ptr<spdlog::logger> logger = spdlog::get("batch_logger");
+	logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+								"query_id"_a=queryContext.getContextToken(),
+								"step"_a=queryContext.getQueryStep(),
+								"substep"_a=queryContext.getQuerySubstep(),
+								"info"_a="In {}. What: {}"_format(function_name, e.what()),
+								"duration"_a="");
+	logger->flush();
+	std::cerr << e.what() << std::endl;
+}
+
+// The key of the result of a query in the query result cache: its normalized algebra and, for every table, how it is
+// read and the fingerprints of its files. Empty when a table is not only read from files that have a version, or when
+// the query calls a function like RAND whose result changes from one run to the next
+std::string get_result_cache_key(const std::string & query,
+	const std::vector<std::string> & tableNames,
+	const std::vector<TableSchema> & tableSchemas,
+	const std::vector<std::vector<std::string>> & tableSchemaCppArgKeys,
+	const std::vector<std::vector<std::string>> & tableSchemaCppArgValues,
+	const std::vector<std::vector<std::string>> & filesAll,
+	const std::vector<int> & fileTypes,
+	const std::vector<std::vector<std::map<std::string, std::string>>> & uri_values) {
+
+	if(!ral::cache::query_result_cache::is_deterministic(query)) {
+		return "";
+	}
+
+	std::string key = ral::parser::normalize_algebra(query);
+	for(size_t i = 0; i < tableNames.size(); i++) {
+		if(fileTypes[i] == gdfFileType || fileTypes[i] == daskFileType || fileTypes[i] == ral::io::DataType::ARROW ||
+			filesAll[i].empty()) {
+			return "";
+		}
+
+		key += "\n" + tableNames[i] + "|" + std::to_string(fileTypes[i]);
+		for(size_t col = 0; col < tableSchemas[i].names.size(); col++) {
+			key += "|" + tableSchemas[i].names[col] + ":" + std::to_string(static_cast<int>(tableSchemas[i].types[col]));
+		}
+		for(size_t arg = 0; arg < tableSchemaCppArgKeys[i].size(); arg++) {
+			key += "|" + tableSchemaCppArgKeys[i][arg] + "=" + tableSchemaCppArgValues[i][arg];
+		}
+		for(size_t fileIndex = 0; fileIndex < filesAll[i].size(); fileIndex++) {
+			std::string fingerprint = ral::cache::query_result_cache::file_fingerprint(filesAll[i][fileIndex]);
+			if(fingerprint.empty()) {
+				return "";
+			}
+			key += "\n" + fingerprint;
+			if(fileIndex < uri_values[i].size()) {
+				for(auto & value : uri_values[i][fileIndex]) {
+					key += "|" + value.first + "=" + value.second;
+				}
+			}
+		}
+	}
+	return key;
+}
+
+void log_result_cache_lookup(const blazingdb::manager::Context & queryContext, bool hit) {
+	auto & result_cache = ral::cache::query_result_cache::getInstance();
+	std::shared_ptr<spdlog::logger> logger = spdlog::get("batch_logger");
+	logger->info("{query_id}|{step}|{substep}|{info}|{duration}||||",
+								"query_id"_a=queryContext.getContextToken(),
+								"step"_a=queryContext.getQueryStep(),
+								"substep"_a=queryContext.getQuerySubstep(),
+								"info"_a="\"Result cache {}. Hit rate: {:.3f}, bytes served: {}, host bytes: {}, disk bytes: {}\""_format(
+									hit ? "hit" : "miss", result_cache.hit_rate(), result_cache.bytes_served(),
+									result_cache.host_bytes(), result_cache.disk_bytes()),
+								"duration"_a="");
+}
+
+// What prepareQuery resolves once for all the runs of a query
+struct prepared_statement {
+	std::vector<std::string> table_names;
+	std::vector<ral::io::data_loader> input_loaders;
+	std::vector<ral::io::Schema> schemas;
+	// not rewritten yet, since the physical operators depend on the number of nodes the query runs on
+	std::shared_ptr<const ral::parser::plan_node> plan_template;
+	size_t num_parameters;
+};
+
+std::mutex prepared_statements_mutex;
+std::map<int32_t, std::shared_ptr<prepared_statement>> prepared_statements;
+int32_t next_prepared_statement_id = 0;
+
+}  // namespace
+
 std::unique_ptr<ResultSet> runQuery(int32_t masterIndex,
 	std::vector<NodeMetaDataTCP> tcpMetadata,
 	std::vector<std::string> tableNames,
@@ -129,51 +245,133 @@ std::unique_ptr<ResultSet> runQuery(int32_t masterIndex,
 	std::vector<std::vector<std::map<std::string, std::string>>> uri_values,
 	std::map<std::string, std::string> config_options ) {
 
-	std::vector<ral::io::data_loader> input_loaders;
-	std::vector<ral::io::Schema> schemas;
-	std::tie(input_loaders, schemas) = get_loaders_and_schemas(tableSchemas, tableSchemaCppArgKeys,
-		tableSchemaCppArgValues, filesAll, fileTypes, uri_values);
-
-	
 	using blazingdb::manager::Context;
-	using blazingdb::transport::Node;
-
-	std::vector<Node> contextNodes;
-	for(auto currentMetadata : tcpMetadata) {
-		auto address =
-			blazingdb::transport::Address::TCP(currentMetadata.ip, currentMetadata.communication_port, 0);
-		contextNodes.push_back(Node(address));
-	}
 
+	std::vector<blazingdb::transport::Node> contextNodes = get_context_nodes(tcpMetadata);
 	Context queryContext{ctxToken, contextNodes, contextNodes[masterIndex], "", config_options};
 	ral::communication::network::Server::getInstance().registerContext(ctxToken);
 	
 	try {
+		// Only single node queries are cached, all the nodes of a distributed query would have to agree on a hit
+		auto & result_cache = ral::cache::query_result_cache::getInstance();
+		result_cache.configure(config_options);
+		std::string result_cache_key;
+		if(result_cache.enabled() && contextNodes.size() == 1) {
+			result_cache_key = get_result_cache_key(query, tableNames, tableSchemas, tableSchemaCppArgKeys,
+				tableSchemaCppArgValues, filesAll, fileTypes, uri_values);
+		}
+		if(!result_cache_key.empty()) {
+			std::unique_ptr<ral::frame::BlazingTable> cached = result_cache.get(result_cache_key);
+			log_result_cache_lookup(queryContext, cached != nullptr);
+			if(cached != nullptr) {
+				return make_result_set(std::move(cached));
+			}
+		}
+
+		std::vector<ral::io::data_loader> input_loaders;
+		std::vector<ral::io::Schema> schemas;
+		std::tie(input_loaders, schemas) = get_loaders_and_schemas(tableSchemas, tableSchemaCppArgKeys,
+			tableSchemaCppArgValues, filesAll, fileTypes, uri_values);
 
 		// Execute query
 		std::unique_ptr<ral::frame::BlazingTable> frame;
 		frame = execute_plan(input_loaders, schemas, tableNames, query, accessToken, queryContext);
+
+		if(!result_cache_key.empty()) {
+			result_cache.put(result_cache_key, frame->toBlazingTableView());
+		}
 		
-		std::unique_ptr<ResultSet> result = std::make_unique<ResultSet>();
-		result->names = frame->names();
-		fix_column_names_duplicated(result->names);
-		result->cudfTable = frame->releaseCudfTable();
-		result->skipdata_analysis_fail = false;
-		return result;
+		return make_result_set(std::move(frame), queryContext);
 	} catch(const std::exception & e) {
-		std::shared_ptr<spdlog::logger> logger = spdlog::get("batch_logger");
-		logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
-									"query_id"_a=queryContext.getContextToken(),
-									"step"_a=queryContext.getQueryStep(),
-									"substep"_a=queryContext.getQuerySubstep(),
-									"info"_a="In runQuery. What: {}"_format(e.what()),
-									"duration"_a="");
-		logger->flush();
-		std::cerr << e.what() << std::endl;
+		log_query_error(queryContext, "runQuery", e);
+		throw;
+	}
+}
+
+int32_t prepareQuery(std::vector<std::string> tableNames,
+	std::vector<TableSchema> tableSchemas,
+	std::vector<std::vector<std::string>> tableSchemaCppArgKeys,
+	std::vector<std::vector<std::string>> tableSchemaCppArgValues,
+	std::vector<std::vector<std::string>> filesAll,
+	std::vector<int> fileTypes,
+	std::string query,
+	std::vector<std::vector<std::map<std::string, std::string>>> uri_values) {
+
+	auto statement = std::make_shared<prepared_statement>();
+	statement->table_names = tableNames;
+	std::tie(statement->input_loaders, statement->schemas) = get_loaders_and_schemas(tableSchemas, tableSchemaCppArgKeys,
+		tableSchemaCppArgValues, filesAll, fileTypes, uri_values);
+	statement->plan_template = ral::parser::build_physical_plan(query);
+	statement->num_parameters = ral::parser::count_parameters(*statement->plan_template);
+
+	std::lock_guard<std::mutex> lock(prepared_statements_mutex);
+	int32_t statementId = next_prepared_statement_id++;
+	prepared_statements[statementId] = statement;
+	return statementId;
+}
+
+std::unique_ptr<ResultSet> runPreparedQuery(int32_t statementId,
+	int32_t masterIndex,
+	std::vector<NodeMetaDataTCP> tcpMetadata,
+	int32_t ctxToken,
+	std::vector<std::string> parameters,
+	uint64_t accessToken,
+	std::map<std::string, std::string> config_options,
+	std::vector<std::string> tableNames,
+	std::vector<TableSchema> tableSchemas,
+	std::vector<std::vector<std::string>> tableSchemaCppArgKeys,
+	std::vector<std::vector<std::string>> tableSchemaCppArgValues,
+	std::vector<std::vector<std::string>> filesAll,
+	std::vector<int> fileTypes,
+	std::vector<std::vector<std::map<std::string, std::string>>> uri_values) {
+
+	std::shared_ptr<prepared_statement> statement;
+	{
+		std::lock_guard<std::mutex> lock(prepared_statements_mutex);
+		auto it = prepared_statements.find(statementId);
+		if(it == prepared_statements.end()) {
+			throw std::invalid_argument("there is no prepared query with id " + std::to_string(statementId));
+		}
+		statement = it->second;
+	}
+	if(parameters.size() != statement->num_parameters) {
+		throw std::invalid_argument("the prepared query takes " + std::to_string(statement->num_parameters) +
+			" parameters but " + std::to_string(parameters.size()) + " were given");
+	}
+
+	using blazingdb::manager::Context;
+
+	std::vector<blazingdb::transport::Node> contextNodes = get_context_nodes(tcpMetadata);
+	Context queryContext{ctxToken, contextNodes, contextNodes[masterIndex], "", config_options};
+	ral::communication::network::Server::getInstance().registerContext(ctxToken);
+
+	try {
+		auto plan = ral::parser::rewrite_plan(ral::parser::bind_parameters(*statement->plan_template, parameters),
+			ral::parser::get_physical_rewrite_rules(queryContext.getTotalNodes()));
+
+		std::unique_ptr<ral::frame::BlazingTable> frame;
+		if(tableNames.empty()) {
+			frame = execute_plan(statement->input_loaders, statement->schemas, statement->table_names, *plan, accessToken, queryContext);
+		} else {
+			std::vector<ral::io::data_loader> input_loaders;
+			std::vector<ral::io::Schema> schemas;
+			std::tie(input_loaders, schemas) = get_loaders_and_schemas(tableSchemas, tableSchemaCppArgKeys,
+				tableSchemaCppArgValues, filesAll, fileTypes, uri_values);
+			frame = execute_plan(input_loaders, schemas, tableNames, *plan, accessToken, queryContext);
+		}
+
+		return make_result_set(std::move(frame), queryContext);
+	} catch(const std::exception & e) {
+		log_query_error(queryContext, "runPreparedQuery", e);
 		throw;
 	}
 }
 
+void releasePreparedQuery(int32_t statementId) {
+	std::lock_guard<std::mutex> lock(prepared_statements_mutex);
+	prepared_statements.erase(statementId);
+}
+
 std::unique_ptr<ResultSet> performPartition(int32_t masterIndex,
 	std::vector<NodeMetaDataTCP> tcpMetadata,
 	int32_t ctxToken,
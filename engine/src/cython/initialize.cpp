@@ -13,8 +13,11 @@
 #include <chrono>
 
 #include <blazingdb/transport/io/reader_writer.h>
+#include <blazingdb/transport/FlowControl.h>
+#include <blazingdb/transport/io/shm_ring_buffer.h>
 
 #include <blazingdb/io/Config/BlazingContext.h>
+#include <blazingdb/io/Library/Logging/AsyncOutput.h>
 #include <blazingdb/io/Library/Logging/CoutOutput.h>
 #include <blazingdb/io/Library/Logging/Logger.h>
 #include "blazingdb/io/Library/Logging/ServiceLogging.h"
@@ -58,6 +61,33 @@ std::string get_ip(const std::string & iface_name = "eth0") {
 	return the_ip;
 }
 
+// The level of LOGGING_LEVEL for both loggers, false if it is not one of them
+bool get_logging_level(std::string name, Library::Logging::LoggingLevel & level, spdlog::level::level_enum & spdlog_level) {
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+	if (name == "trace") {
+		level = Library::Logging::LoggingLevel::TRACE;
+		spdlog_level = spdlog::level::trace;
+	} else if (name == "debug") {
+		level = Library::Logging::LoggingLevel::DEBUG;
+		spdlog_level = spdlog::level::debug;
+	} else if (name == "info") {
+		level = Library::Logging::LoggingLevel::INFO;
+		spdlog_level = spdlog::level::info;
+	} else if (name == "warn") {
+		level = Library::Logging::LoggingLevel::WARN;
+		spdlog_level = spdlog::level::warn;
+	} else if (name == "error") {
+		level = Library::Logging::LoggingLevel::ERROR;
+		spdlog_level = spdlog::level::err;
+	} else if (name == "fatal") {
+		level = Library::Logging::LoggingLevel::FATAL;
+		spdlog_level = spdlog::level::critical;
+	} else {
+		return false;
+	}
+	return true;
+}
+
 void initialize(int ralId,
 	int gpuId,
 	std::string network_iface_name,
@@ -90,6 +120,27 @@ void initialize(int ralId,
 	auto nthread = 4;
 	blazingdb::transport::io::setPinnedBufferProvider(0.1 * total_gpu_mem_size, nthread);
 
+	auto config_it = config_options.find("TRANSPORT_CREDIT_BYTES_PER_SENDER");
+	if (config_it != config_options.end()){
+		blazingdb::transport::setFlowControlCreditsPerSender(std::stoull(config_options["TRANSPORT_CREDIT_BYTES_PER_SENDER"]));
+	}
+
+	config_it = config_options.find("TRANSPORT_SHARED_MEMORY");
+	if (config_it != config_options.end()){
+		bool shared_memory_enabled = config_it->second == "True" || config_it->second == "true" || config_it->second == "1";
+		size_t ring_capacity = blazingdb::transport::io::getSharedMemoryRingCapacity();
+		auto ring_it = config_options.find("TRANSPORT_SHARED_MEMORY_RING_BYTES");
+		if (ring_it != config_options.end()){
+			ring_capacity = std::stoull(ring_it->second);
+		}
+		std::string cluster_id;
+		auto cluster_it = config_options.find("TRANSPORT_SHARED_MEMORY_CLUSTER_ID");
+		if (cluster_it != config_options.end()){
+			cluster_id = cluster_it->second;
+		}
+		blazingdb::transport::io::setSharedMemoryTransport(shared_memory_enabled, ring_capacity, cluster_id);
+	}
+
 	auto & communicationData = ral::communication::CommunicationData::getInstance();
 	communicationData.initialize(ralId, "1.1.1.1", 0, ralHost, ralCommunicationPort, 0);
 
@@ -120,6 +171,25 @@ void initialize(int ralId,
 	spdlog::flush_on(spdlog::level::err);
 	spdlog::flush_every(std::chrono::seconds(1));
 
+	config_it = config_options.find("LOGGING_LEVEL");
+	if (config_it != config_options.end()){
+		Library::Logging::LoggingLevel level;
+		spdlog::level::level_enum spdlog_level;
+		if (get_logging_level(config_it->second, level, spdlog_level)) {
+			Library::Logging::ServiceLogging::getInstance().setLogLevel(level);
+			logger->set_level(spdlog_level);
+		} else {
+			logger->warn("|||{info}|||||","info"_a="Unknown LOGGING_LEVEL " + config_it->second + ", the logging level is not changed");
+		}
+	}
+
+	// the threads that log only queue their logs, and one thread writes them in batches
+	config_it = config_options.find("ENABLE_ASYNC_LOGGING");
+	if (config_it != config_options.end() && (config_it->second == "True" || config_it->second == "true" || config_it->second == "1")){
+		Library::Logging::ServiceLogging::getInstance().setLogOutput(
+			new Library::Logging::AsyncOutput(new Library::Logging::CoutOutput()));
+	}
+
 	logger->debug("|||{info}|||||","info"_a=initLogMsg);
 
 	std::map<std::string, std::string> product_details = getProductDetails();
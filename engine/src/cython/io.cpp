@@ -84,32 +84,36 @@ std::unique_ptr<ResultSet> parseMetadata(std::vector<std::string> files,
 	if (offset.second == 0) {
 		// cover case for empty files to parse
 		
-		std::vector<size_t> column_indices(2 * schema.types.size() + 2);
+		std::vector<size_t> column_indices(3 * schema.types.size() + 3);
 		std::iota(column_indices.begin(), column_indices.end(), 0);
 
-		std::vector<std::string> names(2 * schema.types.size() + 2);
-		std::vector<cudf::type_id> dtypes(2 * schema.types.size() + 2);
+		std::vector<std::string> names(3 * schema.types.size() + 3);
+		std::vector<cudf::type_id> dtypes(3 * schema.types.size() + 3);
 
 		size_t index = 0;
 		for(; index < schema.types.size(); index++) {
 			cudf::type_id dtype = schema.types[index];
-			if (dtype == cudf::type_id::STRING)
-				dtype = cudf::type_id::INT32;
 
-			dtypes[2*index] = dtype;
-			dtypes[2*index + 1] = dtype;
+			dtypes[3*index] = dtype;
+			dtypes[3*index + 1] = dtype;
+			dtypes[3*index + 2] = cudf::type_id::INT64;
 			
 			auto col_name_min = "min_" + std::to_string(index) + "_" + schema.names[index];
 			auto col_name_max = "max_" + std::to_string(index)  + "_" + schema.names[index];
+			auto col_name_null_count = "null_count_" + std::to_string(index)  + "_" + schema.names[index];
 
-			names[2*index] = col_name_min;
-			names[2*index + 1] = col_name_max;
+			names[3*index] = col_name_min;
+			names[3*index + 1] = col_name_max;
+			names[3*index + 2] = col_name_null_count;
 		}
-		dtypes[2*index] = cudf::type_id::INT32;
-		names[2*index] = "file_handle_index";
+		dtypes[3*index] = cudf::type_id::INT64;
+		names[3*index] = "num_rows";
 
-		dtypes[2*index + 1] = cudf::type_id::INT32;
-		names[2*index + 1] = "row_group_index";
+		dtypes[3*index + 1] = cudf::type_id::INT32;
+		names[3*index + 1] = "file_handle_index";
+
+		dtypes[3*index + 2] = cudf::type_id::INT32;
+		names[3*index + 2] = "row_group_index";
 		std::unique_ptr<ResultSet> result = std::make_unique<ResultSet>();
 		result->names = names;
 		auto table = ral::utilities::create_empty_table(dtypes);
@@ -0,0 +1,131 @@
+#include "distribution/broadcast_join.h"
+#include "distribution/primitives.h"
+#include "communication/CommunicationData.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <string>
+
+namespace ral {
+namespace distribution {
+
+typedef ral::communication::CommunicationData CommunicationData;
+
+namespace {
+
+const int64_t LEFT_SIDE_COMPLETE = 1;
+const int64_t RIGHT_SIDE_COMPLETE = 2;
+
+int64_t total_bytes(const std::vector<JoinSideSize> & nodes) {
+	return std::accumulate(nodes.begin(), nodes.end(), int64_t(0),
+		[](int64_t total, const JoinSideSize & size) { return total + size.bytes; });
+}
+
+bool all_complete(const std::vector<JoinSideSize> & nodes) {
+	return std::all_of(nodes.begin(), nodes.end(), [](const JoinSideSize & size) { return size.complete; });
+}
+
+}  // namespace
+
+int64_t getMaxJoinScatterMemOverhead(Context * context) {
+	int64_t max_join_scatter_mem_overhead = DEFAULT_MAX_JOIN_SCATTER_MEM_OVERHEAD;
+	std::map<std::string, std::string> config_options = context->getConfigOptions();
+	auto it = config_options.find("MAX_JOIN_SCATTER_MEM_OVERHEAD");
+	if (it != config_options.end()){
+		max_join_scatter_mem_overhead = std::stoll(config_options["MAX_JOIN_SCATTER_MEM_OVERHEAD"]);
+	}
+	return max_join_scatter_mem_overhead;
+}
+
+int64_t getJoinScatterDecisionBufferBytes(Context * context) {
+	int64_t buffer_bytes = getMaxJoinScatterMemOverhead(context) / std::max(context->getTotalNodes(), 1);
+	std::map<std::string, std::string> config_options = context->getConfigOptions();
+	auto it = config_options.find("JOIN_SCATTER_DECISION_BUFFER_BYTES");
+	if (it != config_options.end()){
+		buffer_bytes = std::stoll(config_options["JOIN_SCATTER_DECISION_BUFFER_BYTES"]);
+	}
+	return buffer_bytes;
+}
+
+SmallTableScatterDecision decideSmallTableScatter(const std::vector<JoinSideSize> & nodes_left,
+	const std::vector<JoinSideSize> & nodes_right, int64_t max_overhead) {
+
+	SmallTableScatterDecision decision;
+	decision.total_bytes_left = total_bytes(nodes_left);
+	decision.total_bytes_right = total_bytes(nodes_right);
+
+	int64_t num_nodes = nodes_left.size();
+	if (num_nodes < 2) {
+		return decision;
+	}
+
+	decision.estimate_regular_distribution = (decision.total_bytes_left + decision.total_bytes_right) * (num_nodes - 1) / num_nodes;
+	int64_t estimate_scatter_left = decision.total_bytes_left * (num_nodes - 1);
+	int64_t estimate_scatter_right = decision.total_bytes_right * (num_nodes - 1);
+
+	if(estimate_scatter_left < decision.estimate_regular_distribution ||
+		estimate_scatter_right < decision.estimate_regular_distribution) {
+		if(estimate_scatter_left < estimate_scatter_right &&
+			decision.total_bytes_left < max_overhead) {
+			decision.scatter_left = true;
+			decision.estimate_scatter = estimate_scatter_left;
+			decision.scattered_side_complete = all_complete(nodes_left);
+		} else if(estimate_scatter_right < estimate_scatter_left &&
+				decision.total_bytes_right < max_overhead) {
+			decision.scatter_right = true;
+			decision.estimate_scatter = estimate_scatter_right;
+			decision.scattered_side_complete = all_complete(nodes_right);
+		}
+	}
+	return decision;
+}
+
+void exchangeJoinSideSizes(Context * context, const JoinSideSize & left, const JoinSideSize & right,
+	std::vector<JoinSideSize> & nodes_left, std::vector<JoinSideSize> & nodes_right) {
+
+	int self_node_idx = context->getNodeIndex(CommunicationData::getInstance().getSelfNode());
+
+	context->incrementQuerySubstep();
+	distributeLeftRightTableSizeBytes(context, left.bytes, right.bytes);
+	std::vector<int64_t> nodes_num_bytes_left;
+	std::vector<int64_t> nodes_num_bytes_right;
+	collectLeftRightTableSizeBytes(context, nodes_num_bytes_left, nodes_num_bytes_right);
+	nodes_num_bytes_left[self_node_idx] = left.bytes;
+	nodes_num_bytes_right[self_node_idx] = right.bytes;
+
+	// whether each side was seen whole goes in a second, much smaller, message
+	int64_t self_complete_flags = (left.complete ? LEFT_SIDE_COMPLETE : 0) | (right.complete ? RIGHT_SIDE_COMPLETE : 0);
+	context->incrementQuerySubstep();
+	distributeNumRows(context, self_complete_flags);
+	std::vector<int64_t> nodes_complete_flags = collectNumRows(context);
+	nodes_complete_flags[self_node_idx] = self_complete_flags;
+
+	nodes_left.resize(nodes_num_bytes_left.size());
+	nodes_right.resize(nodes_num_bytes_right.size());
+	for (std::size_t i = 0; i < nodes_num_bytes_left.size(); i++) {
+		nodes_left[i] = JoinSideSize{nodes_num_bytes_left[i], (nodes_complete_flags[i] & LEFT_SIDE_COMPLETE) != 0};
+		nodes_right[i] = JoinSideSize{nodes_num_bytes_right[i], (nodes_complete_flags[i] & RIGHT_SIDE_COMPLETE) != 0};
+	}
+}
+
+bool anyNodeSwitchedToHashPartitioning(Context * context, bool switched) {
+	context->incrementQuerySubstep();
+	distributeNumRows(context, switched ? 1 : 0);
+	std::vector<int64_t> nodes_switched = collectNumRows(context);
+	return switched || std::any_of(nodes_switched.begin(), nodes_switched.end(), [](int64_t node_switched){ return node_switched != 0; });
+}
+
+int64_t getScatterBudgetBytes(const SmallTableScatterDecision & decision, int64_t self_estimate_bytes,
+	int num_nodes, int64_t max_overhead) {
+
+	if (decision.scattered_side_complete) {
+		return std::numeric_limits<int64_t>::max();
+	}
+	int64_t total_estimate = decision.scatter_left ? decision.total_bytes_left : decision.total_bytes_right;
+	int64_t room = std::max(max_overhead - total_estimate, int64_t(0));
+	return self_estimate_bytes + room / std::max(num_nodes, 1);
+}
+
+}  // namespace distribution
+}  // namespace ral
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "blazingdb/manager/Context.h"
+#include <cstdint>
+#include <vector>
+
+namespace ral {
+namespace distribution {
+
+	namespace {
+		using Context = blazingdb::manager::Context;
+	}  // namespace
+
+	const int64_t DEFAULT_MAX_JOIN_SCATTER_MEM_OVERHEAD = 500000000;  // 500Mb  how much extra memory consumption per node are we ok with
+
+// What a node has seen of one side of a join before the join strategy is chosen.
+// When complete is false, bytes is an estimate of the whole side, which is never less than what was actually buffered.
+	struct JoinSideSize {
+		int64_t bytes;
+		bool complete;
+	};
+
+	struct SmallTableScatterDecision {
+		bool scatter_left = false;
+		bool scatter_right = false;
+		// true when every node saw the whole side that is going to be scattered, so the decision cannot turn out to be wrong
+		bool scattered_side_complete = false;
+		int64_t total_bytes_left = 0;
+		int64_t total_bytes_right = 0;
+		// the bytes that would cross the network with each strategy
+		int64_t estimate_regular_distribution = 0;
+		int64_t estimate_scatter = 0;
+	};
+
+// Reads MAX_JOIN_SCATTER_MEM_OVERHEAD from the config options
+	int64_t getMaxJoinScatterMemOverhead(Context * context);
+
+// Reads JOIN_SCATTER_DECISION_BUFFER_BYTES from the config options. It is how many bytes of each side of a join a node
+// buffers before it picks between scattering one side and hash partitioning both. By default it is the share of one node
+// of MAX_JOIN_SCATTER_MEM_OVERHEAD, since a side that is bigger than that is unlikely to be scattered anyway.
+	int64_t getJoinScatterDecisionBufferBytes(Context * context);
+
+// Picks the join strategy from the sizes that every node reported for each side, nodes_left[i] being the left side of node i.
+// Scattering a side is chosen when it moves fewer bytes than hash partitioning both sides and the side is smaller than max_overhead.
+	SmallTableScatterDecision decideSmallTableScatter(const std::vector<JoinSideSize> & nodes_left,
+		const std::vector<JoinSideSize> & nodes_right, int64_t max_overhead);
+
+// Collective operation, every node of the context must call it. Sends the sizes this node saw of each side of the join
+// and returns the sizes of all the nodes, indexed by node.
+	void exchangeJoinSideSizes(Context * context, const JoinSideSize & left, const JoinSideSize & right,
+		std::vector<JoinSideSize> & nodes_left, std::vector<JoinSideSize> & nodes_right);
+
+// Collective operation, every node of the context must call it. Returns true if any node, this one included, switched
+// from scattering its side of the join to hash partitioning it.
+	bool anyNodeSwitchedToHashPartitioning(Context * context, bool switched);
+
+// How many bytes a node can scatter before it has to switch the rest of its side to hash partitioning.
+// Each node gets what it estimated for itself plus an even share of the room left under max_overhead,
+// so that all the nodes together never scatter more than max_overhead. There is no limit when the scattered side was seen whole.
+	int64_t getScatterBudgetBytes(const SmallTableScatterDecision & decision, int64_t self_estimate_bytes,
+		int num_nodes, int64_t max_overhead);
+
+}  // namespace distribution
+}  // namespace ral
@@ -4,8 +4,11 @@
 #include "communication/network/Client.h"
 #include "communication/network/Server.h"
 #include "utilities/StringUtils.h"
+#include "utilities/Tracing.h"
 #include <blazingdb/io/Library/Logging/Logger.h>
+#include <blazingdb/transport/FlowControl.h>
 #include <cmath>
+#include <spdlog/spdlog.h>
 
 #include <cudf/search.hpp>
 #include <cudf/sorting.hpp>
@@ -18,6 +21,8 @@
 #include "utilities/random_generator.cuh"
 #include "Utils.cuh"
 
+using namespace fmt::literals;
+
 namespace ral {
 namespace distribution {
 
@@ -194,8 +199,13 @@ void distributeTablePartitions(Context * context, std::vector<NodeColumnView> &
 	std::string context_comm_token = context->getContextCommunicationToken();
 	const uint32_t context_token = context->getContextToken();
 	const std::string message_id = ColumnDataPartitionMessage::MessageID() + "_" + context_comm_token;
+	ral::utilities::trace_span span("distribution", "distributeTablePartitions", context_token, "partitions", partitions.size());
 
 	auto self_node = CommunicationData::getInstance().getSelfNode();
+	auto & flow_control_stats = blazingdb::transport::getFlowControlStats();
+	uint64_t stall_time_ns_before = flow_control_stats.stall_time_ns.load();
+	uint64_t stalled_sends_before = flow_control_stats.stalled_sends.load();
+
 	std::vector<BlazingThread> threads;
 	for (auto i = 0; i < partitions.size(); i++){
 		auto & nodeColumn = partitions[i];
@@ -208,15 +218,27 @@ void distributeTablePartitions(Context * context, std::vector<NodeColumnView> &
 			auto destination_node = nodeColumn.first;
 			int partition_id = part_ids.size() > i ? part_ids[i] : 0; // if part_ids is not set, then it does not matter and we can just use 0 as the partition_id
 			
-			threads.push_back(BlazingThread([message_id, context_token, self_node, destination_node, columns, partition_id]() mutable {
+			threads.push_back(BlazingThread(ral::utilities::with_trace_query([message_id, context_token, self_node, destination_node, columns, partition_id]() mutable {
 				auto message = Factory::createColumnDataPartitionMessage(message_id, context_token, self_node, partition_id, columns);
 				Client::send(destination_node, *message);
-			}));
+			})));
 		}
 	}
 	for(size_t i = 0; i < threads.size(); i++) {
 		threads[i].join();
 	}
+
+	// the counters are shared by all the queries of the process, so the delta is only an approximation when queries overlap
+	uint64_t stalled_sends = flow_control_stats.stalled_sends.load() - stalled_sends_before;
+	if (stalled_sends > 0) {
+		auto logger = spdlog::get("batch_logger");
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}||||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="distributeTablePartitions stalled by flow control. stalled_sends: " + std::to_string(stalled_sends),
+									"duration"_a=(flow_control_stats.stall_time_ns.load() - stall_time_ns_before) / 1000000.0);
+	}
 }
 
 void notifyLastTablePartitions(Context * context, std::string message_id) {
@@ -241,6 +263,7 @@ void distributePartitions(Context * context, std::vector<NodeColumnView> & parti
 	std::string context_comm_token = context->getContextCommunicationToken();
 	const uint32_t context_token = context->getContextToken();
 	const std::string message_id = ColumnDataMessage::MessageID() + "_" + context_comm_token;
+	ral::utilities::trace_span span("distribution", "distributePartitions", context_token, "partitions", partitions.size());
 
 	auto self_node = CommunicationData::getInstance().getSelfNode();
 	std::vector<BlazingThread> threads;
@@ -250,10 +273,10 @@ void distributePartitions(Context * context, std::vector<NodeColumnView> & parti
 		}
 		BlazingTableView columns = nodeColumn.second;
 		auto destination_node = nodeColumn.first;
-		threads.push_back(BlazingThread([message_id, context_token, self_node, destination_node, columns]() mutable {
+		threads.push_back(BlazingThread(ral::utilities::with_trace_query([message_id, context_token, self_node, destination_node, columns]() mutable {
 			auto message = Factory::createColumnDataMessage(message_id, context_token, self_node, columns);
 			Client::send(destination_node, *message);
-		}));
+		})));
 	}
 	for(size_t i = 0; i < threads.size(); i++) {
 		threads[i].join();
@@ -355,9 +378,9 @@ void broadcastMessage(std::vector<Node> nodes,
 	std::vector<BlazingThread> threads(nodes.size());
 	for(size_t i = 0; i < nodes.size(); i++) {
 		Node node = nodes[i];
-		threads[i] = BlazingThread([node, message]() {
+		threads[i] = BlazingThread(ral::utilities::with_trace_query([node, message]() {
 			Client::send(node, *message);
-		});
+		}));
 	}
 	for(size_t i = 0; i < threads.size(); i++) {
 		threads[i].join();
@@ -0,0 +1,259 @@
+#include "distribution/skew.h"
+#include "distribution/primitives.h"
+#include "CalciteExpressionParsing.h"
+#include "communication/CommunicationData.h"
+#include "operators/GroupBy.h"
+#include "utilities/CommonOperations.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <spdlog/spdlog.h>
+
+#include <cudf/copying.hpp>
+#include <cudf/replace.hpp>
+#include <cudf/search.hpp>
+#include <cudf/stream_compaction.hpp>
+#include <cudf/unary.hpp>
+#include <from_cudf/cpp_tests/utilities/column_utilities.hpp>
+
+using namespace fmt::literals;
+
+namespace ral {
+namespace distribution {
+
+typedef ral::communication::CommunicationData CommunicationData;
+
+namespace {
+
+const std::string HEAVY_HITTER_COUNT_COLUMN_NAME = "count";
+
+BlazingTableView select_key_column(const BlazingTableView & table, cudf::size_type key_index) {
+	return BlazingTableView(table.view().select({key_index}), {table.names().at(key_index)});
+}
+
+// COUNT(*) of each distinct non null key of a single column table. The counts are returned to the host as int64_t.
+std::pair<std::unique_ptr<BlazingTable>, std::vector<int64_t>> count_keys(const BlazingTableView & keys) {
+	std::unique_ptr<CudfTable> valid_keys = cudf::experimental::drop_nulls(keys.view(), {0});
+
+	std::unique_ptr<BlazingTable> counts = ral::operators::compute_aggregations_with_groupby(
+		BlazingTableView(valid_keys->view(), keys.names()), {""}, {AggregateKind::COUNT_ALL}, {HEAVY_HITTER_COUNT_COLUMN_NAME}, {0});
+
+	std::unique_ptr<CudfColumn> counts_int64 = cudf::experimental::cast(counts->view().column(1), cudf::data_type(cudf::type_id::INT64));
+	std::vector<int64_t> host_counts = cudf::test::to_host<int64_t>(counts_int64->view()).first;
+	return std::make_pair(std::move(counts), std::move(host_counts));
+}
+
+std::unique_ptr<BlazingTable> gather_keys(const BlazingTableView & counts, const std::vector<cudf::size_type> & indices) {
+	rmm::device_buffer gather_map_data(indices.data(), indices.size() * sizeof(cudf::size_type));
+	cudf::column gather_map{cudf::data_type{cudf::type_id::INT32}, static_cast<cudf::size_type>(indices.size()), std::move(gather_map_data)};
+
+	std::unique_ptr<CudfTable> keys = cudf::experimental::gather(counts.view().select({0}), gather_map.view());
+	return std::make_unique<BlazingTable>(std::move(keys), std::vector<std::string>{counts.names().at(0)});
+}
+
+// The counts of the keys of the sample, scaled up to the num_rows that the sample represents
+std::unique_ptr<BlazingTable> count_sampled_keys(const BlazingTableView & key_sample, int64_t num_rows) {
+	std::unique_ptr<BlazingTable> counts;
+	std::vector<int64_t> host_counts;
+	std::tie(counts, host_counts) = count_keys(key_sample);
+
+	// the counts of the sample are scaled up to the whole table, so that the master can merge the counts of nodes with different sizes
+	double scale = key_sample.num_rows() > 0 ? static_cast<double>(num_rows) / key_sample.num_rows() : 0.0;
+	for (auto & count : host_counts) {
+		count = static_cast<int64_t>(std::llround(count * scale));
+	}
+	rmm::device_buffer scaled_counts_data(host_counts.data(), host_counts.size() * sizeof(int64_t));
+
+	std::vector<std::unique_ptr<CudfColumn>> columns = counts->releaseCudfTable()->release();
+	columns[1] = std::make_unique<CudfColumn>(cudf::data_type{cudf::type_id::INT64}, static_cast<cudf::size_type>(host_counts.size()), std::move(scaled_counts_data));
+
+	return std::make_unique<BlazingTable>(std::make_unique<CudfTable>(std::move(columns)),
+		std::vector<std::string>{key_sample.names().at(0), HEAVY_HITTER_COUNT_COLUMN_NAME});
+}
+
+}  // namespace
+
+double getHeavyHitterThreshold(Context * context) {
+	double threshold = DEFAULT_HEAVY_HITTER_THRESHOLD;
+	std::map<std::string, std::string> config_options = context->getConfigOptions();
+	auto it = config_options.find("SKEW_HEAVY_HITTER_THRESHOLD");
+	if (it != config_options.end()){
+		threshold = std::stod(config_options["SKEW_HEAVY_HITTER_THRESHOLD"]);
+	}
+	return threshold;
+}
+
+std::unique_ptr<BlazingTable> sampleKeys(const BlazingTableView & table, cudf::size_type key_index, std::size_t num_samples) {
+	BlazingTableView keys = select_key_column(table, key_index);
+	if (table.num_rows() > 0 && num_samples < static_cast<std::size_t>(table.num_rows())) {
+		return sampling::generateSamples(keys, num_samples);
+	}
+	return keys.clone();
+}
+
+std::unique_ptr<BlazingTable> mergeKeySamples(const std::vector<BlazingTableView> & samples,
+	const std::vector<int64_t> & num_rows, std::size_t num_samples) {
+
+	int64_t total_rows = std::accumulate(num_rows.begin(), num_rows.end(), int64_t(0));
+
+	std::vector<std::unique_ptr<BlazingTable>> shares;
+	std::vector<BlazingTableView> share_views;
+	for (std::size_t i = 0; i < samples.size(); i++) {
+		std::size_t share_size = total_rows > 0 ? static_cast<std::size_t>(std::llround(
+			static_cast<double>(num_samples) * num_rows[i] / total_rows)) : 0;
+		if (share_size < static_cast<std::size_t>(samples[i].num_rows())) {
+			// the sample of a small batch is all its keys in order, so its share is drawn at random too
+			shares.push_back(sampling::generateSamples(samples[i], share_size));
+			share_views.push_back(shares.back()->toBlazingTableView());
+		} else {
+			share_views.push_back(samples[i]);
+		}
+	}
+	return ral::utilities::concatTables(share_views);
+}
+
+std::unique_ptr<BlazingTable> sampleKeyCounts(const BlazingTableView & table, cudf::size_type key_index, std::size_t num_samples) {
+	std::unique_ptr<BlazingTable> key_sample = sampleKeys(table, key_index, num_samples);
+	return count_sampled_keys(key_sample->toBlazingTableView(), table.num_rows());
+}
+
+std::pair<std::unique_ptr<BlazingTable>, double> selectHeavyHitters(const std::vector<BlazingTableView> & key_counts,
+	int64_t total_rows, int num_nodes, double threshold) {
+
+	std::unique_ptr<BlazingTable> all_counts = ral::utilities::concatTables(key_counts);
+
+	// the same key can come from many nodes
+	std::unique_ptr<BlazingTable> merged_counts = ral::operators::compute_aggregations_with_groupby(
+		all_counts->toBlazingTableView(), {"1"}, {AggregateKind::SUM}, {HEAVY_HITTER_COUNT_COLUMN_NAME}, {0});
+
+	std::unique_ptr<CudfColumn> counts_int64 = cudf::experimental::cast(merged_counts->view().column(1), cudf::data_type(cudf::type_id::INT64));
+	std::vector<int64_t> host_counts = cudf::test::to_host<int64_t>(counts_int64->view()).first;
+
+	double max_share = 0.0;
+	std::vector<cudf::size_type> heavy_hitter_indices;
+	if (total_rows > 0) {
+		double threshold_rows = threshold * static_cast<double>(total_rows) / num_nodes;
+		for (std::size_t i = 0; i < host_counts.size(); i++) {
+			max_share = std::max(max_share, static_cast<double>(host_counts[i]) / total_rows);
+			if (host_counts[i] > threshold_rows) {
+				heavy_hitter_indices.push_back(i);
+			}
+		}
+	}
+
+	return std::make_pair(gather_keys(merged_counts->toBlazingTableView(), heavy_hitter_indices), max_share);
+}
+
+std::unique_ptr<BlazingTable> determineHeavyHitters(Context * context, const BlazingTableView & table,
+	cudf::size_type key_index, double threshold, std::size_t num_samples) {
+
+	std::unique_ptr<BlazingTable> key_sample = sampleKeys(table, key_index, num_samples);
+	return determineHeavyHittersFromSample(context, key_sample->toBlazingTableView(), table.num_rows(), threshold);
+}
+
+std::unique_ptr<BlazingTable> determineHeavyHittersFromSample(Context * context, const BlazingTableView & key_sample,
+	int64_t num_rows, double threshold) {
+
+	std::unique_ptr<BlazingTable> self_counts = count_sampled_keys(key_sample, num_rows);
+
+	std::unique_ptr<BlazingTable> heavy_hitter_keys;
+	if(context->isMasterNode(CommunicationData::getInstance().getSelfNode())) {
+		context->incrementQuerySubstep();
+		std::pair<std::vector<NodeColumn>, std::vector<std::size_t> > counts_pair = collectSamples(context);
+		std::vector<BlazingTableView> key_counts;
+		for (std::size_t i = 0; i < counts_pair.first.size(); i++){
+			key_counts.push_back(counts_pair.first[i].second->toBlazingTableView());
+		}
+		key_counts.push_back(self_counts->toBlazingTableView());
+		int64_t total_rows = std::accumulate(counts_pair.second.begin(), counts_pair.second.end(), num_rows);
+
+		double max_share;
+		std::tie(heavy_hitter_keys, max_share) = selectHeavyHitters(key_counts, total_rows, context->getTotalNodes(), threshold);
+
+		auto logger = spdlog::get("batch_logger");
+		logger->debug("{query_id}|{step}|{substep}|{info}|||||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="Heavy hitter detection. sampled_rows: {} heavy_hitters: {} max_key_share: {} threshold_share: {}"_format(
+										total_rows, heavy_hitter_keys->num_rows(), max_share, threshold / context->getTotalNodes()));
+
+		context->incrementQuerySubstep();
+		distributePartitionPlan(context, heavy_hitter_keys->toBlazingTableView());
+	} else {
+		context->incrementQuerySubstep();
+		sendSamplesToMaster(context, self_counts->toBlazingTableView(), num_rows);
+		context->incrementQuerySubstep();
+		heavy_hitter_keys = getPartitionPlan(context);
+	}
+	return heavy_hitter_keys;
+}
+
+std::unique_ptr<BlazingTable> findRecurringKeys(const std::vector<BlazingTableView> & tables, cudf::size_type key_index,
+	std::size_t max_keys) {
+
+	std::vector<BlazingTableView> keys;
+	for (auto & table : tables) {
+		keys.push_back(select_key_column(table, key_index));
+	}
+	std::unique_ptr<BlazingTable> all_keys = ral::utilities::concatTables(keys);
+
+	std::unique_ptr<BlazingTable> counts;
+	std::vector<int64_t> host_counts;
+	std::tie(counts, host_counts) = count_keys(all_keys->toBlazingTableView());
+
+	std::vector<cudf::size_type> recurring_indices;
+	for (std::size_t i = 0; i < host_counts.size() && recurring_indices.size() < max_keys; i++) {
+		if (host_counts[i] >= static_cast<int64_t>(tables.size())) {
+			recurring_indices.push_back(i);
+		}
+	}
+	return gather_keys(counts->toBlazingTableView(), recurring_indices);
+}
+
+std::unique_ptr<BlazingTable> unionKeys(const std::vector<BlazingTableView> & keys, std::size_t max_keys) {
+	std::unique_ptr<BlazingTable> all_keys = ral::utilities::concatTables(keys);
+
+	std::unique_ptr<BlazingTable> counts;
+	std::vector<int64_t> host_counts;
+	std::tie(counts, host_counts) = count_keys(all_keys->toBlazingTableView());
+
+	std::vector<cudf::size_type> indices(std::min(host_counts.size(), max_keys));
+	std::iota(indices.begin(), indices.end(), 0);
+	return gather_keys(counts->toBlazingTableView(), indices);
+}
+
+std::pair<std::unique_ptr<BlazingTable>, std::unique_ptr<BlazingTable>> splitHeavyHitterRows(const BlazingTableView & table,
+	cudf::size_type key_index, const BlazingTableView & heavy_hitter_keys) {
+
+	// the keys were sampled from the left side, the right side of the join may hold them in another type
+	CudfColumnView keys = heavy_hitter_keys.view().column(0);
+	std::unique_ptr<CudfColumn> casted_keys;
+	if (keys.type() != table.view().column(key_index).type()) {
+		casted_keys = cudf::experimental::cast(keys, table.view().column(key_index).type());
+		keys = casted_keys->view();
+	}
+
+	std::unique_ptr<CudfColumn> is_heavy_hitter = cudf::experimental::contains(keys, table.view().column(key_index));
+	// a null key gives a null here, and a null in a boolean mask drops the row from both sides
+	std::unique_ptr<cudf::scalar> false_scalar = get_scalar_from_string("false", cudf::type_id::BOOL8);
+	is_heavy_hitter = cudf::experimental::replace_nulls(is_heavy_hitter->view(), *false_scalar);
+	std::unique_ptr<CudfColumn> is_not_heavy_hitter = cudf::experimental::unary_operation(is_heavy_hitter->view(), cudf::experimental::unary_op::NOT);
+
+	std::unique_ptr<CudfTable> heavy_hitter_rows = cudf::experimental::apply_boolean_mask(table.view(), is_heavy_hitter->view());
+	std::unique_ptr<CudfTable> other_rows = cudf::experimental::apply_boolean_mask(table.view(), is_not_heavy_hitter->view());
+
+	return std::make_pair(std::make_unique<BlazingTable>(std::move(heavy_hitter_rows), table.names()),
+		std::make_unique<BlazingTable>(std::move(other_rows), table.names()));
+}
+
+std::vector<CudfTableView> splitEvenly(const CudfTableView & table, int num_partitions) {
+	std::vector<cudf::size_type> split_indexes;
+	for (int i = 1; i < num_partitions; i++) {
+		split_indexes.push_back(static_cast<cudf::size_type>(static_cast<int64_t>(table.num_rows()) * i / num_partitions));
+	}
+	return cudf::experimental::split(table, split_indexes);
+}
+
+}  // namespace distribution
+}  // namespace ral
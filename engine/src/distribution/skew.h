@@ -0,0 +1,71 @@
+#pragma once
+
+#include "blazingdb/manager/Context.h"
+#include "execution_graph/logic_controllers/LogicPrimitives.h"
+#include <vector>
+
+namespace ral {
+namespace distribution {
+
+	namespace {
+		using Context = blazingdb::manager::Context;
+	}  // namespace
+
+	using namespace ral::frame;
+
+	const double DEFAULT_HEAVY_HITTER_THRESHOLD = 0;
+	const std::size_t DEFAULT_HEAVY_HITTER_NUM_SAMPLES = 10000;
+
+// Reads SKEW_HEAVY_HITTER_THRESHOLD from the config options. A key is a heavy hitter when its estimated share of the rows
+// is bigger than this threshold times the share of a single node, that is threshold / number of nodes.
+// A value <= 0 disables the skew handling.
+	double getHeavyHitterThreshold(Context * context);
+
+// Samples the key column of the table and counts the sampled keys. The counts are scaled up to the number of rows of the table.
+// The output has two columns, the distinct keys and their estimated number of rows as INT64.
+	std::unique_ptr<BlazingTable> sampleKeyCounts(const BlazingTableView & table, cudf::size_type key_index, std::size_t num_samples);
+
+// The key column of the table as a single column table, or num_samples random rows of it when the table has more rows.
+	std::unique_ptr<BlazingTable> sampleKeys(const BlazingTableView & table, cudf::size_type key_index, std::size_t num_samples);
+
+// Merges the key samples of many batches into one sample of about num_samples keys. Every batch gets a share of the merged
+// sample proportional to its rows, which are given in num_rows, so the merged sample represents the sum of num_rows.
+	std::unique_ptr<BlazingTable> mergeKeySamples(const std::vector<BlazingTableView> & samples,
+		const std::vector<int64_t> & num_rows, std::size_t num_samples);
+
+// Merges the key counts of all the nodes and returns the keys whose share of total_rows is above threshold / num_nodes,
+// together with the biggest share found, which is what gets reported in the query log.
+	std::pair<std::unique_ptr<BlazingTable>, double> selectHeavyHitters(const std::vector<BlazingTableView> & key_counts,
+		int64_t total_rows, int num_nodes, double threshold);
+
+// Collective operation, every node of the context must call it. The nodes send their key counts to the master,
+// the master selects the heavy hitters and broadcasts them. It returns a single column table with the heavy hitter keys,
+// which is empty if there is no skew.
+	std::unique_ptr<BlazingTable> determineHeavyHitters(Context * context, const BlazingTableView & table,
+		cudf::size_type key_index, double threshold, std::size_t num_samples = DEFAULT_HEAVY_HITTER_NUM_SAMPLES);
+
+// Like determineHeavyHitters, but for a single column sample of keys that represents num_rows rows of this node,
+// e.g. the merged samples of the batches that the node buffered.
+	std::unique_ptr<BlazingTable> determineHeavyHittersFromSample(Context * context, const BlazingTableView & key_sample,
+		int64_t num_rows, double threshold);
+
+// Returns the keys that appear in every one of the tables, up to max_keys of them. This is used on pre-aggregated batches,
+// where each key appears at most once per batch, so a key that keeps showing up is one whose partial results are worth
+// merging locally before sending them.
+	std::unique_ptr<BlazingTable> findRecurringKeys(const std::vector<BlazingTableView> & tables, cudf::size_type key_index,
+		std::size_t max_keys);
+
+// The distinct non null keys of the single column tables, up to max_keys of them.
+	std::unique_ptr<BlazingTable> unionKeys(const std::vector<BlazingTableView> & keys, std::size_t max_keys);
+
+// Splits the table into the rows whose key is one of the heavy hitters and the rest of them, in that order.
+// Rows with a null key are never heavy hitters. The keys are cast to the type of the key column of the table if they differ.
+	std::pair<std::unique_ptr<BlazingTable>, std::unique_ptr<BlazingTable>> splitHeavyHitterRows(const BlazingTableView & table,
+		cudf::size_type key_index, const BlazingTableView & heavy_hitter_keys);
+
+// Splits the table into num_partitions contiguous slices of about the same number of rows.
+// IMPORTANT: The TableViews returned point to the same data that was input.
+	std::vector<CudfTableView> splitEvenly(const CudfTableView & table, int num_partitions);
+
+}  // namespace distribution
+}  // namespace ral
@@ -9,6 +9,7 @@
 #include "communication/CommunicationData.h"
 #include "operators/GroupBy.h"
 #include "distribution/primitives.h"
+#include "distribution/skew.h"
 #include "utilities/DebuggingUtils.h"
 #include <cudf/partitioning.hpp>
 #include "CodeTimer.h"
@@ -23,9 +24,11 @@ using namespace fmt::literals;
 
 class ComputeAggregateKernel : public kernel {
 public:
-	ComputeAggregateKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	ComputeAggregateKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context} {
         this->query_graph = query_graph;
+        std::tie(this->group_column_indices, this->aggregation_input_expressions, this->aggregation_types,
+            this->aggregation_column_assigned_aliases) = ral::operators::parseGroupByExpression(plan);
 	}
 
     bool can_you_throttle_my_input() {
@@ -35,9 +38,64 @@ public:
 	virtual kstatus run() {
 		CodeTimer timer;
 
-        std::vector<std::string> aggregation_input_expressions, aggregation_column_assigned_aliases;
-        std::tie(this->group_column_indices, aggregation_input_expressions, this->aggregation_types, 
-            aggregation_column_assigned_aliases) = ral::operators::parseGroupByExpression(this->expression);
+        std::size_t merge_bytes_threshold = DEFAULT_MERGE_BYTES_THRESHOLD;
+        std::size_t state_max_bytes = DEFAULT_STATE_MAX_BYTES;
+        double bypass_ratio = DEFAULT_BYPASS_RATIO;
+        std::map<std::string, std::string> config_options = context->getConfigOptions();
+        auto it = config_options.find("AGGREGATION_MERGE_BYTES_THRESHOLD");
+        if (it != config_options.end()){
+            merge_bytes_threshold = std::stoull(config_options["AGGREGATION_MERGE_BYTES_THRESHOLD"]);
+        }
+        it = config_options.find("AGGREGATION_STATE_MAX_BYTES");
+        if (it != config_options.end()){
+            state_max_bytes = std::stoull(config_options["AGGREGATION_STATE_MAX_BYTES"]);
+        }
+        it = config_options.find("AGGREGATION_BYPASS_RATIO");
+        if (it != config_options.end()){
+            bypass_ratio = std::stod(config_options["AGGREGATION_BYPASS_RATIO"]);
+        }
+
+        // The partial results of the batches are folded together while the input streams in, so that what is sent to the
+        // merge phase is a running state with one row per group instead of one row per group per batch.
+        // When the keys barely repeat the folds do not reduce anything, so they are stopped and the partial results of
+        // the batches that are left go out as they are.
+        std::vector<std::unique_ptr<ral::frame::BlazingTable>> pending_partials;
+        std::size_t pending_bytes = 0;
+        std::size_t pending_rows = 0;
+        bool bypass = false;
+        int num_folds = 0;
+        int num_spilled_states = 0;
+        std::size_t rows_folded = 0;
+        std::size_t rows_after_folds = 0;
+
+        auto fold_pending_partials = [&]() {
+            std::vector<ral::frame::BlazingTableView> partials_views;
+            for (auto & partial : pending_partials) {
+                partials_views.push_back(partial->toBlazingTableView());
+            }
+            std::unique_ptr<ral::frame::BlazingTable> state = ral::operators::merge_partial_aggregations(
+                partials_views, this->group_column_indices, this->aggregation_types);
+            num_folds++;
+            rows_folded += pending_rows;
+            rows_after_folds += state->num_rows();
+            if (pending_rows > 0 && (double)state->num_rows() / (double)pending_rows > bypass_ratio) {
+                bypass = true;
+            }
+            pending_partials.clear();
+            pending_bytes = 0;
+            pending_rows = 0;
+            if (bypass || state->sizeInBytes() > state_max_bytes) {
+                // the output cache moves the state to host or disk if it does not fit in the GPU, the merge phase folds it with the rest
+                if (!bypass) {
+                    num_spilled_states++;
+                }
+                this->add_to_output_cache(std::move(state));
+            } else {
+                pending_bytes = state->sizeInBytes();
+                pending_rows = state->num_rows();
+                pending_partials.push_back(std::move(state));
+            }
+        };
 
 		BatchSequence input(this->input_cache(), this);
         int batch_count = 0;
@@ -57,11 +115,21 @@ public:
                     output = ral::operators::compute_aggregations_with_groupby(
                         batch->toBlazingTableView(), aggregation_input_expressions, this->aggregation_types, aggregation_column_assigned_aliases, group_column_indices);
                 }
-                
-                this->add_to_output_cache(std::move(output));
+
+                if (bypass) {
+                    this->add_to_output_cache(std::move(output));
+                } else {
+                    pending_bytes += output->sizeInBytes();
+                    pending_rows += output->num_rows();
+                    pending_partials.push_back(std::move(output));
+                    if (pending_partials.size() > 1 && pending_bytes > merge_bytes_threshold) {
+                        fold_pending_partials();
+                    }
+                }
                 batch_count++;
             } catch(const std::exception& e) {
                 // TODO add retry here
+                // a fold that fails leaves the pending partial results as they were, so only this batch is lost
                 logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
                             "query_id"_a=context->getContextToken(),
                             "step"_a=context->getQueryStep(),
@@ -71,11 +139,36 @@ public:
             }
 		}
 
+        try {
+            if (pending_partials.size() > 1) {
+                fold_pending_partials();
+            }
+            for (auto & partial : pending_partials) {
+                this->add_to_output_cache(std::move(partial));
+            }
+            pending_partials.clear();
+        } catch(const std::exception& e) {
+            logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+                        "query_id"_a=context->getContextToken(),
+                        "step"_a=context->getQueryStep(),
+                        "substep"_a=context->getQuerySubstep(),
+                        "info"_a="In ComputeAggregate kernel folding partial results for {}. What: {}"_format(expression, e.what()),
+                        "duration"_a="");
+            // the merge phase folds the partial results anyway, so the ones that could not be folded here go out as they are
+            for (auto & partial : pending_partials) {
+                if (partial != nullptr) {
+                    this->add_to_output_cache(std::move(partial));
+                }
+            }
+            pending_partials.clear();
+        }
+
         logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
                     "query_id"_a=context->getContextToken(),
                     "step"_a=context->getQueryStep(),
                     "substep"_a=context->getQuerySubstep(),
-                    "info"_a="ComputeAggregate Kernel Completed",
+                    "info"_a="ComputeAggregate Kernel Completed. batches: {} folds: {} rows_folded: {} rows_after_folds: {} spilled_states: {} bypassed: {}"_format(
+                        batch_count, num_folds, rows_folded, rows_after_folds, num_spilled_states, bypass),
                     "duration"_a=timer.elapsed_time(),
                     "kernel_id"_a=this->get_id());
 
@@ -102,15 +195,26 @@ public:
     }
 
 private:
-    std::vector<AggregateKind> aggregation_types;
+    // bytes of partial results that are accumulated before folding them together
+    static const std::size_t DEFAULT_MERGE_BYTES_THRESHOLD = 100000000;
+    // a running state bigger than this is sent to the output, which can spill it, and a new one is started
+    static const std::size_t DEFAULT_STATE_MAX_BYTES = 400000000;
+    // folds that keep more than this fraction of their input rows are not worth it, the rest of the batches are not folded
+    static constexpr double DEFAULT_BYPASS_RATIO = 0.8;
+
     std::vector<int> group_column_indices;
+    std::vector<std::string> aggregation_input_expressions;
+    std::vector<AggregateKind> aggregation_types;
+    std::vector<std::string> aggregation_column_assigned_aliases;
 };
 
 class DistributeAggregateKernel : public kernel {
 public:
-	DistributeAggregateKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	DistributeAggregateKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context} {
         this->query_graph = query_graph;
+        std::tie(this->group_column_indices, this->aggregation_input_expressions, this->aggregation_types,
+            this->aggregation_column_assigned_aliases) = ral::operators::parseGroupByExpression(plan);
 	}
 
     bool can_you_throttle_my_input() {
@@ -122,22 +226,72 @@ public:
         
         CodeTimer timer;
 		
-        std::vector<int> group_column_indices;
-        std::vector<std::string> aggregation_input_expressions, aggregation_column_assigned_aliases; // not used in this kernel
-        std::vector<AggregateKind> aggregation_types; // not used in this kernel
-        std::tie(group_column_indices, aggregation_input_expressions, aggregation_types, 
-            aggregation_column_assigned_aliases) = ral::operators::parseGroupByExpression(this->expression);
-
         std::vector<cudf::size_type> columns_to_hash;
         std::transform(group_column_indices.begin(), group_column_indices.end(), std::back_inserter(columns_to_hash), [](int index) { return (cudf::size_type)index; });
         
 
-        BlazingThread producer_thread([this, group_column_indices, columns_to_hash](){
+        BlazingThread producer_thread(ral::utilities::with_trace_query([this, columns_to_hash](){
             // num_partitions = context->getTotalNodes() will do for now, but may want a function to determine this in the future. 
             // If we do partition into something other than the number of nodes, then we have to use part_ids and change up more of the logic
             int num_partitions = this->context->getTotalNodes(); 
             bool set_empty_part_for_non_master_node = false; // this is only for aggregation without group by
 
+            auto hash_partition_and_distribute = [this, num_partitions, &columns_to_hash](std::unique_ptr<ral::frame::BlazingTable> batch) {
+                CudfTableView batch_view = batch->view();
+                std::vector<CudfTableView> partitioned;
+                std::unique_ptr<CudfTable> hashed_data; // Keep table alive in this scope
+                if (batch_view.num_rows() > 0) {
+                    std::vector<cudf::size_type> hased_data_offsets;
+                    std::tie(hashed_data, hased_data_offsets) = cudf::experimental::hash_partition(batch->view(), columns_to_hash, num_partitions);
+                    // the offsets returned by hash_partition will always start at 0, which is a value we want to ignore for cudf::split
+                    std::vector<cudf::size_type> split_indexes(hased_data_offsets.begin() + 1, hased_data_offsets.end());
+                    partitioned = cudf::experimental::split(hashed_data->view(), split_indexes);
+                } else {
+                    //  copy empty view
+                    for (auto i = 0; i < num_partitions; i++) {
+                        partitioned.push_back(batch_view);
+                    }
+                }
+
+                std::vector<ral::distribution::NodeColumnView > partitions_to_send;
+                for(int nodeIndex = 0; nodeIndex < this->context->getTotalNodes(); nodeIndex++ ){
+                    ral::frame::BlazingTableView partition_table_view = ral::frame::BlazingTableView(partitioned[nodeIndex], batch->names());
+                    if (this->context->getNode(nodeIndex) == ral::communication::CommunicationData::getInstance().getSelfNode()){
+                        // hash_partition followed by split does not create a partition that we can own, so we need to clone it.
+                        // if we dont clone it, hashed_data will go out of scope before we get to use the partition
+                        // also we need a BlazingTable to put into the cache, we cant cache views.
+                        std::unique_ptr<ral::frame::BlazingTable> partition_table_clone = partition_table_view.clone();
+                        this->add_to_output_cache(std::move(partition_table_clone));
+                    } else {
+                        partitions_to_send.emplace_back(
+                            std::make_pair(this->context->getNode(nodeIndex), partition_table_view));
+                    }
+                }
+                ral::distribution::distributeTablePartitions(this->context.get(), partitions_to_send);
+            };
+
+            // The input is already aggregated batch by batch, so a hot key costs its node one row per batch of every node.
+            // The partial results of the keys that keep showing up are merged here and sent once at the end instead.
+            bool merge_heavy_hitters = group_column_indices.size() == 1 && num_partitions > 1 &&
+                ral::distribution::getHeavyHitterThreshold(this->context.get()) > 0;
+            std::vector<std::unique_ptr<ral::frame::BlazingTable>> detection_batches;
+            std::unique_ptr<ral::frame::BlazingTable> heavy_hitter_keys;
+            std::vector<std::unique_ptr<ral::frame::BlazingTable>> heavy_hitter_partials;
+            std::size_t heavy_hitter_partials_rows = 0;
+            std::size_t heavy_hitter_input_rows = 0;
+
+            auto merge_heavy_hitter_partials = [this, &heavy_hitter_partials, &heavy_hitter_partials_rows]() {
+                std::vector<ral::frame::BlazingTableView> partials_views;
+                for (auto & partial : heavy_hitter_partials) {
+                    partials_views.push_back(partial->toBlazingTableView());
+                }
+                std::unique_ptr<ral::frame::BlazingTable> merged = ral::operators::merge_partial_aggregations(
+                    partials_views, group_column_indices, aggregation_types);
+                heavy_hitter_partials.clear();
+                heavy_hitter_partials_rows = merged->num_rows();
+                heavy_hitter_partials.push_back(std::move(merged));
+            };
+
             BatchSequence input(this->input_cache(), this);
             int batch_count = 0;
             while (input.wait_for_next()) {
@@ -162,37 +316,44 @@ public:
                             ral::distribution::distributeTablePartitions(this->context.get(), selfPartition);
                         }
                     } else {
-                        CudfTableView batch_view = batch->view();
-                        std::vector<CudfTableView> partitioned;
-                        std::unique_ptr<CudfTable> hashed_data; // Keep table alive in this scope
-                        if (batch_view.num_rows() > 0) {
-                            std::vector<cudf::size_type> hased_data_offsets;
-                            std::tie(hashed_data, hased_data_offsets) = cudf::experimental::hash_partition(batch->view(), columns_to_hash, num_partitions);
-                            // the offsets returned by hash_partition will always start at 0, which is a value we want to ignore for cudf::split
-                            std::vector<cudf::size_type> split_indexes(hased_data_offsets.begin() + 1, hased_data_offsets.end());
-                            partitioned = cudf::experimental::split(hashed_data->view(), split_indexes);
-                        } else {
-                            //  copy empty view
-                            for (auto i = 0; i < num_partitions; i++) {
-                                partitioned.push_back(batch_view);
+                        // the keys are looked for in every window of HEAVY_HITTER_DETECTION_BATCHES batches of the whole input, not
+                        // only in the first one, since a key can get hot later. The detection is local, so the nodes do not have to agree
+                        bool looking_for_heavy_hitters = merge_heavy_hitters &&
+                            (heavy_hitter_keys == nullptr || heavy_hitter_keys->num_rows() < MAX_MERGED_HEAVY_HITTERS);
+                        if (looking_for_heavy_hitters && batch->num_rows() > 0) {
+                            ral::frame::BlazingTableView keys_view(batch->view().select({group_column_indices[0]}), {batch->names()[group_column_indices[0]]});
+                            detection_batches.push_back(keys_view.clone());
+                            if (detection_batches.size() == HEAVY_HITTER_DETECTION_BATCHES) {
+                                std::vector<ral::frame::BlazingTableView> detection_views;
+                                for (auto & detection_batch : detection_batches) {
+                                    detection_views.push_back(detection_batch->toBlazingTableView());
+                                }
+                                std::unique_ptr<ral::frame::BlazingTable> recurring_keys =
+                                    ral::distribution::findRecurringKeys(detection_views, 0, MAX_MERGED_HEAVY_HITTERS);
+                                detection_batches.clear();
+                                if (heavy_hitter_keys == nullptr) {
+                                    heavy_hitter_keys = std::move(recurring_keys);
+                                } else if (recurring_keys->num_rows() > 0) {
+                                    heavy_hitter_keys = ral::distribution::unionKeys(
+                                        {heavy_hitter_keys->toBlazingTableView(), recurring_keys->toBlazingTableView()}, MAX_MERGED_HEAVY_HITTERS);
+                                }
                             }
                         }
 
-                        std::vector<ral::distribution::NodeColumnView > partitions_to_send;
-                        for(int nodeIndex = 0; nodeIndex < this->context->getTotalNodes(); nodeIndex++ ){
-                            ral::frame::BlazingTableView partition_table_view = ral::frame::BlazingTableView(partitioned[nodeIndex], batch->names());
-                            if (this->context->getNode(nodeIndex) == ral::communication::CommunicationData::getInstance().getSelfNode()){
-                                // hash_partition followed by split does not create a partition that we can own, so we need to clone it.
-                                // if we dont clone it, hashed_data will go out of scope before we get to use the partition
-                                // also we need a BlazingTable to put into the cache, we cant cache views.
-                                std::unique_ptr<ral::frame::BlazingTable> partition_table_clone = partition_table_view.clone();
-                                this->add_to_output_cache(std::move(partition_table_clone));
-                            } else {
-                                partitions_to_send.emplace_back(
-                                    std::make_pair(this->context->getNode(nodeIndex), partition_table_view));
+                        if (merge_heavy_hitters && heavy_hitter_keys != nullptr && heavy_hitter_keys->num_rows() > 0 && batch->num_rows() > 0) {
+                            std::unique_ptr<ral::frame::BlazingTable> heavy_hitter_rows;
+                            std::tie(heavy_hitter_rows, batch) = ral::distribution::splitHeavyHitterRows(
+                                batch->toBlazingTableView(), group_column_indices[0], heavy_hitter_keys->toBlazingTableView());
+                            heavy_hitter_input_rows += heavy_hitter_rows->num_rows();
+                            heavy_hitter_partials_rows += heavy_hitter_rows->num_rows();
+                            heavy_hitter_partials.push_back(std::move(heavy_hitter_rows));
+                            // the merged state has at most one row per heavy hitter, this keeps the pending partials bounded
+                            if (heavy_hitter_partials_rows > 2 * MAX_MERGED_HEAVY_HITTERS) {
+                                merge_heavy_hitter_partials();
                             }
                         }
-                        ral::distribution::distributeTablePartitions(this->context.get(), partitions_to_send);			
+
+                        hash_partition_and_distribute(std::move(batch));
                     }
                     batch_count++;
                 } catch(const std::exception& e) {
@@ -206,14 +367,38 @@ public:
                 }
             }
 
+            if (heavy_hitter_partials.size() > 0) {
+                try {
+                    merge_heavy_hitter_partials();
+                    std::size_t merged_rows = heavy_hitter_partials_rows;
+                    hash_partition_and_distribute(std::move(heavy_hitter_partials.back()));
+
+                    this->logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+                                        "query_id"_a=context->getContextToken(),
+                                        "step"_a=context->getQueryStep(),
+                                        "substep"_a=context->getQuerySubstep(),
+                                        "info"_a="DistributeAggregate merged heavy hitters locally. heavy_hitter_keys: {} partial_rows: {} sent_rows: {}"_format(
+                                            heavy_hitter_keys->num_rows(), heavy_hitter_input_rows, merged_rows),
+                                        "duration"_a="",
+                                        "kernel_id"_a=this->get_id());
+                } catch(const std::exception& e) {
+                    this->logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+                                        "query_id"_a=context->getContextToken(),
+                                        "step"_a=context->getQueryStep(),
+                                        "substep"_a=context->getQuerySubstep(),
+                                        "info"_a="In DistributeAggregate kernel merging heavy hitters for {}. What: {}"_format(expression, e.what()),
+                                        "duration"_a="");
+                }
+            }
+
             if (!(group_column_indices.size() == 0
                 && this->context->isMasterNode(ral::communication::CommunicationData::getInstance().getSelfNode()))) {
                 // Aggregations without groupby does not send distributeTablePartitions
                 ral::distribution::notifyLastTablePartitions(this->context.get(), ColumnDataPartitionMessage::MessageID());
             }
-        });
+        }));
         
-        BlazingThread consumer_thread([this, group_column_indices](){
+        BlazingThread consumer_thread(ral::utilities::with_trace_query([this](){
             // Lets put the server listener to feed the output, but not if its aggregations without group by and its not the master
             if(group_column_indices.size() > 0 || 
                         this->context->isMasterNode(ral::communication::CommunicationData::getInstance().getSelfNode())) {
@@ -223,7 +408,7 @@ public:
                     this->add_to_output_cache(std::move(host_table));
                 }
             }
-        });
+        }));
         producer_thread.join();
         consumer_thread.join();
         
@@ -239,15 +424,24 @@ public:
 	}
 
 private:
+    // number of batches of each window whose keys are looked at to find the keys that show up in every batch of the window
+    static const std::size_t HEAVY_HITTER_DETECTION_BATCHES = 4;
+    static const std::size_t MAX_MERGED_HEAVY_HITTERS = 10000;
 
+    std::vector<int> group_column_indices;
+    std::vector<std::string> aggregation_input_expressions;
+    std::vector<AggregateKind> aggregation_types;
+    std::vector<std::string> aggregation_column_assigned_aliases;
 };
 
 
 class MergeAggregateKernel : public kernel {
 public:
-	MergeAggregateKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	MergeAggregateKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context} {
         this->query_graph = query_graph;
+        std::tie(this->group_column_indices, this->aggregation_input_expressions, this->aggregation_types,
+            this->aggregation_column_assigned_aliases) = ral::operators::parseGroupByExpression(plan);
 	}
 
     bool can_you_throttle_my_input() {
@@ -257,56 +451,59 @@ public:
 	virtual kstatus run() {
         CodeTimer timer;
 
-        std::vector<std::unique_ptr<ral::frame::BlazingTable>> tablesToConcat;
-		std::vector<ral::frame::BlazingTableView> tableViewsToConcat;
+        std::size_t merge_bytes_threshold = DEFAULT_MERGE_BYTES_THRESHOLD;
+        std::map<std::string, std::string> config_options = context->getConfigOptions();
+        auto it = config_options.find("AGGREGATION_MERGE_BYTES_THRESHOLD");
+        if (it != config_options.end()){
+            merge_bytes_threshold = std::stoull(config_options["AGGREGATION_MERGE_BYTES_THRESHOLD"]);
+        }
 
-        // This Kernel needs all of the input before it can do any output. So lets wait until all the input is available
-        this->input_cache()->wait_until_finished();
+        // aggregations without groupby are only merged on the master node
+        bool merge_output = aggregation_types.size() == 0 || group_column_indices.size() > 0 ||
+            context->isMasterNode(ral::communication::CommunicationData::getInstance().getSelfNode());
+
+        // The partial results are folded as they arrive instead of waiting for all of them, so that the input does not
+        // pile up and most of the merging overlaps with the kernels that produce it
+        std::vector<std::unique_ptr<ral::frame::BlazingTable>> tablesToConcat;
+        std::size_t pending_bytes = 0;
+        auto fold_partials = [&]() {
+            std::vector<ral::frame::BlazingTableView> tableViewsToConcat;
+            for (auto & table : tablesToConcat) {
+                tableViewsToConcat.emplace_back(table->toBlazingTableView());
+            }
+            std::unique_ptr<ral::frame::BlazingTable> merged = ral::operators::merge_partial_aggregations(
+                tableViewsToConcat, group_column_indices, aggregation_types);
+            tablesToConcat.clear();
+            pending_bytes = merged->sizeInBytes();
+            tablesToConcat.emplace_back(std::move(merged));
+        };
 
         BatchSequence input(this->input_cache(), this);
         int batch_count=0;
+        int num_folds=0;
         try {
             while (input.wait_for_next()) {
                 auto batch = input.next();
-                // std::cout<<"MergeAggregateKernel batch "<<batch_count<<std::endl;
-                // ral::utilities::print_blazing_table_view_schema(batch->toBlazingTableView(), "MergeAggregateKernel_batch" + std::to_string(batch_count));
                 batch_count++;
-                tableViewsToConcat.emplace_back(batch->toBlazingTableView());
+                pending_bytes += batch->sizeInBytes();
                 tablesToConcat.emplace_back(std::move(batch));
+                if (merge_output && tablesToConcat.size() > 1 && pending_bytes > merge_bytes_threshold) {
+                    fold_partials();
+                    num_folds++;
+                }
             }
-            auto concatenated = ral::utilities::concatTables(tableViewsToConcat);
-                    
-            std::vector<int> group_column_indices;
-            std::vector<std::string> aggregation_input_expressions, aggregation_column_assigned_aliases;
-            std::vector<AggregateKind> aggregation_types;
-            std::tie(group_column_indices, aggregation_input_expressions, aggregation_types, 
-                aggregation_column_assigned_aliases) = ral::operators::parseGroupByExpression(this->expression);
-
-            std::vector<int> mod_group_column_indices;
-            std::vector<std::string> mod_aggregation_input_expressions, mod_aggregation_column_assigned_aliases, merging_column_names;
-            std::vector<AggregateKind> mod_aggregation_types;
-            std::tie(mod_group_column_indices, mod_aggregation_input_expressions, mod_aggregation_types, 
-                mod_aggregation_column_assigned_aliases) = ral::operators::modGroupByParametersForMerge(
-                group_column_indices, aggregation_types, concatenated->names());
 
             std::unique_ptr<ral::frame::BlazingTable> output;
-            if(aggregation_types.size() == 0) {
-                output = ral::operators::compute_groupby_without_aggregations(
-                        concatenated->toBlazingTableView(), mod_group_column_indices);
-            } else if (group_column_indices.size() == 0) {
-                // aggregations without groupby are only merged on the master node
-                if(context->isMasterNode(ral::communication::CommunicationData::getInstance().getSelfNode())) {
-                    output = ral::operators::compute_aggregations_without_groupby(
-                            concatenated->toBlazingTableView(), mod_aggregation_input_expressions, mod_aggregation_types, 
-                            mod_aggregation_column_assigned_aliases);
-                } else {
-                    // with aggregations without groupby the distribution phase should deposit an empty dataframe with the right schema into the cache, which is then output here
-                    output = std::move(concatenated);
-                }
+            if (merge_output) {
+                fold_partials();
+                output = std::move(tablesToConcat.back());
             } else {
-                output = ral::operators::compute_aggregations_with_groupby(
-                        concatenated->toBlazingTableView(), mod_aggregation_input_expressions, mod_aggregation_types,
-                        mod_aggregation_column_assigned_aliases, mod_group_column_indices);
+                // with aggregations without groupby the distribution phase should deposit an empty dataframe with the right schema into the cache, which is then output here
+                std::vector<ral::frame::BlazingTableView> tableViewsToConcat;
+                for (auto & table : tablesToConcat) {
+                    tableViewsToConcat.emplace_back(table->toBlazingTableView());
+                }
+                output = ral::utilities::concatTables(tableViewsToConcat);
             }
             // ral::utilities::print_blazing_table_view_schema(output->toBlazingTableView(), "MergeAggregateKernel_output");
             this->add_to_output_cache(std::move(output));
@@ -325,7 +522,7 @@ public:
                     "query_id"_a=context->getContextToken(),
                     "step"_a=context->getQueryStep(),
                     "substep"_a=context->getQuerySubstep(),
-                    "info"_a="MergeAggregate Kernel Completed",
+                    "info"_a="MergeAggregate Kernel Completed. batches: {} folds: {}"_format(batch_count, num_folds),
                     "duration"_a=timer.elapsed_time(),
                     "kernel_id"_a=this->get_id());
 
@@ -338,7 +535,12 @@ public:
     }
 
 private:
+    static const std::size_t DEFAULT_MERGE_BYTES_THRESHOLD = 100000000;
 
+    std::vector<int> group_column_indices;
+    std::vector<std::string> aggregation_input_expressions;
+    std::vector<AggregateKind> aggregation_types;
+    std::vector<std::string> aggregation_column_assigned_aliases;
 };
 
 
@@ -10,6 +10,9 @@
 #include "parser/expression_utils.hpp"
 #include "execution_graph/logic_controllers/LogicalFilter.h"
 #include "distribution/primitives.h"
+#include "distribution/broadcast_join.h"
+#include "distribution/skew.h"
+#include "RuntimeFilter.h"
 #include "Utils.cuh"
 #include "blazingdb/concurrency/BlazingThread.h"
 #include "CodeTimer.h"
@@ -29,6 +32,19 @@ const std::string LEFT_JOIN = "left";
 const std::string RIGHT_JOIN = "right";
 const std::string OUTER_JOIN = "full";
 
+// Splits the condition of the join into the equalities that the join is done on and the rest of it, which filters the joined rows
+inline void split_join_condition(const ral::parser::plan_node & join, std::string & join_condition, std::string & filter_condition) {
+	if (!join.left_join_keys.empty()) {
+		// the plan already found that the condition is only made of equalities
+		join_condition = join.condition;
+		filter_condition = "";
+		return;
+	}
+	std::string condition = join.condition;
+	StringUtil::findAndReplaceAll(condition, "IS NOT DISTINCT FROM", "=");
+	split_inequality_join_condition(condition, join_condition, filter_condition);
+}
+
 struct TableSchema {
 	std::vector<cudf::data_type> column_types;
 	std::vector<std::string> column_names;
@@ -39,11 +55,19 @@ struct TableSchema {
 
 class PartwiseJoin : public kernel {
 public:
-	PartwiseJoin(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context}, left_sequence{nullptr, this}, right_sequence{nullptr, this} {
+	PartwiseJoin(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, left_sequence{nullptr, this}, right_sequence{nullptr, this} {
 		this->query_graph = query_graph;
 		this->input_.add_port("input_a", "input_b");
 
+		std::string filter_condition;
+		split_join_condition(plan, this->condition, filter_condition);
+		this->join_type = plan.join_type;
+		if (!filter_condition.empty()) {
+			// the part of the condition that is not equalities filters every joined batch
+			this->filter_program = std::make_unique<ral::processor::expression_program>(std::vector<std::string>{filter_condition});
+		}
+
 		join_partition_size_theshold = 400000000; // Threshold for how big to try to make each partition for joining
 		std::map<std::string, std::string> config_options = context->getConfigOptions();
 		auto it = config_options.find("JOIN_PARTITION_SIZE_THRESHOLD");
@@ -260,13 +284,6 @@ public:
 		this->left_sequence = BatchSequence(this->input_.get_cache("input_a"), this);
 		this->right_sequence = BatchSequence(this->input_.get_cache("input_b"), this);
 
-		// lets parse part of the expression here, because we need the joinType before we load
-		std::string new_join_statement, filter_statement;
-		StringUtil::findAndReplaceAll(this->expression, "IS NOT DISTINCT FROM", "=");
-		split_inequality_join_into_join_and_filter(this->expression, new_join_statement, filter_statement);
-		std::string condition = get_named_expression(new_join_statement, "condition");
-		this->join_type = get_named_expression(new_join_statement, "joinType");
-
 		std::unique_ptr<ral::frame::BlazingTable> left_batch = nullptr;
 		std::unique_ptr<ral::frame::BlazingTable> right_batch = nullptr;
 		bool done = false;
@@ -285,7 +302,7 @@ public:
 
 					{ // parsing more of the expression here because we need to have the number of columns of the tables
 						std::vector<int> column_indices;
-						ral::processor::parseJoinConditionToColumnIndices(condition, column_indices);
+						ral::processor::parseJoinConditionToColumnIndices(this->condition, column_indices);
 						for(int i = 0; i < column_indices.size();i++){
 							if(column_indices[i] >= left_batch->num_columns()){
 								this->right_column_indices.push_back(column_indices[i] - left_batch->num_columns());
@@ -354,8 +371,8 @@ public:
 					std::unique_ptr<ral::frame::BlazingTable> joined = join_set(left_batch->toBlazingTableView(), right_batch->toBlazingTableView());
 					
 					produced_output = true;
-					if (filter_statement != "") {
-						auto filter_table = ral::processor::process_filter(joined->toBlazingTableView(), filter_statement, this->context.get());					
+					if (this->filter_program) {
+						auto filter_table = ral::processor::process_filter(joined->toBlazingTableView(), *(this->filter_program));
 						this->add_to_output_cache(std::move(filter_table));
 					} else{
 						// printf("joined table\n");
@@ -410,32 +427,169 @@ private:
 	std::size_t join_partition_size_theshold;
 
 	// parsed expression related parameters
+	std::string condition;
 	std::string join_type;
+	std::unique_ptr<ral::processor::expression_program> filter_program;
 	std::vector<cudf::size_type> left_column_indices, right_column_indices;
 	std::vector<std::string> result_names;
 };
 
+/**
+ * One side of a join for JoinPartitionKernel: the batches that it pulled to pick the join strategy, followed by the rest
+ * of the side. The pulled batches wait in a cache machine, so that they are moved to host memory or to disk when the GPU
+ * is short of memory, like the batches waiting between any two kernels.
+ */
+class BufferedBatchSequence {
+public:
+	BufferedBatchSequence(BatchSequence sequence, std::shared_ptr<Context> context)
+		: sequence(std::move(sequence)), context(context) {
+		buffer = ral::cache::create_cache_machine(ral::cache::cache_settings{.type = ral::cache::CacheType::SIMPLE});
+	}
+
+	// Pulls the next batch of the side into the buffer, false if the side is finished
+	bool buffer_next() {
+		if (!sequence.wait_for_next()) {
+			return false;
+		}
+		add(sequence.next());
+		return true;
+	}
+
+	// From now on a sample of the keys of every buffered batch is kept, while the batch is still in GPU memory
+	void sample_keys(cudf::size_type key_index, std::size_t num_samples) {
+		this->key_index = key_index;
+		this->num_key_samples = num_samples;
+	}
+
+	void add(std::unique_ptr<ral::frame::BlazingTable> batch) {
+		if (batch == nullptr) {
+			return;
+		}
+		if (num_key_samples > 0 && batch->num_columns() > 0) {
+			key_samples.push_back(ral::distribution::sampleKeys(batch->toBlazingTableView(), key_index, num_key_samples));
+			key_sample_rows.push_back(batch->num_rows());
+		}
+		num_buffered_batches++;
+		num_buffered_rows += batch->num_rows();
+		num_buffered_bytes += ral::utilities::get_table_size_bytes(batch->toBlazingTableView());
+		buffer->addToCache(std::move(batch), "", context.get());
+	}
+
+	// Once the strategy is picked, next returns the buffered batches and then the rest of the side
+	void finish_buffering() {
+		buffer->finish();
+	}
+
+	int64_t get_num_buffered_batches() const { return num_buffered_batches; }
+	int64_t get_num_buffered_rows() const { return num_buffered_rows; }
+	int64_t get_num_buffered_bytes() const { return num_buffered_bytes; }
+
+	// The sample of the keys of all the buffered batches, where each batch has a share proportional to its rows, so it
+	// represents get_num_buffered_rows rows. Null if sample_keys was not called before buffering
+	std::unique_ptr<ral::frame::BlazingTable> get_key_sample() const {
+		if (key_samples.empty()) {
+			return nullptr;
+		}
+		std::vector<ral::frame::BlazingTableView> key_sample_views;
+		for (auto & key_sample : key_samples) {
+			key_sample_views.push_back(key_sample->toBlazingTableView());
+		}
+		return ral::distribution::mergeKeySamples(key_sample_views, key_sample_rows, num_key_samples);
+	}
+
+	bool wait_for_next() {
+		return buffer->wait_for_next() || sequence.wait_for_next();
+	}
+
+	std::unique_ptr<ral::frame::BlazingTable> next() {
+		if (buffer->wait_for_next()) {
+			return buffer->pullFromCache(context.get());
+		}
+		return sequence.next();
+	}
+
+	// The buffered batches as they are in the cache, for passing them through without bringing them back to the GPU
+	bool wait_for_next_buffered() {
+		return buffer->wait_for_next();
+	}
+
+	std::unique_ptr<ral::cache::CacheData> next_buffered() {
+		return buffer->pullCacheData(context.get());
+	}
+
+private:
+	BatchSequence sequence;
+	std::shared_ptr<Context> context;
+	std::shared_ptr<ral::cache::CacheMachine> buffer;
+	cudf::size_type key_index = 0;
+	std::size_t num_key_samples = 0;
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> key_samples;
+	std::vector<int64_t> key_sample_rows;
+	int64_t num_buffered_batches = 0;
+	int64_t num_buffered_rows = 0;
+	int64_t num_buffered_bytes = 0;
+};
 
 class JoinPartitionKernel : public kernel {
 public:
-	JoinPartitionKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	JoinPartitionKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context} {
 		this->query_graph = query_graph;
 		this->input_.add_port("input_a", "input_b");
 		this->output_.add_port("output_a", "output_b");
+
+		// the rows are distributed by the equalities of the condition, PartwiseJoin filters them by the rest of it
+		std::string filter_condition;
+		split_join_condition(plan, this->condition, filter_condition);
+		this->join_type = plan.join_type;
 	}
 
 	bool can_you_throttle_my_input() {
 		return true;
 	}
 
+	// Sends each partition to its node, partitions[i] goes to node i. The partition of this node goes straight into the output cache.
+	// Returns the bytes sent to the other nodes.
+	static int64_t distribute_partitions(std::shared_ptr<Context> local_context,
+				const std::vector<CudfTableView> & partitioned,
+				const std::vector<std::string> & names,
+				std::shared_ptr<ral::cache::CacheMachine> & output,
+				const std::string & message_id)
+	{
+		std::vector<ral::distribution::NodeColumnView > partitions_to_send;
+		int64_t bytes_sent = 0;
+		for(int nodeIndex = 0; nodeIndex < local_context->getTotalNodes(); nodeIndex++ ){
+			ral::frame::BlazingTableView partition_table_view = ral::frame::BlazingTableView(partitioned[nodeIndex], names);
+			if (local_context->getNode(nodeIndex) == ral::communication::CommunicationData::getInstance().getSelfNode()){
+				// hash_partition followed by split does not create a partition that we can own, so we need to clone it.
+				// if we dont clone it, hashed_data will go out of scope before we get to use the partition
+				// also we need a BlazingTable to put into the cache, we cant cache views.
+				std::unique_ptr<ral::frame::BlazingTable> partition_table_clone = partition_table_view.clone();
+
+				// TODO: create message id and send to add add_to_output_cache
+				output->addToCache(std::move(partition_table_clone), message_id, local_context.get());
+			} else {
+				partitions_to_send.emplace_back(
+					std::make_pair(local_context->getNode(nodeIndex), partition_table_view));
+				bytes_sent += ral::utilities::get_table_size_bytes(partition_table_view);
+			}
+		}
+		ral::distribution::distributeTablePartitions(local_context.get(), partitions_to_send);
+		return bytes_sent;
+	}
+
+	// When heavy_hitter_keys is set, the rows with those keys do not go to the node that owns their hash.
+	// If replicate_heavy_hitters is true they are sent to every node, otherwise they are spread evenly across the nodes.
+	// The side with the skew is spread and the other side is replicated so that every pair of matching rows still meets on one node.
+	// The batches that were buffered to pick the join strategy go first, then the rest of the sequence.
 	static void partition_table(std::shared_ptr<Context> local_context,
 				std::vector<cudf::size_type> column_indices, 
-				std::unique_ptr<ral::frame::BlazingTable> batch, 
-				BatchSequence & sequence, 
+				BufferedBatchSequence & sequence, 
 				std::shared_ptr<ral::cache::CacheMachine> & output,
 				const std::string & message_id,
-				std::shared_ptr<spdlog::logger> logger)
+				std::shared_ptr<spdlog::logger> logger,
+				std::shared_ptr<ral::frame::BlazingTable> heavy_hitter_keys,
+				bool replicate_heavy_hitters)
 	{
 		using ColumnDataPartitionMessage = ral::communication::messages::ColumnDataPartitionMessage;
 
@@ -446,8 +600,28 @@ public:
 		std::unique_ptr<CudfTable> hashed_data;
 		std::vector<cudf::size_type> hased_data_offsets;
 		int batch_count = 0;
+		int64_t heavy_hitter_rows_count = 0;
+		int64_t bytes_sent = 0;
+		std::unique_ptr<ral::frame::BlazingTable> batch = sequence.next();
         while (!done) {		
             try {            
+				if (heavy_hitter_keys != nullptr && batch->num_rows() > 0) {
+					std::unique_ptr<ral::frame::BlazingTable> heavy_hitter_rows;
+					std::tie(heavy_hitter_rows, batch) = ral::distribution::splitHeavyHitterRows(
+						batch->toBlazingTableView(), column_indices[0], heavy_hitter_keys->toBlazingTableView());
+
+					if (heavy_hitter_rows->num_rows() > 0) {
+						std::vector<CudfTableView> heavy_hitter_partitions;
+						if (replicate_heavy_hitters) {
+							heavy_hitter_partitions.assign(num_partitions, heavy_hitter_rows->view());
+						} else {
+							heavy_hitter_partitions = ral::distribution::splitEvenly(heavy_hitter_rows->view(), num_partitions);
+						}
+						bytes_sent += distribute_partitions(local_context, heavy_hitter_partitions, heavy_hitter_rows->names(), output, message_id);
+						heavy_hitter_rows_count += heavy_hitter_rows->num_rows();
+					}
+				}
+
 				auto batch_view = batch->view();
 				std::vector<CudfTableView> partitioned;
 				if (batch->num_rows() > 0) {
@@ -463,27 +637,11 @@ public:
 						partitioned.push_back(batch_view);
 					}
 				}
-				std::vector<ral::distribution::NodeColumnView > partitions_to_send;
-				for(int nodeIndex = 0; nodeIndex < local_context->getTotalNodes(); nodeIndex++ ){
-					ral::frame::BlazingTableView partition_table_view = ral::frame::BlazingTableView(partitioned[nodeIndex], batch->names());
-					if (local_context->getNode(nodeIndex) == ral::communication::CommunicationData::getInstance().getSelfNode()){
-						// hash_partition followed by split does not create a partition that we can own, so we need to clone it.
-						// if we dont clone it, hashed_data will go out of scope before we get to use the partition
-						// also we need a BlazingTable to put into the cache, we cant cache views.
-						std::unique_ptr<ral::frame::BlazingTable> partition_table_clone = partition_table_view.clone();
-
-						// TODO: create message id and send to add add_to_output_cache
-						output->addToCache(std::move(partition_table_clone), message_id, local_context.get());
-					} else {
-						partitions_to_send.emplace_back(
-							std::make_pair(local_context->getNode(nodeIndex), partition_table_view));
-					}
-				}
-				ral::distribution::distributeTablePartitions(local_context.get(), partitions_to_send);
+				bytes_sent += distribute_partitions(local_context, partitioned, batch->names(), output, message_id);
 
+				batch_count++;
 				if (sequence.wait_for_next()){
 					batch = sequence.next();
-					batch_count++;
 				} else {
 					done = true;
 				}
@@ -502,135 +660,164 @@ public:
 				std::cout<<err<<std::endl;
 			}
         }
+		if (heavy_hitter_keys != nullptr) {
+			logger->debug("{query_id}|{step}|{substep}|{info}|{duration}||||",
+										"query_id"_a=local_context->getContextToken(),
+										"step"_a=local_context->getQueryStep(),
+										"substep"_a=local_context->getQuerySubstep(),
+										"info"_a="JoinPartition heavy hitter rows {}: {}"_format(replicate_heavy_hitters ? "replicated" : "spread", heavy_hitter_rows_count),
+										"duration"_a="");
+		}
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}||||",
+									"query_id"_a=local_context->getContextToken(),
+									"step"_a=local_context->getQueryStep(),
+									"substep"_a=local_context->getQuerySubstep(),
+									"info"_a="JoinPartition hash partitioned {} batches, bytes sent to other nodes: {}"_format(batch_count, bytes_sent),
+									"duration"_a="");
 		//printf("... notifyLastTablePartitions\n");
 		ral::distribution::notifyLastTablePartitions(local_context.get(), ColumnDataPartitionMessage::MessageID());
     }
 
-	std::pair<bool, bool> determine_if_we_are_scattering_a_small_table(const ral::frame::BlazingTableView & left_batch_view, 
-		const ral::frame::BlazingTableView & right_batch_view ){
-
-		std::pair<bool, uint64_t> left_num_rows_estimate = this->query_graph->get_estimated_input_rows_to_cache(this->kernel_id, "input_a");	
-		std::pair<bool, uint64_t> right_num_rows_estimate = this->query_graph->get_estimated_input_rows_to_cache(this->kernel_id, "input_b");	
-		double left_batch_rows = (double)left_batch_view.num_rows();
-		double left_batch_bytes = (double)ral::utilities::get_table_size_bytes(left_batch_view);
-		double right_batch_rows = (double)right_batch_view.num_rows();
-		double right_batch_bytes = (double)ral::utilities::get_table_size_bytes(right_batch_view);
-		int64_t left_bytes_estimate;
-		if (!left_num_rows_estimate.first || left_batch_bytes == 0){
-			// if we cant get a good estimate of current bytes, then we will set to -1 to signify that
-			left_bytes_estimate = -1;
-		} else {
-			left_bytes_estimate = (int64_t)(left_batch_bytes*(((double)left_num_rows_estimate.second)/left_batch_rows));
-		}
-		int64_t right_bytes_estimate;
-		if (!right_num_rows_estimate.first || right_batch_bytes == 0){
-			// if we cant get a good estimate of current bytes, then we will set to -1 to signify that
-			right_bytes_estimate = -1;
-		} else {
-			right_bytes_estimate = (int64_t)(right_batch_bytes*(((double)right_num_rows_estimate.second)/right_batch_rows));
+	// Looks for join keys that hold so much of the left table that the node owning their hash would become the tail of the query.
+	// Only single column keys are considered. The left side is the one that gets spread, the right side gets its heavy hitter rows replicated,
+	// that is why this is not done for joins that have to keep the unmatched rows of the right side.
+	// The detection is a collective operation, so whether it runs only depends on the config and the plan, which are the same on
+	// every node, and never on the batches a node happens to have.
+	bool is_heavy_hitter_detection_enabled() {
+		return ral::distribution::getHeavyHitterThreshold(this->context.get()) > 0 && this->context->getTotalNodes() > 1 &&
+			(this->join_type == INNER_JOIN || this->join_type == LEFT_JOIN) &&
+			this->left_column_indices.size() == 1 && this->right_column_indices.size() == 1;
+	}
+
+	// The keys are sampled across all the batches of the left side that were buffered to pick the join strategy, not only the
+	// first one, since a key can be hot in only part of the input.
+	std::shared_ptr<ral::frame::BlazingTable> determine_heavy_hitters(const BufferedBatchSequence & left_side) {
+		if (!is_heavy_hitter_detection_enabled()) {
+			return nullptr;
 		}
 
-		int self_node_idx = context->getNodeIndex(ral::communication::CommunicationData::getInstance().getSelfNode());
+		std::unique_ptr<ral::frame::BlazingTable> key_sample = left_side.get_key_sample();
+		std::unique_ptr<ral::frame::BlazingTable> heavy_hitter_keys = ral::distribution::determineHeavyHittersFromSample(
+			this->context.get(), key_sample->toBlazingTableView(), left_side.get_num_buffered_rows(),
+			ral::distribution::getHeavyHitterThreshold(this->context.get()));
+		if (heavy_hitter_keys->num_rows() == 0) {
+			return nullptr;
+		}
 
-		context->incrementQuerySubstep();
-		ral::distribution::distributeLeftRightTableSizeBytes(context.get(), left_bytes_estimate, right_bytes_estimate);
-		std::vector<int64_t> nodes_num_bytes_left;
-		std::vector<int64_t> nodes_num_bytes_right;
-		ral::distribution::collectLeftRightTableSizeBytes(context.get(), nodes_num_bytes_left, nodes_num_bytes_right);
-		nodes_num_bytes_left[self_node_idx] = left_bytes_estimate;
-		nodes_num_bytes_right[self_node_idx] = right_bytes_estimate;
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="JoinPartition skew detected, heavy hitter keys: {} sampled_batches: {}"_format(
+										heavy_hitter_keys->num_rows(), left_side.get_num_buffered_batches()),
+									"duration"_a="",
+									"kernel_id"_a=this->get_id());
+		return std::move(heavy_hitter_keys);
+	}
 
-		bool any_unknowns_left = std::any_of(nodes_num_bytes_left.begin(), nodes_num_bytes_left.end(), [](int64_t bytes){return bytes == -1;});
-		bool any_unknowns_right = std::any_of(nodes_num_bytes_right.begin(), nodes_num_bytes_right.end(), [](int64_t bytes){return bytes == -1;});
+	// The join condition has the indices of the columns of both tables as if they were concatenated, the left table first
+	void parse_join_column_indices(const std::string & condition, int left_num_columns) {
+		std::vector<int> column_indices;
+		ral::processor::parseJoinConditionToColumnIndices(condition, column_indices);
+		for(int i = 0; i < column_indices.size();i++){
+			if(column_indices[i] >= left_num_columns){
+				this->right_column_indices.push_back(column_indices[i] - left_num_columns);
+			}else{
+				this->left_column_indices.push_back(column_indices[i]);
+			}
+		}
+	}
 
-		if (any_unknowns_left || any_unknowns_right){
-			return std::make_pair(false, false); // we wont do any small table scatter if we have unknowns
+	// Pulls batches of one side of the join until more than buffer_bytes are buffered or the side is finished.
+	// When the side is not finished its bytes are extrapolated from all the buffered rows, and never less than what was buffered.
+	ral::distribution::JoinSideSize buffer_side(BufferedBatchSequence & side, const std::string & port_name, int64_t buffer_bytes) {
+		while (side.get_num_buffered_bytes() <= buffer_bytes) {
+			if (!side.buffer_next()) {
+				side.finish_buffering();
+				return ral::distribution::JoinSideSize{side.get_num_buffered_bytes(), true};
+			}
+		}
+		side.finish_buffering();
+
+		int64_t buffered_bytes = side.get_num_buffered_bytes();
+		int64_t buffered_rows = side.get_num_buffered_rows();
+		int64_t bytes_estimate = buffered_bytes;
+		std::pair<bool, uint64_t> num_rows_estimate = this->query_graph->get_estimated_input_rows_to_cache(this->kernel_id, port_name);
+		if (num_rows_estimate.first && buffered_rows > 0) {
+			bytes_estimate = std::max(bytes_estimate, (int64_t)(buffered_bytes * (((double)num_rows_estimate.second) / buffered_rows)));
 		}
+		return ral::distribution::JoinSideSize{bytes_estimate, false};
+	}
 
-		int64_t total_bytes_left = std::accumulate(nodes_num_bytes_left.begin(), nodes_num_bytes_left.end(), int64_t(0));
-		int64_t total_bytes_right = std::accumulate(nodes_num_bytes_right.begin(), nodes_num_bytes_right.end(), int64_t(0));
+	// Buffers both sides up to JOIN_SCATTER_DECISION_BUFFER_BYTES before deciding, so that a small side is usually seen whole
+	// and a big one is not judged by its first batch. The sizes of all the nodes are exchanged so that every node takes the same decision.
+	ral::distribution::SmallTableScatterDecision determine_if_we_are_scattering_a_small_table(
+		BufferedBatchSequence & left_side, BufferedBatchSequence & right_side,
+		ral::distribution::JoinSideSize & self_left_size, ral::distribution::JoinSideSize & self_right_size){
 
-		int num_nodes = context->getTotalNodes();
+		int64_t buffer_bytes = ral::distribution::getJoinScatterDecisionBufferBytes(this->context.get());
+		self_left_size = buffer_side(left_side, "input_a", buffer_bytes);
+		self_right_size = buffer_side(right_side, "input_b", buffer_bytes);
 
-		bool scatter_left = false;
-		bool scatter_right = false;
-		int64_t estimate_regular_distribution = (total_bytes_left + total_bytes_right) * (num_nodes - 1) / num_nodes;
-		int64_t estimate_scatter_left = (total_bytes_left) * (num_nodes - 1);
-		int64_t estimate_scatter_right = (total_bytes_right) * (num_nodes - 1);
-		
-		unsigned long long max_join_scatter_mem_overhead = 500000000;  // 500Mb  how much extra memory consumption per node are we ok with
-		std::map<std::string, std::string> config_options = context->getConfigOptions();
-		auto it = config_options.find("MAX_JOIN_SCATTER_MEM_OVERHEAD");
-		if (it != config_options.end()){
-			max_join_scatter_mem_overhead = std::stoull(config_options["MAX_JOIN_SCATTER_MEM_OVERHEAD"]);
-		}
+		std::vector<ral::distribution::JoinSideSize> nodes_left_size;
+		std::vector<ral::distribution::JoinSideSize> nodes_right_size;
+		ral::distribution::exchangeJoinSideSizes(this->context.get(), self_left_size, self_right_size, nodes_left_size, nodes_right_size);
 
-		if(estimate_scatter_left < estimate_regular_distribution ||
-			estimate_scatter_right < estimate_regular_distribution) {
-			if(estimate_scatter_left < estimate_scatter_right &&
-				total_bytes_left < max_join_scatter_mem_overhead) {
-				scatter_left = true;
-			} else if(estimate_scatter_right < estimate_scatter_left &&
-					total_bytes_right < max_join_scatter_mem_overhead) {
-				scatter_right = true;
-			}
-		}
-		return std::make_pair(scatter_left, scatter_right);
+		ral::distribution::SmallTableScatterDecision decision = ral::distribution::decideSmallTableScatter(
+			nodes_left_size, nodes_right_size, ral::distribution::getMaxJoinScatterMemOverhead(this->context.get()));
+
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="JoinPartition strategy decision. buffered_batches: {}/{} self_bytes: {}/{} self_complete: {}/{} total_bytes: {}/{} estimate_regular_distribution: {} estimate_scatter: {} scatter_left: {} scatter_right: {}"_format(
+										left_side.get_num_buffered_batches(), right_side.get_num_buffered_batches(), self_left_size.bytes, self_right_size.bytes,
+										self_left_size.complete, self_right_size.complete, decision.total_bytes_left, decision.total_bytes_right,
+										decision.estimate_regular_distribution, decision.estimate_scatter, decision.scatter_left, decision.scatter_right),
+									"duration"_a="",
+									"kernel_id"_a=this->get_id());
+		return decision;
 	}
 
-	void perform_standard_hash_partitioning(const std::string & condition, 
-		std::unique_ptr<ral::frame::BlazingTable> left_batch,
-		std::unique_ptr<ral::frame::BlazingTable> right_batch,
-		BatchSequence left_sequence,
-		BatchSequence right_sequence){
+	void perform_standard_hash_partitioning(BufferedBatchSequence & left_side, BufferedBatchSequence & right_side){
 		using ColumnDataPartitionMessage = ral::communication::messages::ColumnDataPartitionMessage;
 		
 		this->context->incrementQuerySubstep();
-				
-		{ // parsing more of the expression here because we need to have the number of columns of the tables
-			std::vector<int> column_indices;
-			ral::processor::parseJoinConditionToColumnIndices(condition, column_indices);
-			for(int i = 0; i < column_indices.size();i++){
-				if(column_indices[i] >= left_batch->num_columns()){
-					this->right_column_indices.push_back(column_indices[i] - left_batch->num_columns());
-				}else{
-					this->left_column_indices.push_back(column_indices[i]);
-				}
-			}
-		}
 
-		BlazingMutableThread distribute_left_thread(&JoinPartitionKernel::partition_table, this->context, 
-			this->left_column_indices, std::move(left_batch), std::ref(left_sequence), 
+		std::shared_ptr<ral::frame::BlazingTable> heavy_hitter_keys = determine_heavy_hitters(left_side);
+
+		BlazingMutableThread distribute_left_thread(ral::utilities::with_trace_query(&JoinPartitionKernel::partition_table), this->context, 
+			this->left_column_indices, std::ref(left_side), 
 			std::ref(this->output_.get_cache("output_a")), "output_a_" + this->get_message_id(),
-			this->logger);
+			this->logger, heavy_hitter_keys, false);
 
-		BlazingThread left_consumer([context = this->context, this](){
+		BlazingThread left_consumer(ral::utilities::with_trace_query([context = this->context, this](){
 			ExternalBatchColumnDataSequence<ColumnDataPartitionMessage> external_input_left(this->context, this->get_message_id());
 			std::unique_ptr<ral::frame::BlazingHostTable> host_table;
 
 			while (host_table = external_input_left.next()) {	
 				this->add_to_output_cache(std::move(host_table), "output_a");
 			}
-		});
+		}));
 
 		// clone context, increment step counter to make it so that the next partition_table will have different message id
 		auto cloned_context = context->clone();
 		cloned_context->incrementQuerySubstep();
 
-		BlazingMutableThread distribute_right_thread(&JoinPartitionKernel::partition_table, cloned_context, 
-			this->right_column_indices, std::move(right_batch), std::ref(right_sequence), 
+		BlazingMutableThread distribute_right_thread(ral::utilities::with_trace_query(&JoinPartitionKernel::partition_table), cloned_context, 
+			this->right_column_indices, std::ref(right_side), 
 			std::ref(this->output_.get_cache("output_b")), "output_b_" + this->get_message_id(),
-			this->logger);
+			this->logger, heavy_hitter_keys, true);
 
 		// create thread with ExternalBatchColumnDataSequence for the right table being distriubted
-		BlazingThread right_consumer([cloned_context, this](){
+		BlazingThread right_consumer(ral::utilities::with_trace_query([cloned_context, this](){
 			ExternalBatchColumnDataSequence<ColumnDataPartitionMessage> external_input_right(cloned_context, this->get_message_id());
 			std::unique_ptr<ral::frame::BlazingHostTable> host_table;
 			
 			while (host_table = external_input_right.next()) {
 				this->add_to_output_cache(std::move(host_table), "output_b");
 			}
-		});
+		}));
 	
 		
 		distribute_left_thread.join();
@@ -639,33 +826,92 @@ public:
 		right_consumer.join();
 	}
 
-	void small_table_scatter_distribution(std::unique_ptr<ral::frame::BlazingTable> small_table_batch,
-		std::unique_ptr<ral::frame::BlazingTable> big_table_batch,
-		BatchSequence small_table_sequence,
-		BatchSequenceBypass big_table_sequence, 
-		const std::pair<bool, bool> & scatter_left_right){
+	// Used after a node went over its scatter budget. The partitions go in the same messages as the scattered batches,
+	// so the nodes collecting the small table get both. Returns the bytes sent to the other nodes.
+	int64_t hash_partition_small_table_batch(const ral::frame::BlazingTableView & batch,
+		const std::vector<cudf::size_type> & column_indices, const std::string & output_cache_name) {
+
+		int num_partitions = this->context->getTotalNodes();
+		std::unique_ptr<CudfTable> hashed_data;
+		std::vector<cudf::size_type> hased_data_offsets;
+		std::tie(hashed_data, hased_data_offsets) = cudf::experimental::hash_partition(batch.view(), column_indices, num_partitions);
+		std::vector<cudf::size_type> split_indexes(hased_data_offsets.begin() + 1, hased_data_offsets.end());
+		std::vector<CudfTableView> partitioned = cudf::experimental::split(hashed_data->view(), split_indexes);
+
+		std::vector<ral::distribution::NodeColumnView> partitions_to_send;
+		int64_t bytes_sent = 0;
+		for(int nodeIndex = 0; nodeIndex < num_partitions; nodeIndex++ ){
+			ral::frame::BlazingTableView partition_table_view(partitioned[nodeIndex], batch.names());
+			if (this->context->getNode(nodeIndex) == ral::communication::CommunicationData::getInstance().getSelfNode()){
+				this->add_to_output_cache(partition_table_view.clone(), output_cache_name);
+			} else if (partition_table_view.num_rows() > 0) {
+				partitions_to_send.emplace_back(std::make_pair(this->context->getNode(nodeIndex), partition_table_view));
+				bytes_sent += ral::utilities::get_table_size_bytes(partition_table_view);
+			}
+		}
+		ral::distribution::distributePartitions(this->context.get(), partitions_to_send);
+		return bytes_sent;
+	}
+
+	// The small table is scattered to all the nodes, while the big one stays where it is. Each node scatters its part of the small table
+	// until it goes over its budget, then it hash partitions the rest of it. A small table row is then either on every node or on the node
+	// of its hash, so if any node switched, the big table has to be hash partitioned too, and every pair of matching rows meets on one node.
+	// When the decision was taken with the whole small table seen by every node nobody can go over its budget, and the big table
+	// is passed through without waiting for the small one.
+	void small_table_scatter_distribution(BufferedBatchSequence & small_side,
+		BufferedBatchSequence & big_side,
+		const std::string & big_input_cache_name,
+		const ral::distribution::SmallTableScatterDecision & decision,
+		int64_t scatter_budget_bytes){
 		using ColumnDataMessage = ral::communication::messages::ColumnDataMessage;
+		using ColumnDataPartitionMessage = ral::communication::messages::ColumnDataPartitionMessage;
 
 		this->context->incrementQuerySubstep();
 
-		// In this function we are assuming that one and only one of the two bools in scatter_left_right is true
-		assert((scatter_left_right.first || scatter_left_right.second) && not (scatter_left_right.first && scatter_left_right.second)); 
+		// In this function we are assuming that one and only one of the two sides is scattered
+		assert((decision.scatter_left || decision.scatter_right) && not (decision.scatter_left && decision.scatter_right)); 
 		
-		std::string small_output_cache_name = scatter_left_right.first ? "output_a" : "output_b";
-		std::string big_output_cache_name = scatter_left_right.first ? "output_b" : "output_a";
+		std::string small_output_cache_name = decision.scatter_left ? "output_a" : "output_b";
+		std::string big_output_cache_name = decision.scatter_left ? "output_b" : "output_a";
+		std::vector<cudf::size_type> small_column_indices = decision.scatter_left ? this->left_column_indices : this->right_column_indices;
+		std::vector<cudf::size_type> big_column_indices = decision.scatter_left ? this->right_column_indices : this->left_column_indices;
+
+		int64_t bytes_scattered = 0;
+		int64_t bytes_hash_partitioned = 0;
+		bool switched = false;
 
-		BlazingThread distribute_small_table_thread([this, &small_table_batch, &small_table_sequence, small_output_cache_name](){
+		BlazingThread distribute_small_table_thread(ral::utilities::with_trace_query([this, &small_side, small_output_cache_name,
+				&small_column_indices, scatter_budget_bytes, &bytes_scattered, &bytes_hash_partitioned, &switched](){
 			bool done = false;
 			int batch_count = 0;
+			std::unique_ptr<ral::frame::BlazingTable> small_table_batch = small_side.next();
 			while (!done) {		
 				try {  
-					if(small_table_batch->num_rows() > 0) {
-						ral::distribution::scatterData(this->context.get(), small_table_batch->toBlazingTableView());
+					int64_t batch_bytes = ral::utilities::get_table_size_bytes(small_table_batch->toBlazingTableView());
+					if (!switched && bytes_scattered + batch_bytes > scatter_budget_bytes) {
+						switched = true;
+						logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+													"query_id"_a=this->context->getContextToken(),
+													"step"_a=this->context->getQueryStep(),
+													"substep"_a=this->context->getQuerySubstep(),
+													"info"_a="JoinPartition switching from scattering to hash partitioning the small table. bytes_scattered: {} scatter_budget: {}"_format(bytes_scattered, scatter_budget_bytes),
+													"duration"_a="",
+													"kernel_id"_a=this->get_id());
 					}
-					this->add_to_output_cache(std::move(small_table_batch), small_output_cache_name);
-					if (small_table_sequence.wait_for_next()){
-						small_table_batch = small_table_sequence.next();
-						batch_count++;
+					if (switched) {
+						if(small_table_batch->num_rows() > 0) {
+							bytes_hash_partitioned += hash_partition_small_table_batch(small_table_batch->toBlazingTableView(), small_column_indices, small_output_cache_name);
+						}
+					} else {
+						if(small_table_batch->num_rows() > 0) {
+							ral::distribution::scatterData(this->context.get(), small_table_batch->toBlazingTableView());
+							bytes_scattered += batch_bytes;
+						}
+						this->add_to_output_cache(std::move(small_table_batch), small_output_cache_name);
+					}
+					batch_count++;
+					if (small_side.wait_for_next()){
+						small_table_batch = small_side.next();
 					} else {
 						done = true;
 					}
@@ -680,29 +926,75 @@ public:
 				}
 			}
 			ral::distribution::notifyLastTablePartitions(this->context.get(), ColumnDataMessage::MessageID());
-		});
+		}));
 		
-		BlazingThread collect_small_table_thread([this, small_output_cache_name](){
+		BlazingThread collect_small_table_thread(ral::utilities::with_trace_query([this, small_output_cache_name](){
 			ExternalBatchColumnDataSequence<ColumnDataMessage> external_input_left(this->context, this->get_message_id());
 			
 			while (external_input_left.wait_for_next()) {	
 				std::unique_ptr<ral::frame::BlazingHostTable> host_table = external_input_left.next();
 				this->add_to_output_cache(std::move(host_table), small_output_cache_name);
 			}
-		});
-
-		this->add_to_output_cache(std::move(big_table_batch), big_output_cache_name);
+		}));
 
-		BlazingThread big_table_passthrough_thread([this, &big_table_sequence, big_output_cache_name](){
+		bool any_node_switched = false;
+		if (decision.scattered_side_complete) {
+			while (big_side.wait_for_next_buffered()) {
+				this->add_to_output_cache(big_side.next_buffered(), big_output_cache_name);
+			}
+			BatchSequenceBypass big_table_sequence(this->input_.get_cache(big_input_cache_name));
 			while (big_table_sequence.wait_for_next()) {	
 				auto batch = big_table_sequence.next();
 				this->add_to_output_cache(std::move(batch), big_output_cache_name);
 			}
-		});
-		
-		distribute_small_table_thread.join();
+			distribute_small_table_thread.join();
+		} else {
+			// the big table waits until every node knows whether anybody switched
+			distribute_small_table_thread.join();
+
+			// clone context, so that the messages of the big table do not mix with the ones of the small table
+			auto cloned_context = this->context->clone();
+			any_node_switched = ral::distribution::anyNodeSwitchedToHashPartitioning(cloned_context.get(), switched);
+			if (any_node_switched) {
+				cloned_context->incrementQuerySubstep();
+
+				BlazingMutableThread distribute_big_table_thread(ral::utilities::with_trace_query(&JoinPartitionKernel::partition_table), cloned_context, 
+					big_column_indices, std::ref(big_side), 
+					std::ref(this->output_.get_cache(big_output_cache_name)), big_output_cache_name + "_" + this->get_message_id(),
+					this->logger, std::shared_ptr<ral::frame::BlazingTable>(), false);
+
+				BlazingThread big_table_consumer(ral::utilities::with_trace_query([cloned_context, this, big_output_cache_name](){
+					ExternalBatchColumnDataSequence<ColumnDataPartitionMessage> external_input(cloned_context, this->get_message_id());
+					std::unique_ptr<ral::frame::BlazingHostTable> host_table;
+
+					while (host_table = external_input.next()) {
+						this->add_to_output_cache(std::move(host_table), big_output_cache_name);
+					}
+				}));
+				distribute_big_table_thread.join();
+				big_table_consumer.join();
+			} else {
+				while (big_side.wait_for_next_buffered()) {
+					this->add_to_output_cache(big_side.next_buffered(), big_output_cache_name);
+				}
+				BatchSequenceBypass big_table_sequence(this->input_.get_cache(big_input_cache_name));
+				while (big_table_sequence.wait_for_next()) {	
+					auto batch = big_table_sequence.next();
+					this->add_to_output_cache(std::move(batch), big_output_cache_name);
+				}
+			}
+		}
 		collect_small_table_thread.join();
-		big_table_passthrough_thread.join();		
+
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="JoinPartition scattered {} table. bytes_scattered: {} bytes_hash_partitioned: {} bytes_sent: {} switched: {} any_node_switched: {}"_format(
+										decision.scatter_left ? "left" : "right", bytes_scattered, bytes_hash_partitioned,
+										bytes_scattered * (this->context->getTotalNodes() - 1) + bytes_hash_partitioned, switched, any_node_switched),
+									"duration"_a="",
+									"kernel_id"_a=this->get_id());
 	}
 	
 	virtual kstatus run() {
@@ -711,13 +1003,6 @@ public:
 		BatchSequence left_sequence(this->input_.get_cache("input_a"), this);
 		BatchSequence right_sequence(this->input_.get_cache("input_b"), this);
 
-		// lets parse part of the expression here, because we need the joinType before we load
-		std::string new_join_statement, filter_statement;
-		StringUtil::findAndReplaceAll(this->expression, "IS NOT DISTINCT FROM", "=");
-		split_inequality_join_into_join_and_filter(this->expression, new_join_statement, filter_statement);
-		std::string condition = get_named_expression(new_join_statement, "condition");
-		this->join_type = get_named_expression(new_join_statement, "joinType");
-
 		std::unique_ptr<ral::frame::BlazingTable> left_batch = left_sequence.next();
 		std::unique_ptr<ral::frame::BlazingTable> right_batch = right_sequence.next();
 
@@ -738,41 +1023,47 @@ public:
 										"duration"_a="");
 		}
 
-		std::pair<bool, bool> scatter_left_right;
-		if (this->join_type == OUTER_JOIN){ // cant scatter a full outer join
-			scatter_left_right = std::make_pair(false, false);
-		} else {
-			scatter_left_right = determine_if_we_are_scattering_a_small_table(left_batch->toBlazingTableView(), 
-																				right_batch->toBlazingTableView());
-			if (scatter_left_right.first && this->join_type == LEFT_JOIN){
-				scatter_left_right.first = false; // cant scatter the left side for a left outer join
+		// we need the number of columns of the left table to know which of the columns of the condition belong to each table
+		parse_join_column_indices(this->condition, left_batch->num_columns());
+
+		BufferedBatchSequence left_side(left_sequence, this->context);
+		BufferedBatchSequence right_side(right_sequence, this->context);
+		if (is_heavy_hitter_detection_enabled()) {
+			left_side.sample_keys(this->left_column_indices[0], ral::distribution::DEFAULT_HEAVY_HITTER_NUM_SAMPLES);
+		}
+		left_side.add(std::move(left_batch));
+		right_side.add(std::move(right_batch));
+
+		ral::distribution::SmallTableScatterDecision decision;
+		ral::distribution::JoinSideSize self_left_size{0, false};
+		ral::distribution::JoinSideSize self_right_size{0, false};
+		if (this->join_type != OUTER_JOIN){ // cant scatter a full outer join
+			decision = determine_if_we_are_scattering_a_small_table(left_side, right_side, self_left_size, self_right_size);
+			if (decision.scatter_left && this->join_type == LEFT_JOIN){
+				decision.scatter_left = false; // cant scatter the left side for a left outer join
 			}
+		} else {
+			left_side.finish_buffering();
+			right_side.finish_buffering();
 		}
-		// scatter_left_right = std::make_pair(false, false); // Do this for debugging if you want to disable small table join optmization
-		if (scatter_left_right.first){
-			logger->trace("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
-										"query_id"_a=context->getContextToken(),
-										"step"_a=context->getQueryStep(),
-										"substep"_a=context->getQuerySubstep(),
-										"info"_a="JoinPartition Scattering left table",
-										"duration"_a="",
-										"kernel_id"_a=this->get_id());
-
-			BatchSequenceBypass big_table_sequence(this->input_.get_cache("input_b"));
-			small_table_scatter_distribution( std::move(left_batch), std::move(right_batch),
-						std::move(left_sequence), std::move(big_table_sequence), scatter_left_right);
-		} else if (scatter_left_right.second) {
+		// decision = ral::distribution::SmallTableScatterDecision(); // Do this for debugging if you want to disable small table join optmization
+		if (decision.scatter_left || decision.scatter_right){
 			logger->trace("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
 										"query_id"_a=context->getContextToken(),
 										"step"_a=context->getQueryStep(),
 										"substep"_a=context->getQuerySubstep(),
-										"info"_a="JoinPartition Scattering right table",
+										"info"_a=decision.scatter_left ? "JoinPartition Scattering left table" : "JoinPartition Scattering right table",
 										"duration"_a="",
 										"kernel_id"_a=this->get_id());
 
-			BatchSequenceBypass big_table_sequence(this->input_.get_cache("input_a"));
-			small_table_scatter_distribution( std::move(right_batch), std::move(left_batch),
-						std::move(right_sequence), std::move(big_table_sequence), scatter_left_right);
+			int64_t scatter_budget_bytes = ral::distribution::getScatterBudgetBytes(decision,
+				decision.scatter_left ? self_left_size.bytes : self_right_size.bytes,
+				this->context->getTotalNodes(), ral::distribution::getMaxJoinScatterMemOverhead(this->context.get()));
+			if (decision.scatter_left){
+				small_table_scatter_distribution(left_side, right_side, "input_b", decision, scatter_budget_bytes);
+			} else {
+				small_table_scatter_distribution(right_side, left_side, "input_a", decision, scatter_budget_bytes);
+			}
 		} else {
 			logger->trace("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
 										"query_id"_a=context->getContextToken(),
@@ -782,8 +1073,7 @@ public:
 										"duration"_a="",
 										"kernel_id"_a=this->get_id());
 
-			perform_standard_hash_partitioning(condition, std::move(left_batch), std::move(right_batch),
-				std::move(left_sequence), std::move(right_sequence));
+			perform_standard_hash_partitioning(left_side, right_side);
 		}		
 		
 		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
@@ -799,11 +1089,136 @@ public:
 
 private:
 	// parsed expression related parameters
+	std::string condition;
 	std::string join_type;
 	std::vector<cudf::size_type> left_column_indices, right_column_indices;
 };
 
+/**
+ * Sits on the build side of a join and passes its batches through unchanged, while it adds their join keys to the
+ * runtime filters that the scans of the probe side are waiting for. The filters are published once the whole build side
+ * went through, merged across the nodes when the query is distributed.
+ * A build side with more than RUNTIME_FILTER_MAX_BUILD_ROWS rows abandons its filters, since they would let almost
+ * everything through, and the scans are told right away so that they do not wait for them. The same goes for the
+ * filters that have more keys than that once the ones of all the nodes are merged. By default it is the number of keys
+ * that the Bloom filter takes, one per RUNTIME_FILTER_BITS_PER_KEY bits of it.
+ */
+class RuntimeFilterBuildKernel : public kernel {
+public:
+	RuntimeFilterBuildKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{queryString, context} {
+		this->query_graph = query_graph;
 
+		std::map<std::string, std::string> config_options = context->getConfigOptions();
+		bloom_filter_bytes = ral::cache::DEFAULT_RUNTIME_FILTER_BLOOM_BYTES;
+		auto it = config_options.find("RUNTIME_FILTER_BLOOM_BYTES");
+		if (it != config_options.end()){
+			bloom_filter_bytes = std::stoull(config_options["RUNTIME_FILTER_BLOOM_BYTES"]);
+		}
+		max_build_rows = ral::cache::runtime_filter::max_keys(bloom_filter_bytes);
+		it = config_options.find("RUNTIME_FILTER_MAX_BUILD_ROWS");
+		if (it != config_options.end()){
+			max_build_rows = std::stoull(config_options["RUNTIME_FILTER_MAX_BUILD_ROWS"]);
+		}
+	}
+
+	// The filter with this id gets the keys of this column of the build side
+	void add_filter(int32_t filter_id, int column) {
+		filter_ids.push_back(filter_id);
+		key_columns.push_back(column);
+	}
+
+	bool can_you_throttle_my_input() {
+		return false;
+	}
+
+	virtual kstatus run() {
+		CodeTimer timer;
+
+		auto runtime_filters = this->query_graph->get_runtime_filters();
+		std::vector<std::unique_ptr<ral::cache::runtime_filter>> filters(filter_ids.size());
+		std::size_t num_rows = 0;
+		bool abandoned = false;
+
+		BatchSequence input(this->input_cache(), this);
+		int batch_count = 0;
+		while (input.wait_for_next()) {
+			auto batch = input.next();
+			try {
+				num_rows += batch->num_rows();
+				if (!abandoned && num_rows > max_build_rows) {
+					abandoned = true;
+					for (std::size_t i = 0; i < filters.size(); i++) {
+						runtime_filters->publish(filter_ids[i], nullptr);
+					}
+				}
+				for (std::size_t i = 0; i < filters.size() && !abandoned; i++) {
+					auto keys = batch->view().column(key_columns[i]);
+					if (filters[i] == nullptr) {
+						filters[i] = std::make_unique<ral::cache::runtime_filter>(ral::cache::runtime_filter::key_type_of(keys.type()), bloom_filter_bytes);
+					}
+					if (filters[i]->can_probe(keys.type())) {
+						filters[i]->add(keys);
+					} else {
+						filters[i]->abandon();
+					}
+				}
+			} catch(const std::exception& e) {
+				// a filter that missed some keys would drop rows that have a match
+				abandoned = true;
+				logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+											"query_id"_a=context->getContextToken(),
+											"step"_a=context->getQueryStep(),
+											"substep"_a=context->getQuerySubstep(),
+											"info"_a="In RuntimeFilterBuild kernel batch {} for {}. What: {}"_format(batch_count, expression, e.what()),
+											"duration"_a="");
+			}
+			this->add_to_output_cache(std::move(batch));
+			batch_count++;
+		}
+
+		std::size_t num_published = 0;
+		for (std::size_t i = 0; i < filters.size(); i++) {
+			if (filters[i] == nullptr) {
+				// an empty build side, whose filter only has the type of the keys of the other nodes
+				filters[i] = std::make_unique<ral::cache::runtime_filter>(cudf::type_id::EMPTY, bloom_filter_bytes);
+			}
+			if (abandoned) {
+				filters[i]->abandon();
+			}
+			std::shared_ptr<ral::cache::runtime_filter> filter = std::move(filters[i]);
+			if (this->context->getTotalNodes() > 1) {
+				filter = ral::cache::merge_runtime_filters(this->context.get(), *filter);
+			}
+			if (filter->abandoned() || filter->num_keys() > max_build_rows) {
+				filter = nullptr;
+			} else {
+				num_published++;
+			}
+			runtime_filters->publish(filter_ids[i], filter);
+		}
+
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="RuntimeFilterBuild Kernel Completed. build_rows: {} filters: {} published: {}"_format(num_rows, filter_ids.size(), num_published),
+									"duration"_a=timer.elapsed_time(),
+									"kernel_id"_a=this->get_id());
+
+		return kstatus::proceed;
+	}
+
+	std::pair<bool, uint64_t> get_estimated_output_num_rows(){
+		return this->query_graph->get_estimated_input_rows_to_kernel(this->kernel_id);
+	}
+
+private:
+	std::vector<int32_t> filter_ids;
+	std::vector<int> key_columns;
+	std::size_t bloom_filter_bytes;
+	std::size_t max_build_rows;
+};
 
 } // namespace batch
 } // namespace ral
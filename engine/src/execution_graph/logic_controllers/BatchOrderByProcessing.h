@@ -10,6 +10,7 @@
 #include "distribution/primitives.h"
 #include "operators/OrderBy.h"
 #include "CodeTimer.h"
+#include <limits>
 
 namespace ral {
 namespace batch {
@@ -20,8 +21,8 @@ using namespace fmt::literals;
 
 class SortAndSampleSingleNodeKernel : public kernel {
 public:
-	SortAndSampleSingleNodeKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context}
+	SortAndSampleSingleNodeKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)}
 	{
 		this->query_graph = query_graph;
 		this->output_.add_port("output_a", "output_b");
@@ -45,8 +46,8 @@ public:
 				this->output_cache("output_a")->wait_if_cache_is_saturated();
 
 				auto batch = input.next();
-				auto sortedTable = ral::operators::sort(batch->toBlazingTableView(), this->expression);
-				auto sampledTable = ral::operators::sample(batch->toBlazingTableView(), this->expression);
+				auto sortedTable = ral::operators::sort(batch->toBlazingTableView(), this->sort);
+				auto sampledTable = ral::operators::sample(batch->toBlazingTableView(), this->sort);
 				sampledTableViews.push_back(sampledTable->toBlazingTableView());
 				sampledTables.push_back(std::move(sampledTable));
 				tableTotalRows.push_back(batch->view().num_rows());
@@ -65,7 +66,7 @@ public:
 		}
 		// call total_num_partitions = partition_function(size_of_all_data, number_of_nodes, avaiable_memory, ....)
 		cudf::size_type num_partitions = context->getTotalNodes() * 4; // WSM TODO this is a hardcoded number for now. THis needs to change in the near future
-		auto partitionPlan = ral::operators::generate_partition_plan(num_partitions, sampledTableViews, tableTotalRows, this->expression);
+		auto partitionPlan = ral::operators::generate_partition_plan(num_partitions, sampledTableViews, tableTotalRows, this->sort);
 // std::cout<<">>>>>>>>>>>>>>> PARTITION PLAN START"<< std::endl;
 // ral::utilities::print_blazing_table_view(partitionPlan->toBlazingTableView());
 // std::cout<<">>>>>>>>>>>>>>> PARTITION PLAN END"<< std::endl;
@@ -83,13 +84,14 @@ public:
 	}
 
 private:
+	ral::operators::sort_spec sort;
 
 };
 
 class PartitionSingleNodeKernel : public kernel {
 public:
-	PartitionSingleNodeKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	PartitionSingleNodeKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)} {
 		this->query_graph = query_graph;
 		this->input_.add_port("input_a", "input_b");
 	}
@@ -109,7 +111,7 @@ public:
 		while (input.wait_for_next()) {
 			try {
 				auto batch = input.next();			
-				auto partitions = ral::operators::partition_table(partitionPlan->toBlazingTableView(), batch->toBlazingTableView(), this->expression);
+				auto partitions = ral::operators::partition_table(partitionPlan->toBlazingTableView(), batch->toBlazingTableView(), this->sort);
 
 				// std::cout<<">>>>>>>>>>>>>>> PARTITIONS START"<< std::endl;
 				// for(auto& partition : partitions)
@@ -147,13 +149,14 @@ public:
 	}
 
 private:
+	ral::operators::sort_spec sort;
 
 };
 
 class SortAndSampleKernel : public kernel {
 public:
-	SortAndSampleKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context}
+	SortAndSampleKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)}
 	{
 		this->query_graph = query_graph;
 		this->output_.add_port("output_a", "output_b");
@@ -167,7 +170,7 @@ public:
 		size_t avg_bytes_per_row = localTotalNumRows == 0 ? 1 : localTotalBytes/localTotalNumRows;
 		auto concatSamples = ral::utilities::concatTables(sampledTableViews);
 		auto partitionPlan = ral::operators::generate_distributed_partition_plan(concatSamples->toBlazingTableView(), 
-			localTotalNumRows, avg_bytes_per_row, this->expression, this->context.get());
+			localTotalNumRows, avg_bytes_per_row, this->sort, this->context.get());
 		this->add_to_output_cache(std::move(partitionPlan), "output_b");
 	}
 	
@@ -196,8 +199,8 @@ public:
 			try {
 				this->output_cache("output_a")->wait_if_cache_is_saturated();
 				auto batch = input.next();
-				auto sortedTable = ral::operators::sort(batch->toBlazingTableView(), this->expression);
-				auto sampledTable = ral::operators::sample(batch->toBlazingTableView(), this->expression);
+				auto sortedTable = ral::operators::sort(batch->toBlazingTableView(), this->sort);
+				auto sampledTable = ral::operators::sample(batch->toBlazingTableView(), this->sort);
 				sampledTableViews.push_back(sampledTable->toBlazingTableView());
 				sampledTables.push_back(std::move(sampledTable));
 				localTotalNumRows += batch->view().num_rows();
@@ -212,7 +215,7 @@ public:
 				}
 				population_sampled += batch->num_rows();
 				if (estimate_samples && population_sampled > population_to_sample)	{
-					partition_plan_thread = BlazingThread(&SortAndSampleKernel::compute_partition_plan, this, sampledTableViews, localTotalNumRows, localTotalBytes);
+					partition_plan_thread = BlazingThread(ral::utilities::with_trace_query(std::mem_fn(&SortAndSampleKernel::compute_partition_plan)), this, sampledTableViews, localTotalNumRows, localTotalBytes);
 					estimate_samples = false;
 				}
 				// End estimation
@@ -249,13 +252,14 @@ public:
 	}
 
 private:
+	ral::operators::sort_spec sort;
 
 };
 
 class PartitionKernel : public kernel {
 public:
-	PartitionKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	PartitionKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)} {
 		this->query_graph = query_graph;
 		this->input_.add_port("input_a", "input_b");
 	}
@@ -274,13 +278,13 @@ public:
 		
 		context->incrementQuerySubstep();
 
-		BlazingThread generator([input_cache = this->input_.get_cache("input_a"), &partitionPlan, this](){
+		BlazingThread generator(ral::utilities::with_trace_query([input_cache = this->input_.get_cache("input_a"), &partitionPlan, this](){
 			BatchSequence input(input_cache, this);
 			int batch_count = 0;
 			while (input.wait_for_next()) {
 				try {
 					auto batch = input.next();
-					auto self_partitions = ral::operators::distribute_table_partitions(partitionPlan->toBlazingTableView(), batch->toBlazingTableView(), this->expression, this->context.get());
+					auto self_partitions = ral::operators::distribute_table_partitions(partitionPlan->toBlazingTableView(), batch->toBlazingTableView(), this->sort, this->context.get());
 
 					for (auto && self_part : self_partitions) {
 						std::string cache_id = "output_" + std::to_string(self_part.first);
@@ -298,16 +302,16 @@ public:
 				}	
 			}
 			ral::distribution::notifyLastTablePartitions(this->context.get(), ColumnDataPartitionMessage::MessageID());
-		});
+		}));
 		
-		BlazingThread consumer([this](){
+		BlazingThread consumer(ral::utilities::with_trace_query([this](){
 			ExternalBatchColumnDataSequence<ColumnDataPartitionMessage> external_input(context, this->get_message_id());
 			std::unique_ptr<ral::frame::BlazingHostTable> host_table;
 			while (host_table = external_input.next()) {
 				std::string cache_id = "output_" + std::to_string(host_table->get_part_id());
 				this->add_to_output_cache(std::move(host_table), cache_id);
 			}
-		});
+		}));
 		generator.join();
 		consumer.join();
 
@@ -323,13 +327,14 @@ public:
 	}
 
 private:
+	ral::operators::sort_spec sort;
 
 };
 
 class MergeStreamKernel : public kernel {
 public:
-	MergeStreamKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context}  {
+	MergeStreamKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)}  {
 		this->query_graph = query_graph;
 	}
 
@@ -337,44 +342,97 @@ public:
 		return false;
 	}
 	
+	// Merges the sorted runs of a partition a slice of each at a time, and outputs the rows that no other row can go
+	// before as soon as they are merged. A run only gets its next slice once all the rows of the previous one were output,
+	// so no row is merged more than once and every output batch has at most about batch_bytes
+	void merge_runs(std::vector<std::unique_ptr<ral::frame::BlazingTable>> runs, std::size_t batch_bytes, int & num_output_batches) {
+		std::size_t total_rows = 0;
+		std::size_t total_bytes = 0;
+		for (auto & run : runs) {
+			total_rows += run->num_rows();
+			total_bytes += run->sizeInBytes();
+		}
+		std::size_t avg_bytes_per_row = total_rows == 0 ? 1 : std::max(total_bytes / total_rows, std::size_t(1));
+		std::size_t slice_rows_per_run = std::max(batch_bytes / avg_bytes_per_row / runs.size(), std::size_t(1));
+		cudf::size_type slice_rows = std::min(slice_rows_per_run, static_cast<std::size_t>(std::numeric_limits<cudf::size_type>::max() / 2));
+
+		std::vector<cudf::size_type> offsets(runs.size(), 0);  // the rows of every run that were output
+		std::vector<cudf::size_type> slice_ends(runs.size(), 0);  // the end of the slice of every run that is being merged
+		while (true) {
+			std::vector<ral::frame::BlazingTableView> heads;
+			std::vector<bool> runs_have_more;
+			std::vector<size_t> head_runs;
+			for (size_t i = 0; i < runs.size(); i++) {
+				cudf::size_type num_rows = runs[i]->num_rows();
+				if (offsets[i] == slice_ends[i] && slice_ends[i] < num_rows) {
+					slice_ends[i] = std::min(offsets[i] + slice_rows, num_rows);
+				}
+				if (offsets[i] < slice_ends[i]) {
+					heads.emplace_back(cudf::experimental::slice(runs[i]->view(), {offsets[i], slice_ends[i]})[0], runs[i]->names());
+					runs_have_more.push_back(slice_ends[i] < num_rows);
+					head_runs.push_back(i);
+				}
+			}
+			if (heads.empty()) {
+				break;
+			}
+
+			// the head with the smallest last key is always settled whole, so every round refills at least one run
+			std::unique_ptr<ral::frame::BlazingTable> settled;
+			std::vector<cudf::size_type> num_settled;
+			std::tie(settled, num_settled) = ral::operators::merge_settled_rows(heads, runs_have_more, this->sort);
+			for (size_t i = 0; i < head_runs.size(); i++) {
+				offsets[head_runs[i]] += num_settled[i];
+			}
+			if (settled->num_rows() > 0) {
+				this->add_to_output_cache(std::move(settled));
+				num_output_batches++;
+			}
+		}
+	}
+
 	virtual kstatus run() {
 		CodeTimer timer;
 
+		std::size_t batch_bytes = DEFAULT_MERGE_STREAM_BATCH_BYTES;
+		std::map<std::string, std::string> config_options = context->getConfigOptions();
+		auto it = config_options.find("MERGE_STREAM_BATCH_BYTES");
+		if (it != config_options.end()){
+			batch_bytes = std::stoull(config_options["MERGE_STREAM_BATCH_BYTES"]);
+		}
+
 		int batch_count = 0;
+		int num_output_batches = 0;
 		for (auto idx = 0; idx < this->input_.count(); idx++)
 		{	
 			try {
-				std::vector<ral::frame::BlazingTableView> tableViews;
 				std::vector<std::unique_ptr<ral::frame::BlazingTable>> tables;
+				std::unique_ptr<ral::frame::BlazingTable> empty_table;  // keeps the schema when every run is empty
 				auto cache_id = "input_" + std::to_string(idx);
 
-				// This Kernel needs all of the input before it can do any output. So lets wait until all the input is available
+				// A run that has not arrived yet could have rows that go before any other, so the partition can only be merged
+				// once all of its runs are there. The partitions are in order, so the first one is output while the others are still merged
 				this->input_.get_cache(cache_id)->wait_until_finished();
 				
 				while (this->input_.get_cache(cache_id)->wait_for_next()) {
 					auto table = this->input_.get_cache(cache_id)->pullFromCache(context.get());
-					if (table) {
-						tableViews.emplace_back(table->toBlazingTableView());
+					if (table && table->num_rows() > 0) {
 						tables.emplace_back(std::move(table));
+					} else if (table && !empty_table) {
+						empty_table = std::move(table);
 					}
 				}
 				
-				if (tableViews.empty()) {
-					// noop
-				} else if(tableViews.size() == 1) {
+				if (tables.empty()) {
+					if (empty_table) {
+						this->add_to_output_cache(std::move(empty_table));
+						num_output_batches++;
+					}
+				} else if(tables.size() == 1) {
 					this->add_to_output_cache(std::move(tables.front()));
+					num_output_batches++;
 				} else {
-					// std::cout<<">>>>>>>>>>>>>>> MERGE PARTITIONS START"<< std::endl;
-					// for (auto view : tableViews)
-					// 	ral::utilities::print_blazing_table_view(view);
-
-					// std::cout<<">>>>>>>>>>>>>>> MERGE PARTITIONS END"<< std::endl;
-
-					auto output = ral::operators::merge(tableViews, this->expression);
-
-	//					ral::utilities::print_blazing_table_view(output->toBlazingTableView());
-
-					this->add_to_output_cache(std::move(output));
+					merge_runs(std::move(tables), batch_bytes, num_output_batches);
 				}
 				batch_count++;
 			} catch(const std::exception& e) {
@@ -392,7 +450,7 @@ public:
 									"query_id"_a=context->getContextToken(),
 									"step"_a=context->getQueryStep(),
 									"substep"_a=context->getQuerySubstep(),
-									"info"_a="MergeStream Kernel Completed",
+									"info"_a="MergeStream Kernel Completed. partitions: {} output_batches: {}"_format(batch_count, num_output_batches),
 									"duration"_a=timer.elapsed_time(),
 									"kernel_id"_a=this->get_id());
 		
@@ -400,14 +458,15 @@ public:
 	}
 
 private:
-
+	ral::operators::sort_spec sort;
+	static const std::size_t DEFAULT_MERGE_STREAM_BATCH_BYTES = 50000000;
 };
 
 
 class LimitKernel : public kernel {
 public:
-	LimitKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context}  {
+	LimitKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)}  {
 		this->query_graph = query_graph;
 	}
 
@@ -415,9 +474,56 @@ public:
 		return false;
 	}
 	
+	// With a single node the limit is known up front, so the batches go out as they arrive until it is reached
+	void run_single_node() {
+		int64_t rows_limit = this->sort.limit;
+		bool limit_reached = false;
+		int batch_count = 0;
+		BatchSequenceBypass input_seq(this->input_cache());
+		while (input_seq.wait_for_next()) {
+			auto cache_data = input_seq.next();
+			if (limit_reached) {
+				// the rest of the input is not needed, but the kernels before this one still finish
+				continue;
+			}
+			try {
+				if (rows_limit < 0) {
+					this->add_to_output_cache(std::move(cache_data));
+				} else {
+					auto batch = cache_data->decache();
+					std::tie(batch, rows_limit) = ral::operators::limit_table(std::move(batch), rows_limit);
+					this->add_to_output_cache(std::move(batch));
+					limit_reached = rows_limit == 0;
+				}
+				batch_count++;
+			} catch(const std::exception& e) {
+				// TODO add retry here
+				logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+											"query_id"_a=context->getContextToken(),
+											"step"_a=context->getQueryStep(),
+											"substep"_a=context->getQuerySubstep(),
+											"info"_a="In Limit kernel batch {} for {}. What: {}"_format(batch_count, expression, e.what()),
+											"duration"_a="");
+			}
+		}
+	}
+
 	virtual kstatus run() {
 		CodeTimer timer;
 
+		if (context->getTotalNodes() == 1) {
+			run_single_node();
+
+			logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+										"query_id"_a=context->getContextToken(),
+										"step"_a=context->getQueryStep(),
+										"substep"_a=context->getQuerySubstep(),
+										"info"_a="Limit Kernel Completed",
+										"duration"_a=timer.elapsed_time(),
+										"kernel_id"_a=this->get_id());
+			return kstatus::proceed;
+		}
+
 		int64_t total_batch_rows = 0;
 		std::vector<std::unique_ptr<ral::cache::CacheData>> cache_vector;
 		BatchSequenceBypass input_seq(this->input_cache());
@@ -427,7 +533,7 @@ public:
 			cache_vector.push_back(std::move(batch));
 		}
 
-		int64_t rows_limit = ral::operators::get_local_limit(total_batch_rows, this->expression, this->context.get());
+		int64_t rows_limit = ral::operators::get_local_limit(total_batch_rows, this->sort, this->context.get());
 
 		if (rows_limit < 0) {
 			for (auto &&cache_data : cache_vector) {
@@ -470,6 +576,100 @@ public:
 	}
 
 private:
+	ral::operators::sort_spec sort;
+
+};
+
+/**
+ * ORDER BY ... LIMIT n with a small n. Every batch is sorted together with the n rows that are the best so far and
+ * only those n rows are kept, so the input is never fully sorted, partitioned or shuffled. In a distributed query
+ * each node sends its n candidates to the master, which outputs the n best of all of them.
+ */
+class TopNKernel : public kernel {
+public:
+	TopNKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, sort{ral::operators::get_sort_spec(plan)}  {
+		this->query_graph = query_graph;
+	}
+
+	bool can_you_throttle_my_input() {
+		return true;
+	}
+
+	virtual kstatus run() {
+		CodeTimer timer;
+
+		int64_t num_rows = this->sort.limit;
+
+		std::unique_ptr<ral::frame::BlazingTable> candidates;
+		std::size_t total_input_rows = 0;
+		BatchSequence input(this->input_cache(), this);
+		int batch_count = 0;
+		while (input.wait_for_next()) {
+			try {
+				auto batch = input.next();
+				total_input_rows += batch->num_rows();
+
+				std::vector<ral::frame::BlazingTableView> tables_to_merge = {batch->toBlazingTableView()};
+				if (candidates) {
+					tables_to_merge.push_back(candidates->toBlazingTableView());
+				}
+				candidates = ral::operators::top_n(tables_to_merge, this->sort, num_rows);
+				batch_count++;
+			} catch(const std::exception& e) {
+				// TODO add retry here
+				logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+											"query_id"_a=context->getContextToken(),
+											"step"_a=context->getQueryStep(),
+											"substep"_a=context->getQuerySubstep(),
+											"info"_a="In TopN kernel batch {} for {}. What: {}"_format(batch_count, expression, e.what()),
+											"duration"_a="");
+			}
+		}
+
+		try {
+			if (context->getTotalNodes() > 1) {
+				// the merge is collective, the master waits for every node, so a node without any input batch takes part too.
+				// Any batch, even an empty one, gives the candidates the schema of the output, without one there are no columns
+				if (!candidates) {
+					candidates = ral::frame::createEmptyBlazingTable(std::vector<cudf::type_id>(), std::vector<std::string>());
+				}
+				candidates = ral::operators::merge_top_n_candidates(candidates->toBlazingTableView(), this->sort, num_rows, this->context.get());
+			}
+			if (candidates && candidates->num_columns() > 0) {
+				this->add_to_output_cache(std::move(candidates));
+			}
+		} catch(const std::exception& e) {
+			logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+										"query_id"_a=context->getContextToken(),
+										"step"_a=context->getQueryStep(),
+										"substep"_a=context->getQuerySubstep(),
+										"info"_a="In TopN kernel merging the candidates of every node for {}. What: {}"_format(expression, e.what()),
+										"duration"_a="");
+		}
+
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="TopN Kernel Completed. batches: {} input_rows: {}"_format(batch_count, total_input_rows),
+									"duration"_a=timer.elapsed_time(),
+									"kernel_id"_a=this->get_id());
+
+		return kstatus::proceed;
+	}
+
+	std::pair<bool, uint64_t> get_estimated_output_num_rows(){
+		std::pair<bool, uint64_t> total_in = this->query_graph->get_estimated_input_rows_to_kernel(this->kernel_id);
+		int64_t num_rows = this->sort.limit;
+		if (total_in.first) {
+			return std::make_pair(true, std::min(total_in.second, static_cast<uint64_t>(num_rows)));
+		}
+		return std::make_pair(true, static_cast<uint64_t>(num_rows));
+	}
+
+private:
+	ral::operators::sort_spec sort;
 
 };
 
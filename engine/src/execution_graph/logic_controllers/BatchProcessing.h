@@ -6,10 +6,13 @@
 #include "io/DataLoader.h"
 #include "io/Schema.h"
 #include "utilities/CommonOperations.h"
+#include "utilities/Tracing.h"
 #include "communication/messages/ComponentMessages.h"
 #include "communication/network/Server.h"
 #include <src/communication/network/Client.h>
 #include "parser/expression_utils.hpp"
+#include "parser/physical_plan.hpp"
+#include "skip_data/utils.hpp"
 
 
 #include "utilities/random_generator.cuh"
@@ -24,8 +27,13 @@
 #include <src/operators/OrderBy.h>
 #include <src/operators/GroupBy.h>
 #include <src/utilities/DebuggingUtils.h>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <limits>
 #include <stack>
 #include <mutex>
+#include <numeric>
 #include "io/DataLoader.h"
 #include "io/Schema.h"
 #include <Util/StringUtil.h>
@@ -35,10 +43,14 @@
 #include <boost/foreach.hpp>
 #include "parser/expression_utils.hpp"
 
+#include "CalciteExpressionParsing.h"
+#include "Utils.cuh"
 #include <cudf/copying.hpp>
 #include <cudf/merge.hpp>
+#include <cudf/replace.hpp>
 #include <cudf/search.hpp>
 #include <cudf/sorting.hpp>
+#include <cudf/stream_compaction.hpp>
 #include <src/CalciteInterpreter.h>
 #include <src/utilities/CommonOperations.h>
 
@@ -46,8 +58,11 @@
 #include "config/GPUManager.cuh"
 #include "CacheMachine.h"
 #include "blazingdb/concurrency/BlazingThread.h"
+#include <blazingdb/transport/FlowControl.h>
+#include <functional>
 
 #include "taskflow/graph.h"
+#include "RuntimeFilter.h"
 
 #include "CodeTimer.h"
 
@@ -120,17 +135,26 @@ using ral::communication::messages::ReceivedHostMessage;
 template<class MessageType>
 class ExternalBatchColumnDataSequence {
 public:
+	using message_source = std::function<std::shared_ptr<ral::communication::network::ReceivedMessage>()>;
+
 	ExternalBatchColumnDataSequence(std::shared_ptr<Context> context, const std::string & message_id)
+		: ExternalBatchColumnDataSequence(context, message_id, server_message_source(context))
+	{
+	}
+
+	// get_message waits for the next message that the other nodes sent, nullptr for the last one of a node
+	ExternalBatchColumnDataSequence(std::shared_ptr<Context> context, const std::string & message_id, message_source get_message)
 		: context{context}, last_message_counter{context->getTotalNodes() - 1}
 	{
-		host_cache = std::make_shared<ral::cache::HostCacheMachine>();
-		std::string context_comm_token = context->getContextCommunicationToken();
-		const uint32_t context_token = context->getContextToken();
-		std::string comms_message_token = MessageType::MessageID() + "_" + context_comm_token;
+		// the messages are left in the server while the cache is full, and the server only gives their senders credits
+		// for more once they leave it, so that the senders are throttled by the flow control
+		host_cache = std::make_shared<ral::cache::HostCacheMachine>(
+			blazingdb::transport::getFlowControlCreditsPerSender() * (context->getTotalNodes() - 1));
 
-		BlazingMutableThread t([this, comms_message_token, context_token, message_id](){
+		BlazingMutableThread t(ral::utilities::with_trace_query([this, get_message, message_id](){
 			while(true){
-					auto message = Server::getInstance().getHostMessage(context_token, comms_message_token);
+					this->host_cache->wait_if_cache_is_saturated();
+					auto message = get_message();
 					if(!message) {
 						--last_message_counter;
 						if (last_message_counter == 0 ){
@@ -145,7 +169,7 @@ public:
 						this->host_cache->addToCache(std::move(host_table), message_id, this->context.get());			
 					}
 			}
-		});
+		}));
 		t.detach();
 	}
 
@@ -156,7 +180,20 @@ public:
 	std::unique_ptr<ral::frame::BlazingHostTable> next() {
 		return host_cache->pullFromCache(context.get());
 	}
+
+	// bytes received and not pulled with next yet
+	std::size_t get_num_bytes_buffered() {
+		return host_cache->get_num_bytes_in_cache();
+	}
 private:
+	static message_source server_message_source(std::shared_ptr<Context> context) {
+		const uint32_t context_token = context->getContextToken();
+		std::string comms_message_token = MessageType::MessageID() + "_" + context->getContextCommunicationToken();
+		return [context_token, comms_message_token]() {
+			return Server::getInstance().getHostMessage(context_token, comms_message_token);
+		};
+	}
+
 	std::shared_ptr<Context> context;
 	std::shared_ptr<ral::cache::HostCacheMachine> host_cache;
 	int last_message_counter;
@@ -184,11 +221,30 @@ public:
 		} else {
 			n_batches = n_files;
 		}
+
+		scan_unit_target_bytes = SCAN_UNIT_TARGET_BYTES;
+		std::map<std::string, std::string> config_options = context->getConfigOptions();
+		auto it = config_options.find("SCAN_UNIT_TARGET_BYTES");
+		if (it != config_options.end()){
+			scan_unit_target_bytes = std::stoull(config_options["SCAN_UNIT_TARGET_BYTES"]);
+		}
+		dictionary_pruning_max_threads = DICTIONARY_PRUNING_MAX_THREADS;
+		it = config_options.find("DICTIONARY_PRUNING_MAX_THREADS");
+		if (it != config_options.end()){
+			dictionary_pruning_max_threads = std::stoull(config_options["DICTIONARY_PRUNING_MAX_THREADS"]);
+		}
+		it = config_options.find("ENABLE_LATE_MATERIALIZATION");
+		enable_late_materialization = !(it != config_options.end() && (it->second == "False" || it->second == "false" || it->second == "0"));
 	}
 
 	RecordBatch next() {
+		std::call_once(runtime_filters_waited_, [this] { wait_for_runtime_filters(); });
+
 		std::unique_lock<std::mutex> lock(mutex_);
 
+		// the units of the files that other threads are opening are not known yet
+		file_opened_.wait(lock, [this] { return !cur_file_units.empty() || cur_file_index < n_files || num_files_opening == 0; });
+
 		if (!has_next()) {
 			return nullptr;
 		}
@@ -203,27 +259,72 @@ public:
 			batch_index++;
 			cur_row_group_index++;
 
-			return std::move(ret);
+			lock.unlock();
+			return apply_runtime_filters(std::move(ret), 0);
 		}
 
-		// a file handle that we can use in case errors occur to tell the user which file had parsing issues
-		assert(this->provider->has_next());
+		if (cur_file_units.empty()) {
+			// a file handle that we can use in case errors occur to tell the user which file had parsing issues
+			assert(this->provider->has_next());
 
-		auto local_cur_data_handle = this->provider->get_next();
-		auto local_cur_file_index = cur_file_index;
-		auto local_all_row_groups = this->all_row_groups[cur_file_index];
+			ral::io::data_handle handle;
+			{
+				ral::utilities::trace_span span("io", "open_file", context->getContextToken(), "file_index", cur_file_index);
+				handle = this->provider->get_next();
+			}
+			size_t file_index = cur_file_index;
+			cur_file_index++;
+			num_files_opening++;
+			lock.unlock();
+
+			// the footers, dictionaries and page indexes are read without the lock, so the scan threads can open files at the same time
+			size_t row_groups_skipped = 0;
+			size_t row_groups_without_values = 0;
+			size_t rows_skipped_by_pages = 0;
+			std::vector<ral::io::scan_unit> units;
+			try {
+				units = get_file_units(handle, file_index, row_groups_skipped, row_groups_without_values, rows_skipped_by_pages);
+			} catch (...) {
+				lock.lock();
+				num_files_opening--;
+				file_opened_.notify_all();
+				throw;
+			}
+
+			lock.lock();
+			num_files_opening--;
+			row_groups_skipped_by_dictionary += row_groups_without_values;
+			rows_skipped_by_page_index += rows_skipped_by_pages;
+			for (size_t i = 1; i < units.size(); i++) {
+				cur_file_units.push_back(file_unit{handle, file_index, units[i]});
+			}
+			if (!units.empty()) {
+				n_batches += units.size() - 1;
+			}
+			batch_index++;
+			file_opened_.notify_all();
+			lock.unlock();
+
+			if (units.empty()) {
+				return apply_runtime_filters(schema.makeEmptyBlazingTable(projections), row_groups_skipped);
+			}
+			auto ret = load_scan_unit(handle, file_index, units[0]);
+			return apply_runtime_filters(std::move(ret), row_groups_skipped);
+		}
+
+		file_unit local_unit = cur_file_units.front();
+		cur_file_units.pop_front();
 
 		batch_index++;
-		cur_file_index++;
 
 		lock.unlock();
 
-		auto ret = loader.load_batch(context.get(), projections, schema, local_cur_data_handle, local_cur_file_index, local_all_row_groups);
-		return std::move(ret);
+		auto ret = load_scan_unit(local_unit.handle, local_unit.file_index, local_unit.unit);
+		return apply_runtime_filters(std::move(ret), 0);
 	}
 
 	bool has_next() {
-		return (is_empty_data_source && batch_index < 1) || (is_gdf_parser && batch_index.load() < n_batches) || (cur_file_index < n_files);
+		return (is_empty_data_source && batch_index < 1) || (is_gdf_parser && batch_index.load() < n_batches) || (cur_file_index < n_files) || !cur_file_units.empty();
 	}
 
 	void set_projections(std::vector<size_t> projections) {
@@ -235,11 +336,362 @@ public:
 		return batch_index.load();
 	}
 
+	// The files are split into batches as they are opened, so this counts the ones that were not opened yet as one batch
 	size_t get_num_batches() {
-		return n_batches;
+		return n_batches.load();
+	}
+
+	// The rows whose value in this column of the output are not in the runtime filter with this id are dropped.
+	// It has to be called before the first batch is read
+	void add_runtime_filter(std::shared_ptr<ral::cache::runtime_filter_registry> registry, int32_t filter_id, int column) {
+		runtime_filters = registry;
+		runtime_filter_ids.push_back(filter_id);
+		runtime_filter_columns.push_back(column);
+	}
+
+	// rows loaded, rows dropped by the runtime filters and row groups that were not read because of them
+	std::tuple<size_t, size_t, size_t> get_runtime_filter_stats() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return std::make_tuple(rows_scanned, rows_dropped, row_groups_skipped);
+	}
+
+	// The row groups where this column of the output does not have any of values, which are SQL literals, are not read.
+	// It has to be called before the first batch is read
+	void add_equality_filter(int column, std::vector<std::string> values) {
+		equality_filter_columns.push_back(column);
+		equality_filter_values.push_back(std::move(values));
+	}
+
+	// row groups that were not read because their dictionaries do not have the values of the equality filters
+	size_t get_row_groups_skipped_by_dictionary() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return row_groups_skipped_by_dictionary;
+	}
+
+	// Only the pages where this column of the output can be inside bounds are read, for the files with a page index.
+	// It has to be called before the first batch is read
+	void add_value_bounds(int column, ral::skip_data::column_bounds bounds) {
+		value_bounds_columns.push_back(column);
+		value_bounds.push_back(std::move(bounds));
+	}
+
+	// rows that were not read because the page index shows that they are out of the bounds
+	size_t get_rows_skipped_by_page_index() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return rows_skipped_by_page_index;
+	}
+
+	// The columns of the output that condition uses are read first, and the other ones only for the range of rows where it
+	// is true, when the format can read a range of rows. The batches still have every row of the range, condition is only
+	// evaluated to find it. It has to be called before the first batch is read, ENABLE_LATE_MATERIALIZATION disables it
+	void set_late_materialization_filter(const std::string & condition) {
+		if (!enable_late_materialization) {
+			return;
+		}
+		late_materialization_columns = get_input_columns(condition);
+		late_materialization_program = std::make_unique<ral::processor::expression_program>(
+			std::vector<std::string>{reindex_columns(condition, late_materialization_columns)});
+	}
+
+	// rows whose condition was evaluated before reading their other columns, and rows whose other columns were not read
+	std::pair<size_t, size_t> get_late_materialization_stats() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return std::make_pair(late_materialization_rows, late_materialization_rows_skipped);
 	}
 
 private:
+	// The filters come from the build side of the joins, which usually is much smaller. The scan waits for them up to
+	// RUNTIME_FILTER_MAX_WAIT_MS before it starts reading, and the ones that come later are used from then on
+	void wait_for_runtime_filters() {
+		if (runtime_filter_ids.empty()) {
+			return;
+		}
+		int max_wait_ms = ral::cache::DEFAULT_RUNTIME_FILTER_MAX_WAIT_MS;
+		std::map<std::string, std::string> config_options = context->getConfigOptions();
+		auto it = config_options.find("RUNTIME_FILTER_MAX_WAIT_MS");
+		if (it != config_options.end()){
+			max_wait_ms = std::stoi(config_options["RUNTIME_FILTER_MAX_WAIT_MS"]);
+		}
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(max_wait_ms);
+		for (auto filter_id : runtime_filter_ids) {
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+			runtime_filters->wait(filter_id, std::max(remaining, std::chrono::milliseconds(0)));
+		}
+	}
+
+	// The column of the schema that a column of the output comes from
+	size_t schema_column_index(int column) {
+		return projections.empty() ? column : projections[column];
+	}
+
+	// The units of the file that are left after skipping the row groups and pages where the filters can not be true.
+	// It reads the metadata of the file, so it is called without the lock
+	std::vector<ral::io::scan_unit> get_file_units(const ral::io::data_handle & handle, size_t file_index,
+		size_t & row_groups_skipped, size_t & row_groups_without_values, size_t & rows_skipped_by_pages) {
+		std::vector<cudf::size_type> row_groups = this->all_row_groups[file_index];
+		row_groups_skipped = skip_row_groups_out_of_range(handle, row_groups);
+		if (row_groups_skipped == 0 || !row_groups.empty()) {
+			row_groups_without_values = skip_row_groups_without_values(handle, row_groups);
+		}
+		if ((row_groups_skipped > 0 || row_groups_without_values > 0) && row_groups.empty()) {
+			return {};
+		}
+
+		// a big file is read as several batches, which the scan threads read at the same time
+		std::vector<ral::io::scan_unit> units = parser->get_scan_units(handle.fileHandle, row_groups, scan_unit_target_bytes);
+		if (!value_bounds_columns.empty()) {
+			rows_skipped_by_pages = skip_pages_out_of_range(handle, units);
+		}
+		return units;
+	}
+
+	size_t skip_row_groups_out_of_range(const ral::io::data_handle & handle, std::vector<cudf::size_type> & row_groups) {
+		size_t num_skipped = 0;
+		for (size_t i = 0; i < runtime_filter_ids.size(); i++) {
+			auto filter = runtime_filters->get(runtime_filter_ids[i]);
+			size_t column_index = schema_column_index(runtime_filter_columns[i]);
+			if (filter == nullptr || !schema.get_in_file()[column_index] || !filter->can_probe(cudf::data_type{schema.get_dtype(column_index)})) {
+				continue;
+			}
+			num_skipped += parser->skip_row_groups_out_of_range(handle.fileHandle, schema.get_name(column_index), filter->value_range(), row_groups);
+			if (num_skipped > 0 && row_groups.empty()) {
+				break;
+			}
+		}
+		return num_skipped;
+	}
+
+	size_t skip_row_groups_without_values(const ral::io::data_handle & handle, std::vector<cudf::size_type> & row_groups) {
+		size_t num_skipped = 0;
+		for (size_t i = 0; i < equality_filter_columns.size(); i++) {
+			size_t column_index = schema_column_index(equality_filter_columns[i]);
+			if (!schema.get_in_file()[column_index]) {
+				continue;
+			}
+			num_skipped += parser->skip_row_groups_without_values(handle.fileHandle, schema.get_name(column_index),
+				equality_filter_values[i], row_groups, dictionary_pruning_max_threads);
+			if (num_skipped > 0 && row_groups.empty()) {
+				break;
+			}
+		}
+		return num_skipped;
+	}
+
+	std::unique_ptr<ral::frame::BlazingTable> load_scan_unit(const ral::io::data_handle & handle, size_t file_index, const ral::io::scan_unit & unit) {
+		std::vector<size_t> columns = projections;
+		if (columns.empty()) {
+			columns.resize(schema.get_num_columns());
+			std::iota(columns.begin(), columns.end(), 0);
+		}
+		bool late_materialization = late_materialization_program != nullptr && late_materialization_supported &&
+			!late_materialization_columns.empty() &&
+			late_materialization_columns.size() < columns.size() && late_materialization_columns.back() < static_cast<int>(columns.size()) &&
+			std::all_of(columns.begin(), columns.end(), [this](size_t column) { return schema.get_in_file()[column]; });
+		if (!late_materialization) {
+			return loader.load_scan_unit(context.get(), projections, schema, handle, file_index, unit);
+		}
+
+		std::vector<size_t> condition_projections;
+		std::vector<size_t> other_projections;
+		std::vector<bool> in_condition(columns.size(), false);
+		for (int column : late_materialization_columns) {
+			in_condition[column] = true;
+		}
+		for (size_t i = 0; i < columns.size(); i++) {
+			(in_condition[i] ? condition_projections : other_projections).push_back(columns[i]);
+		}
+
+		auto condition_table = loader.load_scan_unit(context.get(), condition_projections, schema, handle, file_index, unit);
+		int64_t first_kept_row = -1;
+		int64_t last_kept_row = -1;
+		if (condition_table->num_rows() > 0) {
+			std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluated =
+				late_materialization_program->evaluate(condition_table->toBlazingTableView().toBlazingColumns());
+			RAL_EXPECTS(evaluated.size() == 1 && evaluated[0]->view().type().id() == cudf::type_id::BOOL8, "Expression does not evaluate to a boolean mask");
+			std::unique_ptr<cudf::scalar> false_scalar = get_scalar_from_string("false", cudf::type_id::BOOL8);
+			std::unique_ptr<CudfColumn> keep = cudf::experimental::replace_nulls(evaluated[0]->view(), *false_scalar);
+			std::vector<int8_t> host_keep(keep->size());
+			CUDA_TRY(cudaMemcpy(host_keep.data(), keep->view().data<int8_t>(), host_keep.size(), cudaMemcpyDeviceToHost));
+			auto first = std::find(host_keep.begin(), host_keep.end(), 1);
+			if (first != host_keep.end()) {
+				first_kept_row = first - host_keep.begin();
+				last_kept_row = host_keep.rend() - std::find(host_keep.rbegin(), host_keep.rend(), 1) - 1;
+			}
+		}
+
+		size_t num_rows = condition_table->num_rows();
+		if (first_kept_row < 0) {
+			add_late_materialization_stats(num_rows, num_rows);
+			return schema.makeEmptyBlazingTable(projections);
+		}
+		ral::io::scan_unit narrowed_unit;
+		int64_t first_row = 0;
+		if (!parser->narrow_scan_unit(handle.fileHandle, unit, first_kept_row, last_kept_row + 1, narrowed_unit, first_row)) {
+			// the format reads whole units, so the next ones are read in one go
+			late_materialization_supported = false;
+			narrowed_unit = unit;
+			first_row = 0;
+		}
+		auto other_table = loader.load_scan_unit(context.get(), other_projections, schema, handle, file_index, narrowed_unit);
+		add_late_materialization_stats(num_rows, num_rows - other_table->num_rows());
+
+		cudf::size_type begin = first_row;
+		cudf::size_type end = first_row + other_table->num_rows();
+		CudfTableView condition_rows = cudf::experimental::slice(condition_table->view(), {begin, end})[0];
+		std::vector<std::string> condition_names = condition_table->names();
+		std::vector<std::string> other_names = other_table->names();
+		std::vector<std::unique_ptr<CudfColumn>> other_columns = other_table->releaseCudfTable()->release();
+
+		std::vector<std::unique_ptr<CudfColumn>> columns_out;
+		std::vector<std::string> names_out;
+		size_t condition_index = 0;
+		size_t other_index = 0;
+		for (size_t i = 0; i < columns.size(); i++) {
+			if (in_condition[i]) {
+				columns_out.push_back(std::make_unique<CudfColumn>(condition_rows.column(condition_index)));
+				names_out.push_back(condition_names[condition_index]);
+				condition_index++;
+			} else {
+				columns_out.push_back(std::move(other_columns[other_index]));
+				names_out.push_back(other_names[other_index]);
+				other_index++;
+			}
+		}
+		return std::make_unique<ral::frame::BlazingTable>(std::make_unique<CudfTable>(std::move(columns_out)), names_out);
+	}
+
+	void add_late_materialization_stats(size_t rows, size_t rows_skipped) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		late_materialization_rows += rows;
+		late_materialization_rows_skipped += rows_skipped;
+	}
+
+	// The bound of the integers that a literal gives. The literals of integers are kept exact and the others are rounded
+	// towards the inside of the bounds. The ones out of the int64_t values are clamped to them, and false for the ones
+	// that do not even fit in a double, whose side is left unbounded
+	static bool to_integer_bound(const std::string & literal, bool is_lower, bool inclusive, int64_t & bound) {
+		try {
+			if (literal.find_first_of(".eE") == std::string::npos) {
+				try {
+					int64_t value = std::stoll(literal);
+					if (inclusive) {
+						bound = value;
+					} else if (is_lower) {
+						bound = value == std::numeric_limits<int64_t>::max() ? value : value + 1;
+					} else {
+						bound = value == std::numeric_limits<int64_t>::min() ? value : value - 1;
+					}
+					return true;
+				} catch (const std::out_of_range & e) {
+					// read as a double, which is clamped below
+				}
+			}
+			double value = std::stod(literal);
+			double rounded = is_lower ? (inclusive ? std::ceil(value) : std::floor(value) + 1) : (inclusive ? std::floor(value) : std::ceil(value) - 1);
+			// 2^63, the first double past the int64_t values
+			const double int64_end = 9223372036854775808.0;
+			if (rounded >= int64_end) {
+				bound = std::numeric_limits<int64_t>::max();
+			} else if (rounded < -int64_end) {
+				bound = std::numeric_limits<int64_t>::min();
+			} else {
+				bound = static_cast<int64_t>(rounded);
+			}
+			return true;
+		} catch (const std::out_of_range & e) {
+			return false;
+		}
+	}
+
+	// The bounds as a range of values of the type of the column. is_valid is false for the types that the page index
+	// is not compared with
+	static ral::io::column_value_range to_value_range(const ral::skip_data::column_bounds & bounds, cudf::type_id type) {
+		ral::io::column_value_range range;
+		switch (type) {
+		case cudf::type_id::INT8:
+		case cudf::type_id::INT16:
+		case cudf::type_id::INT32:
+		case cudf::type_id::INT64: {
+			range.is_valid = true;
+			range.is_integer = true;
+			range.integer_min = std::numeric_limits<int64_t>::min();
+			range.integer_max = std::numeric_limits<int64_t>::max();
+			if (!bounds.lower.empty() && !to_integer_bound(bounds.lower, true, bounds.lower_inclusive, range.integer_min)) {
+				range.integer_min = std::numeric_limits<int64_t>::min();
+			}
+			if (!bounds.upper.empty() && !to_integer_bound(bounds.upper, false, bounds.upper_inclusive, range.integer_max)) {
+				range.integer_max = std::numeric_limits<int64_t>::max();
+			}
+			break;
+		}
+		case cudf::type_id::FLOAT32:
+		case cudf::type_id::FLOAT64:
+			// the strict bounds are taken as inclusive, the pages are only compared with them. A literal that does not fit
+			// in a double leaves its side unbounded
+			range.is_valid = true;
+			range.float_min = -std::numeric_limits<double>::infinity();
+			range.float_max = std::numeric_limits<double>::infinity();
+			try {
+				if (!bounds.lower.empty()) {
+					range.float_min = std::stod(bounds.lower);
+				}
+			} catch (const std::out_of_range & e) {
+			}
+			try {
+				if (!bounds.upper.empty()) {
+					range.float_max = std::stod(bounds.upper);
+				}
+			} catch (const std::out_of_range & e) {
+			}
+			break;
+		default:
+			break;
+		}
+		return range;
+	}
+
+	// The page index of the file is read once for all the columns with bounds
+	size_t skip_pages_out_of_range(const ral::io::data_handle & handle, std::vector<ral::io::scan_unit> & units) {
+		std::vector<std::string> column_names;
+		std::vector<ral::io::column_value_range> ranges;
+		for (size_t i = 0; i < value_bounds_columns.size(); i++) {
+			size_t column_index = schema_column_index(value_bounds_columns[i]);
+			if (!schema.get_in_file()[column_index]) {
+				continue;
+			}
+			column_names.push_back(schema.get_name(column_index));
+			ranges.push_back(to_value_range(value_bounds[i], schema.get_dtype(column_index)));
+		}
+		if (column_names.empty()) {
+			return 0;
+		}
+		return parser->skip_pages_out_of_range(handle.fileHandle, column_names, ranges, units);
+	}
+
+	std::unique_ptr<ral::frame::BlazingTable> apply_runtime_filters(std::unique_ptr<ral::frame::BlazingTable> table, size_t row_groups_skipped_in_batch) {
+		if (runtime_filter_ids.empty()) {
+			return table;
+		}
+		size_t num_rows = table->num_rows();
+		for (size_t i = 0; i < runtime_filter_ids.size() && table->num_rows() > 0; i++) {
+			auto filter = runtime_filters->get(runtime_filter_ids[i]);
+			auto keys = table->view().column(runtime_filter_columns[i]);
+			if (filter == nullptr || !filter->can_probe(keys.type())) {
+				continue;
+			}
+			std::unique_ptr<cudf::column> mask = filter->contains(keys);
+			std::unique_ptr<CudfTable> filtered = cudf::experimental::apply_boolean_mask(table->view(), mask->view());
+			table = std::make_unique<ral::frame::BlazingTable>(std::move(filtered), table->names());
+		}
+
+		runtime_filters->add_scan_stats(num_rows, num_rows - table->num_rows(), row_groups_skipped_in_batch);
+		std::lock_guard<std::mutex> lock(mutex_);
+		rows_scanned += num_rows;
+		rows_dropped += num_rows - table->num_rows();
+		row_groups_skipped += row_groups_skipped_in_batch;
+		return table;
+	}
+
 	std::shared_ptr<ral::io::data_provider> provider;
 	std::shared_ptr<ral::io::data_parser> parser;
 
@@ -251,18 +703,56 @@ private:
 	size_t cur_row_group_index;
 	std::vector<std::vector<int>> all_row_groups;
 	std::atomic<size_t> batch_index;
-	size_t n_batches;
+	std::atomic<size_t> n_batches;
 	size_t n_files;
 	bool is_empty_data_source;
 	bool is_gdf_parser;
 
+	std::shared_ptr<ral::cache::runtime_filter_registry> runtime_filters;
+	std::vector<int32_t> runtime_filter_ids;
+	std::vector<int> runtime_filter_columns;
+	std::once_flag runtime_filters_waited_;
+	size_t rows_scanned = 0;
+	size_t rows_dropped = 0;
+	size_t row_groups_skipped = 0;
+
+	std::vector<int> equality_filter_columns;
+	std::vector<std::vector<std::string>> equality_filter_values;
+	size_t dictionary_pruning_max_threads;
+	size_t row_groups_skipped_by_dictionary = 0;
+
+	std::vector<int> value_bounds_columns;
+	std::vector<ral::skip_data::column_bounds> value_bounds;
+	size_t rows_skipped_by_page_index = 0;
+
+	bool enable_late_materialization;
+	std::vector<int> late_materialization_columns;
+	std::unique_ptr<ral::processor::expression_program> late_materialization_program;
+	std::atomic<bool> late_materialization_supported{true};
+	size_t late_materialization_rows = 0;
+	size_t late_materialization_rows_skipped = 0;
+
+	// the units of the files that were opened that were not handed out yet
+	struct file_unit {
+		ral::io::data_handle handle;
+		size_t file_index;
+		ral::io::scan_unit unit;
+	};
+	std::deque<file_unit> cur_file_units;
+	size_t num_files_opening = 0;
+	std::condition_variable file_opened_;
+	size_t scan_unit_target_bytes;
+
+	static const size_t SCAN_UNIT_TARGET_BYTES = 250000000;
+	static const size_t DICTIONARY_PRUNING_MAX_THREADS = 8;
+
 	std::mutex mutex_;
 };
 
 class TableScan : public kernel {
 public:
-	TableScan(const std::string & queryString, ral::io::data_loader &loader, ral::io::Schema & schema, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-	: kernel(queryString, context), input(loader, schema, context)
+	TableScan(const ral::parser::plan_node & plan, ral::io::data_loader &loader, ral::io::Schema & schema, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+	: kernel(plan.expr(), context), input(loader, schema, context)
 	{
 		this->query_graph = query_graph;
 	}
@@ -270,6 +760,11 @@ public:
 	bool can_you_throttle_my_input() {
 		return false;
 	}
+
+	// Drops the rows whose value in this column are not in the runtime filter with this id
+	void add_runtime_filter(int32_t filter_id, int column) {
+		input.add_runtime_filter(this->query_graph->get_runtime_filters(), filter_id, column);
+	}
 	
 	virtual kstatus run() {
 		CodeTimer timer;
@@ -283,7 +778,7 @@ public:
 
 		std::vector<BlazingThread> threads;
 		for (int i = 0; i < table_scan_kernel_num_threads; i++) {
-			threads.push_back(BlazingThread([this]() {
+			threads.push_back(BlazingThread(ral::utilities::with_trace_query([this]() {
 				this->output_cache()->wait_if_cache_is_saturated();
 				std::unique_ptr<ral::frame::BlazingTable> batch;
 				while(batch = input.next()) {
@@ -291,7 +786,7 @@ public:
 
 					this->output_cache()->wait_if_cache_is_saturated();
 				}
-			}));
+			})));
 		}
 		for (auto &&t : threads) {
 			t.join();
@@ -304,6 +799,8 @@ public:
 									"info"_a="TableScan Kernel Completed",
 									"duration"_a=timer.elapsed_time(),
 									"kernel_id"_a=this->get_id());
+
+		log_runtime_filter_stats();
 		
 		return kstatus::proceed;
 	}
@@ -320,26 +817,64 @@ public:
 	}
 
 private:
+	void log_runtime_filter_stats() {
+		size_t rows_scanned, rows_dropped, row_groups_skipped;
+		std::tie(rows_scanned, rows_dropped, row_groups_skipped) = input.get_runtime_filter_stats();
+		if (rows_scanned == 0 && row_groups_skipped == 0) {
+			return;
+		}
+		logger->debug("{query_id}|{step}|{substep}|{info}||kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="Runtime filters. rows_scanned: {} rows_dropped: {} row_groups_skipped: {}"_format(rows_scanned, rows_dropped, row_groups_skipped),
+									"kernel_id"_a=this->get_id());
+	}
+
 	DataSourceSequence input;
 };
 
 class BindableTableScan : public kernel {
 public:
-	BindableTableScan(const std::string & queryString, ral::io::data_loader &loader, ral::io::Schema & schema, std::shared_ptr<Context> context,
+	BindableTableScan(const ral::parser::plan_node & plan, ral::io::data_loader &loader, ral::io::Schema & schema, std::shared_ptr<Context> context,
 		std::shared_ptr<ral::cache::graph> query_graph)
-	: kernel(queryString, context), input(loader, schema, context)
+	: kernel(plan.expr(), context), input(loader, schema, context), projections(plan.projections), aliases(plan.aliases)
 	{
 		this->query_graph = query_graph;
+		if(!plan.condition.empty()) {
+			this->filter_program = std::make_unique<ral::processor::expression_program>(
+				std::vector<std::string>{plan.condition});
+
+			// the = and IN of the filter let the scan skip the row groups whose dictionaries do not have their values
+			auto equality_values = ral::skip_data::get_equality_values(plan.condition);
+			for (auto & column_values : equality_values) {
+				input.add_equality_filter(column_values.first, column_values.second);
+			}
+
+			// and its comparisons with numbers let it skip the pages out of their bounds
+			auto column_bounds = ral::skip_data::get_column_bounds(plan.condition);
+			for (auto & bounds : column_bounds) {
+				input.add_value_bounds(bounds.first, bounds.second);
+			}
+
+			// the columns that the filter does not use are only read for the rows around the ones that it keeps
+			input.set_late_materialization_filter(plan.condition);
+		}
 	}
 
 	bool can_you_throttle_my_input() {
 		return false;
 	}
 
+	// Drops the rows whose value in this column are not in the runtime filter with this id
+	void add_runtime_filter(int32_t filter_id, int column) {
+		input.add_runtime_filter(this->query_graph->get_runtime_filters(), filter_id, column);
+	}
+
 	virtual kstatus run() {
 		CodeTimer timer;
 
-		input.set_projections(get_projections(expression));
+		input.set_projections(this->projections);
 
 		int table_scan_kernel_num_threads = 1;
 		std::map<std::string, std::string> config_options = context->getConfigOptions();
@@ -350,20 +885,20 @@ public:
 
 		std::vector<BlazingThread> threads;
 		for (int i = 0; i < table_scan_kernel_num_threads; i++) {
-			threads.push_back(BlazingThread([expression = this->expression, this]() {
+			threads.push_back(BlazingThread(ral::utilities::with_trace_query([this]() {
 
 				this->output_cache()->wait_if_cache_is_saturated();
 
 				std::unique_ptr<ral::frame::BlazingTable> batch;
 				while(batch = input.next()) {
 					try {
-						if(is_filtered_bindable_scan(expression)) {
-							auto columns = ral::processor::process_filter(batch->toBlazingTableView(), expression, this->context.get());
-							columns->setNames(fix_column_aliases(columns->names(), expression));
+						if(this->filter_program) {
+							auto columns = ral::processor::process_filter(batch->toBlazingTableView(), *(this->filter_program));
+							columns->setNames(this->apply_aliases(columns->names()));
 							this->add_to_output_cache(std::move(columns));
 						}
 						else{
-							batch->setNames(fix_column_aliases(batch->names(), expression));
+							batch->setNames(this->apply_aliases(batch->names()));
 							this->add_to_output_cache(std::move(batch));
 						}
 						
@@ -379,7 +914,7 @@ public:
 														"duration"_a="");
 					}
 				}
-			}));
+			})));
 		}
 		for (auto &&t : threads) {
 			t.join();
@@ -393,6 +928,11 @@ public:
 									"duration"_a=timer.elapsed_time(),
 									"kernel_id"_a=this->get_id());
 
+		log_runtime_filter_stats();
+		log_dictionary_pruning_stats();
+		log_page_index_pruning_stats();
+		log_late_materialization_stats();
+
 		return kstatus::proceed;
 	}
 
@@ -408,15 +948,83 @@ public:
 	}
 
 private:
+	void log_dictionary_pruning_stats() {
+		size_t row_groups_skipped = input.get_row_groups_skipped_by_dictionary();
+		if (row_groups_skipped == 0) {
+			return;
+		}
+		logger->debug("{query_id}|{step}|{substep}|{info}||kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="Dictionary pruning. row_groups_skipped: {}"_format(row_groups_skipped),
+									"kernel_id"_a=this->get_id());
+	}
+
+	void log_late_materialization_stats() {
+		size_t rows, rows_skipped;
+		std::tie(rows, rows_skipped) = input.get_late_materialization_stats();
+		if (rows == 0) {
+			return;
+		}
+		logger->debug("{query_id}|{step}|{substep}|{info}||kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="Late materialization. rows: {} rows_skipped: {}"_format(rows, rows_skipped),
+									"kernel_id"_a=this->get_id());
+	}
+
+	void log_page_index_pruning_stats() {
+		size_t rows_skipped = input.get_rows_skipped_by_page_index();
+		if (rows_skipped == 0) {
+			return;
+		}
+		logger->debug("{query_id}|{step}|{substep}|{info}||kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="Page index pruning. rows_skipped: {}"_format(rows_skipped),
+									"kernel_id"_a=this->get_id());
+	}
+
+	void log_runtime_filter_stats() {
+		size_t rows_scanned, rows_dropped, row_groups_skipped;
+		std::tie(rows_scanned, rows_dropped, row_groups_skipped) = input.get_runtime_filter_stats();
+		if (rows_scanned == 0 && row_groups_skipped == 0) {
+			return;
+		}
+		logger->debug("{query_id}|{step}|{substep}|{info}||kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="Runtime filters. rows_scanned: {} rows_dropped: {} row_groups_skipped: {}"_format(rows_scanned, rows_dropped, row_groups_skipped),
+									"kernel_id"_a=this->get_id());
+	}
+
+	// the aliases of the scan replace the names of the first columns, like fix_column_aliases does with the text of the scan
+	std::vector<std::string> apply_aliases(std::vector<std::string> names) const {
+		for (size_t i = 0; i < this->aliases.size() && i < names.size(); i++) {
+			names[i] = this->aliases[i];
+		}
+		return names;
+	}
+
 	DataSourceSequence input;
+	std::unique_ptr<ral::processor::expression_program> filter_program;
+	std::vector<size_t> projections;
+	std::vector<std::string> aliases;
 };
 
 class Projection : public kernel {
 public:
-	Projection(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-	: kernel(queryString, context)
+	Projection(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+	: kernel(plan.expr(), context), out_column_names(plan.aliases)
 	{
 		this->query_graph = query_graph;
+
+		// the expressions are parsed once here instead of for every batch
+		this->program = std::make_unique<ral::processor::expression_program>(plan.expressions);
 	}
 
 	bool can_you_throttle_my_input() {
@@ -433,7 +1041,7 @@ public:
 				this->output_cache()->wait_if_cache_is_saturated();
 
 				auto batch = input.next();
-				auto columns = ral::processor::process_project(std::move(batch), expression, context.get());
+				auto columns = ral::processor::process_project(std::move(batch), *(this->program), this->out_column_names);
 				this->add_to_output_cache(std::move(columns));
 				batch_count++;
 			} catch(const std::exception& e) {
@@ -459,15 +1067,18 @@ public:
 	}
 
 private:
-
+	std::unique_ptr<ral::processor::expression_program> program;
+	std::vector<std::string> out_column_names;
 };
 
 class Filter : public kernel {
 public:
-	Filter(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-	: kernel(queryString, context)
+	Filter(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+	: kernel(plan.expr(), context)
 	{
 		this->query_graph = query_graph;
+		this->condition_program = std::make_unique<ral::processor::expression_program>(
+			std::vector<std::string>{plan.condition});
 	}
 
 	bool can_you_throttle_my_input() {
@@ -484,7 +1095,7 @@ public:
 				this->output_cache()->wait_if_cache_is_saturated();
 
 				auto batch = input.next();
-				auto columns = ral::processor::process_filter(batch->toBlazingTableView(), expression, context.get());
+				auto columns = ral::processor::process_filter(batch->toBlazingTableView(), *(this->condition_program));
 				this->add_to_output_cache(std::move(columns));
 				batch_count++;
 			} catch(const std::exception& e) {
@@ -525,7 +1136,84 @@ public:
     }
 
 private:
+	std::unique_ptr<ral::processor::expression_program> condition_program;
+};
 
+/**
+ * A LogicalFilterProject, that is a Filter and a Project that the plan fused together. The condition and the
+ * projected expressions are evaluated by the same program on each batch, and only the projected columns are filtered,
+ * so the batch is not materialized and queued between a Filter kernel and a Projection kernel.
+ */
+class FilterProjection : public kernel {
+public:
+	FilterProjection(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+	: kernel(plan.expr(), context), out_column_names(plan.aliases)
+	{
+		this->query_graph = query_graph;
+
+		// the program evaluates the condition first and then the projected expressions
+		std::vector<std::string> expressions{plan.condition};
+		expressions.insert(expressions.end(), plan.expressions.begin(), plan.expressions.end());
+		this->program = std::make_unique<ral::processor::expression_program>(expressions);
+	}
+
+	bool can_you_throttle_my_input() {
+		return true;
+	}
+
+	virtual kstatus run() {
+		CodeTimer timer;
+
+		BatchSequence input(this->input_cache(), this);
+		int batch_count = 0;
+		while (input.wait_for_next()) {
+			try {
+				this->output_cache()->wait_if_cache_is_saturated();
+
+				auto batch = input.next();
+				auto columns = ral::processor::process_filter_project(std::move(batch), *(this->program), this->out_column_names);
+				this->add_to_output_cache(std::move(columns));
+				batch_count++;
+			} catch(const std::exception& e) {
+				// TODO add retry here
+				logger->error("{query_id}|{step}|{substep}|{info}|{duration}||||",
+											"query_id"_a=context->getContextToken(),
+											"step"_a=context->getQueryStep(),
+											"substep"_a=context->getQuerySubstep(),
+											"info"_a="In FilterProjection kernel batch {} for {}. What: {}"_format(batch_count, expression, e.what()),
+											"duration"_a="");
+			}
+		}
+
+		logger->debug("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}||",
+									"query_id"_a=context->getContextToken(),
+									"step"_a=context->getQueryStep(),
+									"substep"_a=context->getQuerySubstep(),
+									"info"_a="FilterProjection Kernel Completed",
+									"duration"_a=timer.elapsed_time(),
+									"kernel_id"_a=this->get_id());
+
+		return kstatus::proceed;
+	}
+
+	std::pair<bool, uint64_t> get_estimated_output_num_rows(){
+		std::pair<bool, uint64_t> total_in = this->query_graph->get_estimated_input_rows_to_kernel(this->kernel_id);
+		if (total_in.first){
+			double out_so_far = (double)this->output_.total_rows_added();
+			double in_so_far = (double)this->input_.total_rows_added();
+			if (in_so_far == 0){
+				return std::make_pair(false, 0);
+			} else {
+				return std::make_pair(true, (uint64_t)( ((double)total_in.second) *out_so_far/in_so_far) );
+			}
+		} else {
+			return std::make_pair(false, 0);
+		}
+	}
+
+private:
+	std::unique_ptr<ral::processor::expression_program> program;
+	std::vector<std::string> out_column_names;
 };
 
 class Print : public kernel {
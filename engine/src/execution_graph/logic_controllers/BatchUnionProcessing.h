@@ -23,8 +23,8 @@ using namespace fmt::literals;
 
 class UnionKernel : public kernel {
 public:
-	UnionKernel(const std::string & queryString, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
-		: kernel{queryString, context} {
+	UnionKernel(const ral::parser::plan_node & plan, std::shared_ptr<Context> context, std::shared_ptr<ral::cache::graph> query_graph)
+		: kernel{plan.expr(), context}, is_union_all(plan.argument("all") == "true") {
         this->query_graph = query_graph;
         this->input_.add_port("input_a", "input_b");
 	}
@@ -36,8 +36,7 @@ public:
 	virtual kstatus run() {
 		CodeTimer timer;
 
-        bool isUnionAll = (get_named_expression(this->expression, "all") == "true");
-        RAL_EXPECTS(isUnionAll, "In UnionKernel: UNION is not supported, use UNION ALL");
+        RAL_EXPECTS(this->is_union_all, "In UnionKernel: UNION is not supported, use UNION ALL");
 
         BatchSequenceBypass input_a(this->input_.get_cache("input_a"));
         BatchSequenceBypass input_b(this->input_.get_cache("input_b"));
@@ -74,7 +73,7 @@ public:
 	}
 
 private:
-
+	bool is_union_all;
 };
 
 } // namespace batch
@@ -3,6 +3,7 @@
 #include <random>
 #include <src/utilities/CommonOperations.h>
 #include <src/utilities/DebuggingUtils.h>
+#include <blazingdb/transport/FlowControl.h>
 
 namespace ral {
 namespace cache {
@@ -62,13 +63,23 @@ CacheMachine::CacheMachine()
 	this->memory_resources.push_back( &blazing_host_memory_mesource::getInstance() ); 
 	this->memory_resources.push_back( &blazing_disk_memory_resource::getInstance() );
 	this->num_bytes_added = 0;
+	this->host_bytes_count = 0;
 	this->num_rows_added = 0;
+	this->num_batches_added = 0;
+	this->num_batches_pulled = 0;
+	this->num_rows_pulled = 0;
+	this->num_bytes_pulled = 0;
+	this->saturated_wait_ns = 0;
+	this->next_wait_ns = 0;
+	this->num_batches_to_host = 0;
+	this->num_batches_to_disk = 0;
 	this->flow_control_batches_threshold = std::numeric_limits<std::uint32_t>::max();
 	this->flow_control_bytes_threshold = std::numeric_limits<std::size_t>::max();
 	this->flow_control_batches_count = 0;
 	this->flow_control_bytes_count = 0;
 
 	logger = spdlog::get("batch_logger");
+	something_added = false;
 }
 
 CacheMachine::CacheMachine(std::uint32_t flow_control_batches_threshold, std::size_t flow_control_bytes_threshold)
@@ -78,7 +89,16 @@ CacheMachine::CacheMachine(std::uint32_t flow_control_batches_threshold, std::si
 	this->memory_resources.push_back( &blazing_host_memory_mesource::getInstance() ); 
 	this->memory_resources.push_back( &blazing_disk_memory_resource::getInstance() );
 	this->num_bytes_added = 0;
+	this->host_bytes_count = 0;
 	this->num_rows_added = 0;
+	this->num_batches_added = 0;
+	this->num_batches_pulled = 0;
+	this->num_rows_pulled = 0;
+	this->num_bytes_pulled = 0;
+	this->saturated_wait_ns = 0;
+	this->next_wait_ns = 0;
+	this->num_batches_to_host = 0;
+	this->num_batches_to_disk = 0;
 	this->flow_control_batches_threshold = flow_control_batches_threshold;
 	this->flow_control_bytes_threshold = flow_control_bytes_threshold;
 	this->flow_control_batches_count = 0;
@@ -107,6 +127,32 @@ uint64_t CacheMachine::get_num_rows_added(){
 	return num_rows_added.load();
 }
 
+cache_profile CacheMachine::get_profile() const {
+	cache_profile profile;
+	profile.batches_added = num_batches_added.load();
+	profile.rows_added = num_rows_added.load();
+	profile.bytes_added = num_bytes_added.load();
+	profile.batches_pulled = num_batches_pulled.load();
+	profile.rows_pulled = num_rows_pulled.load();
+	profile.bytes_pulled = num_bytes_pulled.load();
+	profile.saturated_wait_ns = saturated_wait_ns.load();
+	profile.next_wait_ns = next_wait_ns.load();
+	profile.batches_to_host = num_batches_to_host.load();
+	profile.batches_to_disk = num_batches_to_disk.load();
+	return profile;
+}
+
+std::unique_ptr<message> CacheMachine::pop_or_wait() {
+	ral::utilities::trace_span span("cache", "pop_or_wait");
+	auto start = std::chrono::steady_clock::now();
+	std::unique_ptr<message> message_data = waitingCache->pop_or_wait();
+	add_wait_time(next_wait_ns, start);
+	if (message_data) {
+		count_host_bytes(*message_data, false);
+	}
+	return message_data;
+}
+
 void CacheMachine::addHostFrameToCache(std::unique_ptr<ral::frame::BlazingHostTable> host_table, const std::string & message_id, Context * ctx) {
 	
 	// we dont want to add empty tables to a cache, unless we have never added anything
@@ -125,10 +171,31 @@ void CacheMachine::addHostFrameToCache(std::unique_ptr<ral::frame::BlazingHostTa
 		flow_control_bytes_count += host_table->sizeInBytes();
 		lock.unlock();
 
+		num_batches_added++;
 		num_rows_added += host_table->num_rows();
 		num_bytes_added += host_table->sizeInBytes();
-		auto cache_data = std::make_unique<CPUCacheData>(std::move(host_table));
-		auto item =	std::make_unique<message>(std::move(cache_data), message_id);
+
+		std::size_t max_host_bytes = ctx ? blazingdb::transport::getFlowControlCreditsPerSender() * (ctx->getTotalNodes() - 1) : 0;
+		std::unique_ptr<message> item;
+		if (max_host_bytes > 0 && host_bytes_count + host_table->sizeInBytes() > max_host_bytes) {
+			logger->trace("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}|rows|{rows}",
+										"query_id"_a=std::to_string(ctx->getContextToken()),
+										"step"_a=std::to_string(ctx->getQueryStep()),
+										"substep"_a=std::to_string(ctx->getQuerySubstep()),
+										"info"_a="Add to CacheMachine received batch into Disk cache",
+										"duration"_a="",
+										"kernel_id"_a=message_id,
+										"rows"_a=host_table->num_rows());
+
+			num_batches_to_disk++;
+			ral::utilities::trace_instant("cache", "spill_to_disk", ctx->getContextToken(), "bytes", host_table->sizeInBytes());
+			auto cache_data = std::make_unique<CacheDataLocalFile>(ral::communication::messages::deserialize_from_cpu(host_table.get()));
+			item = std::make_unique<message>(std::move(cache_data), message_id);
+		} else {
+			auto cache_data = std::make_unique<CPUCacheData>(std::move(host_table));
+			item = std::make_unique<message>(std::move(cache_data), message_id);
+			count_host_bytes(*item, true);
+		}
 		this->waitingCache->put(std::move(item));
 		this->something_added = true;
 	}
@@ -155,6 +222,7 @@ void CacheMachine::addCacheData(std::unique_ptr<ral::cache::CacheData> cache_dat
 		flow_control_bytes_count += cache_data->sizeInBytes();
 		lock.unlock();
 
+		num_batches_added++;
 		num_rows_added += cache_data->num_rows();
 		num_bytes_added += cache_data->sizeInBytes();
 		int cacheIndex = 0;
@@ -184,7 +252,11 @@ void CacheMachine::addCacheData(std::unique_ptr<ral::cache::CacheData> cache_dat
 							"kernel_id"_a=message_id,
 							"rows"_a=cache_data->num_rows());
 			
+						num_batches_to_host++;
+						ral::utilities::trace_instant("cache", "spill_to_host", ctx ? ctx->getContextToken() : ral::utilities::NO_TRACE_QUERY,
+							"bytes", cache_data->sizeInBytes());
 						auto item = std::make_unique<message>(std::move(cache_data), message_id);
+						count_host_bytes(*item, true);
 						this->waitingCache->put(std::move(item));
 					} else if(cacheIndex == 2) {
 						logger->trace("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}|rows|{rows}",
@@ -197,6 +269,9 @@ void CacheMachine::addCacheData(std::unique_ptr<ral::cache::CacheData> cache_dat
 							"rows"_a=cache_data->num_rows());
 
 						// BlazingMutableThread t([cache_data = std::move(cache_data), this, cacheIndex, message_id]() mutable {
+						num_batches_to_disk++;
+						ral::utilities::trace_instant("cache", "spill_to_disk", ctx ? ctx->getContextToken() : ral::utilities::NO_TRACE_QUERY,
+							"bytes", cache_data->sizeInBytes());
 						auto item = std::make_unique<message>(std::move(cache_data), message_id);
 						this->waitingCache->put(std::move(item));
 						// NOTE: Wait don't kill the main process until the last thread is finished!
@@ -233,6 +308,7 @@ void CacheMachine::addToCache(std::unique_ptr<ral::frame::BlazingTable> table, c
 		flow_control_bytes_count += table->sizeInBytes();
 		lock.unlock();
 		
+		num_batches_added++;
 		num_rows_added += table->num_rows();
 		num_bytes_added += table->sizeInBytes();
 		int cacheIndex = 0;
@@ -269,8 +345,12 @@ void CacheMachine::addToCache(std::unique_ptr<ral::frame::BlazingTable> table, c
 							"kernel_id"_a=message_id,
 							"rows"_a=table->num_rows());
 
+						num_batches_to_host++;
+						ral::utilities::trace_instant("cache", "spill_to_host", ctx ? ctx->getContextToken() : ral::utilities::NO_TRACE_QUERY,
+							"bytes", table->sizeInBytes());
 						auto cache_data = std::make_unique<CPUCacheData>(std::move(table));
 						auto item =	std::make_unique<message>(std::move(cache_data), message_id);
+						count_host_bytes(*item, true);
 						this->waitingCache->put(std::move(item));
 					} else if(cacheIndex == 2) {
 						logger->trace("{query_id}|{step}|{substep}|{info}|{duration}|kernel_id|{kernel_id}|rows|{rows}",
@@ -283,6 +363,9 @@ void CacheMachine::addToCache(std::unique_ptr<ral::frame::BlazingTable> table, c
 							"rows"_a=table->num_rows());
 
 						// BlazingMutableThread t([table = std::move(table), this, cacheIndex, message_id]() mutable {
+						num_batches_to_disk++;
+						ral::utilities::trace_instant("cache", "spill_to_disk", ctx ? ctx->getContextToken() : ral::utilities::NO_TRACE_QUERY,
+							"bytes", table->sizeInBytes());
 						auto cache_data = std::make_unique<CacheDataLocalFile>(std::move(table));
 						auto item =	std::make_unique<message>(std::move(cache_data), message_id);
 						this->waitingCache->put(std::move(item));
@@ -304,12 +387,17 @@ void CacheMachine::wait_until_finished() {
 
 
 std::unique_ptr<ral::frame::BlazingTable> CacheMachine::get_or_wait(size_t index) {
+	ral::utilities::trace_span span("cache", "get_or_wait");
+	auto start = std::chrono::steady_clock::now();
 	std::unique_ptr<message> message_data = waitingCache->get_or_wait(std::to_string(index));
+	add_wait_time(next_wait_ns, start);
 	if (message_data == nullptr) {
 		return nullptr;
 	}
+	count_host_bytes(*message_data, false);
 	
 	std::unique_ptr<ral::frame::BlazingTable> output = message_data->get_data().decache();
+	add_pulled(output->num_rows(), output->sizeInBytes());
 	std::unique_lock<std::mutex> lock(flow_control_mutex);
 	flow_control_batches_count--;
 	flow_control_bytes_count -= output->sizeInBytes();
@@ -318,7 +406,7 @@ std::unique_ptr<ral::frame::BlazingTable> CacheMachine::get_or_wait(size_t index
 }
 
 std::unique_ptr<ral::frame::BlazingTable> CacheMachine::pullFromCache(Context * ctx) {
-	std::unique_ptr<message> message_data = waitingCache->pop_or_wait();
+	std::unique_ptr<message> message_data = pop_or_wait();
 	if (message_data == nullptr) {
 		return nullptr;
 	}
@@ -333,6 +421,7 @@ std::unique_ptr<ral::frame::BlazingTable> CacheMachine::pullFromCache(Context *
 								"rows"_a=message_data->get_data().num_rows());
 
 	std::unique_ptr<ral::frame::BlazingTable> output = message_data->get_data().decache();
+	add_pulled(output->num_rows(), output->sizeInBytes());
 	std::unique_lock<std::mutex> lock(flow_control_mutex);
 	flow_control_batches_count--;
 	flow_control_bytes_count -= output->sizeInBytes();
@@ -341,7 +430,7 @@ std::unique_ptr<ral::frame::BlazingTable> CacheMachine::pullFromCache(Context *
 }
 
 std::unique_ptr<ral::cache::CacheData> CacheMachine::pullCacheData(Context * ctx) {
-	std::unique_ptr<message> message_data = waitingCache->pop_or_wait();
+	std::unique_ptr<message> message_data = pop_or_wait();
 	if (message_data == nullptr) {
 		return nullptr;
 	}
@@ -356,6 +445,7 @@ std::unique_ptr<ral::cache::CacheData> CacheMachine::pullCacheData(Context * ctx
 								"rows"_a=message_data->get_data().num_rows());
 
 	std::unique_ptr<ral::cache::CacheData> output = message_data->release_data();
+	add_pulled(output->num_rows(), output->sizeInBytes());
 	std::unique_lock<std::mutex> lock(flow_control_mutex);
 	flow_control_batches_count--;
 	flow_control_bytes_count -= output->sizeInBytes();
@@ -370,11 +460,13 @@ bool CacheMachine::thresholds_are_met(std::uint32_t batches_count, std::size_t b
 }
 
 void CacheMachine::wait_if_cache_is_saturated() {
-
+	ral::utilities::trace_span span("cache", "wait_if_cache_is_saturated");
+	auto start = std::chrono::steady_clock::now();
 	std::unique_lock<std::mutex> lock(flow_control_mutex);
 	flow_control_condition_variable.wait(lock, [&, this] { 
 		return !thresholds_are_met(flow_control_batches_count, flow_control_bytes_count);
 	});
+	add_wait_time(saturated_wait_ns, start);
 }
 
 
@@ -400,10 +492,11 @@ std::unique_ptr<ral::frame::BlazingTable> ConcatenatingCacheMachine::pullFromCac
 	std::vector<std::unique_ptr<message>> collected_messages;
 	std::unique_ptr<message> message_data;
 	std::string message_id = "";
-	while (message_data = waitingCache->pop_or_wait())
+	while (message_data = pop_or_wait())
 	{
 		auto& cache_data = message_data->get_data();
 		if (collected_messages.empty() || !thresholds_are_met(1 + collected_messages.size(), total_bytes + cache_data.sizeInBytes())) {
+			add_pulled(cache_data.num_rows(), cache_data.sizeInBytes());
 			total_bytes += cache_data.sizeInBytes();
 			message_id = message_data->get_message_id();
 			collected_messages.push_back(std::move(message_data));
@@ -414,6 +507,7 @@ std::unique_ptr<ral::frame::BlazingTable> ConcatenatingCacheMachine::pullFromCac
 			flow_control_bytes_count -= cache_data.sizeInBytes();
 			flow_control_condition_variable.notify_all();
 		} else {
+			count_host_bytes(*message_data, true);
 			waitingCache->put(std::move(message_data));
 			break;
 		}
@@ -5,8 +5,10 @@
 #include "execution_graph/logic_controllers/BlazingColumn.h"
 #include "execution_graph/logic_controllers/BlazingColumnOwner.h"
 #include "execution_graph/logic_controllers/BlazingColumnView.h"
+#include <algorithm>
 #include <atomic>
 #include <blazingdb/manager/Context.h>
+#include <chrono>
 #include <cudf/io/functions.hpp>
 #include <future>
 #include <memory>
@@ -20,6 +22,7 @@
 #include <limits>
 #include <bmr/BlazingMemoryResource.h>
 #include <spdlog/spdlog.h>
+#include "utilities/Tracing.h"
 
 namespace ral {
 namespace cache {
@@ -27,6 +30,9 @@ namespace cache {
 using Context = blazingdb::manager::Context;
 using namespace fmt::literals;
 
+/// \brief A random string of letters and digits, i.e. for the names of the files that the data is spilled to
+std::string randomString(std::size_t length);
+
 /// \brief An enum type to represent the cache level ID
 enum class CacheDataType { GPU, CPU, LOCAL_FILE };
 
@@ -265,6 +271,21 @@ private:
 	std::atomic<bool> finished;
 	std::condition_variable condition_variable_;
 };
+/// \brief The counters of a CacheMachine for the execution profile of its query.
+/// The kernel that adds to the cache waits while it is saturated, the one that pulls from it waits for its batches
+struct cache_profile {
+	uint64_t batches_added = 0;
+	uint64_t rows_added = 0;
+	uint64_t bytes_added = 0;
+	uint64_t batches_pulled = 0;
+	uint64_t rows_pulled = 0;
+	uint64_t bytes_pulled = 0;
+	int64_t saturated_wait_ns = 0;
+	int64_t next_wait_ns = 0;
+	uint64_t batches_to_host = 0;
+	uint64_t batches_to_disk = 0;
+};
+
 /**
 	@brief A class that represents a Cache Machine on a
 	multi-tier (GPU memory, CPU memory, Disk memory) cache system. 
@@ -287,6 +308,9 @@ public:
 
 	virtual void addCacheData(std::unique_ptr<ral::cache::CacheData> cache_data, const std::string & message_id = "", Context * ctx = nullptr);
 
+	/// Adds a batch that another node sent. When the flow control is enabled, the batches that would take the host memory
+	/// of the cache over the credits of all the senders are written to disk, so that what a node receives stays bounded
+	/// until the next kernel pulls it, even when that kernel waits for all of its input first
 	virtual void addHostFrameToCache(std::unique_ptr<ral::frame::BlazingHostTable> table, const std::string & message_id = "", Context * ctx = nullptr);
 
 	virtual void finish();
@@ -300,7 +324,11 @@ public:
 	void wait_until_finished();
 
 	bool wait_for_next() {
-		return this->waitingCache->wait_for_next();
+		ral::utilities::trace_span span("cache", "wait_for_next");
+		auto start = std::chrono::steady_clock::now();
+		bool has_next = this->waitingCache->wait_for_next();
+		add_wait_time(next_wait_ns, start);
+		return has_next;
 	}
 	
 	bool has_next_now() {
@@ -314,8 +342,34 @@ public:
 	
 	virtual void wait_if_cache_is_saturated();
 
+	cache_profile get_profile() const;
+
 
 protected:
+	static void add_wait_time(std::atomic<int64_t> & wait_ns, std::chrono::steady_clock::time_point start) {
+		wait_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/// Pops the next message of the waiting queue, counting the time it waited for it
+	std::unique_ptr<message> pop_or_wait();
+
+	/// Counts the bytes of the batches of the cache that are in host memory, which addHostFrameToCache bounds
+	void count_host_bytes(const message & item, bool added) {
+		if (item.get_data().get_type() == CacheDataType::CPU) {
+			if (added) {
+				host_bytes_count += item.get_data().sizeInBytes();
+			} else {
+				host_bytes_count -= std::min<std::size_t>(host_bytes_count, item.get_data().sizeInBytes());
+			}
+		}
+	}
+
+	void add_pulled(size_t num_rows, size_t num_bytes) {
+		num_batches_pulled++;
+		num_rows_pulled += num_rows;
+		num_bytes_pulled += num_bytes;
+	}
+
 	/// This property represents a waiting queue object which stores all CacheData Objects  
 	std::unique_ptr<WaitingQueue> waitingCache;
 
@@ -323,6 +377,16 @@ protected:
 	std::vector<BlazingMemoryResource*> memory_resources;
 	std::atomic<std::size_t> num_bytes_added;
 	std::atomic<uint64_t> num_rows_added;
+	/// The counters of the profile of the cache
+	std::atomic<uint64_t> num_batches_added;
+	std::atomic<uint64_t> num_batches_pulled;
+	std::atomic<uint64_t> num_rows_pulled;
+	std::atomic<uint64_t> num_bytes_pulled;
+	std::atomic<int64_t> saturated_wait_ns;
+	std::atomic<int64_t> next_wait_ns;
+	std::atomic<uint64_t> num_batches_to_host;
+	std::atomic<uint64_t> num_batches_to_disk;
+	std::atomic<std::size_t> host_bytes_count;
 	/// This variable is to keep track of if anything has been added to the cache. Its useful to keep from adding empty tables to the cache, where we might want an empty table at least to know the schema
 	bool something_added;
 
@@ -344,7 +408,9 @@ protected:
 */ 
 class HostCacheMachine {
 public:
-	HostCacheMachine() {
+	// max_bytes bounds the bytes of the batches that were added and not pulled yet, see wait_if_cache_is_saturated. Zero
+	// does not bound them
+	HostCacheMachine(std::size_t max_bytes = 0) : max_bytes(max_bytes), bytes_count(0) {
 		waitingCache = std::make_unique<WaitingQueue>();
     	logger = spdlog::get("batch_logger");
 		something_added = false;
@@ -364,6 +430,10 @@ public:
 										"kernel_id"_a=message_id,
 										"rows"_a=host_table->num_rows());
 
+			std::unique_lock<std::mutex> lock(flow_control_mutex);
+			bytes_count += host_table->sizeInBytes();
+			lock.unlock();
+
 			auto cache_data = std::make_unique<CPUCacheData>(std::move(host_table));
 			auto item = std::make_unique<message>(std::move(cache_data), message_id);
 			this->waitingCache->put(std::move(item));
@@ -371,6 +441,18 @@ public:
 		}
 	}
 
+	// Blocks while the batches that were added and not pulled yet take max_bytes or more
+	void wait_if_cache_is_saturated() {
+		ral::utilities::trace_span span("cache", "wait_if_cache_is_saturated");
+		std::unique_lock<std::mutex> lock(flow_control_mutex);
+		flow_control_condition_variable.wait(lock, [this] { return max_bytes == 0 || bytes_count < max_bytes; });
+	}
+
+	std::size_t get_num_bytes_in_cache() {
+		std::lock_guard<std::mutex> lock(flow_control_mutex);
+		return bytes_count;
+	}
+
 	virtual void finish() {
 		this->waitingCache->finish();
 	}
@@ -388,6 +470,7 @@ public:
 	} 
 	
 	virtual std::unique_ptr<ral::frame::BlazingHostTable> pullFromCache(Context * ctx = nullptr) {
+		ral::utilities::trace_span span("cache", "pop_or_wait", ctx ? ctx->getContextToken() : ral::utilities::NO_TRACE_QUERY);
 		std::unique_ptr<message> message_data = waitingCache->pop_or_wait();
 		if (message_data == nullptr) {
 			return nullptr;
@@ -404,12 +487,22 @@ public:
 									"kernel_id"_a=message_data->get_message_id(),
 									"rows"_a=message_data->get_data().num_rows());
     
-		return static_cast<CPUCacheData&>(message_data->get_data()).releaseHostTable();
+		std::unique_ptr<ral::frame::BlazingHostTable> host_table = static_cast<CPUCacheData&>(message_data->get_data()).releaseHostTable();
+		std::unique_lock<std::mutex> lock(flow_control_mutex);
+		bytes_count -= std::min(bytes_count, host_table->sizeInBytes());
+		lock.unlock();
+		flow_control_condition_variable.notify_all();
+		return host_table;
 	}
 	
 protected:
 	std::unique_ptr<WaitingQueue> waitingCache;
 
+	std::size_t max_bytes;
+	std::size_t bytes_count;
+	std::mutex flow_control_mutex;
+	std::condition_variable flow_control_condition_variable;
+
   std::shared_ptr<spdlog::logger> logger;
   bool something_added;
 };
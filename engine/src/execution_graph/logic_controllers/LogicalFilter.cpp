@@ -45,6 +45,14 @@ std::unique_ptr<ral::frame::BlazingTable> applyBooleanFilter(
     filteredTable),table.names());
 }
 
+std::string get_filter_condition(const std::string & query_part) {
+  std::string conditional_expression = get_named_expression(query_part, "condition");
+	if(conditional_expression.empty()) {
+		conditional_expression = get_named_expression(query_part, "filters");
+	}
+  return conditional_expression;
+}
+
 std::unique_ptr<ral::frame::BlazingTable> process_filter(
   const ral::frame::BlazingTableView & table_view,
   const std::string & query_part,
@@ -53,19 +61,45 @@ std::unique_ptr<ral::frame::BlazingTable> process_filter(
 	if(table_view.num_rows() == 0) {
 		return std::make_unique<ral::frame::BlazingTable>(cudf::experimental::empty_like(table_view.view()), table_view.names());
 	}
-	
-  std::string conditional_expression = get_named_expression(query_part, "condition");
-	if(conditional_expression.empty()) {
-		conditional_expression = get_named_expression(query_part, "filters");
+
+  expression_program condition_program({get_filter_condition(query_part)});
+  return process_filter(table_view, condition_program);
+}
+
+std::unique_ptr<ral::frame::BlazingTable> process_filter(
+  const ral::frame::BlazingTableView & table_view,
+  expression_program & condition_program) {
+
+	if(table_view.num_rows() == 0) {
+		return std::make_unique<ral::frame::BlazingTable>(cudf::experimental::empty_like(table_view.view()), table_view.names());
 	}
 
-  std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluated_table = evaluate_expressions(table_view.toBlazingColumns(), {conditional_expression});
+  std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluated_table = condition_program.evaluate(table_view.toBlazingColumns());
 
   RAL_EXPECTS(evaluated_table.size() == 1 && evaluated_table[0]->view().type().id() == cudf::type_id::BOOL8, "Expression does not evaluate to a boolean mask");
 
   return applyBooleanFilter(table_view, evaluated_table[0]->view());
 }
 
+std::unique_ptr<ral::frame::BlazingTable> process_filter_project(
+  std::unique_ptr<ral::frame::BlazingTable> table,
+  expression_program & program,
+  const std::vector<std::string> & out_column_names) {
+
+  cudf::size_type num_rows = table->num_rows();
+  std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluated_table = program.evaluate(table->releaseBlazingColumns());
+
+  RAL_EXPECTS(evaluated_table.size() == out_column_names.size() + 1 && evaluated_table[0]->view().type().id() == cudf::type_id::BOOL8, "Expression does not evaluate to a boolean mask");
+
+  std::unique_ptr<ral::frame::BlazingColumn> condition = std::move(evaluated_table[0]);
+  evaluated_table.erase(evaluated_table.begin());
+  auto projected = std::make_unique<ral::frame::BlazingTable>(std::move(evaluated_table), out_column_names);
+  if(num_rows == 0) {
+    return projected;
+  }
+  return applyBooleanFilter(projected->toBlazingTableView(), condition->view());
+}
+
 
   namespace{
     typedef std::pair<blazingdb::transport::Node, std::unique_ptr<ral::frame::BlazingTable> > NodeColumn;
@@ -8,6 +8,8 @@ namespace ral{
 
 namespace processor{
 
+class expression_program;
+
 bool is_logical_filter(const std::string & query_part);
 
 /**
@@ -17,11 +19,30 @@ std::unique_ptr<ral::frame::BlazingTable> applyBooleanFilter(
   const ral::frame::BlazingTableView & table,
   const CudfColumnView & boolValues);
 
+// Returns the condition of a LogicalFilter, or the filters of a BindableTableScan
+std::string get_filter_condition(const std::string & query_part);
+
 std::unique_ptr<ral::frame::BlazingTable> process_filter(
   const ral::frame::BlazingTableView & table,
   const std::string & query_part,
   blazingdb::manager::Context * context);
 
+/**
+Same as above, with the condition already compiled into an expression_program
+*/
+std::unique_ptr<ral::frame::BlazingTable> process_filter(
+  const ral::frame::BlazingTableView & table,
+  expression_program & condition_program);
+
+/**
+A filter and a project in one pass. The first expression of the program is the condition and the others are the
+projected columns, all of them over the columns of the table. Only the projected columns are filtered
+*/
+std::unique_ptr<ral::frame::BlazingTable> process_filter_project(
+  std::unique_ptr<ral::frame::BlazingTable> table,
+  expression_program & program,
+  const std::vector<std::string> & out_column_names);
+
 bool check_if_has_nulls(CudfTableView const& input, std::vector<cudf::size_type> const& keys);
 
 void parseJoinConditionToColumnIndices(const std::string & condition, std::vector<int> & columnIndices);
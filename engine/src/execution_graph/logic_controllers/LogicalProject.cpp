@@ -404,41 +404,67 @@ private:
 };
 
 
-std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate_expressions(
-    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> blazing_columns,
-    const std::vector<std::string> & expressions) {
+struct expression_program::interpreter_program {
+    enum class expression_kind { INTERPRETER, LITERAL, COLUMN };
+
+    // per expression
+    std::vector<expression_kind> kinds;
+    std::vector<cudf::type_id> output_types;
+    std::vector<std::unique_ptr<cudf::scalar>> literal_scalars;
+    std::vector<std::string> string_literals;
+    std::vector<cudf::size_type> column_indices;
+
+    // the inputs of the interpreter are the used input columns followed by the computed columns that are not outputs
+    std::vector<cudf::size_type> input_col_indices;
+    std::vector<cudf::size_type> interpreter_computed_indices;
+
+    std::vector<interops::column_index_type> left_inputs;
+    std::vector<interops::column_index_type> right_inputs;
+    std::vector<interops::column_index_type> outputs;
+    std::vector<interops::column_index_type> final_output_positions;
+    std::vector<interops::operator_type> operators;
+    std::vector<std::unique_ptr<cudf::scalar>> left_scalars;
+    std::vector<std::unique_ptr<cudf::scalar>> right_scalars;
+
+    // true when string functions were computed while planning, the plan then refers to columns of that batch only
+    bool depends_on_data = false;
+};
+
+namespace {
+
+std::string parse_expression(const std::string & expression) {
+    parser::parse_tree parse_tree;
+    parse_tree.build(replace_calcite_regex(expression));
+    parse_tree.transform_to_custom_op();
+    return parse_tree.rebuildExpression();
+}
+
+// Plans the expressions for the schema of the table. The string functions are computed here, into the evaluator.
+std::unique_ptr<expression_program::interpreter_program> plan_expressions(const cudf::table_view & table,
+    const std::vector<std::string> & parsed_expressions,
+    function_evaluator_transformer & evaluator) {
+    using expression_kind = expression_program::interpreter_program::expression_kind;
     using interops::column_index_type;
 
-    std::vector<CudfColumnView> cudf_column_views_in(blazing_columns.size());
-    std::transform(blazing_columns.begin(), blazing_columns.end(), cudf_column_views_in.begin(), [](auto & col){
-        return col->view();
-    });
-    cudf::table_view table(cudf_column_views_in);
-    
-    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> out_columns(expressions.size());
-    
-    std::vector<bool> column_used(table.num_columns(), false);
-    std::vector<std::pair<int, int>> out_idx_computed_idx_pair;
-    std::vector<std::pair<int, int>> out_idx_input_idx_pair;
+    auto program = std::make_unique<expression_program::interpreter_program>();
+    program->kinds.resize(parsed_expressions.size());
+    program->output_types.resize(parsed_expressions.size(), cudf::type_id::EMPTY);
+    program->literal_scalars.resize(parsed_expressions.size());
+    program->string_literals.resize(parsed_expressions.size());
+    program->column_indices.resize(parsed_expressions.size(), -1);
 
+    std::vector<bool> column_used(table.num_columns(), false);
     std::vector<std::vector<std::string>> tokenized_expression_vector;
-    std::vector<cudf::mutable_column_view> interpreter_out_column_views;
 
-    function_evaluator_transformer evaluator{table};
-    for(size_t i = 0; i < expressions.size(); i++){
-        std::string expression = replace_calcite_regex(expressions[i]);
+    for(size_t i = 0; i < parsed_expressions.size(); i++){
         parser::parse_tree parse_tree;
-        parse_tree.build(expression);
-        parse_tree.transform_to_custom_op();
+        parse_tree.build(parsed_expressions[i]);
         parse_tree.transform(evaluator);
-        expression = parse_tree.rebuildExpression();
+        std::string expression = parse_tree.rebuildExpression();
 
         if(contains_evaluation(expression)){
-            cudf::type_id expr_out_type = get_output_type_expression(cudf::table_view{{table, evaluator.computed_columns_view()}}, expression);
-            
-            auto new_column = cudf::make_fixed_width_column(cudf::data_type{expr_out_type}, table.num_rows(), cudf::mask_state::UNINITIALIZED);
-            interpreter_out_column_views.push_back(new_column->mutable_view());
-            out_columns[i] = std::make_unique<ral::frame::BlazingColumnOwner>(std::move(new_column));
+            program->kinds[i] = expression_kind::INTERPRETER;
+            program->output_types[i] = get_output_type_expression(cudf::table_view{{table, evaluator.computed_columns_view()}}, expression);
 
             std::string cleaned_expression = clean_calcite_expression(expression);
             std::vector<std::string> tokens = get_tokens_in_reverse_order(cleaned_expression);
@@ -455,23 +481,100 @@ std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate_expressions(
                 }
             }
         } else if (is_literal(expression)) {
-            cudf::type_id col_type = infer_dtype_from_literal(expression);
-            if(col_type == cudf::type_id::STRING){
-                std::string scalar_str = expression.substr(1, expression.length() - 2);
-                out_columns[i] = std::make_unique<ral::frame::BlazingColumnOwner>(ral::utilities::make_string_column_from_scalar(scalar_str, table.num_rows()));
+            program->kinds[i] = expression_kind::LITERAL;
+            program->output_types[i] = infer_dtype_from_literal(expression);
+            if(program->output_types[i] == cudf::type_id::STRING){
+                program->string_literals[i] = expression.substr(1, expression.length() - 2);
             } else {
-                std::unique_ptr<CudfColumn> fixed_with_col = cudf::make_fixed_width_column(cudf::data_type{col_type}, table.num_rows());
-                std::unique_ptr<cudf::scalar> literal_scalar = get_scalar_from_string(expression);
-                RAL_EXPECTS(!!literal_scalar, "NULL literal not supported in projection");
-                
+                program->literal_scalars[i] = get_scalar_from_string(expression);
+                RAL_EXPECTS(!!program->literal_scalars[i], "NULL literal not supported in projection");
+            }
+        } else {
+            program->kinds[i] = expression_kind::COLUMN;
+            program->column_indices[i] = get_index(expression);
+        }
+    }
+
+    cudf::table_view computed_columns_view = evaluator.computed_columns_view();
+    program->depends_on_data = computed_columns_view.num_columns() > 0;
+
+    // Get the needed columns indices in order and keep track of the mapped indices
+    std::map<column_index_type, column_index_type> col_idx_map;
+    for(size_t i = 0; i < column_used.size(); i++) {
+        if(column_used[i]) {
+            col_idx_map.insert({i, col_idx_map.size()});
+            program->input_col_indices.push_back(i);
+        }
+    }
+
+    // the computed columns that are outputs are moved there, the rest of them are inputs of the interpreter
+    std::vector<bool> computed_is_output(computed_columns_view.num_columns(), false);
+    for(size_t i = 0; i < parsed_expressions.size(); i++){
+        if (program->kinds[i] == expression_kind::COLUMN && program->column_indices[i] >= table.num_columns()) {
+            computed_is_output[program->column_indices[i] - table.num_columns()] = true;
+        }
+    }
+    std::vector<cudf::column_view> interpreter_computed_views;
+    for(cudf::size_type i = 0; i < computed_columns_view.num_columns(); i++) {
+        if(!computed_is_output[i]) {
+            col_idx_map.insert({table.num_columns() + i, col_idx_map.size()});
+            program->interpreter_computed_indices.push_back(i);
+            interpreter_computed_views.push_back(computed_columns_view.column(i));
+        }
+    }
+
+    cudf::table_view interops_input_table{{table.select(program->input_col_indices), cudf::table_view{interpreter_computed_views}}};
+
+    for (size_t i = 0; i < tokenized_expression_vector.size(); i++) {
+        program->final_output_positions.push_back(interops_input_table.num_columns() + i);
+
+        interops::add_expression_to_interpreter_plan(tokenized_expression_vector[i],
+                                                    interops_input_table,
+                                                    col_idx_map,
+                                                    i,
+                                                    tokenized_expression_vector.size(),
+                                                    program->left_inputs,
+                                                    program->right_inputs,
+                                                    program->outputs,
+                                                    program->operators,
+                                                    program->left_scalars,
+                                                    program->right_scalars);
+    }
+
+    return program;
+}
+
+std::vector<std::unique_ptr<ral::frame::BlazingColumn>> run_interpreter_program(
+    const expression_program::interpreter_program & program,
+    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> blazing_columns,
+    const cudf::table_view & table,
+    std::vector<std::unique_ptr<cudf::column>> computed_columns) {
+    using expression_kind = expression_program::interpreter_program::expression_kind;
+
+    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> out_columns(program.kinds.size());
+
+    std::vector<std::pair<int, int>> out_idx_computed_idx_pair;
+    std::vector<std::pair<int, int>> out_idx_input_idx_pair;
+    std::vector<cudf::mutable_column_view> interpreter_out_column_views;
+
+    for(size_t i = 0; i < program.kinds.size(); i++){
+        if(program.kinds[i] == expression_kind::INTERPRETER){
+            auto new_column = cudf::make_fixed_width_column(cudf::data_type{program.output_types[i]}, table.num_rows(), cudf::mask_state::UNINITIALIZED);
+            interpreter_out_column_views.push_back(new_column->mutable_view());
+            out_columns[i] = std::make_unique<ral::frame::BlazingColumnOwner>(std::move(new_column));
+        } else if (program.kinds[i] == expression_kind::LITERAL) {
+            if(program.output_types[i] == cudf::type_id::STRING){
+                out_columns[i] = std::make_unique<ral::frame::BlazingColumnOwner>(ral::utilities::make_string_column_from_scalar(program.string_literals[i], table.num_rows()));
+            } else {
+                std::unique_ptr<CudfColumn> fixed_with_col = cudf::make_fixed_width_column(cudf::data_type{program.output_types[i]}, table.num_rows());
                 if (fixed_with_col->size() != 0){
                     cudf::mutable_column_view out_column_mutable_view = fixed_with_col->mutable_view();
-                    cudf::experimental::fill_in_place(out_column_mutable_view, 0, out_column_mutable_view.size(), *literal_scalar);
+                    cudf::experimental::fill_in_place(out_column_mutable_view, 0, out_column_mutable_view.size(), *program.literal_scalars[i]);
                 }
                 out_columns[i] = std::make_unique<ral::frame::BlazingColumnOwner>(std::move(fixed_with_col));
             }
         } else {
-            cudf::size_type idx = get_index(expression);
+            cudf::size_type idx = program.column_indices[i];
             if (idx < table.num_columns()) {
                 // if the output is just the input, we want to see if its a BlazingColumnView or a BlazingColumnOwner
                 // if its a BlazingColumnView, then we just copy the view (no-memcopy)
@@ -488,7 +591,26 @@ std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate_expressions(
         }
     }
 
-    auto computed_columns = evaluator.release_computed_columns();
+    std::vector<cudf::column_view> interpreter_computed_views;
+    for (auto &&idx : program.interpreter_computed_indices) {
+        interpreter_computed_views.push_back(computed_columns[idx]->view());
+    }
+    cudf::table_view interops_input_table{{table.select(program.input_col_indices), cudf::table_view{interpreter_computed_views}}};
+
+    if(!interpreter_out_column_views.empty()){
+        cudf::mutable_table_view out_table_view(interpreter_out_column_views);
+
+        interops::perform_interpreter_operation(out_table_view,
+                                                interops_input_table,
+                                                program.left_inputs,
+                                                program.right_inputs,
+                                                program.outputs,
+                                                program.final_output_positions,
+                                                program.operators,
+                                                program.left_scalars,
+                                                program.right_scalars);
+    }
+
     for (auto &&p : out_idx_computed_idx_pair) {
         out_columns[p.first] = std::make_unique<ral::frame::BlazingColumnOwner>(std::move(computed_columns[p.second]));
     }
@@ -505,78 +627,71 @@ std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate_expressions(
         }
     }
 
-    // Get the needed columns indices in order and keep track of the mapped indices
-    std::map<column_index_type, column_index_type> col_idx_map;
-    std::vector<cudf::size_type> input_col_indices;
-    for(size_t i = 0; i < column_used.size(); i++) {
-        if(column_used[i]) {
-            col_idx_map.insert({i, col_idx_map.size()});
-            input_col_indices.push_back(i);
-        }
-    }
+    return std::move(out_columns);
+}
 
-    std::vector<std::unique_ptr<cudf::column>> filtered_computed_columns;
-    for(size_t i = 0; i < computed_columns.size(); i++) {
-        if(computed_columns[i]) { 
-            // If computed_columns[i] has not been moved to out_columns
-            // then it will be used as input in interops
-            col_idx_map.insert({table.num_columns() + i, col_idx_map.size()});
-            filtered_computed_columns.push_back(std::move(computed_columns[i]));
-        }
-    }
+} // namespace
 
-    std::vector<cudf::column_view> filtered_computed_views(filtered_computed_columns.size());
-    std::transform(std::cbegin(filtered_computed_columns), std::cend(filtered_computed_columns), filtered_computed_views.begin(), [](auto & col){
-        return col->view();
-    });
+expression_program::expression_program(const std::vector<std::string> & expressions) {
+    parsed_expressions.resize(expressions.size());
+    std::transform(expressions.begin(), expressions.end(), parsed_expressions.begin(), parse_expression);
+}
 
-    cudf::table_view interops_input_table{{table.select(input_col_indices), cudf::table_view{filtered_computed_views}}};
+expression_program::~expression_program() = default;
 
-    std::vector<column_index_type> left_inputs;
-    std::vector<column_index_type> right_inputs;
-    std::vector<column_index_type> outputs;
-    std::vector<column_index_type> final_output_positions;
-    std::vector<interops::operator_type> operators;
-    std::vector<std::unique_ptr<cudf::scalar>> left_scalars;
-    std::vector<std::unique_ptr<cudf::scalar>> right_scalars;
+std::vector<std::unique_ptr<ral::frame::BlazingColumn>> expression_program::evaluate(
+    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> blazing_columns) {
 
-    for (size_t i = 0; i < tokenized_expression_vector.size(); i++) {
-        final_output_positions.push_back(interops_input_table.num_columns() + i);
+    std::vector<CudfColumnView> cudf_column_views_in(blazing_columns.size());
+    std::transform(blazing_columns.begin(), blazing_columns.end(), cudf_column_views_in.begin(), [](auto & col){
+        return col->view();
+    });
+    cudf::table_view table(cudf_column_views_in);
 
-        interops::add_expression_to_interpreter_plan(tokenized_expression_vector[i],
-                                                    interops_input_table,
-                                                    col_idx_map,
-                                                    i,
-                                                    interpreter_out_column_views.size(),
-                                                    left_inputs,
-                                                    right_inputs,
-                                                    outputs,
-                                                    operators,
-                                                    left_scalars,
-                                                    right_scalars);
+    std::vector<cudf::type_id> schema(table.num_columns());
+    std::transform(table.begin(), table.end(), schema.begin(), [](auto & col){
+        return col.type().id();
+    });
+
+    const interpreter_program * cached_program = nullptr;
+    {
+        // a program is never modified nor removed once it is in the map
+        std::lock_guard<std::mutex> lock(programs_mutex);
+        auto it = programs_by_schema.find(schema);
+        if (it != programs_by_schema.end()) {
+            cached_program = it->second.get();
+        }
+    }
+    if (cached_program) {
+        return run_interpreter_program(*cached_program, std::move(blazing_columns), table, {});
     }
 
-    if(!tokenized_expression_vector.empty()){
-        cudf::mutable_table_view out_table_view(interpreter_out_column_views);
+    function_evaluator_transformer evaluator{table};
+    std::unique_ptr<interpreter_program> program = plan_expressions(table, parsed_expressions, evaluator);
+    std::vector<std::unique_ptr<cudf::column>> computed_columns = evaluator.release_computed_columns();
+    if (program->depends_on_data) {
+        return run_interpreter_program(*program, std::move(blazing_columns), table, std::move(computed_columns));
+    }
 
-        interops::perform_interpreter_operation(out_table_view,
-                                                interops_input_table,
-                                                left_inputs,
-                                                right_inputs,
-                                                outputs,
-                                                final_output_positions,
-                                                operators,
-                                                left_scalars,
-                                                right_scalars);
+    {
+        std::lock_guard<std::mutex> lock(programs_mutex);
+        // another thread may have planned the same schema in the meantime, both plans are the same
+        cached_program = programs_by_schema.emplace(schema, std::move(program)).first->second.get();
     }
+    return run_interpreter_program(*cached_program, std::move(blazing_columns), table, std::move(computed_columns));
+}
 
-    return std::move(out_columns);
+std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate_expressions(
+    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> blazing_columns,
+    const std::vector<std::string> & expressions) {
+
+    expression_program program(expressions);
+    return program.evaluate(std::move(blazing_columns));
 }
 
-std::unique_ptr<ral::frame::BlazingTable> process_project(
-  std::unique_ptr<ral::frame::BlazingTable> blazing_table_in,
-  const std::string & query_part,
-  blazingdb::manager::Context * context) {
+void get_project_expressions(const std::string & query_part,
+    std::vector<std::string> & expressions,
+    std::vector<std::string> & out_column_names) {
 
     std::string combined_expression = query_part.substr(
         query_part.find("(") + 1,
@@ -584,8 +699,8 @@ std::unique_ptr<ral::frame::BlazingTable> process_project(
     );
 
     std::vector<std::string> named_expressions = get_expressions_from_expression_list(combined_expression);
-    std::vector<std::string> expressions(named_expressions.size());
-    std::vector<std::string> out_column_names(named_expressions.size());
+    expressions.resize(named_expressions.size());
+    out_column_names.resize(named_expressions.size());
     for(int i = 0; i < named_expressions.size(); i++) {
         const std::string & named_expr = named_expressions[i];
 
@@ -595,9 +710,27 @@ std::unique_ptr<ral::frame::BlazingTable> process_project(
         expressions[i] = expression;
         out_column_names[i] = name;
     }
+}
+
+std::unique_ptr<ral::frame::BlazingTable> process_project(
+  std::unique_ptr<ral::frame::BlazingTable> blazing_table_in,
+  const std::string & query_part,
+  blazingdb::manager::Context * context) {
+
+    std::vector<std::string> expressions;
+    std::vector<std::string> out_column_names;
+    get_project_expressions(query_part, expressions, out_column_names);
 
     return std::make_unique<ral::frame::BlazingTable>(evaluate_expressions(blazing_table_in->releaseBlazingColumns(), expressions), out_column_names);
 }
 
+std::unique_ptr<ral::frame::BlazingTable> process_project(
+  std::unique_ptr<ral::frame::BlazingTable> blazing_table_in,
+  expression_program & program,
+  const std::vector<std::string> & out_column_names) {
+
+    return std::make_unique<ral::frame::BlazingTable>(program.evaluate(blazing_table_in->releaseBlazingColumns()), out_column_names);
+}
+
 } // namespace processor
 } // namespace ral
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <blazingdb/manager/Context.h>
+#include <map>
+#include <mutex>
 
 #include "LogicPrimitives.h"
 #include "execution_graph/logic_controllers/BlazingColumn.h"
@@ -9,13 +11,49 @@ namespace ral{
 
 namespace processor{
 
+/**
+ * A list of Calcite expressions compiled once and evaluated on many batches.
+ * The expressions are parsed when the program is built. The interpreter plan, with its scalar literals,
+ * only depends on the types of the input columns, so it is built for the first batch of each input schema and reused.
+ * Expressions with string functions that have to be computed for each batch are still planned on every batch.
+ */
+class expression_program {
+public:
+  expression_program(const std::vector<std::string> & expressions);
+  ~expression_program();
+
+  std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate(
+    std::vector<std::unique_ptr<ral::frame::BlazingColumn>> blazing_columns_in);
+
+  std::size_t num_expressions() const { return parsed_expressions.size(); }
+
+  // the plan for one input schema, defined in LogicalProject.cpp
+  struct interpreter_program;
+
+private:
+  // the expressions after replace_calcite_regex and transform_to_custom_op
+  std::vector<std::string> parsed_expressions;
+  std::map<std::vector<cudf::type_id>, std::unique_ptr<interpreter_program>> programs_by_schema;
+  std::mutex programs_mutex;
+};
+
 std::vector<std::unique_ptr<ral::frame::BlazingColumn>> evaluate_expressions(
   std::vector<std::unique_ptr<ral::frame::BlazingColumn>> blazing_columns_in, const std::vector<std::string> & expressions);
 
+// Splits the expression list of a LogicalProject into the expressions and the names of the output columns
+void get_project_expressions(const std::string & query_part,
+  std::vector<std::string> & expressions,
+  std::vector<std::string> & out_column_names);
+
 std::unique_ptr<ral::frame::BlazingTable> process_project(
   std::unique_ptr<ral::frame::BlazingTable> blazing_table_in,
   const std::string & query_part,
   blazingdb::manager::Context * context);
 
+std::unique_ptr<ral::frame::BlazingTable> process_project(
+  std::unique_ptr<ral::frame::BlazingTable> blazing_table_in,
+  expression_program & program,
+  const std::vector<std::string> & out_column_names);
+
 } // namespace processor
 } // namespace ral
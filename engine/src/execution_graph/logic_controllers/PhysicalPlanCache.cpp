@@ -0,0 +1,74 @@
+#include "PhysicalPlanCache.h"
+
+namespace ral {
+namespace batch {
+
+physical_plan_cache & physical_plan_cache::getInstance() {
+	static physical_plan_cache instance;
+	return instance;
+}
+
+std::shared_ptr<const ral::parser::plan_node> physical_plan_cache::get_plan(const std::string & logical_plan, int total_nodes) {
+	std::string key = std::to_string(total_nodes) + "|" + ral::parser::normalize_algebra(logical_plan);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = index_.find(key);
+		if(it != index_.end()) {
+			num_hits_++;
+			entries_.splice(entries_.begin(), entries_, it->second);
+			return it->second->second;
+		}
+		num_misses_++;
+	}
+
+	// built without the lock, if two threads build the same plan the second one just replaces the first
+	std::shared_ptr<const ral::parser::plan_node> plan = ral::parser::rewrite_plan(
+		ral::parser::build_physical_plan(logical_plan), ral::parser::get_physical_rewrite_rules(total_nodes));
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(capacity_ > 0) {
+		auto it = index_.find(key);
+		if(it != index_.end()) {
+			entries_.erase(it->second);
+		}
+		entries_.emplace_front(key, plan);
+		index_[key] = entries_.begin();
+		evict();
+	}
+	return plan;
+}
+
+std::shared_ptr<const ral::parser::plan_node> physical_plan_cache::get_plan(const std::string & logical_plan, blazingdb::manager::Context * context) {
+	std::map<std::string, std::string> config_options = context->getConfigOptions();
+	auto it = config_options.find("PHYSICAL_PLAN_CACHE_SIZE");
+	if (it != config_options.end()){
+		set_capacity(std::stoull(config_options["PHYSICAL_PLAN_CACHE_SIZE"]));
+	}
+	return get_plan(logical_plan, context->getTotalNodes());
+}
+
+void physical_plan_cache::set_capacity(size_t capacity) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	capacity_ = capacity;
+	evict();
+}
+
+size_t physical_plan_cache::num_hits() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return num_hits_;
+}
+
+size_t physical_plan_cache::num_misses() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return num_misses_;
+}
+
+void physical_plan_cache::evict() {
+	while(entries_.size() > capacity_) {
+		index_.erase(entries_.back().first);
+		entries_.pop_back();
+	}
+}
+
+}  // namespace batch
+}  // namespace ral
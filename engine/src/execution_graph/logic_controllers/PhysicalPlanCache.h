@@ -0,0 +1,54 @@
+#pragma once
+
+#include "parser/physical_plan.hpp"
+#include <blazingdb/manager/Context.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace ral {
+namespace batch {
+
+const size_t DEFAULT_PHYSICAL_PLAN_CACHE_SIZE = 256;
+
+/**
+ * Keeps the physical plans of the last queries, so that running the same relational algebra again skips parsing and rewriting it.
+ * The plans are keyed by their normalized algebra and the number of nodes they run on, and the least recently used one
+ * is dropped when there are more than capacity. The plans are shared and must not be modified.
+ */
+class physical_plan_cache {
+public:
+	static physical_plan_cache & getInstance();
+
+	// Returns the plan of the algebra from the cache, or builds it and adds it to the cache
+	std::shared_ptr<const ral::parser::plan_node> get_plan(const std::string & logical_plan, int total_nodes);
+
+	// Same, for the nodes of the context. The PHYSICAL_PLAN_CACHE_SIZE config option sets the capacity
+	std::shared_ptr<const ral::parser::plan_node> get_plan(const std::string & logical_plan, blazingdb::manager::Context * context);
+
+	// 0 disables the cache
+	void set_capacity(size_t capacity);
+
+	size_t num_hits();
+	size_t num_misses();
+
+private:
+	physical_plan_cache() = default;
+
+	using entry = std::pair<std::string, std::shared_ptr<const ral::parser::plan_node>>;
+
+	void evict();
+
+	std::mutex mutex_;
+	size_t capacity_ = DEFAULT_PHYSICAL_PLAN_CACHE_SIZE;
+	std::list<entry> entries_;  // most recently used first
+	std::unordered_map<std::string, std::list<entry>::iterator> index_;
+	size_t num_hits_ = 0;
+	size_t num_misses_ = 0;
+};
+
+}  // namespace batch
+}  // namespace ral
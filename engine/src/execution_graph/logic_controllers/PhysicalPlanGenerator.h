@@ -10,6 +10,8 @@
 #include "BatchUnionProcessing.h"
 #include "io/DataLoader.h"
 #include "io/Schema.h"
+#include "PhysicalPlanCache.h"
+#include "parser/physical_plan.hpp"
 #include "utilities/CommonOperations.h"
 #include <spdlog/spdlog.h>
 #include "utilities/BlazingSqlInvalidAlgebraException.h"
@@ -39,201 +41,177 @@ struct tree_processor {
 	std::vector<ral::io::Schema> schemas;
 	std::vector<std::string> table_names;
 	const bool transform_operators_bigger_than_gpu = false;
+	std::vector<ral::parser::runtime_filter_spec> runtime_filter_specs;
+
+	std::shared_ptr<kernel> make_kernel(const ral::parser::plan_node & plan, std::shared_ptr<ral::cache::graph> query_graph) {
+		using ral::parser::plan_node_kind;
 
-	std::shared_ptr<kernel> make_kernel(std::string expr, std::shared_ptr<ral::cache::graph> query_graph) {
 		std::shared_ptr<kernel> k;
+		std::string expr = plan.expr();
 		auto kernel_context = this->context->clone();
-		if ( is_project(expr) ) {
-			k = std::make_shared<Projection>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+		switch (plan.kind) {
+		case plan_node_kind::Project:
+			k = std::make_shared<Projection>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::ProjectKernel);
-		} else if ( is_filter(expr) ) {
-			k = std::make_shared<Filter>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::Filter:
+			k = std::make_shared<Filter>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::FilterKernel);
-		} else if ( is_logical_scan(expr) ) {
-			size_t table_index = get_table_index(table_names, extract_table_name(expr));
+			break;
+		case plan_node_kind::FilterProject:
+			k = std::make_shared<FilterProjection>(plan, kernel_context, query_graph);
+			k->set_type_id(kernel_type::FilterProjectKernel);
+			break;
+		case plan_node_kind::TableScan: {
+			size_t table_index = get_table_index(table_names, plan.table_name);
 			auto loader = this->input_loaders[table_index].clone(); // NOTE: this is required if the same loader is used next time
 			auto schema = this->schemas[table_index];
-			k = std::make_shared<TableScan>(expr, *loader, schema, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			k = std::make_shared<TableScan>(plan, *loader, schema, kernel_context, query_graph);
 			k->set_type_id(kernel_type::TableScanKernel);
-		} else if (is_bindable_scan(expr)) {
-			size_t table_index = get_table_index(table_names, extract_table_name(expr));
+			break;
+		}
+		case plan_node_kind::BindableTableScan: {
+			size_t table_index = get_table_index(table_names, plan.table_name);
 			auto loader = this->input_loaders[table_index].clone(); // NOTE: this is required if the same loader is used next time
 			auto schema = this->schemas[table_index];
-			k = std::make_shared<BindableTableScan>(expr, *loader, schema, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			k = std::make_shared<BindableTableScan>(plan, *loader, schema, kernel_context, query_graph);
 			k->set_type_id(kernel_type::BindableTableScanKernel);
-		}  else if (is_single_node_partition(expr)) {
-			k = std::make_shared<PartitionSingleNodeKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		}
+		case plan_node_kind::PartitionSingleNode:
+			k = std::make_shared<PartitionSingleNodeKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::PartitionSingleNodeKernel);
-		} else if (is_single_node_sort_and_sample(expr)) {
-			k = std::make_shared<SortAndSampleSingleNodeKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::SortAndSampleSingleNode:
+			k = std::make_shared<SortAndSampleSingleNodeKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::SortAndSampleSingleNodeKernel);
-		} else if (is_partition(expr)) {
-			k = std::make_shared<PartitionKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::Partition:
+			k = std::make_shared<PartitionKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::PartitionKernel);
-		} else if (is_sort_and_sample(expr)) {
-			k = std::make_shared<SortAndSampleKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::SortAndSample:
+			k = std::make_shared<SortAndSampleKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::SortAndSampleKernel);
-		} else if (is_merge(expr)) {
-			k = std::make_shared<MergeStreamKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::MergeStream:
+			k = std::make_shared<MergeStreamKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::MergeStreamKernel);
-		} else if (is_limit(expr)) {
-			k = std::make_shared<LimitKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::Limit:
+			k = std::make_shared<LimitKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::LimitKernel);
-		}  else if (is_compute_aggregate(expr)) {
-			k = std::make_shared<ComputeAggregateKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::TopN:
+			k = std::make_shared<TopNKernel>(plan, kernel_context, query_graph);
+			k->set_type_id(kernel_type::TopNKernel);
+			break;
+		case plan_node_kind::ComputeAggregate:
+			k = std::make_shared<ComputeAggregateKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::ComputeAggregateKernel);
-		}  else if (is_distribute_aggregate(expr)) {
-			k = std::make_shared<DistributeAggregateKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::DistributeAggregate:
+			k = std::make_shared<DistributeAggregateKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::DistributeAggregateKernel);
-		}  else if (is_merge_aggregate(expr)) {
-			k = std::make_shared<MergeAggregateKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::MergeAggregate:
+			k = std::make_shared<MergeAggregateKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::MergeAggregateKernel);
-		}  else if (is_pairwise_join(expr)) {
-			k = std::make_shared<PartwiseJoin>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::PartwiseJoin:
+			k = std::make_shared<PartwiseJoin>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::PartwiseJoinKernel);
-		} else if (is_join_partition(expr)) {
-			k = std::make_shared<JoinPartitionKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::JoinPartition:
+			k = std::make_shared<JoinPartitionKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::JoinPartitionKernel);
-		} else if (is_union(expr)) {
-			k = std::make_shared<UnionKernel>(expr, kernel_context, query_graph);
-			kernel_context->setKernelId(k->get_id());
+			break;
+		case plan_node_kind::Union:
+			k = std::make_shared<UnionKernel>(plan, kernel_context, query_graph);
 			k->set_type_id(kernel_type::UnionKernel);
-		} else {
+			break;
+		default:
+			// Sort, Aggregate and Join only exist until the rewrite rules replace them
 			throw ral::utilities::BlazingSqlInvalidAlgebraException("expression in the Algebra Relational is currently not supported: " + expr);
 		}
+		kernel_context->setKernelId(k->get_id());
 		return k;
 	}
-	void expr_tree_from_json(boost::property_tree::ptree const& p_tree, node * root_ptr, int level, std::shared_ptr<ral::cache::graph> query_graph) {
-		auto expr = p_tree.get<std::string>("expr", "");
-		root_ptr->expr = expr;
+
+	void expr_tree_from_plan(const ral::parser::plan_node & plan, node * root_ptr, int level, std::shared_ptr<ral::cache::graph> query_graph) {
+		root_ptr->expr = plan.expr();
 		root_ptr->level = level;
-		root_ptr->kernel_unit = make_kernel(expr, query_graph);
-		for (auto &child : p_tree.get_child("children")) {
+		root_ptr->kernel_unit = make_kernel(plan, query_graph);
+		add_runtime_filters_to_scan(plan, root_ptr->kernel_unit);
+		for (auto &child : plan.children) {
 			auto child_node_ptr = std::make_shared<node>();
 			root_ptr->children.push_back(child_node_ptr);
-			expr_tree_from_json(child.second, child_node_ptr.get(), level + 1, query_graph);
+			node * child_root_ptr = child_node_ptr.get();
+			int child_level = level + 1;
+			if (make_runtime_filter_build_node(*child, child_root_ptr, child_level, query_graph)) {
+				// the build side of a join goes through the kernel that builds its filters
+				auto input_node_ptr = std::make_shared<node>();
+				child_root_ptr->children.push_back(input_node_ptr);
+				child_root_ptr = input_node_ptr.get();
+				child_level++;
+			}
+			expr_tree_from_plan(*child, child_root_ptr, child_level, query_graph);
 		}
-	} 
-
-	boost::property_tree::ptree create_array_tree(boost::property_tree::ptree child){
-		boost::property_tree::ptree children;
-		children.push_back(std::make_pair("", child));
-		return children;
 	}
 
-	void transform_json_tree(boost::property_tree::ptree &p_tree) {
-		std::string expr = p_tree.get<std::string>("expr", "");
-		if (is_sort(expr)){
-			auto limit_expr = expr;
-			auto merge_expr = expr;
-			auto partition_expr = expr;
-			auto sort_and_sample_expr = expr;
-			if(ral::operators::has_limit_only(expr)){
-				StringUtil::findAndReplaceAll(limit_expr, LOGICAL_SORT_TEXT, LOGICAL_LIMIT_TEXT);
+	// Plans the runtime filters from the build side of the joins to the scans of their probe side, ENABLE_RUNTIME_FILTERS disables them
+	void plan_runtime_filters(const ral::parser::plan_node & plan) {
+		runtime_filter_specs.clear();
+		std::map<std::string, std::string> config_options = context->getConfigOptions();
+		auto it = config_options.find("ENABLE_RUNTIME_FILTERS");
+		if (it != config_options.end() && (it->second == "False" || it->second == "false" || it->second == "0")){
+			return;
+		}
+		runtime_filter_specs = ral::parser::plan_runtime_filters(plan, [this](const ral::parser::plan_node & scan) {
+			return this->schemas[get_table_index(this->table_names, scan.table_name)].get_num_columns();
+		});
+	}
 
-				p_tree.put("expr", limit_expr);
+	void add_runtime_filters_to_scan(const ral::parser::plan_node & plan, std::shared_ptr<kernel> scan_kernel) {
+		for (auto & spec : runtime_filter_specs) {
+			if (spec.scan != &plan) {
+				continue;
+			}
+			if (plan.kind == ral::parser::plan_node_kind::TableScan) {
+				std::static_pointer_cast<TableScan>(scan_kernel)->add_runtime_filter(spec.id, spec.scan_column);
 			} else {
-				if (this->context->getTotalNodes() == 1) {
-					StringUtil::findAndReplaceAll(limit_expr, LOGICAL_SORT_TEXT, LOGICAL_LIMIT_TEXT);
-					StringUtil::findAndReplaceAll(merge_expr, LOGICAL_SORT_TEXT, LOGICAL_MERGE_TEXT);
-					StringUtil::findAndReplaceAll(partition_expr, LOGICAL_SORT_TEXT, LOGICAL_SINGLE_NODE_PARTITION_TEXT);
-					StringUtil::findAndReplaceAll(sort_and_sample_expr, LOGICAL_SORT_TEXT, LOGICAL_SINGLE_NODE_SORT_AND_SAMPLE_TEXT);
-				}	else {
-					StringUtil::findAndReplaceAll(limit_expr, LOGICAL_SORT_TEXT, LOGICAL_LIMIT_TEXT);
-					StringUtil::findAndReplaceAll(merge_expr, LOGICAL_SORT_TEXT, LOGICAL_MERGE_TEXT);
-					StringUtil::findAndReplaceAll(partition_expr, LOGICAL_SORT_TEXT, LOGICAL_PARTITION_TEXT);
-					StringUtil::findAndReplaceAll(sort_and_sample_expr, LOGICAL_SORT_TEXT, LOGICAL_SORT_AND_SAMPLE_TEXT);
-				}
-				boost::property_tree::ptree sample_tree;
-				sample_tree.put("expr", sort_and_sample_expr);
-				sample_tree.add_child("children", p_tree.get_child("children"));
-				boost::property_tree::ptree partition_tree;
-				partition_tree.put("expr", partition_expr);
-				partition_tree.add_child("children", create_array_tree(sample_tree));
-				boost::property_tree::ptree merge_tree;
-				merge_tree.put("expr", merge_expr);
-				merge_tree.add_child("children", create_array_tree(partition_tree)); 
-
-				p_tree.put("expr", limit_expr);
-				p_tree.put_child("children", create_array_tree(merge_tree));
+				std::static_pointer_cast<BindableTableScan>(scan_kernel)->add_runtime_filter(spec.id, spec.scan_column);
 			}
-		} 
-		else if (is_aggregate(expr)) {
-			auto merge_aggregate_expr = expr;
-			auto distribute_aggregate_expr = expr;
-			auto compute_aggregate_expr = expr;
-
-			if (this->context->getTotalNodes() == 1) {
-				StringUtil::findAndReplaceAll(merge_aggregate_expr, LOGICAL_AGGREGATE_TEXT, LOGICAL_MERGE_AGGREGATE_TEXT);
-				StringUtil::findAndReplaceAll(compute_aggregate_expr, LOGICAL_AGGREGATE_TEXT, LOGICAL_COMPUTE_AGGREGATE_TEXT);
-
-				boost::property_tree::ptree agg_tree;
-				agg_tree.put("expr", compute_aggregate_expr);
-				agg_tree.add_child("children", p_tree.get_child("children")); 
-
-				p_tree.clear();
-
-				p_tree.put("expr", merge_aggregate_expr);
-				p_tree.put_child("children", create_array_tree(agg_tree));
-			}	else {
-				StringUtil::findAndReplaceAll(merge_aggregate_expr, LOGICAL_AGGREGATE_TEXT, LOGICAL_MERGE_AGGREGATE_TEXT);
-				StringUtil::findAndReplaceAll(distribute_aggregate_expr, LOGICAL_AGGREGATE_TEXT, LOGICAL_DISTRIBUTE_AGGREGATE_TEXT);
-				StringUtil::findAndReplaceAll(compute_aggregate_expr, LOGICAL_AGGREGATE_TEXT, LOGICAL_COMPUTE_AGGREGATE_TEXT);
-
-				boost::property_tree::ptree compute_aggregate_tree;
-				compute_aggregate_tree.put("expr", compute_aggregate_expr);
-				compute_aggregate_tree.add_child("children", p_tree.get_child("children"));
-			
-				boost::property_tree::ptree distribute_aggregate_tree;
-				distribute_aggregate_tree.put("expr", distribute_aggregate_expr);
-				distribute_aggregate_tree.add_child("children", create_array_tree(compute_aggregate_tree)); 
-
-				p_tree.clear();
+		}
+	}
 
-				p_tree.put("expr", merge_aggregate_expr);
-				p_tree.put_child("children", create_array_tree(distribute_aggregate_tree));
+	// Puts the kernel that builds the runtime filters of the joins whose build side is plan in root_ptr, false if there are none
+	bool make_runtime_filter_build_node(const ral::parser::plan_node & plan, node * root_ptr, int level, std::shared_ptr<ral::cache::graph> query_graph) {
+		std::vector<std::string> filter_ids;
+		std::vector<std::string> key_columns;
+		for (auto & spec : runtime_filter_specs) {
+			if (spec.build_input == &plan) {
+				filter_ids.push_back(std::to_string(spec.id));
+				key_columns.push_back("$" + std::to_string(spec.build_column));
 			}
-		} else if (is_join(expr)) {
-			if (this->context->getTotalNodes() == 1) {
-				// PartwiseJoin
-				auto pairwise_expr = expr;
-				StringUtil::findAndReplaceAll(pairwise_expr, LOGICAL_JOIN_TEXT, LOGICAL_PARTWISE_JOIN_TEXT);
-				p_tree.put("expr", pairwise_expr);
-			} else {
-				auto pairwise_expr = expr;
-				auto join_partition_expr = expr;
-
-				StringUtil::findAndReplaceAll(pairwise_expr, LOGICAL_JOIN_TEXT, LOGICAL_PARTWISE_JOIN_TEXT);
-				StringUtil::findAndReplaceAll(join_partition_expr, LOGICAL_JOIN_TEXT, LOGICAL_JOIN_PARTITION_TEXT);
-
-				boost::property_tree::ptree join_partition_tree;
-				join_partition_tree.put("expr", join_partition_expr);
-				join_partition_tree.add_child("children", p_tree.get_child("children")); 
-
-				p_tree.clear();
+		}
+		if (filter_ids.empty()) {
+			return false;
+		}
 
-				p_tree.put("expr", pairwise_expr);
-				p_tree.put_child("children", create_array_tree(join_partition_tree));
+		root_ptr->expr = "RuntimeFilterBuild(filters=[" + StringUtil::combine(filter_ids, ", ") + "], keys=[" + StringUtil::combine(key_columns, ", ") + "])";
+		root_ptr->level = level;
+		auto kernel_context = this->context->clone();
+		auto k = std::make_shared<RuntimeFilterBuildKernel>(root_ptr->expr, kernel_context, query_graph);
+		k->set_type_id(kernel_type::RuntimeFilterBuildKernel);
+		kernel_context->setKernelId(k->get_id());
+		for (auto & spec : runtime_filter_specs) {
+			if (spec.build_input == &plan) {
+				k->add_filter(spec.id, spec.build_column);
 			}
 		}
-		for (auto &child : p_tree.get_child("children")) {
-			transform_json_tree(child.second);
-		}
+		root_ptr->kernel_unit = k;
+		return true;
 	}
 
 	std::string to_string() {
@@ -258,22 +236,25 @@ struct tree_processor {
 	} 
 	
 	std::shared_ptr<ral::cache::graph> build_batch_graph(std::string json) {
-		auto query_graph = std::make_shared<ral::cache::graph>();
+		std::shared_ptr<const ral::parser::plan_node> plan;
 		try {
-			std::istringstream input(json);
-			boost::property_tree::ptree p_tree;
-			boost::property_tree::read_json(input, p_tree);
-			transform_json_tree(p_tree);
-
-			expr_tree_from_json(p_tree, &this->root, 0, query_graph);
+			plan = physical_plan_cache::getInstance().get_plan(json, this->context.get());
 		} catch (std::exception & e) {
-			std::shared_ptr<spdlog::logger> logger = spdlog::get("batch_logger");
-			logger->error("|||{info}|||||",
-										"info"_a="In build_batch_graph. What: {}"_format(e.what()));
-			logger->flush();
+			log_build_error(e);
+			throw;
+		}
+		return build_batch_graph(*plan);
+	}
 
-			std::cerr << "property_tree:" << e.what() <<  std::endl;
-			throw e;
+	// plan has to be already rewritten into physical operators
+	std::shared_ptr<ral::cache::graph> build_batch_graph(const ral::parser::plan_node & plan) {
+		auto query_graph = std::make_shared<ral::cache::graph>();
+		try {
+			plan_runtime_filters(plan);
+			expr_tree_from_plan(plan, &this->root, 0, query_graph);
+		} catch (std::exception & e) {
+			log_build_error(e);
+			throw;
 		}
 
 		if (this->root.kernel_unit != nullptr) {
@@ -283,6 +264,15 @@ struct tree_processor {
 		return query_graph;
 	}
 
+	void log_build_error(const std::exception & e) {
+		std::shared_ptr<spdlog::logger> logger = spdlog::get("batch_logger");
+		logger->error("|||{info}|||||",
+									"info"_a="In build_batch_graph. What: {}"_format(e.what()));
+		logger->flush();
+
+		std::cerr << "property_tree:" << e.what() <<  std::endl;
+	}
+
 	void visit(ral::cache::graph& query_graph, node * parent, std::vector<std::shared_ptr<node>>& children) {
 		for (size_t index = 0; index < children.size(); index++) {
 			auto& child  =  children[index];
@@ -0,0 +1,302 @@
+#include "QueryResultCache.h"
+#include <blazingdb/io/Config/BlazingContext.h>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+namespace ral {
+namespace cache {
+
+query_result_cache & query_result_cache::getInstance() {
+	static query_result_cache instance;
+	return instance;
+}
+
+query_result_cache::result_entry::~result_entry() {
+	if(!file_path.empty()) {
+		std::remove(file_path.c_str());
+	}
+}
+
+namespace {
+
+// The host table as it is in memory, its column transports and then its buffers, each one after its size
+void write_host_table(const std::string & file_path, const ral::frame::BlazingHostTable & table) {
+	std::ofstream file(file_path, std::ios::binary);
+	const std::vector<ral::frame::ColumnTransport> & columns_offsets = table.get_columns_offsets();
+	uint64_t num_columns = columns_offsets.size();
+	file.write(reinterpret_cast<const char *>(&num_columns), sizeof(num_columns));
+	file.write(reinterpret_cast<const char *>(columns_offsets.data()), num_columns * sizeof(ral::frame::ColumnTransport));
+	const std::vector<std::basic_string<char>> & raw_buffers = table.get_raw_buffers();
+	uint64_t num_buffers = raw_buffers.size();
+	file.write(reinterpret_cast<const char *>(&num_buffers), sizeof(num_buffers));
+	for(auto & buffer : raw_buffers) {
+		uint64_t buffer_size = buffer.size();
+		file.write(reinterpret_cast<const char *>(&buffer_size), sizeof(buffer_size));
+		file.write(buffer.data(), buffer_size);
+	}
+	if(!file) {
+		throw std::runtime_error("query_result_cache: cannot write " + file_path);
+	}
+}
+
+std::unique_ptr<ral::frame::BlazingHostTable> read_host_table(const std::string & file_path) {
+	std::ifstream file(file_path, std::ios::binary);
+	uint64_t num_columns = 0;
+	file.read(reinterpret_cast<char *>(&num_columns), sizeof(num_columns));
+	std::vector<ral::frame::ColumnTransport> columns_offsets(num_columns);
+	file.read(reinterpret_cast<char *>(columns_offsets.data()), num_columns * sizeof(ral::frame::ColumnTransport));
+	uint64_t num_buffers = 0;
+	file.read(reinterpret_cast<char *>(&num_buffers), sizeof(num_buffers));
+	std::vector<std::basic_string<char>> raw_buffers(num_buffers);
+	for(auto & buffer : raw_buffers) {
+		uint64_t buffer_size = 0;
+		file.read(reinterpret_cast<char *>(&buffer_size), sizeof(buffer_size));
+		buffer.resize(buffer_size);
+		file.read(&buffer[0], buffer_size);
+	}
+	if(!file) {
+		throw std::runtime_error("query_result_cache: cannot read " + file_path);
+	}
+	return std::make_unique<ral::frame::BlazingHostTable>(columns_offsets, std::move(raw_buffers));
+}
+
+// The functions of Calcite whose result is not only given by their arguments
+const std::set<std::string> nondeterministic_functions = {"RAND", "RAND_INTEGER", "CURRENT_DATE", "CURRENT_TIME",
+	"CURRENT_TIMESTAMP", "LOCALTIME", "LOCALTIMESTAMP", "NOW"};
+
+}  // namespace
+
+void query_result_cache::lru_list::push_front(const std::string & key, std::shared_ptr<result_entry> result) {
+	bytes += result->size_in_bytes;
+	entries.emplace_front(key, std::move(result));
+	index[key] = entries.begin();
+}
+
+std::shared_ptr<query_result_cache::result_entry> query_result_cache::lru_list::erase(const std::string & key) {
+	auto it = index.find(key);
+	if(it == index.end()) {
+		return nullptr;
+	}
+	auto result = it->second->second;
+	bytes -= result->size_in_bytes;
+	entries.erase(it->second);
+	index.erase(it);
+	return result;
+}
+
+query_result_cache::lru_list::entry query_result_cache::lru_list::pop_back() {
+	entry last = std::move(entries.back());
+	entries.pop_back();
+	index.erase(last.first);
+	bytes -= last.second->size_in_bytes;
+	return last;
+}
+
+void query_result_cache::configure(const std::map<std::string, std::string> & config_options) {
+	size_t max_host_bytes = 0;
+	size_t max_disk_bytes = 0;
+	auto it = config_options.find("RESULT_CACHE_MAX_BYTES");
+	if (it != config_options.end()){
+		max_host_bytes = std::stoull(it->second);
+	}
+	it = config_options.find("RESULT_CACHE_MAX_DISK_BYTES");
+	if (it != config_options.end()){
+		max_disk_bytes = std::stoull(it->second);
+	}
+	set_budget(max_host_bytes, max_disk_bytes);
+}
+
+void query_result_cache::set_budget(size_t max_host_bytes, size_t max_disk_bytes) {
+	std::vector<std::shared_ptr<result_entry>> dropped;
+	std::vector<lru_list::entry> victims;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		max_host_bytes_ = max_host_bytes;
+		max_disk_bytes_ = max_host_bytes > 0 ? max_disk_bytes : 0;
+		victims = evict(dropped);
+	}
+	spill(std::move(victims));
+}
+
+bool query_result_cache::enabled() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return max_host_bytes_ > 0;
+}
+
+std::string query_result_cache::file_fingerprint(const std::string & file) {
+	try {
+		auto fs_manager = BlazingContext::getInstance()->getFileSystemManager();
+		if(!fs_manager) {
+			return "";
+		}
+		FileStatus status = fs_manager->getFileStatus(Uri{file});
+		if(!status.isFile() || (status.getModificationTime() == 0 && status.getETag().empty())) {
+			return "";
+		}
+		return file + "|" + std::to_string(status.getFileSize()) + "|" + std::to_string(status.getModificationTime()) +
+			   "|" + status.getETag();
+	} catch(const std::exception & e) {
+		return "";
+	}
+}
+
+bool query_result_cache::is_deterministic(const std::string & algebra) {
+	bool in_quotes = false;
+	std::string word;
+	for(char c : algebra) {
+		if(c == '\'') {
+			in_quotes = !in_quotes;
+		} else if(!in_quotes && (std::isupper(static_cast<unsigned char>(c)) || c == '_')) {
+			word.push_back(c);
+			continue;
+		}
+		if(nondeterministic_functions.count(word) > 0) {
+			return false;
+		}
+		word.clear();
+	}
+	return nondeterministic_functions.count(word) == 0;
+}
+
+std::unique_ptr<ral::frame::BlazingTable> query_result_cache::get(const std::string & key) {
+	std::shared_ptr<result_entry> result;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(max_host_bytes_ == 0) {
+			return nullptr;
+		}
+		for(lru_list * list : {&host_, &disk_}) {
+			auto it = list->index.find(key);
+			if(it != list->index.end()) {
+				list->entries.splice(list->entries.begin(), list->entries, it->second);
+				result = it->second->second;
+				break;
+			}
+		}
+		if(result == nullptr) {
+			num_misses_++;
+			return nullptr;
+		}
+		num_hits_++;
+	}
+
+	// read without the lock, the entry stays alive even if it is evicted meanwhile
+	std::unique_ptr<ral::frame::BlazingTable> table;
+	if(result->host_table != nullptr) {
+		table = ral::communication::messages::deserialize_from_cpu(result->host_table.get());
+	} else {
+		table = ral::communication::messages::deserialize_from_cpu(read_host_table(result->file_path).get());
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	bytes_served_ += table->sizeInBytes();
+	return table;
+}
+
+void query_result_cache::put(const std::string & key, const ral::frame::BlazingTableView & result) {
+	if(!enabled()) {
+		return;
+	}
+
+	auto entry = std::make_shared<result_entry>();
+	entry->host_table = ral::communication::messages::serialize_gpu_message_to_host_table(result);
+	entry->size_in_bytes = entry->host_table->sizeInBytes();
+
+	std::vector<std::shared_ptr<result_entry>> dropped;
+	std::vector<lru_list::entry> victims;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		dropped.push_back(host_.erase(key));
+		dropped.push_back(disk_.erase(key));
+		host_.push_front(key, std::move(entry));
+		victims = evict(dropped);
+	}
+	spill(std::move(victims));
+}
+
+void query_result_cache::clear() {
+	lru_list host;
+	lru_list disk;
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::swap(host, host_);
+	std::swap(disk, disk_);
+}
+
+std::vector<query_result_cache::lru_list::entry> query_result_cache::evict(std::vector<std::shared_ptr<result_entry>> & dropped) {
+	std::vector<lru_list::entry> victims;
+	while(host_.bytes > max_host_bytes_) {
+		auto last = host_.pop_back();
+		// the host size is close to the one of the file, so the results that would not fit are dropped without writing them
+		if(last.second->size_in_bytes <= max_disk_bytes_) {
+			victims.push_back(std::move(last));
+		} else {
+			dropped.push_back(std::move(last.second));
+		}
+	}
+	while(disk_.bytes > max_disk_bytes_) {
+		dropped.push_back(disk_.pop_back().second);
+	}
+	return victims;
+}
+
+void query_result_cache::spill(std::vector<lru_list::entry> victims) {
+	for(size_t i = 0; i < victims.size(); i++) {
+		lru_list::entry victim = std::move(victims[i]);
+		auto spilled = std::make_shared<result_entry>();
+		spilled->file_path = "/tmp/.blazing-result-cache-" + randomString(64);
+		spilled->size_in_bytes = victim.second->size_in_bytes;
+		try {
+			write_host_table(spilled->file_path, *victim.second->host_table);
+		} catch(const std::exception & e) {
+			continue;
+		}
+
+		std::vector<std::shared_ptr<result_entry>> dropped;
+		std::lock_guard<std::mutex> lock(mutex_);
+		// it was put again while it was written
+		if(host_.index.find(victim.first) != host_.index.end()) {
+			continue;
+		}
+		dropped.push_back(disk_.erase(victim.first));
+		disk_.push_front(victim.first, std::move(spilled));
+		for(auto & more_victim : evict(dropped)) {
+			victims.push_back(std::move(more_victim));
+		}
+	}
+}
+
+size_t query_result_cache::num_hits() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return num_hits_;
+}
+
+size_t query_result_cache::num_misses() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return num_misses_;
+}
+
+double query_result_cache::hit_rate() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	size_t lookups = num_hits_ + num_misses_;
+	return lookups == 0 ? 0.0 : static_cast<double>(num_hits_) / lookups;
+}
+
+size_t query_result_cache::bytes_served() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return bytes_served_;
+}
+
+size_t query_result_cache::host_bytes() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return host_.bytes;
+}
+
+size_t query_result_cache::disk_bytes() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return disk_.bytes;
+}
+
+}  // namespace cache
+}  // namespace ral
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CacheMachine.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ral {
+namespace cache {
+
+/**
+ * Keeps the results of the queries that only read files, so that running the same query again over files that did not
+ * change returns the stored result without building or executing its graph.
+ * The results are kept in host memory within max_host_bytes. The least recently used ones are spilled to local files
+ * while they fit in max_disk_bytes, and dropped after that. The cache is disabled while max_host_bytes is 0.
+ * The lock is only held to look up and pick entries, the copies and the files are done without it.
+ */
+class query_result_cache {
+public:
+	static query_result_cache & getInstance();
+
+	// The RESULT_CACHE_MAX_BYTES and RESULT_CACHE_MAX_DISK_BYTES config options set the budgets, both are 0 by default
+	void configure(const std::map<std::string, std::string> & config_options);
+	void set_budget(size_t max_host_bytes, size_t max_disk_bytes);
+	bool enabled();
+
+	// The fingerprint of a file, its uri with its size and its modification time or ETag.
+	// Empty if the file system does not report a version for it, in which case its queries are not cached
+	static std::string file_fingerprint(const std::string & file);
+
+	// False if the algebra calls a function whose result changes from one run to the next, like RAND or CURRENT_TIMESTAMP
+	static bool is_deterministic(const std::string & algebra);
+
+	// The result of the query with this key, nullptr if it is not cached
+	std::unique_ptr<ral::frame::BlazingTable> get(const std::string & key);
+
+	// Keeps a host copy of the result
+	void put(const std::string & key, const ral::frame::BlazingTableView & result);
+
+	void clear();
+
+	size_t num_hits();
+	size_t num_misses();
+	double hit_rate();
+	size_t bytes_served();  // size of the results returned by get
+	size_t host_bytes();
+	size_t disk_bytes();
+
+private:
+	query_result_cache() = default;
+
+	// the result and its size, either in host memory or spilled to a file, which is removed once nobody reads it anymore
+	struct result_entry {
+		std::unique_ptr<ral::frame::BlazingHostTable> host_table;
+		std::string file_path;
+		size_t size_in_bytes;
+		~result_entry();
+	};
+
+	struct lru_list {
+		using entry = std::pair<std::string, std::shared_ptr<result_entry>>;
+		std::list<entry> entries;  // most recently used first
+		std::unordered_map<std::string, std::list<entry>::iterator> index;
+		size_t bytes = 0;
+
+		void push_front(const std::string & key, std::shared_ptr<result_entry> result);
+		std::shared_ptr<result_entry> erase(const std::string & key);
+		entry pop_back();
+	};
+
+	// With the lock held, takes out of the lists what does not fit in the budgets anymore. Returns the host results that
+	// fit on disk, to be spilled without the lock, the rest go to dropped so that they are released without the lock too
+	std::vector<lru_list::entry> evict(std::vector<std::shared_ptr<result_entry>> & dropped);
+
+	// Writes the host results to files without the lock, and then puts them in the disk list
+	void spill(std::vector<lru_list::entry> victims);
+
+	std::mutex mutex_;
+	size_t max_host_bytes_ = 0;
+	size_t max_disk_bytes_ = 0;
+	lru_list host_;
+	lru_list disk_;
+	size_t num_hits_ = 0;
+	size_t num_misses_ = 0;
+	size_t bytes_served_ = 0;
+};
+
+}  // namespace cache
+}  // namespace ral
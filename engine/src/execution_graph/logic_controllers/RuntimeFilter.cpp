@@ -0,0 +1,290 @@
+#include "RuntimeFilter.h"
+#include "communication/CommunicationData.h"
+#include "distribution/primitives.h"
+#include "utilities/bloom_filter.cuh"
+#include <cudf/column/column_factories.hpp>
+#include <cudf/hashing.hpp>
+#include <cudf/reduction.hpp>
+#include <cudf/scalar/scalar.hpp>
+#include <cudf/unary.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ral {
+namespace cache {
+
+namespace {
+
+const uint32_t BLOOM_FILTER_SEED_A = 0;
+const uint32_t BLOOM_FILTER_SEED_B = 0x9e3779b9;
+
+// key_type, abandoned, num_keys, has_range, min_bits, max_bits
+const std::size_t RUNTIME_FILTER_HEADER_SIZE = 6;
+
+std::unique_ptr<cudf::column> hash_keys(const cudf::column_view & keys, uint32_t seed) {
+	return cudf::hash(cudf::table_view{{keys}}, cudf::hash_id::HASH_MURMUR3, {seed});
+}
+
+int64_t to_bits(double value) {
+	int64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+double from_bits(int64_t bits) {
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// The min or the max of the keys as the bits of their int64_t or double value, false if they are all null
+bool reduce_keys(const cudf::column_view & keys, std::unique_ptr<cudf::experimental::aggregation> aggregation, int64_t & bits) {
+	std::unique_ptr<cudf::scalar> result = cudf::experimental::reduce(keys, aggregation, keys.type());
+	if(!result->is_valid()) {
+		return false;
+	}
+	if(keys.type().id() == cudf::type_id::FLOAT64) {
+		bits = to_bits(static_cast<cudf::experimental::scalar_type_t<double> *>(result.get())->value());
+	} else {
+		bits = static_cast<cudf::experimental::scalar_type_t<int64_t> *>(result.get())->value();
+	}
+	return true;
+}
+
+}  // namespace
+
+runtime_filter::runtime_filter(cudf::type_id key_type, std::size_t bloom_bytes) : key_type_(key_type) {
+	// the bits of a key are taken with a mask, so the number of words is a power of two
+	std::size_t num_words = 1;
+	while(num_words * sizeof(uint64_t) < bloom_bytes) {
+		num_words *= 2;
+	}
+	words_ = rmm::device_buffer(num_words * sizeof(uint64_t));
+	cudaMemset(words_.data(), 0, words_.size());
+}
+
+cudf::type_id runtime_filter::key_type_of(cudf::data_type type) {
+	switch(type.id()) {
+	case cudf::type_id::BOOL8:
+	case cudf::type_id::INT8:
+	case cudf::type_id::INT16:
+	case cudf::type_id::INT32:
+	case cudf::type_id::INT64:
+		return cudf::type_id::INT64;
+	case cudf::type_id::FLOAT32:
+	case cudf::type_id::FLOAT64:
+		return cudf::type_id::FLOAT64;
+	case cudf::type_id::STRING:
+		return cudf::type_id::STRING;
+	default:
+		return cudf::type_id::EMPTY;
+	}
+}
+
+std::unique_ptr<cudf::column> runtime_filter::cast_keys(const cudf::column_view & keys) const {
+	if(keys.type().id() == key_type_) {
+		return std::make_unique<cudf::column>(keys);
+	}
+	return cudf::experimental::cast(keys, cudf::data_type{key_type_});
+}
+
+void runtime_filter::add(const cudf::column_view & keys) {
+	if(abandoned_ || keys.size() == 0) {
+		return;
+	}
+
+	std::unique_ptr<cudf::column> cast = cast_keys(keys);
+	auto hashes_a = hash_keys(cast->view(), BLOOM_FILTER_SEED_A);
+	auto hashes_b = hash_keys(cast->view(), BLOOM_FILTER_SEED_B);
+	ral::utilities::bloom_filter_insert(cast->view(), hashes_a->view(), hashes_b->view(),
+		static_cast<uint64_t *>(words_.data()), words_.size() / sizeof(uint64_t));
+	num_keys_ += cast->size() - cast->null_count();
+
+	if(key_type_ == cudf::type_id::STRING) {
+		return;
+	}
+	int64_t min_bits;
+	int64_t max_bits;
+	if(reduce_keys(cast->view(), cudf::experimental::make_min_aggregation(), min_bits) &&
+		reduce_keys(cast->view(), cudf::experimental::make_max_aggregation(), max_bits)) {
+		extend_range(min_bits, max_bits);
+	}
+}
+
+void runtime_filter::extend_range(int64_t min_bits, int64_t max_bits) {
+	if(!has_range_) {
+		has_range_ = true;
+		min_bits_ = min_bits;
+		max_bits_ = max_bits;
+	} else if(key_type_ == cudf::type_id::FLOAT64) {
+		min_bits_ = to_bits(std::min(from_bits(min_bits_), from_bits(min_bits)));
+		max_bits_ = to_bits(std::max(from_bits(max_bits_), from_bits(max_bits)));
+	} else {
+		min_bits_ = std::min(min_bits_, min_bits);
+		max_bits_ = std::max(max_bits_, max_bits);
+	}
+}
+
+void runtime_filter::merge(const runtime_filter & other) {
+	// the filter of an empty build side does not know the type of the keys, and all its bits are unset
+	if(!other.abandoned_ && other.num_keys_ == 0 && other.words_.size() == words_.size()) {
+		return;
+	}
+	if(!abandoned_ && num_keys_ == 0) {
+		key_type_ = other.key_type_;
+	}
+
+	if(other.abandoned_ || other.key_type_ != key_type_ || other.words_.size() != words_.size()) {
+		abandon();
+	}
+	if(abandoned_) {
+		return;
+	}
+
+	ral::utilities::bloom_filter_merge(static_cast<uint64_t *>(words_.data()), static_cast<const uint64_t *>(other.words_.data()),
+		words_.size() / sizeof(uint64_t));
+	num_keys_ += other.num_keys_;
+
+	if(other.has_range_) {
+		extend_range(other.min_bits_, other.max_bits_);
+	}
+}
+
+void runtime_filter::abandon() {
+	abandoned_ = true;
+	has_range_ = false;
+}
+
+bool runtime_filter::abandoned() const { return abandoned_; }
+
+std::size_t runtime_filter::num_keys() const { return num_keys_; }
+
+std::size_t runtime_filter::max_keys(std::size_t bloom_bytes) { return bloom_bytes * 8 / RUNTIME_FILTER_BITS_PER_KEY; }
+
+bool runtime_filter::can_probe(cudf::data_type type) const {
+	return !abandoned_ && key_type_ != cudf::type_id::EMPTY && key_type_of(type) == key_type_;
+}
+
+std::unique_ptr<cudf::column> runtime_filter::contains(const cudf::column_view & keys) const {
+	std::unique_ptr<cudf::column> cast = cast_keys(keys);
+	auto hashes_a = hash_keys(cast->view(), BLOOM_FILTER_SEED_A);
+	auto hashes_b = hash_keys(cast->view(), BLOOM_FILTER_SEED_B);
+	return ral::utilities::bloom_filter_contains(cast->view(), hashes_a->view(), hashes_b->view(),
+		static_cast<const uint64_t *>(words_.data()), words_.size() / sizeof(uint64_t));
+}
+
+ral::io::column_value_range runtime_filter::value_range() const {
+	ral::io::column_value_range range;
+	range.is_valid = has_range_ && !abandoned_;
+	range.is_integer = key_type_ == cudf::type_id::INT64;
+	if(range.is_integer) {
+		range.integer_min = min_bits_;
+		range.integer_max = max_bits_;
+	} else {
+		range.float_min = from_bits(min_bits_);
+		range.float_max = from_bits(max_bits_);
+	}
+	return range;
+}
+
+std::unique_ptr<ral::frame::BlazingTable> runtime_filter::to_table() const {
+	std::vector<int64_t> header = {static_cast<int64_t>(key_type_), abandoned_, static_cast<int64_t>(num_keys_), has_range_,
+		min_bits_, max_bits_};
+
+	std::size_t num_words = words_.size() / sizeof(uint64_t);
+	auto column = cudf::make_numeric_column(cudf::data_type{cudf::type_id::INT64}, RUNTIME_FILTER_HEADER_SIZE + num_words);
+	int64_t * data = column->mutable_view().data<int64_t>();
+	cudaMemcpy(data, header.data(), header.size() * sizeof(int64_t), cudaMemcpyHostToDevice);
+	cudaMemcpy(data + RUNTIME_FILTER_HEADER_SIZE, words_.data(), words_.size(), cudaMemcpyDeviceToDevice);
+
+	std::vector<std::unique_ptr<cudf::column>> columns;
+	columns.push_back(std::move(column));
+	return std::make_unique<ral::frame::BlazingTable>(
+		std::make_unique<cudf::experimental::table>(std::move(columns)), std::vector<std::string>{"runtime_filter"});
+}
+
+std::unique_ptr<runtime_filter> runtime_filter::from_table(const ral::frame::BlazingTableView & table) {
+	cudf::column_view column = table.view().column(0);
+	std::vector<int64_t> header(RUNTIME_FILTER_HEADER_SIZE);
+	cudaMemcpy(header.data(), column.data<int64_t>(), header.size() * sizeof(int64_t), cudaMemcpyDeviceToHost);
+
+	std::size_t num_words = column.size() - RUNTIME_FILTER_HEADER_SIZE;
+	auto filter = std::make_unique<runtime_filter>(static_cast<cudf::type_id>(header[0]), num_words * sizeof(uint64_t));
+	filter->abandoned_ = header[1] != 0;
+	filter->num_keys_ = header[2];
+	filter->has_range_ = header[3] != 0;
+	filter->min_bits_ = header[4];
+	filter->max_bits_ = header[5];
+	cudaMemcpy(filter->words_.data(), column.data<int64_t>() + RUNTIME_FILTER_HEADER_SIZE, num_words * sizeof(uint64_t),
+		cudaMemcpyDeviceToDevice);
+	return filter;
+}
+
+void runtime_filter_registry::publish(int32_t id, std::shared_ptr<runtime_filter> filter) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		filters_[id] = std::move(filter);
+	}
+	published_.notify_all();
+}
+
+std::shared_ptr<runtime_filter> runtime_filter_registry::wait(int32_t id, std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	published_.wait_for(lock, timeout, [this, id] { return filters_.find(id) != filters_.end(); });
+	auto it = filters_.find(id);
+	return it == filters_.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<runtime_filter> runtime_filter_registry::get(int32_t id) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = filters_.find(id);
+	return it == filters_.end() ? nullptr : it->second;
+}
+
+void runtime_filter_registry::add_scan_stats(std::size_t rows_scanned, std::size_t rows_dropped, std::size_t row_groups_skipped) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	rows_scanned_ += rows_scanned;
+	rows_dropped_ += rows_dropped;
+	row_groups_skipped_ += row_groups_skipped;
+}
+
+std::size_t runtime_filter_registry::rows_scanned() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return rows_scanned_;
+}
+
+std::size_t runtime_filter_registry::rows_dropped() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return rows_dropped_;
+}
+
+std::size_t runtime_filter_registry::row_groups_skipped() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return row_groups_skipped_;
+}
+
+std::unique_ptr<runtime_filter> merge_runtime_filters(Context * context, const runtime_filter & filter) {
+	using namespace ral::distribution;
+
+	std::unique_ptr<runtime_filter> merged;
+	if(context->isMasterNode(ral::communication::CommunicationData::getInstance().getSelfNode())) {
+		context->incrementQuerySubstep();
+		std::pair<std::vector<NodeColumn>, std::vector<std::size_t> > filters_pair = collectSamples(context);
+		merged = std::make_unique<runtime_filter>(filter);
+		for(auto & node_filter : filters_pair.first) {
+			merged->merge(*runtime_filter::from_table(node_filter.second->toBlazingTableView()));
+		}
+
+		context->incrementQuerySubstep();
+		distributePartitionPlan(context, merged->to_table()->toBlazingTableView());
+	} else {
+		context->incrementQuerySubstep();
+		sendSamplesToMaster(context, filter.to_table()->toBlazingTableView(), filter.num_keys());
+		context->incrementQuerySubstep();
+		merged = runtime_filter::from_table(getPartitionPlan(context)->toBlazingTableView());
+	}
+	return merged;
+}
+
+}  // namespace cache
+}  // namespace ral
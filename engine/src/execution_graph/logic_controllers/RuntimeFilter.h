@@ -0,0 +1,109 @@
+#pragma once
+
+#include "LogicPrimitives.h"
+#include "io/data_parser/DataParser.h"
+#include <blazingdb/manager/Context.h>
+#include <rmm/device_buffer.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace ral {
+namespace cache {
+
+using Context = blazingdb::manager::Context;
+
+const std::size_t DEFAULT_RUNTIME_FILTER_BLOOM_BYTES = 1 << 20;  // 1 MB
+// With the 3 hashes of the Bloom filter and 10 bits per key, about 2% of the keys that are not in the filter pass it.
+// Past that the filter lets most rows through, so by default a filter takes at most bloom bits / 10 keys
+const std::size_t RUNTIME_FILTER_BITS_PER_KEY = 10;
+const int DEFAULT_RUNTIME_FILTER_MAX_WAIT_MS = 5000;
+
+/**
+ * The keys of the build side of a join, as a Bloom filter and their min and max values.
+ * A scan of the probe side uses it to skip the row groups that can not have any of the keys and to drop the rows
+ * that do not have a match before they are joined or shuffled.
+ * Every filter of a query has the same size, so that the ones that each node builds can be merged into one.
+ */
+class runtime_filter {
+public:
+	runtime_filter(cudf::type_id key_type, std::size_t bloom_bytes);
+
+	// The type that the keys are cast to before hashing them, so that both sides of a join hash the same values the same way.
+	// EMPTY for the types that the filters do not support
+	static cudf::type_id key_type_of(cudf::data_type type);
+
+	void add(const cudf::column_view & keys);
+	void merge(const runtime_filter & other);
+
+	// An abandoned filter keeps every row, i.e. when the build side has too many keys for the filter to be selective
+	void abandon();
+	bool abandoned() const;
+
+	std::size_t num_keys() const;
+
+	// How many keys a filter of this size takes before most of the keys that are not in it pass it
+	static std::size_t max_keys(std::size_t bloom_bytes);
+	bool can_probe(cudf::data_type type) const;
+
+	// A BOOL8 column that is false for the keys that are not in the build side, and true for the ones that are,
+	// and for a few others due to the false positives of the Bloom filter
+	std::unique_ptr<cudf::column> contains(const cudf::column_view & keys) const;
+
+	// The min and max of the keys, is_valid is false if the filter does not have them
+	ral::io::column_value_range value_range() const;
+
+	// A single INT64 column with the filter, which is how it is sent to other nodes
+	std::unique_ptr<ral::frame::BlazingTable> to_table() const;
+	static std::unique_ptr<runtime_filter> from_table(const ral::frame::BlazingTableView & table);
+
+private:
+	std::unique_ptr<cudf::column> cast_keys(const cudf::column_view & keys) const;
+	void extend_range(int64_t min_bits, int64_t max_bits);
+
+	cudf::type_id key_type_;
+	bool abandoned_ = false;
+	std::size_t num_keys_ = 0;
+	bool has_range_ = false;
+	int64_t min_bits_ = 0;  // the bits of a double when the keys are FLOAT64
+	int64_t max_bits_ = 0;
+	rmm::device_buffer words_;  // the bits of the Bloom filter as uint64_t words
+};
+
+/**
+ * The runtime filters of a query graph. The kernels that build a filter publish it when their input is done,
+ * and the scans that use it wait for it before they start reading.
+ */
+class runtime_filter_registry {
+public:
+	// filter is nullptr when there is not going to be one for that id
+	void publish(int32_t id, std::shared_ptr<runtime_filter> filter);
+
+	// The filter once it is published, nullptr if it is not published after timeout or if it was published without a filter
+	std::shared_ptr<runtime_filter> wait(int32_t id, std::chrono::milliseconds timeout);
+
+	// The filter if it is already published, without waiting for it
+	std::shared_ptr<runtime_filter> get(int32_t id);
+
+	void add_scan_stats(std::size_t rows_scanned, std::size_t rows_dropped, std::size_t row_groups_skipped);
+	std::size_t rows_scanned();
+	std::size_t rows_dropped();
+	std::size_t row_groups_skipped();
+
+private:
+	std::mutex mutex_;
+	std::condition_variable published_;
+	std::map<int32_t, std::shared_ptr<runtime_filter>> filters_;
+	std::size_t rows_scanned_ = 0;
+	std::size_t rows_dropped_ = 0;
+	std::size_t row_groups_skipped_ = 0;
+};
+
+// Collective operation, every node of the context must call it. The master merges the filters of all the nodes and
+// broadcasts the result, which is abandoned if the filter of any node was
+std::unique_ptr<runtime_filter> merge_runtime_filters(Context * context, const runtime_filter & filter);
+
+}  // namespace cache
+}  // namespace ral
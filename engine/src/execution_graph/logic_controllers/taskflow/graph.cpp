@@ -1,4 +1,6 @@
 #include "graph.h"
+#include "utilities/Tracing.h"
+#include <chrono>
 
 namespace ral {
 namespace cache {
@@ -60,7 +62,18 @@ namespace cache {
 							visited.insert(edge_id);
 							Q.push_back(target_id);
 							BlazingThread t([this, source, source_id, edge] {
-								auto state = source->run();
+								// the spans of the thread without a context at hand, like the waits on the caches, are of the query of the kernel
+								ral::utilities::scoped_trace_query trace_query(source->get_context() ?
+									source->get_context()->getContextToken() : ral::utilities::NO_TRACE_QUERY);
+								auto start = std::chrono::steady_clock::now();
+								kstatus state;
+								{
+									ral::utilities::trace_span span("kernel", get_kernel_type_name(source->get_type_id()),
+										ral::utilities::NO_TRACE_QUERY, "kernel_id", source_id);
+									state = source->run();
+								}
+								source->add_to_query_profile(std::chrono::duration_cast<std::chrono::nanoseconds>(
+									std::chrono::steady_clock::now() - start).count());
 								if(state == kstatus::proceed) {
 									source->output_.finish();
 								} else if (edge.target != -1) { // not a dummy node
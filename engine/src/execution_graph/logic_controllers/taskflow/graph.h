@@ -2,6 +2,7 @@
 
 #include "kernel.h"
 #include "kpair.h"
+#include "execution_graph/logic_controllers/RuntimeFilter.h"
 
 namespace ral {
 namespace cache {
@@ -47,7 +48,7 @@ protected:
 	};
 
 public:
-	graph() {
+	graph() : runtime_filters_(std::make_shared<runtime_filter_registry>()) {
 		container_[head_id_] = nullptr;	 // sentinel node
 	}
 	graph(const graph &) = default;
@@ -86,12 +87,16 @@ public:
 	std::set<Edge> get_reverse_neighbours(kernel * from);
 	std::set<Edge> get_reverse_neighbours(int32_t id);
 
+	// The filters that the joins of the graph build for the scans of their probe side
+	std::shared_ptr<runtime_filter_registry> get_runtime_filters() const { return runtime_filters_; }
+
 private:
 	const std::int32_t head_id_{-1};
 	std::vector<kernel *> kernels_;
 	std::map<std::int32_t, kernel *> container_;
 	std::map<std::int32_t, std::set<Edge>> edges_;
 	std::map<std::int32_t, std::set<Edge>> reverse_edges_;
+	std::shared_ptr<runtime_filter_registry> runtime_filters_;
 };
 
 
@@ -1,4 +1,6 @@
 #include "kernel.h"
+#include <algorithm>
+
 namespace ral {
 namespace cache {
     
@@ -10,6 +12,40 @@ std::pair<bool, uint64_t> kernel::get_estimated_output_num_rows(){
     return this->query_graph->get_estimated_input_rows_to_kernel(this->kernel_id);
 }
 
+void kernel::add_to_query_profile(int64_t run_time_ns) {
+	// the OutputKernel is not part of the plan, and a kernel with many output edges is run for each of them
+	if(context == nullptr || profiled.exchange(true)) {
+		return;
+	}
+
+	blazingdb::manager::KernelProfile profile;
+	profile.kernel_id = this->get_id();
+	profile.kernel_type = get_kernel_type_name(this->kernel_type_id);
+	profile.expression = this->expression;
+	for(auto & cache : this->input_.cache_machines_) {
+		if(cache.second) {
+			cache_profile input = cache.second->get_profile();
+			profile.input_wait_ns += input.next_wait_ns;
+			profile.batches_in += input.batches_pulled;
+			profile.rows_in += input.rows_pulled;
+			profile.bytes_in += input.bytes_pulled;
+		}
+	}
+	for(auto & cache : this->output_.cache_machines_) {
+		if(cache.second) {
+			cache_profile output = cache.second->get_profile();
+			profile.output_wait_ns += output.saturated_wait_ns;
+			profile.batches_out += output.batches_added;
+			profile.rows_out += output.rows_added;
+			profile.bytes_out += output.bytes_added;
+			profile.batches_spilled_to_host += output.batches_to_host;
+			profile.batches_spilled_to_disk += output.batches_to_disk;
+		}
+	}
+	profile.busy_ns = std::max<int64_t>(0, run_time_ns - profile.input_wait_ns - profile.output_wait_ns);
+	context->getQueryProfile()->addKernelProfile(std::move(profile));
+}
+
 
 }  // end namespace cache
 }  // end namespace ral
\ No newline at end of file
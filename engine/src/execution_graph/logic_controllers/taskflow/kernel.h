@@ -111,6 +111,9 @@ public:
 		this->output_.get_cache(cache_id)->wait_if_cache_is_saturated();
 	}
 
+	// Adds what the kernel did to the profile of its query, once it is done. run_time_ns is how long its run took
+	void add_to_query_profile(int64_t run_time_ns);
+
 protected:
 	static std::size_t kernel_count;
 
@@ -126,6 +129,9 @@ public:
 	std::shared_ptr<Context> context;
 
 	std::shared_ptr<spdlog::logger> logger;
+
+private:
+	std::atomic<bool> profiled{false};
 };
 
  
@@ -6,6 +6,7 @@ namespace cache {
 enum class kernel_type {
 	ProjectKernel,
 	FilterKernel,
+	FilterProjectKernel,
 	UnionKernel,
 	MergeStreamKernel,
 	PartitionKernel,
@@ -13,15 +14,42 @@ enum class kernel_type {
 	PartitionSingleNodeKernel,
 	SortAndSampleSingleNodeKernel,
 	LimitKernel,
+	TopNKernel,
 	ComputeAggregateKernel,
 	DistributeAggregateKernel,
 	MergeAggregateKernel,
 	TableScanKernel,
 	BindableTableScanKernel,
 	PartwiseJoinKernel,
-	JoinPartitionKernel
+	JoinPartitionKernel,
+	RuntimeFilterBuildKernel
 };
 
+inline const char * get_kernel_type_name(kernel_type type) {
+	switch(type) {
+	case kernel_type::ProjectKernel: return "ProjectKernel";
+	case kernel_type::FilterKernel: return "FilterKernel";
+	case kernel_type::FilterProjectKernel: return "FilterProjectKernel";
+	case kernel_type::UnionKernel: return "UnionKernel";
+	case kernel_type::MergeStreamKernel: return "MergeStreamKernel";
+	case kernel_type::PartitionKernel: return "PartitionKernel";
+	case kernel_type::SortAndSampleKernel: return "SortAndSampleKernel";
+	case kernel_type::PartitionSingleNodeKernel: return "PartitionSingleNodeKernel";
+	case kernel_type::SortAndSampleSingleNodeKernel: return "SortAndSampleSingleNodeKernel";
+	case kernel_type::LimitKernel: return "LimitKernel";
+	case kernel_type::TopNKernel: return "TopNKernel";
+	case kernel_type::ComputeAggregateKernel: return "ComputeAggregateKernel";
+	case kernel_type::DistributeAggregateKernel: return "DistributeAggregateKernel";
+	case kernel_type::MergeAggregateKernel: return "MergeAggregateKernel";
+	case kernel_type::TableScanKernel: return "TableScanKernel";
+	case kernel_type::BindableTableScanKernel: return "BindableTableScanKernel";
+	case kernel_type::PartwiseJoinKernel: return "PartwiseJoinKernel";
+	case kernel_type::JoinPartitionKernel: return "JoinPartitionKernel";
+	case kernel_type::RuntimeFilterBuildKernel: return "RuntimeFilterBuildKernel";
+	}
+	return "";
+}
+
 
 }  // namespace cache
 }  // namespace ral
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "utilities/CommonOperations.h"
 #include "utilities/StringUtils.h"
+#include "utilities/Tracing.h"
 #include <CodeTimer.h>
 #include <blazingdb/io/Library/Logging/Logger.h>
 #include "blazingdb/concurrency/BlazingThread.h"
@@ -71,7 +72,7 @@ std::unique_ptr<ral::frame::BlazingTable> data_loader::load_data(
 	std::vector<BlazingThread> threads;
 
 	for(int file_set_index = 0; file_set_index < file_sets.size(); file_set_index++) {
-		threads.push_back(BlazingThread([&, file_set_index]() {
+		threads.push_back(BlazingThread(ral::utilities::with_trace_query([&, file_set_index]() {
 			for (int file_in_set = 0; file_in_set < file_sets[file_set_index].size(); file_in_set++) {
 				int file_index = file_in_set * MAX_NUM_LOADING_THREADS + file_set_index;
 
@@ -150,7 +151,7 @@ std::unique_ptr<ral::frame::BlazingTable> data_loader::load_data(
 						"", "", "", "ERROR: Was unable to open " + file_sets[file_set_index][file_in_set].uri.toString()));
 				}
 			}
-		}));
+		})));
 	}
 	std::for_each(threads.begin(), threads.end(), [](BlazingThread & this_thread) { this_thread.join(); });
 
@@ -221,10 +222,38 @@ std::unique_ptr<ral::frame::BlazingTable> data_loader::load_batch(
 		std::iota(column_indices.begin(), column_indices.end(), 0);
 	}
 
+	ral::utilities::trace_span span("io", "parse_batch", context ? context->getContextToken() : ral::utilities::NO_TRACE_QUERY);
 	std::unique_ptr<ral::frame::BlazingTable> loaded_table = parser->parse_batch(file_data_handle.fileHandle, fileSchema, column_indices, row_group_ids);
+	if(loaded_table) {
+		span.set_arg("rows", loaded_table->num_rows());
+	}
 	return std::move(loaded_table);
 }
 
+std::unique_ptr<ral::frame::BlazingTable> data_loader::load_scan_unit(
+	Context * context,
+	const std::vector<size_t> & column_indices_in,
+	const Schema & schema,
+	data_handle file_data_handle,
+	size_t file_index,
+	const scan_unit & unit) {
+
+	auto fileSchema = schema.fileSchema(file_index);
+
+	std::vector<size_t> column_indices = column_indices_in;
+	if (column_indices.size() == 0) {  // including all columns by default
+		column_indices.resize(fileSchema.get_num_columns());
+		std::iota(column_indices.begin(), column_indices.end(), 0);
+	}
+
+	ral::utilities::trace_span span("io", "parse_scan_unit", context ? context->getContextToken() : ral::utilities::NO_TRACE_QUERY);
+	std::unique_ptr<ral::frame::BlazingTable> loaded_table = parser->parse_scan_unit(file_data_handle.fileHandle, fileSchema, column_indices, unit);
+	if(loaded_table) {
+		span.set_arg("rows", loaded_table->num_rows());
+	}
+	return loaded_table;
+}
+
 
 void data_loader::get_schema(Schema & schema, std::vector<std::pair<std::string, cudf::type_id>> non_file_columns) {
 	bool got_schema = false;
@@ -55,6 +55,15 @@ public:
 		size_t file_index,
 		std::vector<cudf::size_type> row_group_ids);
 
+	// Like load_batch, for a unit of the file that data_parser::get_scan_units made
+	std::unique_ptr<ral::frame::BlazingTable>  load_scan_unit(
+		Context * context,
+		const std::vector<size_t> & column_indices_in,
+		const Schema & schema,
+		data_handle file_data_handle,
+		size_t file_index,
+		const scan_unit & unit);
+
 	void get_schema(Schema & schema, std::vector<std::pair<std::string, cudf::type_id>> non_file_columns);
 
 	std::unique_ptr<ral::frame::BlazingTable> get_metadata(int offset);
@@ -21,13 +21,81 @@
 namespace ral {
 namespace io {
 
+namespace {
+
+// The bytes of a file are read this many at a time to find the ends of its rows
+const int64_t ROW_END_SEARCH_CHUNK_BYTES = 1 << 20;
+
+// Splits the num_bytes of the file into ranges of about target_bytes, like make_byte_range_scan_units, but only at the line
+// terminators that are outside of the quoted fields, since a quoted field can have line terminators too. Every range
+// but the first starts at the terminator of the last row of the previous one. The whole file is read to know which
+// terminators are quoted, and a file that can not be read gets a single unit
+std::vector<scan_unit> make_quoted_byte_range_scan_units(std::shared_ptr<arrow::io::RandomAccessFile> file,
+	int64_t num_bytes,
+	size_t target_bytes,
+	char quotechar,
+	char lineterminator) {
+	if(target_bytes == 0 || num_bytes <= static_cast<int64_t>(target_bytes)) {
+		return std::vector<scan_unit>(1);
+	}
+
+	std::vector<int64_t> range_offsets = {0};
+	int64_t next_range_offset = target_bytes;
+	bool in_quotes = false;  // a doubled quote inside of a quoted field toggles it twice
+	std::string chunk;
+	for(int64_t chunk_offset = 0; chunk_offset < num_bytes; chunk_offset += chunk.size()) {
+		chunk.resize(std::min(ROW_END_SEARCH_CHUNK_BYTES, num_bytes - chunk_offset));
+		int64_t bytes_read;
+		arrow::Status status = file->ReadAt(chunk_offset, chunk.size(), &bytes_read, &chunk[0]);
+		if(!status.ok() || bytes_read != static_cast<int64_t>(chunk.size())) {
+			return std::vector<scan_unit>(1);
+		}
+		for(size_t i = 0; i < chunk.size(); i++) {
+			if(chunk[i] == quotechar) {
+				in_quotes = !in_quotes;
+			} else if(chunk[i] == lineterminator && !in_quotes && chunk_offset + static_cast<int64_t>(i) >= next_range_offset) {
+				range_offsets.push_back(chunk_offset + i);
+				next_range_offset = chunk_offset + i + target_bytes;
+			}
+		}
+	}
+	if(range_offsets.size() == 1) {
+		return std::vector<scan_unit>(1);
+	}
+
+	std::vector<scan_unit> units(range_offsets.size());
+	for(size_t i = 0; i < range_offsets.size(); i++) {
+		units[i].byte_range_offset = range_offsets[i];
+		units[i].byte_range_size = (i + 1 < range_offsets.size() ? range_offsets[i + 1] : num_bytes) - range_offsets[i];
+	}
+	return units;
+}
+
+// The names of the columns of the file in the order of the file, which is the order that read_csv expects them in.
+// The schema of the table can have them in another order
+std::vector<std::string> get_names_in_file_order(const Schema & schema) {
+	std::vector<size_t> file_indices = schema.get_calcite_to_file_indices();
+	std::vector<std::string> names(schema.get_num_columns());
+	for(size_t i = 0; i < schema.get_num_columns(); i++) {
+		size_t file_index = file_indices.empty() ? i : file_indices[i];
+		if(file_index >= names.size()) {
+			names.resize(file_index + 1);
+		}
+		names[file_index] = schema.get_name(i);
+	}
+	return names;
+}
+
+}  // namespace
+
 csv_parser::csv_parser(cudf_io::read_csv_args args_) : csv_args{args_} {}
 
 csv_parser::~csv_parser() {}
 
 cudf_io::table_with_metadata read_csv_arg_arrow(cudf_io::read_csv_args new_csv_args,
 	std::shared_ptr<arrow::io::RandomAccessFile> arrow_file_handle,
-	bool first_row_only = false) {
+	bool first_row_only = false,
+	bool close_file = true) {
 
 	int64_t num_bytes;
 	arrow_file_handle->GetSize(&num_bytes);
@@ -46,7 +114,8 @@ cudf_io::table_with_metadata read_csv_arg_arrow(cudf_io::read_csv_args new_csv_a
 
 	cudf_io::table_with_metadata table_out = cudf_io::read_csv(new_csv_args);
 
-	arrow_file_handle->Close();
+	if(close_file)
+		arrow_file_handle->Close();
 
 	return std::move(table_out);
 }
@@ -62,13 +131,21 @@ std::unique_ptr<ral::frame::BlazingTable> csv_parser::parse(
 		return nullptr;
 	}
 
-	cudf_io::read_csv_args new_csv_arg = this->csv_args;
+	return parse_with_args(file, column_indices, this->csv_args, true);
+}
+
+std::unique_ptr<ral::frame::BlazingTable> csv_parser::parse_with_args(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	std::vector<size_t> column_indices,
+	cudf_io::read_csv_args new_csv_arg,
+	bool close_file) {
+
 	if(column_indices.size() > 0) {
 		// copy column_indices into use_col_indexes (at the moment is ordered only)
 		new_csv_arg.use_cols_indexes.resize(column_indices.size());
 		new_csv_arg.use_cols_indexes.assign(column_indices.begin(), column_indices.end());
 
-		cudf_io::table_with_metadata csv_table = read_csv_arg_arrow(new_csv_arg, file);
+		cudf_io::table_with_metadata csv_table = read_csv_arg_arrow(new_csv_arg, file, false, close_file);
 
 		if(csv_table.tbl->num_columns() <= 0)
 			Library::Logging::Logger().logWarn("csv_parser::parse no columns were read");
@@ -112,6 +189,53 @@ std::unique_ptr<ral::frame::BlazingTable> csv_parser::parse_batch(
 }
 
 
+std::unique_ptr<ral::frame::BlazingTable> csv_parser::parse_scan_unit(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const Schema & schema,
+	std::vector<size_t> column_indices,
+	const scan_unit & unit) {
+
+	if(file == nullptr || unit.byte_range_size == 0) {
+		return parse_batch(file, schema, column_indices, unit.row_groups);
+	}
+
+	cudf_io::read_csv_args new_csv_arg = this->csv_args;
+	new_csv_arg.byte_range_offset = unit.byte_range_offset;
+	new_csv_arg.byte_range_size = unit.byte_range_size;
+	if(unit.byte_range_offset > 0 && new_csv_arg.header == 0) {
+		// only the first range has the header, the other ones get the names of the columns of the file. Without a header
+		// read_csv names the columns the same way for every range
+		new_csv_arg.header = -1;
+		if(new_csv_arg.names.empty()) {
+			new_csv_arg.names = get_names_in_file_order(schema);
+		}
+	}
+	return parse_with_args(file, column_indices, new_csv_arg, false);
+}
+
+std::vector<scan_unit> csv_parser::get_scan_units(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::vector<cudf::size_type> & row_groups,
+	size_t target_bytes) {
+
+	// the rows that the options skip or limit are counted from the start of the file, and a compressed file can only
+	// be read from its start, so those are read whole. The arrow files do not have a name to infer the compression from
+	bool can_split = (this->csv_args.compression == cudf_io::compression_type::NONE ||
+		this->csv_args.compression == cudf_io::compression_type::AUTO) &&
+		this->csv_args.nrows == -1 && this->csv_args.skiprows == 0 && this->csv_args.skipfooter == 0 &&
+		this->csv_args.byte_range_offset == 0 && this->csv_args.byte_range_size == 0 && this->csv_args.header <= 0;
+	if(file == nullptr || !can_split) {
+		return data_parser::get_scan_units(file, row_groups, target_bytes);
+	}
+
+	int64_t num_bytes;
+	file->GetSize(&num_bytes);
+	if(this->csv_args.quoting == cudf_io::quote_style::NONE) {
+		return make_byte_range_scan_units(num_bytes, target_bytes);
+	}
+	return make_quoted_byte_range_scan_units(file, num_bytes, target_bytes, this->csv_args.quotechar, this->csv_args.lineterminator);
+}
+
 void csv_parser::parse_schema(
 	std::shared_ptr<arrow::io::RandomAccessFile> file, ral::io::Schema & schema) {
 
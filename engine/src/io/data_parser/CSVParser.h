@@ -37,9 +37,26 @@ public:
 		std::vector<size_t> column_indices,
 		std::vector<cudf::size_type> row_groups);
 
+	std::unique_ptr<ral::frame::BlazingTable> parse_scan_unit(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const Schema & schema,
+		std::vector<size_t> column_indices,
+		const scan_unit & unit);
+
+	std::vector<scan_unit> get_scan_units(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<cudf::size_type> & row_groups,
+		size_t target_bytes);
+
 	void parse_schema(std::shared_ptr<arrow::io::RandomAccessFile> file, ral::io::Schema & schema);
 
 private:
+	std::unique_ptr<ral::frame::BlazingTable> parse_with_args(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		std::vector<size_t> column_indices,
+		cudf_io::read_csv_args new_csv_arg,
+		bool close_file);
+
 	cudf_io::read_csv_args csv_args{cudf_io::source_info("")};
 };
 
@@ -11,12 +11,67 @@
 #include "../Schema.h"
 #include "execution_graph/logic_controllers/LogicPrimitives.h"
 #include "arrow/io/interfaces.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 namespace ral {
 namespace io {
 
+// Inclusive bounds of the values of a column that a scan needs. The ones of an integer column are kept as int64_t
+// and the ones of a floating point column as double
+struct column_value_range {
+	bool is_valid = false;
+	bool is_integer = false;
+	int64_t integer_min = 0;
+	int64_t integer_max = 0;
+	double float_min = 0;
+	double float_max = 0;
+};
+
+// A part of a file that a scan reads as one batch. The formats with row groups or stripes split a file by them, and the
+// text formats by ranges of bytes, which the reader extends to whole lines. A unit can also be a range of rows of the
+// file, when the page index of a parquet file shows that only some of the rows of its row groups are needed
+struct scan_unit {
+	std::vector<cudf::size_type> row_groups;  // empty means all of them, like in parse_batch
+	int64_t byte_range_offset = 0;
+	int64_t byte_range_size = 0;  // 0 means up to the end of the file
+	int64_t skip_rows = 0;
+	int64_t num_rows = -1;  // -1 when the unit is not a range of rows
+};
+
+// Groups consecutive row_groups, whose sizes in bytes are row_group_bytes, into units of at least target_bytes each,
+// except for the last one. A target_bytes of 0 makes a single unit
+inline std::vector<scan_unit> make_row_group_scan_units(
+	const std::vector<cudf::size_type> & row_groups, const std::vector<int64_t> & row_group_bytes, size_t target_bytes) {
+	std::vector<scan_unit> units(1);
+	int64_t unit_bytes = 0;
+	for(size_t i = 0; i < row_groups.size(); i++) {
+		if(target_bytes > 0 && unit_bytes >= static_cast<int64_t>(target_bytes)) {
+			units.emplace_back();
+			unit_bytes = 0;
+		}
+		units.back().row_groups.push_back(row_groups[i]);
+		unit_bytes += row_group_bytes[i];
+	}
+	return units;
+}
+
+// Splits the num_bytes of a file into ranges of target_bytes. A target_bytes of 0 makes a single unit
+inline std::vector<scan_unit> make_byte_range_scan_units(int64_t num_bytes, size_t target_bytes) {
+	if(target_bytes == 0 || num_bytes <= static_cast<int64_t>(target_bytes)) {
+		return std::vector<scan_unit>(1);
+	}
+	std::vector<scan_unit> units;
+	for(int64_t offset = 0; offset < num_bytes; offset += target_bytes) {
+		scan_unit unit;
+		unit.byte_range_offset = offset;
+		unit.byte_range_size = std::min<int64_t>(target_bytes, num_bytes - offset);
+		units.push_back(unit);
+	}
+	return units;
+}
+
 class data_parser {
 public:
 
@@ -35,6 +90,27 @@ public:
 		return nullptr; // TODO cordova ask ALexander why is not a pure virtual function as before
 	}
 
+	// Reads a unit of the file that get_scan_units made. The file can be shared by the units that are read at the same time,
+	// so it is not closed
+	virtual std::unique_ptr<ral::frame::BlazingTable> parse_scan_unit(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const Schema & schema,
+		std::vector<size_t> column_indices,
+		const scan_unit & unit) {
+		return parse_batch(file, schema, column_indices, unit.row_groups);
+	}
+
+	// Splits the row_groups of the file, or its bytes, into consecutive units of about target_bytes each. There is always
+	// at least one unit, and the formats that can not be split get one with the whole file
+	virtual std::vector<scan_unit> get_scan_units(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<cudf::size_type> & row_groups,
+		size_t target_bytes) {
+		scan_unit unit;
+		unit.row_groups = row_groups;
+		return {unit};
+	}
+
 	virtual size_t get_num_partitions() {
 		return 0;
 	}
@@ -45,6 +121,54 @@ public:
 	virtual std::unique_ptr<ral::frame::BlazingTable> get_metadata(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, int offset) {
 		return nullptr;
 	}
+
+	// Removes from row_groups the ones of the file that can not have values of the column inside range, according to the
+	// statistics of the file. An empty row_groups means all of them, like in parse_batch, so the ones that are left get listed.
+	// Returns how many were removed, the formats without statistics keep all of them
+	virtual size_t skip_row_groups_out_of_range(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::string & column_name,
+		const column_value_range & range,
+		std::vector<cudf::size_type> & row_groups) {
+		return 0;
+	}
+
+	// Removes from row_groups the ones of the file where the column does not have any of values, which are SQL literals,
+	// according to the dictionaries of its column chunks. Like skip_row_groups_out_of_range, an empty row_groups means all
+	// of them. Reads the dictionaries of up to max_threads row groups at a time and returns how many were removed. The row
+	// groups that are not fully dictionary encoded are kept, and so are all of them in the formats without dictionaries
+	virtual size_t skip_row_groups_without_values(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::string & column_name,
+		const std::vector<std::string> & values,
+		std::vector<cudf::size_type> & row_groups,
+		size_t max_threads) {
+		return 0;
+	}
+
+	// Narrows the units of the file to the rows of the pages where every column can have values inside its range, according
+	// to the page index of the file. The units that are left without rows are removed. Returns how many rows were cut
+	// out, the formats and the files without a page index keep all of them
+	virtual size_t skip_pages_out_of_range(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<std::string> & column_names,
+		const std::vector<column_value_range> & ranges,
+		std::vector<scan_unit> & units) {
+		return 0;
+	}
+
+	// A unit that reads the rows [begin_row, end_row) of unit, counting from its first row, and maybe some rows around them,
+	// for reading the other columns of the rows that a filter keeps. first_row is the row of unit where the narrowed unit
+	// starts. False for the formats that can only read the whole unit
+	virtual bool narrow_scan_unit(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const scan_unit & unit,
+		int64_t begin_row,
+		int64_t end_row,
+		scan_unit & narrowed_unit,
+		int64_t & first_row) {
+		return false;
+	}
 };
 
 } /* namespace io */
@@ -16,7 +16,8 @@ json_parser::~json_parser() {
 cudf::experimental::io::table_with_metadata read_json_file(
 	cudf::experimental::io::read_json_args args,
 	std::shared_ptr<arrow::io::RandomAccessFile> arrow_file_handle,
-	bool first_row_only = false)
+	bool first_row_only = false,
+	bool close_file = true)
 {
 	args.source = cudf::experimental::io::source_info(arrow_file_handle);
 
@@ -35,7 +36,8 @@ cudf::experimental::io::table_with_metadata read_json_file(
 
 	auto table_and_metadata = cudf::experimental::io::read_json(args);
 
-	arrow_file_handle->Close();
+	if(close_file)
+		arrow_file_handle->Close();
 
 	return std::move(table_and_metadata);
 }
@@ -49,10 +51,17 @@ std::unique_ptr<ral::frame::BlazingTable> json_parser::parse(
 		return nullptr;
 	}
 
-	cudf::experimental::io::read_json_args new_json_args = args;
+	return parse_with_args(file, column_indices, args, true);
+}
+
+std::unique_ptr<ral::frame::BlazingTable> json_parser::parse_with_args(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	std::vector<size_t> column_indices,
+	cudf::experimental::io::read_json_args new_json_args,
+	bool close_file) {
 
 	// All json columns are be read
-	auto table_and_metadata = read_json_file(args, file);
+	auto table_and_metadata = read_json_file(new_json_args, file, false, close_file);
 
 	if(table_and_metadata.tbl->num_columns() <= 0)
 		Library::Logging::Logger().logWarn("json_parser::parse no columns were read");
@@ -73,6 +82,52 @@ std::unique_ptr<ral::frame::BlazingTable> json_parser::parse(
 	return std::make_unique<ral::frame::BlazingTable>(std::make_unique<cudf::experimental::table>(std::move(selected_columns)), selected_column_names);	
 }
 
+std::unique_ptr<ral::frame::BlazingTable> json_parser::parse_batch(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const Schema & schema,
+	std::vector<size_t> column_indices,
+	std::vector<cudf::size_type> row_groups) {
+
+	if(file == nullptr) {
+		return schema.makeEmptyBlazingTable(column_indices);
+	}
+	return parse(file, schema, column_indices);
+}
+
+std::unique_ptr<ral::frame::BlazingTable> json_parser::parse_scan_unit(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const Schema & schema,
+	std::vector<size_t> column_indices,
+	const scan_unit & unit) {
+
+	if(file == nullptr || unit.byte_range_size == 0) {
+		return parse_batch(file, schema, column_indices, unit.row_groups);
+	}
+
+	cudf::experimental::io::read_json_args new_json_args = args;
+	new_json_args.byte_range_offset = unit.byte_range_offset;
+	new_json_args.byte_range_size = unit.byte_range_size;
+	return parse_with_args(file, column_indices, new_json_args, false);
+}
+
+std::vector<scan_unit> json_parser::get_scan_units(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::vector<cudf::size_type> & row_groups,
+	size_t target_bytes) {
+
+	// only the files with a record per line can be read from the middle
+	bool can_split = args.lines && (args.compression == cudf::experimental::io::compression_type::NONE ||
+		args.compression == cudf::experimental::io::compression_type::AUTO) &&
+		args.byte_range_offset == 0 && args.byte_range_size == 0;
+	if(file == nullptr || !can_split) {
+		return data_parser::get_scan_units(file, row_groups, target_bytes);
+	}
+
+	int64_t num_bytes;
+	file->GetSize(&num_bytes);
+	return make_byte_range_scan_units(num_bytes, target_bytes);
+}
+
 void json_parser::parse_schema(
 	std::shared_ptr<arrow::io::RandomAccessFile> file, ral::io::Schema & schema) {
 
@@ -21,9 +21,32 @@ public:
 		const Schema & schema,
 		std::vector<size_t> column_indices);
 
+	std::unique_ptr<ral::frame::BlazingTable> parse_batch(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const Schema & schema,
+		std::vector<size_t> column_indices,
+		std::vector<cudf::size_type> row_groups);
+
+	std::unique_ptr<ral::frame::BlazingTable> parse_scan_unit(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const Schema & schema,
+		std::vector<size_t> column_indices,
+		const scan_unit & unit);
+
+	std::vector<scan_unit> get_scan_units(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<cudf::size_type> & row_groups,
+		size_t target_bytes);
+
 	void parse_schema(std::shared_ptr<arrow::io::RandomAccessFile> file, Schema & schema);
 
 private:
+	std::unique_ptr<ral::frame::BlazingTable> parse_with_args(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		std::vector<size_t> column_indices,
+		cudf::experimental::io::read_json_args new_json_args,
+		bool close_file);
+
 	cudf::experimental::io::read_json_args args;
 };
 
@@ -1,4 +1,5 @@
 #include "OrcParser.h"
+#include "metadata/orc_metadata.h"
 
 #include <arrow/io/file.h>
 
@@ -85,6 +86,32 @@ std::unique_ptr<ral::frame::BlazingTable> orc_parser::parse_batch(
 	return nullptr;
 }
 
+std::vector<scan_unit> orc_parser::get_scan_units(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::vector<cudf::size_type> & row_groups,
+	size_t target_bytes) {
+
+	if(file == nullptr || target_bytes == 0) {
+		return data_parser::get_scan_units(file, row_groups, target_bytes);
+	}
+
+	std::unique_ptr<orc::Reader> orc_reader = open_orc_reader(file);
+
+	std::vector<cudf::size_type> stripes = row_groups;
+	if(stripes.empty()) {
+		stripes.resize(orc_reader->getNumberOfStripes());
+		std::iota(stripes.begin(), stripes.end(), 0);
+	}
+
+	// the stripes do not have their uncompressed size, so this is the one in the file
+	std::vector<int64_t> stripe_bytes(stripes.size());
+	for(size_t i = 0; i < stripes.size(); i++) {
+		stripe_bytes[i] = orc_reader->getStripe(stripes[i])->getLength();
+	}
+
+	return make_row_group_scan_units(stripes, stripe_bytes, target_bytes);
+}
+
 void orc_parser::parse_schema(
 	std::shared_ptr<arrow::io::RandomAccessFile> file, ral::io::Schema & schema) {
 
@@ -99,5 +126,9 @@ void orc_parser::parse_schema(
 	}
 }
 
+std::unique_ptr<ral::frame::BlazingTable> orc_parser::get_metadata(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, int offset) {
+	return get_minmax_metadata(files, offset);
+}
+
 } /* namespace io */
 } /* namespace ral */
@@ -30,8 +30,15 @@ public:
 		std::vector<size_t> column_indices,
 		std::vector<cudf::size_type> row_groups);
 
+	std::vector<scan_unit> get_scan_units(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<cudf::size_type> & row_groups,
+		size_t target_bytes);
+
 	void parse_schema(std::shared_ptr<arrow::io::RandomAccessFile> file, Schema & schema);
 
+	std::unique_ptr<ral::frame::BlazingTable> get_metadata(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, int offset);
+
 private:
 	cudf::experimental::io::read_orc_args orc_args{cudf_io::source_info("")};
 };
@@ -1,14 +1,26 @@
 
 #include "metadata/parquet_metadata.h"
+#include "metadata/parquet_page_index.h"
 
 #include "ParquetParser.h"
 #include "utilities/CommonOperations.h"
-
+#include "utilities/Tracing.h"
+#include "parser/expression_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <numeric>
+#include <unordered_set>
 
 #include <arrow/io/file.h>
 #include "blazingdb/concurrency/BlazingThread.h"
+#include <blazingdb/io/Util/StringUtil.h>
 
+#include <parquet/column_reader.h>
 #include <parquet/column_writer.h>
 #include <parquet/file_writer.h>
 
@@ -17,6 +29,247 @@ namespace io {
 
 namespace cudf_io = cudf::experimental::io;
 
+namespace {
+
+// Whether the integers of a column are read by cudf as they are stored, unlike decimals or unsigned integers
+bool is_signed_integer(parquet::ConvertedType::type converted_type) {
+	return converted_type == parquet::ConvertedType::NONE || converted_type == parquet::ConvertedType::INT_8 ||
+		   converted_type == parquet::ConvertedType::INT_16 || converted_type == parquet::ConvertedType::INT_32 ||
+		   converted_type == parquet::ConvertedType::INT_64;
+}
+
+// Whether the min and max of the statistics of a column chunk can have a value inside range.
+// The types whose values cudf does not read as they are stored, like decimals or unsigned integers, always can
+bool statistics_overlap(const std::shared_ptr<parquet::Statistics> & statistics, const column_value_range & range) {
+	bool is_signed_integer = ral::io::is_signed_integer(statistics->descr()->converted_type());
+
+	switch(statistics->physical_type()) {
+	case parquet::Type::INT32: {
+		auto typed_statistics = std::static_pointer_cast<parquet::Int32Statistics>(statistics);
+		return !range.is_integer || !is_signed_integer ||
+			   (typed_statistics->max() >= range.integer_min && typed_statistics->min() <= range.integer_max);
+	}
+	case parquet::Type::INT64: {
+		auto typed_statistics = std::static_pointer_cast<parquet::Int64Statistics>(statistics);
+		return !range.is_integer || !is_signed_integer ||
+			   (typed_statistics->max() >= range.integer_min && typed_statistics->min() <= range.integer_max);
+	}
+	case parquet::Type::FLOAT: {
+		auto typed_statistics = std::static_pointer_cast<parquet::FloatStatistics>(statistics);
+		return range.is_integer || (typed_statistics->max() >= range.float_min && typed_statistics->min() <= range.float_max);
+	}
+	case parquet::Type::DOUBLE: {
+		auto typed_statistics = std::static_pointer_cast<parquet::DoubleStatistics>(statistics);
+		return range.is_integer || (typed_statistics->max() >= range.float_min && typed_statistics->min() <= range.float_max);
+	}
+	default:
+		return true;
+	}
+}
+
+template <typename T>
+bool from_plain_bytes(const std::string & bytes, T & value) {
+	if(bytes.size() != sizeof(T)) {
+		return false;
+	}
+	std::memcpy(&value, bytes.data(), sizeof(T));
+	return true;
+}
+
+// The values are compared as the type of the range, which can hold all of them
+template <typename T, typename R>
+bool plain_range_overlaps(const std::string & min_bytes, const std::string & max_bytes, R range_min, R range_max) {
+	T min;
+	T max;
+	return !from_plain_bytes(min_bytes, min) || !from_plain_bytes(max_bytes, max) ||
+		   (static_cast<R>(max) >= range_min && static_cast<R>(min) <= range_max);
+}
+
+// Whether a page whose PLAIN encoded min and max are these can have a value inside range, like statistics_overlap
+bool page_overlaps(const parquet::ColumnDescriptor * column, const std::string & min, const std::string & max, const column_value_range & range) {
+	bool is_signed_integer = ral::io::is_signed_integer(column->converted_type());
+
+	switch(column->physical_type()) {
+	case parquet::Type::INT32:
+		return !range.is_integer || !is_signed_integer || plain_range_overlaps<int32_t>(min, max, range.integer_min, range.integer_max);
+	case parquet::Type::INT64:
+		return !range.is_integer || !is_signed_integer || plain_range_overlaps<int64_t>(min, max, range.integer_min, range.integer_max);
+	case parquet::Type::FLOAT:
+		return range.is_integer || plain_range_overlaps<float>(min, max, range.float_min, range.float_max);
+	case parquet::Type::DOUBLE:
+		return range.is_integer || plain_range_overlaps<double>(min, max, range.float_min, range.float_max);
+	default:
+		return true;
+	}
+}
+
+template <typename T>
+std::string to_plain_bytes(T value) {
+	std::string bytes(sizeof(T), '\0');
+	std::memcpy(&bytes[0], &value, sizeof(T));
+	return bytes;
+}
+
+// The bytes of the PLAIN encoding of the value of a column that is equal to literal, which is how the values of a dictionary
+// page are stored. False if they can not be compared that way, like the types that cudf reads as something else
+bool literal_to_plain_bytes(const parquet::ColumnDescriptor * column, const std::string & literal, std::string & bytes) {
+	parquet::ConvertedType::type converted_type = column->converted_type();
+	try {
+		switch(column->physical_type()) {
+		case parquet::Type::BYTE_ARRAY: {
+			if(!is_string(literal) || (converted_type != parquet::ConvertedType::NONE && converted_type != parquet::ConvertedType::UTF8)) {
+				return false;
+			}
+			bytes = literal.substr(1, literal.size() - 2);
+			StringUtil::findAndReplaceAll(bytes, "''", "'");
+			return true;
+		}
+		case parquet::Type::INT32: {
+			if(!is_number(literal) || (converted_type != parquet::ConvertedType::NONE && converted_type != parquet::ConvertedType::INT_8 &&
+				converted_type != parquet::ConvertedType::INT_16 && converted_type != parquet::ConvertedType::INT_32)) {
+				return false;
+			}
+			size_t end;
+			long long value = std::stoll(literal, &end);
+			if(end != literal.size() || value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+				return false;
+			}
+			bytes = to_plain_bytes(static_cast<int32_t>(value));
+			return true;
+		}
+		case parquet::Type::INT64: {
+			if(!is_number(literal) || (converted_type != parquet::ConvertedType::NONE && converted_type != parquet::ConvertedType::INT_64)) {
+				return false;
+			}
+			size_t end;
+			int64_t value = std::stoll(literal, &end);
+			if(end != literal.size()) {
+				return false;
+			}
+			bytes = to_plain_bytes(value);
+			return true;
+		}
+		case parquet::Type::DOUBLE: {
+			if(!is_number(literal) || converted_type != parquet::ConvertedType::NONE) {
+				return false;
+			}
+			double value = std::stod(literal);
+			// 0.0 and -0.0 are equal but their bytes are not
+			if(value == 0 || std::isnan(value)) {
+				return false;
+			}
+			bytes = to_plain_bytes(value);
+			return true;
+		}
+		default:
+			return false;
+		}
+	} catch(const std::exception & e) {
+		return false;
+	}
+}
+
+// Whether the data pages of the column chunk can only be dictionary encoded, from the encodings of its metadata. A writer
+// falls back to another encoding when the dictionary grows too big. PLAIN is also the encoding of the dictionary page of
+// the version 2 files and the Arrow writer lists it for every dictionary encoded chunk, so it does not tell whether some data
+// pages fell back to it, and then has_plain_pages is true
+bool only_dictionary_pages(const parquet::ColumnChunkMetaData & column_chunk, bool & has_plain_pages) {
+	has_plain_pages = false;
+	for(parquet::Encoding::type encoding : column_chunk.encodings()) {
+		switch(encoding) {
+		case parquet::Encoding::PLAIN_DICTIONARY:
+		case parquet::Encoding::RLE_DICTIONARY:
+		case parquet::Encoding::RLE:  // of the levels
+		case parquet::Encoding::BIT_PACKED:
+			break;
+		case parquet::Encoding::PLAIN:
+			has_plain_pages = true;
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// Whether the column chunk is dictionary encoded and none of the values of its dictionary are in plain_values.
+// Only the dictionary page is read, unless the encodings of the chunk do not tell if some of its data pages are PLAIN
+bool dictionary_excludes(parquet::RowGroupReader & row_group, int column_index, const std::unordered_set<std::string> & plain_values) {
+	bool has_plain_pages;
+	if(!only_dictionary_pages(*row_group.metadata()->ColumnChunk(column_index), has_plain_pages)) {
+		return false;
+	}
+
+	parquet::Type::type physical_type = row_group.metadata()->schema()->Column(column_index)->physical_type();
+	std::unique_ptr<parquet::PageReader> pages = row_group.GetColumnPageReader(column_index);
+
+	std::shared_ptr<parquet::Page> page = pages->NextPage();
+	if(page == nullptr || page->type() != parquet::PageType::DICTIONARY_PAGE) {
+		return false;
+	}
+	auto dictionary_page = std::static_pointer_cast<parquet::DictionaryPage>(page);
+	if(dictionary_page->encoding() != parquet::Encoding::PLAIN && dictionary_page->encoding() != parquet::Encoding::PLAIN_DICTIONARY) {
+		return false;
+	}
+
+	int64_t value_size = physical_type == parquet::Type::INT32 ? sizeof(int32_t) : sizeof(int64_t);
+	const uint8_t * data = dictionary_page->data();
+	int64_t size = dictionary_page->size();
+	int64_t offset = 0;
+	for(int32_t i = 0; i < dictionary_page->num_values(); i++) {
+		if(physical_type == parquet::Type::BYTE_ARRAY) {
+			uint32_t length;
+			if(offset + static_cast<int64_t>(sizeof(length)) > size) {
+				return false;
+			}
+			std::memcpy(&length, data + offset, sizeof(length));
+			offset += sizeof(length);
+			value_size = length;
+		}
+		if(offset + value_size > size) {
+			return false;
+		}
+		if(plain_values.count(std::string(reinterpret_cast<const char *>(data + offset), value_size)) > 0) {
+			return false;
+		}
+		offset += value_size;
+	}
+	if(!has_plain_pages) {
+		return true;
+	}
+
+	while((page = pages->NextPage()) != nullptr) {
+		parquet::Encoding::type encoding;
+		if(page->type() == parquet::PageType::DATA_PAGE) {
+			encoding = static_cast<const parquet::DataPage *>(page.get())->encoding();
+		} else if(page->type() == parquet::PageType::DATA_PAGE_V2) {
+			encoding = static_cast<const parquet::DataPageV2 *>(page.get())->encoding();
+		} else {
+			continue;
+		}
+		if(encoding != parquet::Encoding::PLAIN_DICTIONARY && encoding != parquet::Encoding::RLE_DICTIONARY) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::unique_ptr<ral::frame::BlazingTable> read_parquet_columns(const cudf_io::read_parquet_args & pq_args, size_t num_columns) {
+	auto result = cudf_io::read_parquet(pq_args);
+
+	auto result_table = std::move(result.tbl);
+	if (result.metadata.column_names.size() > num_columns) {
+		auto columns = result_table->release();
+		// Assuming columns are in the same order as column_indices and any extra columns (i.e. index column) are put last
+		columns.resize(num_columns);
+		result_table = std::make_unique<cudf::experimental::table>(std::move(columns));
+	}
+
+	return std::make_unique<ral::frame::BlazingTable>(std::move(result_table), result.metadata.column_names);
+}
+
+}  // namespace
+
 parquet_parser::parquet_parser() {
 	// TODO Auto-generated constructor stub
 }
@@ -121,17 +374,37 @@ std::unique_ptr<ral::frame::BlazingTable> parquet_parser::parse_batch(
 
 		pq_args.row_group_list = row_groups;
 
-		auto result = cudf_io::read_parquet(pq_args);
+		return read_parquet_columns(pq_args, column_indices.size());
+	}
+	return nullptr;
+}
+
+std::unique_ptr<ral::frame::BlazingTable> parquet_parser::parse_scan_unit(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const Schema & schema,
+	std::vector<size_t> column_indices,
+	const scan_unit & unit)
+{
+	if(unit.num_rows < 0) {
+		return parse_batch(file, schema, column_indices, unit.row_groups);
+	}
+	if(file == nullptr) {
+		return schema.makeEmptyBlazingTable(column_indices);
+	}
+	if(column_indices.size() > 0) {
+		cudf_io::read_parquet_args pq_args{cudf_io::source_info{file}};
+
+		pq_args.strings_to_categorical = false;
+		pq_args.columns.resize(column_indices.size());
 
-		auto result_table = std::move(result.tbl);
-		if (result.metadata.column_names.size() > column_indices.size()) {
-			auto columns = result_table->release();
-			// Assuming columns are in the same order as column_indices and any extra columns (i.e. index column) are put last
-			columns.resize(column_indices.size());
-			result_table = std::make_unique<cudf::experimental::table>(std::move(columns));
+		for(size_t column_i = 0; column_i < column_indices.size(); column_i++) {
+			pq_args.columns[column_i] = schema.get_name(column_indices[column_i]);
 		}
 
-		return std::make_unique<ral::frame::BlazingTable>(std::move(result_table), result.metadata.column_names);
+		pq_args.skip_rows = unit.skip_rows;
+		pq_args.num_rows = unit.num_rows;
+
+		return read_parquet_columns(pq_args, column_indices.size());
 	}
 	return nullptr;
 }
@@ -190,5 +463,359 @@ std::unique_ptr<ral::frame::BlazingTable> parquet_parser::get_metadata(std::vect
 	return std::move(minmax_metadata_table);
 }
 
+std::vector<scan_unit> parquet_parser::get_scan_units(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::vector<cudf::size_type> & row_groups,
+	size_t target_bytes) {
+
+	if(file == nullptr || target_bytes == 0) {
+		return data_parser::get_scan_units(file, row_groups, target_bytes);
+	}
+
+	auto parquet_reader = parquet::ParquetFileReader::Open(file);
+	std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_reader->metadata();
+
+	std::vector<cudf::size_type> unit_row_groups = row_groups;
+	if(unit_row_groups.empty()) {
+		unit_row_groups.resize(file_metadata->num_row_groups());
+		std::iota(unit_row_groups.begin(), unit_row_groups.end(), 0);
+	}
+
+	// the uncompressed size, which is closer to the one of the columns once they are decoded
+	std::vector<int64_t> row_group_bytes(unit_row_groups.size());
+	for(size_t i = 0; i < unit_row_groups.size(); i++) {
+		row_group_bytes[i] = file_metadata->RowGroup(unit_row_groups[i])->total_byte_size();
+	}
+	parquet_reader->Close();
+
+	return make_row_group_scan_units(unit_row_groups, row_group_bytes, target_bytes);
+}
+
+size_t parquet_parser::skip_row_groups_out_of_range(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::string & column_name,
+	const column_value_range & range,
+	std::vector<cudf::size_type> & row_groups) {
+
+	if(file == nullptr || !range.is_valid) {
+		return 0;
+	}
+
+	auto parquet_reader = parquet::ParquetFileReader::Open(file);
+	std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_reader->metadata();
+	int column_index = file_metadata->schema()->ColumnIndex(column_name);
+	if(column_index < 0) {
+		parquet_reader->Close();
+		return 0;
+	}
+
+	if(row_groups.empty()) {
+		row_groups.resize(file_metadata->num_row_groups());
+		std::iota(row_groups.begin(), row_groups.end(), 0);
+	}
+
+	std::vector<cudf::size_type> row_groups_in_range;
+	for(cudf::size_type row_group : row_groups) {
+		auto column_chunk = file_metadata->RowGroup(row_group)->ColumnChunk(column_index);
+		std::shared_ptr<parquet::Statistics> statistics = column_chunk->is_stats_set() ? column_chunk->statistics() : nullptr;
+		if(statistics == nullptr || !statistics->HasMinMax() || statistics_overlap(statistics, range)) {
+			row_groups_in_range.push_back(row_group);
+		}
+	}
+	parquet_reader->Close();
+
+	size_t num_skipped = row_groups.size() - row_groups_in_range.size();
+	row_groups = std::move(row_groups_in_range);
+	return num_skipped;
+}
+
+size_t parquet_parser::skip_row_groups_without_values(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::string & column_name,
+	const std::vector<std::string> & values,
+	std::vector<cudf::size_type> & row_groups,
+	size_t max_threads) {
+
+	if(file == nullptr || values.empty() || max_threads == 0) {
+		return 0;
+	}
+
+	auto parquet_reader = parquet::ParquetFileReader::Open(file);
+	std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_reader->metadata();
+	int column_index = file_metadata->schema()->ColumnIndex(column_name);
+	if(column_index < 0) {
+		parquet_reader->Close();
+		return 0;
+	}
+
+	std::unordered_set<std::string> plain_values;
+	for(const std::string & value : values) {
+		std::string bytes;
+		if(!literal_to_plain_bytes(file_metadata->schema()->Column(column_index), value, bytes)) {
+			parquet_reader->Close();
+			return 0;
+		}
+		plain_values.insert(bytes);
+	}
+
+	if(row_groups.empty()) {
+		row_groups.resize(file_metadata->num_row_groups());
+		std::iota(row_groups.begin(), row_groups.end(), 0);
+	}
+
+	// the pages are read with ranged reads of the file, so the row groups can be read at the same time
+	std::vector<char> excluded(row_groups.size(), false);
+	std::atomic<size_t> next_row_group(0);
+	std::vector<BlazingThread> threads(std::min(row_groups.size(), max_threads));
+	for(auto & thread : threads) {
+		thread = BlazingThread(ral::utilities::with_trace_query([&]() {
+			for(size_t i = next_row_group++; i < row_groups.size(); i = next_row_group++) {
+				if(!file_metadata->RowGroup(row_groups[i])->ColumnChunk(column_index)->has_dictionary_page()) {
+					continue;
+				}
+				try {
+					excluded[i] = dictionary_excludes(*parquet_reader->RowGroup(row_groups[i]), column_index, plain_values);
+				} catch(const std::exception & e) {
+					// a row group whose dictionary can not be read is kept, the scan reports the error if there is one
+				}
+			}
+		}));
+	}
+	for(auto & thread : threads) {
+		thread.join();
+	}
+	parquet_reader->Close();
+
+	std::vector<cudf::size_type> row_groups_with_values;
+	for(size_t i = 0; i < row_groups.size(); i++) {
+		if(!excluded[i]) {
+			row_groups_with_values.push_back(row_groups[i]);
+		}
+	}
+
+	size_t num_skipped = row_groups.size() - row_groups_with_values.size();
+	row_groups = std::move(row_groups_with_values);
+	return num_skipped;
+}
+
+size_t parquet_parser::skip_pages_out_of_range(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::vector<std::string> & column_names,
+	const std::vector<column_value_range> & ranges,
+	std::vector<scan_unit> & units) {
+
+	if(file == nullptr || units.empty() ||
+		std::none_of(ranges.begin(), ranges.end(), [](const column_value_range & range) { return range.is_valid; })) {
+		return 0;
+	}
+
+	// the footer and the page index locations are read once for all the columns
+	auto parquet_reader = parquet::ParquetFileReader::Open(file);
+	std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_reader->metadata();
+	std::vector<std::vector<parquet_page_index_location>> locations;
+	if(!read_page_index_locations(file, locations) || locations.size() != static_cast<size_t>(file_metadata->num_row_groups())) {
+		parquet_reader->Close();
+		return 0;
+	}
+	std::vector<int> column_indices;
+	std::vector<const column_value_range *> column_ranges;
+	for(size_t i = 0; i < column_names.size(); i++) {
+		int column_index = file_metadata->schema()->ColumnIndex(column_names[i]);
+		if(column_index >= 0 && ranges[i].is_valid) {
+			column_indices.push_back(column_index);
+			column_ranges.push_back(&ranges[i]);
+		}
+	}
+	if(column_indices.empty()) {
+		parquet_reader->Close();
+		return 0;
+	}
+
+	// the first row of each row group in the file, and the end of the last one
+	std::vector<int64_t> first_rows(file_metadata->num_row_groups() + 1, 0);
+	for(int row_group = 0; row_group < file_metadata->num_row_groups(); row_group++) {
+		first_rows[row_group + 1] = first_rows[row_group] + file_metadata->RowGroup(row_group)->num_rows();
+	}
+
+	// The rows of the file from the first to the last page of the row group that can have values inside range, for every
+	// column. The pages in between are read too, a row group is read from a single range. The columns without a page index
+	// in the row group do not narrow it
+	std::map<cudf::size_type, std::pair<int64_t, int64_t>> needed_rows;
+	auto get_needed_rows = [&](cudf::size_type row_group) {
+		auto it = needed_rows.find(row_group);
+		if(it != needed_rows.end()) {
+			return it->second;
+		}
+		std::pair<int64_t, int64_t> rows(first_rows[row_group], first_rows[row_group + 1]);
+		int64_t num_rows = rows.second - rows.first;
+		for(size_t i = 0; i < column_indices.size() && rows.first < rows.second; i++) {
+			int column_index = column_indices[i];
+			parquet_column_page_index page_index;
+			if(static_cast<size_t>(column_index) >= locations[row_group].size() ||
+				!read_column_page_index(file, locations[row_group][column_index], page_index)) {
+				continue;
+			}
+			const parquet::ColumnDescriptor * column = file_metadata->schema()->Column(column_index);
+			int64_t begin = -1;
+			int64_t end = -1;
+			for(size_t page = 0; page < page_index.pages.size(); page++) {
+				if(page_index.null_pages[page] ||
+					!page_overlaps(column, page_index.min_values[page], page_index.max_values[page], *column_ranges[i])) {
+					continue;
+				}
+				if(begin < 0) {
+					begin = page_index.pages[page].first_row_index;
+				}
+				end = page + 1 < page_index.pages.size() ? page_index.pages[page + 1].first_row_index : num_rows;
+			}
+			if(begin < 0) {
+				rows.second = rows.first;
+			} else {
+				rows.second = std::min(rows.second, first_rows[row_group] + end);
+				rows.first = std::min(std::max(rows.first, first_rows[row_group] + begin), rows.second);
+			}
+		}
+		needed_rows[row_group] = rows;
+		return rows;
+	};
+
+	size_t rows_skipped = 0;
+	std::vector<scan_unit> units_left;
+	for(const scan_unit & unit : units) {
+		std::vector<cudf::size_type> unit_row_groups;
+		for(cudf::size_type row_group = 0; row_group < file_metadata->num_row_groups(); row_group++) {
+			bool in_unit = unit.num_rows >= 0
+				? first_rows[row_group] < unit.skip_rows + unit.num_rows && first_rows[row_group + 1] > unit.skip_rows
+				: unit.row_groups.empty() || std::find(unit.row_groups.begin(), unit.row_groups.end(), row_group) != unit.row_groups.end();
+			if(in_unit) {
+				unit_row_groups.push_back(row_group);
+			}
+		}
+
+		// the rows that are left of each row group of the unit, merged when they are consecutive
+		int64_t unit_rows = 0;
+		int64_t rows_left = 0;
+		bool only_whole_row_groups = unit.num_rows < 0;
+		std::vector<cudf::size_type> row_groups_left;
+		std::vector<std::pair<int64_t, int64_t>> row_ranges_left;
+		for(cudf::size_type row_group : unit_row_groups) {
+			int64_t begin = first_rows[row_group];
+			int64_t end = first_rows[row_group + 1];
+			if(unit.num_rows >= 0) {
+				begin = std::max(begin, unit.skip_rows);
+				end = std::min(end, unit.skip_rows + unit.num_rows);
+			}
+			unit_rows += end - begin;
+
+			std::pair<int64_t, int64_t> needed = get_needed_rows(row_group);
+			begin = std::max(begin, needed.first);
+			end = std::min(end, needed.second);
+			if(begin >= end) {
+				continue;
+			}
+			rows_left += end - begin;
+			only_whole_row_groups = only_whole_row_groups && begin == first_rows[row_group] && end == first_rows[row_group + 1];
+			row_groups_left.push_back(row_group);
+			if(!row_ranges_left.empty() && row_ranges_left.back().second == begin) {
+				row_ranges_left.back().second = end;
+			} else {
+				row_ranges_left.emplace_back(begin, end);
+			}
+		}
+		rows_skipped += unit_rows - rows_left;
+
+		if(rows_left == unit_rows) {
+			units_left.push_back(unit);
+		} else if(only_whole_row_groups) {
+			if(!row_groups_left.empty()) {
+				scan_unit unit_left;
+				unit_left.row_groups = row_groups_left;
+				units_left.push_back(unit_left);
+			}
+		} else {
+			for(auto & row_range : row_ranges_left) {
+				scan_unit unit_left;
+				unit_left.skip_rows = row_range.first;
+				unit_left.num_rows = row_range.second - row_range.first;
+				units_left.push_back(unit_left);
+			}
+		}
+	}
+	parquet_reader->Close();
+
+	units = std::move(units_left);
+	return rows_skipped;
+}
+
+bool parquet_parser::narrow_scan_unit(
+	std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const scan_unit & unit,
+	int64_t begin_row,
+	int64_t end_row,
+	scan_unit & narrowed_unit,
+	int64_t & first_row) {
+
+	if(file == nullptr || begin_row >= end_row) {
+		return false;
+	}
+
+	narrowed_unit = scan_unit();
+	if(unit.num_rows >= 0) {
+		narrowed_unit.skip_rows = unit.skip_rows + begin_row;
+		narrowed_unit.num_rows = end_row - begin_row;
+		first_row = begin_row;
+		return true;
+	}
+
+	auto parquet_reader = parquet::ParquetFileReader::Open(file);
+	std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_reader->metadata();
+
+	std::vector<cudf::size_type> row_groups = unit.row_groups;
+	if(row_groups.empty()) {
+		row_groups.resize(file_metadata->num_row_groups());
+		std::iota(row_groups.begin(), row_groups.end(), 0);
+	}
+	std::vector<int64_t> file_first_rows(file_metadata->num_row_groups() + 1, 0);
+	for(int row_group = 0; row_group < file_metadata->num_row_groups(); row_group++) {
+		file_first_rows[row_group + 1] = file_first_rows[row_group] + file_metadata->RowGroup(row_group)->num_rows();
+	}
+	parquet_reader->Close();
+
+	// the row groups of the unit that have rows in the range, they are read in the order of the unit
+	size_t first = row_groups.size();
+	size_t last = 0;
+	int64_t first_unit_row = 0;
+	int64_t unit_row = 0;
+	for(size_t i = 0; i < row_groups.size(); i++) {
+		int64_t num_rows = file_first_rows[row_groups[i] + 1] - file_first_rows[row_groups[i]];
+		if(unit_row < end_row && unit_row + num_rows > begin_row) {
+			if(first == row_groups.size()) {
+				first = i;
+				first_unit_row = unit_row;
+			}
+			last = i;
+		}
+		unit_row += num_rows;
+	}
+	if(first == row_groups.size()) {
+		return false;
+	}
+
+	bool consecutive = true;
+	for(size_t i = first + 1; i <= last; i++) {
+		consecutive = consecutive && row_groups[i] == row_groups[i - 1] + 1;
+	}
+	if(consecutive) {
+		// consecutive row groups are the same rows of the file, so only the range itself is read
+		narrowed_unit.skip_rows = file_first_rows[row_groups[first]] + begin_row - first_unit_row;
+		narrowed_unit.num_rows = end_row - begin_row;
+		first_row = begin_row;
+	} else {
+		narrowed_unit.row_groups.assign(row_groups.begin() + first, row_groups.begin() + last + 1);
+		first_row = first_unit_row;
+	}
+	return true;
+}
+
 } /* namespace io */
 } /* namespace ral */
@@ -32,10 +32,48 @@ public:
 		std::vector<size_t> column_indices,
 		std::vector<cudf::size_type> row_groups);
 
+	std::unique_ptr<ral::frame::BlazingTable> parse_scan_unit(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const Schema & schema,
+		std::vector<size_t> column_indices,
+		const scan_unit & unit);
+
 	void parse_schema(std::shared_ptr<arrow::io::RandomAccessFile> file, Schema & schema);
 
 	std::unique_ptr<ral::frame::BlazingTable> get_metadata(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, int offset);
 
+	std::vector<scan_unit> get_scan_units(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<cudf::size_type> & row_groups,
+		size_t target_bytes);
+
+	size_t skip_row_groups_out_of_range(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::string & column_name,
+		const column_value_range & range,
+		std::vector<cudf::size_type> & row_groups);
+
+	size_t skip_row_groups_without_values(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::string & column_name,
+		const std::vector<std::string> & values,
+		std::vector<cudf::size_type> & row_groups,
+		size_t max_threads);
+
+	size_t skip_pages_out_of_range(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::vector<std::string> & column_names,
+		const std::vector<column_value_range> & ranges,
+		std::vector<scan_unit> & units);
+
+	bool narrow_scan_unit(
+		std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const scan_unit & unit,
+		int64_t begin_row,
+		int64_t end_row,
+		scan_unit & narrowed_unit,
+		int64_t & first_row);
+
 };
 
 } /* namespace io */
@@ -0,0 +1,187 @@
+#include "common_metadata.h"
+#include <rmm/rmm.h>
+#include <cudf/column/column_factories.hpp>
+#include "from_cudf/cpp_tests/utilities/column_wrapper.hpp"
+#include <limits>
+#include <stdexcept>
+
+std::unique_ptr<ral::frame::BlazingTable> makeMetadataTable(std::vector<std::string> col_names) {
+	const int ncols = col_names.size();
+	std::vector<std::string> metadata_col_names;
+	metadata_col_names.resize(ncols*3 + 3);
+	
+	int metadata_col_index = -1;
+	for (int colIndex = 0; colIndex < ncols; ++colIndex){
+		std::string col_name = col_names[colIndex];
+		auto col_name_min = "min_" + std::to_string(colIndex) + "_" + col_name;
+		auto col_name_max = "max_" + std::to_string(colIndex)  + "_" + col_name;
+		auto col_name_null_count = "null_count_" + std::to_string(colIndex)  + "_" + col_name;
+		
+		metadata_col_names[++metadata_col_index] = col_name_min;
+		metadata_col_names[++metadata_col_index] = col_name_max;
+		metadata_col_names[++metadata_col_index] = col_name_null_count;
+	}
+
+	metadata_col_names[++metadata_col_index] = "num_rows";
+	metadata_col_names[++metadata_col_index] = "file_handle_index";
+	metadata_col_names[++metadata_col_index] = "row_group_index";
+	
+	std::vector<std::unique_ptr<cudf::column>> minmax_metadata_gdf_table;
+	minmax_metadata_gdf_table.resize(metadata_col_names.size());
+	for (int i = 0; i < metadata_col_names.size(); ++i) {
+		//std::unique_ptr<cudf::column> empty = cudf::make_empty_column(cudf::data_type(cudf::type_id::INT32));
+		cudf::test::fixed_width_column_wrapper<int32_t> expected_col2{{(int32_t)-1}};
+		minmax_metadata_gdf_table[i] = expected_col2.release();
+	}
+	
+	auto cudf_metadata_table = std::make_unique<cudf::experimental::table>(std::move(minmax_metadata_gdf_table));
+	auto metadata_table = std::make_unique<ral::frame::BlazingTable>(std::move(cudf_metadata_table), metadata_col_names);
+
+	return metadata_table;
+}
+
+namespace {
+
+// T is the type of the column, Stored the one its values are kept as
+template <typename T, typename Stored = T>
+void push_type_limits(std::vector<std::vector<int64_t>> & minmax_metadata_table, int col_index, bool all_null) {
+	Stored lowest = std::numeric_limits<T>::lowest();
+	Stored max = std::numeric_limits<T>::max();
+	push_min_max<Stored>(minmax_metadata_table, col_index, all_null ? max : lowest, all_null ? lowest : max);
+}
+
+}  // namespace
+
+void push_min_max_limits(std::vector<std::vector<int64_t>> & minmax_metadata_table, int col_index, cudf::type_id dtype, bool all_null) {
+	switch(dtype) {
+	case cudf::type_id::BOOL8:
+		push_type_limits<bool, int64_t>(minmax_metadata_table, col_index, all_null);
+		break;
+	case cudf::type_id::INT8:
+		push_type_limits<int8_t, int64_t>(minmax_metadata_table, col_index, all_null);
+		break;
+	case cudf::type_id::INT16:
+		push_type_limits<int16_t, int64_t>(minmax_metadata_table, col_index, all_null);
+		break;
+	case cudf::type_id::INT32:
+	case cudf::type_id::TIMESTAMP_DAYS:
+		push_type_limits<int32_t, int64_t>(minmax_metadata_table, col_index, all_null);
+		break;
+	case cudf::type_id::INT64:
+	case cudf::type_id::TIMESTAMP_SECONDS:
+	case cudf::type_id::TIMESTAMP_MILLISECONDS:
+	case cudf::type_id::TIMESTAMP_MICROSECONDS:
+	case cudf::type_id::TIMESTAMP_NANOSECONDS:
+		push_type_limits<int64_t>(minmax_metadata_table, col_index, all_null);
+		break;
+	case cudf::type_id::FLOAT32:
+		push_type_limits<float>(minmax_metadata_table, col_index, all_null);
+		break;
+	case cudf::type_id::FLOAT64:
+		push_type_limits<double>(minmax_metadata_table, col_index, all_null);
+		break;
+	default:
+		throw std::runtime_error("Invalid dtype in push_min_max_limits");
+	}
+}
+
+void push_string_min_max(std::vector<std::vector<std::string>> & string_metadata_table, int col_index, const std::string & min, const std::string & max) {
+	string_metadata_table[col_index].push_back(min.substr(0, MAX_METADATA_STRING_BYTES));
+	if(max.size() > MAX_METADATA_STRING_BYTES) {
+		string_metadata_table[col_index + 1].push_back(max.substr(0, MAX_METADATA_STRING_BYTES) + METADATA_STRING_MAX_BYTE);
+	} else {
+		string_metadata_table[col_index + 1].push_back(max);
+	}
+}
+
+void push_string_min_max_limits(std::vector<std::vector<std::string>> & string_metadata_table, int col_index, bool all_null) {
+	std::string lowest = "";
+	std::string max(1, METADATA_STRING_MAX_BYTE);
+	string_metadata_table[col_index].push_back(all_null ? max : lowest);
+	string_metadata_table[col_index + 1].push_back(all_null ? lowest : max);
+}
+
+std::basic_string<char> get_typed_vector_content(cudf::type_id dtype, std::vector<int64_t> &vector) {
+  std::basic_string<char> output;
+  switch (dtype) {
+	case cudf::type_id::INT8:{
+			std::vector<char> typed_v(vector.begin(), vector.end());
+			output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(char));
+			break;
+		}
+	case cudf::type_id::INT16: {
+		std::vector<int16_t> typed_v(vector.begin(), vector.end());
+		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int16_t));
+		break;
+	}
+	case cudf::type_id::INT32:{
+		std::vector<int32_t> typed_v(vector.begin(), vector.end());
+		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int32_t));
+		break;
+	}
+	case cudf::type_id::INT64: {
+		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
+		break;
+	}
+	case cudf::type_id::FLOAT32: {
+		float* casted_metadata = reinterpret_cast<float*>(&(vector[0]));
+		output = std::basic_string<char>((char *)casted_metadata, vector.size() * sizeof(float));
+		break;
+	}
+	case cudf::type_id::FLOAT64: {
+		double* casted_metadata = reinterpret_cast<double*>(&(vector[0]));
+		output = std::basic_string<char>((char *)casted_metadata, vector.size() * sizeof(double));
+		break;
+	}
+	case cudf::type_id::BOOL8: {
+		std::vector<int8_t> typed_v(vector.begin(), vector.end());
+		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int8_t));
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_DAYS: {
+		std::vector<int32_t> typed_v(vector.begin(), vector.end());
+		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int32_t));
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_SECONDS: {
+		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_MILLISECONDS: {
+		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_MICROSECONDS: {
+		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_NANOSECONDS: {
+		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
+		break;
+	}
+	default: {
+		// default return type since we're throwing an exception.
+		std::cerr << "Invalid gdf_dtype in create_host_column" << std::endl;
+		throw std::runtime_error("Invalid gdf_dtype in create_host_column");
+	}
+  }
+  return output;
+}
+
+std::unique_ptr<cudf::column> make_cudf_column_from(cudf::data_type dtype, std::basic_string<char> &vector, unsigned long column_size) {
+	size_t width_per_value = cudf::size_of(dtype);
+	if (vector.size() != 0) {
+		auto buffer_size = width_per_value * column_size;
+		rmm::device_buffer gpu_buffer(vector.data(), buffer_size);
+		return std::make_unique<cudf::column>(dtype, column_size, std::move(gpu_buffer));
+	} else {
+		auto buffer_size = width_per_value * column_size;
+		rmm::device_buffer gpu_buffer(buffer_size);
+		return std::make_unique<cudf::column>(dtype, column_size, buffer_size);
+	}
+}
+
+std::unique_ptr<cudf::column> make_cudf_string_column_from(const std::vector<std::string> & strings) {
+	cudf::test::strings_column_wrapper column(strings.begin(), strings.end());
+	return column.release();
+}
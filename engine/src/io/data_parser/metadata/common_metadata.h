@@ -0,0 +1,51 @@
+#ifndef BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_COMMON_METADATA_H_
+#define BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_COMMON_METADATA_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cudf/cudf.h>
+#include <execution_graph/logic_controllers/LogicPrimitives.h>
+
+// The metadata of a file format is a table with a min_<i>_<name>, a max_<i>_<name> and a null_count_<i>_<name> column for
+// each column i that has statistics, then a num_rows, a file_handle_index and a row_group_index column, with a row per row
+// group (or stripe) of each file. A null count of -1 means that it is not known
+
+// Strings are kept as a prefix of at most this many bytes, see push_string_min_max
+const size_t MAX_METADATA_STRING_BYTES = 64;
+
+// Greater than every byte of a UTF-8 string, so a string that ends with it is greater than all the ones with its prefix
+const char METADATA_STRING_MAX_BYTE = '\xff';
+
+// The metadata of a set of files that have no row groups, which has a single row with -1 in every column
+std::unique_ptr<ral::frame::BlazingTable> makeMetadataTable(std::vector<std::string> col_names);
+
+// Adds the min and the max of a row group, floats and doubles are kept as their bits
+template <typename T>
+void push_min_max(std::vector<std::vector<int64_t>> & minmax_metadata_table, int col_index, T min, T max) {
+	minmax_metadata_table[col_index].push_back(0);
+	minmax_metadata_table[col_index + 1].push_back(0);
+	size_t current_row_index = minmax_metadata_table[col_index].size() - 1;
+	reinterpret_cast<T *>(&(minmax_metadata_table[col_index][0]))[current_row_index] = min;
+	reinterpret_cast<T *>(&(minmax_metadata_table[col_index + 1][0]))[current_row_index] = max;
+}
+
+// Adds a min and a max for a row group whose column has no statistics, or whose values are all null. When the values are
+// not known they are every value of the type, so that the row group is never skipped. When they are all null the min is
+// greater than the max, so that every comparison with the column skips the row group, as none of its rows can match
+void push_min_max_limits(std::vector<std::vector<int64_t>> & minmax_metadata_table, int col_index, cudf::type_id dtype, bool all_null);
+
+// The string versions of the above, truncated to MAX_METADATA_STRING_BYTES. A truncated max gets METADATA_STRING_MAX_BYTE
+// appended so that it is still greater than or equal to the original
+void push_string_min_max(std::vector<std::vector<std::string>> & string_metadata_table, int col_index, const std::string & min, const std::string & max);
+void push_string_min_max_limits(std::vector<std::vector<std::string>> & string_metadata_table, int col_index, bool all_null);
+
+// The bytes of the values of a metadata column, which are kept as int64_t (or as the bits of a float or a double) while
+// the metadata is read
+std::basic_string<char> get_typed_vector_content(cudf::type_id dtype, std::vector<int64_t> &vector);
+
+std::unique_ptr<cudf::column> make_cudf_column_from(cudf::data_type dtype, std::basic_string<char> &vector, unsigned long column_size);
+
+std::unique_ptr<cudf::column> make_cudf_string_column_from(const std::vector<std::string> & strings);
+
+#endif	// BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_COMMON_METADATA_H_
@@ -0,0 +1,299 @@
+#include "orc_metadata.h"
+#include "common_metadata.h"
+#include "blazingdb/concurrency/BlazingThread.h"
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+namespace ral {
+namespace io {
+
+namespace {
+
+// The ORC library reads its files through an orc::InputStream
+class arrow_orc_input_stream : public orc::InputStream {
+public:
+	arrow_orc_input_stream(std::shared_ptr<arrow::io::RandomAccessFile> file) : file(file), name("arrow_file") {
+		arrow::Status status = file->GetSize(&length);
+		if(!status.ok()) {
+			throw std::runtime_error("Could not get the size of the ORC file: " + status.ToString());
+		}
+	}
+
+	uint64_t getLength() const override { return length; }
+
+	uint64_t getNaturalReadSize() const override { return 128 * 1024; }
+
+	void read(void * buf, uint64_t length, uint64_t offset) override {
+		int64_t bytes_read;
+		arrow::Status status = file->ReadAt(offset, length, &bytes_read, buf);
+		if(!status.ok() || bytes_read != length) {
+			throw std::runtime_error("Could not read the ORC file: " + status.ToString());
+		}
+	}
+
+	const std::string & getName() const override { return name; }
+
+private:
+	std::shared_ptr<arrow::io::RandomAccessFile> file;
+	int64_t length;
+	std::string name;
+};
+
+const size_t MAX_METADATA_THREADS = 16;
+
+// Calls work for every file, with at most MAX_METADATA_THREADS files at a time
+void for_each_file(size_t num_files, const std::function<void(size_t)> & work) {
+	std::atomic<size_t> next_file(0);
+	std::vector<BlazingThread> threads(std::min(num_files, MAX_METADATA_THREADS));
+	for(auto & thread : threads) {
+		thread = BlazingThread([&next_file, num_files, &work]() {
+			for(size_t file_index = next_file++; file_index < num_files; file_index = next_file++) {
+				work(file_index);
+			}
+		});
+	}
+	for(auto & thread : threads) {
+		thread.join();
+	}
+}
+
+// The type that cudf reads a column of this kind as, EMPTY for the kinds whose statistics do not have a min and a max
+cudf::type_id to_dtype(orc::TypeKind kind) {
+	switch(kind) {
+	case orc::TypeKind::BOOLEAN:
+		return cudf::type_id::BOOL8;
+	case orc::TypeKind::BYTE:
+		return cudf::type_id::INT8;
+	case orc::TypeKind::SHORT:
+		return cudf::type_id::INT16;
+	case orc::TypeKind::INT:
+		return cudf::type_id::INT32;
+	case orc::TypeKind::LONG:
+		return cudf::type_id::INT64;
+	case orc::TypeKind::FLOAT:
+		return cudf::type_id::FLOAT32;
+	case orc::TypeKind::DOUBLE:
+		return cudf::type_id::FLOAT64;
+	case orc::TypeKind::DATE:
+		return cudf::type_id::TIMESTAMP_DAYS;
+	case orc::TypeKind::TIMESTAMP:
+		return cudf::type_id::TIMESTAMP_NANOSECONDS;
+	case orc::TypeKind::STRING:
+	case orc::TypeKind::VARCHAR:
+	case orc::TypeKind::CHAR:
+		return cudf::type_id::STRING;
+	default:
+		return cudf::type_id::EMPTY;
+	}
+}
+
+// Adds the min, max and null count of a column of a stripe. The stripes without a min and a max, i.e. when all the values
+// are null or the file was written without statistics, get the limits of push_min_max_limits
+void set_min_max(std::vector<std::vector<int64_t>> & minmax_metadata_table,
+	std::vector<std::vector<std::string>> & string_metadata_table,
+	int col_index,
+	cudf::type_id dtype,
+	uint64_t num_rows,
+	const orc::ColumnStatistics * statistics) {
+
+	// the number of values does not count the nulls
+	int64_t null_count = statistics != nullptr ? num_rows - statistics->getNumberOfValues() : -1;
+	minmax_metadata_table[col_index + 2].push_back(null_count);
+	bool all_null = num_rows > 0 && static_cast<uint64_t>(null_count) == num_rows;
+
+	switch(dtype) {
+	case cudf::type_id::BOOL8: {
+		auto typed_statistics = dynamic_cast<const orc::BooleanColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasCount() && typed_statistics->getNumberOfValues() > 0) {
+			push_min_max<int64_t>(minmax_metadata_table, col_index, typed_statistics->getFalseCount() > 0 ? 0 : 1,
+				typed_statistics->getTrueCount() > 0 ? 1 : 0);
+			return;
+		}
+		break;
+	}
+	case cudf::type_id::INT8:
+	case cudf::type_id::INT16:
+	case cudf::type_id::INT32:
+	case cudf::type_id::INT64: {
+		auto typed_statistics = dynamic_cast<const orc::IntegerColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasMinimum() && typed_statistics->hasMaximum()) {
+			push_min_max<int64_t>(minmax_metadata_table, col_index, typed_statistics->getMinimum(), typed_statistics->getMaximum());
+			return;
+		}
+		break;
+	}
+	case cudf::type_id::FLOAT32: {
+		auto typed_statistics = dynamic_cast<const orc::DoubleColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasMinimum() && typed_statistics->hasMaximum()) {
+			push_min_max<float>(minmax_metadata_table, col_index, typed_statistics->getMinimum(), typed_statistics->getMaximum());
+			return;
+		}
+		break;
+	}
+	case cudf::type_id::FLOAT64: {
+		auto typed_statistics = dynamic_cast<const orc::DoubleColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasMinimum() && typed_statistics->hasMaximum()) {
+			push_min_max<double>(minmax_metadata_table, col_index, typed_statistics->getMinimum(), typed_statistics->getMaximum());
+			return;
+		}
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_DAYS: {
+		auto typed_statistics = dynamic_cast<const orc::DateColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasMinimum() && typed_statistics->hasMaximum()) {
+			push_min_max<int64_t>(minmax_metadata_table, col_index, typed_statistics->getMinimum(), typed_statistics->getMaximum());
+			return;
+		}
+		break;
+	}
+	case cudf::type_id::TIMESTAMP_NANOSECONDS: {
+		// the statistics are in milliseconds, so the max is the last nanosecond of its millisecond
+		auto typed_statistics = dynamic_cast<const orc::TimestampColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasMinimum() && typed_statistics->hasMaximum()) {
+			push_min_max<int64_t>(minmax_metadata_table, col_index, typed_statistics->getMinimum() * 1000000,
+				typed_statistics->getMaximum() * 1000000 + 999999);
+			return;
+		}
+		break;
+	}
+	case cudf::type_id::STRING: {
+		auto typed_statistics = dynamic_cast<const orc::StringColumnStatistics *>(statistics);
+		if(typed_statistics != nullptr && typed_statistics->hasMinimum() && typed_statistics->hasMaximum()) {
+			push_string_min_max(string_metadata_table, col_index, typed_statistics->getMinimum(), typed_statistics->getMaximum());
+		} else {
+			push_string_min_max_limits(string_metadata_table, col_index, all_null);
+		}
+		return;
+	}
+	default:
+		throw std::runtime_error("Invalid dtype in set_min_max for orc");
+	}
+	push_min_max_limits(minmax_metadata_table, col_index, dtype, all_null);
+}
+
+}  // namespace
+
+std::unique_ptr<orc::Reader> open_orc_reader(std::shared_ptr<arrow::io::RandomAccessFile> file) {
+	return orc::createReader(std::make_unique<arrow_orc_input_stream>(file), orc::ReaderOptions());
+}
+
+std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
+	const std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> & files, int metadata_offset) {
+
+	if(files.size() == 0) {
+		return nullptr;
+	}
+
+	std::vector<std::unique_ptr<orc::Reader>> orc_readers(files.size());
+	for_each_file(files.size(), [&files, &orc_readers](size_t file_index) {
+		orc_readers[file_index] = open_orc_reader(files[file_index]);
+	});
+
+	// the columns are taken from a file that has stripes, all the files of a table have the same ones
+	int valid_orc_reader = -1;
+	size_t total_num_stripes = 0;
+	for(size_t i = 0; i < orc_readers.size(); i++) {
+		total_num_stripes += orc_readers[i]->getNumberOfStripes();
+		if(valid_orc_reader == -1 && orc_readers[i]->getNumberOfStripes() > 0) {
+			valid_orc_reader = i;
+		}
+	}
+
+	if(valid_orc_reader == -1) {
+		const orc::Type & schema = orc_readers[0]->getType();
+		std::vector<std::string> col_names(schema.getSubtypeCount());
+		for(size_t i = 0; i < col_names.size(); i++) {
+			col_names[i] = schema.getFieldName(i);
+		}
+		return makeMetadataTable(col_names);
+	}
+
+	std::vector<std::string> metadata_names;
+	std::vector<cudf::data_type> metadata_dtypes;
+	std::vector<size_t> columns_with_metadata;
+
+	const orc::Type & schema = orc_readers[valid_orc_reader]->getType();
+	for(size_t colIndex = 0; colIndex < schema.getSubtypeCount(); colIndex++) {
+		cudf::type_id dtype = to_dtype(schema.getSubtype(colIndex)->getKind());
+		if(dtype == cudf::type_id::EMPTY) {
+			continue;
+		}
+		metadata_dtypes.push_back(cudf::data_type{dtype});
+		metadata_names.push_back("min_" + std::to_string(colIndex) + "_" + schema.getFieldName(colIndex));
+		metadata_dtypes.push_back(cudf::data_type{dtype});
+		metadata_names.push_back("max_" + std::to_string(colIndex) + "_" + schema.getFieldName(colIndex));
+		metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT64});
+		metadata_names.push_back("null_count_" + std::to_string(colIndex) + "_" + schema.getFieldName(colIndex));
+		columns_with_metadata.push_back(colIndex);
+	}
+	metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT64});
+	metadata_names.push_back("num_rows");
+	metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT32});
+	metadata_names.push_back("file_handle_index");
+	metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT32});
+	metadata_names.push_back("row_group_index");
+
+	size_t num_metadata_cols = metadata_names.size();
+
+	// each file only writes its own entry, so they do not need a lock
+	std::vector<std::vector<std::vector<int64_t>>> minmax_metadata_table_per_file(files.size());
+	std::vector<std::vector<std::vector<std::string>>> string_metadata_table_per_file(files.size());
+	for_each_file(files.size(), [&](size_t file_index) {
+		const std::unique_ptr<orc::Reader> & orc_reader = orc_readers[file_index];
+		uint64_t num_stripes = orc_reader->getNumberOfStripes();
+		if(num_stripes == 0) {
+			return;
+		}
+
+		std::vector<std::vector<int64_t>> this_minmax_metadata_table(num_metadata_cols);
+		std::vector<std::vector<std::string>> this_string_metadata_table(num_metadata_cols);
+		bool has_stripe_statistics = orc_reader->getNumberOfStripeStatistics() == num_stripes;
+		const orc::Type & file_schema = orc_reader->getType();
+		for(uint64_t stripe_index = 0; stripe_index < num_stripes; stripe_index++) {
+			uint64_t num_rows = orc_reader->getStripe(stripe_index)->getNumberOfRows();
+			std::unique_ptr<orc::StripeStatistics> stripe_statistics =
+				has_stripe_statistics ? orc_reader->getStripeStatistics(stripe_index) : nullptr;
+			for(size_t col_count = 0; col_count < columns_with_metadata.size(); col_count++) {
+				uint64_t column_id = file_schema.getSubtype(columns_with_metadata[col_count])->getColumnId();
+				const orc::ColumnStatistics * statistics =
+					stripe_statistics != nullptr ? stripe_statistics->getColumnStatistics(column_id) : nullptr;
+				set_min_max(this_minmax_metadata_table, this_string_metadata_table, col_count * 3,
+					metadata_dtypes[col_count * 3].id(), num_rows, statistics);
+			}
+			this_minmax_metadata_table[num_metadata_cols - 3].push_back(num_rows);
+			this_minmax_metadata_table[num_metadata_cols - 2].push_back(metadata_offset + file_index);
+			this_minmax_metadata_table[num_metadata_cols - 1].push_back(stripe_index);
+		}
+		minmax_metadata_table_per_file[file_index] = std::move(this_minmax_metadata_table);
+		string_metadata_table_per_file[file_index] = std::move(this_string_metadata_table);
+	});
+
+	// NOTE: the files have to keep their order, so that the file_handle_index match the ones of the HiveMetadata
+	std::vector<std::vector<int64_t>> minmax_metadata_table(num_metadata_cols);
+	std::vector<std::vector<std::string>> string_metadata_table(num_metadata_cols);
+	for(size_t file_index = 0; file_index < files.size(); file_index++) {
+		for(size_t j = 0; j < minmax_metadata_table_per_file[file_index].size(); j++) {
+			std::copy(minmax_metadata_table_per_file[file_index][j].begin(), minmax_metadata_table_per_file[file_index][j].end(),
+				std::back_inserter(minmax_metadata_table[j]));
+			std::copy(string_metadata_table_per_file[file_index][j].begin(), string_metadata_table_per_file[file_index][j].end(),
+				std::back_inserter(string_metadata_table[j]));
+		}
+	}
+
+	std::vector<std::unique_ptr<cudf::column>> minmax_metadata_gdf_table(num_metadata_cols);
+	for(size_t index = 0; index < num_metadata_cols; index++) {
+		if(metadata_dtypes[index].id() == cudf::type_id::STRING) {
+			minmax_metadata_gdf_table[index] = make_cudf_string_column_from(string_metadata_table[index]);
+			continue;
+		}
+		auto content = get_typed_vector_content(metadata_dtypes[index].id(), minmax_metadata_table[index]);
+		minmax_metadata_gdf_table[index] = make_cudf_column_from(metadata_dtypes[index], content, total_num_stripes);
+	}
+	auto table = std::make_unique<cudf::experimental::table>(std::move(minmax_metadata_gdf_table));
+
+	return std::make_unique<ral::frame::BlazingTable>(std::move(table), metadata_names);
+}
+
+} /* namespace io */
+} /* namespace ral */
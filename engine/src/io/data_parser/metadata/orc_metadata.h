@@ -0,0 +1,25 @@
+#ifndef BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_ORC_METADATA_H_
+#define BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_ORC_METADATA_H_
+
+#include <memory>
+#include <vector>
+#include <arrow/io/interfaces.h>
+#include <orc/OrcFile.hh>
+#include <execution_graph/logic_controllers/LogicPrimitives.h>
+
+namespace ral {
+namespace io {
+
+// A reader of the footer of an ORC file, i.e. its stripes and their statistics, that reads through the arrow file.
+// cudf only reads the data of the stripes, so this uses the ORC library for the rest
+std::unique_ptr<orc::Reader> open_orc_reader(std::shared_ptr<arrow::io::RandomAccessFile> file);
+
+// The min, max and null count of the columns of every stripe of the files, in the same layout as the metadata of the
+// parquet files, with the stripes as the row groups. The files are read in parallel by a bounded number of threads
+std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
+	const std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> & files, int metadata_offset);
+
+} /* namespace io */
+} /* namespace ral */
+
+#endif	// BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_ORC_METADATA_H_
@@ -6,48 +6,43 @@
 #define BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_PARQUET_METADATA_CPP_H_
 
 #include "parquet_metadata.h"
+#include "common_metadata.h"
 #include <rmm/rmm.h>
 #include "blazingdb/concurrency/BlazingThread.h"
 #include <cudf/column/column_factories.hpp>
 #include "from_cudf/cpp_tests/utilities/column_wrapper.hpp"
 
-std::unique_ptr<ral::frame::BlazingTable> makeMetadataTable(std::vector<std::string> col_names) {
-	const int ncols = col_names.size();
-	std::vector<std::string> metadata_col_names;
-	metadata_col_names.resize(ncols*2 + 2);
-	
-	int metadata_col_index = -1;
-	for (int colIndex = 0; colIndex < ncols; ++colIndex){
-		std::string col_name = col_names[colIndex];
-		auto col_name_min = "min_" + std::to_string(colIndex) + "_" + col_name;
-		auto col_name_max = "max_" + std::to_string(colIndex)  + "_" + col_name;
-		
-		metadata_col_names[++metadata_col_index] = col_name_min;
-		metadata_col_names[++metadata_col_index] = col_name_max;
-	}
-
-	metadata_col_names[++metadata_col_index] = "file_handle_index";
-	metadata_col_names[++metadata_col_index] = "row_group_index";
-	
-	std::vector<std::unique_ptr<cudf::column>> minmax_metadata_gdf_table;
-	minmax_metadata_gdf_table.resize(metadata_col_names.size());
-	for (int i = 0; i < metadata_col_names.size(); ++i) {
-		//std::unique_ptr<cudf::column> empty = cudf::make_empty_column(cudf::data_type(cudf::type_id::INT32));
-		cudf::test::fixed_width_column_wrapper<int32_t> expected_col2{{(int32_t)-1}};
-		minmax_metadata_gdf_table[i] = expected_col2.release();
-	}
-	
-	auto cudf_metadata_table = std::make_unique<cudf::experimental::table>(std::move(minmax_metadata_gdf_table));
-	auto metadata_table = std::make_unique<ral::frame::BlazingTable>(std::move(cudf_metadata_table), metadata_col_names);
-
-	return metadata_table;
-}
-
+// Adds the min, max and null count of a column of a row group. statistics is nullptr when the row group does not have them
 void set_min_max(
 	std::vector<std::vector<int64_t>> &minmax_metadata_table,
-	int col_index, parquet::Type::type physical,
+	std::vector<std::vector<std::string>> &string_metadata_table,
+	int col_index, cudf::type_id dtype, parquet::Type::type physical,
 	parquet::ConvertedType::type logical,
-	std::shared_ptr<parquet::Statistics> &statistics) {
+	int64_t num_rows,
+	std::shared_ptr<parquet::Statistics> statistics) {
+
+	int64_t null_count = statistics != nullptr ? statistics->null_count() : -1;
+	minmax_metadata_table[col_index + 2].push_back(null_count);
+
+	// i.e. all the values are null, or the writer did not keep them
+	if (statistics == nullptr || !statistics->HasMinMax()) {
+		bool all_null = num_rows > 0 && null_count == num_rows;
+		if (dtype == cudf::type_id::STRING) {
+			push_string_min_max_limits(string_metadata_table, col_index, all_null);
+		} else {
+			push_min_max_limits(minmax_metadata_table, col_index, dtype, all_null);
+		}
+		return;
+	}
+
+	if (physical == parquet::Type::type::BYTE_ARRAY) {
+		auto convertedStats =
+			std::static_pointer_cast<parquet::ByteArrayStatistics>(statistics);
+		push_string_min_max(string_metadata_table, col_index,
+			parquet::ByteArrayToString(convertedStats->min()),
+			parquet::ByteArrayToString(convertedStats->max()));
+		return;
+	}
 
 	int64_t dummy = 0;
 	minmax_metadata_table[col_index].push_back(dummy);
@@ -142,13 +137,8 @@ void set_min_max(
 		casted_metadata_max[current_row_index] = max;
 		break;
 	}
-	case parquet::Type::type::BYTE_ARRAY:
 	case parquet::Type::type::FIXED_LEN_BYTE_ARRAY: {
-		auto convertedStats =
-			std::static_pointer_cast<parquet::FLBAStatistics>(statistics);
-		// No min max for String columns
-		// minmax_metadata_table[col_index].push_back(-1);
-		// minmax_metadata_table[col_index + 1].push_back(-1);
+		// No min max for fixed length byte arrays, they are not taken as metadata columns
 		break;
 	}
 	case parquet::Type::type::INT96: {
@@ -212,86 +202,6 @@ cudf::type_id to_dtype(parquet::Type::type physical, parquet::ConvertedType::typ
 }
 
 
-std::basic_string<char> get_typed_vector_content(cudf::type_id dtype, std::vector<int64_t> &vector) {
-  std::basic_string<char> output;
-  switch (dtype) {
-	case cudf::type_id::INT8:{
-			std::vector<char> typed_v(vector.begin(), vector.end());
-			output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(char));
-			break;
-		}
-	case cudf::type_id::INT16: {
-		std::vector<int16_t> typed_v(vector.begin(), vector.end());
-		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int16_t));
-		break;
-	}
-	case cudf::type_id::INT32:{
-		std::vector<int32_t> typed_v(vector.begin(), vector.end());
-		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int32_t));
-		break;
-	}
-	case cudf::type_id::INT64: {
-		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
-		break;
-	}
-	case cudf::type_id::FLOAT32: {
-		float* casted_metadata = reinterpret_cast<float*>(&(vector[0]));
-		output = std::basic_string<char>((char *)casted_metadata, vector.size() * sizeof(float));
-		break;
-	}
-	case cudf::type_id::FLOAT64: {
-		double* casted_metadata = reinterpret_cast<double*>(&(vector[0]));
-		output = std::basic_string<char>((char *)casted_metadata, vector.size() * sizeof(double));
-		break;
-	}
-	case cudf::type_id::BOOL8: {
-		std::vector<int8_t> typed_v(vector.begin(), vector.end());
-		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int8_t));
-		break;
-	}
-	case cudf::type_id::TIMESTAMP_DAYS: {
-		std::vector<int32_t> typed_v(vector.begin(), vector.end());
-		output = std::basic_string<char>((char *)typed_v.data(), typed_v.size() * sizeof(int32_t));
-		break;
-	}
-	case cudf::type_id::TIMESTAMP_SECONDS: {
-		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
-		break;
-	}
-	case cudf::type_id::TIMESTAMP_MILLISECONDS: {
-		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
-		break;
-	}
-	case cudf::type_id::TIMESTAMP_MICROSECONDS: {
-		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
-		break;
-	}
-	case cudf::type_id::TIMESTAMP_NANOSECONDS: {
-		output = std::basic_string<char>((char *)vector.data(), vector.size() * sizeof(int64_t));
-		break;
-	}
-	default: {
-		// default return type since we're throwing an exception.
-		std::cerr << "Invalid gdf_dtype in create_host_column" << std::endl;
-		throw std::runtime_error("Invalid gdf_dtype in create_host_column");
-	}
-  }
-  return output;
-}
-
-std::unique_ptr<cudf::column> make_cudf_column_from(cudf::data_type dtype, std::basic_string<char> &vector, unsigned long column_size) {
-	size_t width_per_value = cudf::size_of(dtype);
-	if (vector.size() != 0) {
-		auto buffer_size = width_per_value * column_size;
-		rmm::device_buffer gpu_buffer(vector.data(), buffer_size);
-		return std::make_unique<cudf::column>(dtype, column_size, std::move(gpu_buffer));
-	} else {
-		auto buffer_size = width_per_value * column_size;
-		rmm::device_buffer gpu_buffer(buffer_size);
-		return std::make_unique<cudf::column>(dtype, column_size, buffer_size);
-	}
-}
-
 std::unique_ptr<cudf::column> make_empty_column(cudf::data_type type) {
   return std::make_unique<cudf::column>(type, 0, rmm::device_buffer{});
 }
@@ -346,22 +256,27 @@ std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
 			auto logical_type = column->converted_type();
 			cudf::data_type dtype = cudf::data_type (to_dtype(physical_type, logical_type)) ;
 
-			if (columnMetaData->is_stats_set() && dtype.id() != cudf::type_id::STRING) {
-				auto statistics = columnMetaData->statistics();
-				if (statistics->HasMinMax()) {
-					auto col_name_min = "min_" + std::to_string(colIndex) + "_" + column->name();
-					metadata_dtypes.push_back(dtype);
-					metadata_names.push_back(col_name_min);
-					
-					auto col_name_max = "max_" + std::to_string(colIndex)  + "_" + column->name();
-					metadata_dtypes.push_back(dtype);
-					metadata_names.push_back(col_name_max);
-
-					columns_with_metadata.push_back(colIndex);
-				}
+			// the row groups that are all nulls do not have a min and a max, they get the limits of push_min_max_limits
+			if (columnMetaData->is_stats_set() && dtype.id() != cudf::type_id::EMPTY &&
+					physical_type != parquet::Type::type::FIXED_LEN_BYTE_ARRAY) {
+				auto col_name_min = "min_" + std::to_string(colIndex) + "_" + column->name();
+				metadata_dtypes.push_back(dtype);
+				metadata_names.push_back(col_name_min);
+				
+				auto col_name_max = "max_" + std::to_string(colIndex)  + "_" + column->name();
+				metadata_dtypes.push_back(dtype);
+				metadata_names.push_back(col_name_max);
+
+				auto col_name_null_count = "null_count_" + std::to_string(colIndex)  + "_" + column->name();
+				metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT64});
+				metadata_names.push_back(col_name_null_count);
+
+				columns_with_metadata.push_back(colIndex);
 			}
 		}
 
+		metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT64});
+		metadata_names.push_back("num_rows");
 		metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT32});
 		metadata_names.push_back("file_handle_index");
 		metadata_dtypes.push_back(cudf::data_type{cudf::type_id::INT32});
@@ -371,6 +286,7 @@ std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
 	size_t num_metadata_cols = metadata_names.size();
 
 	std::vector<std::vector<std::vector<int64_t>>> minmax_metadata_table_per_file(parquet_readers.size());
+	std::vector<std::vector<std::vector<std::string>>> string_metadata_table_per_file(parquet_readers.size());
 
 	size_t file_index = 0;
 	std::vector<BlazingThread> threads(parquet_readers.size());
@@ -378,12 +294,13 @@ std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
 	for (size_t file_index = 0; file_index < parquet_readers.size(); file_index++){
 		// NOTE: It is really important to mantain the `file_index order` in order to match the same order in HiveMetadata
 		threads[file_index] = BlazingThread([&guard, metadata_offset,  &parquet_readers, file_index, 
-									&minmax_metadata_table_per_file, num_metadata_cols, columns_with_metadata](){
+									&minmax_metadata_table_per_file, &string_metadata_table_per_file, num_metadata_cols, columns_with_metadata, metadata_dtypes](){
 		  
 		std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_readers[file_index]->metadata();
 
 		if (file_metadata->num_row_groups() > 0){
 			std::vector<std::vector<int64_t>> this_minmax_metadata_table(num_metadata_cols);
+			std::vector<std::vector<std::string>> this_string_metadata_table(num_metadata_cols);
 
 			int num_row_groups = file_metadata->num_row_groups();
 			const parquet::SchemaDescriptor *schema = file_metadata->schema();
@@ -391,28 +308,28 @@ std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
 			for (int row_group_index = 0; row_group_index < num_row_groups; row_group_index++) {
 				auto groupReader = parquet_readers[file_index]->RowGroup(row_group_index);
 				auto *rowGroupMetadata = groupReader->metadata();
+				int64_t num_rows = rowGroupMetadata->num_rows();
 				for (int col_count = 0; col_count < columns_with_metadata.size();
 					col_count++) {
 					const parquet::ColumnDescriptor *column = schema->Column(columns_with_metadata[col_count]);
 					auto columnMetaData = rowGroupMetadata->ColumnChunk(columns_with_metadata[col_count]);
-					if (columnMetaData->is_stats_set()) {
-						auto statistics = columnMetaData->statistics();
-						if (statistics->HasMinMax()) {
-							set_min_max(this_minmax_metadata_table,
-							col_count * 2,
-										column->physical_type(),
-										column->converted_type(),
-										statistics);
-							
-						}
-					}
+					set_min_max(this_minmax_metadata_table,
+								this_string_metadata_table,
+								col_count * 3,
+								metadata_dtypes[col_count * 3].id(),
+								column->physical_type(),
+								column->converted_type(),
+								num_rows,
+								columnMetaData->is_stats_set() ? columnMetaData->statistics() : nullptr);
 				}
+				this_minmax_metadata_table[this_minmax_metadata_table.size() - 3].push_back(num_rows);
 				this_minmax_metadata_table[this_minmax_metadata_table.size() - 2].push_back(metadata_offset + file_index);
 				this_minmax_metadata_table[this_minmax_metadata_table.size() - 1].push_back(row_group_index);			  
 			}
 			
 			guard.lock();
 			minmax_metadata_table_per_file[file_index] = std::move(this_minmax_metadata_table);
+			string_metadata_table_per_file[file_index] = std::move(this_string_metadata_table);
 			guard.unlock();
 		}
 		});
@@ -422,16 +339,22 @@ std::unique_ptr<ral::frame::BlazingTable> get_minmax_metadata(
 	}
 
 	std::vector<std::vector<int64_t>> minmax_metadata_table = minmax_metadata_table_per_file[valid_parquet_reader];
+	std::vector<std::vector<std::string>> string_metadata_table = string_metadata_table_per_file[valid_parquet_reader];
 	for (size_t i = valid_parquet_reader + 1; i < 	minmax_metadata_table_per_file.size(); i++) {
 		for (size_t j = 0; j < 	minmax_metadata_table_per_file[i].size(); j++) {
 			std::copy(minmax_metadata_table_per_file[i][j].begin(), minmax_metadata_table_per_file[i][j].end(), std::back_inserter(minmax_metadata_table[j]));
+			std::copy(string_metadata_table_per_file[i][j].begin(), string_metadata_table_per_file[i][j].end(), std::back_inserter(string_metadata_table[j]));
 		}
 	}
 
 	std::vector<std::unique_ptr<cudf::column>> minmax_metadata_gdf_table(minmax_metadata_table.size());
 	for (size_t index = 0; index < 	minmax_metadata_table.size(); index++) {
-		auto vector = minmax_metadata_table[index];
 		auto dtype = metadata_dtypes[index];
+		if (dtype.id() == cudf::type_id::STRING) {
+			minmax_metadata_gdf_table[index] = make_cudf_string_column_from(string_metadata_table[index]);
+			continue;
+		}
+		auto vector = minmax_metadata_table[index];
 		auto content =  get_typed_vector_content(dtype.id(), vector);
 		minmax_metadata_gdf_table[index] = make_cudf_column_from(dtype, content, total_num_row_groups);
 	}
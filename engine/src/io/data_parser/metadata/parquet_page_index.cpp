@@ -0,0 +1,342 @@
+#include "parquet_page_index.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace ral {
+namespace io {
+
+namespace {
+
+const char PARQUET_MAGIC[] = "PAR1";
+const int64_t PARQUET_FOOTER_TAIL_SIZE = 8;  // the length of the footer and the magic
+
+// The types of the thrift compact protocol
+const uint8_t THRIFT_STOP = 0;
+const uint8_t THRIFT_BOOLEAN_TRUE = 1;
+const uint8_t THRIFT_BOOLEAN_FALSE = 2;
+const uint8_t THRIFT_BYTE = 3;
+const uint8_t THRIFT_I16 = 4;
+const uint8_t THRIFT_I32 = 5;
+const uint8_t THRIFT_I64 = 6;
+const uint8_t THRIFT_DOUBLE = 7;
+const uint8_t THRIFT_BINARY = 8;
+const uint8_t THRIFT_LIST = 9;
+const uint8_t THRIFT_SET = 10;
+const uint8_t THRIFT_MAP = 11;
+const uint8_t THRIFT_STRUCT = 12;
+
+// Reads the thrift compact protocol, which is how parquet encodes its metadata. Only what the page index needs is
+// decoded, the other fields are skipped. Throws if the data ends before what it reads
+class thrift_compact_reader {
+public:
+	thrift_compact_reader(const uint8_t * data, size_t size) : data(data), size(size), pos(0) {}
+
+	// The id and the type of the next field of the struct, false at its end. last_id is the one of the previous field
+	bool read_field_header(int16_t & last_id, int16_t & id, uint8_t & type) {
+		uint8_t header = read_byte();
+		type = header & 0x0f;
+		if(type == THRIFT_STOP) {
+			return false;
+		}
+		uint8_t delta = header >> 4;
+		id = delta == 0 ? static_cast<int16_t>(read_zigzag()) : last_id + delta;
+		last_id = id;
+		return true;
+	}
+
+	void read_list_header(uint8_t & element_type, uint32_t & num_elements) {
+		uint8_t header = read_byte();
+		element_type = header & 0x0f;
+		num_elements = header >> 4;
+		if(num_elements == 15) {
+			num_elements = static_cast<uint32_t>(read_varint());
+		}
+	}
+
+	int64_t read_integer() { return read_zigzag(); }
+
+	std::string read_binary() {
+		uint64_t length = read_varint();
+		check(length);
+		std::string value(reinterpret_cast<const char *>(data + pos), length);
+		pos += length;
+		return value;
+	}
+
+	// A bool element of a list, the ones of a struct are in the type of their field header
+	bool read_list_bool() { return read_byte() == THRIFT_BOOLEAN_TRUE; }
+
+	void skip(uint8_t type) {
+		switch(type) {
+		case THRIFT_BOOLEAN_TRUE:
+		case THRIFT_BOOLEAN_FALSE:
+			return;
+		case THRIFT_BYTE:
+			read_byte();
+			return;
+		case THRIFT_I16:
+		case THRIFT_I32:
+		case THRIFT_I64:
+			read_varint();
+			return;
+		case THRIFT_DOUBLE:
+			check(sizeof(double));
+			pos += sizeof(double);
+			return;
+		case THRIFT_BINARY:
+			read_binary();
+			return;
+		case THRIFT_LIST:
+		case THRIFT_SET: {
+			uint8_t element_type;
+			uint32_t num_elements;
+			read_list_header(element_type, num_elements);
+			for(uint32_t i = 0; i < num_elements; i++) {
+				skip_element(element_type);
+			}
+			return;
+		}
+		case THRIFT_MAP: {
+			uint64_t num_entries = read_varint();
+			if(num_entries == 0) {
+				return;
+			}
+			uint8_t types = read_byte();
+			for(uint64_t i = 0; i < num_entries; i++) {
+				skip_element(types >> 4);
+				skip_element(types & 0x0f);
+			}
+			return;
+		}
+		case THRIFT_STRUCT: {
+			int16_t last_id = 0;
+			int16_t id;
+			uint8_t field_type;
+			while(read_field_header(last_id, id, field_type)) {
+				skip(field_type);
+			}
+			return;
+		}
+		default:
+			throw std::runtime_error("Unknown thrift type " + std::to_string(type));
+		}
+	}
+
+private:
+	// the bools of a list take a byte each
+	void skip_element(uint8_t type) {
+		if(type == THRIFT_BOOLEAN_TRUE || type == THRIFT_BOOLEAN_FALSE) {
+			read_byte();
+		} else {
+			skip(type);
+		}
+	}
+
+	void check(uint64_t length) {
+		if(length > size - pos) {
+			throw std::runtime_error("Thrift data ended before the end of a value");
+		}
+	}
+
+	uint8_t read_byte() {
+		check(1);
+		return data[pos++];
+	}
+
+	uint64_t read_varint() {
+		uint64_t value = 0;
+		for(int shift = 0; shift < 64; shift += 7) {
+			uint8_t byte = read_byte();
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		throw std::runtime_error("Thrift varint is too long");
+	}
+
+	int64_t read_zigzag() {
+		uint64_t value = read_varint();
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	const uint8_t * data;
+	size_t size;
+	size_t pos;
+};
+
+// Calls read_field(id, type) for every field of the next struct, which has to read or skip the value of the field
+template <typename ReadField>
+void read_struct(thrift_compact_reader & reader, ReadField read_field) {
+	int16_t last_id = 0;
+	int16_t id;
+	uint8_t type;
+	while(reader.read_field_header(last_id, id, type)) {
+		read_field(id, type);
+	}
+}
+
+// Calls read_element(index) for every element of the next list, which has to read the element
+template <typename ReadElement>
+void read_list(thrift_compact_reader & reader, ReadElement read_element) {
+	uint8_t element_type;
+	uint32_t num_elements;
+	reader.read_list_header(element_type, num_elements);
+	for(uint32_t i = 0; i < num_elements; i++) {
+		read_element(i);
+	}
+}
+
+bool read_bytes(std::shared_ptr<arrow::io::RandomAccessFile> file, int64_t offset, int64_t length, std::string & bytes) {
+	bytes.resize(length);
+	int64_t bytes_read;
+	arrow::Status status = file->ReadAt(offset, length, &bytes_read, &bytes[0]);
+	return status.ok() && bytes_read == length;
+}
+
+}  // namespace
+
+bool parse_page_index_locations(
+	const uint8_t * data, size_t size, std::vector<std::vector<parquet_page_index_location>> & locations) {
+	try {
+		thrift_compact_reader reader(data, size);
+		locations.clear();
+		// FileMetaData.row_groups, RowGroup.columns and the page index fields of ColumnChunk
+		read_struct(reader, [&](int16_t id, uint8_t type) {
+			if(id != 4 || type != THRIFT_LIST) {
+				reader.skip(type);
+				return;
+			}
+			read_list(reader, [&](uint32_t) {
+				locations.emplace_back();
+				read_struct(reader, [&](int16_t id, uint8_t type) {
+					if(id != 1 || type != THRIFT_LIST) {
+						reader.skip(type);
+						return;
+					}
+					read_list(reader, [&](uint32_t) {
+						parquet_page_index_location location;
+						read_struct(reader, [&](int16_t id, uint8_t type) {
+							if(id == 4 && type == THRIFT_I64) {
+								location.offset_index_offset = reader.read_integer();
+							} else if(id == 5 && type == THRIFT_I32) {
+								location.offset_index_length = static_cast<int32_t>(reader.read_integer());
+							} else if(id == 6 && type == THRIFT_I64) {
+								location.column_index_offset = reader.read_integer();
+							} else if(id == 7 && type == THRIFT_I32) {
+								location.column_index_length = static_cast<int32_t>(reader.read_integer());
+							} else {
+								reader.skip(type);
+							}
+						});
+						locations.back().push_back(location);
+					});
+				});
+			});
+		});
+		return true;
+	} catch(const std::exception & e) {
+		return false;
+	}
+}
+
+bool parse_offset_index(const uint8_t * data, size_t size, std::vector<parquet_page_location> & pages) {
+	try {
+		thrift_compact_reader reader(data, size);
+		pages.clear();
+		read_struct(reader, [&](int16_t id, uint8_t type) {
+			if(id != 1 || type != THRIFT_LIST) {
+				reader.skip(type);
+				return;
+			}
+			read_list(reader, [&](uint32_t) {
+				parquet_page_location page;
+				read_struct(reader, [&](int16_t id, uint8_t type) {
+					if(id == 1 && type == THRIFT_I64) {
+						page.offset = reader.read_integer();
+					} else if(id == 2 && type == THRIFT_I32) {
+						page.compressed_page_size = static_cast<int32_t>(reader.read_integer());
+					} else if(id == 3 && type == THRIFT_I64) {
+						page.first_row_index = reader.read_integer();
+					} else {
+						reader.skip(type);
+					}
+				});
+				pages.push_back(page);
+			});
+		});
+		return true;
+	} catch(const std::exception & e) {
+		return false;
+	}
+}
+
+bool parse_column_index(const uint8_t * data, size_t size, parquet_column_page_index & page_index) {
+	try {
+		thrift_compact_reader reader(data, size);
+		page_index.null_pages.clear();
+		page_index.min_values.clear();
+		page_index.max_values.clear();
+		read_struct(reader, [&](int16_t id, uint8_t type) {
+			if(id == 1 && type == THRIFT_LIST) {
+				read_list(reader, [&](uint32_t) { page_index.null_pages.push_back(reader.read_list_bool()); });
+			} else if(id == 2 && type == THRIFT_LIST) {
+				read_list(reader, [&](uint32_t) { page_index.min_values.push_back(reader.read_binary()); });
+			} else if(id == 3 && type == THRIFT_LIST) {
+				read_list(reader, [&](uint32_t) { page_index.max_values.push_back(reader.read_binary()); });
+			} else {
+				reader.skip(type);
+			}
+		});
+		return page_index.null_pages.size() == page_index.min_values.size() &&
+			   page_index.min_values.size() == page_index.max_values.size();
+	} catch(const std::exception & e) {
+		return false;
+	}
+}
+
+bool read_page_index_locations(
+	std::shared_ptr<arrow::io::RandomAccessFile> file, std::vector<std::vector<parquet_page_index_location>> & locations) {
+	int64_t file_size;
+	if(!file->GetSize(&file_size).ok() || file_size < PARQUET_FOOTER_TAIL_SIZE) {
+		return false;
+	}
+
+	std::string tail;
+	if(!read_bytes(file, file_size - PARQUET_FOOTER_TAIL_SIZE, PARQUET_FOOTER_TAIL_SIZE, tail) ||
+		tail.compare(4, 4, PARQUET_MAGIC) != 0) {
+		return false;
+	}
+	uint32_t footer_size;
+	std::memcpy(&footer_size, tail.data(), sizeof(footer_size));
+	if(footer_size > file_size - PARQUET_FOOTER_TAIL_SIZE) {
+		return false;
+	}
+
+	std::string footer;
+	if(!read_bytes(file, file_size - PARQUET_FOOTER_TAIL_SIZE - footer_size, footer_size, footer)) {
+		return false;
+	}
+	return parse_page_index_locations(reinterpret_cast<const uint8_t *>(footer.data()), footer.size(), locations);
+}
+
+bool read_column_page_index(std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const parquet_page_index_location & location,
+	parquet_column_page_index & page_index) {
+	if(location.offset_index_length <= 0 || location.column_index_length <= 0) {
+		return false;
+	}
+
+	std::string offset_index;
+	std::string column_index;
+	if(!read_bytes(file, location.offset_index_offset, location.offset_index_length, offset_index) ||
+		!read_bytes(file, location.column_index_offset, location.column_index_length, column_index)) {
+		return false;
+	}
+	return parse_offset_index(reinterpret_cast<const uint8_t *>(offset_index.data()), offset_index.size(), page_index.pages) &&
+		   parse_column_index(reinterpret_cast<const uint8_t *>(column_index.data()), column_index.size(), page_index) &&
+		   page_index.pages.size() == page_index.null_pages.size();
+}
+
+}  // namespace io
+}  // namespace ral
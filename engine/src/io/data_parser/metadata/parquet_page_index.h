@@ -0,0 +1,55 @@
+#ifndef BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_PARQUET_PAGE_INDEX_H_
+#define BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_PARQUET_PAGE_INDEX_H_
+
+#include <arrow/io/interfaces.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ral {
+namespace io {
+
+// Where the ColumnIndex and OffsetIndex of a column chunk are in the file. A length of 0 means the chunk does not have one
+struct parquet_page_index_location {
+	int64_t offset_index_offset = 0;
+	int32_t offset_index_length = 0;
+	int64_t column_index_offset = 0;
+	int32_t column_index_length = 0;
+};
+
+// A page of a column chunk, from its OffsetIndex. first_row_index is relative to the row group
+struct parquet_page_location {
+	int64_t offset = 0;
+	int32_t compressed_page_size = 0;
+	int64_t first_row_index = 0;
+};
+
+// The page index of a column chunk. The min and max values are PLAIN encoded, and are empty for the pages that only have nulls
+struct parquet_column_page_index {
+	std::vector<parquet_page_location> pages;
+	std::vector<bool> null_pages;
+	std::vector<std::string> min_values;
+	std::vector<std::string> max_values;
+};
+
+// The page index locations of every column chunk of the file, by row group and column. arrow does not expose them yet,
+// so they are decoded from the footer of the file. False if the file can not be parsed
+bool read_page_index_locations(
+	std::shared_ptr<arrow::io::RandomAccessFile> file, std::vector<std::vector<parquet_page_index_location>> & locations);
+
+// The page index of a column chunk, false if it does not have one or if it can not be parsed
+bool read_column_page_index(std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const parquet_page_index_location & location,
+	parquet_column_page_index & page_index);
+
+// The same from the thrift compact encoding of a FileMetaData, an OffsetIndex and a ColumnIndex
+bool parse_page_index_locations(
+	const uint8_t * data, size_t size, std::vector<std::vector<parquet_page_index_location>> & locations);
+bool parse_offset_index(const uint8_t * data, size_t size, std::vector<parquet_page_location> & pages);
+bool parse_column_index(const uint8_t * data, size_t size, parquet_column_page_index & page_index);
+
+}  // namespace io
+}  // namespace ral
+
+#endif	// BLAZINGDB_RAL_SRC_IO_DATA_PARSER_METADATA_PARQUET_PAGE_INDEX_H_
@@ -12,6 +12,8 @@
 #include <cudf/stream_compaction.hpp>
 #include <cudf/filling.hpp>
 #include <cudf/scalar/scalar_factories.hpp>
+#include <cudf/unary.hpp>
+#include <algorithm>
 
 namespace ral {
 namespace operators {
@@ -88,6 +90,22 @@ std::tuple<std::vector<int>, std::vector<std::string>, std::vector<AggregateKind
 		std::move(aggregation_types), std::move(aggregation_column_assigned_aliases));
 }
 
+std::tuple<std::vector<int>, std::vector<std::string>, std::vector<AggregateKind>, std::vector<std::string>> 
+	parseGroupByExpression(const ral::parser::plan_node & aggregate){
+
+	std::vector<std::string> aggregation_input_expressions;
+	std::vector<AggregateKind> aggregation_types;
+	std::vector<std::string> aggregation_column_assigned_aliases;
+	for(size_t i = 0; i < aggregate.expressions.size(); i++) {
+		const std::string & alias = aggregate.aliases[i];
+		aggregation_types.push_back(get_aggregation_operation(alias + "=[" + aggregate.expressions[i] + "]"));
+		aggregation_input_expressions.push_back(get_string_between_outer_parentheses(aggregate.expressions[i]));
+		aggregation_column_assigned_aliases.push_back(alias.find("EXPR$") == 0 ? "" : alias);
+	}
+	return std::make_tuple(aggregate.group_columns, std::move(aggregation_input_expressions), 
+		std::move(aggregation_types), std::move(aggregation_column_assigned_aliases));
+}
+
 
 std::tuple<std::vector<int>, std::vector<std::string>, std::vector<AggregateKind>,	std::vector<std::string>> 
 	modGroupByParametersForMerge(const std::vector<int> & group_column_indices, 
@@ -282,5 +300,65 @@ std::unique_ptr<ral::frame::BlazingTable> compute_aggregations_with_groupby(
 	return std::make_unique<BlazingTable>(std::move(output_table), output_names);
 }
 
+// The merge of a COUNT is a SUM and a SUM is wider than its input, so a partial result that was already merged can have
+// other types than the partial results of the batches that come after it. The columns are cast to their common type,
+// casted_columns owns the ones that had to be cast
+std::vector<ral::frame::BlazingTableView> normalize_partial_aggregation_types(
+	const std::vector<ral::frame::BlazingTableView> & partials, std::vector<std::unique_ptr<CudfColumn>> & casted_columns) {
+
+	cudf::size_type num_columns = 0;
+	for (auto & partial : partials) {
+		num_columns = std::max(num_columns, partial.num_columns());
+	}
+	std::vector<cudf::type_id> common_types(num_columns, cudf::type_id::EMPTY);
+	for (auto & partial : partials) {
+		for (cudf::size_type j = 0; j < partial.num_columns(); j++) {
+			cudf::type_id type = partial.view().column(j).type().id();
+			common_types[j] = common_types[j] == cudf::type_id::EMPTY ? type : get_common_type(common_types[j], type);
+		}
+	}
+
+	std::vector<ral::frame::BlazingTableView> normalized;
+	for (auto & partial : partials) {
+		std::vector<CudfColumnView> columns;
+		for (cudf::size_type j = 0; j < partial.num_columns(); j++) {
+			CudfColumnView column = partial.view().column(j);
+			if (column.type().id() != common_types[j]) {
+				casted_columns.push_back(cudf::experimental::cast(column, cudf::data_type(common_types[j])));
+				column = casted_columns.back()->view();
+			}
+			columns.push_back(column);
+		}
+		normalized.emplace_back(CudfTableView(columns), partial.names());
+	}
+	return normalized;
+}
+
+std::unique_ptr<ral::frame::BlazingTable> merge_partial_aggregations(
+	const std::vector<ral::frame::BlazingTableView> & partials, const std::vector<int> & group_column_indices,
+	const std::vector<AggregateKind> & aggregation_types) {
+
+	std::vector<std::unique_ptr<CudfColumn>> casted_columns;
+	std::unique_ptr<ral::frame::BlazingTable> concatenated = ral::utilities::concatTables(
+		normalize_partial_aggregation_types(partials, casted_columns));
+
+	std::vector<int> mod_group_column_indices;
+	std::vector<std::string> mod_aggregation_input_expressions, mod_aggregation_column_assigned_aliases;
+	std::vector<AggregateKind> mod_aggregation_types;
+	std::tie(mod_group_column_indices, mod_aggregation_input_expressions, mod_aggregation_types,
+		mod_aggregation_column_assigned_aliases) = modGroupByParametersForMerge(
+		group_column_indices, aggregation_types, concatenated->names());
+
+	if(aggregation_types.size() == 0) {
+		return compute_groupby_without_aggregations(concatenated->toBlazingTableView(), mod_group_column_indices);
+	} else if(group_column_indices.size() == 0) {
+		return compute_aggregations_without_groupby(concatenated->toBlazingTableView(), mod_aggregation_input_expressions,
+			mod_aggregation_types, mod_aggregation_column_assigned_aliases);
+	} else {
+		return compute_aggregations_with_groupby(concatenated->toBlazingTableView(), mod_aggregation_input_expressions,
+			mod_aggregation_types, mod_aggregation_column_assigned_aliases, mod_group_column_indices);
+	}
+}
+
 }  // namespace operators
 }  // namespace ral
@@ -6,6 +6,7 @@
 #include <tuple>
 
 #include "execution_graph/logic_controllers/LogicPrimitives.h"
+#include "parser/physical_plan.hpp"
 #include <cudf/aggregation.hpp>
 #include <cudf/groupby.hpp>
 #include <cudf/detail/aggregation/aggregation.hpp>
@@ -28,6 +29,10 @@ namespace operators {
 	std::tuple<std::vector<int>, std::vector<std::string>, std::vector<AggregateKind>, std::vector<std::string>> 
 		parseGroupByExpression(const std::string & queryString);
 
+	// The same as the one above, from the group columns and the aggregations that the plan node already has
+	std::tuple<std::vector<int>, std::vector<std::string>, std::vector<AggregateKind>, std::vector<std::string>> 
+		parseGroupByExpression(const ral::parser::plan_node & aggregate);
+
 	std::tuple<std::vector<int>, std::vector<std::string>, std::vector<AggregateKind>, std::vector<std::string>> 
 		modGroupByParametersForMerge(const std::vector<int> & group_column_indices, 
 		const std::vector<AggregateKind> & aggregation_types, const std::vector<std::string> & merging_column_names);
@@ -43,5 +48,12 @@ namespace operators {
 		const ral::frame::BlazingTableView & table, const std::vector<std::string> & aggregation_input_expressions, const std::vector<AggregateKind> & aggregation_types,
 		const std::vector<std::string> & aggregation_column_assigned_aliases, const std::vector<int> & group_column_indices);
 
+	// Aggregates together partial results of the same aggregation, that is tables that have its group columns followed by
+	// its aggregations. The result has the same columns, so it can be merged again with other partial results, even if
+	// the merge widened their types
+	std::unique_ptr<ral::frame::BlazingTable> merge_partial_aggregations(
+		const std::vector<ral::frame::BlazingTableView> & partials, const std::vector<int> & group_column_indices,
+		const std::vector<AggregateKind> & aggregation_types);
+
 }  // namespace operators
 }  // namespace ral
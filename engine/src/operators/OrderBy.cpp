@@ -4,6 +4,9 @@
 #include "communication/CommunicationData.h"
 #include "distribution/primitives.h"
 #include <blazingdb/io/Library/Logging/Logger.h>
+#include <algorithm>
+#include <cudf/concatenate.hpp>
+#include <cudf/copying.hpp>
 #include <cudf/sorting.hpp>
 #include <cudf/search.hpp>
 #include <cudf/strings/copying.hpp>
@@ -104,36 +107,22 @@ int64_t determine_local_limit(Context * context, int64_t local_num_rows, cudf::s
 	return std::min(std::max(limit_rows - prev_total_rows, int64_t{0}), local_num_rows);
 }
 
-auto get_sort_vars(const std::string & query_part) {
-	auto rangeStart = query_part.find("(");
-	auto rangeEnd = query_part.rfind(")") - rangeStart - 1;
-	std::string combined_expression = query_part.substr(rangeStart + 1, rangeEnd);
-
-	int num_sort_columns = count_string_occurrence(combined_expression, "sort");
-	
-	std::vector<int> sortColIndices(num_sort_columns);
-	std::vector<cudf::order> sortOrderTypes(num_sort_columns);
-	for(auto i = 0; i < num_sort_columns; i++) {
-		sortColIndices[i] = get_index(get_named_expression(combined_expression, "sort" + std::to_string(i)));
-		sortOrderTypes[i] = (get_named_expression(combined_expression, "dir" + std::to_string(i)) == ASCENDING_ORDER_SORT_TEXT ? cudf::order::ASCENDING : cudf::order::DESCENDING);
+sort_spec get_sort_spec(const ral::parser::plan_node & sort_plan) {
+	sort_spec spec;
+	for(auto & key : sort_plan.sort_keys) {
+		spec.columns.push_back(key.column);
+		spec.orders.push_back(key.ascending ? cudf::order::ASCENDING : cudf::order::DESCENDING);
 	}
-
-	std::string limitRowsStr = get_named_expression(combined_expression, "fetch");
-	cudf::size_type limitRows = !limitRowsStr.empty() ? std::stoi(limitRowsStr) : -1;
-
-	return std::make_tuple(sortColIndices, sortOrderTypes, limitRows);
+	spec.limit = sort_plan.limit;
+	return spec;
 }
 
-bool has_limit_only(const std::string & query_part){
-	std::vector<int> sortColIndices;
-	std::tie(sortColIndices, std::ignore, std::ignore) = get_sort_vars(query_part);
-
-	return sortColIndices.empty();
+bool has_limit_only(const sort_spec & sort){
+	return sort.columns.empty();
 }
 
-int64_t get_local_limit(int64_t total_batch_rows, const std::string & query_part, Context * context){
-	cudf::size_type limitRows;
-	std::tie(std::ignore, std::ignore, limitRows) = get_sort_vars(query_part);
+int64_t get_local_limit(int64_t total_batch_rows, const sort_spec & sort, Context * context){
+	int64_t limitRows = sort.limit;
 
 	if(context->getTotalNodes() > 1 && limitRows >= 0) {
 		limitRows = determine_local_limit(context, total_batch_rows, limitRows);
@@ -155,20 +144,12 @@ limit_table(std::unique_ptr<ral::frame::BlazingTable> table, int64_t num_rows_li
 	}
 }
 
-std::unique_ptr<ral::frame::BlazingTable> sort(const ral::frame::BlazingTableView & table, const std::string & query_part){
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
-
-	return logicalSort(table, sortColIndices, sortOrderTypes);
+std::unique_ptr<ral::frame::BlazingTable> sort(const ral::frame::BlazingTableView & table, const sort_spec & sort){
+	return logicalSort(table, sort.columns, sort.orders);
 }
 
-std::unique_ptr<ral::frame::BlazingTable> sample(const ral::frame::BlazingTableView & table, const std::string & query_part){
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
+std::unique_ptr<ral::frame::BlazingTable> sample(const ral::frame::BlazingTableView & table, const sort_spec & sort){
+	const std::vector<int> & sortColIndices = sort.columns;
 
 	auto tableNames = table.names();
 	std::vector<std::string> sortColNames(sortColIndices.size());
@@ -180,11 +161,9 @@ std::unique_ptr<ral::frame::BlazingTable> sample(const ral::frame::BlazingTableV
 	return selfSamples;
 }
 
-std::unique_ptr<ral::frame::BlazingTable> generate_partition_plan(cudf::size_type number_partitions, const std::vector<ral::frame::BlazingTableView> & samples, const std::vector<size_t> & total_rows_tables, const std::string & query_part){
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
+std::unique_ptr<ral::frame::BlazingTable> generate_partition_plan(cudf::size_type number_partitions, const std::vector<ral::frame::BlazingTableView> & samples, const std::vector<size_t> & total_rows_tables, const sort_spec & sort){
+	const std::vector<cudf::order> & sortOrderTypes = sort.orders;
+	std::vector<int> sortColIndices(sort.columns.size());
 
 	// Normalize indices, samples contains the filtered columns
 	std::iota(sortColIndices.begin(), sortColIndices.end(), 0);
@@ -197,11 +176,9 @@ std::unique_ptr<ral::frame::BlazingTable> generate_partition_plan(cudf::size_typ
 	return generatePartitionPlans(number_partitions, samples, sortOrderTypes);
 }
 
-std::vector<cudf::table_view> partition_table(const ral::frame::BlazingTableView & partitionPlan, const ral::frame::BlazingTableView & sortedTable, const std::string & query_part) {
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
+std::vector<cudf::table_view> partition_table(const ral::frame::BlazingTableView & partitionPlan, const ral::frame::BlazingTableView & sortedTable, const sort_spec & sort) {
+	const std::vector<cudf::order> & sortOrderTypes = sort.orders;
+	const std::vector<int> & sortColIndices = sort.columns;
 
 	if(sortedTable.num_rows() == 0) {
 		return {sortedTable.view()};
@@ -222,11 +199,8 @@ std::vector<cudf::table_view> partition_table(const ral::frame::BlazingTableView
 }
 
 std::unique_ptr<ral::frame::BlazingTable> generate_distributed_partition_plan(const ral::frame::BlazingTableView & selfSamples, 
-	std::size_t table_num_rows, std::size_t avg_bytes_per_row, const std::string & query_part, Context * context){
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
+	std::size_t table_num_rows, std::size_t avg_bytes_per_row, const sort_spec & sort, Context * context){
+	const std::vector<cudf::order> & sortOrderTypes = sort.orders;
 
 	std::unique_ptr<ral::frame::BlazingTable> partitionPlan;
 	if(context->isMasterNode(CommunicationData::getInstance().getSelfNode())) {
@@ -286,14 +260,9 @@ std::unique_ptr<ral::frame::BlazingTable> generate_distributed_partition_plan(co
 std::vector<std::pair<int, std::unique_ptr<ral::frame::BlazingTable>>>
 distribute_table_partitions(const ral::frame::BlazingTableView & partitionPlan,
 													const ral::frame::BlazingTableView & sortedTable,
-													const std::string & query_part,
+													const sort_spec & sort,
 													blazingdb::manager::Context * context) {
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
-
-	std::vector<NodeColumnView> partitions = partitionData(context, sortedTable, partitionPlan, sortColIndices, sortOrderTypes);
+	std::vector<NodeColumnView> partitions = partitionData(context, sortedTable, partitionPlan, sort.columns, sort.orders);
 
 	int num_nodes = context->getTotalNodes();
 	int num_partitions = partitions.size();
@@ -315,12 +284,85 @@ distribute_table_partitions(const ral::frame::BlazingTableView & partitionPlan,
 }
 
 
-std::unique_ptr<ral::frame::BlazingTable> merge(std::vector<ral::frame::BlazingTableView> partitions_to_merge, const std::string & query_part) {
-	std::vector<cudf::order> sortOrderTypes;
-	std::vector<int> sortColIndices;
-	cudf::size_type limitRows;
-	std::tie(sortColIndices, sortOrderTypes, limitRows) = get_sort_vars(query_part);
-	return sortedMerger(partitions_to_merge, sortOrderTypes, sortColIndices);
+std::unique_ptr<ral::frame::BlazingTable> merge(std::vector<ral::frame::BlazingTableView> partitions_to_merge, const sort_spec & sort) {
+	return sortedMerger(partitions_to_merge, sort.orders, sort.columns);
+}
+
+std::pair<std::unique_ptr<ral::frame::BlazingTable>, std::vector<cudf::size_type>>
+merge_settled_rows(std::vector<ral::frame::BlazingTableView> heads, const std::vector<bool> & runs_have_more, const sort_spec & sort) {
+	const std::vector<cudf::order> & sortOrderTypes = sort.orders;
+	const std::vector<int> & sortColIndices = sort.columns;
+
+	std::vector<cudf::size_type> num_settled(heads.size());
+
+	// the last key of every head whose run goes on, the smallest of them bounds what is settled
+	std::vector<CudfTableView> last_keys;
+	for (size_t i = 0; i < heads.size(); i++) {
+		cudf::size_type num_rows = heads[i].num_rows();
+		if (runs_have_more[i] && num_rows > 0) {
+			last_keys.push_back(cudf::experimental::slice(heads[i].view().select(sortColIndices), {num_rows - 1, num_rows})[0]);
+		}
+	}
+	if (last_keys.empty()) {
+		for (size_t i = 0; i < heads.size(); i++) {
+			num_settled[i] = heads[i].num_rows();
+		}
+		return std::make_pair(sortedMerger(heads, sortOrderTypes, sortColIndices), num_settled);
+	}
+
+	std::vector<cudf::null_order> null_orders(sortColIndices.size(), cudf::null_order::AFTER);
+	std::unique_ptr<CudfTable> concatenated_last_keys = cudf::concatenate(last_keys);
+	std::unique_ptr<cudf::column> last_keys_order = cudf::experimental::sorted_order(concatenated_last_keys->view(), sortOrderTypes, null_orders);
+	cudf::column_view smallest_index = cudf::experimental::slice(last_keys_order->view(), {0, 1})[0];
+	std::unique_ptr<CudfTable> bound = cudf::experimental::gather(concatenated_last_keys->view(), smallest_index);
+
+	// every head is sorted, so its settled rows are the ones before the upper bound of the bound
+	std::vector<ral::frame::BlazingTableView> settled_heads;
+	for (size_t i = 0; i < heads.size(); i++) {
+		auto bound_index = cudf::experimental::upper_bound(heads[i].view().select(sortColIndices), bound->view(), sortOrderTypes, null_orders);
+		num_settled[i] = cudf::test::to_host<cudf::size_type>(bound_index->view()).first[0];
+		settled_heads.emplace_back(cudf::experimental::slice(heads[i].view(), {0, num_settled[i]})[0], heads[i].names());
+	}
+	return std::make_pair(sortedMerger(settled_heads, sortOrderTypes, sortColIndices), num_settled);
+}
+
+std::unique_ptr<ral::frame::BlazingTable> top_n(const std::vector<ral::frame::BlazingTableView> & tables, const sort_spec & sort, int64_t num_rows) {
+	const std::vector<cudf::order> & sortOrderTypes = sort.orders;
+	const std::vector<int> & sortColIndices = sort.columns;
+
+	// the nodes that did not get any input send their candidates without columns
+	if (std::none_of(tables.begin(), tables.end(), [](const ral::frame::BlazingTableView & table) { return table.num_columns() > 0; })) {
+		return ral::frame::createEmptyBlazingTable(std::vector<cudf::type_id>(), std::vector<std::string>());
+	}
+
+	std::unique_ptr<ral::frame::BlazingTable> concatenated = ral::utilities::concatTables(tables);
+
+	std::vector<cudf::null_order> null_orders(sortColIndices.size(), cudf::null_order::AFTER);
+	std::unique_ptr<cudf::column> sorted_order = cudf::experimental::sorted_order(concatenated->view().select(sortColIndices), sortOrderTypes, null_orders);
+
+	cudf::column_view top_rows = sorted_order->view();
+	if (top_rows.size() > num_rows) {
+		top_rows = cudf::experimental::slice(top_rows, {0, static_cast<cudf::size_type>(num_rows)})[0];
+	}
+	std::unique_ptr<cudf::experimental::table> gathered = cudf::experimental::gather(concatenated->view(), top_rows);
+	return std::make_unique<ral::frame::BlazingTable>(std::move(gathered), concatenated->names());
+}
+
+std::unique_ptr<ral::frame::BlazingTable> merge_top_n_candidates(const ral::frame::BlazingTableView & candidates, const sort_spec & sort, int64_t num_rows, Context * context) {
+	if(context->isMasterNode(CommunicationData::getInstance().getSelfNode())) {
+		context->incrementQuerySubstep();
+		std::pair<std::vector<NodeColumn>, std::vector<std::size_t> > candidates_pair = collectSamples(context);
+		std::vector<ral::frame::BlazingTableView> all_candidates;
+		for (auto & node_candidates : candidates_pair.first) {
+			all_candidates.push_back(node_candidates.second->toBlazingTableView());
+		}
+		all_candidates.push_back(candidates);
+		return top_n(all_candidates, sort, num_rows);
+	} else {
+		context->incrementQuerySubstep();
+		sendSamplesToMaster(context, candidates, candidates.num_rows());
+		return ral::utilities::create_empty_table(candidates);
+	}
 }
 
 }  // namespace operators
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include "execution_graph/logic_controllers/LogicPrimitives.h"
+#include "parser/physical_plan.hpp"
 
 
 namespace ral {
@@ -13,27 +14,49 @@ namespace {
   using blazingdb::manager::Context;
 }
 
-std::unique_ptr<ral::frame::BlazingTable> sort(const ral::frame::BlazingTableView & table, const std::string & query_part);
+// The keys and the fetch of a sort, taken once from its plan node instead of from its text for every batch
+struct sort_spec {
+	std::vector<int> columns;
+	std::vector<cudf::order> orders;
+	int64_t limit = -1;  // -1 when there is no fetch
+};
 
-std::unique_ptr<ral::frame::BlazingTable> sample(const ral::frame::BlazingTableView & table, const std::string & query_part);
+sort_spec get_sort_spec(const ral::parser::plan_node & sort_plan);
 
-std::unique_ptr<ral::frame::BlazingTable> generate_distributed_partition_plan(const ral::frame::BlazingTableView & selfSamples, std::size_t table_num_rows, std::size_t avg_bytes_per_row, const std::string & query_part, Context * context);
+std::unique_ptr<ral::frame::BlazingTable> sort(const ral::frame::BlazingTableView & table, const sort_spec & sort);
 
-std::unique_ptr<ral::frame::BlazingTable> generate_partition_plan(cudf::size_type number_partitions, const std::vector<ral::frame::BlazingTableView> & samples, const std::vector<size_t> & total_rows_tables, const std::string & query_part);
+std::unique_ptr<ral::frame::BlazingTable> sample(const ral::frame::BlazingTableView & table, const sort_spec & sort);
 
-std::vector<cudf::table_view> partition_table(const ral::frame::BlazingTableView & partitionPlan, const ral::frame::BlazingTableView & sortedTable, const std::string & query_part);
+std::unique_ptr<ral::frame::BlazingTable> generate_distributed_partition_plan(const ral::frame::BlazingTableView & selfSamples, std::size_t table_num_rows, std::size_t avg_bytes_per_row, const sort_spec & sort, Context * context);
+
+std::unique_ptr<ral::frame::BlazingTable> generate_partition_plan(cudf::size_type number_partitions, const std::vector<ral::frame::BlazingTableView> & samples, const std::vector<size_t> & total_rows_tables, const sort_spec & sort);
+
+std::vector<cudf::table_view> partition_table(const ral::frame::BlazingTableView & partitionPlan, const ral::frame::BlazingTableView & sortedTable, const sort_spec & sort);
 
 std::vector<std::pair<int, std::unique_ptr<ral::frame::BlazingTable>>>
-distribute_table_partitions(const ral::frame::BlazingTableView & partitionPlan,	const ral::frame::BlazingTableView & sortedTable, const std::string & query_part,	Context * context);
+distribute_table_partitions(const ral::frame::BlazingTableView & partitionPlan,	const ral::frame::BlazingTableView & sortedTable, const sort_spec & sort,	Context * context);
 
-bool has_limit_only(const std::string & query_part);
+bool has_limit_only(const sort_spec & sort);
 
-int64_t get_local_limit(int64_t total_batch_rows, const std::string & query_part, Context * context);
+int64_t get_local_limit(int64_t total_batch_rows, const sort_spec & sort, Context * context);
 
 std::pair<std::unique_ptr<ral::frame::BlazingTable>, int64_t>
 limit_table(std::unique_ptr<ral::frame::BlazingTable> table, int64_t num_rows_limit);
 
-std::unique_ptr<ral::frame::BlazingTable> merge(std::vector<ral::frame::BlazingTableView> partitions_to_merge, const std::string & query_part);
+std::unique_ptr<ral::frame::BlazingTable> merge(std::vector<ral::frame::BlazingTableView> partitions_to_merge, const sort_spec & sort);
+
+// Merges the heads of sorted runs. The rows up to the smallest last key among the heads whose run has more rows are
+// settled, none of the rows that are still to come can go before them. Returns the settled rows, sorted, and how many
+// rows of every head were settled, which are always its first rows
+std::pair<std::unique_ptr<ral::frame::BlazingTable>, std::vector<cudf::size_type>>
+merge_settled_rows(std::vector<ral::frame::BlazingTableView> heads, const std::vector<bool> & runs_have_more, const sort_spec & sort);
+
+// The first num_rows rows of the tables in the order of the sort, sorted. Only those rows are gathered
+std::unique_ptr<ral::frame::BlazingTable> top_n(const std::vector<ral::frame::BlazingTableView> & tables, const sort_spec & sort, int64_t num_rows);
+
+// Collective operation, every node of the context must call it. The master gets the top num_rows rows of the
+// candidates of every node, and the other nodes get an empty table
+std::unique_ptr<ral::frame::BlazingTable> merge_top_n_candidates(const ral::frame::BlazingTableView & candidates, const sort_spec & sort, int64_t num_rows, Context * context);
 
 }  // namespace operators
 }  // namespace ral
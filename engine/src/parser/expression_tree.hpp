@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <blazingdb/io/Util/StringUtil.h>
 #include <iostream>
 #include <sstream>
@@ -150,6 +151,13 @@ struct operator_node : parse_node, std::enable_shared_from_this<operator_node> {
     }
 
     std::shared_ptr<parse_node> reduce()  override {
+        if (ral::skip_data::is_null_count_op(this->value)) {
+            // only the null counts of a column are known
+            if (this->children.size() == 1 && this->children[0]->type == parse_node_type::OPERAND && is_var_column(this->children[0]->value)) {
+                return shared_from_this();
+            }
+            return std::make_shared<operator_node>("NONE");
+        }
         if (ral::skip_data::is_unsupported_binary_op(this->value)) {
             return std::make_shared<operator_node>("NONE");
         }
@@ -520,10 +528,26 @@ public:
         auto expr2 = make_sub(n, m, 1, 1);
         return make_pair_node(expr1, expr2);
     }
-    void apply_skip_data_rules_helper(std::stack<std::shared_ptr<parse_node>*>& nodes) {
+    // A row group may have nulls when its null count is not 0, and values when it is not its number of rows.
+    // An unknown null count is -1, so it never skips the row group
+    std::shared_ptr<parse_node> transform_null_count_op(std::shared_ptr<parse_node> &subtree, int num_columns) {
+        auto id = ral::skip_data::get_id(subtree->children[0]->value);
+        auto ptr = std::make_shared<operator_node>("<>");
+        ptr->set_left(std::make_shared<operad_node>("$" + std::to_string(2 * num_columns + 1 + id)));
+        if (subtree->value == "IS_NULL") {
+            ptr->set_right(std::make_shared<operad_node>("0"));
+        } else {
+            ptr->set_right(std::make_shared<operad_node>("$" + std::to_string(2 * num_columns)));
+        }
+        return ptr;
+    }
+
+    void apply_skip_data_rules_helper(std::stack<std::shared_ptr<parse_node>*>& nodes, int num_columns) {
         while (not nodes.empty()) {
             auto& p = *nodes.top();
-            if (p->children.size() == 2) {
+            if (p->children.size() == 1 && ral::skip_data::is_null_count_op(p->value)) {
+                p = transform_null_count_op(p, num_columns);
+            } else if (p->children.size() == 2) {
                 auto op = p->value;
                  if (op == "=") {
                  	p = transform_equal(p);
@@ -543,8 +567,16 @@ public:
         }
     }
 
-    void apply_skip_data_rules() {
+    // The metadata that the rules are for has the min of column i at $(2 * i) and its max at $(2 * i + 1). When num_columns
+    // is not -1 it also has the number of rows at $(2 * num_columns) and the null count of column i at
+    // $(2 * num_columns + 1 + i), otherwise IS_NULL and IS_NOT_NULL can not skip anything
+    void apply_skip_data_rules(int num_columns = -1) {
         assert(!!this->root);
+        if (num_columns < 0) {
+            drop_helper(this->root, [](parse_node *p) {
+                return ral::skip_data::is_null_count_op(p->value);
+            });
+        }
         this->root = this->root->reduce();
         if (root->value == "NONE") {
             root->value = "";
@@ -552,7 +584,7 @@ public:
         }
         std::stack< std::shared_ptr<parse_node> *> nodes;
         get_prefix_nodes(this->root, nodes);
-        apply_skip_data_rules_helper(nodes);
+        apply_skip_data_rules_helper(nodes, num_columns);
     }
 
     template <typename predicate>
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <map>
 #include <regex>
 
@@ -284,3 +285,46 @@ std::string replace_calcite_regex(const std::string & expression) {
 	StringUtil::findAndReplaceAll(ret, "/INT(", "/(");
 	return ret;
 }
+
+namespace {
+
+// Calls on_column(i, position, length) for every $i of the expression that is not inside a literal
+template <typename OnColumn>
+void for_each_input_column(const std::string & expression, OnColumn on_column) {
+	bool in_quotes = false;
+	for(size_t i = 0; i < expression.size(); i++) {
+		if(expression[i] == '\'') {
+			in_quotes = !in_quotes;
+		} else if(!in_quotes && expression[i] == '$') {
+			size_t end = expression.find_first_not_of("0123456789", i + 1);
+			end = (end == std::string::npos) ? expression.size() : end;
+			if(end > i + 1) {
+				on_column(std::stoi(expression.substr(i + 1, end - i - 1)), i, end - i);
+				i = end - 1;
+			}
+		}
+	}
+}
+
+}  // namespace
+
+std::vector<int> get_input_columns(const std::string & expression) {
+	std::vector<int> columns;
+	for_each_input_column(expression, [&columns](int column, size_t, size_t) { columns.push_back(column); });
+	std::sort(columns.begin(), columns.end());
+	columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+	return columns;
+}
+
+std::string reindex_columns(const std::string & expression, const std::vector<int> & columns) {
+	std::string reindexed;
+	size_t copied = 0;
+	for_each_input_column(expression, [&](int column, size_t position, size_t length) {
+		auto it = std::find(columns.begin(), columns.end(), column);
+		RAL_EXPECTS(it != columns.end(), "Column $" + std::to_string(column) + " is not in the columns to reindex with");
+		reindexed += expression.substr(copied, position - copied) + "$" + std::to_string(it - columns.begin());
+		copied = position + length;
+	});
+	reindexed += expression.substr(copied);
+	return reindexed;
+}
@@ -108,12 +108,14 @@ const std::string LOGICAL_MERGE_AGGREGATE_TEXT = "MergeAggregate";
 const std::string LOGICAL_PROJECT_TEXT = "LogicalProject";
 const std::string LOGICAL_LIMIT_TEXT = "LogicalLimit";
 const std::string LOGICAL_SORT_TEXT = "LogicalSort";
+const std::string LOGICAL_TOP_N_TEXT = "LogicalTopN";
 const std::string LOGICAL_MERGE_TEXT = "LogicalMerge";
 const std::string LOGICAL_PARTITION_TEXT = "LogicalPartition";
 const std::string LOGICAL_SORT_AND_SAMPLE_TEXT = "Logical_SortAndSample";
 const std::string LOGICAL_SINGLE_NODE_PARTITION_TEXT = "LogicalSingleNodePartition";
 const std::string LOGICAL_SINGLE_NODE_SORT_AND_SAMPLE_TEXT = "LogicalSingleNodeSortAndSample";
 const std::string LOGICAL_FILTER_TEXT = "LogicalFilter";
+const std::string LOGICAL_FILTER_PROJECT_TEXT = "LogicalFilterProject";
 const std::string ASCENDING_ORDER_SORT_TEXT = "ASC";
 const std::string DESCENDING_ORDER_SORT_TEXT = "DESC";
 
@@ -155,5 +157,12 @@ std::vector<std::string> get_expressions_from_expression_list(std::string & comb
 
 std::string replace_calcite_regex(const std::string & expression);
 
+// The columns, as the i of each $i, that the expression uses. Sorted and without repetitions
+std::vector<int> get_input_columns(const std::string & expression);
+
+// The expression with every $i replaced by $j, where j is the position of i in columns, which has to have all of the ones
+// that the expression uses. For evaluating an expression on a table that only has those columns
+std::string reindex_columns(const std::string & expression, const std::vector<int> & columns);
+
 //Returns the column names according to the corresponding algebra expression
 std::vector<std::string> fix_column_aliases(const std::vector<std::string> & column_names, std::string expression);
@@ -0,0 +1,633 @@
+#include "parser/physical_plan.hpp"
+#include "parser/expression_utils.hpp"
+#include "utilities/BlazingSqlInvalidAlgebraException.h"
+#include <blazingdb/io/Util/StringUtil.h>
+#include <boost/property_tree/json_parser.hpp>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace ral {
+namespace parser {
+
+namespace {
+
+const std::vector<std::pair<plan_node_kind, std::string>> & plan_node_kind_names() {
+	static const std::vector<std::pair<plan_node_kind, std::string>> names = {
+		{plan_node_kind::Project, LOGICAL_PROJECT_TEXT},
+		{plan_node_kind::Filter, LOGICAL_FILTER_TEXT},
+		{plan_node_kind::FilterProject, LOGICAL_FILTER_PROJECT_TEXT},
+		{plan_node_kind::TableScan, LOGICAL_SCAN_TEXT},
+		{plan_node_kind::BindableTableScan, BINDABLE_SCAN_TEXT},
+		{plan_node_kind::Union, LOGICAL_UNION_TEXT},
+		{plan_node_kind::Sort, LOGICAL_SORT_TEXT},
+		{plan_node_kind::Aggregate, LOGICAL_AGGREGATE_TEXT},
+		{plan_node_kind::Join, LOGICAL_JOIN_TEXT},
+		{plan_node_kind::Limit, LOGICAL_LIMIT_TEXT},
+		{plan_node_kind::TopN, LOGICAL_TOP_N_TEXT},
+		{plan_node_kind::MergeStream, LOGICAL_MERGE_TEXT},
+		{plan_node_kind::Partition, LOGICAL_PARTITION_TEXT},
+		{plan_node_kind::SortAndSample, LOGICAL_SORT_AND_SAMPLE_TEXT},
+		{plan_node_kind::PartitionSingleNode, LOGICAL_SINGLE_NODE_PARTITION_TEXT},
+		{plan_node_kind::SortAndSampleSingleNode, LOGICAL_SINGLE_NODE_SORT_AND_SAMPLE_TEXT},
+		{plan_node_kind::ComputeAggregate, LOGICAL_COMPUTE_AGGREGATE_TEXT},
+		{plan_node_kind::DistributeAggregate, LOGICAL_DISTRIBUTE_AGGREGATE_TEXT},
+		{plan_node_kind::MergeAggregate, LOGICAL_MERGE_AGGREGATE_TEXT},
+		{plan_node_kind::PartwiseJoin, LOGICAL_PARTWISE_JOIN_TEXT},
+		{plan_node_kind::JoinPartition, LOGICAL_JOIN_PARTITION_TEXT}};
+	return names;
+}
+
+std::string trim(const std::string & text) {
+	size_t start = text.find_first_not_of(" \t\n");
+	if(start == std::string::npos) {
+		return "";
+	}
+	size_t end = text.find_last_not_of(" \t\n");
+	return text.substr(start, end - start + 1);
+}
+
+// Splits on the commas that are not inside parentheses, brackets, braces or quotes
+std::vector<std::string> split_top_level(const std::string & text) {
+	std::vector<std::string> parts;
+	int depth = 0;
+	bool in_quotes = false;
+	size_t start = 0;
+	for(size_t i = 0; i < text.size(); i++) {
+		char c = text[i];
+		if(c == '\'') {
+			in_quotes = !in_quotes;
+		} else if(in_quotes) {
+			continue;
+		} else if(c == '(' || c == '[' || c == '{') {
+			depth++;
+		} else if(c == ')' || c == ']' || c == '}') {
+			depth--;
+		} else if(c == ',' && depth == 0) {
+			parts.push_back(trim(text.substr(start, i - start)));
+			start = i + 1;
+		}
+	}
+	std::string last = trim(text.substr(start));
+	if(!last.empty()) {
+		parts.push_back(last);
+	}
+	return parts;
+}
+
+std::string strip_enclosing(const std::string & text, char open, char close) {
+	if(text.size() >= 2 && text.front() == open && text.back() == close) {
+		return text.substr(1, text.size() - 2);
+	}
+	return text;
+}
+
+// $3 -> 3, -1 if it is not a column reference
+int column_index(const std::string & token) {
+	std::string trimmed = trim(token);
+	if(trimmed.size() < 2 || trimmed[0] != '$' || trimmed.find_first_not_of("0123456789", 1) != std::string::npos) {
+		return -1;
+	}
+	return std::stoi(trimmed.substr(1));
+}
+
+std::vector<int> parse_index_set(const std::string & text) {
+	std::vector<int> indices;
+	for(auto & index : split_top_level(strip_enclosing(trim(text), '{', '}'))) {
+		indices.push_back(std::stoi(index));
+	}
+	return indices;
+}
+
+// Fills the join keys when the condition is =($a, $b) or an AND of those, like parseJoinConditionToColumnIndices does
+void parse_join_keys(plan_node & node) {
+	std::vector<std::string> equalities;
+	if(StringUtil::beginsWith(node.condition, "AND(")) {
+		equalities = split_top_level(strip_enclosing(node.condition.substr(3), '(', ')'));
+	} else {
+		equalities.push_back(node.condition);
+	}
+
+	std::vector<int> left_keys;
+	std::vector<int> right_keys;
+	for(auto & equality : equalities) {
+		if(!StringUtil::beginsWith(equality, "=(")) {
+			return;
+		}
+		std::vector<std::string> operands = split_top_level(strip_enclosing(equality.substr(1), '(', ')'));
+		if(operands.size() != 2) {
+			return;
+		}
+		int left_index = column_index(operands[0]);
+		int right_index = column_index(operands[1]);
+		if(left_index < 0 || right_index < 0) {
+			return;
+		}
+		if(right_index < left_index) {
+			std::swap(left_index, right_index);
+		}
+		left_keys.push_back(left_index);
+		right_keys.push_back(right_index);
+	}
+	node.left_join_keys = std::move(left_keys);
+	node.right_join_keys = std::move(right_keys);
+}
+
+void parse_typed_arguments(plan_node & node) {
+	switch(node.kind) {
+	case plan_node_kind::TableScan:
+	case plan_node_kind::BindableTableScan: {
+		std::vector<std::string> table_parts = split_top_level(strip_enclosing(node.argument("table"), '[', ']'));
+		node.table_name = StringUtil::combine(table_parts, ".");
+		node.condition = strip_enclosing(node.argument("filters"), '[', ']');
+		for(auto & projection : split_top_level(strip_enclosing(node.argument("projects"), '[', ']'))) {
+			node.projections.push_back(std::stoull(projection));
+		}
+		node.aliases = split_top_level(strip_enclosing(node.argument("aliases"), '[', ']'));
+		break;
+	}
+	case plan_node_kind::Project:
+		for(auto & argument : node.arguments) {
+			node.aliases.push_back(argument.first);
+			node.expressions.push_back(argument.second);
+		}
+		break;
+	case plan_node_kind::Filter:
+		node.condition = node.argument("condition");
+		break;
+	case plan_node_kind::FilterProject:
+		// the condition is always the first argument, so that a column named condition does not get in the way
+		for(size_t i = 0; i < node.arguments.size(); i++) {
+			if(i == 0) {
+				node.condition = node.arguments[i].second;
+			} else {
+				node.aliases.push_back(node.arguments[i].first);
+				node.expressions.push_back(node.arguments[i].second);
+			}
+		}
+		break;
+	case plan_node_kind::Join:
+	case plan_node_kind::PartwiseJoin:
+	case plan_node_kind::JoinPartition:
+		node.condition = node.argument("condition");
+		node.join_type = node.argument("joinType");
+		parse_join_keys(node);
+		break;
+	case plan_node_kind::Aggregate:
+	case plan_node_kind::ComputeAggregate:
+	case plan_node_kind::DistributeAggregate:
+	case plan_node_kind::MergeAggregate:
+		for(auto & argument : node.arguments) {
+			if(argument.first == "group") {
+				node.group_columns = parse_index_set(argument.second);
+			} else if(argument.first != "groups") {
+				node.aliases.push_back(argument.first);
+				node.expressions.push_back(argument.second);
+			}
+		}
+		break;
+	case plan_node_kind::Sort:
+	case plan_node_kind::Limit:
+	case plan_node_kind::TopN:
+	case plan_node_kind::MergeStream:
+	case plan_node_kind::Partition:
+	case plan_node_kind::SortAndSample:
+	case plan_node_kind::PartitionSingleNode:
+	case plan_node_kind::SortAndSampleSingleNode:
+		for(size_t i = 0; !node.argument("sort" + std::to_string(i)).empty(); i++) {
+			node.sort_keys.push_back(sort_key{column_index(node.argument("sort" + std::to_string(i))),
+				node.argument("dir" + std::to_string(i)) == ASCENDING_ORDER_SORT_TEXT});
+		}
+		// fetch can also be a parameter, that is only known once it is bound
+		if(!node.argument("fetch").empty() && node.argument("fetch").find_first_not_of("0123456789") == std::string::npos) {
+			node.limit = std::stoll(node.argument("fetch"));
+		}
+		break;
+	case plan_node_kind::Union:
+		break;
+	}
+}
+
+// A node of another kind with the same arguments, without children
+std::shared_ptr<plan_node> derive_node(const plan_node & node, plan_node_kind kind) {
+	auto derived = std::make_shared<plan_node>(node);
+	derived->kind = kind;
+	derived->children.clear();
+	return derived;
+}
+
+// Chains the kinds from the top down, the last one gets the children of node
+std::shared_ptr<plan_node> derive_chain(const std::shared_ptr<plan_node> & node, const std::vector<plan_node_kind> & kinds) {
+	std::shared_ptr<plan_node> top;
+	std::shared_ptr<plan_node> bottom;
+	for(auto kind : kinds) {
+		auto derived = derive_node(*node, kind);
+		if(bottom) {
+			bottom->children.push_back(derived);
+		} else {
+			top = derived;
+		}
+		bottom = derived;
+	}
+	bottom->children = node->children;
+	return top;
+}
+
+// Calls on_parameter(index, position, length) for every ?index that is not inside a string literal
+template <typename Callback>
+void for_each_parameter(const std::string & text, Callback on_parameter) {
+	bool in_quotes = false;
+	for(size_t i = 0; i < text.size(); i++) {
+		if(text[i] == '\'') {
+			in_quotes = !in_quotes;
+		} else if(!in_quotes && text[i] == '?') {
+			size_t end = text.find_first_not_of("0123456789", i + 1);
+			end = (end == std::string::npos) ? text.size() : end;
+			if(end > i + 1) {
+				on_parameter(std::stoull(text.substr(i + 1, end - i - 1)), i, end - i);
+				i = end - 1;
+			}
+		}
+	}
+}
+
+// The expression with every $i replaced by the column that inputs[i] is, false if one of the inputs it uses is not
+// just a column
+bool substitute_columns(const std::string & expression, const std::vector<std::string> & inputs, std::string & substituted) {
+	substituted.clear();
+	bool in_quotes = false;
+	for(size_t i = 0; i < expression.size(); i++) {
+		if(expression[i] == '\'') {
+			in_quotes = !in_quotes;
+		} else if(!in_quotes && expression[i] == '$') {
+			size_t end = expression.find_first_not_of("0123456789", i + 1);
+			end = (end == std::string::npos) ? expression.size() : end;
+			if(end > i + 1) {
+				size_t index = std::stoull(expression.substr(i + 1, end - i - 1));
+				int input_column = index < inputs.size() ? column_index(inputs[index]) : -1;
+				if(input_column < 0) {
+					return false;
+				}
+				substituted += "$" + std::to_string(input_column);
+				i = end - 1;
+				continue;
+			}
+		}
+		substituted.push_back(expression[i]);
+	}
+	return true;
+}
+
+bool substitute_columns(const std::vector<std::string> & expressions, const std::vector<std::string> & inputs,
+	std::vector<std::string> & substituted) {
+	substituted.resize(expressions.size());
+	for(size_t i = 0; i < expressions.size(); i++) {
+		if(!substitute_columns(expressions[i], inputs, substituted[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::shared_ptr<plan_node> make_filter_project(const std::string & condition, const std::vector<std::string> & expressions,
+	const std::vector<std::string> & aliases, const std::vector<std::shared_ptr<plan_node>> & children) {
+	std::string expr = LOGICAL_FILTER_PROJECT_TEXT + "(condition=[" + condition + "]";
+	for(size_t i = 0; i < expressions.size(); i++) {
+		expr += ", " + aliases[i] + "=[" + expressions[i] + "]";
+	}
+	expr += ")";
+	auto node = parse_plan_node(expr);
+	node->children = children;
+	return node;
+}
+
+}  // namespace
+
+const std::string & plan_node_kind_name(plan_node_kind kind) {
+	for(auto & name : plan_node_kind_names()) {
+		if(name.first == kind) {
+			return name.second;
+		}
+	}
+	throw std::invalid_argument("unknown plan node kind");
+}
+
+std::string plan_node::expr() const { return plan_node_kind_name(kind) + arguments_text; }
+
+const std::string & plan_node::argument(const std::string & name) const {
+	static const std::string empty;
+	for(auto & argument : arguments) {
+		if(argument.first == name) {
+			return argument.second;
+		}
+	}
+	return empty;
+}
+
+std::shared_ptr<plan_node> parse_plan_node(const std::string & expr) {
+	std::string text = trim(expr);
+	size_t arguments_start = text.find('(');
+	std::string operator_name = trim(text.substr(0, arguments_start));
+
+	auto & names = plan_node_kind_names();
+	auto it = std::find_if(names.begin(), names.end(),
+		[&operator_name](const std::pair<plan_node_kind, std::string> & name) { return name.second == operator_name; });
+	if(it == names.end()) {
+		throw ral::utilities::BlazingSqlInvalidAlgebraException("expression in the Algebra Relational is currently not supported: " + expr);
+	}
+
+	auto node = std::make_shared<plan_node>();
+	node->kind = it->first;
+	if(arguments_start != std::string::npos) {
+		node->arguments_text = text.substr(arguments_start);
+		for(auto & argument : split_top_level(strip_enclosing(node->arguments_text, '(', ')'))) {
+			size_t value_start = argument.find("=[");
+			if(value_start == std::string::npos) {
+				node->arguments.emplace_back(argument, "");
+			} else {
+				node->arguments.emplace_back(trim(argument.substr(0, value_start)),
+					strip_enclosing(argument.substr(value_start + 1), '[', ']'));
+			}
+		}
+	}
+	parse_typed_arguments(*node);
+	return node;
+}
+
+std::shared_ptr<plan_node> build_physical_plan(const boost::property_tree::ptree & p_tree) {
+	auto node = parse_plan_node(p_tree.get<std::string>("expr", ""));
+	for(auto & child : p_tree.get_child("children")) {
+		node->children.push_back(build_physical_plan(child.second));
+	}
+	return node;
+}
+
+std::shared_ptr<plan_node> build_physical_plan(const std::string & json) {
+	std::istringstream input(json);
+	boost::property_tree::ptree p_tree;
+	boost::property_tree::read_json(input, p_tree);
+	return build_physical_plan(p_tree);
+}
+
+std::string normalize_algebra(const std::string & json) {
+	std::string normalized;
+	normalized.reserve(json.size());
+	bool in_string = false;
+	bool escaped = false;
+	for(char c : json) {
+		if(in_string) {
+			// the expressions are kept as they are, the spaces of an alias like `a b` are part of the plan
+			if(escaped) {
+				escaped = false;
+			} else if(c == '\\') {
+				escaped = true;
+			} else if(c == '"') {
+				in_string = false;
+			}
+		} else if(c == '"') {
+			in_string = true;
+		} else if(std::isspace(static_cast<unsigned char>(c))) {
+			continue;
+		}
+		normalized.push_back(c);
+	}
+	return normalized;
+}
+
+size_t count_parameters(const plan_node & plan) {
+	size_t num_parameters = 0;
+	for_each_parameter(plan.arguments_text, [&num_parameters](size_t index, size_t /*position*/, size_t /*length*/) {
+		num_parameters = std::max(num_parameters, index + 1);
+	});
+	for(auto & child : plan.children) {
+		num_parameters = std::max(num_parameters, count_parameters(*child));
+	}
+	return num_parameters;
+}
+
+std::shared_ptr<plan_node> bind_parameters(const plan_node & plan, const std::vector<std::string> & parameters) {
+	std::string bound_text;
+	size_t copied = 0;
+	for_each_parameter(plan.arguments_text, [&](size_t index, size_t position, size_t length) {
+		if(index >= parameters.size()) {
+			throw std::invalid_argument("the query has a parameter ?" + std::to_string(index) + " but only " +
+										std::to_string(parameters.size()) + " parameters were given");
+		}
+		bound_text += plan.arguments_text.substr(copied, position - copied) + parameters[index];
+		copied = position + length;
+	});
+	bound_text += plan.arguments_text.substr(copied);
+
+	// the typed fields are parsed again since the parameters can be part of them
+	auto bound = parse_plan_node(plan_node_kind_name(plan.kind) + bound_text);
+	for(auto & child : plan.children) {
+		bound->children.push_back(bind_parameters(*child, parameters));
+	}
+	return bound;
+}
+
+std::vector<plan_rewrite_rule> get_physical_rewrite_rules(int total_nodes) {
+	bool single_node = total_nodes == 1;
+	return {
+		{"limit_only_sort",
+			[](const plan_node & node) { return node.kind == plan_node_kind::Sort && node.sort_keys.empty(); },
+			[](const std::shared_ptr<plan_node> & node) { return derive_chain(node, {plan_node_kind::Limit}); }},
+		{"top_n_sort",
+			[](const plan_node & node) {
+				return node.kind == plan_node_kind::Sort && node.limit >= 0 && node.limit <= MAX_TOP_N_ROWS;
+			},
+			[](const std::shared_ptr<plan_node> & node) { return derive_chain(node, {plan_node_kind::TopN}); }},
+		{"distributed_sort",
+			[](const plan_node & node) { return node.kind == plan_node_kind::Sort; },
+			[single_node](const std::shared_ptr<plan_node> & node) {
+				if(single_node) {
+					return derive_chain(node, {plan_node_kind::Limit, plan_node_kind::MergeStream,
+						plan_node_kind::PartitionSingleNode, plan_node_kind::SortAndSampleSingleNode});
+				}
+				return derive_chain(node, {plan_node_kind::Limit, plan_node_kind::MergeStream,
+					plan_node_kind::Partition, plan_node_kind::SortAndSample});
+			}},
+		{"distributed_aggregate",
+			[](const plan_node & node) { return node.kind == plan_node_kind::Aggregate; },
+			[single_node](const std::shared_ptr<plan_node> & node) {
+				if(single_node) {
+					return derive_chain(node, {plan_node_kind::MergeAggregate, plan_node_kind::ComputeAggregate});
+				}
+				return derive_chain(node, {plan_node_kind::MergeAggregate, plan_node_kind::DistributeAggregate,
+					plan_node_kind::ComputeAggregate});
+			}},
+		{"distributed_join",
+			[](const plan_node & node) { return node.kind == plan_node_kind::Join; },
+			[single_node](const std::shared_ptr<plan_node> & node) {
+				if(single_node) {
+					return derive_chain(node, {plan_node_kind::PartwiseJoin});
+				}
+				return derive_chain(node, {plan_node_kind::PartwiseJoin, plan_node_kind::JoinPartition});
+			}},
+		// the rows are filtered where the condition is evaluated, so a project below the filter can only be moved
+		// above it when the condition uses the columns it passes through
+		{"fuse_filter_over_project",
+			[](const plan_node & node) {
+				std::string condition;
+				return node.kind == plan_node_kind::Filter && node.children[0]->kind == plan_node_kind::Project &&
+					   substitute_columns(node.condition, node.children[0]->expressions, condition);
+			},
+			[](const std::shared_ptr<plan_node> & node) {
+				auto & project = node->children[0];
+				std::string condition;
+				substitute_columns(node->condition, project->expressions, condition);
+				return make_filter_project(condition, project->expressions, project->aliases, project->children);
+			}},
+		{"fuse_project_over_filter",
+			[](const plan_node & node) {
+				return node.kind == plan_node_kind::Project && node.children[0]->kind == plan_node_kind::Filter;
+			},
+			[](const std::shared_ptr<plan_node> & node) {
+				auto & filter = node->children[0];
+				return make_filter_project(filter->condition, node->expressions, node->aliases, filter->children);
+			}},
+		{"fuse_project_over_filter_project",
+			[](const plan_node & node) {
+				std::vector<std::string> expressions;
+				return node.kind == plan_node_kind::Project && node.children[0]->kind == plan_node_kind::FilterProject &&
+					   substitute_columns(node.expressions, node.children[0]->expressions, expressions);
+			},
+			[](const std::shared_ptr<plan_node> & node) {
+				auto & filter_project = node->children[0];
+				std::vector<std::string> expressions;
+				substitute_columns(node->expressions, filter_project->expressions, expressions);
+				return make_filter_project(filter_project->condition, expressions, node->aliases, filter_project->children);
+			}}};
+}
+
+std::shared_ptr<plan_node> rewrite_plan(const std::shared_ptr<plan_node> & root, const std::vector<plan_rewrite_rule> & rules) {
+	auto node = root;
+	for(auto & child : node->children) {
+		child = rewrite_plan(child, rules);
+	}
+	for(auto & rule : rules) {
+		if(rule.matches(*node)) {
+			return rule.apply(node);
+		}
+	}
+	return node;
+}
+
+size_t num_output_columns(const plan_node & node, const scan_num_columns_fn & scan_num_columns) {
+	switch(node.kind) {
+	case plan_node_kind::TableScan:
+		return scan_num_columns(node);
+	case plan_node_kind::BindableTableScan:
+		return node.projections.empty() ? scan_num_columns(node) : node.projections.size();
+	case plan_node_kind::Project:
+	case plan_node_kind::FilterProject:
+		return node.expressions.size();
+	case plan_node_kind::Aggregate:
+	case plan_node_kind::ComputeAggregate:
+	case plan_node_kind::DistributeAggregate:
+	case plan_node_kind::MergeAggregate:
+		return node.group_columns.size() + node.expressions.size();
+	case plan_node_kind::Join:
+	case plan_node_kind::PartwiseJoin:
+		return num_output_columns(join_input(node, 0), scan_num_columns) +
+			   num_output_columns(join_input(node, 1), scan_num_columns);
+	default:
+		return node.children.empty() ? 0 : num_output_columns(*node.children[0], scan_num_columns);
+	}
+}
+
+const plan_node & join_input(const plan_node & join, size_t index) {
+	if(join.children.size() == 1 && join.children[0]->kind == plan_node_kind::JoinPartition) {
+		return *join.children[0]->children.at(index);
+	}
+	return *join.children.at(index);
+}
+
+namespace {
+
+// The scan and the column of its output that a column of node comes from, when every row of node comes from a row of
+// that scan with the same value in that column. The scan is nullptr otherwise
+std::pair<const plan_node *, int> trace_scan_column(
+	const plan_node & node, int column, const scan_num_columns_fn & scan_num_columns) {
+	switch(node.kind) {
+	case plan_node_kind::TableScan:
+	case plan_node_kind::BindableTableScan:
+		return {&node, column};
+	case plan_node_kind::Filter:
+	case plan_node_kind::MergeStream:
+	case plan_node_kind::Partition:
+	case plan_node_kind::SortAndSample:
+	case plan_node_kind::PartitionSingleNode:
+	case plan_node_kind::SortAndSampleSingleNode:
+		return trace_scan_column(*node.children[0], column, scan_num_columns);
+	case plan_node_kind::Project:
+	case plan_node_kind::FilterProject: {
+		int input_column = column_index(node.expressions.at(column));
+		if(input_column < 0) {
+			return {nullptr, -1};
+		}
+		return trace_scan_column(*node.children[0], input_column, scan_num_columns);
+	}
+	case plan_node_kind::Aggregate:
+	case plan_node_kind::ComputeAggregate:
+		if(static_cast<size_t>(column) >= node.group_columns.size()) {
+			return {nullptr, -1};
+		}
+		return trace_scan_column(*node.children[0], node.group_columns[column], scan_num_columns);
+	case plan_node_kind::DistributeAggregate:
+	case plan_node_kind::MergeAggregate:
+		// their input comes from a ComputeAggregate, which outputs the group columns first
+		if(static_cast<size_t>(column) >= node.group_columns.size()) {
+			return {nullptr, -1};
+		}
+		return trace_scan_column(*node.children[0], column, scan_num_columns);
+	case plan_node_kind::PartwiseJoin: {
+		// a side that keeps its rows without a match would have them with nulls in the other side instead
+		size_t num_left_columns = num_output_columns(join_input(node, 0), scan_num_columns);
+		if(static_cast<size_t>(column) < num_left_columns) {
+			if(node.join_type == "inner" || node.join_type == "left") {
+				return trace_scan_column(join_input(node, 0), column, scan_num_columns);
+			}
+		} else if(node.join_type == "inner" || node.join_type == "right") {
+			return trace_scan_column(join_input(node, 1), column - num_left_columns, scan_num_columns);
+		}
+		return {nullptr, -1};
+	}
+	default:
+		// a Limit keeps other rows when its input has less of them, and a Union has more than one scan
+		return {nullptr, -1};
+	}
+}
+
+void collect_runtime_filters(
+	const plan_node & node, const scan_num_columns_fn & scan_num_columns, std::vector<runtime_filter_spec> & specs) {
+	for(auto & child : node.children) {
+		collect_runtime_filters(*child, scan_num_columns, specs);
+	}
+	if(node.kind != plan_node_kind::PartwiseJoin || (node.join_type != "inner" && node.join_type != "right")) {
+		return;
+	}
+
+	const plan_node & left = join_input(node, 0);
+	const plan_node & right = join_input(node, 1);
+	int num_left_columns = num_output_columns(left, scan_num_columns);
+	for(size_t i = 0; i < node.left_join_keys.size(); i++) {
+		auto scan_column = trace_scan_column(left, node.left_join_keys[i], scan_num_columns);
+		if(scan_column.first != nullptr) {
+			specs.push_back(runtime_filter_spec{static_cast<int32_t>(specs.size()), &node, &right,
+				node.right_join_keys[i] - num_left_columns, scan_column.first, scan_column.second});
+		}
+	}
+}
+
+}  // namespace
+
+std::vector<runtime_filter_spec> plan_runtime_filters(const plan_node & root, const scan_num_columns_fn & scan_num_columns) {
+	std::vector<runtime_filter_spec> specs;
+	collect_runtime_filters(root, scan_num_columns, specs);
+	return specs;
+}
+
+}  // namespace parser
+}  // namespace ral
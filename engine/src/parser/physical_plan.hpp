@@ -0,0 +1,151 @@
+#pragma once
+
+#include <boost/property_tree/ptree.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ral {
+namespace parser {
+
+enum class plan_node_kind {
+	Project,
+	Filter,
+	// a Filter and a Project evaluated together, the condition and the expressions are on the same input
+	FilterProject,
+	TableScan,
+	BindableTableScan,
+	Union,
+	// logical operators that the rewrite rules replace by the physical ones below
+	Sort,
+	Aggregate,
+	Join,
+	// physical operators
+	Limit,
+	TopN,
+	MergeStream,
+	Partition,
+	SortAndSample,
+	PartitionSingleNode,
+	SortAndSampleSingleNode,
+	ComputeAggregate,
+	DistributeAggregate,
+	MergeAggregate,
+	PartwiseJoin,
+	JoinPartition
+};
+
+// The name of the operator of a kind in the relational algebra text, i.e. LogicalProject
+const std::string & plan_node_kind_name(plan_node_kind kind);
+
+struct sort_key {
+	int column;
+	bool ascending;
+};
+
+/**
+ * A relational algebra node parsed once from the text that Calcite generates, i.e.
+ * LogicalJoin(condition=[=($0, $3)], joinType=[inner]).
+ * The arguments are kept in order, and the ones the planner and the kernels use are also parsed into typed fields.
+ */
+struct plan_node {
+	plan_node_kind kind;
+	// text of the arguments, from the opening parenthesis on, as Calcite wrote it
+	std::string arguments_text;
+	// every name=[value] argument, with the outer brackets of the value removed
+	std::vector<std::pair<std::string, std::string>> arguments;
+
+	std::string table_name;                // scans, i.e. main.nation
+	std::vector<size_t> projections;       // columns read by a BindableTableScan, empty means all
+	std::string condition;                 // Filter, FilterProject and Join condition, BindableTableScan filters
+	std::string join_type;                 // Join
+	// equijoin keys, the right keys index the columns of the left input followed by the ones of the right input.
+	// Empty when the condition is not made of equalities between columns only
+	std::vector<int> left_join_keys;
+	std::vector<int> right_join_keys;
+	std::vector<std::string> expressions;  // Project and FilterProject expressions and Aggregate aggregations
+	std::vector<std::string> aliases;      // their names, and the aliases of a scan
+	std::vector<int> group_columns;        // Aggregate
+	std::vector<sort_key> sort_keys;       // Sort
+	int64_t limit = -1;                    // Sort fetch, -1 when there is none
+
+	std::vector<std::shared_ptr<plan_node>> children;
+
+	// The relational algebra text of the node, for the logs. The kernels are built from the node itself
+	std::string expr() const;
+
+	// The value of a named argument, empty if the node does not have it
+	const std::string & argument(const std::string & name) const;
+};
+
+// Parses one node, without its children. Throws BlazingSqlInvalidAlgebraException if the operator is not supported
+std::shared_ptr<plan_node> parse_plan_node(const std::string & expr);
+
+// Builds the plan from the JSON tree of the relational algebra, every node has an expr and its children
+std::shared_ptr<plan_node> build_physical_plan(const boost::property_tree::ptree & p_tree);
+std::shared_ptr<plan_node> build_physical_plan(const std::string & json);
+
+// The relational algebra JSON without the whitespace between its tokens, so that the same plan always gives the same text.
+// The strings of the JSON, that is the expressions of the plan, are kept as they are
+std::string normalize_algebra(const std::string & json);
+
+// How many dynamic parameters the plan has, Calcite writes them as ?0, ?1... in the expressions
+size_t count_parameters(const plan_node & plan);
+
+// A copy of the plan where every ?i is replaced by parameters[i], which has to be a literal as Calcite writes them, i.e. 10, 'abc' or null
+std::shared_ptr<plan_node> bind_parameters(const plan_node & plan, const std::vector<std::string> & parameters);
+
+/**
+ * A rule that replaces the nodes it matches with a subtree.
+ * apply gets the node with its children and returns the root of what replaces it, that must end in the same children.
+ */
+struct plan_rewrite_rule {
+	std::string name;
+	std::function<bool(const plan_node &)> matches;
+	std::function<std::shared_ptr<plan_node>(const std::shared_ptr<plan_node> &)> apply;
+};
+
+// Sorts with a limit of up to this many rows run as a TopN, which keeps that many candidates per node instead of
+// sorting and shuffling all the rows
+const int64_t MAX_TOP_N_ROWS = 100000;
+
+// The rules that turn the Sort, Aggregate and Join nodes into the kernels that run them in a cluster of total_nodes nodes,
+// and that fuse the chains of Filter and Project nodes into FilterProject nodes
+std::vector<plan_rewrite_rule> get_physical_rewrite_rules(int total_nodes);
+
+// Applies the first rule that matches to every node, children first. The nodes that a rule creates are not rewritten again
+std::shared_ptr<plan_node> rewrite_plan(const std::shared_ptr<plan_node> & root, const std::vector<plan_rewrite_rule> & rules);
+
+// The number of columns of a scan, the ones of its table when it does not have projections
+using scan_num_columns_fn = std::function<size_t(const plan_node &)>;
+
+// The number of columns that a node of a physical plan outputs
+size_t num_output_columns(const plan_node & node, const scan_num_columns_fn & scan_num_columns);
+
+// The input of a PartwiseJoin, 0 for the left one and 1 for the right one, skipping the JoinPartition in between if there is one
+const plan_node & join_input(const plan_node & join, size_t index);
+
+/**
+ * A filter that the build side of an equijoin sends to a scan of its probe side, so that the scan drops the rows
+ * whose key can not have a match before they are joined or shuffled.
+ * The build side is the right input of an inner or right join, the keys that it has are the only ones that a row
+ * coming from the left input can join with.
+ */
+struct runtime_filter_spec {
+	int32_t id;
+	const plan_node * join;         // the PartwiseJoin
+	const plan_node * build_input;  // its right input, whose rows build the filter
+	int build_column;               // the key column in the right input
+	const plan_node * scan;         // the scan of the left input whose rows are filtered
+	int scan_column;                // the key column in the output of the scan
+};
+
+// The filters for every key of the joins of a physical plan whose left key comes straight from a scan column, that is
+// through filters, sorts, aggregation keys, projections that keep the column as it is and the inputs of other joins
+// that do not keep the rows without a match
+std::vector<runtime_filter_spec> plan_runtime_filters(const plan_node & root, const scan_num_columns_fn & scan_num_columns);
+
+}  // namespace parser
+}  // namespace ral
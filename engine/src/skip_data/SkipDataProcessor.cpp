@@ -2,6 +2,7 @@
 #include "SkipDataProcessor.h"
 
 #include <cudf/column/column_factories.hpp>
+#include <cudf/scalar/scalar.hpp>
 #include "parser/expression_tree.hpp"
 #include "CalciteExpressionParsing.h"
 #include "execution_graph/logic_controllers/LogicalFilter.h"
@@ -83,6 +84,29 @@ std::pair<std::unique_ptr<ral::frame::BlazingTable>, bool> process_skipdata_for_
         }
     }
     
+    // the number of rows and the null counts go after the mins and maxes, see apply_skip_data_rules. The columns that have a
+    // min and a max but no null count are the partition columns of hive tables, which never have nulls
+    int null_count_columns = -1;
+    std::unique_ptr<cudf::column> temp_no_nulls;
+    auto num_rows_it = std::find(metadata_names.begin(), metadata_names.end(), "num_rows");
+    if (num_rows_it != metadata_names.end()) {
+        std::unique_ptr<cudf::scalar> no_nulls = cudf::make_numeric_scalar(cudf::data_type(cudf::type_id::INT64));
+        static_cast<cudf::experimental::scalar_type_t<int64_t> *>(no_nulls.get())->set_value(0);
+        temp_no_nulls = cudf::make_column_from_scalar(*no_nulls, rows);
+        projected_metadata_cols.emplace_back(std::move(metadata_columns[std::distance(metadata_names.begin(), num_rows_it)]));
+        for (int i = 0; i < column_indeces.size(); i++){
+            int col_index = column_indeces[i];
+            std::string metadata_null_count_name = "null_count_" + std::to_string(col_index) + '_' + names[col_index];
+            auto it = std::find(metadata_names.begin(), metadata_names.end(), metadata_null_count_name);
+            if (it != metadata_names.end()) {
+                projected_metadata_cols.emplace_back(std::move(metadata_columns[std::distance(metadata_names.begin(), it)]));
+            } else {
+                projected_metadata_cols.emplace_back(std::make_unique<ral::frame::BlazingColumnView>(temp_no_nulls->view()));
+            }
+        }
+        null_count_columns = column_indeces.size();
+    }
+
     // process filter_string to convert to skip data version
     ral::parser::parse_tree tree;
     if (tree.build(filter_string)){
@@ -92,7 +116,7 @@ std::pair<std::unique_ptr<ral::frame::BlazingTable>, bool> process_skipdata_for_
                 tree.drop({"$" + std::to_string(i)});
             }
         }
-        tree.apply_skip_data_rules();
+        tree.apply_skip_data_rules(null_count_columns);
         if (tree.is_valid()) {
             // std::cout << " skiP-data: " << filter_string << " | " << tree.rebuildExpression() << std::endl; 
             filter_string =  tree.rebuildExpression();
@@ -4,11 +4,134 @@
 #include <iostream>
 #include <regex>
 
+#include "parser/expression_tree.hpp"
 #include "parser/expression_utils.hpp"
 
 namespace ral {
 namespace skip_data {
 
+namespace {
+
+// Adds to values the literal of an = of column and a literal, or the ones of an
+// OR of them. False for any other node, or for one that compares another column
+bool collect_equality_values(const ral::parser::parse_node *node,
+                             std::string &column,
+                             std::vector<std::string> &values) {
+  if (node->type != ral::parser::parse_node_type::OPERATOR) {
+    return false;
+  }
+  if (node->value == "OR") {
+    return std::all_of(node->children.begin(), node->children.end(),
+                       [&column, &values](const auto &child) {
+                         return collect_equality_values(child.get(), column,
+                                                        values);
+                       });
+  }
+  if (node->value != "=" || node->children.size() != 2) {
+    return false;
+  }
+
+  const ral::parser::parse_node *var = node->children[0].get();
+  const ral::parser::parse_node *literal = node->children[1].get();
+  if (!is_var_column(var->value)) {
+    std::swap(var, literal);
+  }
+  if (var->type != ral::parser::parse_node_type::OPERAND ||
+      literal->type != ral::parser::parse_node_type::OPERAND ||
+      !is_var_column(var->value) ||
+      !(is_number(literal->value) || is_string(literal->value))) {
+    return false;
+  }
+  if (!column.empty() && column != var->value) {
+    return false;
+  }
+  column = var->value;
+  values.push_back(literal->value);
+  return true;
+}
+
+void collect_conjuncts(const ral::parser::parse_node *node,
+                       std::map<int, std::vector<std::string>> &values) {
+  if (node->type == ral::parser::parse_node_type::OPERATOR &&
+      node->value == "AND") {
+    for (auto &&child : node->children) {
+      collect_conjuncts(child.get(), values);
+    }
+    return;
+  }
+
+  std::string column;
+  std::vector<std::string> column_values;
+  if (collect_equality_values(node, column, column_values)) {
+    values.emplace(get_id(column), std::move(column_values));
+  }
+}
+
+// Narrows the bounds of the column of a comparison of a column and a literal
+// number. False for any other node
+bool add_column_bound(const ral::parser::parse_node *node,
+                      std::map<int, column_bounds> &bounds) {
+  static const std::vector<std::string> comparisons = {"=", "<", "<=", ">",
+                                                       ">="};
+  if (node->type != ral::parser::parse_node_type::OPERATOR ||
+      std::find(comparisons.begin(), comparisons.end(), node->value) ==
+          comparisons.end() ||
+      node->children.size() != 2) {
+    return false;
+  }
+
+  const ral::parser::parse_node *var = node->children[0].get();
+  const ral::parser::parse_node *literal = node->children[1].get();
+  std::string op = node->value;
+  if (!is_var_column(var->value)) {
+    // 5 < $0 is $0 > 5
+    std::swap(var, literal);
+    if (op[0] == '<') {
+      op[0] = '>';
+    } else if (op[0] == '>') {
+      op[0] = '<';
+    }
+  }
+  if (var->type != ral::parser::parse_node_type::OPERAND ||
+      literal->type != ral::parser::parse_node_type::OPERAND ||
+      !is_var_column(var->value) || !is_number(literal->value)) {
+    return false;
+  }
+
+  column_bounds &column = bounds[get_id(var->value)];
+  double value = std::stod(literal->value);
+  bool inclusive = op.size() == 1 ? op == "=" : true;
+  if (op != "<" && op != "<=") {
+    if (column.lower.empty() || value > std::stod(column.lower) ||
+        (value == std::stod(column.lower) && !inclusive)) {
+      column.lower = literal->value;
+      column.lower_inclusive = inclusive;
+    }
+  }
+  if (op != ">" && op != ">=") {
+    if (column.upper.empty() || value < std::stod(column.upper) ||
+        (value == std::stod(column.upper) && !inclusive)) {
+      column.upper = literal->value;
+      column.upper_inclusive = inclusive;
+    }
+  }
+  return true;
+}
+
+void collect_bounds(const ral::parser::parse_node *node,
+                    std::map<int, column_bounds> &bounds) {
+  if (node->type == ral::parser::parse_node_type::OPERATOR &&
+      node->value == "AND") {
+    for (auto &&child : node->children) {
+      collect_bounds(child.get(), bounds);
+    }
+    return;
+  }
+  add_column_bound(node, bounds);
+}
+
+} // namespace
+
 bool is_binary_op(const std::string &test) {
   return interops::is_binary_operator(map_to_operator_type(test));
 }
@@ -35,10 +158,17 @@ bool is_exclusion_unary_op(const std::string &test) {
     // special type
     return true;
   }
+  if (is_null_count_op(test)) {
+    return false;
+  }
   
   return interops::is_unary_operator(map_to_operator_type(test));
 }
 
+bool is_null_count_op(const std::string &test) {
+  return test == "IS_NULL" || test == "IS_NOT_NULL";
+}
+
 int get_id(const std::string &s) {
   auto text = s.substr(1);
   int number;
@@ -65,5 +195,28 @@ std::vector<std::string> split(const std::string &str,
   } while (pos < str.length() && prev < str.length());
   return tokens;
 }
+
+std::map<int, std::vector<std::string>>
+get_equality_values(const std::string &filter) {
+  std::map<int, std::vector<std::string>> values;
+  if (filter.empty()) {
+    return values;
+  }
+  ral::parser::parse_tree tree;
+  tree.build(replace_calcite_regex(filter));
+  collect_conjuncts(tree.root.get(), values);
+  return values;
+}
+
+std::map<int, column_bounds> get_column_bounds(const std::string &filter) {
+  std::map<int, column_bounds> bounds;
+  if (filter.empty()) {
+    return bounds;
+  }
+  ral::parser::parse_tree tree;
+  tree.build(replace_calcite_regex(filter));
+  collect_bounds(tree.root.get(), bounds);
+  return bounds;
+}
 } // namespace skip_data
 } // namespace ral
@@ -1,4 +1,5 @@
 #pragma once
+#include <map>
 #include <string>
 #include <vector>
 
@@ -13,9 +14,32 @@ bool is_unsupported_binary_op(const std::string &test);
 
 bool is_exclusion_unary_op(const std::string &test);
 
+// IS_NULL and IS_NOT_NULL, which are evaluated with the null counts of the metadata
+bool is_null_count_op(const std::string &test);
+
 int get_id(const std::string &s);
 
 std::vector<std::string> split(const std::string &str,
                                const std::string &delim = " ");
+
+// The literals that a column has to be equal to for the filter to be true, for
+// the columns that one of the conjuncts of the filter compares with = or IN,
+// which is an OR of = of the same column. The literals are kept as they are in
+// the filter, and a column of several conjuncts keeps the ones of the first
+std::map<int, std::vector<std::string>>
+get_equality_values(const std::string &filter);
+
+// The bounds of the values of a column for the filter to be true. A bound is a
+// literal number, empty when the column does not have it
+struct column_bounds {
+  std::string lower;
+  bool lower_inclusive = true;
+  std::string upper;
+  bool upper_inclusive = true;
+};
+
+// The bounds of the columns that the conjuncts of the filter compare with a
+// literal number, with =, <, <=, > or >=. The tightest one is kept
+std::map<int, column_bounds> get_column_bounds(const std::string &filter);
 } // namespace skip_data
 } // namespace ral
\ No newline at end of file
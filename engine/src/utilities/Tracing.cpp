@@ -0,0 +1,201 @@
+#include "Tracing.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ral {
+namespace utilities {
+
+std::atomic<int> num_traced_queries{0};
+
+namespace {
+
+const size_t MAX_TRACED_QUERIES = 16;
+const size_t TRACE_BUFFER_EVENTS = 1 << 14;  // per thread, the oldest events are overwritten
+
+// A ring of the events of a thread. Only its thread writes it, the exporters copy the events and drop the ones that
+// were overwritten while they copied them
+class trace_buffer {
+public:
+	trace_buffer(int thread_id) : events(TRACE_BUFFER_EVENTS), num_recorded(0), thread_exited(false), thread_id(thread_id) {}
+
+	void record(const trace_event & event) {
+		uint64_t index = num_recorded.load(std::memory_order_relaxed);
+		events[index % events.size()] = event;
+		num_recorded.store(index + 1, std::memory_order_release);
+	}
+
+	template <typename Predicate>
+	void collect(Predicate keep, std::vector<trace_event> & collected) const {
+		uint64_t end = num_recorded.load(std::memory_order_acquire);
+		uint64_t begin = end > events.size() ? end - events.size() : 0;
+		std::vector<trace_event> copied;
+		for(uint64_t index = begin; index < end; index++) {
+			copied.push_back(events[index % events.size()]);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t overwritten = num_recorded.load(std::memory_order_relaxed) - begin;
+		overwritten = overwritten > events.size() ? overwritten - events.size() : 0;
+		for(size_t i = overwritten; i < copied.size(); i++) {
+			if(keep(copied[i])) {
+				collected.push_back(copied[i]);
+			}
+		}
+	}
+
+	std::vector<trace_event> events;
+	std::atomic<uint64_t> num_recorded;
+	std::atomic<bool> thread_exited;
+	const int thread_id;
+};
+
+// Marks the buffer of the thread when the thread exits, so that it is released once its spans are not needed
+struct thread_trace_buffer {
+	~thread_trace_buffer() {
+		if(buffer) {
+			buffer->thread_exited = true;
+		}
+	}
+	std::shared_ptr<trace_buffer> buffer;
+};
+
+// the traced query ids plus one, so that the zero they start with is a free slot
+std::array<std::atomic<int64_t>, MAX_TRACED_QUERIES> traced_queries{};
+
+// guards the list of buffers and the changes of traced_queries, not the recording
+std::mutex trace_buffers_mutex;
+std::vector<std::shared_ptr<trace_buffer>> trace_buffers;
+int next_trace_thread_id = 0;
+
+// steady_clock to system_clock, so that the spans of the nodes of a distributed query are in the same time
+const int64_t trace_clock_offset_ns =
+	std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count() -
+	trace_clock_ns();
+
+thread_local thread_trace_buffer this_thread_buffer;
+thread_local int64_t this_thread_query_id = NO_TRACE_QUERY;
+
+std::shared_ptr<trace_buffer> register_trace_buffer() {
+	std::lock_guard<std::mutex> lock(trace_buffers_mutex);
+	auto buffer = std::make_shared<trace_buffer>(next_trace_thread_id++);
+	trace_buffers.push_back(buffer);
+	return buffer;
+}
+
+void append_trace_event_json(std::string & json, const trace_event & event, int node_index, int thread_id) {
+	char times[64];
+	double start_us = (event.start_ns + trace_clock_offset_ns) / 1000.0;
+	if(event.duration_ns >= 0) {
+		std::snprintf(times, sizeof(times), "\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", start_us, event.duration_ns / 1000.0);
+	} else {
+		std::snprintf(times, sizeof(times), "\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", start_us);
+	}
+	json += ",\n{\"name\":\"" + std::string(event.name) + "\",\"cat\":\"" + std::string(event.category) + "\"," + times +
+			",\"pid\":" + std::to_string(node_index) + ",\"tid\":" + std::to_string(thread_id);
+	if(event.arg_name != nullptr) {
+		json += ",\"args\":{\"" + std::string(event.arg_name) + "\":" + std::to_string(event.arg_value) + "}";
+	}
+	json += "}";
+}
+
+}  // namespace
+
+bool start_query_trace(int64_t query_id) {
+	std::lock_guard<std::mutex> lock(trace_buffers_mutex);
+	for(auto & query : traced_queries) {
+		if(query.load() == 0) {
+			query = query_id + 1;
+			num_traced_queries++;
+			return true;
+		}
+	}
+	return false;
+}
+
+void stop_query_trace(int64_t query_id) {
+	std::lock_guard<std::mutex> lock(trace_buffers_mutex);
+	for(auto & query : traced_queries) {
+		if(query.load() == query_id + 1) {
+			query = 0;
+			num_traced_queries--;
+			break;
+		}
+	}
+
+	// the threads of the other traced queries may still record into theirs
+	trace_buffers.erase(std::remove_if(trace_buffers.begin(), trace_buffers.end(), [](const std::shared_ptr<trace_buffer> & buffer) {
+		if(!buffer->thread_exited) {
+			return false;
+		}
+		std::vector<trace_event> events;
+		buffer->collect([](const trace_event & event) { return is_query_traced(event.query_id); }, events);
+		return events.empty();
+	}), trace_buffers.end());
+}
+
+bool is_query_traced(int64_t query_id) {
+	if(query_id == NO_TRACE_QUERY) {
+		return false;
+	}
+	for(auto & query : traced_queries) {
+		if(query.load(std::memory_order_relaxed) == query_id + 1) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void set_thread_trace_query(int64_t query_id) { this_thread_query_id = query_id; }
+
+int64_t get_thread_trace_query() { return this_thread_query_id; }
+
+void record_trace_event(trace_event event) {
+	if(event.query_id == NO_TRACE_QUERY) {
+		event.query_id = this_thread_query_id;
+	}
+	if(!is_query_traced(event.query_id)) {
+		return;
+	}
+	if(!this_thread_buffer.buffer) {
+		this_thread_buffer.buffer = register_trace_buffer();
+	}
+	this_thread_buffer.buffer->record(event);
+}
+
+std::string get_query_trace_json(int64_t query_id, int node_index) {
+	std::vector<std::pair<int, trace_event>> events;
+	{
+		std::lock_guard<std::mutex> lock(trace_buffers_mutex);
+		for(auto & buffer : trace_buffers) {
+			std::vector<trace_event> buffer_events;
+			buffer->collect([query_id](const trace_event & event) { return event.query_id == query_id; }, buffer_events);
+			for(auto & event : buffer_events) {
+				events.emplace_back(buffer->thread_id, event);
+			}
+		}
+	}
+	std::sort(events.begin(), events.end(), [](const std::pair<int, trace_event> & a, const std::pair<int, trace_event> & b) {
+		return a.second.start_ns < b.second.start_ns;
+	});
+
+	std::string json = "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + std::to_string(node_index) +
+					   ",\"args\":{\"name\":\"node " + std::to_string(node_index) + " query " + std::to_string(query_id) + "\"}}";
+	for(auto & event : events) {
+		append_trace_event_json(json, event.second, node_index, event.first);
+	}
+	json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return json;
+}
+
+bool write_query_trace(int64_t query_id, int node_index, const std::string & path) {
+	std::ofstream file(path);
+	file << get_query_trace_json(query_id, node_index);
+	return file.good();
+}
+
+}  // namespace utilities
+}  // namespace ral
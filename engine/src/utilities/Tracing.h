@@ -0,0 +1,134 @@
+#ifndef BLAZINGDB_RAL_UTILITIES_TRACING_H
+#define BLAZINGDB_RAL_UTILITIES_TRACING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace ral {
+namespace utilities {
+
+// Spans of the work of the traced queries, to see which kernels overlap and where their threads wait. Every thread
+// records its spans into a buffer of its own, so recording does not take a lock, and the spans of a query are exported
+// as Chrome trace events, which chrome://tracing and Perfetto load
+
+const int64_t NO_TRACE_QUERY = -1;
+
+struct trace_event {
+	const char * category;
+	const char * name;
+	const char * arg_name;  // null if the event does not have an argument
+	int64_t arg_value;
+	int64_t query_id;
+	int64_t start_ns;
+	int64_t duration_ns;  // negative for an instant event
+};
+
+// How many queries are being traced, nothing is recorded while there are none
+extern std::atomic<int> num_traced_queries;
+
+inline bool is_tracing_enabled() { return num_traced_queries.load(std::memory_order_relaxed) > 0; }
+
+inline int64_t trace_clock_ns() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Starts recording the spans of the query, false if there are already too many queries being traced
+bool start_query_trace(int64_t query_id);
+
+// Stops recording the spans of the query and releases the buffers of the finished threads that only had its spans
+void stop_query_trace(int64_t query_id);
+
+bool is_query_traced(int64_t query_id);
+
+// The spans of the thread that do not say their query are of this one
+void set_thread_trace_query(int64_t query_id);
+
+int64_t get_thread_trace_query();
+
+// Records the event into the buffer of the thread, if its query is traced
+void record_trace_event(trace_event event);
+
+// The spans of the query that are still in the buffers, as Chrome trace JSON. Every node is a process of the trace, so
+// the files of the nodes of a distributed query can be merged into one timeline
+std::string get_query_trace_json(int64_t query_id, int node_index);
+
+// Writes get_query_trace_json into the file, false if it can not be written
+bool write_query_trace(int64_t query_id, int node_index, const std::string & path);
+
+// Sets the trace query of the thread while it is in scope
+class scoped_trace_query {
+public:
+	explicit scoped_trace_query(int64_t query_id) : previous_query_id(get_thread_trace_query()) {
+		set_thread_trace_query(query_id);
+	}
+	~scoped_trace_query() { set_thread_trace_query(previous_query_id); }
+
+	scoped_trace_query(const scoped_trace_query &) = delete;
+	scoped_trace_query & operator=(const scoped_trace_query &) = delete;
+
+private:
+	int64_t previous_query_id;
+};
+
+// Wraps the function of a thread so that it runs with the trace query of the thread that wraps it, since a new thread
+// does not have one. For the threads that the kernels spawn, like BlazingThread(with_trace_query([this]() { ... }))
+template <typename Function>
+auto with_trace_query(Function function) {
+	return [query_id = get_thread_trace_query(), function = std::move(function)](auto &&... args) mutable {
+		scoped_trace_query trace_query(query_id);
+		return function(std::forward<decltype(args)>(args)...);
+	};
+}
+
+// Records the time from its construction to its destruction. The category, name and arg_name are not copied, they have
+// to be string literals. When tracing is disabled it only loads an atomic
+class trace_span {
+public:
+	trace_span(const char * category,
+		const char * name,
+		int64_t query_id = NO_TRACE_QUERY,
+		const char * arg_name = nullptr,
+		int64_t arg_value = 0)
+		: event{category, name, arg_name, arg_value, query_id, -1, 0} {
+		if(is_tracing_enabled()) {
+			event.start_ns = trace_clock_ns();
+		}
+	}
+	~trace_span() {
+		if(event.start_ns >= 0) {
+			event.duration_ns = trace_clock_ns() - event.start_ns;
+			record_trace_event(event);
+		}
+	}
+
+	// For the arguments that are only known at the end of the span, like the bytes that it read
+	void set_arg(const char * arg_name, int64_t arg_value) {
+		event.arg_name = arg_name;
+		event.arg_value = arg_value;
+	}
+
+	trace_span(const trace_span &) = delete;
+	trace_span & operator=(const trace_span &) = delete;
+
+private:
+	trace_event event;
+};
+
+// Records a point in time, like a spill of a batch
+inline void trace_instant(const char * category,
+	const char * name,
+	int64_t query_id = NO_TRACE_QUERY,
+	const char * arg_name = nullptr,
+	int64_t arg_value = 0) {
+	if(is_tracing_enabled()) {
+		record_trace_event({category, name, arg_name, arg_value, query_id, trace_clock_ns(), -1});
+	}
+}
+
+}  // namespace utilities
+}  // namespace ral
+
+#endif  // BLAZINGDB_RAL_UTILITIES_TRACING_H
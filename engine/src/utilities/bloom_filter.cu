@@ -0,0 +1,110 @@
+#include <cudf/column/column_factories.hpp>
+#include <cudf/utilities/bit.hpp>
+#include <thrust/execution_policy.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/transform.h>
+
+#include "bloom_filter.cuh"
+
+namespace ral {
+namespace utilities {
+namespace {
+
+const int NUM_BLOOM_FILTER_HASHES = 3;
+
+struct BloomFilterBits {
+    BloomFilterBits(const cudf::column_view & keys, const cudf::column_view & hashes_a, const cudf::column_view & hashes_b,
+        std::size_t num_words)
+    : null_mask{keys.null_mask()}, offset{keys.offset()}, hashes_a{hashes_a.data<uint32_t>()},
+      hashes_b{hashes_b.data<uint32_t>()}, bit_mask{num_words * 64 - 1}
+    { }
+
+    __device__
+    bool is_valid(cudf::size_type index) const {
+        return null_mask == nullptr || cudf::bit_is_set(null_mask, index + offset);
+    }
+
+    __device__
+    uint64_t bit(cudf::size_type index, int i) const {
+        // the second hash is made odd so that the probes of a key never repeat
+        uint64_t step = static_cast<uint64_t>(hashes_b[index]) | 1;
+        return (static_cast<uint64_t>(hashes_a[index]) + i * step) & bit_mask;
+    }
+
+    const cudf::bitmask_type * null_mask;
+    const cudf::size_type offset;
+    const uint32_t * hashes_a;
+    const uint32_t * hashes_b;
+    const uint64_t bit_mask;
+};
+
+struct InsertKey {
+    InsertKey(BloomFilterBits bits, uint64_t * words) : bits{bits}, words{words} { }
+
+    __device__
+    void operator()(cudf::size_type index) {
+        if (!bits.is_valid(index)) {
+            return;
+        }
+        for (int i = 0; i < NUM_BLOOM_FILTER_HASHES; i++) {
+            uint64_t bit = bits.bit(index, i);
+            atomicOr(reinterpret_cast<unsigned long long int *>(words + bit / 64), 1ull << (bit % 64));
+        }
+    }
+
+    BloomFilterBits bits;
+    uint64_t * words;
+};
+
+struct ContainsKey {
+    ContainsKey(BloomFilterBits bits, const uint64_t * words) : bits{bits}, words{words} { }
+
+    __device__
+    uint8_t operator()(cudf::size_type index) {
+        if (!bits.is_valid(index)) {
+            return 0;
+        }
+        for (int i = 0; i < NUM_BLOOM_FILTER_HASHES; i++) {
+            uint64_t bit = bits.bit(index, i);
+            if ((words[bit / 64] & (1ull << (bit % 64))) == 0) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    BloomFilterBits bits;
+    const uint64_t * words;
+};
+
+} // namespace
+
+void bloom_filter_insert(const cudf::column_view & keys, const cudf::column_view & hashes_a, const cudf::column_view & hashes_b,
+    uint64_t * words, std::size_t num_words) {
+
+    thrust::for_each(thrust::device,
+                     thrust::counting_iterator<cudf::size_type>(0),
+                     thrust::counting_iterator<cudf::size_type>(keys.size()),
+                     InsertKey(BloomFilterBits(keys, hashes_a, hashes_b, num_words), words));
+}
+
+std::unique_ptr<cudf::column> bloom_filter_contains(const cudf::column_view & keys, const cudf::column_view & hashes_a,
+    const cudf::column_view & hashes_b, const uint64_t * words, std::size_t num_words) {
+
+    auto result = cudf::make_numeric_column(cudf::data_type{cudf::type_id::BOOL8}, keys.size(), cudf::mask_state::UNALLOCATED);
+    thrust::transform(thrust::device,
+                      thrust::counting_iterator<cudf::size_type>(0),
+                      thrust::counting_iterator<cudf::size_type>(keys.size()),
+                      result->mutable_view().data<uint8_t>(),
+                      ContainsKey(BloomFilterBits(keys, hashes_a, hashes_b, num_words), words));
+    return result;
+}
+
+void bloom_filter_merge(uint64_t * words, const uint64_t * other_words, std::size_t num_words) {
+    thrust::transform(thrust::device, words, words + num_words, other_words, words, thrust::bit_or<uint64_t>());
+}
+
+} // namespace utilities
+} // namespace ral
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <cudf/column/column.hpp>
+#include <cudf/column/column_view.hpp>
+
+namespace ral {
+namespace utilities {
+
+// The bits of a key are found by double hashing from two hashes of it, hashes_a and hashes_b are the INT32 columns
+// that cudf::hash gives for the keys with two different seeds. The nulls of keys are never in the filter.
+// num_words has to be a power of two.
+
+// Sets the bits of the keys that are not null in the words of the filter
+void bloom_filter_insert(const cudf::column_view & keys, const cudf::column_view & hashes_a, const cudf::column_view & hashes_b,
+	uint64_t * words, std::size_t num_words);
+
+// A BOOL8 column without nulls that is false for the keys that are not in the filter and for the null ones
+std::unique_ptr<cudf::column> bloom_filter_contains(const cudf::column_view & keys, const cudf::column_view & hashes_a,
+	const cudf::column_view & hashes_b, const uint64_t * words, std::size_t num_words);
+
+// words |= other_words
+void bloom_filter_merge(uint64_t * words, const uint64_t * other_words, std::size_t num_words);
+
+} // namespace utilities
+} // namespace ral
@@ -0,0 +1,53 @@
+#include <from_cudf/cpp_tests/utilities/column_utilities.hpp>
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <from_cudf/cpp_tests/utilities/table_utilities.hpp>
+
+#include <cudf/copying.hpp>
+#include <cudf/sorting.hpp>
+
+#include "operators/GroupBy.h"
+#include "../BlazingUnitTest.h"
+
+struct MergePartialAggregationsTest : public BlazingUnitTest {};
+
+static std::unique_ptr<ral::frame::BlazingTable> aggregate_batch(const ral::frame::BlazingTableView & batch) {
+	return ral::operators::compute_aggregations_with_groupby(batch, {"$1", "$1"},
+		{AggregateKind::SUM, AggregateKind::COUNT_VALID}, {"sum", "count"}, {0});
+}
+
+static std::unique_ptr<CudfTable> sort_by_key(const CudfTableView & table) {
+	std::unique_ptr<cudf::column> order = cudf::experimental::sorted_order(table.select({0}));
+	return cudf::experimental::gather(table, order->view());
+}
+
+// The state of the first fold has the COUNT as an INT64 SUM, while the partial results of the batches after it still
+// have it as an INT32 COUNT, so the second fold merges tables of different types
+TEST_F(MergePartialAggregationsTest, FoldsPartialResultsWithWidenedTypes) {
+	std::vector<std::string> names{"key", "value"};
+	cudf::test::fixed_width_column_wrapper<int32_t> key_1{{1, 2, 1}};
+	cudf::test::fixed_width_column_wrapper<int32_t> value_1{{10, 20, 30}};
+	cudf::test::fixed_width_column_wrapper<int32_t> key_2{{2, 3}};
+	cudf::test::fixed_width_column_wrapper<int32_t> value_2{{5, 7}};
+	cudf::test::fixed_width_column_wrapper<int32_t> key_3{{1, 3, 3, 4}};
+	cudf::test::fixed_width_column_wrapper<int32_t> value_3{{1, 2, 3, 4}, {1, 1, 1, 0}};
+
+	auto partial_1 = aggregate_batch(ral::frame::BlazingTableView(CudfTableView{{key_1, value_1}}, names));
+	auto partial_2 = aggregate_batch(ral::frame::BlazingTableView(CudfTableView{{key_2, value_2}}, names));
+	auto partial_3 = aggregate_batch(ral::frame::BlazingTableView(CudfTableView{{key_3, value_3}}, names));
+
+	std::vector<AggregateKind> aggregation_types{AggregateKind::SUM, AggregateKind::COUNT_VALID};
+	std::vector<int> group_column_indices{0};
+	auto state = ral::operators::merge_partial_aggregations(
+		{partial_1->toBlazingTableView(), partial_2->toBlazingTableView()}, group_column_indices, aggregation_types);
+	ASSERT_NE(state->view().column(2).type(), partial_3->view().column(2).type());
+
+	state = ral::operators::merge_partial_aggregations(
+		{state->toBlazingTableView(), partial_3->toBlazingTableView()}, group_column_indices, aggregation_types);
+
+	cudf::test::fixed_width_column_wrapper<int32_t> expected_key{{1, 2, 3, 4}};
+	cudf::test::fixed_width_column_wrapper<int64_t> expected_sum{{41, 25, 12, 0}, {1, 1, 1, 0}};
+	cudf::test::fixed_width_column_wrapper<int64_t> expected_count{{3, 2, 3, 0}};
+	CudfTableView expected{{expected_key, expected_sum, expected_count}};
+
+	cudf::test::expect_tables_equal(expected, sort_by_key(state->view())->view());
+}
@@ -0,0 +1,72 @@
+#include "distribution/broadcast_join.h"
+#include "../BlazingUnitTest.h"
+
+#include <limits>
+
+using ral::distribution::JoinSideSize;
+using ral::distribution::SmallTableScatterDecision;
+
+struct BroadcastJoinTest : public BlazingUnitTest {};
+
+const int64_t max_overhead = 500000000;
+
+TEST_F(BroadcastJoinTest, SmallCompleteSideIsScattered) {
+	std::vector<JoinSideSize> left{{1000, true}, {2000, true}, {1500, true}, {500, true}};
+	std::vector<JoinSideSize> right{{100000000, false}, {100000000, false}, {100000000, false}, {100000000, false}};
+
+	SmallTableScatterDecision decision = ral::distribution::decideSmallTableScatter(left, right, max_overhead);
+
+	EXPECT_TRUE(decision.scatter_left);
+	EXPECT_FALSE(decision.scatter_right);
+	EXPECT_TRUE(decision.scattered_side_complete);
+	EXPECT_EQ(5000, decision.total_bytes_left);
+	EXPECT_EQ(5000 * 3, decision.estimate_scatter);
+	EXPECT_EQ(std::numeric_limits<int64_t>::max(), ral::distribution::getScatterBudgetBytes(decision, 1000, 4, max_overhead));
+}
+
+TEST_F(BroadcastJoinTest, SidesOfSimilarSizeAreHashPartitioned) {
+	std::vector<JoinSideSize> left{{1000000, true}, {1000000, true}};
+	std::vector<JoinSideSize> right{{1200000, true}, {800000, true}};
+
+	SmallTableScatterDecision decision = ral::distribution::decideSmallTableScatter(left, right, max_overhead);
+
+	EXPECT_FALSE(decision.scatter_left);
+	EXPECT_FALSE(decision.scatter_right);
+}
+
+TEST_F(BroadcastJoinTest, SideOverMaxOverheadIsNotScattered) {
+	std::vector<JoinSideSize> left{{4000000000, false}, {4000000000, false}};
+	std::vector<JoinSideSize> right{{300000000, false}, {300000000, false}};
+
+	SmallTableScatterDecision decision = ral::distribution::decideSmallTableScatter(left, right, max_overhead);
+
+	EXPECT_FALSE(decision.scatter_left);
+	EXPECT_FALSE(decision.scatter_right);
+}
+
+TEST_F(BroadcastJoinTest, SingleNodeNeverScatters) {
+	std::vector<JoinSideSize> left{{1000, true}};
+	std::vector<JoinSideSize> right{{100000000, true}};
+
+	SmallTableScatterDecision decision = ral::distribution::decideSmallTableScatter(left, right, max_overhead);
+
+	EXPECT_FALSE(decision.scatter_left);
+	EXPECT_FALSE(decision.scatter_right);
+}
+
+TEST_F(BroadcastJoinTest, IncompleteSideGetsBudgetWithItsShareOfTheRoomLeft) {
+	std::vector<JoinSideSize> left{{400000000, false}, {400000000, false}};
+	std::vector<JoinSideSize> right{{100000000, false}, {50000000, false}};
+
+	SmallTableScatterDecision decision = ral::distribution::decideSmallTableScatter(left, right, max_overhead);
+
+	ASSERT_TRUE(decision.scatter_right);
+	EXPECT_FALSE(decision.scattered_side_complete);
+
+	// 350000000 bytes are left under the max overhead, each of the two nodes can take half of it
+	int64_t first_node_budget = ral::distribution::getScatterBudgetBytes(decision, 100000000, 2, max_overhead);
+	int64_t second_node_budget = ral::distribution::getScatterBudgetBytes(decision, 50000000, 2, max_overhead);
+	EXPECT_EQ(275000000, first_node_budget);
+	EXPECT_EQ(225000000, second_node_budget);
+	EXPECT_EQ(max_overhead, first_node_budget + second_node_budget);
+}
@@ -2,6 +2,7 @@
 #include "execution_graph/logic_controllers/LogicalProject.h"
 #include "execution_graph/logic_controllers/CacheMachine.h"
 #include "io/DataLoader.h"
+#include "parser/physical_plan.hpp"
 #include <boost/property_tree/json_parser.hpp>
 #include <src/from_cudf/cpp_tests/utilities/base_fixture.hpp>
 #include <src/io/data_parser/CSVParser.h>
@@ -135,17 +136,20 @@ TEST_F(Batching, SortSamplePartitionTest) {
 
 	ral::io::data_loader loader(parser, provider);
 
-	TableScan customer_generator("", loader, schema, queryContext, nullptr);
+	auto scan_node = ral::parser::parse_plan_node("LogicalTableScan(table=[[main, customer]])");
+	TableScan customer_generator(*scan_node, loader, schema, queryContext, nullptr);
 
-	SortAndSampleSingleNodeKernel sort_and_sample("Logical_SortAndSample(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC])", queryContext, nullptr);
-	PartitionSingleNodeKernel partition("LogicalPartition(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC])", queryContext, nullptr);
-	MergeStreamKernel merge("LogicalMerge(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC])", queryContext, nullptr);
+	auto sort_and_sample_node = ral::parser::parse_plan_node("LogicalSingleNodeSortAndSample(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC])");
+	auto partition_node = ral::parser::parse_plan_node("LogicalSingleNodePartition(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC])");
+	auto merge_node = ral::parser::parse_plan_node("LogicalMerge(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC])");
+	SortAndSampleSingleNodeKernel sort_and_sample(*sort_and_sample_node, queryContext, nullptr);
+	PartitionSingleNodeKernel partition(*partition_node, queryContext, nullptr);
+	MergeStreamKernel merge(*merge_node, queryContext, nullptr);
 
-	// SortAndSampleSingleNodeKernel sort_and_sample("Logical_SortAndSample(sort0=[$0], dir0=[ASC])", queryContext);
-	// PartitionSingleNodeKernel partition("LogicalPartition(sort0=[$0], dir0=[ASC])", queryContext);
-	// MergeStreamKernel merge("LogicalMerge(sort0=[$0], dir0=[ASC])", queryContext);
-	Projection project("LogicalProject(c_custkey=[$0], c_nationkey=[$3])", queryContext, nullptr);
-	Filter filter("LogicalFilter(condition=[<($0, 100)])", queryContext, nullptr);
+	auto project_node = ral::parser::parse_plan_node("LogicalProject(c_custkey=[$0], c_nationkey=[$3])");
+	auto filter_node = ral::parser::parse_plan_node("LogicalFilter(condition=[<($0, 100)])");
+	Projection project(*project_node, queryContext, nullptr);
+	Filter filter(*filter_node, queryContext, nullptr);
 	Print print;
 	ral::cache::graph m;
 	try {
@@ -81,3 +81,32 @@ TEST_F(CacheMachineTest, CacheMachineTest) {
 	}
 	std::this_thread::sleep_for(std::chrono::seconds(1));
 }
+
+TEST_F(CacheMachineTest, CacheMachineProfileTest) {
+	ral::cache::CacheMachine cacheMachine(std::numeric_limits<std::uint32_t>::max(), std::numeric_limits<std::size_t>::max());
+
+	size_t bytes_added = 0;
+	for(int i = 0; i < 3; ++i) {
+		auto table = build_custom_one_column_table();
+		bytes_added += table->sizeInBytes();
+		cacheMachine.wait_if_cache_is_saturated();
+		cacheMachine.addToCache(std::move(table));
+	}
+	cacheMachine.finish();
+	while(cacheMachine.wait_for_next()) {
+		auto table = cacheMachine.pullFromCache();
+		EXPECT_EQ(table->num_rows(), 10);
+	}
+
+	ral::cache::cache_profile profile = cacheMachine.get_profile();
+	EXPECT_EQ(profile.batches_added, 3);
+	EXPECT_EQ(profile.rows_added, 30);
+	EXPECT_EQ(profile.bytes_added, bytes_added);
+	EXPECT_EQ(profile.batches_pulled, 3);
+	EXPECT_EQ(profile.rows_pulled, 30);
+	EXPECT_EQ(profile.bytes_pulled, bytes_added);
+	EXPECT_EQ(profile.batches_to_host, 0);
+	EXPECT_EQ(profile.batches_to_disk, 0);
+	EXPECT_GE(profile.saturated_wait_ns, 0);
+	EXPECT_GE(profile.next_wait_ns, 0);
+}
@@ -0,0 +1,95 @@
+#include "execution_graph/logic_controllers/BatchProcessing.h"
+#include <blazingdb/transport/FlowControl.h>
+#include <src/from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include "../BlazingUnitTest.h"
+
+#include <numeric>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+using ral::communication::messages::ColumnDataPartitionMessage;
+using ral::communication::messages::ReceivedHostMessage;
+using ral::communication::network::ReceivedMessage;
+
+struct ExternalSequenceFlowControlTest : public BlazingUnitTest {
+	void TearDown() override {
+		blazingdb::transport::setFlowControlCreditsPerSender(0);
+		BlazingUnitTest::TearDown();
+	}
+};
+
+static std::unique_ptr<ral::frame::BlazingHostTable> make_host_table(cudf::size_type num_rows) {
+	std::vector<int64_t> values(num_rows);
+	std::iota(values.begin(), values.end(), 0);
+	cudf::test::fixed_width_column_wrapper<int64_t> column(values.begin(), values.end());
+	std::vector<cudf::column_view> views{column};
+	return ral::communication::messages::serialize_gpu_message_to_host_table(
+		ral::frame::BlazingTableView(cudf::table_view{views}, std::vector<std::string>{"a"}));
+}
+
+// The sequence stops taking messages from the server while what it received was not pulled, so that the senders are
+// throttled by the credits of the messages that stay in the server
+TEST_F(ExternalSequenceFlowControlTest, ReceivingStopsWhileTheBatchesAreNotPulled) {
+	const int NUM_MESSAGES = 20;
+	const std::size_t table_bytes = make_host_table(100)->sizeInBytes();
+	blazingdb::transport::setFlowControlCreditsPerSender(table_bytes * 3);
+
+	std::vector<Node> nodes = {Node(Address::TCP("127.0.0.1", 8089, 0)), Node(Address::TCP("127.0.0.1", 8090, 0))};
+	auto context = std::make_shared<Context>(0, nodes, nodes[0], "", std::map<std::string, std::string>());
+	Node sender = nodes[1];
+
+	std::atomic<int> num_received{0};
+	ExternalBatchColumnDataSequence<ColumnDataPartitionMessage> sequence(context, "", [&]() {
+		std::shared_ptr<ReceivedMessage> message;
+		if(num_received < NUM_MESSAGES) {
+			message = std::make_shared<ReceivedHostMessage>("", 0, sender, make_host_table(100));
+		}
+		num_received++;
+		return message;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	EXPECT_EQ(num_received.load(), 3);
+	EXPECT_EQ(sequence.get_num_bytes_buffered(), table_bytes * 3);
+
+	int num_pulled = 0;
+	while(sequence.wait_for_next()) {
+		auto host_table = sequence.next();
+		EXPECT_EQ(host_table->num_rows(), 100);
+		EXPECT_LE(sequence.get_num_bytes_buffered(), table_bytes * 3);
+		num_pulled++;
+	}
+	EXPECT_EQ(num_pulled, NUM_MESSAGES);
+	EXPECT_EQ(num_received.load(), NUM_MESSAGES + 1);
+}
+
+// What the sequence hands over is added to the output cache of the kernel, which can hold it until all of its input is
+// there, so the batches over the credits of the senders go to disk instead of the host memory
+TEST_F(ExternalSequenceFlowControlTest, ReceivedBatchesOverTheCreditsAreWrittenToDisk) {
+	const int NUM_MESSAGES = 5;
+	const std::size_t table_bytes = make_host_table(100)->sizeInBytes();
+	blazingdb::transport::setFlowControlCreditsPerSender(table_bytes * 3);
+
+	std::vector<Node> nodes = {Node(Address::TCP("127.0.0.1", 8089, 0)), Node(Address::TCP("127.0.0.1", 8090, 0))};
+	Context context(0, nodes, nodes[0], "", std::map<std::string, std::string>());
+
+	ral::cache::CacheMachine cache;
+	for(int i = 0; i < NUM_MESSAGES; i++) {
+		cache.addHostFrameToCache(make_host_table(100), "", &context);
+	}
+	EXPECT_EQ(cache.get_profile().batches_to_disk, NUM_MESSAGES - 3);
+
+	// pulling a batch from host memory makes room for the next one
+	EXPECT_EQ(cache.pullFromCache(&context)->num_rows(), 100);
+	cache.addHostFrameToCache(make_host_table(100), "", &context);
+	EXPECT_EQ(cache.get_profile().batches_to_disk, NUM_MESSAGES - 3);
+
+	cache.finish();
+	int num_pulled = 1;
+	while(auto table = cache.pullFromCache(&context)) {
+		EXPECT_EQ(table->num_rows(), 100);
+		num_pulled++;
+	}
+	EXPECT_EQ(num_pulled, NUM_MESSAGES + 1);
+}
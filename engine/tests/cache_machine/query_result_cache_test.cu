@@ -0,0 +1,111 @@
+#include <from_cudf/cpp_tests/utilities/column_utilities.hpp>
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <from_cudf/cpp_tests/utilities/table_utilities.hpp>
+
+#include "execution_graph/logic_controllers/QueryResultCache.h"
+#include "../BlazingUnitTest.h"
+
+using ral::cache::query_result_cache;
+
+struct QueryResultCacheTest : public BlazingUnitTest {
+	QueryResultCacheTest() { query_result_cache::getInstance().clear(); }
+	~QueryResultCacheTest() {
+		query_result_cache::getInstance().clear();
+		query_result_cache::getInstance().set_budget(0, 0);
+	}
+};
+
+TEST_F(QueryResultCacheTest, HitAndMiss) {
+	query_result_cache & cache = query_result_cache::getInstance();
+	cache.set_budget(1 << 20, 0);
+	size_t hits = cache.num_hits();
+	size_t misses = cache.num_misses();
+
+	cudf::test::fixed_width_column_wrapper<int32_t> column{{1, 2, 3, 4}, {1, 0, 1, 1}};
+	CudfTableView table{{column}};
+	cache.put("query_a", ral::frame::BlazingTableView(table, {"a"}));
+
+	auto result = cache.get("query_a");
+	ASSERT_NE(result, nullptr);
+	cudf::test::expect_tables_equal(table, result->view());
+	EXPECT_EQ(result->names(), std::vector<std::string>{"a"});
+	EXPECT_EQ(cache.get("query_b"), nullptr);
+
+	EXPECT_EQ(cache.num_hits(), hits + 1);
+	EXPECT_EQ(cache.num_misses(), misses + 1);
+}
+
+// A key has the fingerprints of the files of the query, so a file that changed gives another key that misses, while
+// putting the same key again replaces its result
+TEST_F(QueryResultCacheTest, Invalidation) {
+	query_result_cache & cache = query_result_cache::getInstance();
+	cache.set_budget(1 << 20, 0);
+
+	cudf::test::fixed_width_column_wrapper<int32_t> old_column{{1, 2, 3}};
+	cudf::test::fixed_width_column_wrapper<int32_t> new_column{{4, 5}};
+	CudfTableView old_table{{old_column}};
+	CudfTableView new_table{{new_column}};
+	cache.put("query\nfile|12|100|", ral::frame::BlazingTableView(old_table, {"a"}));
+
+	EXPECT_EQ(cache.get("query\nfile|8|200|"), nullptr);
+
+	cache.put("query\nfile|12|100|", ral::frame::BlazingTableView(new_table, {"a"}));
+	auto result = cache.get("query\nfile|12|100|");
+	ASSERT_NE(result, nullptr);
+	cudf::test::expect_tables_equal(new_table, result->view());
+
+	cache.set_budget(0, 0);
+	EXPECT_FALSE(cache.enabled());
+	EXPECT_EQ(cache.get("query\nfile|12|100|"), nullptr);
+	EXPECT_EQ(cache.host_bytes(), 0);
+}
+
+TEST_F(QueryResultCacheTest, EvictionSpillsAndDrops) {
+	query_result_cache & cache = query_result_cache::getInstance();
+
+	cudf::test::fixed_width_column_wrapper<int64_t> column_a{{1, 2, 3, 4}};
+	cudf::test::fixed_width_column_wrapper<int64_t> column_b{{5, 6, 7, 8}};
+	CudfTableView table_a{{column_a}};
+	CudfTableView table_b{{column_b}};
+	size_t table_bytes = 4 * sizeof(int64_t);
+
+	// room for one result in host memory, the least recently used one is spilled
+	cache.set_budget(table_bytes, 1 << 20);
+	cache.put("query_a", ral::frame::BlazingTableView(table_a, {"a"}));
+	cache.put("query_b", ral::frame::BlazingTableView(table_b, {"b"}));
+	EXPECT_EQ(cache.host_bytes(), table_bytes);
+	EXPECT_EQ(cache.disk_bytes(), table_bytes);
+
+	auto spilled = cache.get("query_a");
+	ASSERT_NE(spilled, nullptr);
+	cudf::test::expect_tables_equal(table_a, spilled->view());
+	EXPECT_EQ(spilled->names(), std::vector<std::string>{"a"});
+	auto kept = cache.get("query_b");
+	ASSERT_NE(kept, nullptr);
+	cudf::test::expect_tables_equal(table_b, kept->view());
+
+	// without disk budget the spilled result is dropped
+	cache.set_budget(table_bytes, 0);
+	EXPECT_EQ(cache.disk_bytes(), 0);
+	EXPECT_EQ(cache.get("query_a"), nullptr);
+	EXPECT_NE(cache.get("query_b"), nullptr);
+
+	// a result that does not fit on disk is dropped without spilling it
+	cache.put("query_a", ral::frame::BlazingTableView(table_a, {"a"}));
+	EXPECT_EQ(cache.disk_bytes(), 0);
+	EXPECT_EQ(cache.get("query_b"), nullptr);
+	EXPECT_NE(cache.get("query_a"), nullptr);
+}
+
+TEST_F(QueryResultCacheTest, NondeterministicPlans) {
+	EXPECT_TRUE(query_result_cache::is_deterministic(
+		"LogicalProject(EXPR$0=[+($0, 1)])\n  LogicalTableScan(table=[[main, nation]])"));
+	EXPECT_TRUE(query_result_cache::is_deterministic(
+		"LogicalFilter(condition=[=($1, 'RAND')])\n  LogicalTableScan(table=[[main, nation]])"));
+	EXPECT_TRUE(query_result_cache::is_deterministic(
+		"LogicalProject(RANDOM_KEY=[$0])\n  LogicalTableScan(table=[[main, nation]])"));
+	EXPECT_FALSE(query_result_cache::is_deterministic(
+		"LogicalProject(EXPR$0=[RAND()])\n  LogicalTableScan(table=[[main, nation]])"));
+	EXPECT_FALSE(query_result_cache::is_deterministic(
+		"LogicalFilter(condition=[<($2, CURRENT_TIMESTAMP)])\n  LogicalTableScan(table=[[main, orders]])"));
+}
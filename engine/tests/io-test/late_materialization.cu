@@ -0,0 +1,197 @@
+#include "../BlazingUnitTest.h"
+
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "execution_graph/logic_controllers/BatchProcessing.h"
+#include "io/data_parser/ParquetParser.h"
+#include "io/data_provider/UriDataProvider.h"
+#include "utilities/CommonOperations.h"
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <from_cudf/cpp_tests/utilities/table_utilities.hpp>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+namespace {
+
+const int64_t ROWS_PER_ROW_GROUP = 1000;
+const int64_t NUM_ROW_GROUPS = 4;
+
+// Column key has the values of the rows, and a and b are multiples of them
+std::string write_late_materialization_file(const std::string & path) {
+	std::vector<std::shared_ptr<arrow::Field>> fields;
+	std::vector<std::shared_ptr<arrow::Array>> arrays;
+	for(auto name_and_factor : std::vector<std::pair<std::string, int64_t>>{{"key", 1}, {"a", 3}, {"b", 7}}) {
+		arrow::Int64Builder builder;
+		for(int64_t row = 0; row < ROWS_PER_ROW_GROUP * NUM_ROW_GROUPS; row++) {
+			EXPECT_TRUE(builder.Append(row * name_and_factor.second).ok());
+		}
+		std::shared_ptr<arrow::Array> array;
+		EXPECT_TRUE(builder.Finish(&array).ok());
+		fields.push_back(arrow::field(name_and_factor.first, arrow::int64(), false));
+		arrays.push_back(array);
+	}
+	std::shared_ptr<arrow::Table> table = arrow::Table::Make(arrow::schema(fields), arrays);
+
+	std::shared_ptr<arrow::io::FileOutputStream> sink;
+	EXPECT_TRUE(arrow::io::FileOutputStream::Open(path, &sink).ok());
+	EXPECT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), sink, ROWS_PER_ROW_GROUP).ok());
+	EXPECT_TRUE(sink->Close().ok());
+	return path;
+}
+
+ral::io::scan_unit row_group_unit(std::vector<cudf::size_type> row_groups) {
+	ral::io::scan_unit unit;
+	unit.row_groups = row_groups;
+	return unit;
+}
+
+ral::io::scan_unit row_range_unit(int64_t skip_rows, int64_t num_rows) {
+	ral::io::scan_unit unit;
+	unit.skip_rows = skip_rows;
+	unit.num_rows = num_rows;
+	return unit;
+}
+
+}  // namespace
+
+struct LateMaterializationTest : public BlazingUnitTest {
+	void SetUp() {
+		BlazingUnitTest::SetUp();
+		path = write_late_materialization_file("/tmp/.blazing-late-materialization-test.parquet");
+		ASSERT_TRUE(arrow::io::ReadableFile::Open(path, &file).ok());
+		contextNodes = {Node(Address::TCP("127.0.0.1", 8089, 0))};
+	}
+
+	void TearDown() {
+		file->Close();
+		std::remove(path.c_str());
+		BlazingUnitTest::TearDown();
+	}
+
+	// Scans the columns a, key and b of the file, so that the column of the condition is between the other ones, and
+	// filters the batches with the condition
+	std::unique_ptr<ral::frame::BlazingTable> scan(const std::string & condition,
+		bool late_materialization,
+		std::vector<int> row_groups,
+		std::pair<size_t, size_t> & stats) {
+		std::map<std::string, std::string> config_options = {
+			{"ENABLE_LATE_MATERIALIZATION", late_materialization ? "true" : "false"},
+			{"SCAN_UNIT_TARGET_BYTES", "1000000000"}};
+
+		auto parser = std::make_shared<ral::io::parquet_parser>();
+		auto provider = std::make_shared<ral::io::uri_data_provider>(std::vector<Uri>{Uri{path}});
+		ral::io::data_loader loader(parser, provider);
+		ral::io::Schema file_schema;
+		loader.get_schema(file_schema, {});
+		ral::io::Schema schema(file_schema.get_names(), file_schema.get_calcite_to_file_indices(), file_schema.get_dtypes(),
+			file_schema.get_in_file(), {row_groups});
+		for(auto & file_name : file_schema.get_files()) {
+			schema.add_file(file_name);
+		}
+
+		Context context(0, contextNodes, contextNodes[0], "", config_options);
+		ral::batch::DataSourceSequence input(loader, schema, context.clone());
+		input.set_projections({1, 0, 2});
+		input.set_late_materialization_filter(condition);
+		ral::processor::expression_program filter_program({condition});
+
+		std::vector<std::unique_ptr<ral::frame::BlazingTable>> filtered;
+		std::vector<ral::frame::BlazingTableView> filtered_views;
+		while(auto batch = input.next()) {
+			filtered.push_back(ral::processor::process_filter(batch->toBlazingTableView(), filter_program));
+			filtered_views.push_back(filtered.back()->toBlazingTableView());
+		}
+		stats = input.get_late_materialization_stats();
+		return ral::utilities::concatTables(filtered_views);
+	}
+
+	void expect_same_rows_as_full_read(
+		const std::string & condition, std::vector<int> row_groups, cudf::size_type num_rows, size_t rows_skipped) {
+		std::pair<size_t, size_t> full_stats;
+		auto full = scan(condition, false, row_groups, full_stats);
+		EXPECT_EQ(full_stats.first, 0);
+		EXPECT_EQ(full->num_rows(), num_rows);
+
+		std::pair<size_t, size_t> narrowed_stats;
+		auto narrowed = scan(condition, true, row_groups, narrowed_stats);
+		size_t num_row_groups = row_groups.empty() ? NUM_ROW_GROUPS : row_groups.size();
+		EXPECT_EQ(narrowed_stats.first, num_row_groups * ROWS_PER_ROW_GROUP);
+		EXPECT_EQ(narrowed_stats.second, rows_skipped);
+
+		EXPECT_EQ(narrowed->names(), full->names());
+		cudf::test::expect_tables_equal(full->view(), narrowed->view());
+	}
+
+	std::string path;
+	std::shared_ptr<arrow::io::ReadableFile> file;
+	ral::io::parquet_parser parser;
+	std::vector<Node> contextNodes;
+};
+
+TEST_F(LateMaterializationTest, NarrowsRowRanges) {
+	ral::io::scan_unit narrowed;
+	int64_t first_row = -1;
+	ASSERT_TRUE(parser.narrow_scan_unit(file, row_range_unit(100, 2000), 10, 20, narrowed, first_row));
+
+	EXPECT_EQ(narrowed.skip_rows, 110);
+	EXPECT_EQ(narrowed.num_rows, 10);
+	EXPECT_TRUE(narrowed.row_groups.empty());
+	EXPECT_EQ(first_row, 10);
+}
+
+TEST_F(LateMaterializationTest, NarrowsConsecutiveRowGroupsToRowRanges) {
+	ral::io::scan_unit narrowed;
+	int64_t first_row = -1;
+	ASSERT_TRUE(parser.narrow_scan_unit(file, row_group_unit({1, 2}), 500, 1500, narrowed, first_row));
+
+	EXPECT_EQ(narrowed.skip_rows, 1500);
+	EXPECT_EQ(narrowed.num_rows, 1000);
+	EXPECT_TRUE(narrowed.row_groups.empty());
+	EXPECT_EQ(first_row, 500);
+
+	// the rows of row group 2 start at 1000 in the unit and at 2000 in the file
+	ASSERT_TRUE(parser.narrow_scan_unit(file, row_group_unit({0, 2, 3}), 1500, 2500, narrowed, first_row));
+	EXPECT_EQ(narrowed.skip_rows, 2500);
+	EXPECT_EQ(narrowed.num_rows, 1000);
+	EXPECT_EQ(first_row, 500);
+}
+
+TEST_F(LateMaterializationTest, NarrowsRowGroupsThatAreNotConsecutive) {
+	ral::io::scan_unit narrowed;
+	int64_t first_row = -1;
+	ASSERT_TRUE(parser.narrow_scan_unit(file, row_group_unit({0, 2, 3}), 900, 1100, narrowed, first_row));
+
+	EXPECT_EQ(narrowed.row_groups, (std::vector<cudf::size_type>{0, 2}));
+	EXPECT_EQ(narrowed.num_rows, -1);
+	EXPECT_EQ(first_row, 0);
+}
+
+TEST_F(LateMaterializationTest, DoesNotNarrowOutsideOfTheUnit) {
+	ral::io::scan_unit narrowed;
+	int64_t first_row = -1;
+	EXPECT_FALSE(parser.narrow_scan_unit(file, row_group_unit({0, 1}), 2000, 2100, narrowed, first_row));
+	EXPECT_FALSE(parser.narrow_scan_unit(file, row_group_unit({0, 1}), 100, 100, narrowed, first_row));
+	EXPECT_FALSE(parser.narrow_scan_unit(nullptr, row_range_unit(0, 100), 10, 20, narrowed, first_row));
+}
+
+TEST_F(LateMaterializationTest, ReadsTheRowRangeOfTheCondition) {
+	expect_same_rows_as_full_read("AND(>=($1, 1500), <($1, 2600))", {}, 1100, 4000 - 1100);
+}
+
+TEST_F(LateMaterializationTest, ReadsTheRowGroupsOfTheCondition) {
+	// the rows from 900 to 1100 of the unit are in row groups 0 and 2, so row group 3 is not read
+	expect_same_rows_as_full_read("AND(>=($1, 900), <($1, 2100))", {0, 2, 3}, 200, 1000);
+}
+
+TEST_F(LateMaterializationTest, ReadsNothingElseWithoutRowsOfTheCondition) {
+	expect_same_rows_as_full_read("<($1, 0)", {}, 0, 4000);
+}
@@ -0,0 +1,294 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "io/data_parser/ParquetParser.h"
+#include <arrow/io/file.h>
+
+namespace {
+
+const uint8_t THRIFT_BOOLEAN_TRUE = 1;
+const uint8_t THRIFT_I32 = 5;
+const uint8_t THRIFT_I64 = 6;
+const uint8_t THRIFT_BINARY = 8;
+const uint8_t THRIFT_LIST = 9;
+const uint8_t THRIFT_STRUCT = 12;
+
+const int64_t ROWS_PER_PAGE = 25;
+
+// Writes the thrift compact protocol, since the parquet writer of arrow does not write page indexes
+class thrift_compact_writer {
+public:
+	void begin_struct() { last_ids.push_back(0); }
+
+	void end_struct() {
+		bytes.push_back(0);
+		last_ids.pop_back();
+	}
+
+	void field(int16_t id, uint8_t type) {
+		bytes.push_back(static_cast<char>(((id - last_ids.back()) << 4) | type));
+		last_ids.back() = id;
+	}
+
+	void integer_field(int16_t id, uint8_t type, int64_t value) {
+		field(id, type);
+		integer(value);
+	}
+
+	void binary_field(int16_t id, const std::string & value) {
+		field(id, THRIFT_BINARY);
+		binary(value);
+	}
+
+	void list(uint8_t element_type, size_t num_elements) {
+		if(num_elements < 15) {
+			bytes.push_back(static_cast<char>((num_elements << 4) | element_type));
+		} else {
+			bytes.push_back(static_cast<char>(0xf0 | element_type));
+			varint(num_elements);
+		}
+	}
+
+	void integer(int64_t value) { varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); }
+
+	void binary(const std::string & value) {
+		varint(value.size());
+		bytes += value;
+	}
+
+	void list_bool(bool value) { bytes.push_back(value ? 1 : 2); }
+
+	std::string bytes;
+
+private:
+	void varint(uint64_t value) {
+		while(value >= 0x80) {
+			bytes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+			value >>= 7;
+		}
+		bytes.push_back(static_cast<char>(value));
+	}
+
+	std::vector<int16_t> last_ids;
+};
+
+std::string plain_int64(int64_t value) { return std::string(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+// The min and max of the pages of a column chunk, every page has ROWS_PER_PAGE rows
+using chunk_pages = std::vector<std::pair<int64_t, int64_t>>;
+
+// A parquet file with INT64 columns whose chunks, by column and row group, have these pages. It does not have the data of
+// the pages, only the footer and the page index, which is all that skip_pages_out_of_range reads
+std::string write_page_index_file(
+	const std::string & path, const std::vector<std::string> & names, const std::vector<std::vector<chunk_pages>> & chunks) {
+	size_t num_row_groups = chunks[0].size();
+	std::string file = "PAR1";
+
+	// the ColumnIndex and OffsetIndex of every chunk, and where they are
+	std::vector<std::vector<std::vector<int64_t>>> locations(num_row_groups, std::vector<std::vector<int64_t>>(names.size()));
+	for(size_t row_group = 0; row_group < num_row_groups; row_group++) {
+		for(size_t column = 0; column < names.size(); column++) {
+			const chunk_pages & pages = chunks[column][row_group];
+			thrift_compact_writer column_index;
+			column_index.begin_struct();
+			column_index.field(1, THRIFT_LIST);
+			column_index.list(THRIFT_BOOLEAN_TRUE, pages.size());
+			for(size_t page = 0; page < pages.size(); page++) {
+				column_index.list_bool(false);
+			}
+			column_index.field(2, THRIFT_LIST);
+			column_index.list(THRIFT_BINARY, pages.size());
+			for(auto & page : pages) {
+				column_index.binary(plain_int64(page.first));
+			}
+			column_index.field(3, THRIFT_LIST);
+			column_index.list(THRIFT_BINARY, pages.size());
+			for(auto & page : pages) {
+				column_index.binary(plain_int64(page.second));
+			}
+			column_index.integer_field(4, THRIFT_I32, 0);  // BoundaryOrder UNORDERED
+			column_index.end_struct();
+
+			thrift_compact_writer offset_index;
+			offset_index.begin_struct();
+			offset_index.field(1, THRIFT_LIST);
+			offset_index.list(THRIFT_STRUCT, pages.size());
+			for(size_t page = 0; page < pages.size(); page++) {
+				offset_index.begin_struct();
+				offset_index.integer_field(1, THRIFT_I64, 4 + page * 100);
+				offset_index.integer_field(2, THRIFT_I32, 100);
+				offset_index.integer_field(3, THRIFT_I64, page * ROWS_PER_PAGE);
+				offset_index.end_struct();
+			}
+			offset_index.end_struct();
+
+			locations[row_group][column] = {static_cast<int64_t>(file.size()), static_cast<int64_t>(offset_index.bytes.size()),
+				static_cast<int64_t>(file.size() + offset_index.bytes.size()), static_cast<int64_t>(column_index.bytes.size())};
+			file += offset_index.bytes + column_index.bytes;
+		}
+	}
+
+	thrift_compact_writer footer;
+	footer.begin_struct();
+	footer.integer_field(1, THRIFT_I32, 1);
+	footer.field(2, THRIFT_LIST);
+	footer.list(THRIFT_STRUCT, names.size() + 1);
+	footer.begin_struct();
+	footer.binary_field(4, "schema");
+	footer.integer_field(5, THRIFT_I32, names.size());
+	footer.end_struct();
+	for(auto & name : names) {
+		footer.begin_struct();
+		footer.integer_field(1, THRIFT_I32, 2);  // INT64
+		footer.integer_field(3, THRIFT_I32, 0);  // REQUIRED
+		footer.binary_field(4, name);
+		footer.end_struct();
+	}
+	int64_t num_rows = 0;
+	std::vector<int64_t> row_group_rows;
+	for(size_t row_group = 0; row_group < num_row_groups; row_group++) {
+		row_group_rows.push_back(chunks[0][row_group].size() * ROWS_PER_PAGE);
+		num_rows += row_group_rows.back();
+	}
+	footer.integer_field(3, THRIFT_I64, num_rows);
+	footer.field(4, THRIFT_LIST);
+	footer.list(THRIFT_STRUCT, num_row_groups);
+	for(size_t row_group = 0; row_group < num_row_groups; row_group++) {
+		footer.begin_struct();
+		footer.field(1, THRIFT_LIST);
+		footer.list(THRIFT_STRUCT, names.size());
+		for(size_t column = 0; column < names.size(); column++) {
+			footer.begin_struct();
+			footer.integer_field(2, THRIFT_I64, 4);
+			footer.field(3, THRIFT_STRUCT);
+			footer.begin_struct();
+			footer.integer_field(1, THRIFT_I32, 2);  // INT64
+			footer.field(2, THRIFT_LIST);
+			footer.list(THRIFT_I32, 1);
+			footer.integer(0);  // PLAIN
+			footer.field(3, THRIFT_LIST);
+			footer.list(THRIFT_BINARY, 1);
+			footer.binary(names[column]);
+			footer.integer_field(4, THRIFT_I32, 0);  // UNCOMPRESSED
+			footer.integer_field(5, THRIFT_I64, row_group_rows[row_group]);
+			footer.integer_field(6, THRIFT_I64, 400);
+			footer.integer_field(7, THRIFT_I64, 400);
+			footer.integer_field(9, THRIFT_I64, 4);
+			footer.end_struct();
+			footer.integer_field(4, THRIFT_I64, locations[row_group][column][0]);
+			footer.integer_field(5, THRIFT_I32, locations[row_group][column][1]);
+			footer.integer_field(6, THRIFT_I64, locations[row_group][column][2]);
+			footer.integer_field(7, THRIFT_I32, locations[row_group][column][3]);
+			footer.end_struct();
+		}
+		footer.integer_field(2, THRIFT_I64, 400 * names.size());
+		footer.integer_field(3, THRIFT_I64, row_group_rows[row_group]);
+		footer.end_struct();
+	}
+	footer.end_struct();
+
+	uint32_t footer_size = footer.bytes.size();
+	file += footer.bytes + std::string(reinterpret_cast<const char *>(&footer_size), sizeof(footer_size)) + "PAR1";
+	std::ofstream(path, std::ios::binary) << file;
+	return path;
+}
+
+ral::io::column_value_range integer_range(int64_t min, int64_t max) {
+	ral::io::column_value_range range;
+	range.is_valid = true;
+	range.is_integer = true;
+	range.integer_min = min;
+	range.integer_max = max;
+	return range;
+}
+
+ral::io::scan_unit row_group_unit(std::vector<cudf::size_type> row_groups) {
+	ral::io::scan_unit unit;
+	unit.row_groups = row_groups;
+	return unit;
+}
+
+ral::io::scan_unit row_range_unit(int64_t skip_rows, int64_t num_rows) {
+	ral::io::scan_unit unit;
+	unit.skip_rows = skip_rows;
+	unit.num_rows = num_rows;
+	return unit;
+}
+
+}  // namespace
+
+// Two row groups of 100 rows with pages of 25 rows. Column a has the values of the rows, so its pages go from 0 to 24,
+// 25 to 49 and so on, and column b goes from 0 to 39 in the first row group and from 100 to 139 in the second one
+struct ParquetPageIndexTest : public ::testing::Test {
+	void SetUp() {
+		path = write_page_index_file("/tmp/.blazing-page-index-test.parquet", {"a", "b"},
+			{{{{0, 24}, {25, 49}, {50, 74}, {75, 99}}, {{100, 124}, {125, 149}, {150, 174}, {175, 199}}},
+				{{{0, 9}, {10, 19}, {20, 29}, {30, 39}}, {{100, 109}, {110, 119}, {120, 129}, {130, 139}}}});
+		ASSERT_TRUE(arrow::io::ReadableFile::Open(path, &file).ok());
+	}
+
+	void TearDown() {
+		file->Close();
+		std::remove(path.c_str());
+	}
+
+	std::string path;
+	std::shared_ptr<arrow::io::ReadableFile> file;
+	ral::io::parquet_parser parser;
+};
+
+TEST_F(ParquetPageIndexTest, NarrowsRowGroupsToRowRanges) {
+	std::vector<ral::io::scan_unit> units = {ral::io::scan_unit()};
+	EXPECT_EQ(parser.skip_pages_out_of_range(file, {"a"}, {integer_range(30, 60)}, units), 150);
+
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].skip_rows, 25);
+	EXPECT_EQ(units[0].num_rows, 50);
+}
+
+TEST_F(ParquetPageIndexTest, NarrowsRowRanges) {
+	std::vector<ral::io::scan_unit> units = {row_range_unit(50, 100)};
+	EXPECT_EQ(parser.skip_pages_out_of_range(file, {"a"}, {integer_range(30, 60)}, units), 75);
+
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].skip_rows, 50);
+	EXPECT_EQ(units[0].num_rows, 25);
+}
+
+TEST_F(ParquetPageIndexTest, KeepsWholeRowGroups) {
+	std::vector<ral::io::scan_unit> units = {row_group_unit({0}), row_group_unit({1})};
+	EXPECT_EQ(parser.skip_pages_out_of_range(file, {"a"}, {integer_range(100, 199)}, units), 100);
+
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].row_groups, std::vector<cudf::size_type>{1});
+	EXPECT_EQ(units[0].num_rows, -1);
+}
+
+TEST_F(ParquetPageIndexTest, IntersectsTheRowsOfEveryColumn) {
+	std::vector<ral::io::scan_unit> units = {ral::io::scan_unit()};
+	EXPECT_EQ(parser.skip_pages_out_of_range(file, {"a", "b"}, {integer_range(30, 60), integer_range(0, 15)}, units), 175);
+
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].skip_rows, 25);
+	EXPECT_EQ(units[0].num_rows, 25);
+}
+
+TEST_F(ParquetPageIndexTest, IgnoresUnknownColumnsAndInvalidRanges) {
+	std::vector<ral::io::scan_unit> units = {ral::io::scan_unit()};
+	EXPECT_EQ(parser.skip_pages_out_of_range(file, {"c", "b", "a"},
+		{integer_range(0, 0), ral::io::column_value_range(), integer_range(30, 60)}, units), 150);
+
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].skip_rows, 25);
+	EXPECT_EQ(units[0].num_rows, 50);
+}
+
+TEST_F(ParquetPageIndexTest, RemovesUnitsWithoutRows) {
+	std::vector<ral::io::scan_unit> units = {row_group_unit({0}), row_group_unit({1})};
+	EXPECT_EQ(parser.skip_pages_out_of_range(file, {"a"}, {integer_range(1000, 2000)}, units), 200);
+	EXPECT_TRUE(units.empty());
+}
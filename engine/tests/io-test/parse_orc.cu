@@ -104,3 +104,48 @@ TYPED_TEST(OrcTest, multipleColumns)
     // TODO: c.cordova, values are equals but something weird happen with the expect_tables_equal
     //cudf::test::expect_tables_equal(expect_cudf_table_view, orc_table->view());
 }
+
+TYPED_TEST(OrcTest, stripeMetadata)
+{
+    std::string filepath = GetCurrentWorkingDir() + "/tests/io-test/region_0_0.orc";
+
+    cudf::experimental::io::read_orc_args orc_args{cudf::experimental::io::source_info{filepath}};
+
+    std::vector<Uri> uris;
+    uris.push_back(Uri{filepath});
+    auto parser = std::make_shared<ral::io::orc_parser>(orc_args);
+    auto provider = std::make_shared<ral::io::uri_data_provider>(uris);
+    ral::io::data_loader loader(parser, provider);
+
+    int offset = 3;
+    std::unique_ptr<BlazingTable> metadata = loader.get_metadata(offset);
+
+    // the file has a single stripe
+    std::vector<std::string> expect_names{"min_0_r_regionkey", "max_0_r_regionkey", "null_count_0_r_regionkey",
+        "min_1_r_name", "max_1_r_name", "null_count_1_r_name",
+        "min_2_r_comment", "max_2_r_comment", "null_count_2_r_comment",
+        "num_rows", "file_handle_index", "row_group_index"};
+    EXPECT_EQ(metadata->names(), expect_names);
+    EXPECT_EQ(metadata->num_rows(), 1);
+
+    std::string min_key = cudf::test::to_string(metadata->view().column(0), "|");
+    std::string max_key = cudf::test::to_string(metadata->view().column(1), "|");
+    EXPECT_EQ(min_key, "0");
+    EXPECT_EQ(max_key, "4");
+
+    cudf::test::strings_column_wrapper expect_min_name{"AFRICA"};
+    cudf::test::strings_column_wrapper expect_max_name{"MIDDLE EAST"};
+    cudf::test::expect_columns_equal(metadata->view().column(3), expect_min_name);
+    cudf::test::expect_columns_equal(metadata->view().column(4), expect_max_name);
+
+    cudf::test::fixed_width_column_wrapper<int64_t> expect_null_count{{0}};
+    cudf::test::fixed_width_column_wrapper<int64_t> expect_num_rows{{5}};
+    cudf::test::expect_columns_equal(metadata->view().column(2), expect_null_count);
+    cudf::test::expect_columns_equal(metadata->view().column(5), expect_null_count);
+    cudf::test::expect_columns_equal(metadata->view().column(9), expect_num_rows);
+
+    cudf::test::fixed_width_column_wrapper<int32_t> expect_file_handle_index{{offset}};
+    cudf::test::fixed_width_column_wrapper<int32_t> expect_row_group_index{{0}};
+    cudf::test::expect_columns_equal(metadata->view().column(10), expect_file_handle_index);
+    cudf::test::expect_columns_equal(metadata->view().column(11), expect_row_group_index);
+}
@@ -0,0 +1,306 @@
+#include <from_cudf/cpp_tests/utilities/column_utilities.hpp>
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+#include <from_cudf/cpp_tests/utilities/table_utilities.hpp>
+
+#include "execution_graph/logic_controllers/BatchOrderByProcessing.h"
+#include "operators/OrderBy.h"
+#include "parser/physical_plan.hpp"
+#include "utilities/CommonOperations.h"
+#include "../BlazingUnitTest.h"
+
+#include <numeric>
+#include <random>
+#include <set>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+namespace {
+
+// A table with a key, which can be null, and an id that is unique across all the tables of a test
+std::unique_ptr<ral::frame::BlazingTable> make_table(
+	const std::vector<int32_t> & keys, const std::vector<bool> & key_valids, const std::vector<int32_t> & ids) {
+	cudf::test::fixed_width_column_wrapper<int32_t> key_column(keys.begin(), keys.end(), key_valids.begin());
+	cudf::test::fixed_width_column_wrapper<int32_t> id_column(ids.begin(), ids.end());
+	CudfTableView view{{key_column, id_column}};
+	return ral::frame::BlazingTableView(view, {"key", "id"}).clone();
+}
+
+std::unique_ptr<ral::frame::BlazingTable> make_table(const std::vector<int32_t> & keys, int32_t first_id) {
+	std::vector<int32_t> ids(keys.size());
+	std::iota(ids.begin(), ids.end(), first_id);
+	return make_table(keys, std::vector<bool>(keys.size(), true), ids);
+}
+
+std::vector<int32_t> host_keys(const ral::frame::BlazingTableView & table) {
+	auto keys = cudf::test::to_host<int32_t>(table.view().column(0)).first;
+	return std::vector<int32_t>(keys.begin(), keys.end());
+}
+
+std::multiset<int32_t> host_ids(const ral::frame::BlazingTableView & table) {
+	auto ids = cudf::test::to_host<int32_t>(table.view().column(1)).first;
+	return std::multiset<int32_t>(ids.begin(), ids.end());
+}
+
+// A sorted run of random keys out of a few values, so that the runs share keys
+std::unique_ptr<ral::frame::BlazingTable> random_run(
+	int num_rows, int num_keys, double null_ratio, int32_t first_id, const ral::operators::sort_spec & sort, unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int32_t> key_distribution(0, num_keys - 1);
+	std::bernoulli_distribution null_distribution(null_ratio);
+	std::vector<int32_t> keys, ids;
+	std::vector<bool> key_valids;
+	for(int i = 0; i < num_rows; i++) {
+		keys.push_back(key_distribution(generator));
+		key_valids.push_back(!null_distribution(generator));
+		ids.push_back(first_id + i);
+	}
+	auto table = make_table(keys, key_valids, ids);
+	return ral::operators::sort(table->toBlazingTableView(), sort);
+}
+
+}  // namespace
+
+struct MergeSettledRowsTest : public BlazingUnitTest {};
+
+TEST_F(MergeSettledRowsTest, SettlesUpToTheSmallestLastKeyOfTheRunsWithMoreRows) {
+	ral::operators::sort_spec sort{{0}, {cudf::order::ASCENDING}};
+	auto a = make_table({1, 3, 5, 7}, 0);
+	auto b = make_table({2, 4, 6, 8, 10}, 100);
+	auto c = make_table({5, 5, 9}, 200);
+
+	// b has no more rows, so its last key does not bound anything, and the bound is 7
+	std::unique_ptr<ral::frame::BlazingTable> settled;
+	std::vector<cudf::size_type> num_settled;
+	std::tie(settled, num_settled) = ral::operators::merge_settled_rows(
+		{a->toBlazingTableView(), b->toBlazingTableView(), c->toBlazingTableView()}, {true, false, true}, sort);
+
+	EXPECT_EQ(num_settled, (std::vector<cudf::size_type>{4, 3, 2}));
+	EXPECT_EQ(host_keys(settled->toBlazingTableView()), (std::vector<int32_t>{1, 2, 3, 4, 5, 5, 5, 6, 7}));
+	EXPECT_EQ(host_ids(settled->toBlazingTableView()), (std::multiset<int32_t>{0, 1, 2, 3, 100, 101, 102, 200, 201}));
+}
+
+TEST_F(MergeSettledRowsTest, SettlesEverythingWhenNoRunHasMoreRows) {
+	ral::operators::sort_spec sort{{0}, {cudf::order::ASCENDING}};
+	auto a = make_table({1, 8, 9}, 0);
+	auto b = make_table({2, 2, 2}, 100);
+
+	std::unique_ptr<ral::frame::BlazingTable> settled;
+	std::vector<cudf::size_type> num_settled;
+	std::tie(settled, num_settled) =
+		ral::operators::merge_settled_rows({a->toBlazingTableView(), b->toBlazingTableView()}, {false, false}, sort);
+
+	EXPECT_EQ(num_settled, (std::vector<cudf::size_type>{3, 3}));
+	EXPECT_EQ(host_keys(settled->toBlazingTableView()), (std::vector<int32_t>{1, 2, 2, 2, 8, 9}));
+}
+
+TEST_F(MergeSettledRowsTest, SettlesInTheOrderOfDescendingKeys) {
+	ral::operators::sort_spec sort{{0}, {cudf::order::DESCENDING}};
+	auto a = make_table({9, 7, 5}, 0);
+	auto b = make_table({8, 8, 1}, 100);
+
+	// the last keys are 5 and 1, and 5 goes first
+	std::unique_ptr<ral::frame::BlazingTable> settled;
+	std::vector<cudf::size_type> num_settled;
+	std::tie(settled, num_settled) =
+		ral::operators::merge_settled_rows({a->toBlazingTableView(), b->toBlazingTableView()}, {true, true}, sort);
+
+	EXPECT_EQ(num_settled, (std::vector<cudf::size_type>{3, 2}));
+	EXPECT_EQ(host_keys(settled->toBlazingTableView()), (std::vector<int32_t>{9, 8, 8, 7, 5}));
+}
+
+TEST_F(MergeSettledRowsTest, NullsAreNotSettledBeforeTheValues) {
+	ral::operators::sort_spec sort{{0}, {cudf::order::ASCENDING}};
+	auto a = make_table({1, 2, 0}, {true, true, false}, {0, 1, 2});
+	auto b = make_table({3, 4}, {true, true}, {100, 101});
+
+	// the last key of a is null, which goes after every value, so the bound is 4 and the null waits
+	std::unique_ptr<ral::frame::BlazingTable> settled;
+	std::vector<cudf::size_type> num_settled;
+	std::tie(settled, num_settled) =
+		ral::operators::merge_settled_rows({a->toBlazingTableView(), b->toBlazingTableView()}, {true, true}, sort);
+
+	EXPECT_EQ(num_settled, (std::vector<cudf::size_type>{2, 2}));
+	EXPECT_EQ(settled->view().column(0).null_count(), 0);
+	EXPECT_EQ(host_keys(settled->toBlazingTableView()), (std::vector<int32_t>{1, 2, 3, 4}));
+}
+
+struct MergeStreamTest : public BlazingUnitTest {
+	MergeStreamTest() { nodes.push_back(Node(Address::TCP("127.0.0.1", 8089, 0))); }
+
+	// Runs a MergeStreamKernel over the partitions, every one with its sorted runs, and returns its output batches
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> run_merge_stream(const std::string & plan,
+		std::vector<std::vector<std::unique_ptr<ral::frame::BlazingTable>>> partitions,
+		std::size_t batch_bytes) {
+		std::map<std::string, std::string> config_options = {{"MERGE_STREAM_BATCH_BYTES", std::to_string(batch_bytes)}};
+		auto context = std::make_shared<Context>(0, nodes, nodes[0], "", config_options);
+		auto node = ral::parser::parse_plan_node(plan);
+		ral::batch::MergeStreamKernel merge_stream_kernel(*node, context, nullptr);
+		merge_stream_kernel.set_type_id(ral::cache::kernel_type::MergeStreamKernel);
+
+		for(size_t i = 0; i < partitions.size(); i++) {
+			auto input = ral::cache::create_cache_machine(ral::cache::cache_settings{.type = ral::cache::CacheType::SIMPLE});
+			for(auto & run : partitions[i]) {
+				input->addToCache(std::move(run), "", context.get());
+			}
+			input->finish();
+			merge_stream_kernel.input_.register_cache("input_" + std::to_string(i), input);
+		}
+		auto output = ral::cache::create_cache_machine(ral::cache::cache_settings{.type = ral::cache::CacheType::SIMPLE});
+		merge_stream_kernel.output_.register_cache(std::to_string(merge_stream_kernel.get_id()), output);
+
+		EXPECT_EQ(merge_stream_kernel.run(), ral::cache::kstatus::proceed);
+		output->finish();
+
+		std::vector<std::unique_ptr<ral::frame::BlazingTable>> batches;
+		while(output->wait_for_next()) {
+			batches.push_back(output->pullFromCache(context.get()));
+		}
+		return batches;
+	}
+
+	// The batches together have to be the full sort of the runs. Ties can be merged in any order, so the keys are
+	// compared in order and the ids as a set, and an id that comes out twice is a row that was merged twice
+	void expect_full_sort(const std::vector<std::unique_ptr<ral::frame::BlazingTable>> & batches,
+		const std::vector<ral::frame::BlazingTableView> & runs,
+		const ral::operators::sort_spec & sort) {
+		std::vector<ral::frame::BlazingTableView> batch_views;
+		for(auto & batch : batches) {
+			batch_views.push_back(batch->toBlazingTableView());
+		}
+		auto merged = ral::utilities::concatTables(batch_views);
+		auto all_rows = ral::utilities::concatTables(runs);
+		auto sorted = ral::operators::sort(all_rows->toBlazingTableView(), sort);
+
+		ASSERT_EQ(sorted->num_rows(), merged->num_rows());
+		cudf::test::expect_tables_equal(sorted->view().select(sort.columns), merged->view().select(sort.columns));
+		std::multiset<int32_t> ids = host_ids(merged->toBlazingTableView());
+		EXPECT_EQ(host_ids(sorted->toBlazingTableView()), ids);
+		EXPECT_EQ(std::set<int32_t>(ids.begin(), ids.end()).size(), ids.size());
+	}
+
+	std::vector<Node> nodes;
+};
+
+TEST_F(MergeStreamTest, MergesSeveralRunsLikeAFullSort) {
+	std::string plan = "LogicalMerge(sort0=[$0], dir0=[ASC])";
+	auto sort = ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan));
+
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> runs;
+	for(int i = 0; i < 5; i++) {
+		runs.push_back(random_run(300, 1000, 0.0, i * 1000, sort, i));
+	}
+	std::vector<ral::frame::BlazingTableView> run_views;
+	for(auto & run : runs) {
+		run_views.push_back(run->toBlazingTableView());
+	}
+	auto expected_runs = ral::utilities::concatTables(run_views);
+
+	std::vector<std::vector<std::unique_ptr<ral::frame::BlazingTable>>> partitions(1);
+	partitions[0] = std::move(runs);
+	auto batches = run_merge_stream(plan, std::move(partitions), 1000);
+
+	EXPECT_GT(batches.size(), 1);
+	expect_full_sort(batches, {expected_runs->toBlazingTableView()}, sort);
+}
+
+TEST_F(MergeStreamTest, MergesRunsThatRunOutAtDifferentTimes) {
+	std::string plan = "LogicalMerge(sort0=[$0], dir0=[DESC])";
+	auto sort = ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan));
+
+	// the short runs run out after a slice or two while the long ones are still being refilled
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> runs;
+	std::vector<int> run_rows = {3, 1000, 40, 250, 1};
+	for(size_t i = 0; i < run_rows.size(); i++) {
+		runs.push_back(random_run(run_rows[i], 5000, 0.05, i * 10000, sort, 20 + i));
+	}
+	std::vector<ral::frame::BlazingTableView> run_views;
+	for(auto & run : runs) {
+		run_views.push_back(run->toBlazingTableView());
+	}
+	auto expected_runs = ral::utilities::concatTables(run_views);
+
+	std::vector<std::vector<std::unique_ptr<ral::frame::BlazingTable>>> partitions(1);
+	partitions[0] = std::move(runs);
+	auto batches = run_merge_stream(plan, std::move(partitions), 2000);
+	expect_full_sort(batches, {expected_runs->toBlazingTableView()}, sort);
+}
+
+TEST_F(MergeStreamTest, MergesDuplicateKeysAcrossRuns) {
+	std::string plan = "LogicalMerge(sort0=[$0], dir0=[ASC])";
+	auto sort = ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan));
+
+	// only 4 keys and some nulls, so most of the rows tie with rows of the other runs on the first key
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> runs;
+	for(int i = 0; i < 4; i++) {
+		runs.push_back(random_run(200, 4, 0.1, i * 1000, sort, 40 + i));
+	}
+	std::vector<ral::frame::BlazingTableView> run_views;
+	for(auto & run : runs) {
+		run_views.push_back(run->toBlazingTableView());
+	}
+	auto expected_runs = ral::utilities::concatTables(run_views);
+
+	std::vector<std::vector<std::unique_ptr<ral::frame::BlazingTable>>> partitions(1);
+	partitions[0] = std::move(runs);
+	auto batches = run_merge_stream(plan, std::move(partitions), 500);
+	expect_full_sort(batches, {expected_runs->toBlazingTableView()}, sort);
+}
+
+// A run whose keys all go after the ones of the other run is not settled at all until the other run runs out, so it
+// keeps its slice over many rounds. Its rows have to come out once, and the batches can not grow past a slice per run
+TEST_F(MergeStreamTest, RefillsARunOnlyAfterItsSliceWasOutput) {
+	std::string plan = "LogicalMerge(sort0=[$0], dir0=[ASC])";
+	auto sort = ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan));
+
+	std::vector<int32_t> low_keys(400), high_keys(400);
+	std::iota(low_keys.begin(), low_keys.end(), 0);
+	std::iota(high_keys.begin(), high_keys.end(), 1000);
+	std::vector<int32_t> mixed_keys(400);
+	for(size_t i = 0; i < mixed_keys.size(); i++) {
+		mixed_keys[i] = i * 3;
+	}
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> runs;
+	runs.push_back(make_table(high_keys, 0));
+	runs.push_back(make_table(low_keys, 1000));
+	runs.push_back(make_table(mixed_keys, 2000));
+	std::vector<ral::frame::BlazingTableView> run_views;
+	std::size_t total_bytes = 0;
+	for(auto & run : runs) {
+		run_views.push_back(run->toBlazingTableView());
+		total_bytes += run->sizeInBytes();
+	}
+	auto expected_runs = ral::utilities::concatTables(run_views);
+	std::size_t bytes_per_row = total_bytes / expected_runs->num_rows();
+
+	// 10 rows per run and slice
+	std::size_t batch_bytes = 10 * bytes_per_row * runs.size();
+	std::vector<std::vector<std::unique_ptr<ral::frame::BlazingTable>>> partitions(1);
+	partitions[0] = std::move(runs);
+	auto batches = run_merge_stream(plan, std::move(partitions), batch_bytes);
+
+	for(auto & batch : batches) {
+		EXPECT_LE(batch->num_rows(), 30);
+	}
+	expect_full_sort(batches, {expected_runs->toBlazingTableView()}, sort);
+}
+
+TEST_F(MergeStreamTest, MergesEveryPartitionInOrder) {
+	std::string plan = "LogicalMerge(sort0=[$0], dir0=[ASC])";
+	auto sort = ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan));
+
+	std::vector<std::vector<std::unique_ptr<ral::frame::BlazingTable>>> partitions(2);
+	partitions[0].push_back(make_table({0, 2, 4}, 0));
+	partitions[0].push_back(make_table({1, 3}, 10));
+	partitions[1].push_back(make_table({5, 7}, 20));
+	partitions[1].push_back(make_table({6}, 30));
+	auto batches = run_merge_stream(plan, std::move(partitions), 1000);
+
+	std::vector<int32_t> keys;
+	for(auto & batch : batches) {
+		auto batch_keys = host_keys(batch->toBlazingTableView());
+		keys.insert(keys.end(), batch_keys.begin(), batch_keys.end());
+	}
+	EXPECT_EQ(keys, (std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
@@ -11,6 +11,7 @@
 #include "from_cudf/cpp_tests/utilities/table_utilities.hpp"
 #include "from_cudf/cpp_tests/utilities/type_lists.hpp"
 #include "Interpreter/interpreter_cpp.h"
+#include "Interpreter/interpreter_cpu.h"
 
 template <typename T>
 struct InteropsTestNumeric : public cudf::test::BaseFixture {
@@ -387,3 +388,98 @@ TEST_F(InteropsTestString, test_string)
 
   cudf::test::expect_tables_equal(expected_table_view, out_table_view);
 }
+
+struct InteropsTestCpu : public cudf::test::BaseFixture {
+  void SetUp() {
+	  rmmInitialize(nullptr);
+  }
+  void TearDown() {
+    rmmFinalize();
+  }
+};
+
+TEST_F(InteropsTestCpu, same_results_as_device)
+{
+  using namespace interops;
+
+  // more rows than a block, with nulls
+  cudf::size_type inputRows = 10000;
+  auto sequence1 = cudf::test::make_counting_transform_iterator(0, [](auto row) { return static_cast<int32_t>(row % 100 - 50); });
+  auto sequence2 = cudf::test::make_counting_transform_iterator(0, [](auto row) { return static_cast<double>(row) / 7; });
+  auto sequence3 = cudf::test::make_counting_transform_iterator(0, [](auto row) { return static_cast<int32_t>(row % 5); });
+  auto valids = cudf::test::make_counting_transform_iterator(0, [](auto row) { return row % 11 != 0; });
+  cudf::test::fixed_width_column_wrapper<int32_t> col1(sequence1, sequence1 + inputRows, valids);
+  cudf::test::fixed_width_column_wrapper<double> col2(sequence2, sequence2 + inputRows);
+  cudf::test::fixed_width_column_wrapper<int32_t> col3(sequence3, sequence3 + inputRows);
+  cudf::table_view in_table_view ({col1, col2, col3});
+
+  // $3 = SIN(($0 + $2) / $1) * (($0 - $2) / $1) ^ 2  | $4 = $0 / $2  | $5 = $0 > 10 OR $2 IS NULL
+  std::vector<column_index_type> left_inputs =  {0, 6, 6,           0, 7, 7,            6, 0, 0,            2,           8};
+  std::vector<column_index_type> right_inputs = {2, 1, UNARY_INDEX, 2, 1, SCALAR_INDEX, 7, 2, SCALAR_INDEX, UNARY_INDEX, 9};
+  std::vector<column_index_type> outputs =      {6, 6, 6,           7, 7, 7,            3, 4, 8,            9,           5};
+  std::vector<column_index_type> final_output_positions = {3, 4, 5};
+  std::vector<operator_type> operators = {operator_type::BLZ_ADD, operator_type::BLZ_DIV, operator_type::BLZ_SIN,
+    operator_type::BLZ_SUB, operator_type::BLZ_DIV, operator_type::BLZ_POW, operator_type::BLZ_MUL,
+    operator_type::BLZ_DIV, operator_type::BLZ_GREATER, operator_type::BLZ_IS_NULL, operator_type::BLZ_LOGICAL_OR};
+
+  std::vector<std::unique_ptr<cudf::scalar>> left_scalars(operators.size());
+  std::vector<std::unique_ptr<cudf::scalar>> right_scalars(operators.size());
+  right_scalars[5] = cudf::make_numeric_scalar(cudf::data_type{cudf::type_id::INT32});
+  static_cast<cudf::experimental::scalar_type_t<int32_t>*>(right_scalars[5].get())->set_value(2);
+  right_scalars[8] = cudf::make_numeric_scalar(cudf::data_type{cudf::type_id::INT32});
+  static_cast<cudf::experimental::scalar_type_t<int32_t>*>(right_scalars[8].get())->set_value(10);
+
+  auto out_col1 = cudf::make_fixed_width_column(cudf::data_type{cudf::type_id::FLOAT64}, inputRows, cudf::mask_state::UNINITIALIZED);
+  auto out_col2 = cudf::make_fixed_width_column(cudf::data_type{cudf::type_id::INT32}, inputRows, cudf::mask_state::UNINITIALIZED);
+  auto out_col3 = cudf::make_fixed_width_column(cudf::data_type{cudf::type_id::BOOL8}, inputRows, cudf::mask_state::UNINITIALIZED);
+  cudf::mutable_table_view out_table_view ({out_col1->mutable_view(), out_col2->mutable_view(), out_col3->mutable_view()});
+
+  perform_interpreter_operation(out_table_view, in_table_view, left_inputs, right_inputs, outputs, final_output_positions,
+    operators, left_scalars, right_scalars);
+
+  // the same plan over host copies of the columns
+  auto host_col1 = cudf::test::to_host<int32_t>(col1);
+  auto host_col2 = cudf::test::to_host<double>(col2);
+  auto host_col3 = cudf::test::to_host<int32_t>(col3);
+  cudf::table_view host_in_table_view ({
+    cudf::column_view{cudf::data_type{cudf::type_id::INT32}, inputRows, host_col1.first.data(), host_col1.second.data()},
+    cudf::column_view{cudf::data_type{cudf::type_id::FLOAT64}, inputRows, host_col2.first.data()},
+    cudf::column_view{cudf::data_type{cudf::type_id::INT32}, inputRows, host_col3.first.data()}});
+
+  std::vector<double> host_out1(inputRows);
+  std::vector<int32_t> host_out2(inputRows);
+  std::vector<uint8_t> host_out3(inputRows);
+  std::vector<cudf::bitmask_type> host_valids1(cudf::num_bitmask_words(inputRows));
+  std::vector<cudf::bitmask_type> host_valids2(cudf::num_bitmask_words(inputRows));
+  std::vector<cudf::bitmask_type> host_valids3(cudf::num_bitmask_words(inputRows));
+  cudf::mutable_table_view host_out_table_view ({
+    cudf::mutable_column_view{cudf::data_type{cudf::type_id::FLOAT64}, inputRows, host_out1.data(), host_valids1.data()},
+    cudf::mutable_column_view{cudf::data_type{cudf::type_id::INT32}, inputRows, host_out2.data(), host_valids2.data()},
+    cudf::mutable_column_view{cudf::data_type{cudf::type_id::BOOL8}, inputRows, host_out3.data(), host_valids3.data()}});
+
+  cpu::perform_interpreter_operation(host_out_table_view, host_in_table_view, left_inputs, right_inputs, outputs,
+    final_output_positions, operators, cpu::to_host_scalars(left_scalars), cpu::to_host_scalars(right_scalars), 4);
+
+  auto device_out1 = cudf::test::to_host<double>(out_col1->view());
+  auto device_out2 = cudf::test::to_host<int32_t>(out_col2->view());
+  auto device_out3 = cudf::test::to_host<bool>(out_col3->view());
+  for (cudf::size_type row = 0; row < inputRows; row++) {
+    bool valid1 = cudf::bit_is_set(device_out1.second.data(), row);
+    ASSERT_EQ(valid1, cudf::bit_is_set(host_valids1.data(), row));
+    if (valid1) {
+      ASSERT_NEAR(device_out1.first[row], host_out1[row], 1e-9 * std::max(1.0, std::abs(host_out1[row])));
+    }
+
+    bool valid2 = cudf::bit_is_set(device_out2.second.data(), row);
+    ASSERT_EQ(valid2, cudf::bit_is_set(host_valids2.data(), row));
+    if (valid2) {
+      ASSERT_EQ(device_out2.first[row], host_out2[row]);
+    }
+
+    bool valid3 = cudf::bit_is_set(device_out3.second.data(), row);
+    ASSERT_EQ(valid3, cudf::bit_is_set(host_valids3.data(), row));
+    if (valid3) {
+      ASSERT_EQ(static_cast<bool>(device_out3.first[row]), static_cast<bool>(host_out3[row]));
+    }
+  }
+}
@@ -363,3 +363,49 @@ TYPED_TEST(ProjectRoundTest, test_round)
 
     cudf::test::expect_tables_equal(expect_cudf_table_view, table_out->view());
 }
+
+struct ExpressionProgramTest : public cudf::test::BaseFixture {};
+
+TEST_F(ExpressionProgramTest, reused_across_batches_and_schemas)
+{
+    ral::processor::expression_program program({"+($0, 1)", "$1", "*($0, $0)"});
+
+    cudf::test::fixed_width_column_wrapper<int32_t> batch1_col1{{1, 2, 3}};
+    cudf::test::fixed_width_column_wrapper<int32_t> batch1_col2{{7, 8, 9}};
+    auto batch1_out = program.evaluate(ral::frame::cudfTableViewToBlazingColumns(CudfTableView{{batch1_col1, batch1_col2}}));
+
+    cudf::test::fixed_width_column_wrapper<int32_t> batch2_col1{{4, 5}};
+    cudf::test::fixed_width_column_wrapper<int32_t> batch2_col2{{10, 11}};
+    auto batch2_out = program.evaluate(ral::frame::cudfTableViewToBlazingColumns(CudfTableView{{batch2_col1, batch2_col2}}));
+
+    // a batch with other types gets its own plan
+    cudf::test::fixed_width_column_wrapper<double> batch3_col1{{0.5, 1.5}};
+    cudf::test::fixed_width_column_wrapper<int32_t> batch3_col2{{12, 13}};
+    auto batch3_out = program.evaluate(ral::frame::cudfTableViewToBlazingColumns(CudfTableView{{batch3_col1, batch3_col2}}));
+
+    ASSERT_EQ(3, batch1_out.size());
+    cudf::test::expect_columns_equal(cudf::test::fixed_width_column_wrapper<int32_t>{{2, 3, 4}, {1, 1, 1}}, batch1_out[0]->view());
+    cudf::test::expect_columns_equal(batch1_col2, batch1_out[1]->view());
+    cudf::test::expect_columns_equal(cudf::test::fixed_width_column_wrapper<int32_t>{{1, 4, 9}, {1, 1, 1}}, batch1_out[2]->view());
+
+    cudf::test::expect_columns_equal(cudf::test::fixed_width_column_wrapper<int32_t>{{5, 6}, {1, 1}}, batch2_out[0]->view());
+    cudf::test::expect_columns_equal(batch2_col2, batch2_out[1]->view());
+    cudf::test::expect_columns_equal(cudf::test::fixed_width_column_wrapper<int32_t>{{16, 25}, {1, 1}}, batch2_out[2]->view());
+
+    cudf::test::expect_columns_equal(cudf::test::fixed_width_column_wrapper<double>{{1.5, 2.5}, {1, 1}}, batch3_out[0]->view());
+    cudf::test::expect_columns_equal(cudf::test::fixed_width_column_wrapper<double>{{0.25, 2.25}, {1, 1}}, batch3_out[2]->view());
+}
+
+TEST_F(ExpressionProgramTest, string_functions_are_computed_for_every_batch)
+{
+    ral::processor::expression_program program({"SUBSTRING($0, 1, 2)"});
+
+    cudf::test::strings_column_wrapper batch1_col{"abc", "def"};
+    auto batch1_out = program.evaluate(ral::frame::cudfTableViewToBlazingColumns(CudfTableView{{batch1_col}}));
+
+    cudf::test::strings_column_wrapper batch2_col{"ghi", "jkl", "mno"};
+    auto batch2_out = program.evaluate(ral::frame::cudfTableViewToBlazingColumns(CudfTableView{{batch2_col}}));
+
+    cudf::test::expect_columns_equal(cudf::test::strings_column_wrapper{"ab", "de"}, batch1_out[0]->view());
+    cudf::test::expect_columns_equal(cudf::test::strings_column_wrapper{"gh", "jk", "mn"}, batch2_out[0]->view());
+}
@@ -1,4 +1,5 @@
 #include "parser/expression_tree.hpp"
+#include "parser/expression_utils.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
 
@@ -90,3 +91,10 @@ TEST_F(ExpressionTreeTest, case_10) {
 	tree.transform_to_custom_op();
 	EXPECT_EQ(tree.rebuildExpression(), expected);
 }
+
+TEST_F(ExpressionTreeTest, input_columns) {
+	std::string expression = "AND(>($5, 3), =($2, '$7'), <($5, $0))";
+	std::vector<int> expected = {0, 2, 5};
+	EXPECT_EQ(get_input_columns(expression), expected);
+	EXPECT_EQ(reindex_columns(expression, expected), "AND(>($2, 3), =($1, '$7'), <($2, $0))");
+}
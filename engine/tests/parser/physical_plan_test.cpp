@@ -0,0 +1,196 @@
+#include "parser/physical_plan.hpp"
+#include "utilities/BlazingSqlInvalidAlgebraException.h"
+#include <gtest/gtest.h>
+
+using namespace ral::parser;
+
+struct PhysicalPlanTest : public ::testing::Test {
+	PhysicalPlanTest() {}
+
+	~PhysicalPlanTest() {}
+};
+
+TEST_F(PhysicalPlanTest, parse_bindable_scan) {
+	auto node = parse_plan_node("BindableTableScan(table=[[main, nation]], filters=[[<($0, 10)]], projects=[[0, 1, 2]], aliases=[[n_nationkey, n_name, n_regionkey]])");
+	EXPECT_EQ(node->kind, plan_node_kind::BindableTableScan);
+	EXPECT_EQ(node->table_name, "main.nation");
+	EXPECT_EQ(node->condition, "<($0, 10)");
+	EXPECT_EQ(node->projections, std::vector<size_t>({0, 1, 2}));
+	EXPECT_EQ(node->aliases, std::vector<std::string>({"n_nationkey", "n_name", "n_regionkey"}));
+}
+
+TEST_F(PhysicalPlanTest, parse_join_keys) {
+	auto node = parse_plan_node("LogicalJoin(condition=[AND(=($3, $0), =($1, $5))], joinType=[left])");
+	EXPECT_EQ(node->kind, plan_node_kind::Join);
+	EXPECT_EQ(node->join_type, "left");
+	EXPECT_EQ(node->left_join_keys, std::vector<int>({0, 1}));
+	EXPECT_EQ(node->right_join_keys, std::vector<int>({3, 5}));
+
+	auto inequality = parse_plan_node("LogicalJoin(condition=[AND(=($0, $3), <($1, $4))], joinType=[inner])");
+	EXPECT_TRUE(inequality->left_join_keys.empty());
+	EXPECT_TRUE(inequality->right_join_keys.empty());
+}
+
+TEST_F(PhysicalPlanTest, parse_sort_and_aggregate) {
+	auto sort = parse_plan_node("LogicalSort(sort0=[$1], dir0=[DESC], sort1=[$0], dir1=[ASC], fetch=[5])");
+	ASSERT_EQ(sort->sort_keys.size(), 2);
+	EXPECT_EQ(sort->sort_keys[0].column, 1);
+	EXPECT_FALSE(sort->sort_keys[0].ascending);
+	EXPECT_EQ(sort->sort_keys[1].column, 0);
+	EXPECT_TRUE(sort->sort_keys[1].ascending);
+	EXPECT_EQ(sort->limit, 5);
+
+	auto aggregate = parse_plan_node("LogicalAggregate(group=[{0, 2}], EXPR$1=[SUM($1)], EXPR$2=[COUNT()])");
+	EXPECT_EQ(aggregate->group_columns, std::vector<int>({0, 2}));
+	EXPECT_EQ(aggregate->expressions, std::vector<std::string>({"SUM($1)", "COUNT()"}));
+}
+
+// the operator is told by its name only, not by text found anywhere in the expression
+TEST_F(PhysicalPlanTest, operator_name_in_literal) {
+	auto node = parse_plan_node("LogicalProject(EXPR$0=[CASE(=($1, 'LogicalFilter'), 1, 0)], b=[$0])");
+	EXPECT_EQ(node->kind, plan_node_kind::Project);
+	EXPECT_EQ(node->expressions, std::vector<std::string>({"CASE(=($1, 'LogicalFilter'), 1, 0)", "$0"}));
+	EXPECT_EQ(node->expr(), "LogicalProject(EXPR$0=[CASE(=($1, 'LogicalFilter'), 1, 0)], b=[$0])");
+}
+
+TEST_F(PhysicalPlanTest, unsupported_operator) {
+	EXPECT_THROW(parse_plan_node("LogicalCalc(expr#0=[1])"), ral::utilities::BlazingSqlInvalidAlgebraException);
+}
+
+TEST_F(PhysicalPlanTest, rewrite_single_node) {
+	std::string json = R"J({"expr": "LogicalSort(sort0=[$0], dir0=[ASC])", "children": [
+		{"expr": "LogicalAggregate(group=[{0}], EXPR$1=[SUM($1)])", "children": [
+			{"expr": "LogicalJoin(condition=[=($0, $2)], joinType=[inner])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, a]])", "children": []},
+				{"expr": "LogicalTableScan(table=[[main, b]])", "children": []}]}]}]})J";
+
+	auto plan = rewrite_plan(build_physical_plan(json), get_physical_rewrite_rules(1));
+	std::vector<plan_node_kind> kinds;
+	for(auto node = plan; !node->children.empty(); node = node->children[0]) {
+		kinds.push_back(node->kind);
+	}
+	EXPECT_EQ(kinds, std::vector<plan_node_kind>({plan_node_kind::Limit, plan_node_kind::MergeStream,
+		plan_node_kind::PartitionSingleNode, plan_node_kind::SortAndSampleSingleNode, plan_node_kind::MergeAggregate,
+		plan_node_kind::ComputeAggregate, plan_node_kind::PartwiseJoin}));
+	EXPECT_EQ(plan->expr(), "LogicalLimit(sort0=[$0], dir0=[ASC])");
+}
+
+TEST_F(PhysicalPlanTest, rewrite_distributed) {
+	std::string json = R"J({"expr": "LogicalSort(fetch=[10])", "children": [
+		{"expr": "LogicalAggregate(group=[{0}], EXPR$1=[SUM($1)])", "children": [
+			{"expr": "LogicalJoin(condition=[=($0, $2)], joinType=[inner])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, a]])", "children": []},
+				{"expr": "LogicalTableScan(table=[[main, b]])", "children": []}]}]}]})J";
+
+	auto plan = rewrite_plan(build_physical_plan(json), get_physical_rewrite_rules(4));
+	std::vector<plan_node_kind> kinds;
+	auto node = plan;
+	for(; !node->children.empty(); node = node->children[0]) {
+		kinds.push_back(node->kind);
+	}
+	EXPECT_EQ(kinds, std::vector<plan_node_kind>({plan_node_kind::Limit, plan_node_kind::MergeAggregate,
+		plan_node_kind::DistributeAggregate, plan_node_kind::ComputeAggregate, plan_node_kind::PartwiseJoin,
+		plan_node_kind::JoinPartition}));
+	EXPECT_EQ(node->table_name, "main.a");
+}
+
+TEST_F(PhysicalPlanTest, rewrite_top_n) {
+	std::string json = R"J({"expr": "LogicalSort(sort0=[$1], dir0=[DESC], fetch=[100])", "children": [
+		{"expr": "LogicalTableScan(table=[[main, a]])", "children": []}]})J";
+
+	for(int total_nodes : {1, 4}) {
+		auto plan = rewrite_plan(build_physical_plan(json), get_physical_rewrite_rules(total_nodes));
+		EXPECT_EQ(plan->kind, plan_node_kind::TopN);
+		EXPECT_EQ(plan->expr(), "LogicalTopN(sort0=[$1], dir0=[DESC], fetch=[100])");
+		EXPECT_EQ(plan->limit, 100);
+		ASSERT_EQ(plan->sort_keys.size(), 1);
+		EXPECT_EQ(plan->children[0]->kind, plan_node_kind::TableScan);
+	}
+
+	// bigger limits are better served by the distributed sort
+	std::string big_limit_json = R"J({"expr": "LogicalSort(sort0=[$1], dir0=[DESC], fetch=[100000000])", "children": [
+		{"expr": "LogicalTableScan(table=[[main, a]])", "children": []}]})J";
+	auto plan = rewrite_plan(build_physical_plan(big_limit_json), get_physical_rewrite_rules(1));
+	EXPECT_EQ(plan->kind, plan_node_kind::Limit);
+}
+
+TEST_F(PhysicalPlanTest, fuse_filter_and_project) {
+	std::string json = R"J({"expr": "LogicalProject(total=[+($1, $0)], key=[$0])", "children": [
+		{"expr": "LogicalFilter(condition=[AND(>($1, 10), <>($0, '$1'))])", "children": [
+			{"expr": "LogicalProject(k=[$2], v=[$0])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]}]}]})J";
+
+	auto plan = rewrite_plan(build_physical_plan(json), get_physical_rewrite_rules(1));
+	EXPECT_EQ(plan->kind, plan_node_kind::FilterProject);
+	EXPECT_EQ(plan->condition, "AND(>($0, 10), <>($2, '$1'))");
+	EXPECT_EQ(plan->expressions, std::vector<std::string>({"+($0, $2)", "$2"}));
+	EXPECT_EQ(plan->aliases, std::vector<std::string>({"total", "key"}));
+	EXPECT_EQ(plan->expr(), "LogicalFilterProject(condition=[AND(>($0, 10), <>($2, '$1'))], total=[+($0, $2)], key=[$2])");
+	ASSERT_EQ(plan->children.size(), 1);
+	EXPECT_EQ(plan->children[0]->kind, plan_node_kind::TableScan);
+}
+
+TEST_F(PhysicalPlanTest, fuse_filter_over_computed_column) {
+	// the filter uses a column that the project below it computes, so only the project above it is fused
+	std::string json = R"J({"expr": "LogicalProject(x=[$0])", "children": [
+		{"expr": "LogicalFilter(condition=[>($0, 10)])", "children": [
+			{"expr": "LogicalProject(s=[+($0, $1)])", "children": [
+				{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]}]}]})J";
+
+	auto plan = rewrite_plan(build_physical_plan(json), get_physical_rewrite_rules(1));
+	EXPECT_EQ(plan->expr(), "LogicalFilterProject(condition=[>($0, 10)], x=[$0])");
+	EXPECT_EQ(plan->children[0]->kind, plan_node_kind::Project);
+	EXPECT_EQ(plan->children[0]->children[0]->kind, plan_node_kind::TableScan);
+}
+
+TEST_F(PhysicalPlanTest, normalize_algebra) {
+	EXPECT_EQ(normalize_algebra("{\"expr\": \"LogicalFilter(condition=[=($1, 'a b')])\",\n\t\"children\": []}"),
+		"{\"expr\":\"LogicalFilter(condition=[=($1, 'a b')])\",\"children\":[]}");
+	// aliases can have spaces, two plans that only differ in them are not the same plan
+	EXPECT_NE(normalize_algebra("{\"expr\": \"LogicalProject(a b=[$0])\", \"children\": []}"),
+		normalize_algebra("{\"expr\": \"LogicalProject(ab=[$0])\", \"children\": []}"));
+	EXPECT_EQ(normalize_algebra("{\"expr\": \"LogicalProject(\\\"a\\\"=[$0])\" }"), "{\"expr\":\"LogicalProject(\\\"a\\\"=[$0])\"}");
+}
+
+TEST_F(PhysicalPlanTest, bind_parameters) {
+	std::string json = R"J({"expr": "LogicalProject(a=[$0], b=[?1])", "children": [
+		{"expr": "LogicalFilter(condition=[AND(>($0, ?0), <>($1, '?0'))])", "children": [
+			{"expr": "LogicalTableScan(table=[[main, t]])", "children": []}]}]})J";
+
+	auto plan_template = build_physical_plan(json);
+	EXPECT_EQ(count_parameters(*plan_template), 2);
+
+	auto plan = bind_parameters(*plan_template, {"10", "'x'"});
+	EXPECT_EQ(plan->expressions, std::vector<std::string>({"$0", "'x'"}));
+	EXPECT_EQ(plan->children[0]->condition, "AND(>($0, 10), <>($1, '?0'))");
+	// the template is left as it was, so that it can be bound again
+	EXPECT_EQ(plan_template->children[0]->condition, "AND(>($0, ?0), <>($1, '?0'))");
+
+	EXPECT_THROW(bind_parameters(*plan_template, {"10"}), std::invalid_argument);
+}
+
+TEST_F(PhysicalPlanTest, plan_runtime_filters) {
+	// fact(4 columns) joined with a filtered dimension, and that with a left join whose right side can not be filtered
+	std::string json = R"J({"expr": "LogicalProject(k=[$0], v=[$5])", "children": [
+		{"expr": "LogicalJoin(condition=[=($1, $4)], joinType=[inner])", "children": [
+			{"expr": "LogicalJoin(condition=[=($0, $3)], joinType=[left])", "children": [
+				{"expr": "BindableTableScan(table=[[main, fact]], projects=[[0, 2, 3]], aliases=[[k, d, v]])", "children": []},
+				{"expr": "LogicalTableScan(table=[[main, other]])", "children": []}]},
+			{"expr": "LogicalProject(id=[$0], name=[$1])", "children": [
+				{"expr": "LogicalFilter(condition=[=($1, 'x')])", "children": [
+					{"expr": "LogicalTableScan(table=[[main, dim]])", "children": []}]}]}]}]})J";
+
+	auto plan = rewrite_plan(build_physical_plan(json), get_physical_rewrite_rules(2));
+	auto scan_num_columns = [](const plan_node & scan) { return scan.table_name == "main.other" ? size_t(1) : size_t(2); };
+	auto specs = plan_runtime_filters(*plan, scan_num_columns);
+
+	ASSERT_EQ(specs.size(), 1);
+	const plan_node & join = *plan->children[0];
+	EXPECT_EQ(specs[0].join, &join);
+	EXPECT_EQ(specs[0].build_input, &join_input(join, 1));
+	EXPECT_EQ(specs[0].build_column, 0);
+	EXPECT_EQ(specs[0].scan->table_name, "main.fact");
+	EXPECT_EQ(specs[0].scan_column, 1);
+
+	EXPECT_EQ(num_output_columns(join, scan_num_columns), 6);
+}
@@ -0,0 +1,251 @@
+#include "../BlazingUnitTest.h"
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "io/DataLoader.h"
+#include "io/data_parser/CSVParser.h"
+#include "io/data_parser/JSONParser.h"
+#include "io/data_parser/ParquetParser.h"
+#include "io/data_provider/UriDataProvider.h"
+#include "utilities/CommonOperations.h"
+#include <from_cudf/cpp_tests/utilities/table_utilities.hpp>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+
+namespace cudf_io = cudf::experimental::io;
+
+namespace {
+
+const int NUM_ROWS = 500;
+
+std::string write_file(const std::string & path, const std::string & content) {
+	std::ofstream file(path, std::ofstream::out);
+	file << content;
+	file.close();
+	return path;
+}
+
+// Every row has a quoted field with the line terminator and the delimiter in it, and some a doubled quote
+std::string quoted_csv_content() {
+	std::string content = "id,text,value\n";
+	for(int i = 0; i < NUM_ROWS; i++) {
+		content += std::to_string(i) + ",\"row " + std::to_string(i) + ",\nwith a line break" + (i % 3 == 0 ? " and a \"\"quote\"\"" : "") +
+			"\"," + std::to_string(i * 2) + "\n";
+	}
+	return content;
+}
+
+std::string csv_content(bool header) {
+	std::string content = header ? "id,value,other\n" : "";
+	for(int i = 0; i < NUM_ROWS; i++) {
+		content += std::to_string(i) + "," + std::to_string(i * 3) + "," + std::to_string(i * 7) + "\n";
+	}
+	return content;
+}
+
+std::string json_lines_content() {
+	std::string content;
+	for(int i = 0; i < NUM_ROWS; i++) {
+		content += "{\"id\":" + std::to_string(i) + ",\"value\":" + std::to_string(i * 5) + "}\n";
+	}
+	return content;
+}
+
+std::shared_ptr<arrow::io::ReadableFile> open_file(const std::string & path) {
+	std::shared_ptr<arrow::io::ReadableFile> file;
+	EXPECT_TRUE(arrow::io::ReadableFile::Open(path, &file).ok());
+	return file;
+}
+
+// The units have to cover the bytes of the file one after the other
+void expect_contiguous_byte_ranges(const std::vector<ral::io::scan_unit> & units, int64_t num_bytes) {
+	int64_t offset = 0;
+	for(auto & unit : units) {
+		EXPECT_EQ(unit.byte_range_offset, offset);
+		EXPECT_GT(unit.byte_range_size, 0);
+		offset += unit.byte_range_size;
+	}
+	EXPECT_EQ(offset, num_bytes);
+}
+
+}  // namespace
+
+struct ScanUnitsTest : public BlazingUnitTest {
+	void TearDown() {
+		for(auto & path : paths) {
+			std::remove(path.c_str());
+		}
+		BlazingUnitTest::TearDown();
+	}
+
+	ral::io::Schema get_schema(std::shared_ptr<ral::io::data_parser> parser, const std::string & path) {
+		auto provider = std::make_shared<ral::io::uri_data_provider>(std::vector<Uri>{Uri{path}});
+		ral::io::data_loader loader(parser, provider);
+		ral::io::Schema schema;
+		loader.get_schema(schema, {});
+		return schema;
+	}
+
+	// Reads every unit of the file and checks that together they are the whole file, with the same names
+	void expect_units_read_the_whole_file(std::shared_ptr<ral::io::data_parser> parser,
+		const std::string & path,
+		const ral::io::Schema & schema,
+		const std::vector<ral::io::scan_unit> & units) {
+		std::vector<size_t> column_indices(schema.get_num_columns());
+		std::iota(column_indices.begin(), column_indices.end(), 0);
+
+		auto file = open_file(path);
+		std::vector<std::unique_ptr<ral::frame::BlazingTable>> unit_tables;
+		std::vector<ral::frame::BlazingTableView> unit_views;
+		for(auto & unit : units) {
+			unit_tables.push_back(parser->parse_scan_unit(file, schema, column_indices, unit));
+			ASSERT_NE(unit_tables.back(), nullptr);
+			unit_views.push_back(unit_tables.back()->toBlazingTableView());
+		}
+		file->Close();
+		auto units_table = ral::utilities::concatTables(unit_views);
+
+		auto whole = parser->parse(open_file(path), schema, column_indices);
+		EXPECT_EQ(whole->num_rows(), NUM_ROWS);
+		for(auto & unit_table : unit_tables) {
+			EXPECT_EQ(unit_table->names(), whole->names());
+		}
+		cudf::test::expect_tables_equal(whole->view(), units_table->view());
+	}
+
+	std::vector<std::string> paths;
+};
+
+TEST_F(ScanUnitsTest, SplitsCSVAtTheEndsOfTheRows) {
+	std::string content = csv_content(true);
+	paths.push_back(write_file("/tmp/.blazing-scan-units-test.csv", content));
+	cudf_io::read_csv_args args{cudf_io::source_info{""}};
+	auto parser = std::make_shared<ral::io::csv_parser>(args);
+
+	auto units = parser->get_scan_units(open_file(paths.back()), {}, 1000);
+	ASSERT_GT(units.size(), 1);
+	expect_contiguous_byte_ranges(units, content.size());
+	for(size_t i = 1; i < units.size(); i++) {
+		EXPECT_EQ(content[units[i].byte_range_offset], '\n');
+	}
+	expect_units_read_the_whole_file(parser, paths.back(), get_schema(parser, paths.back()), units);
+}
+
+TEST_F(ScanUnitsTest, DoesNotSplitCSVInsideOfQuotedFields) {
+	std::string content = quoted_csv_content();
+	paths.push_back(write_file("/tmp/.blazing-scan-units-test-quoted.csv", content));
+	cudf_io::read_csv_args args{cudf_io::source_info{""}};
+	auto parser = std::make_shared<ral::io::csv_parser>(args);
+
+	auto units = parser->get_scan_units(open_file(paths.back()), {}, 1000);
+	ASSERT_GT(units.size(), 1);
+	expect_contiguous_byte_ranges(units, content.size());
+	for(size_t i = 1; i < units.size(); i++) {
+		// every row ends with the value, so a terminator outside of the quotes comes after a digit
+		EXPECT_EQ(content[units[i].byte_range_offset], '\n');
+		EXPECT_TRUE(std::isdigit(content[units[i].byte_range_offset - 1]));
+	}
+	expect_units_read_the_whole_file(parser, paths.back(), get_schema(parser, paths.back()), units);
+}
+
+TEST_F(ScanUnitsTest, SplitsCSVWithoutAHeader) {
+	std::string content = csv_content(false);
+	paths.push_back(write_file("/tmp/.blazing-scan-units-test-no-header.csv", content));
+	cudf_io::read_csv_args args{cudf_io::source_info{""}};
+	args.header = -1;
+	auto parser = std::make_shared<ral::io::csv_parser>(args);
+
+	auto units = parser->get_scan_units(open_file(paths.back()), {}, 1000);
+	ASSERT_GT(units.size(), 1);
+	expect_units_read_the_whole_file(parser, paths.back(), get_schema(parser, paths.back()), units);
+}
+
+TEST_F(ScanUnitsTest, LaterCSVUnitsGetTheNamesInTheOrderOfTheFile) {
+	std::string content = csv_content(true);
+	paths.push_back(write_file("/tmp/.blazing-scan-units-test-order.csv", content));
+	cudf_io::read_csv_args args{cudf_io::source_info{""}};
+	auto parser = std::make_shared<ral::io::csv_parser>(args);
+	auto units = parser->get_scan_units(open_file(paths.back()), {}, 1000);
+	ASSERT_GT(units.size(), 1);
+
+	// the columns of the schema are not in the order of the file
+	ral::io::Schema file_schema = get_schema(parser, paths.back());
+	ral::io::Schema schema({"other", "id", "value"}, {2, 0, 1}, {file_schema.get_dtype(2), file_schema.get_dtype(0), file_schema.get_dtype(1)});
+
+	auto file = open_file(paths.back());
+	auto first = parser->parse_scan_unit(file, schema, {0, 2}, units.front());
+	auto later = parser->parse_scan_unit(file, schema, {0, 2}, units.back());
+	file->Close();
+	EXPECT_EQ(first->names(), (std::vector<std::string>{"id", "other"}));
+	EXPECT_EQ(later->names(), first->names());
+}
+
+TEST_F(ScanUnitsTest, SplitsJSONLinesAtTheEndsOfTheRows) {
+	std::string content = json_lines_content();
+	paths.push_back(write_file("/tmp/.blazing-scan-units-test.json", content));
+	cudf_io::read_json_args args{cudf_io::source_info{""}};
+	args.lines = true;
+	auto parser = std::make_shared<ral::io::json_parser>(args);
+
+	auto units = parser->get_scan_units(open_file(paths.back()), {}, 1000);
+	ASSERT_GT(units.size(), 1);
+	expect_contiguous_byte_ranges(units, content.size());
+	expect_units_read_the_whole_file(parser, paths.back(), get_schema(parser, paths.back()), units);
+}
+
+TEST_F(ScanUnitsTest, DoesNotSplitJSONThatIsNotInLines) {
+	paths.push_back(write_file("/tmp/.blazing-scan-units-test-array.json", json_lines_content()));
+	cudf_io::read_json_args args{cudf_io::source_info{""}};
+	args.lines = false;
+	ral::io::json_parser parser(args);
+
+	auto units = parser.get_scan_units(open_file(paths.back()), {}, 1000);
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].byte_range_size, 0);
+}
+
+TEST_F(ScanUnitsTest, SplitsParquetByRowGroups) {
+	const int64_t rows_per_row_group = 100;
+	arrow::Int64Builder builder;
+	for(int64_t row = 0; row < 4 * rows_per_row_group; row++) {
+		ASSERT_TRUE(builder.Append(row).ok());
+	}
+	std::shared_ptr<arrow::Array> array;
+	ASSERT_TRUE(builder.Finish(&array).ok());
+	std::shared_ptr<arrow::Table> table = arrow::Table::Make(arrow::schema({arrow::field("id", arrow::int64(), false)}), {array});
+	paths.push_back("/tmp/.blazing-scan-units-test.parquet");
+	std::shared_ptr<arrow::io::FileOutputStream> sink;
+	ASSERT_TRUE(arrow::io::FileOutputStream::Open(paths.back(), &sink).ok());
+	ASSERT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), sink, rows_per_row_group).ok());
+	ASSERT_TRUE(sink->Close().ok());
+
+	ral::io::parquet_parser parser;
+	auto units = parser.get_scan_units(open_file(paths.back()), {}, 1);
+	ASSERT_EQ(units.size(), 4);
+	for(size_t i = 0; i < units.size(); i++) {
+		EXPECT_EQ(units[i].row_groups, (std::vector<cudf::size_type>{static_cast<cudf::size_type>(i)}));
+		EXPECT_EQ(units[i].byte_range_size, 0);
+	}
+
+	// only the row groups that are left after skipping get units
+	units = parser.get_scan_units(open_file(paths.back()), {1, 3}, 1);
+	ASSERT_EQ(units.size(), 2);
+	EXPECT_EQ(units[0].row_groups, (std::vector<cudf::size_type>{1}));
+	EXPECT_EQ(units[1].row_groups, (std::vector<cudf::size_type>{3}));
+
+	// a target bigger than the file makes a single unit with every row group
+	units = parser.get_scan_units(open_file(paths.back()), {}, 1000000000);
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].row_groups, (std::vector<cudf::size_type>{0, 1, 2, 3}));
+
+	units = parser.get_scan_units(open_file(paths.back()), {0, 2}, 0);
+	ASSERT_EQ(units.size(), 1);
+	EXPECT_EQ(units[0].row_groups, (std::vector<cudf::size_type>{0, 2}));
+}
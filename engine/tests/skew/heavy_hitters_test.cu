@@ -0,0 +1,211 @@
+#include <from_cudf/cpp_tests/utilities/column_utilities.hpp>
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+
+#include "distribution/skew.h"
+#include "../BlazingUnitTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+struct HeavyHittersTest : public BlazingUnitTest {};
+
+// Keys follow a Zipf distribution, key 0 is the most frequent one.
+static std::vector<int32_t> generate_zipf_keys(std::size_t num_rows, int num_keys, double exponent, unsigned int seed) {
+	std::vector<double> weights(num_keys);
+	for(int k = 0; k < num_keys; k++) {
+		weights[k] = 1.0 / std::pow(k + 1, exponent);
+	}
+	std::mt19937 generator(seed);
+	std::discrete_distribution<int32_t> distribution(weights.begin(), weights.end());
+
+	std::vector<int32_t> keys(num_rows);
+	for(auto & key : keys) {
+		key = distribution(generator);
+	}
+	return keys;
+}
+
+TEST_F(HeavyHittersTest, ZipfHeadIsDetectedAcrossNodes) {
+	const int num_nodes = 4;
+	const std::size_t rows_per_node = 100000;
+
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> node_counts;
+	std::vector<ral::frame::BlazingTableView> node_counts_views;
+	for(int node = 0; node < num_nodes; node++) {
+		std::vector<int32_t> keys = generate_zipf_keys(rows_per_node, 100000, 1.2, node);
+		cudf::test::fixed_width_column_wrapper<int32_t> key_column(keys.begin(), keys.end());
+		cudf::test::fixed_width_column_wrapper<int32_t> value_column(keys.begin(), keys.end());
+		CudfTableView table_view{{key_column, value_column}};
+		ral::frame::BlazingTableView table(table_view, {"key", "value"});
+
+		node_counts.push_back(ral::distribution::sampleKeyCounts(table, 0, 10000));
+		node_counts_views.push_back(node_counts.back()->toBlazingTableView());
+	}
+
+	std::unique_ptr<ral::frame::BlazingTable> heavy_hitters;
+	double max_share;
+	std::tie(heavy_hitters, max_share) = ral::distribution::selectHeavyHitters(
+		node_counts_views, num_nodes * rows_per_node, num_nodes, 0.5);
+
+	// with an exponent of 1.2 the first key holds about 20% of the rows, above the 12.5% threshold for 4 nodes,
+	// the second one holds about 8%
+	ASSERT_EQ(1, heavy_hitters->num_columns());
+	ASSERT_EQ(1, heavy_hitters->num_rows());
+	EXPECT_EQ(0, cudf::test::to_host<int32_t>(heavy_hitters->view().column(0)).first[0]);
+	EXPECT_GT(max_share, 0.125);
+}
+
+TEST_F(HeavyHittersTest, UniformKeysHaveNoHeavyHitters) {
+	std::vector<int32_t> keys(100000);
+	std::iota(keys.begin(), keys.end(), 0);
+	cudf::test::fixed_width_column_wrapper<int32_t> key_column(keys.begin(), keys.end());
+	CudfTableView table_view{{key_column}};
+	ral::frame::BlazingTableView table(table_view, {"key"});
+
+	std::unique_ptr<ral::frame::BlazingTable> counts = ral::distribution::sampleKeyCounts(table, 0, 10000);
+
+	std::unique_ptr<ral::frame::BlazingTable> heavy_hitters;
+	double max_share;
+	std::tie(heavy_hitters, max_share) = ral::distribution::selectHeavyHitters(
+		{counts->toBlazingTableView()}, keys.size(), 4, 0.5);
+
+	EXPECT_EQ(0, heavy_hitters->num_rows());
+}
+
+TEST_F(HeavyHittersTest, SplitHeavyHitterRows) {
+	cudf::test::fixed_width_column_wrapper<int32_t> key_column{{7, 1, 7, 2, 7, 3, 0}, {1, 1, 1, 1, 1, 1, 0}};
+	cudf::test::fixed_width_column_wrapper<int64_t> value_column{{0, 1, 2, 3, 4, 5, 6}};
+	CudfTableView table_view{{key_column, value_column}};
+	ral::frame::BlazingTableView table(table_view, {"key", "value"});
+
+	cudf::test::fixed_width_column_wrapper<int32_t> heavy_hitter_column{{7, 3}};
+	CudfTableView heavy_hitters_view{{heavy_hitter_column}};
+	ral::frame::BlazingTableView heavy_hitters(heavy_hitters_view, {"key"});
+
+	std::unique_ptr<ral::frame::BlazingTable> heavy_hitter_rows, other_rows;
+	std::tie(heavy_hitter_rows, other_rows) = ral::distribution::splitHeavyHitterRows(table, 0, heavy_hitters);
+
+	std::vector<int64_t> heavy_hitter_values = cudf::test::to_host<int64_t>(heavy_hitter_rows->view().column(1)).first;
+	std::vector<int64_t> other_values = cudf::test::to_host<int64_t>(other_rows->view().column(1)).first;
+
+	// the row with a null key is not a heavy hitter and it is not lost either
+	EXPECT_EQ(std::vector<int64_t>({0, 2, 4, 5}), heavy_hitter_values);
+	EXPECT_EQ(std::vector<int64_t>({1, 3, 6}), other_values);
+	EXPECT_EQ(table.names(), heavy_hitter_rows->names());
+}
+
+TEST_F(HeavyHittersTest, SplitEvenly) {
+	std::vector<int32_t> values(10);
+	std::iota(values.begin(), values.end(), 0);
+	cudf::test::fixed_width_column_wrapper<int32_t> column(values.begin(), values.end());
+	CudfTableView table_view{{column}};
+
+	std::vector<CudfTableView> partitions = ral::distribution::splitEvenly(table_view, 4);
+
+	ASSERT_EQ(4, partitions.size());
+	cudf::size_type total_rows = 0;
+	for(auto & partition : partitions) {
+		EXPECT_GE(partition.num_rows(), 2);
+		EXPECT_LE(partition.num_rows(), 3);
+		total_rows += partition.num_rows();
+	}
+	EXPECT_EQ(10, total_rows);
+}
+
+TEST_F(HeavyHittersTest, RecurringKeys) {
+	cudf::test::fixed_width_column_wrapper<int32_t> batch1{{1, 2, 3}};
+	cudf::test::fixed_width_column_wrapper<int32_t> batch2{{2, 3, 4}};
+	cudf::test::fixed_width_column_wrapper<int32_t> batch3{{3, 5, 2}};
+	CudfTableView view1{{batch1}}, view2{{batch2}}, view3{{batch3}};
+	std::vector<ral::frame::BlazingTableView> batches{
+		ral::frame::BlazingTableView(view1, {"key"}),
+		ral::frame::BlazingTableView(view2, {"key"}),
+		ral::frame::BlazingTableView(view3, {"key"})};
+
+	std::unique_ptr<ral::frame::BlazingTable> recurring_keys = ral::distribution::findRecurringKeys(batches, 0, 100);
+
+	std::vector<int32_t> keys = cudf::test::to_host<int32_t>(recurring_keys->view().column(0)).first;
+	std::sort(keys.begin(), keys.end());
+	EXPECT_EQ(std::vector<int32_t>({2, 3}), keys);
+
+	recurring_keys = ral::distribution::findRecurringKeys(batches, 0, 1);
+	EXPECT_EQ(1, recurring_keys->num_rows());
+}
+
+TEST_F(HeavyHittersTest, MergedKeySamplesAreProportionalToTheRowsOfTheBatches) {
+	std::vector<int32_t> small_keys(1000, 1);
+	std::vector<int32_t> big_keys(9000, 2);
+	cudf::test::fixed_width_column_wrapper<int32_t> small_column(small_keys.begin(), small_keys.end());
+	cudf::test::fixed_width_column_wrapper<int32_t> big_column(big_keys.begin(), big_keys.end());
+	CudfTableView small_view{{small_column}}, big_view{{big_column}};
+
+	std::unique_ptr<ral::frame::BlazingTable> small_sample =
+		ral::distribution::sampleKeys(ral::frame::BlazingTableView(small_view, {"key"}), 0, 500);
+	std::unique_ptr<ral::frame::BlazingTable> big_sample =
+		ral::distribution::sampleKeys(ral::frame::BlazingTableView(big_view, {"key"}), 0, 500);
+	EXPECT_EQ(500, small_sample->num_rows());
+
+	std::unique_ptr<ral::frame::BlazingTable> merged = ral::distribution::mergeKeySamples(
+		{small_sample->toBlazingTableView(), big_sample->toBlazingTableView()}, {1000, 9000}, 500);
+
+	std::vector<int32_t> keys = cudf::test::to_host<int32_t>(merged->view().column(0)).first;
+	EXPECT_EQ(500, keys.size());
+	EXPECT_EQ(50, std::count(keys.begin(), keys.end(), 1));
+	EXPECT_EQ(450, std::count(keys.begin(), keys.end(), 2));
+}
+
+TEST_F(HeavyHittersTest, KeyThatIsHotOnlyInALaterBatchIsDetected) {
+	// the first batch has uniform keys, the hot key only shows up in the next ones
+	std::vector<std::vector<int32_t>> batches_keys(4, std::vector<int32_t>(20000));
+	std::iota(batches_keys[0].begin(), batches_keys[0].end(), 1000);
+	for(std::size_t batch = 1; batch < batches_keys.size(); batch++) {
+		for(std::size_t row = 0; row < batches_keys[batch].size(); row++) {
+			batches_keys[batch][row] = row % 2 == 0 ? 7 : static_cast<int32_t>(100000 * batch + row);
+		}
+	}
+
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> samples;
+	std::vector<ral::frame::BlazingTableView> sample_views;
+	std::vector<int64_t> num_rows;
+	for(auto & keys : batches_keys) {
+		cudf::test::fixed_width_column_wrapper<int32_t> key_column(keys.begin(), keys.end());
+		CudfTableView table_view{{key_column}};
+		samples.push_back(ral::distribution::sampleKeys(ral::frame::BlazingTableView(table_view, {"key"}), 0, 10000));
+		sample_views.push_back(samples.back()->toBlazingTableView());
+		num_rows.push_back(keys.size());
+	}
+	std::unique_ptr<ral::frame::BlazingTable> merged = ral::distribution::mergeKeySamples(sample_views, num_rows, 10000);
+	std::unique_ptr<ral::frame::BlazingTable> counts = ral::distribution::sampleKeyCounts(merged->toBlazingTableView(), 0, merged->num_rows());
+
+	std::unique_ptr<ral::frame::BlazingTable> heavy_hitters;
+	double max_share;
+	std::tie(heavy_hitters, max_share) = ral::distribution::selectHeavyHitters(
+		{counts->toBlazingTableView()}, merged->num_rows(), 4, 0.5);
+
+	// key 7 holds 3/8 of the rows, a sample of the first batch alone would not have it
+	ASSERT_EQ(1, heavy_hitters->num_rows());
+	EXPECT_EQ(7, cudf::test::to_host<int32_t>(heavy_hitters->view().column(0)).first[0]);
+	EXPECT_NEAR(0.375, max_share, 0.05);
+}
+
+TEST_F(HeavyHittersTest, UnionKeys) {
+	cudf::test::fixed_width_column_wrapper<int32_t> keys1{{1, 2, 3}};
+	cudf::test::fixed_width_column_wrapper<int32_t> keys2{{3, 4}, {1, 1}};
+	cudf::test::fixed_width_column_wrapper<int32_t> keys3{{5, 0}, {1, 0}};
+	CudfTableView view1{{keys1}}, view2{{keys2}}, view3{{keys3}};
+	std::vector<ral::frame::BlazingTableView> keys_views{
+		ral::frame::BlazingTableView(view1, {"key"}),
+		ral::frame::BlazingTableView(view2, {"key"}),
+		ral::frame::BlazingTableView(view3, {"key"})};
+
+	std::unique_ptr<ral::frame::BlazingTable> keys = ral::distribution::unionKeys(keys_views, 100);
+
+	// the null key is not a key
+	std::vector<int32_t> host_keys = cudf::test::to_host<int32_t>(keys->view().column(0)).first;
+	std::sort(host_keys.begin(), host_keys.end());
+	EXPECT_EQ(std::vector<int32_t>({1, 2, 3, 4, 5}), host_keys);
+
+	EXPECT_EQ(2, ral::distribution::unionKeys(keys_views, 2)->num_rows());
+}
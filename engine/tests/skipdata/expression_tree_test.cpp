@@ -16,12 +16,12 @@ struct ExpressionTreeTest : public ::testing::Test {
   
   }
 
-  void process(std::string prefix, std::string expected, bool valid_expr = true) {
+  void process(std::string prefix, std::string expected, bool valid_expr = true, int num_columns = -1) {
     ral::parser::parse_tree tree;
     tree.build(prefix);
       std::cout << "before:\n";
       tree.print();
-      tree.apply_skip_data_rules();
+      tree.apply_skip_data_rules(num_columns);
       std::cout << "after:\n";
       tree.print();
       auto solution =  tree.prefix();
@@ -129,6 +129,50 @@ TEST_F(ExpressionTreeTest, expr_test_9) {
   process(prefix, expected, valid_expr);
 }
 
+TEST_F(ExpressionTreeTest, string_equal) {
+  std::string prefix = "=($1, 'PE')";
+  std::string expected = "AND <= $2 'PE' >= $3 'PE'";
+  process(prefix, expected);
+}
+
+TEST_F(ExpressionTreeTest, string_range) {
+  std::string prefix = "AND(>=($0, 'A100'), <($0, 'B'))";
+  std::string expected = "AND >= $1 'A100' < $0 'B'";
+  process(prefix, expected);
+}
+
+TEST_F(ExpressionTreeTest, string_in) {
+  // calcite expands IN into the equalities
+  std::string prefix = "OR(=($0, 'AR'), =($0, 'PE'))";
+  std::string expected = "OR AND <= $0 'AR' >= $1 'AR' AND <= $0 'PE' >= $1 'PE'";
+  process(prefix, expected);
+}
+
+TEST_F(ExpressionTreeTest, is_null) {
+  // two columns, so the number of rows is $4 and the null counts are $5 and $6
+  std::string prefix = "IS_NULL($1)";
+  std::string expected = "<> $6 0";
+  process(prefix, expected, true, 2);
+}
+
+TEST_F(ExpressionTreeTest, is_not_null) {
+  std::string prefix = "AND(IS_NOT_NULL($0), >($1, 10))";
+  std::string expected = "AND <> $5 $4 > $3 10";
+  process(prefix, expected, true, 2);
+}
+
+TEST_F(ExpressionTreeTest, is_null_without_null_counts) {
+  std::string prefix = "AND(IS_NULL($0), >($1, 10))";
+  std::string expected = "> $3 10";
+  process(prefix, expected);
+}
+
+TEST_F(ExpressionTreeTest, is_null_of_expression) {
+  std::string prefix = "OR(IS_NULL(+($0, $1)), >($1, 10))";
+  std::string expected = "";
+  process(prefix, expected, true, 2);
+}
+
 TEST_F(ExpressionTreeTest, drop_test1) {
   std::string prefix = "OR(AND(AND(>($0, 100), =(+($0, $1), 123)), <($1, 10)), =($0, 500))";
   std::string expected = "OR > $1 100 AND <= $0 500 >= $1 500";
@@ -205,3 +249,43 @@ TEST_F(ExpressionTreeTest, drop_test3) {
     EXPECT_EQ(solution, expected);
 
 }
+
+TEST_F(ExpressionTreeTest, equality_values) {
+  auto values = get_equality_values(
+      "AND(=($0, 5), OR(=($2, 'PE'), =($2, 'BR')), >($1, 3), =($3, $1))");
+  std::map<int, std::vector<std::string>> expected = {
+      {0, {"5"}}, {2, {"'PE'", "'BR'"}}};
+  EXPECT_EQ(values, expected);
+}
+
+TEST_F(ExpressionTreeTest, equality_values_of_other_columns) {
+  auto values = get_equality_values("OR(=($0, 5), =($1, 6))");
+  EXPECT_TRUE(values.empty());
+
+  values = get_equality_values("OR(=($0, 5), >($0, 6))");
+  EXPECT_TRUE(values.empty());
+
+  values = get_equality_values("=(+($0, 1), 5)");
+  EXPECT_TRUE(values.empty());
+}
+
+TEST_F(ExpressionTreeTest, column_bounds) {
+  auto bounds = get_column_bounds(
+      "AND(>=($0, 10), <($0, 20), <(15, $0), =($1, 3), <($2, $3), >($4, 'a'))");
+  ASSERT_EQ(bounds.size(), 2);
+
+  EXPECT_EQ(bounds[0].lower, "15");
+  EXPECT_FALSE(bounds[0].lower_inclusive);
+  EXPECT_EQ(bounds[0].upper, "20");
+  EXPECT_FALSE(bounds[0].upper_inclusive);
+
+  EXPECT_EQ(bounds[1].lower, "3");
+  EXPECT_TRUE(bounds[1].lower_inclusive);
+  EXPECT_EQ(bounds[1].upper, "3");
+  EXPECT_TRUE(bounds[1].upper_inclusive);
+}
+
+TEST_F(ExpressionTreeTest, column_bounds_of_disjunctions) {
+  auto bounds = get_column_bounds("OR(>($0, 5), <($0, 2))");
+  EXPECT_TRUE(bounds.empty());
+}
@@ -0,0 +1,254 @@
+#include <from_cudf/cpp_tests/utilities/column_utilities.hpp>
+#include <from_cudf/cpp_tests/utilities/column_wrapper.hpp>
+
+#include <cudf/utilities/bit.hpp>
+
+#include "execution_graph/logic_controllers/BatchOrderByProcessing.h"
+#include "operators/OrderBy.h"
+#include "parser/physical_plan.hpp"
+#include "utilities/CommonOperations.h"
+#include "../BlazingUnitTest.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+
+namespace {
+
+// A row of the tables of these tests. key0 can be null, id is unique, so a row of the output tells which input row it is
+struct row {
+	bool key0_valid;
+	int32_t key0;
+	int32_t key1;
+	int32_t id;
+};
+
+std::unique_ptr<ral::frame::BlazingTable> make_table(const std::vector<row> & rows) {
+	std::vector<int32_t> key0, key1, id;
+	std::vector<bool> key0_valid;
+	for(auto & r : rows) {
+		key0.push_back(r.key0);
+		key0_valid.push_back(r.key0_valid);
+		key1.push_back(r.key1);
+		id.push_back(r.id);
+	}
+	cudf::test::fixed_width_column_wrapper<int32_t> key0_column(key0.begin(), key0.end(), key0_valid.begin());
+	cudf::test::fixed_width_column_wrapper<int32_t> key1_column(key1.begin(), key1.end());
+	cudf::test::fixed_width_column_wrapper<int32_t> id_column(id.begin(), id.end());
+	CudfTableView view{{key0_column, key1_column, id_column}};
+	return ral::frame::BlazingTableView(view, {"key0", "key1", "id"}).clone();
+}
+
+std::vector<row> to_rows(const ral::frame::BlazingTableView & table) {
+	auto key0 = cudf::test::to_host<int32_t>(table.view().column(0));
+	auto key1 = cudf::test::to_host<int32_t>(table.view().column(1)).first;
+	auto id = cudf::test::to_host<int32_t>(table.view().column(2)).first;
+	std::vector<row> rows;
+	for(cudf::size_type i = 0; i < table.num_rows(); i++) {
+		bool valid = key0.second.empty() || cudf::bit_is_set(key0.second.data(), i);
+		rows.push_back(row{valid, key0.first[i], key1[i], id[i]});
+	}
+	return rows;
+}
+
+// The order of the sort kernels, a null is bigger than any value, so it goes last when ascending and first when descending
+bool goes_before(const row & a, const row & b, const ral::operators::sort_spec & sort) {
+	for(size_t k = 0; k < sort.columns.size(); k++) {
+		int compare;
+		if(sort.columns[k] == 0) {
+			if(a.key0_valid != b.key0_valid) {
+				compare = a.key0_valid ? -1 : 1;
+			} else {
+				compare = !a.key0_valid ? 0 : (a.key0 < b.key0 ? -1 : (a.key0 > b.key0 ? 1 : 0));
+			}
+		} else {
+			int32_t a_key = sort.columns[k] == 1 ? a.key1 : a.id;
+			int32_t b_key = sort.columns[k] == 1 ? b.key1 : b.id;
+			compare = a_key < b_key ? -1 : (a_key > b_key ? 1 : 0);
+		}
+		if(sort.orders[k] == cudf::order::DESCENDING) {
+			compare = -compare;
+		}
+		if(compare != 0) {
+			return compare < 0;
+		}
+	}
+	return false;
+}
+
+bool same_keys(const row & a, const row & b, const ral::operators::sort_spec & sort) {
+	return !goes_before(a, b, sort) && !goes_before(b, a, sort);
+}
+
+// The output has to be the first rows of the input in the order of the sort. When the rows at the cut-off tie on the
+// keys any of them can be kept, so the rows are compared by their keys, and every output row has to be an input row
+void expect_top_rows(const std::vector<row> & input, const ral::frame::BlazingTableView & output, const ral::operators::sort_spec & sort) {
+	std::vector<row> expected = input;
+	std::stable_sort(expected.begin(), expected.end(), [&sort](const row & a, const row & b) { return goes_before(a, b, sort); });
+	expected.resize(std::min<size_t>(expected.size(), sort.limit));
+
+	std::vector<row> rows = to_rows(output);
+	ASSERT_EQ(expected.size(), rows.size());
+	std::set<int32_t> ids;
+	for(size_t i = 0; i < rows.size(); i++) {
+		EXPECT_TRUE(same_keys(expected[i], rows[i], sort)) << "row " << i << " has id " << rows[i].id << " instead of " << expected[i].id;
+		auto input_row = std::find_if(input.begin(), input.end(), [&rows, i](const row & r) { return r.id == rows[i].id; });
+		ASSERT_NE(input_row, input.end());
+		EXPECT_TRUE(same_keys(*input_row, rows[i], sort));
+		EXPECT_EQ(input_row->key0_valid, rows[i].key0_valid);
+		EXPECT_TRUE(ids.insert(rows[i].id).second) << "row " << rows[i].id << " is repeated";
+	}
+}
+
+std::vector<row> random_rows(int num_rows, int num_keys, double null_ratio, unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int32_t> key_distribution(0, num_keys - 1);
+	std::bernoulli_distribution null_distribution(null_ratio);
+	std::vector<row> rows;
+	for(int i = 0; i < num_rows; i++) {
+		rows.push_back(row{!null_distribution(generator), key_distribution(generator), key_distribution(generator), i});
+	}
+	return rows;
+}
+
+}  // namespace
+
+struct TopNTest : public BlazingUnitTest {
+	TopNTest() {
+		nodes.push_back(Node(Address::TCP("127.0.0.1", 8089, 0)));
+		context = std::make_shared<Context>(0, nodes, nodes[0], "", std::map<std::string, std::string>());
+	}
+
+	// Runs a TopNKernel of a single node over the batches, which are split from the rows, and returns its output
+	std::unique_ptr<ral::frame::BlazingTable> run_top_n_kernel(const std::string & plan, const std::vector<row> & rows, size_t batch_rows) {
+		auto node = ral::parser::parse_plan_node(plan);
+		ral::batch::TopNKernel top_n_kernel(*node, context, nullptr);
+		top_n_kernel.set_type_id(ral::cache::kernel_type::TopNKernel);
+
+		auto input = ral::cache::create_cache_machine(ral::cache::cache_settings{.type = ral::cache::CacheType::SIMPLE});
+		auto output = ral::cache::create_cache_machine(ral::cache::cache_settings{.type = ral::cache::CacheType::SIMPLE});
+		top_n_kernel.input_.register_cache(std::to_string(top_n_kernel.get_id()), input);
+		top_n_kernel.output_.register_cache(std::to_string(top_n_kernel.get_id()), output);
+
+		for(size_t start = 0; start < rows.size(); start += batch_rows) {
+			std::vector<row> batch(rows.begin() + start, rows.begin() + std::min(rows.size(), start + batch_rows));
+			input->addToCache(make_table(batch), "", context.get());
+		}
+		input->finish();
+
+		EXPECT_EQ(top_n_kernel.run(), ral::cache::kstatus::proceed);
+		output->finish();
+
+		std::vector<std::unique_ptr<ral::frame::BlazingTable>> batches;
+		std::vector<ral::frame::BlazingTableView> views;
+		while(output->wait_for_next()) {
+			batches.push_back(output->pullFromCache(context.get()));
+			views.push_back(batches.back()->toBlazingTableView());
+		}
+		EXPECT_EQ(1, batches.size());
+		return ral::utilities::concatTables(views);
+	}
+
+	std::vector<Node> nodes;
+	std::shared_ptr<Context> context;
+};
+
+TEST_F(TopNTest, TiesAtTheCutOff) {
+	// 50 rows of each key, the cut-off is in the middle of the rows of key 1
+	std::vector<row> rows;
+	for(int i = 0; i < 200; i++) {
+		rows.push_back(row{true, (i * 7) % 4, 0, i});
+	}
+	std::string plan = "LogicalTopN(sort0=[$0], dir0=[ASC], fetch=[75])";
+	auto output = run_top_n_kernel(plan, rows, 30);
+	expect_top_rows(rows, output->toBlazingTableView(), ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan)));
+}
+
+TEST_F(TopNTest, NullsGoLastWhenAscending) {
+	std::vector<row> rows = random_rows(500, 20, 0.3, 1);
+	std::string plan = "LogicalTopN(sort0=[$0], sort1=[$2], dir0=[ASC], dir1=[ASC], fetch=[400])";
+	auto output = run_top_n_kernel(plan, rows, 64);
+
+	// there are about 150 nulls, so the last rows of the output are nulls and the first ones are not
+	std::vector<row> output_rows = to_rows(output->toBlazingTableView());
+	EXPECT_TRUE(output_rows.front().key0_valid);
+	EXPECT_FALSE(output_rows.back().key0_valid);
+	expect_top_rows(rows, output->toBlazingTableView(), ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan)));
+}
+
+TEST_F(TopNTest, NullsGoFirstWhenDescending) {
+	std::vector<row> rows = random_rows(500, 20, 0.1, 2);
+	std::string plan = "LogicalTopN(sort0=[$0], sort1=[$2], dir0=[DESC], dir1=[ASC], fetch=[100])";
+	auto output = run_top_n_kernel(plan, rows, 64);
+
+	std::vector<row> output_rows = to_rows(output->toBlazingTableView());
+	EXPECT_FALSE(output_rows.front().key0_valid);
+	EXPECT_TRUE(output_rows.back().key0_valid);
+	expect_top_rows(rows, output->toBlazingTableView(), ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan)));
+}
+
+TEST_F(TopNTest, MixedAscendingAndDescendingKeys) {
+	std::vector<row> rows = random_rows(1000, 10, 0.05, 3);
+	std::string plan = "LogicalTopN(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC], fetch=[250])";
+	auto output = run_top_n_kernel(plan, rows, 100);
+	expect_top_rows(rows, output->toBlazingTableView(), ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan)));
+}
+
+TEST_F(TopNTest, LimitLargerThanTheInput) {
+	std::vector<row> rows = random_rows(90, 30, 0.1, 4);
+	std::string plan = "LogicalTopN(sort0=[$0], sort1=[$1], dir0=[ASC], dir1=[DESC], fetch=[1000])";
+	auto output = run_top_n_kernel(plan, rows, 40);
+
+	// every row comes out, sorted
+	EXPECT_EQ(rows.size(), output->num_rows());
+	expect_top_rows(rows, output->toBlazingTableView(), ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan)));
+}
+
+TEST_F(TopNTest, EmptyBatches) {
+	std::vector<row> rows = random_rows(100, 10, 0.1, 5);
+	std::string plan = "LogicalTopN(sort0=[$0], dir0=[ASC], fetch=[10])";
+	auto node = ral::parser::parse_plan_node(plan);
+	ral::operators::sort_spec sort = ral::operators::get_sort_spec(*node);
+
+	std::unique_ptr<ral::frame::BlazingTable> empty = make_table({});
+	std::unique_ptr<ral::frame::BlazingTable> batch = make_table(rows);
+	std::unique_ptr<ral::frame::BlazingTable> candidates = ral::operators::top_n({empty->toBlazingTableView()}, sort, sort.limit);
+	EXPECT_EQ(0, candidates->num_rows());
+	EXPECT_EQ(3, candidates->num_columns());
+
+	candidates = ral::operators::top_n({batch->toBlazingTableView(), candidates->toBlazingTableView()}, sort, sort.limit);
+	expect_top_rows(rows, candidates->toBlazingTableView(), sort);
+}
+
+// The master merges the candidates of every node with top_n. A node without any input batch sends candidates without columns
+TEST_F(TopNTest, MergesTheCandidatesOfEveryNode) {
+	std::string plan = "LogicalTopN(sort0=[$1], sort1=[$0], dir0=[ASC], dir1=[DESC], fetch=[120])";
+	ral::operators::sort_spec sort = ral::operators::get_sort_spec(*ral::parser::parse_plan_node(plan));
+
+	std::vector<row> all_rows;
+	std::vector<std::unique_ptr<ral::frame::BlazingTable>> node_candidates;
+	for(int node = 0; node < 3; node++) {
+		std::vector<row> node_rows = random_rows(400, 50, 0.1, 10 + node);
+		for(auto & r : node_rows) {
+			r.id += node * 1000;
+		}
+		all_rows.insert(all_rows.end(), node_rows.begin(), node_rows.end());
+		node_candidates.push_back(run_top_n_kernel(plan, node_rows, 70));
+	}
+	node_candidates.push_back(ral::frame::createEmptyBlazingTable(std::vector<cudf::type_id>(), std::vector<std::string>()));
+
+	std::vector<ral::frame::BlazingTableView> candidates_views;
+	for(auto & candidates : node_candidates) {
+		candidates_views.push_back(candidates->toBlazingTableView());
+	}
+	std::unique_ptr<ral::frame::BlazingTable> merged = ral::operators::top_n(candidates_views, sort, sort.limit);
+	expect_top_rows(all_rows, merged->toBlazingTableView(), sort);
+
+	// with no node having input there are no columns either
+	std::unique_ptr<ral::frame::BlazingTable> nothing = ral::operators::top_n({candidates_views.back()}, sort, sort.limit);
+	EXPECT_EQ(0, nothing->num_columns());
+}
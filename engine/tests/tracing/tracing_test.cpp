@@ -0,0 +1,89 @@
+#include "utilities/Tracing.h"
+#include "../BlazingUnitTest.h"
+
+#include <thread>
+
+using namespace ral::utilities;
+
+struct TracingTest : public BlazingUnitTest {};
+
+static size_t count_occurrences(const std::string & text, const std::string & pattern) {
+	size_t count = 0;
+	for(size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+		count++;
+	}
+	return count;
+}
+
+TEST_F(TracingTest, NothingIsRecordedWhenTheQueryIsNotTraced) {
+	{
+		trace_span span("kernel", "ProjectKernel", 101);
+	}
+	EXPECT_FALSE(is_tracing_enabled());
+	EXPECT_EQ(count_occurrences(get_query_trace_json(101, 0), "\"ph\":\"X\""), 0);
+}
+
+TEST_F(TracingTest, SpansOfEveryThreadAreExportedByQuery) {
+	ASSERT_TRUE(start_query_trace(7));
+	ASSERT_TRUE(start_query_trace(8));
+
+	std::thread first([] {
+		scoped_trace_query trace_query(7);
+		trace_span span("kernel", "FilterKernel", NO_TRACE_QUERY, "kernel_id", 3);
+		trace_instant("cache", "spill_to_host", NO_TRACE_QUERY, "bytes", 1024);
+	});
+	std::thread second([] {
+		trace_span span("distribution", "distributeTablePartitions", 7);
+		trace_span other_query_span("kernel", "ProjectKernel", 8);
+	});
+	first.join();
+	second.join();
+
+	std::string json = get_query_trace_json(7, 2);
+	EXPECT_EQ(count_occurrences(json, "\"ph\":\"X\""), 2);
+	EXPECT_EQ(count_occurrences(json, "\"ph\":\"i\""), 1);
+	EXPECT_EQ(count_occurrences(json, "\"pid\":2"), 4);
+	EXPECT_NE(json.find("\"args\":{\"kernel_id\":3}"), std::string::npos);
+	EXPECT_NE(json.find("\"args\":{\"bytes\":1024}"), std::string::npos);
+	EXPECT_EQ(json.find("ProjectKernel"), std::string::npos);
+
+	stop_query_trace(7);
+	EXPECT_TRUE(is_tracing_enabled());
+	EXPECT_NE(get_query_trace_json(8, 2).find("ProjectKernel"), std::string::npos);
+
+	stop_query_trace(8);
+	EXPECT_FALSE(is_tracing_enabled());
+}
+
+TEST_F(TracingTest, OnlyTheNewestSpansOfAThreadAreKept) {
+	ASSERT_TRUE(start_query_trace(9));
+	std::thread recorder([] {
+		for(int i = 0; i < (1 << 15); i++) {
+			trace_instant("cache", "spill_to_disk", 9, "batch", i);
+		}
+	});
+	recorder.join();
+
+	std::string json = get_query_trace_json(9, 0);
+	EXPECT_EQ(count_occurrences(json, "\"ph\":\"i\""), 1 << 14);
+	EXPECT_EQ(json.find("\"args\":{\"batch\":0}"), std::string::npos);
+	EXPECT_NE(json.find("\"args\":{\"batch\":32767}"), std::string::npos);
+	stop_query_trace(9);
+}
+
+TEST_F(TracingTest, ThreadsOfAKernelInheritItsQuery) {
+	ASSERT_TRUE(start_query_trace(10));
+	std::thread kernel([] {
+		scoped_trace_query trace_query(10);
+		std::thread spawned(with_trace_query([](int batch) {
+			trace_instant("cache", "spill_to_host", NO_TRACE_QUERY, "batch", batch);
+		}), 5);
+		spawned.join();
+	});
+	kernel.join();
+
+	std::string json = get_query_trace_json(10, 0);
+	EXPECT_NE(json.find("\"args\":{\"batch\":5}"), std::string::npos);
+	EXPECT_EQ(get_thread_trace_query(), NO_TRACE_QUERY);
+	stop_query_trace(10);
+}
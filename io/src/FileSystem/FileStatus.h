@@ -15,6 +15,11 @@ class FileStatus {
 public:
 	FileStatus();
 	FileStatus(const Uri & uri, FileType fileType, unsigned long long fileSize);
+	FileStatus(const Uri & uri,
+		FileType fileType,
+		unsigned long long fileSize,
+		unsigned long long modificationTime,
+		const std::string & eTag);
 	FileStatus(const FileStatus & other);
 	FileStatus(FileStatus && other);
 	~FileStatus();
@@ -22,6 +27,10 @@ public:
 	Uri getUri() const noexcept;
 	FileType getFileType() const noexcept;
 	unsigned long long getFileSize() const noexcept;
+	// milliseconds since the epoch, 0 when the file system does not report it
+	unsigned long long getModificationTime() const noexcept;
+	// version tag of the object in object stores (S3 ETag, GCS etag), empty otherwise
+	std::string getETag() const noexcept;
 
 	// Helpers
 	bool isFile() const noexcept;
@@ -41,7 +50,6 @@ public:
 
 	 unsigned long long getBlockSize() const noexcept;
 
-	 unsigned long long getModificationTime() const noexcept;
 	 unsigned long long getAccessTime() const noexcept;
 
 	 std::string getOwner() const noexcept;
@@ -52,6 +60,8 @@ private:
 	Uri uri;
 	FileType fileType;
 	unsigned long long fileSize;
+	unsigned long long modificationTime;
+	std::string eTag;
 };
 
 #endif /* _BLAZING_FILE_STATUS_H_ */
@@ -144,7 +144,13 @@ FileStatus HadoopFileSystem::Private::getFileStatus(const Uri & uri) const {
 		default: fileType = FileType::UNDEFINED; break;
 		}
 
-		return FileStatus(uri, fileType, stat_buf.size);
+		unsigned long long modificationTime = 0;
+		arrow::io::HdfsPathInfo path_info;
+		if(fileType == FileType::FILE && this->hdfs->GetPathInfo(path.toString(), &path_info).ok()) {
+			modificationTime = path_info.last_modified_time * 1000ull;  // HDFS reports seconds
+		}
+
+		return FileStatus(uri, fileType, stat_buf.size, modificationTime, "");
 	} else {
 		// TODO percy error handling
 	}
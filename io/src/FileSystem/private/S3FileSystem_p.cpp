@@ -346,12 +346,13 @@ FileStatus S3FileSystem::Private::getFileStatus(const Uri & uri) const {
 
 		std::string contentType = result.GetContentType();
 		long long contentLength = result.GetContentLength();
+		const unsigned long long modificationTime = result.GetLastModified().Millis();
 
 		if(objectKey[objectKey.size() - 1] == '/' || contentType == "application/x-directory") {
 			const FileStatus fileStatus(uri, FileType::DIRECTORY, contentLength);
 			return fileStatus;
 		} else {
-			const FileStatus fileStatus(uri, FileType::FILE, contentLength);
+			const FileStatus fileStatus(uri, FileType::FILE, contentLength, modificationTime, result.GetETag());
 			return fileStatus;
 		}
 	} else {
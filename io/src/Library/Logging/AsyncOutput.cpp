@@ -0,0 +1,149 @@
+#include "Library/Logging/AsyncOutput.h"
+#include <cstddef>
+
+namespace Library {
+namespace Logging {
+namespace {
+// A log that the writer misses to wake up for is written after this time at most
+const std::chrono::milliseconds WRITER_WAIT_TIME(100);
+}  // namespace
+
+AsyncOutput::AsyncOutput(GenericOutput * output, size_t capacity, size_t maxBatchSize)
+	: output{output}, enqueuePosition{0}, dequeuePosition{0}, isActive{true}, isConsumerWaiting{false},
+	  fullRingWaits{0}, maxBatchSize{maxBatchSize}, lastSecond{-1} {
+	size_t size = 2;
+	while(size < capacity) {
+		size <<= 1;
+	}
+	ring = std::vector<Slot>(size);
+	mask = size - 1;
+	for(size_t position = 0; position < size; ++position) {
+		ring[position].sequence.store(position, std::memory_order_relaxed);
+	}
+
+	thread = std::thread(&AsyncOutput::doOnConsumer, this);
+}
+
+AsyncOutput::~AsyncOutput() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		isActive = false;
+		condition.notify_one();
+	}
+
+	if(thread.joinable()) {
+		thread.join();
+	}
+}
+
+size_t AsyncOutput::getFullRingWaits() const { return fullRingWaits.load(std::memory_order_relaxed); }
+
+void AsyncOutput::flush(std::string && log) {
+	LogRecord record;
+	record.message = std::move(log);
+	doOnProducer(true, std::move(record));
+}
+
+void AsyncOutput::flush(const std::string & log) {
+	LogRecord record;
+	record.message = log;
+	doOnProducer(true, std::move(record));
+}
+
+void AsyncOutput::flush(
+	const int nodeInd, const std::string & datetime, const std::string & level, const std::string & log) {
+	LogRecord record;
+	record.message = datetime + "|" + std::to_string(nodeInd) + "|" + level + "|" + log;
+	doOnProducer(true, std::move(record));
+}
+
+void AsyncOutput::flush(LogRecord && record) { doOnProducer(false, std::move(record)); }
+
+void AsyncOutput::doOnProducer(bool isFormatted, LogRecord && record) {
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	Slot * slot;
+	while(true) {
+		slot = &ring[position & mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+		if(difference == 0) {
+			if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if(difference < 0) {
+			// the ring is full, the writer has to free the slot of this position
+			fullRingWaits.fetch_add(1, std::memory_order_relaxed);
+			condition.notify_one();
+			std::this_thread::yield();
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		} else {
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->isFormatted = isFormatted;
+	slot->record = std::move(record);
+	slot->sequence.store(position + 1, std::memory_order_release);
+
+	// only wake up the writer when it sleeps, the fence orders the publication with the check of the flag
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(isConsumerWaiting.load(std::memory_order_relaxed)) {
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.notify_one();
+	}
+}
+
+void AsyncOutput::doOnConsumer() {
+	std::string batch;
+	while(true) {
+		batch.clear();
+		if(processLogData(batch) > 0) {
+			output->flush(batch);
+			continue;
+		}
+
+		if(!isActive) {
+			break;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		isConsumerWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!hasLogData() && isActive) {
+			condition.wait_for(lock, WRITER_WAIT_TIME);
+		}
+		isConsumerWaiting.store(false, std::memory_order_relaxed);
+	}
+}
+
+bool AsyncOutput::hasLogData() const {
+	return ring[dequeuePosition & mask].sequence.load(std::memory_order_acquire) == dequeuePosition + 1;
+}
+
+size_t AsyncOutput::processLogData(std::string & batch) {
+	size_t counter = 0;
+	while(counter < maxBatchSize && hasLogData()) {
+		Slot & slot = ring[dequeuePosition & mask];
+		if(counter > 0) {
+			batch += '\n';
+		}
+		if(slot.isFormatted) {
+			batch += slot.record.message;
+		} else {
+			std::time_t second = std::chrono::system_clock::to_time_t(slot.record.time);
+			if(second != lastSecond) {
+				lastSecond = second;
+				lastDatetime = formatLogTime(slot.record.time);
+			}
+			appendLogRecord(batch, lastDatetime, slot.record);
+		}
+		slot.record.message.clear();
+		slot.record.fields.clear();
+		slot.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+		++dequeuePosition;
+		++counter;
+	}
+	return counter;
+}
+}  // namespace Logging
+}  // namespace Library
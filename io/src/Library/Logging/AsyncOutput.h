@@ -0,0 +1,92 @@
+#ifndef SRC_LIBRARY_LOGGING_ASYNCOUTPUT_H_
+#define SRC_LIBRARY_LOGGING_ASYNCOUTPUT_H_
+
+#include "Library/Logging/GenericOutput.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Library {
+namespace Logging {
+// Writes the logs of another output from a background thread. The threads that log only move their record into a
+// lock-free ring, the writer formats the records and gives them to the output in batches of lines, so that the output
+// takes its lock and flushes once per batch instead of once per line
+class AsyncOutput : public GenericOutput {
+public:
+	// Takes the ownership of the output. The capacity of the ring is rounded up to a power of two, and a batch has at
+	// most maxBatchSize lines
+	AsyncOutput(GenericOutput * output, size_t capacity = 1 << 16, size_t maxBatchSize = 1024);
+
+	// Writes what is left in the ring
+	~AsyncOutput();
+
+public:
+	AsyncOutput(AsyncOutput &&) = delete;
+
+	AsyncOutput(const AsyncOutput &) = delete;
+
+	AsyncOutput & operator=(AsyncOutput &&) = delete;
+
+	AsyncOutput & operator=(const AsyncOutput &) = delete;
+
+public:
+	// How many times a thread found the ring full and had to wait for the writer
+	size_t getFullRingWaits() const;
+
+public:
+	void flush(std::string && log) override;
+
+	void flush(const std::string & log) override;
+
+	void flush(
+		const int nodeInd, const std::string & datetime, const std::string & level, const std::string & log) override;
+
+	void flush(LogRecord && record) override;
+
+private:
+	// A slot of the ring. Its sequence says if it can be written (position) or read (position + 1) for the lap of
+	// the ring of a position. The message of a formatted record is the whole line
+	struct Slot {
+		std::atomic<size_t> sequence;
+		bool isFormatted;
+		LogRecord record;
+	};
+
+	void doOnProducer(bool isFormatted, LogRecord && record);
+
+	void doOnConsumer();
+
+	bool hasLogData() const;
+
+	// Moves up to the max batch size of lines to the batch, returns how many
+	size_t processLogData(std::string & batch);
+
+private:
+	std::unique_ptr<GenericOutput> output;
+
+	std::vector<Slot> ring;
+	size_t mask;
+	std::atomic<size_t> enqueuePosition;
+	size_t dequeuePosition;
+
+private:
+	std::atomic<bool> isActive;
+	std::atomic<bool> isConsumerWaiting;
+	std::atomic<size_t> fullRingWaits;
+	std::mutex mutex;
+	std::condition_variable condition;
+	const size_t maxBatchSize;
+	std::thread thread;
+
+private:
+	// the datetime of the second of the last record, most records of a batch share it
+	std::time_t lastSecond;
+	std::string lastDatetime;
+};
+}  // namespace Logging
+}  // namespace Library
+
+#endif
@@ -1,8 +1,7 @@
 #include "Library/Logging/BlazingLogger.h"
 #include "Library/Logging/ServiceLogging.h"
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <utility>
 
 namespace Library {
 namespace Logging {
@@ -16,37 +15,58 @@ void BlazingLogger::log(std::string && logdata) { sendDataToService(logdata); }
 
 void BlazingLogger::log(const std::string & logdata) { sendDataToService(logdata); }
 
-void BlazingLogger::logInfo(std::string && logdata) { buildLogData(LoggingLevel::INFO, logdata); }
+void BlazingLogger::logInfo(std::string && logdata) { buildLogData(LoggingLevel::INFO, std::move(logdata)); }
 
 void BlazingLogger::logInfo(const std::string & logdata) { buildLogData(LoggingLevel::INFO, logdata); }
 
-void BlazingLogger::logWarn(std::string && logdata) { buildLogData(LoggingLevel::WARN, logdata); }
+void BlazingLogger::logWarn(std::string && logdata) { buildLogData(LoggingLevel::WARN, std::move(logdata)); }
 
 void BlazingLogger::logWarn(const std::string & logdata) { buildLogData(LoggingLevel::WARN, logdata); }
 
-void BlazingLogger::logTrace(std::string && logdata) { buildLogData(LoggingLevel::TRACE, logdata); }
+void BlazingLogger::logTrace(std::string && logdata) { buildLogData(LoggingLevel::TRACE, std::move(logdata)); }
 
 void BlazingLogger::logTrace(const std::string & logdata) { buildLogData(LoggingLevel::TRACE, logdata); }
 
-void BlazingLogger::logDebug(std::string && logdata) { buildLogData(LoggingLevel::DEBUG, logdata); }
+void BlazingLogger::logDebug(std::string && logdata) { buildLogData(LoggingLevel::DEBUG, std::move(logdata)); }
 
 void BlazingLogger::logDebug(const std::string & logdata) { buildLogData(LoggingLevel::DEBUG, logdata); }
 
-void BlazingLogger::logError(std::string && logdata) { buildLogData(LoggingLevel::ERROR, logdata); }
+void BlazingLogger::logError(std::string && logdata) { buildLogData(LoggingLevel::ERROR, std::move(logdata)); }
 
 void BlazingLogger::logError(const std::string & logdata) { buildLogData(LoggingLevel::ERROR, logdata); }
 
-void BlazingLogger::logFatal(std::string && logdata) { buildLogData(LoggingLevel::FATAL, logdata); }
+void BlazingLogger::logFatal(std::string && logdata) { buildLogData(LoggingLevel::FATAL, std::move(logdata)); }
 
 void BlazingLogger::logFatal(const std::string & logdata) { buildLogData(LoggingLevel::FATAL, logdata); }
 
+void BlazingLogger::logFields(LoggingLevel level, const std::string & logdata, std::vector<LogField> && fields) {
+	if(isEnabled(level)) {
+		sendRecordToService(level, std::string(logdata), std::move(fields));
+	}
+}
+
+bool BlazingLogger::isEnabled(LoggingLevel level) { return ServiceLogging::getInstance().isLogLevelEnabled(level); }
+
+void BlazingLogger::buildLogData(LoggingLevel level, std::string && logdata) {
+	if(isEnabled(level)) {
+		sendRecordToService(level, std::move(logdata), {});
+	}
+}
+
 void BlazingLogger::buildLogData(LoggingLevel level, const std::string & logdata) {
-	auto now = std::chrono::system_clock::now();
-	auto time = std::chrono::system_clock::to_time_t(now);
+	if(isEnabled(level)) {
+		sendRecordToService(level, std::string(logdata), {});
+	}
+}
 
-	std::ostringstream ss;
-	ss << std::put_time(std::localtime(&time), "%FT%TZ");
-	ServiceLogging::getInstance().setLogData(ss.str(), getLevelName(level), logdata);
+// The record is formatted by the output, so that an asynchronous one does it out of the thread that logs
+void BlazingLogger::sendRecordToService(LoggingLevel level, std::string && logdata, std::vector<LogField> && fields) {
+	LogRecord record;
+	record.time = std::chrono::system_clock::now();
+	record.level = level;
+	record.message = std::move(logdata);
+	record.fields = std::move(fields);
+	ServiceLogging::getInstance().setLogRecord(std::move(record));
 }
 
 void BlazingLogger::sendDataToService(const std::string & logdata) {
@@ -1,6 +1,7 @@
 #ifndef SRC_LIBRARY_LOGGING_BLAZINGLOGGER_H_
 #define SRC_LIBRARY_LOGGING_BLAZINGLOGGER_H_
 
+#include "Library/Logging/LogRecord.h"
 #include "Library/Logging/LoggingLevel.h"
 #include <string>
 
@@ -58,9 +59,19 @@ public:
 
 	void logFatal(const std::string & logdata);
 
+	// A log with key=value fields, for the tools that parse the logs
+	void logFields(LoggingLevel level, const std::string & logdata, std::vector<LogField> && fields);
+
+	// To skip building the message of a log that would be dropped
+	bool isEnabled(LoggingLevel level);
+
 private:
+	void buildLogData(LoggingLevel level, std::string && logdata);
+
 	void buildLogData(LoggingLevel level, const std::string & logdata);
 
+	void sendRecordToService(LoggingLevel level, std::string && logdata, std::vector<LogField> && fields);
+
 	void sendDataToService(const std::string & logdata);
 };
 }  // namespace Logging
@@ -1,6 +1,7 @@
 #ifndef SRC_LIBRARY_LOGGING_GENERICOUTPUT_H_
 #define SRC_LIBRARY_LOGGING_GENERICOUTPUT_H_
 
+#include "Library/Logging/LogRecord.h"
 #include <string>
 
 namespace Library {
@@ -16,6 +17,9 @@ public:
 	virtual void flush(
 		const int nodeInd, const std::string & datetime, const std::string & level, const std::string & log) = 0;
 
+	// The outputs that do not format records themselves write them as a line
+	virtual void flush(LogRecord && record) { flush(formatLogRecord(record)); }
+
 	// virtual void setNodeIdentifier(const unsigned int nodeInd) = 0;
 };
 }  // namespace Logging
@@ -0,0 +1,58 @@
+#ifndef SRC_LIBRARY_LOGGING_LOGRECORD_H_
+#define SRC_LIBRARY_LOGGING_LOGRECORD_H_
+
+#include "Library/Logging/LoggingLevel.h"
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Library {
+namespace Logging {
+using LogField = std::pair<std::string, std::string>;
+
+// A log message that is not formatted yet, so that the thread that logs it only takes the time. The fields are
+// appended to the message as |key=value
+struct LogRecord {
+	std::chrono::system_clock::time_point time;
+	LoggingLevel level;
+	int nodeInd;
+	std::string message;
+	std::vector<LogField> fields;
+};
+
+inline std::string formatLogTime(const std::chrono::system_clock::time_point & time) {
+	std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+	std::tm local;
+	localtime_r(&seconds, &local);
+	char datetime[32];
+	return std::string(datetime, std::strftime(datetime, sizeof(datetime), "%FT%TZ", &local));
+}
+
+// Appends datetime|nodeInd|level|message|key=value..., the same line that the outputs write for a log with a level
+inline void appendLogRecord(std::string & line, const std::string & datetime, const LogRecord & record) {
+	line += datetime;
+	line += '|';
+	line += std::to_string(record.nodeInd);
+	line += '|';
+	line += getLevelName(record.level);
+	line += '|';
+	line += record.message;
+	for(const auto & field : record.fields) {
+		line += '|';
+		line += field.first;
+		line += '=';
+		line += field.second;
+	}
+}
+
+inline std::string formatLogRecord(const LogRecord & record) {
+	std::string line;
+	appendLogRecord(line, formatLogTime(record.time), record);
+	return line;
+}
+}  // namespace Logging
+}  // namespace Library
+
+#endif
@@ -6,6 +6,9 @@ namespace Logging {
 enum class LoggingLevel { INFO, WARN, TRACE, DEBUG, ERROR, FATAL };
 
 const char * getLevelName(LoggingLevel level);
+
+// The order of the levels from TRACE to FATAL, the enum values are not in that order
+int getLevelSeverity(LoggingLevel level);
 }  // namespace Logging
 }  // namespace Library
 
@@ -5,7 +5,7 @@
 
 namespace Library {
 namespace Logging {
-ServiceLogging::ServiceLogging() {
+ServiceLogging::ServiceLogging() : minLevelSeverity{getLevelSeverity(LoggingLevel::TRACE)} {
 	auto value = new Library::Logging::CoutOutput();
 	this->output = value;
 	srand(time(NULL));
@@ -28,6 +28,11 @@ void ServiceLogging::setLogData(const std::string & datetime, const std::string
 	output->flush(this->nodeInd, datetime, level, message);
 }
 
+void ServiceLogging::setLogRecord(LogRecord && record) {
+	record.nodeInd = this->nodeInd;
+	output->flush(std::move(record));
+}
+
 void ServiceLogging::setLogOutput(GenericOutput * value) {
 	if(output) {
 		delete output;
@@ -35,6 +40,10 @@ void ServiceLogging::setLogOutput(GenericOutput * value) {
 	output = value;
 }
 
+void ServiceLogging::setLogLevel(LoggingLevel level) {
+	minLevelSeverity.store(getLevelSeverity(level), std::memory_order_relaxed);
+}
+
 void ServiceLogging::setNodeIdentifier(const int nodeInd) {
 	std::string message = "Node index " + std::to_string(nodeInd) + " was using temporary node index identifier " +
 						  std::to_string(this->nodeInd);
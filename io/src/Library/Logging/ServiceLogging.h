@@ -1,6 +1,8 @@
 #ifndef SRC_LIBRARY_LOGGING_SERVICELOGGING_H_
 #define SRC_LIBRARY_LOGGING_SERVICELOGGING_H_
 
+#include "Library/Logging/LogRecord.h"
+#include <atomic>
 #include <string>
 
 namespace Library {
@@ -35,13 +37,23 @@ public:
 
 	void setLogData(const std::string & datetime, const std::string & level, const std::string & message);
 
+	void setLogRecord(LogRecord && record);
+
 	void setLogOutput(GenericOutput * output);
 
+	// The logs with a lower level are dropped before they are built
+	void setLogLevel(LoggingLevel level);
+
+	bool isLogLevelEnabled(LoggingLevel level) const {
+		return getLevelSeverity(level) >= minLevelSeverity.load(std::memory_order_relaxed);
+	}
+
 	void setNodeIdentifier(const int nodeInd);
 
 private:
 	GenericOutput * output{nullptr};
 	int nodeInd;
+	std::atomic<int> minLevelSeverity;
 };
 }  // namespace Logging
 }  // namespace Library
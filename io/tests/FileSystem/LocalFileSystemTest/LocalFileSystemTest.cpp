@@ -1,6 +1,8 @@
 #include <iostream>
 #include <limits.h>
 #include <time.h>
+#include <unistd.h>
+#include <utime.h>
 
 #include "gtest/gtest.h"
 
@@ -36,6 +38,28 @@ TEST_F(LocalFileSystemTest, GetFileStatusLinuxRegularFile) {
 	EXPECT_TRUE(fileStatus.getFileSize() > 0);
 }
 
+TEST_F(LocalFileSystemTest, GetFileStatusModificationTime) {
+	char filePath[] = "/tmp/LocalFileSystemTestXXXXXX";
+	const int fd = mkstemp(filePath);
+	ASSERT_NE(fd, -1);
+	close(fd);
+
+	struct utimbuf times;
+	times.actime = 1500000000;
+	times.modtime = 1500000000;
+	ASSERT_EQ(utime(filePath, &times), 0);
+	const FileStatus before = localFileSystem->getFileStatus(Uri(filePath));
+	EXPECT_EQ(before.getModificationTime(), 1500000000000ull);
+	EXPECT_TRUE(before.getETag().empty());
+
+	times.modtime = 1600000000;
+	ASSERT_EQ(utime(filePath, &times), 0);
+	const FileStatus after = localFileSystem->getFileStatus(Uri(filePath));
+	EXPECT_EQ(after.getModificationTime(), 1600000000000ull);
+
+	unlink(filePath);
+}
+
 TEST_F(LocalFileSystemTest, GetFileStatusLinuxDirectory) {
 	const std::string currentExe = "/proc/self/net";
 	const FileStatus fileStatus = localFileSystem->getFileStatus(currentExe);
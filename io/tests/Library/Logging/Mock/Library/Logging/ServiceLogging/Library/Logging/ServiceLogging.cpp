@@ -22,6 +22,8 @@ void ServiceLogging::setLogData(std::string && data) { mock->setLogData(std::mov
 
 void ServiceLogging::setLogData(const std::string & data) { mock->setLogData(data); }
 
+void ServiceLogging::setLogRecord(LogRecord && record) { mock->setLogRecord(record); }
+
 void ServiceLogging::setLogOutput(GenericOutput * output) { mock->setLogOutput(output); }
 }  // namespace Logging
 }  // namespace Library
@@ -1,6 +1,7 @@
 #ifndef TEST_MOCK_LIBRARY_LOGGING_SERVICELOGGING_H_
 #define TEST_MOCK_LIBRARY_LOGGING_SERVICELOGGING_H_
 
+#include "Library/Logging/LogRecord.h"
 #include <gmock/gmock.h>
 
 namespace Library {
@@ -19,6 +20,8 @@ struct ServiceLogging {
 
 	virtual void setLogData(const std::string & data) = 0;
 
+	virtual void setLogRecord(const ::Library::Logging::LogRecord & record) = 0;
+
 	virtual void setLogOutput(::Library::Logging::GenericOutput * output) = 0;
 };
 
@@ -27,6 +30,8 @@ struct ServiceLoggingMock : public ServiceLogging {
 
 	MOCK_METHOD1(setLogData, void(const std::string & data));
 
+	MOCK_METHOD1(setLogRecord, void(const ::Library::Logging::LogRecord & record));
+
 	MOCK_METHOD1(setLogOutput, void(::Library::Logging::GenericOutput * output));
 };
 }  // namespace Logging
@@ -64,8 +69,12 @@ public:
 
 	void setLogData(const std::string & data);
 
+	void setLogRecord(LogRecord && record);
+
 	void setLogOutput(GenericOutput * output);
 
+	bool isLogLevelEnabled(LoggingLevel level) const { return true; }
+
 private:
 	BlazingTest::Library::Logging::ServiceLoggingMock * mock{nullptr};
 };
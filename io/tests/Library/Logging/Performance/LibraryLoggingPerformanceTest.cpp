@@ -1,15 +1,20 @@
+#include "Library/Logging/AsyncOutput.h"
 #include "Library/Logging/CoutOutput.h"
+#include "Library/Logging/FileOutput.h"
 #include "Library/Logging/Logger.h"
 #include "Library/Logging/ServiceLogging.h"
 #include "Library/Logging/TcpOutput.h"
 #include "Library/Network/GenericSocket.h"
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <chrono>
 #include <ctime>
+#include <fstream>
 #include <functional>
 #include <future>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <mutex>
 #include <ostream>
 #include <thread>
@@ -293,3 +298,79 @@ TEST_F(LibraryLoggingPerformanceTest, PerformanceCoutOutput) {
 			  << " MBps\n";
 	std::cerr << "Improvement Ratio: " << (double) standardMean / (double) loggingMean << "x\n\n";
 }
+
+
+TEST_F(LibraryLoggingPerformanceTest, PerformanceAsyncOutput) {
+	const int threadSize{20};
+	const int messageTimes{10000};
+	const int messageSize{99};
+	const std::string messageData = generateMessage(messageSize);
+	const std::string filename{"/tmp/LibraryLoggingPerformanceTest.log"};
+
+	auto logFunction = [this](const int id, const int messageTimes, const std::string & messageData) {
+		auto start = std::chrono::high_resolution_clock::now();
+		for(int k = 0; k < messageTimes; ++k) {
+			Library::Logging::Logger().logInfo(messageData);
+		}
+		auto finish = std::chrono::high_resolution_clock::now();
+		elapsedTime[id] = (double) std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count() / 1000.0;
+	};
+
+	// every thread writes to the file with its lock and a flush per line
+	Library::Logging::ServiceLogging::getInstance().setLogOutput(new Library::Logging::FileOutput(filename, true));
+
+	std::cerr << "Start File Output" << std::endl;
+	executeFunction(threadSize, messageTimes, messageData, logFunction);
+	std::cerr << "Finish File Output" << std::endl;
+
+	double fileMean;
+	double fileDeviation;
+	calculateStatisticValues(elapsedTime, fileMean, fileDeviation);
+
+
+	// the threads only push to the ring, the writer thread writes batches to the file
+	auto * asyncOutput = new Library::Logging::AsyncOutput(new Library::Logging::FileOutput(filename, true));
+	Library::Logging::ServiceLogging::getInstance().setLogOutput(asyncOutput);
+
+	std::cerr << "Start Async Output" << std::endl;
+	executeFunction(threadSize, messageTimes, messageData, logFunction);
+	std::cerr << "Finish Async Output" << std::endl;
+
+	auto fullRingWaits = asyncOutput->getFullRingWaits();
+
+	// the destructor of the output writes what is left in the ring
+	auto drainStart = std::chrono::high_resolution_clock::now();
+	Library::Logging::ServiceLogging::getInstance().setLogOutput(new Library::Logging::CoutOutput());
+	auto drainFinish = std::chrono::high_resolution_clock::now();
+	double drainTime =
+		(double) std::chrono::duration_cast<std::chrono::microseconds>(drainFinish - drainStart).count() / 1000.0;
+
+	double asyncMean;
+	double asyncDeviation;
+	calculateStatisticValues(elapsedTime, asyncMean, asyncDeviation);
+
+	std::ifstream file(filename);
+	int totalLines = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
+	EXPECT_EQ(threadSize * messageTimes, totalLines);
+
+	const double totalMessages = threadSize * messageTimes;
+
+	std::cerr << "\n\n";
+	std::cerr << "Number of Threads: " << threadSize << '\n';
+	std::cerr << "Message per Thread: " << messageTimes << '\n';
+	std::cerr << "Message Length: " << messageSize << " bytes \n\n";
+
+	std::cerr.precision(2);
+	std::cerr << std::fixed;
+	std::cerr << "File Output Mean: " << fileMean << " ms\n";
+	std::cerr << "File Output Deviation: " << fileDeviation << "\n";
+	std::cerr << "File Output Throughput: " << totalMessages / fileMean * 1000.0 << " messages/s\n\n";
+
+	std::cerr << "Async Output Mean: " << asyncMean << " ms\n";
+	std::cerr << "Async Output Deviation: " << asyncDeviation << "\n";
+	std::cerr << "Async Output Throughput: " << totalMessages / asyncMean * 1000.0 << " messages/s\n";
+	std::cerr << "Async Output Drain Time: " << drainTime << " ms\n";
+	std::cerr << "Async Output Full Ring Waits: " << fullRingWaits << "\n\n";
+
+	std::cerr << "Improvement Ratio: " << fileMean / asyncMean << "x\n\n";
+}
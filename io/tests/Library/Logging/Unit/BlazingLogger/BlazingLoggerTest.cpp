@@ -3,11 +3,14 @@
 #include "Library/Logging/ServiceLogging.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
-#include <regex>
 #include <thread>
 #include <vector>
 
-using testing::MatchesRegex;
+using Library::Logging::LogRecord;
+using testing::AllOf;
+using testing::ElementsAre;
+using testing::Field;
+using testing::Pair;
 using testing::SafeMatcherCast;
 using testing::StrEq;
 
@@ -16,11 +19,10 @@ struct BlazingLoggerTest : public ::testing::Test {
 
 	virtual ~BlazingLoggerTest() {}
 
-	virtual void SetUp() { regex = R"(^\[[0-9]{4}-([0-9]{2})-([0-9]{2})T([0-9]{2}):([0-9]{2}):([0-9]{2})Z\])"; }
+	virtual void SetUp() {}
 
 	virtual void TearDown() {}
 
-	std::string regex;
 	const std::string logData{"sample logging data"};
 };
 
@@ -45,11 +47,9 @@ TEST_F(BlazingLoggerTest, CheckLogger) {
 
 TEST_F(BlazingLoggerTest, CheckLoggerInfo) {
 	auto level = Library::Logging::LoggingLevel::INFO;
-	regex += R"(\[)" + std::string(Library::Logging::getLevelName(level)) + R"(\])";
-	regex += logData + R"($)";
-
 	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
-	EXPECT_CALL(mock, setLogData(SafeMatcherCast<const std::string &>(MatchesRegex(regex)))).Times(4);
+	EXPECT_CALL(mock, setLogRecord(AllOf(Field(&LogRecord::level, level), Field(&LogRecord::message, StrEq(logData)))))
+		.Times(4);
 
 	{
 		Logger().logInfo(logData);
@@ -65,11 +65,9 @@ TEST_F(BlazingLoggerTest, CheckLoggerInfo) {
 
 TEST_F(BlazingLoggerTest, CheckLoggerWarn) {
 	auto level = Library::Logging::LoggingLevel::WARN;
-	regex += R"(\[)" + std::string(Library::Logging::getLevelName(level)) + R"(\])";
-	regex += logData + R"($)";
-
 	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
-	EXPECT_CALL(mock, setLogData(SafeMatcherCast<const std::string &>(MatchesRegex(regex)))).Times(4);
+	EXPECT_CALL(mock, setLogRecord(AllOf(Field(&LogRecord::level, level), Field(&LogRecord::message, StrEq(logData)))))
+		.Times(4);
 
 	{
 		Logger().logWarn(logData);
@@ -85,11 +83,9 @@ TEST_F(BlazingLoggerTest, CheckLoggerWarn) {
 
 TEST_F(BlazingLoggerTest, CheckLoggerTrace) {
 	auto level = Library::Logging::LoggingLevel::TRACE;
-	regex += R"(\[)" + std::string(Library::Logging::getLevelName(level)) + R"(\])";
-	regex += logData + R"($)";
-
 	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
-	EXPECT_CALL(mock, setLogData(SafeMatcherCast<const std::string &>(MatchesRegex(regex)))).Times(4);
+	EXPECT_CALL(mock, setLogRecord(AllOf(Field(&LogRecord::level, level), Field(&LogRecord::message, StrEq(logData)))))
+		.Times(4);
 
 	{
 		Logger().logTrace(logData);
@@ -105,11 +101,9 @@ TEST_F(BlazingLoggerTest, CheckLoggerTrace) {
 
 TEST_F(BlazingLoggerTest, CheckLoggerDebug) {
 	auto level = Library::Logging::LoggingLevel::DEBUG;
-	regex += R"(\[)" + std::string(Library::Logging::getLevelName(level)) + R"(\])";
-	regex += logData + R"($)";
-
 	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
-	EXPECT_CALL(mock, setLogData(SafeMatcherCast<const std::string &>(MatchesRegex(regex)))).Times(4);
+	EXPECT_CALL(mock, setLogRecord(AllOf(Field(&LogRecord::level, level), Field(&LogRecord::message, StrEq(logData)))))
+		.Times(4);
 
 	{
 		Logger().logDebug(logData);
@@ -125,11 +119,9 @@ TEST_F(BlazingLoggerTest, CheckLoggerDebug) {
 
 TEST_F(BlazingLoggerTest, CheckLoggerError) {
 	auto level = Library::Logging::LoggingLevel::ERROR;
-	regex += R"(\[)" + std::string(Library::Logging::getLevelName(level)) + R"(\])";
-	regex += logData + R"($)";
-
 	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
-	EXPECT_CALL(mock, setLogData(SafeMatcherCast<const std::string &>(MatchesRegex(regex)))).Times(4);
+	EXPECT_CALL(mock, setLogRecord(AllOf(Field(&LogRecord::level, level), Field(&LogRecord::message, StrEq(logData)))))
+		.Times(4);
 
 	{
 		Logger().logError(logData);
@@ -145,11 +137,9 @@ TEST_F(BlazingLoggerTest, CheckLoggerError) {
 
 TEST_F(BlazingLoggerTest, CheckLoggerFatal) {
 	auto level = Library::Logging::LoggingLevel::FATAL;
-	regex += R"(\[)" + std::string(Library::Logging::getLevelName(level)) + R"(\])";
-	regex += logData + R"($)";
-
 	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
-	EXPECT_CALL(mock, setLogData(SafeMatcherCast<const std::string &>(MatchesRegex(regex)))).Times(4);
+	EXPECT_CALL(mock, setLogRecord(AllOf(Field(&LogRecord::level, level), Field(&LogRecord::message, StrEq(logData)))))
+		.Times(4);
 
 	{
 		Logger().logFatal(logData);
@@ -163,6 +153,20 @@ TEST_F(BlazingLoggerTest, CheckLoggerFatal) {
 }
 
 
+TEST_F(BlazingLoggerTest, CheckLoggerFields) {
+	auto level = Library::Logging::LoggingLevel::DEBUG;
+
+	auto & mock = Library::Logging::ServiceLogging::getInstance().getMock();
+	EXPECT_CALL(mock,
+		setLogRecord(AllOf(Field(&LogRecord::level, level),
+			Field(&LogRecord::message, StrEq(logData)),
+			Field(&LogRecord::fields, ElementsAre(Pair("query_id", "1"), Pair("rows", "100"))))))
+		.Times(1);
+
+	Logger().logFields(level, logData, {{"query_id", "1"}, {"rows", "100"}});
+}
+
+
 TEST_F(BlazingLoggerTest, CheckLoggerMultiThread) {
 	const int SIZE = 10;
 
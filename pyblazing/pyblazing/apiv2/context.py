@@ -299,12 +299,14 @@ def modifyAlgebraForDataframesWithOnlyWantedColumns(algebra, tableScanInfo,origi
     return algebra
 
 
-def get_uri_values(files, partitions, base_folder):
+def get_partition_names(files, base_folder):
     base_folder = base_folder + '/'
+    return [os.path.dirname(file.decode()).replace(base_folder,'') for file in files]
+
+
+def get_uri_values(files, partitions, base_folder):
     uri_values = []
-    for file in files:
-        file_dir = os.path.dirname(file.decode())
-        partition_name = file_dir.replace(base_folder,'')
+    for file, partition_name in zip(files, get_partition_names(files, base_folder)):
         if partition_name in partitions:
             uri_values.append(partitions[partition_name])
         else:
@@ -417,6 +419,8 @@ def mergeMetadata(curr_table, fileMetadata, hiveMetadata):
         col_name = columns[index]
         names.append('min_' + str(index) + '_' + col_name)
         names.append('max_' + str(index) + '_' + col_name)
+        names.append('null_count_' + str(index) + '_' + col_name)
+    names.append('num_rows')
     names.append('file_handle_index')
     names.append('row_group_index')
 
@@ -620,6 +624,12 @@ class BlazingTable(object):
         # a pair of values with the startIndex and batchSize info for each slice
         self.offset = (0,0)
 
+        # partitioned tables, the folders of the partitions under partition_location and a metadata table with a row
+        # for each of them, whose file_handle_index is the index of the partition in partition_names
+        self.partition_location = None
+        self.partition_names = []
+        self.partition_metadata = None
+
         self.column_names = []
         self.column_types = []
 
@@ -709,6 +719,96 @@ class BlazingTable(object):
         return self.dask_mapping[worker]
 
 
+def to_algebra_literal(value):
+    if value is None:
+        return 'null'
+    if isinstance(value, (bool, np.bool_)):
+        return 'true' if value else 'false'
+    if isinstance(value, (int, float, np.number)):
+        return str(value)
+    return "'" + str(value).replace("'", "''") + "'"
+
+
+def bind_algebra_parameters(algebra, literals):
+    """
+    Replaces the ?0, ?1... parameters of the algebra that are not inside a string literal by literals[0], literals[1]...
+    """
+    bound = []
+    in_quotes = False
+    i = 0
+    while i < len(algebra):
+        c = algebra[i]
+        if c == "'":
+            in_quotes = not in_quotes
+        elif c == '?' and not in_quotes:
+            end = i + 1
+            while end < len(algebra) and algebra[end].isdigit():
+                end = end + 1
+            if end > i + 1:
+                bound.append(literals[int(algebra[i + 1:end])])
+                i = end
+                continue
+        bound.append(c)
+        i = i + 1
+    return ''.join(bound)
+
+
+def has_algebra_parameters(algebra):
+    return re.search(r"\?\d", re.sub(r"'[^']*'", '', algebra)) is not None
+
+
+class PreparedQuery(object):
+    """
+    A query prepared with BlazingContext.prepare, that can be run many times with different parameters.
+    """
+
+    def __init__(self, context, statement_id, tables, fileTypes, scan_queries):
+        self.context = context
+        self.statement_id = statement_id
+        # the engine keeps views of the dataframe tables, they have to live as long as the prepared query
+        self.tables = tables
+        self.fileTypes = fileTypes
+        # the filters of the scans that still have parameters, the files of their tables are pruned on every run
+        self.scan_queries = scan_queries
+
+    def sql(self, parameters=[], config_options={}):
+        """
+        Run the query, parameters[i] is the value of its i-th parameter.
+        Returns a cudf.DataFrame.
+        """
+        if self.statement_id is None:
+            raise ValueError("The prepared query was already released")
+
+        masterIndex = 0
+        ctxToken = random.randint(0, 64000)
+        accessToken = 0
+        literals = [to_algebra_literal(parameter) for parameter in parameters]
+
+        run_tables = None
+        if len(self.scan_queries) > 0:
+            run_tables = dict(self.tables)
+            for table_name, scan_table_query in self.scan_queries.items():
+                run_tables[table_name] = self.context._get_table_slices(table_name, self.tables[table_name],
+                    bind_algebra_parameters(scan_table_query, literals), True)[0]
+
+        return cio.runPreparedQueryCaller(
+                    self.statement_id,
+                    masterIndex,
+                    self.context.nodes,
+                    ctxToken,
+                    literals,
+                    accessToken,
+                    self.context._get_query_config_options(config_options),
+                    run_tables,
+                    self.fileTypes)
+
+    def release(self):
+        if self.statement_id is not None:
+            cio.releasePreparedQueryCaller(self.statement_id)
+            self.statement_id = None
+            self.tables = None
+
+
 class BlazingContext(object):
     """
     BlazingContext is the Python API of BlazingSQL. Along with initialization arguments allowing for
@@ -743,6 +843,10 @@ class BlazingContext(object):
                                     MAX_JOIN_SCATTER_MEM_OVERHEAD : The bigger this value, the more likely one of the tables of join will be
                                            scattered to all the nodes, instead of doing a standard hash based partitioning shuffle. Value is in bytes.
                                            default: 500000000
+                                    JOIN_SCATTER_DECISION_BUFFER_BYTES : How many bytes of each side of a join a node buffers before deciding whether
+                                           to scatter one of them. A side that fits in it is measured instead of estimated. If a scattered side turns out to be
+                                           bigger than estimated, the nodes switch to hash partitioning halfway. Value is in bytes.
+                                           default: MAX_JOIN_SCATTER_MEM_OVERHEAD / number of nodes
                                     MAX_NUM_ORDER_BY_PARTITIONS_PER_NODE : The maximum number of partitions that will be made for an order by.
                                            Increse this number if running into OOM issues when doing order bys with large amounts of data.
                                            default: 8
@@ -752,6 +856,19 @@ class BlazingContext(object):
                                     TABLE_SCAN_KERNEL_NUM_THREADS: The number of threads used in the TableScan and BindableTableScan kernels for
                                            reading batches
                                            default: 1
+                                    SCAN_UNIT_TARGET_BYTES : The approximate size in bytes of the batches that a file is split into when it
+                                           is scanned, by groups of row groups for parquet, stripes for orc and ranges of lines for csv
+                                           and json lines. The batches of a file are read in parallel by the scan threads. 0 reads
+                                           each file as a single batch.
+                                           default: 250000000
+                                    DICTIONARY_PRUNING_MAX_THREADS : The max number of row groups of a parquet file whose dictionaries
+                                           are read at the same time, to skip the ones that do not have any of the values that the
+                                           filter of a scan compares a column with = or IN. 0 disables it.
+                                           default: 8
+                                    ENABLE_LATE_MATERIALIZATION : If True, a scan with a filter reads the columns that the filter uses first,
+                                           and the other columns only for the range of rows that the filter keeps, for the formats
+                                           that can read a range of rows (parquet).
+                                           default: True
                                     MAX_DATA_LOAD_CONCAT_CACHE_BYTE_SIZE : The max size in bytes to concatenate the batches read from the scan kernels
                                            default: 400000000
                                     FLOW_CONTROL_BATCHES_THRESHOLD : If an output cache surpasses this value in num batches, the kernel will try to 
@@ -763,9 +880,75 @@ class BlazingContext(object):
                                     ORDER_BY_SAMPLES_RATIO : The ratio to multiply the estimated total number of rows in the SortAndSampleKernel to
                                            calculate the number of samples
                                            default: 0.1
+                                    MERGE_STREAM_BATCH_BYTES : The approximate size of the batches that the merge of a sort outputs.
+                                            Smaller batches let the kernels after the sort start sooner.
+                                            default: 50000000
                                     BLAZING_DEVICE_MEM_RESOURCE_CONSUMPTION_THRESHOLD : The percent (as a decimal) of total GPU memory that the memory resource
                                             will consider to be full
                                             default: 0.95
+                                    SKEW_HEAVY_HITTER_THRESHOLD : A join or group by key is considered a heavy hitter when its estimated share of the rows is
+                                            bigger than this value times the share of a single node. The rows of heavy hitter join keys are spread across the nodes,
+                                            and the partial aggregations of recurring group by keys are merged locally before they are sent. A value of 0 disables it.
+                                            default: 0 (disabled), 0.5 is a good value to enable it
+                                    TRANSPORT_CREDIT_BYTES_PER_SENDER : The max number of bytes a node will accept from each other node for a query before
+                                            they are consumed. Senders block until the receiver grants them credits. It has to be set to the same value on all nodes.
+                                            default: 0 (makes it not applicable)
+                                    TRANSPORT_SHARED_MEMORY : If True, nodes that run on the same host send their partitions through a shared memory
+                                            ring instead of TCP. Nodes on other hosts keep using TCP. It has to be enabled on all nodes of the host.
+                                            default: False
+                                    TRANSPORT_SHARED_MEMORY_RING_BYTES : The size in bytes of the shared memory ring each node creates to receive
+                                            messages when TRANSPORT_SHARED_MEMORY is enabled.
+                                            default: 67108864 (64MB)
+                                    TRANSPORT_SHARED_MEMORY_CLUSTER_ID : Names the shared memory rings of the nodes of this BlazingContext, so that two
+                                            clusters running on the same host do not write into each other's rings.
+                                            default: the address of the dask-scheduler
+                                    PHYSICAL_PLAN_CACHE_SIZE : How many physical plans are kept, so that running the same query again skips
+                                            parsing its plan. A value of 0 disables it.
+                                            default: 256
+                                    RESULT_CACHE_MAX_BYTES : How many bytes of host memory are used to keep the results of single node
+                                            queries that only read files, so that running the same query again over files that did not
+                                            change returns the kept result. A value of 0 disables it.
+                                            default: 0
+                                    RESULT_CACHE_MAX_DISK_BYTES : How many bytes of local files are used to keep the results that
+                                            do not fit in RESULT_CACHE_MAX_BYTES anymore. A value of 0 drops them instead.
+                                            default: 0
+                                    ENABLE_RUNTIME_FILTERS : Inner and right joins build a filter with the keys of their right
+                                            side, which the scans of their left side use to skip row groups and to drop the rows
+                                            that can not have a match before they are joined or shuffled.
+                                            default: True
+                                    RUNTIME_FILTER_BLOOM_BYTES : Size of the Bloom filter of each runtime filter.
+                                            default: 1048576
+                                    RUNTIME_FILTER_MAX_BUILD_ROWS : Joins whose right side has more rows than this, in a node or
+                                            in all of them, do not build runtime filters.
+                                            default: RUNTIME_FILTER_BLOOM_BYTES * 8 / 10, so 838860 for the default
+                                            Bloom filter
+                                    RUNTIME_FILTER_MAX_WAIT_MS : How long a scan waits for its runtime filters before it starts
+                                            reading without them.
+                                            default: 5000
+                                    AGGREGATION_MERGE_BYTES_THRESHOLD : How many bytes of partial aggregation results
+                                            are accumulated before folding them together into a running state.
+                                            default: 100000000
+                                    AGGREGATION_STATE_MAX_BYTES : The size of a running aggregation state after which it
+                                            is sent to the merge phase, where it can be spilled, and a new one is started.
+                                            default: 400000000
+                                    AGGREGATION_BYPASS_RATIO : When a fold of partial aggregation results keeps more than
+                                            this fraction of its rows, the keys barely repeat and the rest of the partial
+                                            results are sent to the merge phase without folding them.
+                                            default: 0.8
+                                    ENABLE_TRACING : If True, every node records when the kernels run, where they wait on their
+                                            caches, the shuffles, the spills, the reads and the messages of each query, and writes them
+                                            as a Chrome trace JSON file that chrome://tracing and Perfetto load. Every node is a
+                                            process of the trace, so the files of the nodes can be merged into one timeline.
+                                            default: False
+                                    TRACE_OUTPUT_DIRECTORY : The directory where the nodes write the trace of each query when
+                                            ENABLE_TRACING is set, as RAL.{node}.query.{query_id}.trace.json.
+                                            default: the working directory of the nodes
+                                    LOGGING_LEVEL : The lowest level of the logs that the nodes write. One of trace, debug, info, warn,
+                                            error or fatal. The logs of lower levels are dropped before they are built.
+                                            default: trace
+                                    ENABLE_ASYNC_LOGGING : If True, the threads of the nodes only queue their logs, and a background
+                                            thread writes them in batches. A thread only waits for it when the queue is full.
+                                            default: False
 
         Examples
         --------
@@ -804,6 +987,9 @@ class BlazingContext(object):
             self.config_options[option.encode()] = str(config_options[option]).encode() # make sure all options are encoded strings
         
         if(dask_client is not None):
+            if b'TRANSPORT_SHARED_MEMORY_CLUSTER_ID' not in self.config_options:
+                self.config_options[b'TRANSPORT_SHARED_MEMORY_CLUSTER_ID'] = str(self.dask_client.scheduler_info()["address"]).encode()
+
             if network_interface is None:
                 network_interface = 'eth0'
 
@@ -856,6 +1042,8 @@ class BlazingContext(object):
         self.schema = BlazingSchemaClass(self.db)
         self.generator = RelationalAlgebraGeneratorClass(self.schema)
         self.tables = {}
+        # for each partitioned table of the last query, how many of its partitions it read out of how many the table has
+        self.partition_pruning_stats = {}
         self.logs_initialized = False
 
         # waitForPingSuccess(self.client)
@@ -1075,6 +1263,11 @@ class BlazingContext(object):
         input : data source for table.
                 cudf.Dataframe, dask_cudf.DataFrame, pandas.DataFrame, filepath for csv, orc, parquet, etc...
 
+        The folders of every partition of a partitioned table (Hive cursor or partitions=...) and their files are
+        listed when the table is created, since its schema and its row group metadata come from them. Listing is not
+        deferred to the queries; what they skip is reading the partitions whose values can not pass their filters,
+        see partition_pruning_stats.
+
         Examples
         --------
 
@@ -1243,7 +1436,11 @@ class BlazingContext(object):
                 parsedMetadata = parseHiveMetadata(table, uri_values)
                 table.metadata = parsedMetadata
 
-            if parsedSchema['file_type'] == DataType.PARQUET :
+                table.partition_location = hive_schema['location']
+                table.partition_names = list(hive_schema['partitions'].keys())
+                table.partition_metadata = parseHiveMetadata(table, list(hive_schema['partitions'].values()))
+
+            if parsedSchema['file_type'] == DataType.PARQUET or parsedSchema['file_type'] == DataType.ORC:
                 parsedMetadata = self._parseMetadata(file_format_hint, table.slices, parsedSchema, kwargs)
 
                 if isinstance(parsedMetadata, dask_cudf.core.DataFrame):
@@ -1384,6 +1581,57 @@ class BlazingContext(object):
         return all_sliced_files, all_sliced_uri_values, all_sliced_row_groups_ids
 
 
+    def _prune_partitions(self, table_name, current_table, scan_table_query):
+        """
+        Returns the table with only the files of the partitions whose values can pass the filter of the scan, which is
+        evaluated against one row per partition instead of one per row group, and records how many partitions are read
+        """
+        partition_of_file = get_partition_names(current_table.files, current_table.partition_location)
+        partitions_total = len(set(partition_of_file))
+
+        pruned = cio.runSkipDataCaller(current_table, scan_table_query, current_table.partition_metadata)
+        if pruned['skipdata_analysis_fail']:
+            self.partition_pruning_stats[table_name] = {'partitions_scanned': partitions_total, 'partitions_total': partitions_total}
+            return current_table
+
+        kept_partitions = set()
+        if not pruned['metadata'].empty:
+            kept_indexes = pruned['metadata']['file_handle_index'].to_pandas().values.tolist()
+            kept_partitions = set(current_table.partition_names[i] for i in kept_indexes)
+        file_indexes = [i for i, name in enumerate(partition_of_file) if name in kept_partitions]
+        self.partition_pruning_stats[table_name] = {
+            'partitions_scanned': len(set(partition_of_file[i] for i in file_indexes)),
+            'partitions_total': partitions_total}
+        if len(file_indexes) == len(current_table.files):
+            return current_table
+
+        metadata = None
+        if current_table.metadata is not None:
+            # the rows of the files that are left, with their file_handle_index in the new list of files
+            new_file_indexes = np.full(len(current_table.files), -1, dtype=np.int32)
+            new_file_indexes[file_indexes] = np.arange(len(file_indexes), dtype=np.int32)
+            old_file_indexes = current_table.metadata['file_handle_index'].to_array()
+            metadata = current_table.metadata[new_file_indexes[old_file_indexes] >= 0].reset_index(drop=True)
+            metadata['file_handle_index'] = new_file_indexes[metadata['file_handle_index'].to_array()]
+
+        row_groups_ids = current_table.row_groups_ids
+        if row_groups_ids is not None and len(row_groups_ids) > 0:
+            row_groups_ids = [row_groups_ids[i] for i in file_indexes]
+
+        bt = BlazingTable(current_table.input,
+                        current_table.fileType,
+                        files=[current_table.files[i] for i in file_indexes],
+                        calcite_to_file_indices=current_table.calcite_to_file_indices,
+                        uri_values=[current_table.uri_values[i] for i in file_indexes],
+                        args=current_table.args,
+                        metadata=metadata,
+                        row_groups_ids=row_groups_ids,
+                        in_file=current_table.in_file)
+        bt.column_names = current_table.column_names
+        bt.file_column_names = current_table.file_column_names
+        bt.column_types = current_table.column_types
+        return bt
+
     def _optimize_with_skip_data_getSlices(self, current_table, scan_table_query,single_gpu):
         nodeFilesList = []
         file_indices_and_rowgroup_indices = cio.runSkipDataCaller(current_table, scan_table_query)
@@ -1495,6 +1743,90 @@ class BlazingContext(object):
 
     
 
+    def _get_query_config_options(self, config_options):
+        if len(config_options) == 0:
+            query_config_options = self.config_options 
+        else:        
+            query_config_options = {}
+            for option in config_options:
+                query_config_options[option.encode()] = str(config_options[option]).encode() # make sure all options are encoded strings
+        return query_config_options
+
+    def _get_table_slices(self, table_name, table, scan_table_query, single_gpu):
+        """
+        Returns the slices of a file table that each node reads, without the partitions and row groups that the filter
+        of its scan rules out
+        """
+        if table.partition_metadata is not None:
+            table = self._prune_partitions(table_name, table, scan_table_query)
+        if table.has_metadata():
+            return self._optimize_with_skip_data_getSlices(table, scan_table_query, single_gpu)
+        if single_gpu == True:
+            return table.getSlices(1)
+        return table.getSlices(len(self.nodes))
+
+    def _get_node_tables(self, algebra, single_gpu, scan_queries=None):
+        """
+        Returns the algebra with only the columns that are used of the dataframe tables, the tables that each node
+        reads and their file types.
+        If scan_queries is a dict the file tables are not pruned, since the filters of their scans still have parameters,
+        and the filters of the tables that can be pruned are put in it by table name instead
+        """
+        nodeTableList = [{} for _ in range(len(self.nodes))]
+        if single_gpu:
+            nodeTableList = [{},]
+        fileTypes = []
+
+        if self.dask_client is None or single_gpu == True :
+            new_tables, relational_algebra_steps = cio.getTableScanInfoCaller(algebra,self.tables)
+        else:
+            worker = tuple(self.dask_client.scheduler_info()['workers'])[0]
+            connection = self.dask_client.submit(
+                cio.getTableScanInfoCaller,
+                algebra,
+                self.tables,
+                workers=[worker])
+            new_tables, relational_algebra_steps = connection.result()
+
+        algebra = modifyAlgebraForDataframesWithOnlyWantedColumns(algebra, relational_algebra_steps,self.tables)
+
+        self.partition_pruning_stats = {}
+        for table in new_tables:
+            fileTypes.append(new_tables[table].fileType)
+            ftype = new_tables[table].fileType
+            if(ftype == DataType.PARQUET or ftype == DataType.ORC or ftype == DataType.JSON or ftype == DataType.CSV):
+                scan_table_query = relational_algebra_steps[table]['table_scans'][0]
+                can_be_pruned = new_tables[table].partition_metadata is not None or new_tables[table].has_metadata()
+                if scan_queries is not None and can_be_pruned and has_algebra_parameters(scan_table_query):
+                    scan_queries[table] = scan_table_query
+                    currentTableNodes = new_tables[table].getSlices(1) if single_gpu == True else new_tables[table].getSlices(len(self.nodes))
+                else:
+                    currentTableNodes = self._get_table_slices(table, new_tables[table], scan_table_query, single_gpu)
+            elif(new_tables[table].fileType == DataType.DASK_CUDF):
+                if single_gpu == True:
+                    #TODO: repartition onto the node that does the work
+                    print("Unsupported running single_gpu queries on dask_cudf please use files")
+                elif new_tables[table].input.npartitions < len(self.nodes): # dask DataFrames are expected to have one partition per node. If we have less, we have to repartition
+                    print("WARNING: Dask DataFrame table has less partitions than there are nodes. Repartitioning ... ")
+                    temp_df = new_tables[table].input.compute()
+                    new_tables[table].input = dask_cudf.from_cudf(temp_df,npartitions=len(self.nodes))
+                    new_tables[table].input = new_tables[table].input.persist()
+                    new_tables[table].dask_mapping = getNodePartitions(new_tables[table].input, self.dask_client)
+                currentTableNodes = []
+                for node in self.nodes:
+                    currentTableNodes.append(new_tables[table])
+            elif(new_tables[table].fileType == DataType.CUDF or new_tables[table].fileType == DataType.ARROW):
+                currentTableNodes = []
+                for node in self.nodes:
+                    if not isinstance(new_tables[table].input, list):
+                        new_tables[table].input = [new_tables[table].input]
+                    currentTableNodes.append(new_tables[table])
+
+            for j, nodeList in enumerate(nodeTableList):
+                nodeList[table] = currentTableNodes[j]
+
+        return algebra, nodeTableList, fileTypes
+
     def sql(self, query, table_list=[], algebra=None, return_futures=False, single_gpu=False, config_options={}):
         """
         Query a BlazingSQL table.
@@ -1555,10 +1887,6 @@ class BlazingContext(object):
         """
         # TODO: remove hardcoding
         masterIndex = 0
-        nodeTableList = [{} for _ in range(len(self.nodes))]
-        if single_gpu:
-            nodeTableList = [{},]
-        fileTypes = []
 
         if (algebra is None):
             algebra = self.explain(query)
@@ -1573,60 +1901,8 @@ class BlazingContext(object):
             print("Parsing Error")
             return
 
-        if len(config_options) == 0:
-            query_config_options = self.config_options 
-        else:        
-            query_config_options = {}
-            for option in config_options:
-                query_config_options[option.encode()] = str(config_options[option]).encode() # make sure all options are encoded strings
-
-        if self.dask_client is None or single_gpu == True :
-            new_tables, relational_algebra_steps = cio.getTableScanInfoCaller(algebra,self.tables)
-        else:
-            worker = tuple(self.dask_client.scheduler_info()['workers'])[0]
-            connection = self.dask_client.submit(
-                cio.getTableScanInfoCaller,
-                algebra,
-                self.tables,
-                workers=[worker])
-            new_tables, relational_algebra_steps = connection.result()
-
-        algebra = modifyAlgebraForDataframesWithOnlyWantedColumns(algebra, relational_algebra_steps,self.tables)
-
-        for table in new_tables:
-            fileTypes.append(new_tables[table].fileType)
-            ftype = new_tables[table].fileType
-            if(ftype == DataType.PARQUET or ftype == DataType.ORC or ftype == DataType.JSON or ftype == DataType.CSV):
-                if new_tables[table].has_metadata():
-                    scan_table_query = relational_algebra_steps[table]['table_scans'][0]
-                    currentTableNodes = self._optimize_with_skip_data_getSlices(new_tables[table], scan_table_query,single_gpu)
-                else:
-                    if single_gpu == True:
-                        currentTableNodes = new_tables[table].getSlices(1)
-                    else:
-                        currentTableNodes = new_tables[table].getSlices(len(self.nodes))
-            elif(new_tables[table].fileType == DataType.DASK_CUDF):
-                if single_gpu == True:
-                    #TODO: repartition onto the node that does the work
-                    print("Unsupported running single_gpu queries on dask_cudf please use files")
-                elif new_tables[table].input.npartitions < len(self.nodes): # dask DataFrames are expected to have one partition per node. If we have less, we have to repartition
-                    print("WARNING: Dask DataFrame table has less partitions than there are nodes. Repartitioning ... ")
-                    temp_df = new_tables[table].input.compute()
-                    new_tables[table].input = dask_cudf.from_cudf(temp_df,npartitions=len(self.nodes))
-                    new_tables[table].input = new_tables[table].input.persist()
-                    new_tables[table].dask_mapping = getNodePartitions(new_tables[table].input, self.dask_client)
-                currentTableNodes = []
-                for node in self.nodes:
-                    currentTableNodes.append(new_tables[table])
-            elif(new_tables[table].fileType == DataType.CUDF or new_tables[table].fileType == DataType.ARROW):
-                currentTableNodes = []
-                for node in self.nodes:
-                    if not isinstance(new_tables[table].input, list):
-                        new_tables[table].input = [new_tables[table].input]
-                    currentTableNodes.append(new_tables[table])
-
-            for j, nodeList in enumerate(nodeTableList):
-                nodeList[table] = currentTableNodes[j]
+        query_config_options = self._get_query_config_options(config_options)
+        algebra, nodeTableList, fileTypes = self._get_node_tables(algebra, single_gpu)
 
         ctxToken = random.randint(0, 64000)
         accessToken = 0
@@ -1683,6 +1959,76 @@ class BlazingContext(object):
                     result = dask.dataframe.from_delayed(dask_futures)
         return result
 
+    def get_query_profile(self):
+        """
+        Returns the execution profile of the last query, like an EXPLAIN ANALYZE.
+
+        The profile is a cudf.DataFrame with a row per kernel of the execution graph of the query: its busy time,
+        the time it waited for its input batches (input_wait_ms) and for its saturated output caches (output_wait_ms),
+        the batches, rows and bytes in and out, and the output batches that were spilled to host memory or disk.
+        When distributed, the profile of every worker is returned, with a worker column.
+        Queries served from the result cache do not have a profile.
+
+        Examples
+        --------
+
+        >>> df = bc.sql('SELECT n_regionkey, COUNT(*) FROM nation GROUP BY n_regionkey')
+        >>> print(bc.get_query_profile()[['kernel_id', 'kernel_type', 'busy_ms', 'rows_in', 'rows_out']])
+           kernel_id                kernel_type  busy_ms  rows_in  rows_out
+        0          0    BindableTableScanKernel     3.21        0        25
+        1          1     ComputeAggregateKernel     1.87       25         5
+        ...
+        """
+        if self.dask_client is None:
+            return cio.getLastQueryProfileCaller()
+
+        profiles = []
+        for worker, profile in self.dask_client.run(cio.getLastQueryProfileCaller).items():
+            if profile is not None:
+                profile['worker'] = worker
+                profiles.append(profile)
+        if len(profiles) == 0:
+            return None
+        return cudf.concat(profiles)
+
+    def prepare(self, query, algebra=None):
+        """
+        Prepare a query to be run many times.
+
+        The plan of the query and the files of its tables are resolved once, so each run skips parsing the plan
+        and listing the files. The query can have parameters, written as ? in the SQL or as ?0, ?1... in the algebra,
+        that are given when it is run.
+
+        Returns a PreparedQuery. Call its release method when it is not needed anymore.
+        Prepared queries can only be run on a single GPU, without a dask client.
+
+        Examples
+        --------
+
+        >>> prepared = bc.prepare('SELECT n_nationkey, n_name FROM nation WHERE n_regionkey = ?')
+        >>> df = prepared.sql([1])
+        >>> df = prepared.sql([3])
+        >>> prepared.release()
+        """
+        if self.dask_client is not None:
+            print("Unsupported preparing queries with a dask client, please use sql")
+            return None
+
+        if (algebra is None):
+            algebra = self.explain(query)
+
+        if algebra == '':
+            print("Parsing Error")
+            return None
+
+        # the filters that have parameters can only prune the files of their tables once they are bound, on every run
+        scan_queries = {}
+        algebra, nodeTableList, fileTypes = self._get_node_tables(algebra, True, scan_queries)
+        algebra = get_plan(algebra)
+
+        statement_id = cio.prepareQueryCaller(nodeTableList[0], fileTypes, algebra)
+        return PreparedQuery(self, statement_id, nodeTableList[0], fileTypes, scan_queries)
+
     # END SQL interface
 
     # BEGIN LOG interface
@@ -0,0 +1,113 @@
+import os
+import shutil
+import tempfile
+import unittest
+
+import blazingsql
+from pyblazing.apiv2.context import get_partition_names
+
+import pandas as pd
+
+
+class TestPartitionPruning(unittest.TestCase):
+
+    YEARS = [2018, 2019, 2020]
+    MONTHS = [1, 2]
+    ROWS_PER_PARTITION = 10
+
+    @classmethod
+    def setUpClass(cls):
+        # a folder per year and month, like year=2019/month=2, each one with a file of its rows
+        cls.location = tempfile.mkdtemp(prefix='blazing-partition-pruning-')
+        row = 0
+        for year in cls.YEARS:
+            for month in cls.MONTHS:
+                folder = os.path.join(cls.location, 'year=' + str(year), 'month=' + str(month))
+                os.makedirs(folder)
+                ids = list(range(row, row + cls.ROWS_PER_PARTITION))
+                pd.DataFrame({'id': ids, 'value': [i * 3 for i in ids]}).to_parquet(
+                    os.path.join(folder, 'part.parquet'), index=False)
+                row = row + cls.ROWS_PER_PARTITION
+
+        cls.context = blazingsql.BlazingContext()
+        cls.context.create_table('sales', cls.location, file_format='parquet',
+                                 partitions={'year': cls.YEARS, 'month': cls.MONTHS},
+                                 partitions_schema=[('year', 'int32'), ('month', 'int32')])
+
+    @classmethod
+    def tearDownClass(cls):
+        shutil.rmtree(cls.location)
+
+    def scanned_partitions(self, where):
+        """
+        Returns the partitions whose files the query reads and checks that the stats of the query report them
+        """
+        query = 'select id, year, month from sales where ' + where
+        algebra = self.context.explain(query)
+        _, node_tables, _ = self.context._get_node_tables(algebra, True)
+        files = node_tables[0]['sales'].files
+        partitions = set(get_partition_names(files, self.location))
+
+        stats = self.context.partition_pruning_stats['sales']
+        self.assertEqual(stats['partitions_scanned'], len(partitions))
+        self.assertEqual(stats['partitions_total'], len(self.YEARS) * len(self.MONTHS))
+        return partitions
+
+    def expect_query_rows(self, where, partitions):
+        """
+        The query has to return the rows of the partitions, pruning can not lose any of them
+        """
+        result = self.context.sql('select id, year, month from sales where ' + where).to_pandas()
+        self.assertEqual(len(result), len(partitions) * self.ROWS_PER_PARTITION)
+        self.assertEqual(set('year=' + str(y) + '/month=' + str(m) for y, m in zip(result['year'], result['month'])),
+                         partitions)
+
+    def test_equality(self):
+        partitions = self.scanned_partitions('year = 2019')
+        self.assertEqual(partitions, {'year=2019/month=1', 'year=2019/month=2'})
+        self.expect_query_rows('year = 2019', partitions)
+
+    def test_ranges(self):
+        self.assertEqual(self.scanned_partitions('year > 2018'),
+                         {'year=2019/month=1', 'year=2019/month=2', 'year=2020/month=1', 'year=2020/month=2'})
+        partitions = self.scanned_partitions('year >= 2019 and year < 2020')
+        self.assertEqual(partitions, {'year=2019/month=1', 'year=2019/month=2'})
+        self.expect_query_rows('year >= 2019 and year < 2020', partitions)
+
+    def test_in(self):
+        partitions = self.scanned_partitions('year in (2018, 2020)')
+        self.assertEqual(partitions,
+                         {'year=2018/month=1', 'year=2018/month=2', 'year=2020/month=1', 'year=2020/month=2'})
+        self.expect_query_rows('year in (2018, 2020)', partitions)
+
+    def test_and(self):
+        partitions = self.scanned_partitions('year = 2019 and month = 2')
+        self.assertEqual(partitions, {'year=2019/month=2'})
+        self.expect_query_rows('year = 2019 and month = 2', partitions)
+
+    def test_or(self):
+        partitions = self.scanned_partitions('year = 2018 or month = 1')
+        self.assertEqual(partitions,
+                         {'year=2018/month=1', 'year=2018/month=2', 'year=2019/month=1', 'year=2020/month=1'})
+        self.expect_query_rows('year = 2018 or month = 1', partitions)
+
+    def test_not(self):
+        # the skip-data rules do not evaluate NOT or <>, so those conditions keep every partition
+        all_partitions = set('year=' + str(y) + '/month=' + str(m) for y in self.YEARS for m in self.MONTHS)
+        self.assertEqual(self.scanned_partitions('not (year = 2019)'), all_partitions)
+        self.expect_query_rows('not (year = 2019)', all_partitions - {'year=2019/month=1', 'year=2019/month=2'})
+
+        # while the conditions next to them in an AND still prune
+        partitions = self.scanned_partitions('year = 2020 and not (month = 1)')
+        self.assertEqual(partitions, {'year=2020/month=1', 'year=2020/month=2'})
+        self.expect_query_rows('year = 2020 and not (month = 1)', {'year=2020/month=2'})
+
+    def test_no_filter(self):
+        query = 'select id from sales'
+        self.context._get_node_tables(self.context.explain(query), True)
+        stats = self.context.partition_pruning_stats['sales']
+        self.assertEqual(stats['partitions_scanned'], stats['partitions_total'])
+
+
+if __name__ == '__main__':
+    unittest.main()